@@ -6,6 +6,7 @@
 #include "ledger/manager.h"
 #include "banking/fee_market.h"
 #include "banking/mev_protection.h"
+#include "banking/prioritization_scheduler.h"
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
@@ -289,7 +290,10 @@ public:
   
   // Fee market statistics
   FeeStats get_fee_market_stats() const;
+  PrioritizationFeeScheduler::Statistics get_scheduler_stats() const;
   uint64_t get_current_base_fee() const;
+  std::vector<PrioritizationFeeCache::SlotFee>
+  get_recent_prioritization_fees(const std::vector<PublicKey> &accounts = {}) const;
   
   // MEV protection statistics
   size_t get_detected_mev_attacks() const;
@@ -366,25 +370,25 @@ private:
   std::atomic<uint64_t> total_processing_time_ms_;
   std::chrono::steady_clock::time_point start_time_;
 
-  // Priority queue for priority processing
-  // Higher priority values processed first
-  using PriorityTransaction = std::pair<int, TransactionPtr>;
-  struct PriorityCompare {
-    bool operator()(const PriorityTransaction& a, const PriorityTransaction& b) {
-      return a.first < b.first;  // Higher priority first
-    }
-  };
-  std::priority_queue<PriorityTransaction, 
-                     std::vector<PriorityTransaction>,
-                     PriorityCompare> priority_queue_;
+  // Prioritization-fee ordering with block and per-account compute limits;
+  // manual priorities act as a floor on the compute-unit price
+  std::unique_ptr<PrioritizationFeeScheduler> scheduler_;
   std::unordered_map<TransactionPtr, int> transaction_priorities_;
   mutable std::mutex priority_mutex_;
+  // Scheduled transactions hold their account locks until their batch
+  // commits or aborts
+  std::unordered_multimap<const ledger::Transaction *,
+                          PrioritizationFeeScheduler::Batch>
+      scheduled_;
+  std::mutex scheduled_mutex_;
+  common::Slot scheduler_slot_ = 0; ///< Ledger slot the block budget follows
 
   // Internal methods
   void initialize_pipeline();
   void process_batches();
   void create_batch_if_needed();
   void process_transaction_queue();
+  void complete_scheduled(const TransactionBatch &batch, bool committed);
   
   // Utility methods for transaction processing
   std::string encode_base58(const std::vector<uint8_t> &data) const;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace slonana {
+namespace banking {
+
+/**
+ * Lock-free log-bucketed histogram of fee amounts
+ *
+ * Values below 32 get a bucket each; above that every power of two is split
+ * into 16 equal sub-buckets, so a bucket is at most 1/16 as wide as its
+ * lower edge and the whole u64 range fits in 976 buckets. Each bucket also
+ * keeps the smallest and largest value recorded into it, which makes
+ * quantiles exact when a bucket holds a single distinct fee and otherwise
+ * bounds the error by the bucket width.
+ *
+ * record() and remove() are a handful of relaxed atomic operations, so many
+ * threads can feed one histogram without locking. Queries scan the fixed
+ * bucket array: memory and query cost do not depend on the sample count.
+ * remove() keeps a bucket's min/max until it empties, so after removals a
+ * bucket's bounds may be looser than its contents but never outside it.
+ */
+class FeeHistogram {
+public:
+  static constexpr size_t SUB_BUCKET_BITS = 4;
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  void record(uint64_t value);
+  /// Undo a record() of `value`
+  void remove(uint64_t value);
+  void clear();
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  /**
+   * Values at the given fractions (0.0 to 1.0) of the distribution in one
+   * scan: for fraction q, the largest value recorded in the bucket holding
+   * the sample of rank floor(q × (count − 1)). Zero when empty.
+   */
+  std::vector<uint64_t> quantiles(const std::vector<double> &fractions) const;
+  uint64_t quantile(double fraction) const;
+  /// Smallest and largest recorded value (bucket bounds after removals)
+  uint64_t min() const;
+  uint64_t max() const;
+
+  static size_t bucket_index(uint64_t value);
+  static uint64_t bucket_lower(size_t index);
+  static uint64_t bucket_upper(size_t index);
+
+private:
+  struct Bucket {
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint64_t> min{UINT64_MAX};
+    std::atomic<uint64_t> max{0};
+  };
+
+  std::array<Bucket, BUCKETS> buckets_;
+  std::atomic<uint64_t> count_{0};
+};
+
+} // namespace banking
+} // namespace slonana
@@ -1,11 +1,11 @@
 #pragma once
 
+#include "banking/fee_histogram.h"
+#include "banking/prioritization_fee_cache.h"
 #include "common/types.h"
 #include <atomic>
-#include <deque>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 #include <vector>
 
 namespace slonana {
@@ -40,6 +40,17 @@ struct FeeStats {
  * 
  * Implements sophisticated fee market mechanics for optimal transaction ordering
  * and priority fee handling, compatible with Agave's fee market implementation.
+ *
+ * Recent fees are those recorded over the last history_slots slots, capped
+ * at max_history_size samples. They live in a fixed ring and a FeeHistogram
+ * over the same samples: recording overwrites the oldest sample and moves
+ * two histogram counters without taking a lock, and advance_slot() evicts
+ * the samples of slots that leave the window. Tier
+ * thresholds and statistics are read from a cached set of percentiles that
+ * is recomputed, with one scan of the fixed-size histogram, by the first
+ * reader after new samples arrive; readers never wait for each other or
+ * for writers. Per-slot and per-account prioritization fees for
+ * getRecentPrioritizationFees are kept in a PrioritizationFeeCache.
  */
 class FeeMarket {
 public:
@@ -96,6 +107,26 @@ public:
    */
   void record_transaction_fee(uint64_t fee, bool included);
 
+  /**
+   * Attribute subsequently recorded fees to `slot` and evict the samples of
+   * slots that fall out of the window; older slots are ignored
+   */
+  void advance_slot(uint64_t slot);
+
+  /**
+   * Record the compute-unit price a transaction committed in `slot` paid
+   * for the writable accounts it locked
+   */
+  void record_prioritization_fee(uint64_t slot, uint64_t compute_unit_price,
+                                 const std::vector<common::PublicKey> &writable_accounts);
+
+  /**
+   * Per-slot prioritization fees over the recent slot window, oldest first.
+   * With accounts, each slot reports the highest of their local minimums.
+   */
+  std::vector<PrioritizationFeeCache::SlotFee>
+  get_recent_prioritization_fees(const std::vector<common::PublicKey> &accounts = {}) const;
+
   // Configuration
   /**
    * Set the target block utilization for base fee adjustment
@@ -109,6 +140,13 @@ public:
    */
   void set_max_history_size(size_t max_history);
 
+  /**
+   * Set how many recent slots, including the current one, the fee window
+   * covers
+   */
+  void set_history_slots(size_t slots);
+  size_t get_history_slots() const;
+
   /**
    * Enable or disable adaptive fee adjustments
    * @param enabled True to enable adaptive adjustments
@@ -134,15 +172,39 @@ private:
   double target_utilization_;
   bool adaptive_fees_enabled_;
 
-  // Fee history
-  std::deque<uint64_t> recent_fees_;
-  std::deque<bool> inclusion_status_;
+  // Fee history: the current ring, plus retired ones tagged with the slot
+  // they were replaced in. Recorders may still hold a pointer to a retired
+  // ring, so it is only freed once the window has moved past that slot
+  struct SampleWindow;
+  std::atomic<SampleWindow *> window_;
+  std::vector<std::pair<uint64_t, std::unique_ptr<SampleWindow>>> retired_windows_;
+  std::unique_ptr<SampleWindow> current_window_;
   size_t max_history_size_;
-  mutable std::mutex history_mutex_;
+  std::atomic<uint64_t> current_slot_{0};
+  std::atomic<uint64_t> history_slots_;
+  std::mutex config_mutex_;
+
+  // Percentiles cached from the histogram, tagged with the ring position
+  // they were computed at
+  struct CachedStats {
+    std::atomic<uint64_t> position{UINT64_MAX};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> min{0};
+    std::atomic<uint64_t> p25{0};
+    std::atomic<uint64_t> median{0};
+    std::atomic<uint64_t> p90{0};
+    std::atomic<uint64_t> p99{0};
+    std::atomic<uint64_t> max{0};
+  };
+  CachedStats cached_;
+  std::mutex refresh_mutex_;
+
+  PrioritizationFeeCache prioritization_fees_;
 
   // Configuration constants
   static constexpr uint64_t DEFAULT_BASE_FEE = 5000; // 5000 lamports
   static constexpr size_t DEFAULT_MAX_HISTORY = 10000;
+  static constexpr size_t DEFAULT_HISTORY_SLOTS = 150;
   static constexpr double DEFAULT_TARGET_UTILIZATION = 0.5;
   static constexpr double BASE_FEE_ADJUSTMENT_FACTOR = 0.125; // 12.5%
 
@@ -152,9 +214,10 @@ private:
   static constexpr double P25_THRESHOLD = 0.25;
 
   // Internal helper methods
-  uint64_t calculate_percentile(double percentile);
-  void trim_history_if_needed();
-  std::vector<uint64_t> get_sorted_fees();
+  /// Bring cached_ up to date unless another reader is already doing so
+  void refresh_cached_stats();
+  /// Free retired rings and evict samples older than the window; config_mutex_ held
+  void evict_before(uint64_t first_slot);
 };
 
 } // namespace banking
@@ -4,6 +4,7 @@
 #include "ledger/manager.h"
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -77,6 +78,21 @@ public:
   // Detection
   /**
    * Detect potential MEV patterns in a batch of transactions
+   *
+   * One pass over the batch in block order. Each transaction's fee payer,
+   * writable accounts, first program instruction (program, discriminator,
+   * amount) and compute-unit price are extracted once. Swap direction is
+   * not decoded; the order of the instruction's writable accounts stands
+   * in for it, so a swap back through the same accounts reads as an
+   * unwind.
+   * Every writable account keeps a small state machine over its timeline:
+   * the last position, the last sender and the last position of anyone
+   * else, plus each sender's last position on it. A sender returning to
+   * an account after someone else used it closes a sandwich at any
+   * distance; adjacent entries on an account are checked for front- and
+   * back-running. Cost is linear in the number of writable account
+   * references.
+   *
    * @param transactions Transaction batch to analyze
    * @return Vector of detected MEV alerts
    */
@@ -202,7 +218,7 @@ private:
   std::atomic<size_t> protected_transactions_;
 
   // Alert history
-  std::vector<MEVAlert> alert_history_;
+  std::deque<MEVAlert> alert_history_;
   mutable std::mutex alert_mutex_;
   static constexpr size_t MAX_ALERT_HISTORY = 1000;
 
@@ -210,16 +226,9 @@ private:
   static constexpr double DEFAULT_ALERT_THRESHOLD = 0.7;
   static constexpr size_t MAX_SAME_SENDER_CONSECUTIVE = 3;
 
-  // Detection helper methods
-  bool transactions_access_same_accounts(const TransactionPtr &tx1,
-                                         const TransactionPtr &tx2);
-  bool transactions_have_similar_operations(const TransactionPtr &tx1,
-                                            const TransactionPtr &tx2);
-  double calculate_mev_confidence(const TransactionPtr &tx1,
-                                  const TransactionPtr &tx2,
-                                  const TransactionPtr &tx3);
-  Hash get_transaction_hash(const TransactionPtr &tx);
-  PublicKey get_transaction_sender(const TransactionPtr &tx);
+  // Detection confidences
+  static constexpr double FRONT_RUN_CONFIDENCE = 0.75;
+  static constexpr double BACK_RUN_CONFIDENCE = 0.6;
 
   // Protection helper methods
   void trim_alert_history();
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common/types.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace slonana {
+namespace banking {
+
+/**
+ * Recent prioritization fees by slot, as served by getRecentPrioritizationFees
+ *
+ * A ring of the last `window` slots (150 by default, as in Agave) keeps for
+ * each slot the lowest compute-unit price among its committed transactions
+ * and, per writable account, the lowest price paid by transactions locking
+ * that account: the local fee market a new transaction touching the account
+ * competes in. Each slot's accounts live in a fixed-size open-addressing
+ * table claimed with CAS, so updates never lock or allocate and memory is
+ * fixed; accounts beyond a slot's table capacity are counted as untracked.
+ */
+class PrioritizationFeeCache {
+public:
+  static constexpr size_t DEFAULT_WINDOW = 150;
+  static constexpr size_t ACCOUNTS_PER_SLOT = 256; ///< Power of two
+
+  struct SlotFee {
+    uint64_t slot = 0;
+    uint64_t prioritization_fee = 0; ///< Micro-lamports per compute unit
+  };
+
+  explicit PrioritizationFeeCache(size_t window = DEFAULT_WINDOW);
+  ~PrioritizationFeeCache();
+
+  /**
+   * Record a transaction committed in `slot`. Updates for slots that have
+   * already left the window are ignored.
+   */
+  void update(uint64_t slot, uint64_t compute_unit_price,
+              const std::vector<common::PublicKey> &writable_accounts);
+
+  /**
+   * Slots in the window, oldest first, each with its minimum price raised
+   * to the highest per-account minimum among `accounts` that it touched
+   */
+  std::vector<SlotFee>
+  get_recent_fees(const std::vector<common::PublicKey> &accounts = {}) const;
+
+  size_t window() const { return window_; }
+  uint64_t untracked_accounts() const {
+    return untracked_accounts_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct SlotEntry;
+
+  SlotEntry *claim(uint64_t slot);
+
+  size_t window_;
+  std::unique_ptr<SlotEntry[]> entries_;
+  std::atomic<uint64_t> newest_slot_{0};
+  std::atomic<uint64_t> untracked_accounts_{0};
+};
+
+} // namespace banking
+} // namespace slonana
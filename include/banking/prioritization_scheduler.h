@@ -0,0 +1,203 @@
+#pragma once
+
+#include "common/min_max_heap.h"
+#include "common/types.h"
+#include "ledger/manager.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace slonana {
+namespace banking {
+
+using namespace slonana::common;
+
+/**
+ * What the scheduler needs to know about a transaction: what it pays per
+ * compute unit, how many units it may use, and which accounts it locks.
+ */
+struct SchedulableTransaction {
+  using TransactionPtr = std::shared_ptr<ledger::Transaction>;
+
+  static constexpr uint64_t DEFAULT_INSTRUCTION_COMPUTE_UNITS = 200000;
+  static constexpr uint64_t MAX_COMPUTE_UNITS = 1400000;
+  /// ComputeBudget111111111111111111111111111111
+  static constexpr std::array<uint8_t, 32> COMPUTE_BUDGET_PROGRAM_ID = {
+      0x03, 0x06, 0x46, 0x6f, 0xe5, 0x21, 0x17, 0x32, 0xff, 0xec, 0xad,
+      0xba, 0x72, 0xc3, 0x9b, 0xe7, 0xbc, 0x8c, 0xe5, 0xbb, 0xc5, 0xf7,
+      0x12, 0x6b, 0x2c, 0x43, 0x9b, 0x3a, 0x40, 0x00, 0x00, 0x00};
+
+  TransactionPtr transaction;
+  uint64_t compute_unit_price = 0; ///< Micro-lamports per compute unit
+  uint64_t compute_units = DEFAULT_INSTRUCTION_COMPUTE_UNITS; ///< Cost charged
+  std::vector<PublicKey> writable_accounts;
+  std::vector<PublicKey> readonly_accounts;
+  uint64_t id = 0; ///< Arrival order, assigned on submit
+
+  /**
+   * Read the account keys, their writability and any ComputeBudget
+   * SetComputeUnitLimit/SetComputeUnitPrice instructions from a legacy
+   * message. Without a limit instruction, each other instruction is
+   * charged the default 200k units, capped at 1.4M. An unparseable message
+   * gets the defaults and no accounts.
+   */
+  static SchedulableTransaction from_transaction(TransactionPtr transaction);
+
+  /// Priority fee in lamports: price × units, rounded up
+  uint64_t priority_fee() const;
+};
+
+/**
+ * Compute-unit budget of the block being built: a limit for the whole block
+ * and a smaller one for each writable account, so a single hot account
+ * cannot take the block and serialize execution behind its lock.
+ */
+class CostTracker {
+public:
+  struct Limits {
+    uint64_t block_units = 48000000;
+    uint64_t account_units = 12000000; ///< Per writable account
+  };
+
+  enum class Verdict { FITS, BLOCK_FULL, ACCOUNT_FULL };
+
+  CostTracker() = default;
+  explicit CostTracker(const Limits &limits) : limits_(limits) {}
+
+  Verdict check(const SchedulableTransaction &transaction) const;
+  void add(const SchedulableTransaction &transaction);
+  /// Undo add() for a transaction that did not make it into the block
+  void remove(const SchedulableTransaction &transaction);
+  void reset();
+
+  uint64_t block_units() const { return block_units_; }
+  uint64_t account_units(const PublicKey &account) const;
+  const Limits &limits() const { return limits_; }
+
+private:
+  Limits limits_;
+  uint64_t block_units_ = 0;
+  std::unordered_map<PublicKey, uint64_t> account_units_;
+};
+
+/**
+ * Central prioritization-fee scheduler
+ *
+ * Pending transactions sit in a min-max heap ordered by compute-unit price,
+ * earlier arrivals first at equal price: the best end feeds the workers and
+ * the worst end is evicted when the queue is full. Each schedule() pass
+ * takes transactions from the top and assigns them to worker threads such
+ * that
+ *   - the block and per-account compute limits are respected,
+ *   - a batch has no conflicting account locks (a transaction conflicting
+ *     with the batch being built starts that thread's next batch), and
+ *   - a transaction whose accounts are locked by work in flight on a single
+ *     thread goes to that thread, which runs its batches in order, while
+ *     one conflicting with several threads waits.
+ * Transactions skipped in a pass stay queued. Workers report back through
+ * complete(); a transaction that could not run (e.g. it lost a lock race
+ * with work outside the scheduler) is re-queued and its cost refunded.
+ *
+ * Thread-safe; intended to be driven by one scheduling thread.
+ */
+class PrioritizationFeeScheduler {
+public:
+  static constexpr size_t MAX_THREADS = 64;
+
+  struct Config {
+    size_t worker_threads = 4; ///< At most MAX_THREADS
+    size_t max_batch_size = 64; ///< Per thread and pass
+    size_t max_pending = 100000;
+    size_t lookahead = 4096; ///< Transactions examined per pass
+    CostTracker::Limits limits;
+  };
+
+  struct Batch {
+    size_t thread = 0;
+    std::vector<SchedulableTransaction> transactions;
+  };
+
+  struct Statistics {
+    uint64_t received = 0;
+    uint64_t scheduled = 0;
+    uint64_t completed = 0;
+    uint64_t retried = 0;           ///< Re-queued by complete()
+    uint64_t dropped = 0;           ///< Evicted or rejected at capacity
+    uint64_t deferred_cost = 0;     ///< Skipped for block/account limits
+    uint64_t deferred_conflict = 0; ///< Skipped for account locks
+  };
+
+  PrioritizationFeeScheduler();
+  explicit PrioritizationFeeScheduler(const Config &config);
+
+  /**
+   * Queue a transaction. At capacity the lowest-priority transaction is
+   * evicted; returns false if that is the new one.
+   */
+  bool submit(SchedulableTransaction transaction);
+  /**
+   * One pass scheduling up to `max_transactions`, at most max_batch_size
+   * per thread. A thread may get several batches; they must run in the
+   * order returned.
+   */
+  std::vector<Batch>
+  schedule(size_t max_transactions = std::numeric_limits<size_t>::max());
+  /**
+   * Release a batch's locks. `executed[i]` false re-queues transaction i
+   * and refunds its cost; an empty vector means all of them ran.
+   */
+  void complete(const Batch &batch, const std::vector<bool> &executed = {});
+  /// Start a new block: clears the cost tracker
+  void on_new_block();
+
+  size_t pending_count() const;
+  size_t in_flight_count() const;
+  uint64_t block_units() const;
+  Statistics get_statistics() const;
+  const Config &config() const { return config_; }
+
+private:
+  struct QueueEntry {
+    uint64_t price;
+    uint64_t id;
+  };
+  struct QueueLess {
+    bool operator()(const QueueEntry &a, const QueueEntry &b) const {
+      return a.price != b.price ? a.price < b.price : a.id > b.id;
+    }
+  };
+  static constexpr size_t NO_THREAD = MAX_THREADS;
+
+  /// Locks held on one account by batches in flight
+  struct AccountLocks {
+    size_t writer = NO_THREAD;
+    uint32_t writes = 0;
+    std::vector<std::pair<size_t, uint32_t>> readers; ///< (thread, count)
+  };
+  struct BatchLocks;
+  struct ThreadPass;
+
+  uint64_t allowed_threads(const SchedulableTransaction &transaction,
+                           const std::vector<ThreadPass> &passes) const;
+  void lock(const SchedulableTransaction &transaction, size_t thread);
+  void unlock(const SchedulableTransaction &transaction, size_t thread);
+  void enqueue(SchedulableTransaction transaction);
+
+  Config config_;
+  mutable std::mutex mutex_;
+  common::MinMaxHeap<QueueEntry, QueueLess> queue_;
+  std::unordered_map<uint64_t, SchedulableTransaction> pending_;
+  std::unordered_map<PublicKey, AccountLocks> locks_;
+  std::vector<uint64_t> in_flight_units_; ///< Per thread
+  size_t in_flight_ = 0;
+  uint64_t next_id_ = 0;
+  CostTracker cost_tracker_;
+  Statistics stats_;
+};
+
+} // namespace banking
+} // namespace slonana
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace slonana {
+namespace common {
+
+/**
+ * @brief ChaCha20 keystream used as a deterministic random number generator
+ *
+ * Same construction as rand_chacha's ChaCha20Rng in the Rust ecosystem: the
+ * 32-byte seed is the key, the nonce is zero and successive 64-byte blocks
+ * are consumed as little-endian 32-bit words. Every validator seeding it with
+ * the same bytes (a slot, an epoch, a shred id) draws the same sequence,
+ * which is what stake-weighted shuffles and leader schedules rely on.
+ *
+ * Satisfies UniformRandomBitGenerator, so it also works with <random> and
+ * std::shuffle.
+ */
+class ChaChaRng {
+public:
+  using Seed = std::array<uint8_t, 32>;
+  using result_type = uint64_t;
+
+  explicit ChaChaRng(const Seed &seed);
+  /// Seed from a 64-bit value stored little-endian in the first 8 bytes
+  explicit ChaChaRng(uint64_t seed = 0);
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  result_type operator()() { return next_u64(); }
+
+  uint32_t next_u32();
+  uint64_t next_u64();
+
+  /**
+   * Uniform value in [0, bound) using a widening multiply with rejection
+   * (rand's gen_range for u64); bound must be non-zero
+   */
+  uint64_t gen_range(uint64_t bound);
+
+  /**
+   * Uniform value in [0, bound) as rand's Uniform::new(0, bound) samples it,
+   * which is what WeightedIndex draws with. Only the 2^64 mod bound biased
+   * products are rejected, so the stream differs from gen_range's; bound
+   * must be non-zero
+   */
+  uint64_t sample_uniform(uint64_t bound);
+
+  /// Rewind to the start of the stream for a new seed
+  void reseed(const Seed &seed);
+
+  static Seed seed_from_u64(uint64_t value);
+
+private:
+  std::array<uint32_t, 8> key_;
+  uint64_t counter_;
+  std::array<uint32_t, 16> block_;
+  size_t index_;
+
+  void refill();
+};
+
+} // namespace common
+} // namespace slonana
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace slonana {
+namespace common {
+
+/**
+ * @brief Double-ended priority queue (Atkinson et al. min-max heap)
+ *
+ * An array heap whose even levels are ordered like a min-heap and odd levels
+ * like a max-heap, so both the smallest and the largest element are at the
+ * top two levels. Push and both pops are O(log n) with no allocation beyond
+ * the backing vector, which makes it suitable for bounded queues that serve
+ * from the best end and evict from the worst.
+ */
+template <typename T, typename Less = std::less<T>> class MinMaxHeap {
+public:
+  MinMaxHeap() = default;
+  explicit MinMaxHeap(Less less) : less_(std::move(less)) {}
+
+  bool empty() const { return items_.empty(); }
+  size_t size() const { return items_.size(); }
+  void reserve(size_t capacity) { items_.reserve(capacity); }
+  void clear() { items_.clear(); }
+
+  const T &min() const { return items_[0]; }
+  const T &max() const { return items_[max_index()]; }
+
+  void push(T item) {
+    items_.push_back(std::move(item));
+    bubble_up(items_.size() - 1);
+  }
+
+  T pop_min() { return remove_at(0); }
+  T pop_max() { return remove_at(max_index()); }
+
+private:
+  static bool is_min_level(size_t index) {
+    size_t level = 0;
+    for (size_t n = index + 1; n > 1; n >>= 1) {
+      ++level;
+    }
+    return level % 2 == 0;
+  }
+  static size_t parent(size_t index) { return (index - 1) / 2; }
+
+  /// On a min level, "better" means smaller; on a max level, larger
+  bool better(size_t a, size_t b, bool min_level) const {
+    return min_level ? less_(items_[a], items_[b]) : less_(items_[b], items_[a]);
+  }
+
+  size_t max_index() const {
+    if (items_.size() < 3) {
+      return items_.size() - 1;
+    }
+    return less_(items_[1], items_[2]) ? 2 : 1;
+  }
+
+  T remove_at(size_t index) {
+    T result = std::move(items_[index]);
+    if (index + 1 != items_.size()) {
+      items_[index] = std::move(items_.back());
+      items_.pop_back();
+      trickle_down(index);
+    } else {
+      items_.pop_back();
+    }
+    return result;
+  }
+
+  void bubble_up(size_t index) {
+    if (index == 0) {
+      return;
+    }
+    bool min_level = is_min_level(index);
+    size_t up = parent(index);
+    if (better(up, index, min_level)) {
+      // Belongs on the parent's (opposite) kind of level
+      std::swap(items_[index], items_[up]);
+      bubble_up_grandparents(up, !min_level);
+    } else {
+      bubble_up_grandparents(index, min_level);
+    }
+  }
+
+  void bubble_up_grandparents(size_t index, bool min_level) {
+    while (index > 2) {
+      size_t grandparent = parent(parent(index));
+      if (!better(index, grandparent, min_level)) {
+        break;
+      }
+      std::swap(items_[index], items_[grandparent]);
+      index = grandparent;
+    }
+  }
+
+  void trickle_down(size_t index) {
+    bool min_level = is_min_level(index);
+    size_t count = items_.size();
+    while (true) {
+      size_t first_child = 2 * index + 1;
+      if (first_child >= count) {
+        return;
+      }
+
+      // Best among children and grandchildren
+      size_t best = first_child;
+      for (size_t c = first_child; c < first_child + 2 && c < count; ++c) {
+        if (better(c, best, min_level)) {
+          best = c;
+        }
+        for (size_t g = 2 * c + 1; g < 2 * c + 3 && g < count; ++g) {
+          if (better(g, best, min_level)) {
+            best = g;
+          }
+        }
+      }
+
+      if (!better(best, index, min_level)) {
+        return;
+      }
+      std::swap(items_[best], items_[index]);
+      if (best <= first_child + 1) {
+        return; // A child: it is on the opposite level, nothing below moves
+      }
+      if (better(parent(best), best, min_level)) {
+        std::swap(items_[best], items_[parent(best)]);
+      }
+      index = best;
+    }
+  }
+
+  std::vector<T> items_;
+  Less less_;
+};
+
+} // namespace common
+} // namespace slonana
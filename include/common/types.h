@@ -55,6 +55,8 @@ struct ValidatorConfig {
   // Network service toggles
   bool enable_rpc = true;                     ///< Enable JSON-RPC API server
   bool enable_gossip = true;                  ///< Enable gossip network participation
+  bool enable_quic_tpu = false;               ///< Also ingest transactions over QUIC (experimental; non-TLS handshake)
+  uint32_t quic_tpu_port = 8009;              ///< UDP port for QUIC transaction ingestion
   uint32_t max_connections = 1000;            ///< Maximum concurrent network connections
 
   // Runtime configuration
@@ -121,6 +123,7 @@ struct ValidatorConfig {
   // Snapshot and bootstrap configuration
   std::string snapshot_source = "auto";      ///< Snapshot source: auto|mirror|none
   std::string snapshot_mirror = "";          ///< URL for custom snapshot mirror
+  std::string snapshot_sha256 = "";          ///< Hex SHA-256 the downloaded archive must match
   bool allow_stale_rpc = false;             ///< Allow RPC before full sync completion
   std::string upstream_rpc_url = "";         ///< RPC URL for catch-up and auto-discovery
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "common/types.h"
+#include "consensus/heaviest_subtree_fork_choice.h"
 #include "consensus/tower_bft.h"
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -66,7 +68,6 @@ struct BlockMetadata {
   uint64_t confirmation_count;
   bool is_processed;
   bool is_confirmed;
-  std::vector<PublicKey> validators_voted;
   std::chrono::steady_clock::time_point arrival_time;
   
   BlockMetadata(const Hash& hash, const Hash& parent, Slot s)
@@ -78,20 +79,25 @@ struct BlockMetadata {
 /**
  * Advanced Fork Choice Algorithm
  * Implements Agave-compatible weighted fork selection with optimistic confirmation
+ *
+ * Head selection and stake counting are delegated to a
+ * HeaviestSubtreeForkChoice keyed by slot: a vote moves its validator's
+ * stake from the previous vote's path to the new one in O(depth), and only
+ * blocks on the new path are checked for confirmation and rooting.
  * 
  * CONCURRENCY MODEL DOCUMENTATION:
  * ================================
  * 
  * LOCK HIERARCHY (acquire in this order to prevent deadlocks):
  * 1. vote_processing_mutex_     - Protects vote processing operations
- * 2. data_mutex_ (shared/unique) - Protects main data structures (blocks_, forks_, etc.)
+ * 2. data_mutex_ (shared/unique) - Protects main data structures (blocks_, forks_, fork_tree_, etc.)
  * 3. weight_cache_mutex_        - Protects weight_cache_ operations
  * 4. fork_weights_mutex_        - Protects cached_weights_ and related state
  * 
  * LOCK RESPONSIBILITIES:
  * ---------------------
  * - vote_processing_mutex_: Serializes add_vote() and process_votes_batch()
- * - data_mutex_: Guards blocks_, forks_, block_to_fork_map_, recent_votes_, current_head_, etc.
+ * - data_mutex_: Guards blocks_, forks_, block_to_fork_map_, fork_tree_, current_head_, etc.
  *   * Shared lock: For read operations (get_head, get_statistics, etc.)
  *   * Unique lock: For write operations (add_block, garbage_collect, etc.)
  * - weight_cache_mutex_: Protects the weight_cache_ from concurrent access
@@ -111,6 +117,7 @@ struct BlockMetadata {
  * - Reader-writer locks allow concurrent reads
  * - Separate cache mutexes reduce lock contention
  * - O(1) block-to-fork mapping eliminates linear searches
+ * - O(depth) incremental vote accounting; the head is read, never searched
  * - Configurable TTL-based cache expiry prevents stale data
  * - Bounded data structures prevent unbounded memory growth
  */
@@ -248,6 +255,14 @@ public:
   Configuration get_configuration() const { return config_; }
   void update_configuration(const Configuration& new_config);
   
+  // Commitment notifications (processed on add_block, confirmed on
+  // optimistic confirmation, rooted on rooting, dead for every slot a new
+  // root prunes off its ancestry, reported before that ROOTED)
+  enum class CommitmentEvent { PROCESSED, CONFIRMED, ROOTED, DEAD };
+  using CommitmentCallback = std::function<void(Slot, CommitmentEvent)>;
+  /// Invoked with fork choice locked: must be cheap and must not call back in
+  void set_commitment_callback(CommitmentCallback callback);
+  
   // Debugging and analysis
   void print_fork_tree() const;
   std::string get_fork_tree_json() const;
@@ -260,16 +275,18 @@ private:
   // Data structures
   std::unordered_map<Hash, std::unique_ptr<BlockMetadata>> blocks_;
   std::unordered_map<Hash, std::unique_ptr<Fork>> forks_;
-  std::vector<VoteInfo> recent_votes_;
   std::unordered_map<PublicKey, uint64_t> validator_stakes_;
-  
-  // Event-driven confirmation tracking
-  std::unordered_set<Hash> pending_confirmation_blocks_;
-  
-  // Stake aggregation for efficient stake counting
-  mutable std::unordered_map<Hash, uint64_t> block_stake_aggregation_;
-  mutable bool stake_aggregation_dirty_;
-  
+
+  // Stake-weighted tree of slots above the root, and the block per slot
+  HeaviestSubtreeForkChoice fork_tree_;
+  std::unordered_map<Slot, Hash> slot_hashes_;
+
+  // Votes for blocks not seen yet, by block hash. They reach the tree just
+  // before their block, whose pending-vote replay then counts them; a block
+  // with a different hash at the same slot never receives them
+  static constexpr size_t MAX_EARLY_VOTE_BLOCKS = 1024;
+  std::unordered_map<Hash, std::vector<VoteInfo>> early_votes_;
+
   // Optimization: Block-to-Fork mapping for O(1) fork lookups
   std::unordered_map<Hash, Fork*> block_to_fork_map_;
   
@@ -279,6 +296,8 @@ private:
   Slot current_head_slot_;
   Slot current_root_slot_;
   
+  CommitmentCallback commitment_callback_;
+  
   // Thread safety
   mutable std::shared_mutex data_mutex_;
   mutable std::mutex vote_processing_mutex_;
@@ -296,42 +315,34 @@ private:
   
   // Internal operations
   void update_fork_weights();
-  Fork* find_best_fork() const;
-  uint64_t calculate_fork_weight(const Fork& fork) const;
   bool meets_supermajority(const Hash& block_hash, uint64_t threshold) const;
-  
+  void apply_vote_unsafe(const VoteInfo& vote);
+
   // Optimistic confirmation logic
   bool check_optimistic_confirmation_conditions(const Hash& block_hash) const;
-  void process_optimistic_confirmations();
-  
+  void confirm_block_unsafe(BlockMetadata& block);
+
   // Rooting logic
   bool check_rooting_conditions(const Hash& block_hash) const;
-  void process_rooting_candidates();
-  
+  bool root_block_unsafe(const Hash& block_hash);
+
+  // Walk from a voted slot toward the root confirming and rooting blocks
+  // whose subtree stake now crosses the thresholds
+  void process_commitment_along(Slot slot);
+
   // Maintenance operations
-  void cleanup_expired_votes();
   void prune_old_blocks();
   bool is_block_expired(const BlockMetadata& block) const;
-  
+
   // Helper methods
-  std::vector<Hash> build_chain_to_root(const Hash& block_hash) const;
   uint64_t count_stake_supporting_block(const Hash& block_hash) const;
   uint64_t count_stake_supporting_block_unsafe(const Hash& block_hash) const;
   bool is_ancestor_unsafe(const Hash& potential_ancestor, const Hash& descendant) const;
-  void update_fork_metrics(Fork& fork);
-  bool is_valid_fork_transition(const Hash& from, const Hash& to) const;
-  
+  Slot slot_of_unsafe(const Hash& block_hash) const;
+
   // LRU cache management
   void update_weight_cache_lru(const Hash& block_hash) const;
   void evict_weight_cache_lru() const;
-  
-  // Event-driven confirmation
-  void add_pending_confirmation_block(const Hash& block_hash);
-  void process_pending_confirmations();
-  
-  // Stake aggregation
-  void rebuild_stake_aggregation() const;
-  void update_stake_aggregation_for_vote(const VoteInfo& vote) const;
 };
 
 } // namespace consensus
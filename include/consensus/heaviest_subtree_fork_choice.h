@@ -0,0 +1,124 @@
+#pragma once
+
+#include "common/types.h"
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace slonana {
+namespace consensus {
+
+using namespace slonana::common;
+
+/**
+ * Stake-weighted fork choice over the tree of slots above the root
+ * Compatible with Agave's HeaviestSubtreeForkChoice
+ *
+ * Every slot stores the stake of the latest votes landing on it, the stake
+ * voted on its whole subtree and the heaviest leaf below it. Only each
+ * validator's latest vote counts: moving it subtracts the validator's stake
+ * along the old vote's path to the root and adds it along the new one,
+ * refreshing each ancestor's best descendant on the way, so a vote costs
+ * O(depth x fanout) and the fork choice head is read in O(1).
+ *
+ * Nodes live in a deque indexed by slot - root, so parent and ancestor
+ * queries are array walks rather than hash lookups. One block per slot is
+ * tracked; a second block for a slot is rejected.
+ *
+ * Not synchronized: the owner serializes access.
+ */
+class HeaviestSubtreeForkChoice {
+public:
+  static constexpr Slot NO_SLOT = UINT64_MAX;
+
+  HeaviestSubtreeForkChoice() = default;
+
+  /**
+   * Add a block; the first block added becomes the root
+   * @return false if the parent is unknown, the slot does not follow it or
+   * the slot is already present
+   */
+  bool add_block(Slot slot, Slot parent);
+
+  /**
+   * Record a validator's vote; only votes newer than their latest count.
+   * Votes for slots not added yet are applied when the block arrives.
+   * @return true if the vote became the validator's latest
+   */
+  bool add_vote(const PublicKey &validator, Slot slot, uint64_t stake);
+
+  /**
+   * Make slot the root and drop every node that does not descend from it
+   * @return the dropped slots that are not ancestors of the new root, in
+   *         slot order; they belong to forks that can never be finalized
+   */
+  std::vector<Slot> set_root(Slot root);
+
+  bool contains(Slot slot) const;
+  bool empty() const { return root_ == NO_SLOT; }
+  size_t size() const { return size_; }
+  Slot root() const { return root_; }
+
+  /// Fork choice head: heaviest leaf under the root
+  Slot best_slot() const { return best_slot(root_); }
+  /// Heaviest leaf under a slot, NO_SLOT if unknown
+  Slot best_slot(Slot slot) const;
+
+  /// Parent of a slot, NO_SLOT for the root or unknown slots
+  Slot parent(Slot slot) const;
+  const std::vector<Slot> &children(Slot slot) const;
+
+  /// Stake of latest votes on the slot itself
+  uint64_t stake_voted_at(Slot slot) const;
+  /// Stake of latest votes on the slot and its descendants
+  uint64_t stake_voted_subtree(Slot slot) const;
+
+  /// True if ancestor is descendant or lies on its path to the root
+  bool is_ancestor(Slot ancestor, Slot descendant) const;
+
+  /// Latest vote slot of a validator, NO_SLOT if none
+  Slot latest_vote(const PublicKey &validator) const;
+
+  void clear();
+
+private:
+  struct Node {
+    bool present = false;
+    Slot parent = NO_SLOT;
+    Slot best = NO_SLOT;
+    uint64_t stake_voted_at = 0;
+    uint64_t stake_voted_subtree = 0;
+    std::vector<Slot> children;
+  };
+
+  struct LatestVote {
+    Slot slot = NO_SLOT;
+    uint64_t stake = 0;
+    bool applied = false; // Counted in the tree (slot present)
+  };
+
+  std::deque<Node> nodes_; // nodes_[slot - root_]
+  Slot root_ = NO_SLOT;
+  size_t size_ = 0;
+
+  std::unordered_map<PublicKey, LatestVote> latest_votes_;
+  // Votes waiting for their block, by slot
+  std::unordered_map<Slot, std::vector<PublicKey>> pending_votes_;
+
+  Node *node(Slot slot);
+  const Node *node(Slot slot) const;
+
+  /// Add delta to the vote at slot and refresh subtree stake and best
+  /// descendant along its path to the root
+  void apply_stake(Slot slot, uint64_t stake, bool add);
+  /// Move one validator's stake between two present slots, touching only the
+  /// paths below their common ancestor
+  void move_stake(Slot from, Slot to, uint64_t stake);
+  /// Refresh best upward from `slot` until it stops changing
+  void propagate_best(Slot slot);
+  void refresh_best(Node &node, Slot slot);
+};
+
+} // namespace consensus
+} // namespace slonana
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "common/types.h"
+#include "staking/manager.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace slonana {
+namespace consensus {
+
+using namespace slonana::common;
+
+/**
+ * Stake-weighted leader schedule of one epoch
+ * Compatible with Agave's LeaderSchedule
+ *
+ * Validators are taken in the epoch stakes order (descending stake, ties by
+ * descending identity). A ChaCha20 stream seeded with the epoch number
+ * (little-endian in the first 8 seed bytes) picks one leader for every
+ * NUM_CONSECUTIVE_LEADER_SLOTS slots, sampling stake-proportionally exactly
+ * as rand's WeightedIndex does. Only the picks are stored, as indices into
+ * the validator list, so a slot's leader is two array reads.
+ */
+class LeaderSchedule {
+public:
+  static constexpr uint64_t NUM_CONSECUTIVE_LEADER_SLOTS = 4;
+
+  LeaderSchedule(const staking::EpochStakes &stakes, uint64_t slots_per_epoch);
+
+  Epoch epoch() const { return epoch_; }
+  Slot first_slot() const { return first_slot_; }
+  uint64_t slot_count() const { return slot_count_; }
+
+  /// Leader of an absolute slot, nullptr outside the epoch or without stake
+  const PublicKey *leader_at(Slot slot) const;
+
+  /// Slot indices (relative to the first slot) led by identity
+  std::vector<uint64_t> leader_slots(const PublicKey &identity) const;
+
+  const std::vector<PublicKey> &validators() const { return validators_; }
+  /// Validator index leading each run of NUM_CONSECUTIVE_LEADER_SLOTS slots
+  const std::vector<uint32_t> &leader_indices() const { return leader_indices_; }
+
+private:
+  Epoch epoch_;
+  Slot first_slot_;
+  uint64_t slot_count_;
+  std::vector<PublicKey> validators_;
+  std::vector<uint32_t> leader_indices_;
+};
+
+/**
+ * Leader schedules by epoch, drawn once and shared
+ *
+ * The stakes for an epoch come from the provider, normally
+ * StakingManager::get_epoch_stakes. notify_slot() reports the working slot;
+ * once it is within the precompute lookahead of the next epoch, that
+ * epoch's schedule is drawn on a background thread so lookups across the
+ * boundary do not wait. The provider itself is always called on the
+ * caller's thread, which keeps it under the caller's synchronization.
+ *
+ * Like Agave, schedules are only produced up to one epoch past the latest
+ * notified slot, so far-future lookups do not freeze stakes early.
+ */
+class LeaderScheduleCache {
+public:
+  using StakesProvider =
+      std::function<std::shared_ptr<const staking::EpochStakes>(Epoch)>;
+
+  static constexpr size_t MAX_SCHEDULES = 4;
+  static constexpr uint64_t DEFAULT_PRECOMPUTE_LOOKAHEAD = 2000;
+
+  explicit LeaderScheduleCache(
+      StakesProvider provider,
+      uint64_t slots_per_epoch = staking::StakingManager::DEFAULT_SLOTS_PER_EPOCH,
+      uint64_t precompute_lookahead = DEFAULT_PRECOMPUTE_LOOKAHEAD);
+  ~LeaderScheduleCache();
+
+  LeaderScheduleCache(const LeaderScheduleCache &) = delete;
+  LeaderScheduleCache &operator=(const LeaderScheduleCache &) = delete;
+
+  /**
+   * Schedule of an epoch, drawn now if needed (or awaited if being
+   * precomputed); nullptr beyond the schedulable epochs
+   */
+  std::shared_ptr<const LeaderSchedule> get_epoch_schedule(Epoch epoch);
+
+  /// Leader of a slot, nullopt if its epoch is not schedulable or unstaked
+  std::optional<PublicKey> slot_leader(Slot slot);
+
+  /**
+   * Advance the working slot; starts the next epoch's schedule in the
+   * background when the boundary is within the lookahead
+   */
+  void notify_slot(Slot slot);
+
+  /// Stakes the schedule of an epoch is drawn from, straight from the provider
+  std::shared_ptr<const staking::EpochStakes> epoch_stakes(Epoch epoch) const {
+    return provider_ ? provider_(epoch) : nullptr;
+  }
+
+  Epoch epoch_of(Slot slot) const { return slot / slots_per_epoch_; }
+  uint64_t slots_per_epoch() const { return slots_per_epoch_; }
+  /// Schedules drawn on the background thread so far
+  uint64_t precomputed_count() const {
+    return precomputed_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr Epoch NO_EPOCH = UINT64_MAX;
+
+  bool schedulable(Epoch epoch) const;
+  std::shared_ptr<const LeaderSchedule>
+  store(Epoch epoch, std::shared_ptr<const LeaderSchedule> schedule);
+
+  StakesProvider provider_;
+  uint64_t slots_per_epoch_;
+  uint64_t precompute_lookahead_;
+  std::atomic<Slot> latest_slot_{0};
+  std::atomic<uint64_t> precomputed_{0};
+
+  mutable std::mutex mutex_;
+  std::condition_variable precompute_done_;
+  std::map<Epoch, std::shared_ptr<const LeaderSchedule>> schedules_;
+  Epoch precomputing_ = NO_EPOCH;
+  std::thread precompute_thread_;
+};
+
+} // namespace consensus
+} // namespace slonana
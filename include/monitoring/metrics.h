@@ -1,5 +1,6 @@
 #pragma once
 
+#include "monitoring/metrics_core.h"
 #include <chrono>
 #include <functional>
 #include <map>
@@ -164,6 +165,12 @@ public:
    * @return histogram buckets and statistics
    */
   virtual HistogramData get_data() const = 0;
+
+  /**
+   * @brief Get the raw log-linear distribution
+   * @return mergeable snapshot with exact sum, min and max
+   */
+  virtual HistogramSnapshot snapshot() const = 0;
 };
 
 /**
@@ -256,6 +263,59 @@ public:
   virtual void clear() = 0;
 };
 
+/**
+ * @brief One metric over a fixed set of values of a single label
+ *
+ * Every label value is registered once, when the vector is created, so the
+ * hot path indexes a handle by position with no key building, map lookup or
+ * registry lock.
+ */
+template <typename Metric> class MetricVec {
+public:
+  MetricVec() = default;
+  explicit MetricVec(std::vector<std::shared_ptr<Metric>> handles)
+      : handles_(std::move(handles)) {}
+
+  Metric &operator[](size_t index) const { return *handles_[index]; }
+  size_t size() const { return handles_.size(); }
+
+private:
+  std::vector<std::shared_ptr<Metric>> handles_;
+};
+
+using CounterVec = MetricVec<ICounter>;
+using GaugeVec = MetricVec<IGauge>;
+using HistogramVec = MetricVec<IHistogram>;
+
+/**
+ * @brief Register a counter for each value of `label`
+ * @return handles in the order of `values`
+ */
+CounterVec make_counter_vec(IMetricsRegistry &registry, const std::string &name,
+                            const std::string &help, const std::string &label,
+                            const std::vector<std::string> &values,
+                            const std::map<std::string, std::string> &labels = {});
+
+/**
+ * @brief Register a gauge for each value of `label`
+ * @return handles in the order of `values`
+ */
+GaugeVec make_gauge_vec(IMetricsRegistry &registry, const std::string &name,
+                        const std::string &help, const std::string &label,
+                        const std::vector<std::string> &values,
+                        const std::map<std::string, std::string> &labels = {});
+
+/**
+ * @brief Register a histogram for each value of `label`
+ * @return handles in the order of `values`
+ */
+HistogramVec
+make_histogram_vec(IMetricsRegistry &registry, const std::string &name,
+                   const std::string &help, const std::string &label,
+                   const std::vector<std::string> &values,
+                   const std::vector<double> &buckets,
+                   const std::map<std::string, std::string> &labels = {});
+
 /**
  * @brief Metrics exporter interface for different output formats
  */
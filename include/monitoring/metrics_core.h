@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace slonana {
+namespace monitoring {
+
+/**
+ * Lock-free metric primitives
+ *
+ * Writers touch only their own shard: each thread is given a shard index
+ * the first time it records anything, and shards live on separate cache
+ * lines, so increments from different threads never contend. Shards are
+ * summed only when a snapshot is taken (a scrape), so reads are the slow
+ * side.
+ */
+
+/// Number of shards per metric: hardware threads rounded up to a power of
+/// two, at most 64
+size_t metrics_shard_count();
+
+namespace detail {
+size_t assign_metrics_shard();
+inline thread_local size_t metrics_shard = assign_metrics_shard();
+
+/// Relaxed add for atomic<double> (its fetch_add is not in every standard
+/// library yet)
+inline void atomic_add(std::atomic<double> &target, double amount) noexcept {
+  double current = target.load(std::memory_order_relaxed);
+  while (!target.compare_exchange_weak(current, current + amount,
+                                       std::memory_order_relaxed)) {
+  }
+}
+} // namespace detail
+
+/// Calling thread's shard, in [0, metrics_shard_count())
+inline size_t metrics_shard_index() noexcept { return detail::metrics_shard; }
+
+/**
+ * Counter split into per-thread shards. Whole increments go to an integer
+ * cell; fractional amounts to a separate double cell in the same shard.
+ */
+class ShardedCounter {
+public:
+  ShardedCounter();
+
+  void add(uint64_t amount = 1) noexcept {
+    shards_[metrics_shard_index()].count.fetch_add(amount,
+                                                   std::memory_order_relaxed);
+  }
+  void add(double amount) noexcept {
+    detail::atomic_add(shards_[metrics_shard_index()].fraction, amount);
+  }
+
+  /// Sum over all shards; concurrent increments may or may not be included
+  double value() const noexcept;
+  void reset() noexcept;
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> fraction{0.0};
+  };
+
+  std::unique_ptr<Shard[]> shards_;
+};
+
+/**
+ * Aggregated histogram contents. Snapshots taken from histograms with the
+ * same layout can be merged, e.g. across shards or processes.
+ */
+struct HistogramSnapshot {
+  std::vector<uint64_t> counts; ///< Per bucket, see LogLinearHistogram
+  uint64_t count = 0;
+  double sum = 0.0;
+  double min = 0.0; ///< Exact; 0 when empty
+  double max = 0.0; ///< Exact; 0 when empty
+
+  void merge(const HistogramSnapshot &other);
+  /// Value at quantile q in [0, 1], within the bucket precision
+  double quantile(double q) const;
+  /**
+   * Observations in buckets whose upper edge is at or below `bound`: a
+   * lower bound on the observations <= `bound`, exact when `bound` falls on
+   * a bucket edge
+   */
+  uint64_t count_at_or_below(double bound) const;
+};
+
+/**
+ * Log-linear (HDR-style) histogram over positive doubles
+ *
+ * Every power of two between 2^MIN_EXPONENT and 2^MAX_EXPONENT is split
+ * into 2^SUB_BUCKET_BITS equal-width buckets, so a value's bucket is found
+ * from its exponent and leading mantissa bits with no search, and relative
+ * error is at most 1/16 across the whole range. Values at or below the
+ * range (including zero and negatives) go to the first bucket, values
+ * above it to the last; sum, min and max stay exact.
+ *
+ * Each shard (about 8 KiB) is allocated by the first thread that records
+ * into it.
+ */
+class LogLinearHistogram {
+public:
+  static constexpr int SUB_BUCKET_BITS = 4;
+  static constexpr int MIN_EXPONENT = -32; ///< ~2.3e-10
+  static constexpr int MAX_EXPONENT = 32;  ///< ~4.3e9
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKETS =
+      size_t(MAX_EXPONENT - MIN_EXPONENT) * SUB_BUCKETS + 2;
+
+  LogLinearHistogram();
+  ~LogLinearHistogram();
+
+  LogLinearHistogram(const LogLinearHistogram &) = delete;
+  LogLinearHistogram &operator=(const LogLinearHistogram &) = delete;
+
+  void record(double value) noexcept;
+  HistogramSnapshot snapshot() const;
+
+  static size_t bucket_index(double value) noexcept;
+  static double bucket_lower_bound(size_t index);
+  static double bucket_upper_bound(size_t index);
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<double> sum{0.0};
+    std::atomic<double> min;
+    std::atomic<double> max;
+
+    Shard();
+  };
+
+  Shard &shard() noexcept;
+
+  std::unique_ptr<std::atomic<Shard *>[]> shards_;
+};
+
+} // namespace monitoring
+} // namespace slonana
@@ -1,14 +1,20 @@
 #pragma once
 
 #include "monitoring/metrics.h"
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 
 namespace slonana {
 namespace monitoring {
 
 /**
- * @brief Prometheus format metrics exporter
+ * @brief Prometheus text format metrics exporter
+ *
+ * Reads each metric once per scrape (histograms through a single snapshot)
+ * and groups series by metric name, so labelled handles of one metric share
+ * a single HELP/TYPE header.
  */
 class PrometheusExporter : public IMetricsExporter {
 public:
@@ -19,15 +25,14 @@ public:
   std::string get_content_type() const override;
 
 private:
-  std::string format_counter(const std::string &name, double value,
-                             const std::string &help = "");
-  std::string format_gauge(const std::string &name, double value,
-                           const std::string &help = "");
-  std::string format_histogram(const std::string &name,
-                               const std::vector<double> &buckets,
-                               const std::string &help = "");
-  std::string escape_label_value(const std::string &value);
+  void format_simple(std::ostringstream &output, const IMetric &metric);
+  void format_histogram(std::ostringstream &output, const std::string &name,
+                        const IHistogram &histogram);
+  void format_labels(std::ostringstream &output,
+                     const std::map<std::string, std::string> &labels);
+  static std::string format_value(double value);
+  static std::string escape_label_value(const std::string &value);
 };
 
 } // namespace monitoring
-} // namespace slonana
\ No newline at end of file
+} // namespace slonana
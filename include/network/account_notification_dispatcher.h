@@ -0,0 +1,169 @@
+#pragma once
+
+#include "common/types.h"
+#include "network/websocket_server.h"
+#include "storage/account_change_feed.h"
+#include "storage/accounts_db.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace slonana {
+namespace network {
+
+using namespace slonana::common;
+
+/**
+ * @brief Turns committed account writes into accountNotification and
+ * programNotification messages.
+ *
+ * Records are drained from the account store's change feed and grouped by
+ * slot, keeping only the newest write per account. A slot's changes are
+ * delivered once per commitment level as fork choice reports the slot
+ * processed, confirmed and finally rooted; accounts nobody subscribes to
+ * (directly or through their owner program) are never loaded, and each
+ * account that is loaded is encoded at most once per encoding no matter how
+ * many subscribers or commitment levels it reaches.
+ *
+ * Slots abandoned by fork choice must be reported through on_slot_dead(),
+ * otherwise a later root finalizes every pending slot at or below it.
+ */
+class AccountNotificationDispatcher {
+public:
+  /// Reads an account as of a slot, e.g. AccountsDB::get_account_at_slot
+  using AccountLoader = std::function<std::optional<storage::AccountData>(
+      const PublicKey &, uint64_t)>;
+  /// Called with the base58 address of every account changed in a batch
+  using ChangeListener = std::function<void(const std::string &)>;
+
+  struct Config {
+    size_t max_batch = 4096;                  ///< Records drained per poll
+    std::chrono::milliseconds poll_interval{2}; ///< Idle wait between polls
+    size_t max_pending_slots = 512; ///< Oldest unrooted slots are dropped
+  };
+
+  struct Stats {
+    uint64_t records_drained = 0;
+    uint64_t duplicate_writes = 0; ///< Superseded by a newer write in a slot
+    uint64_t accounts_loaded = 0;
+    uint64_t encodings = 0;
+    uint64_t notifications_published = 0;
+    uint64_t slots_finalized = 0;
+    uint64_t slots_discarded = 0; ///< Dead, or evicted by max_pending_slots
+    uint64_t feed_dropped = 0;
+  };
+
+  AccountNotificationDispatcher(
+      std::shared_ptr<storage::AccountChangeFeed> feed,
+      std::shared_ptr<WebSocketServer> websocket_server, AccountLoader loader);
+  AccountNotificationDispatcher(
+      std::shared_ptr<storage::AccountChangeFeed> feed,
+      std::shared_ptr<WebSocketServer> websocket_server, AccountLoader loader,
+      const Config &config);
+  ~AccountNotificationDispatcher();
+
+  AccountNotificationDispatcher(const AccountNotificationDispatcher &) =
+      delete;
+  AccountNotificationDispatcher &
+  operator=(const AccountNotificationDispatcher &) = delete;
+
+  /// Set before start(); e.g. RpcServer::invalidate_account
+  void set_change_listener(ChangeListener listener);
+
+  bool start();
+  void stop();
+  bool is_running() const { return running_.load(); }
+
+  /**
+   * Drain the feed, apply queued commitment events and publish. Runs on the
+   * dispatcher thread once started; exposed for callers that drive it
+   * themselves. Not safe to call concurrently with itself.
+   * @return Number of (subscription key, commitment, encoding) publications
+   */
+  size_t poll();
+
+  // Commitment events; cheap and callable from any thread (including fork
+  // choice callbacks that hold fork choice locks)
+  void on_slot_processed(Slot slot);
+  void on_slot_confirmed(Slot slot);
+  void on_slot_rooted(Slot slot);
+  void on_slot_dead(Slot slot);
+
+  Stats get_stats() const;
+  /// Slots holding changes that have not been finalized yet
+  size_t pending_slot_count() const;
+
+private:
+  using KeyBytes = std::array<uint8_t, 32>;
+
+  struct KeyHash {
+    size_t operator()(const KeyBytes &key) const noexcept;
+  };
+
+  enum class Event : uint8_t { PROCESSED, CONFIRMED, ROOTED, DEAD };
+
+  struct PendingChange {
+    storage::AccountChangeRecord record;
+    std::string address;       ///< base58 pubkey
+    std::string owner_address; ///< base58 owner program
+    int delivered = -1; ///< Highest CommitmentLevel published, -1 for none
+    bool loaded = false;
+    std::optional<storage::AccountData> account;
+    std::array<std::string, 2> value; ///< Encoded value per AccountEncoding
+  };
+
+  struct PendingSlot {
+    std::unordered_map<KeyBytes, PendingChange, KeyHash> changes;
+    int reached = -1; ///< Highest CommitmentLevel the slot has reached
+  };
+
+  size_t drain_feed();
+  size_t advance(Slot slot, int level);
+  size_t deliver(Slot slot, PendingSlot &pending, int level,
+                 bool only_new = false);
+  size_t deliver_change(Slot slot, PendingChange &change, int level);
+  const std::string &encoded_value(PendingChange &change,
+                                   AccountEncoding encoding);
+  void dispatcher_loop();
+
+  std::shared_ptr<storage::AccountChangeFeed> feed_;
+  std::shared_ptr<WebSocketServer> websocket_server_;
+  AccountLoader loader_;
+  ChangeListener change_listener_;
+  Config config_;
+
+  // Owned by the polling thread
+  std::map<Slot, PendingSlot> pending_;
+  std::vector<storage::AccountChangeRecord> drain_buffer_;
+
+  // Commitment events from fork choice
+  std::mutex events_mutex_;
+  std::condition_variable events_cv_;
+  std::vector<std::pair<Slot, Event>> events_;
+
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+
+  std::atomic<uint64_t> records_drained_{0};
+  std::atomic<uint64_t> duplicate_writes_{0};
+  std::atomic<uint64_t> accounts_loaded_{0};
+  std::atomic<uint64_t> encodings_{0};
+  std::atomic<uint64_t> notifications_published_{0};
+  std::atomic<uint64_t> slots_finalized_{0};
+  std::atomic<uint64_t> slots_discarded_{0};
+  std::atomic<size_t> pending_slots_{0};
+};
+
+} // namespace network
+} // namespace slonana
@@ -1,8 +1,15 @@
 #pragma once
 
+#include "crds_gossip_pull.h"
+#include "crds_shards.h"
 #include "crds_value.h"
+#include "protocol.h"
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -39,9 +46,26 @@ enum class CrdsError {
  *
  * This is the main data structure for the gossip protocol.
  * It stores versioned CRDS values and handles conflict resolution.
+ *
+ * The table is split into NUM_SHARDS shards by the pubkey of each label, so
+ * every value of one node lives in one shard and writers for different
+ * nodes do not contend. Stored values are immutable: an update publishes a
+ * new VersionedCrdsValue and readers keep the version they already hold
+ * (read-copy-update), holding a shard's shared lock only while copying
+ * pointers. Each shard indexes its values by ordinal and by hash prefix
+ * (CrdsShards) so the pull responder only visits the partition a
+ * requester's filter covers.
+ *
+ * The table also keeps this node's own pull request filters (CrdsFilterSet)
+ * current as values are inserted, replaced and trimmed, so a pull round
+ * copies a few sampled partitions instead of re-hashing the whole table.
  */
 class Crds {
 public:
+  using ValuePtr = std::shared_ptr<const VersionedCrdsValue>;
+
+  static constexpr size_t NUM_SHARDS = 64;
+
   Crds();
   ~Crds();
 
@@ -58,9 +82,9 @@ public:
   bool upserts(const CrdsValue &value) const;
 
   /**
-   * Get a value by its label
+   * Get a value by its label; the snapshot stays valid after updates
    */
-  const VersionedCrdsValue *get(const CrdsValueLabel &label) const;
+  ValuePtr get(const CrdsValueLabel &label) const;
 
   /**
    * Get all values from a specific pubkey
@@ -81,13 +105,32 @@ public:
   /**
    * Get a specific contact info
    */
-  const ContactInfo *get_contact_info(const PublicKey &pubkey) const;
+  std::shared_ptr<const ContactInfo>
+  get_contact_info(const PublicKey &pubkey) const;
 
   /**
    * Get all votes for a pubkey
    */
   std::vector<Vote> get_votes(const PublicKey &pubkey) const;
 
+  /**
+   * Pull responder: values in the filter's hash partition that the filter
+   * does not contain. Skips the requester's own values and values with a
+   * wallclock after max_wallclock; stops after max_values.
+   */
+  std::vector<ValuePtr> filter_pull_responses(const CrdsFilter &filter,
+                                              const PublicKey &requester,
+                                              uint64_t max_wallclock,
+                                              size_t max_values) const;
+
+  /**
+   * Pull requester: up to max_filters randomly sampled partition filters
+   * covering the whole table between them once all are sent. Stale
+   * partitions are rebuilt, and the partitioning grows or shrinks with the
+   * table, before copying.
+   */
+  std::vector<CrdsFilter> build_pull_filters(size_t max_filters);
+
   /**
    * Remove entries older than timeout
    */
@@ -116,38 +159,55 @@ public:
   void clear();
 
 private:
-  // Main table: label -> versioned value
-  std::unordered_map<CrdsValueLabel, VersionedCrdsValue> table_;
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    // Main table: label -> versioned value
+    std::unordered_map<CrdsValueLabel, ValuePtr> table;
+    // Index: pubkey -> set of labels
+    std::unordered_map<PublicKey, std::unordered_set<CrdsValueLabel>> records;
+    // Index: ordinal -> value, in insertion order
+    std::map<uint64_t, ValuePtr> by_ordinal;
+    // Index: hash prefix partition -> ordinals
+    CrdsShards by_hash;
+  };
 
-  // Index: pubkey -> set of labels
-  std::unordered_map<PublicKey, std::unordered_set<CrdsValueLabel>> records_;
+  std::array<Shard, NUM_SHARDS> shards_;
 
   // Ordinal counter for insertion order
-  uint64_t ordinal_counter_;
+  std::atomic<uint64_t> ordinal_counter_;
+
+  std::atomic<size_t> num_values_;
+  std::atomic<size_t> num_nodes_;
+  std::atomic<size_t> num_votes_;
 
-  // Mutex for thread-safe operations
-  mutable std::mutex mutex_;
+  // Own pull filters. Writers update them after releasing their shard
+  // lock; rebuilds hold filter_mutex_ while taking shard locks
+  std::mutex filter_mutex_;
+  CrdsFilterSet filter_set_;
 
   // Statistics
   struct Stats {
-    size_t num_inserts = 0;
-    size_t num_updates = 0;
-    size_t num_failures = 0;
-    size_t num_trims = 0;
+    std::atomic<size_t> num_inserts{0};
+    std::atomic<size_t> num_updates{0};
+    std::atomic<size_t> num_failures{0};
+    std::atomic<size_t> num_trims{0};
+    std::atomic<size_t> num_filter_rebuilds{0};
   };
   Stats stats_;
 
-  // Helper: Check if value overrides existing
-  bool overrides(const CrdsValue &value,
-                 const VersionedCrdsValue &existing) const;
+  Shard &shard_for(const PublicKey &pubkey);
+  const Shard &shard_for(const PublicKey &pubkey) const;
+
+  // Helper: Refill one filter partition from the hash indices
+  void rebuild_filter(size_t partition);
 
   // Helper: Update indices when inserting
-  void update_indices(const CrdsValueLabel &label,
-                      const VersionedCrdsValue &value);
+  void update_indices(Shard &shard, const CrdsValueLabel &label,
+                      const ValuePtr &value);
 
   // Helper: Remove from indices
-  void remove_from_indices(const CrdsValueLabel &label,
-                           const VersionedCrdsValue &value);
+  void remove_from_indices(Shard &shard, const CrdsValueLabel &label,
+                           const ValuePtr &value);
 };
 
 } // namespace gossip
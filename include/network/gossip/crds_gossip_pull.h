@@ -0,0 +1,79 @@
+#pragma once
+
+#include "protocol.h"
+#include <cstdint>
+#include <vector>
+
+namespace slonana {
+namespace network {
+namespace gossip {
+
+/**
+ * CrdsFilterSet - Pull request bloom filters, one per hash partition
+ * Based on Agave: gossip/src/crds_gossip_pull.rs (CrdsFilterSet)
+ *
+ * The hash space is split into 2^mask_bits partitions by the top bits of
+ * hash_prefix(), each with a fixed-size filter that fits in one pull request
+ * packet. Filters are kept up to date as values come and go instead of
+ * being rebuilt for every pull round: additions set bits directly, while
+ * removals (updates and trims) can only be counted, since a bloom filter
+ * cannot forget. A partition whose stale count grows too large, or that
+ * overflows, reports is_stale() and is rebuilt by the owner.
+ *
+ * Not synchronized: the owner (Crds) guards it with its own lock.
+ */
+class CrdsFilterSet {
+public:
+  /// Items per filter: 10 bits each keeps a full filter under 1 KiB
+  static constexpr size_t MAX_ITEMS_PER_FILTER = 742;
+
+  explicit CrdsFilterSet(uint32_t mask_bits = 0);
+
+  /// Smallest mask_bits whose partitions hold num_items without overflow
+  static uint32_t mask_bits_for(size_t num_items);
+
+  /// A value entered the table
+  void add(const Hash &hash);
+
+  /// A value left the table (replaced or trimmed)
+  void remove(const Hash &hash);
+
+  /// Partition a hash falls in
+  size_t partition_of(const Hash &hash) const;
+
+  /// True if the table outgrew the partitions or shrank far below them
+  bool needs_resize() const;
+
+  /// True if a partition's filter should be rebuilt from the table
+  bool is_stale(size_t partition) const;
+
+  /// Empty every partition and re-split with a new mask_bits
+  void resize(uint32_t mask_bits);
+
+  /// Empty one partition ahead of refilling it through add()
+  void reset(size_t partition);
+
+  const CrdsFilter &filter(size_t partition) const {
+    return partitions_[partition].filter;
+  }
+  size_t num_filters() const { return partitions_.size(); }
+  uint32_t mask_bits() const { return mask_bits_; }
+  size_t num_items() const { return num_items_; }
+
+private:
+  struct Partition {
+    CrdsFilter filter;
+    size_t live = 0;  // Values in the table that hash here
+    size_t stale = 0; // Removed values whose bits are still set
+  };
+
+  uint32_t mask_bits_;
+  std::vector<Partition> partitions_;
+  size_t num_items_;
+
+  CrdsFilter make_filter(size_t partition) const;
+};
+
+} // namespace gossip
+} // namespace network
+} // namespace slonana
@@ -2,73 +2,105 @@
 
 #include "crds_value.h"
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
-#include <unordered_set>
 
 namespace slonana {
 namespace network {
 namespace gossip {
 
 /**
- * CrdsShards - Sharding for efficient CRDS data management
+ * CrdsShards - Index of CRDS entries by value hash prefix
  * Based on Agave: gossip/src/crds_shards.rs
- * 
- * Shards CRDS entries by pubkey for efficient lookups and range queries
- * Optimizes performance for large clusters (>1000 nodes)
+ *
+ * Entries are bucketed by the top shard_bits bits of hash_prefix(hash), so
+ * a pull request filter covering one mask partition only visits the
+ * entries that can fall inside it instead of the whole table.
+ *
+ * Not synchronized: the owner (a Crds shard) guards it with its own lock.
  */
 class CrdsShards {
 public:
   /**
    * Constructor
-   * @param num_shards Number of shards (power of 2 recommended)
+   * @param num_shards Number of shards, rounded up to a power of 2
    */
   explicit CrdsShards(size_t num_shards = 256);
-  
+
   /**
    * Insert an entry into the appropriate shard
-   * @param index The CRDS table index
+   * @param index The CRDS table index (ordinal)
    * @param value The versioned CRDS value
    */
   void insert(size_t index, const VersionedCrdsValue *value);
-  
+
   /**
    * Remove an entry from its shard
-   * @param index The CRDS table index
+   * @param index The CRDS table index (ordinal)
    * @param value The versioned CRDS value
    */
   void remove(size_t index, const VersionedCrdsValue *value);
-  
+
   /**
-   * Get all indices in a shard for a given pubkey
-   * @param pubkey The public key to query
-   * @return Set of CRDS table indices
+   * Visit every entry whose hash matches a filter partition
+   * @param mask CrdsFilter::mask()
+   * @param mask_bits CrdsFilter::mask_bits()
+   * @param visit Called with (index, const VersionedCrdsValue *)
    */
-  std::unordered_set<size_t> get_indices(const PublicKey &pubkey) const;
-  
+  template <typename Visitor>
+  void find(uint64_t mask, uint32_t mask_bits, Visitor &&visit) const {
+    uint64_t ones = mask_bits >= 64 ? 0 : (~0ULL >> mask_bits);
+    mask |= ones;
+    if (mask_bits > shard_bits_) {
+      // Finer than a shard: test the prefix of each entry in it
+      for (const auto &[index, entry] : shards_[shard_of(mask)]) {
+        if ((entry.prefix | ones) == mask) {
+          visit(index, entry.value);
+        }
+      }
+      return;
+    }
+    // The partition spans 2^(shard_bits - mask_bits) whole shards
+    size_t first = shard_of(mask & ~ones);
+    size_t count = size_t{1} << (shard_bits_ - mask_bits);
+    for (size_t shard = first; shard < first + count; ++shard) {
+      for (const auto &[index, entry] : shards_[shard]) {
+        visit(index, entry.value);
+      }
+    }
+  }
+
   /**
    * Get a random sample of entries from shards
    * @param max_count Maximum number of entries to return
    * @return Vector of CRDS table indices
    */
   std::vector<size_t> sample(size_t max_count) const;
-  
+
   /**
    * Get total number of entries across all shards
    */
-  size_t size() const;
-  
+  size_t size() const { return size_; }
+
   /**
    * Clear all shards
    */
   void clear();
 
 private:
-  size_t num_shards_;
-  std::vector<std::unordered_set<size_t>> shards_;
-  mutable std::mutex mutex_;
-  
-  // Hash a pubkey to a shard index
-  size_t shard_index(const PublicKey &pubkey) const;
+  struct Entry {
+    uint64_t prefix;
+    const VersionedCrdsValue *value;
+  };
+
+  uint32_t shard_bits_;
+  std::vector<std::unordered_map<size_t, Entry>> shards_; // index -> entry
+  size_t size_;
+
+  size_t shard_of(uint64_t prefix) const {
+    return shard_bits_ == 0 ? 0
+                            : static_cast<size_t>(prefix >> (64 - shard_bits_));
+  }
 };
 
 } // namespace gossip
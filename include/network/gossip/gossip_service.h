@@ -39,6 +39,8 @@ public:
     uint64_t trim_interval_ms = 10000;   // Trim old entries interval
     uint64_t entry_timeout_ms = 30000;   // Entry timeout
     bool enable_ping_pong = true;   // Enable ping/pong for latency
+    size_t max_pull_response_values = 1024; // Values answered per pull request
+    size_t max_pull_filters = 8;    // Filter partitions requested per round
   };
 
   explicit GossipService(const Config &config);
@@ -72,7 +74,8 @@ public:
   /**
    * Get contact info for a specific node
    */
-  const ContactInfo *get_contact_info(const PublicKey &pubkey) const;
+  std::shared_ptr<const ContactInfo>
+  get_contact_info(const PublicKey &pubkey) const;
 
   /**
    * Get all known peers
@@ -148,7 +151,6 @@ private:
   struct PullState {
     std::vector<PublicKey> pull_peers; // Peers to pull from
     uint64_t last_pull_time = 0;
-    CrdsFilter filter; // Bloom filter of known values
     std::mutex mutex;
   };
   PullState pull_state_;
@@ -184,11 +186,11 @@ private:
   // Pull gossip logic
   void do_pull_gossip();
   std::vector<PublicKey> select_pull_peers(size_t count);
-  Protocol build_pull_request();
+  std::vector<Protocol> build_pull_requests(size_t max_filters);
 
   // Network operations
   bool send_message(const Protocol &msg, const std::string &dest_addr);
-  Result<Protocol> receive_message();
+  Result<Protocol> receive_message(std::string &from_addr);
 
   // Helper methods
   void update_active_set();
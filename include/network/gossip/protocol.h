@@ -43,20 +43,39 @@ class CrdsFilter {
 public:
   CrdsFilter();
   explicit CrdsFilter(size_t num_items);
+  /**
+   * Filter covering one partition of the hash space: values whose first
+   * mask_bits hash bits equal the top mask_bits of mask
+   */
+  CrdsFilter(size_t num_items, uint64_t mask, uint32_t mask_bits);
 
   void add(const Hash &hash);
   bool contains(const Hash &hash) const;
   void clear();
 
+  size_t num_bits() const { return num_bits_; }
+
+  uint64_t mask() const { return mask_; }
+  uint32_t mask_bits() const { return mask_bits_; }
+  /// True if the hash falls in this filter's partition
+  bool test_mask(const Hash &hash) const;
+
   std::vector<uint8_t> serialize() const;
+  /// Throws std::runtime_error on truncated or inconsistent input
   static CrdsFilter deserialize(const std::vector<uint8_t> &data);
 
 private:
   std::vector<uint64_t> bits_;
   size_t num_bits_;
   size_t num_hashes_;
+  uint64_t mask_;
+  uint32_t mask_bits_;
 };
 
+/// First 8 bytes of a value hash as a little-endian u64 (Agave hash_as_u64);
+/// its top bits select the hash partition
+uint64_t hash_prefix(const Hash &hash);
+
 /**
  * PingMessage - Ping for measuring latency
  * Agave: gossip/src/ping_pong.rs (Ping struct)
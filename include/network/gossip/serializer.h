@@ -53,13 +53,25 @@ public:
   static void write_u64(std::vector<uint8_t> &buf, uint64_t val);
   static void write_bytes(std::vector<uint8_t> &buf, const std::vector<uint8_t> &bytes);
   static void write_string(std::vector<uint8_t> &buf, const std::string &str);
-  
-private:
+
+  // Readers throw std::runtime_error on truncated input
   static uint8_t read_u8(const uint8_t *&ptr, const uint8_t *end);
   static uint16_t read_u16(const uint8_t *&ptr, const uint8_t *end);
   static uint32_t read_u32(const uint8_t *&ptr, const uint8_t *end);
   static uint64_t read_u64(const uint8_t *&ptr, const uint8_t *end);
   static std::vector<uint8_t> read_bytes(const uint8_t *&ptr, const uint8_t *end, size_t len);
+
+private:
+  /// Length prefix of a sequence whose elements take at least min_size bytes
+  static size_t read_len(const uint8_t *&ptr, const uint8_t *end,
+                         size_t min_size);
+  static std::vector<uint8_t> read_sized_bytes(const uint8_t *&ptr,
+                                               const uint8_t *end);
+  static std::string read_string(const uint8_t *&ptr, const uint8_t *end);
+  static std::vector<uint64_t> read_slots(const uint8_t *&ptr,
+                                          const uint8_t *end);
+  static CrdsData read_crds_data(const uint8_t *&ptr, const uint8_t *end);
+  static CrdsValue read_crds_value(const uint8_t *&ptr, const uint8_t *end);
 };
 
 } // namespace gossip
@@ -1,9 +1,9 @@
 #pragma once
 
+#include "common/chacha_rng.h"
 #include "common/types.h"
 #include <cstdint>
 #include <vector>
-#include <random>
 
 namespace slonana {
 namespace network {
@@ -14,47 +14,100 @@ using namespace slonana::common;
 /**
  * WeightedShuffle - Stake-weighted random peer selection
  * Based on Agave: gossip/src/weighted_shuffle.rs
- * 
+ *
  * Selects peers with probability proportional to their stake
  * for improved network security and efficiency
+ *
+ * Remaining weights live in a binary indexed (Fenwick) tree, so each draw
+ * finds and removes its node in O(log n) and the order is produced lazily:
+ * asking for the first k nodes costs O(k log n). The tree built from the
+ * full weight set is cached, so reset() or reseed() restore it with an O(n)
+ * copy and one instance can serve many shuffles over the same nodes (one
+ * per shred, per rotation, per pull round). Zero-weight nodes come last, in
+ * uniformly random order. Draws use ChaChaRng, so a seed fixes the order on
+ * every validator.
  */
 class WeightedShuffle {
 public:
+  /// Returned by next_index() once every node has been drawn
+  static constexpr size_t npos = SIZE_MAX;
+
   /**
    * Node with stake weight
    */
   struct WeightedNode {
     PublicKey pubkey;
     uint64_t stake;  // Stake weight in lamports
-    
+
     WeightedNode(const PublicKey &pk, uint64_t s) : pubkey(pk), stake(s) {}
   };
-  
+
   /**
    * Constructor
    * @param nodes Vector of nodes with their stake weights
    * @param seed Random seed for deterministic shuffling
    */
   WeightedShuffle(const std::vector<WeightedNode> &nodes, uint64_t seed = 0);
-  
+
+  /**
+   * Shuffle over indices 0..weights.size()-1 without node storage
+   * @param weights Weight of each index
+   * @param seed Random seed for deterministic shuffling
+   */
+  explicit WeightedShuffle(const std::vector<uint64_t> &weights,
+                           uint64_t seed = 0);
+
   /**
    * Get next node in weighted random order
-   * @return Pointer to next node, or nullptr if exhausted
+   * @return Pointer to next node, or nullptr if exhausted (always nullptr
+   * for index-only shuffles)
    */
   const WeightedNode *next();
-  
+
+  /**
+   * Draw the next index in weighted random order and remove it
+   * @return Index into the weights, or npos if exhausted
+   */
+  size_t next_index();
+
   /**
-   * Reset iterator to beginning
+   * Weighted draw that leaves every node in place (Agave: first())
+   * @return Index into the weights, or npos if nothing has weight
+   */
+  size_t sample_index();
+
+  /**
+   * Take an index out of the remaining set, e.g. the local node
+   */
+  void remove_index(size_t index);
+
+  /**
+   * Reset iterator to beginning: restores every node and rewinds the
+   * seed, so the same order is produced again
    */
   void reset();
-  
+
+  /**
+   * Restore every node and start a new order from another seed
+   */
+  void reseed(uint64_t seed);
+  void reseed(const ChaChaRng::Seed &seed);
+
   /**
    * Get shuffled nodes in order
    * @param max_count Maximum number to return
    * @return Vector of nodes in weighted random order
    */
   std::vector<WeightedNode> get_shuffled(size_t max_count = SIZE_MAX);
-  
+
+  /**
+   * First max_count indices of the order for the current seed; resets
+   * before drawing
+   */
+  std::vector<size_t> shuffle_indices(size_t max_count = SIZE_MAX);
+
+  size_t size() const { return weights_.size(); }
+
   /**
    * Static helper: Select random node weighted by stake
    * @param nodes Nodes to select from
@@ -66,13 +119,26 @@ public:
 
 private:
   std::vector<WeightedNode> nodes_;
-  std::vector<size_t> shuffled_indices_;
-  size_t current_index_;
-  uint64_t seed_;
-  std::mt19937_64 rng_;
-  
-  void compute_shuffle();
-  uint64_t compute_weight_sum() const;
+  std::vector<uint64_t> weights_;
+
+  // 1-based Fenwick tree over weights_; base_ is the untouched copy
+  std::vector<uint64_t> base_tree_;
+  std::vector<uint64_t> tree_;
+  uint64_t base_total_;
+  uint64_t total_;
+  size_t top_bit_; // Highest power of two <= size()
+
+  // Zero-weight indices still to be drawn, in uniform random order
+  std::vector<size_t> base_zeros_;
+  std::vector<size_t> zeros_;
+  std::vector<bool> removed_;
+
+  ChaChaRng::Seed seed_;
+  ChaChaRng rng_;
+
+  void build();
+  size_t find(uint64_t value) const;
+  void subtract(size_t index, uint64_t weight);
 };
 
 } // namespace gossip
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/types.h"
+#include "network/quic_transport.h"
 #include "security/secure_messaging.h"
 #include <atomic>
 #include <chrono>
@@ -8,6 +9,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <netinet/in.h>
 #include <openssl/ssl.h>
 #include <queue>
@@ -21,17 +23,22 @@ namespace slonana {
 namespace network {
 
 /**
- * QUIC Stream represents a multiplexed stream within a QUIC connection
+ * QUIC Stream represents a multiplexed stream within a QUIC connection.
+ * Streams opened by a QuicConnection write straight into its transport;
+ * close() finishes the stream so the peer can deliver it.
  */
 class QuicStream {
 public:
   using StreamId = uint64_t;
+  /// Appends data to the transport stream, optionally finishing it
+  using Writer = std::function<bool(StreamId, const uint8_t *, size_t, bool)>;
 
   QuicStream(StreamId id);
+  QuicStream(StreamId id, Writer writer);
   ~QuicStream();
 
   // Stream operations
-  bool send_data(const std::vector<uint8_t> &data);
+  bool send_data(const std::vector<uint8_t> &data, bool fin = false);
   std::vector<uint8_t> receive_data();
   bool close();
   bool is_closed() const;
@@ -41,9 +48,8 @@ public:
   size_t bytes_sent() const { return bytes_sent_; }
   size_t bytes_received() const { return bytes_received_; }
 
-  // Static helper for QUIC protocol
-  static void encode_varint_static(std::vector<uint8_t> &buffer,
-                                   uint64_t value);
+  /// Detach from the transport (connection going away)
+  void set_writer(Writer writer);
 
 private:
   StreamId stream_id_;
@@ -51,24 +57,49 @@ private:
   size_t bytes_sent_;
   size_t bytes_received_;
   std::queue<std::vector<uint8_t>> pending_data_;
-  std::vector<uint8_t> outbound_buffer_;
+  Writer writer_;
   mutable std::mutex mutex_;
+};
+
+/**
+ * Resumption tickets by server address, shared by a client's connections so
+ * reconnecting to a leader can send transactions in 0-RTT. Servers accept
+ * each ticket for 0-RTT once, so a connection takes its ticket and stores
+ * the fresh one the server issues.
+ */
+class QuicTicketCache {
+public:
+  void store(const std::string &server, quic::ResumptionTicket ticket);
+  /// Remove and return the server's unexpired ticket
+  std::optional<quic::ResumptionTicket> take(const std::string &server);
 
-  // Helper methods
-  void encode_varint(std::vector<uint8_t> &buffer, uint64_t value);
+private:
+  std::unordered_map<std::string, quic::ResumptionTicket> tickets_;
+  mutable std::mutex mutex_;
 };
 
 /**
- * QUIC Connection manages a single QUIC connection with stream multiplexing
+ * QUIC Connection manages a single QUIC connection with stream multiplexing.
+ * The transport runs on a per-connection event thread over a connected UDP
+ * socket; callers only touch it under engine_mutex_.
  */
 class QuicConnection {
 public:
   using ConnectionId = std::string;
+  using DataCallback =
+      std::function<void(QuicStream::StreamId, std::vector<uint8_t> &&)>;
 
   QuicConnection(const std::string &remote_address, uint16_t remote_port);
+  QuicConnection(const std::string &remote_address, uint16_t remote_port,
+                 const quic::Identity &identity,
+                 std::shared_ptr<QuicTicketCache> tickets);
   ~QuicConnection();
 
-  // Connection lifecycle
+  /**
+   * Establish the connection. Returns once the handshake completes, or
+   * immediately after sending the ClientHello when a cached ticket allows
+   * 0-RTT stream data.
+   */
   bool connect();
   bool disconnect();
   bool is_connected() const;
@@ -78,6 +109,17 @@ public:
   std::shared_ptr<QuicStream> get_stream(QuicStream::StreamId stream_id);
   void close_stream(QuicStream::StreamId stream_id);
 
+  /// Send one serialized transaction on its own finished stream (TPU)
+  bool send_transaction(const std::vector<uint8_t> &transaction);
+
+  /// Streams opened by the server; called on the event thread
+  void set_data_callback(DataCallback callback) {
+    data_callback_ = std::move(callback);
+  }
+  void set_handshake_timeout(std::chrono::milliseconds timeout) {
+    handshake_timeout_ = timeout;
+  }
+
   // Connection properties
   const std::string &get_remote_address() const { return remote_address_; }
   uint16_t get_remote_port() const { return remote_port_; }
@@ -85,40 +127,42 @@ public:
 
   // Statistics
   size_t get_stream_count() const;
-  std::chrono::milliseconds get_rtt() const { return rtt_; }
+  std::chrono::milliseconds get_rtt() const;
+  bool used_early_data() const;
+  quic::Connection::Stats get_transport_stats() const;
 
 private:
   std::string remote_address_;
   uint16_t remote_port_;
   ConnectionId connection_id_;
-  bool connected_;
-  QuicStream::StreamId next_stream_id_;
-  std::chrono::milliseconds rtt_;
+  std::atomic<bool> connected_;
+  std::chrono::milliseconds handshake_timeout_;
 
   std::unordered_map<QuicStream::StreamId, std::shared_ptr<QuicStream>>
       streams_;
   mutable std::mutex streams_mutex_;
+  DataCallback data_callback_;
 
-  // Socket and TLS
+  // Transport
+  quic::Identity identity_;
+  std::shared_ptr<QuicTicketCache> tickets_;
+  quic::TransportConfig transport_config_;
+  std::unique_ptr<quic::Connection> engine_;
+  mutable std::mutex engine_mutex_;
+  std::condition_variable state_cv_;
+
+  // Socket and event thread
   int socket_fd_;
+  int wake_fd_;
   struct sockaddr_in server_addr_;
-  SSL_CTX *tls_ctx_;
-  SSL *tls_ssl_;
+  std::thread event_thread_;
+  std::atomic<bool> should_stop_;
 
-  // Internal connection management
   void handle_connection_events();
-  bool perform_quic_handshake();
-  void process_quic_packet(const uint8_t *data, size_t length);
-  void send_pending_packets();
-  void handle_connection_maintenance();
-  void cleanup_tls();
-  
-  // Refactored handshake helper methods - eliminates duplicate code
-  std::vector<uint8_t> create_initial_packet();
-  bool send_initial_packet(const std::vector<uint8_t>& initial_packet);
-  bool wait_for_handshake_response();
-  std::thread event_thread_;
-  bool should_stop_;
+  bool write_stream(QuicStream::StreamId stream_id, const uint8_t *data,
+                    size_t length, bool fin);
+  void wake();
+  void close_socket();
 };
 
 /**
@@ -179,6 +223,12 @@ public:
   // Security statistics
   slonana::security::SecureMessaging::SecurityStats get_security_stats() const;
 
+  /// Ed25519 identity presented to servers (stake-weighted QoS)
+  void set_identity(const quic::Key32 &seed) {
+    identity_ = quic::Identity(seed);
+  }
+  const quic::Key32 &get_identity() const { return identity_.public_key(); }
+
   // Performance tuning
   void set_send_buffer_size(size_t size) { send_buffer_size_ = size; }
   void set_receive_buffer_size(size_t size) { receive_buffer_size_ = size; }
@@ -204,22 +254,14 @@ private:
   size_t send_buffer_size_;
   size_t receive_buffer_size_;
 
-  // Event processing
-  void process_events();
-  std::thread event_processor_;
-  bool should_stop_;
-  std::condition_variable stop_cv_;
-  std::mutex stop_mutex_;
+  // Transport identity and 0-RTT tickets shared by all connections
+  quic::Identity identity_;
+  std::shared_ptr<QuicTicketCache> tickets_;
 
   // Connection pool management
   void cleanup_expired_connections();
   std::string generate_connection_id(const std::string &address, uint16_t port);
 
-  // Production QUIC methods
-  void update_congestion_control();
-  void handle_retransmissions();
-  void update_connection_stats();
-  
   // Secure messaging helpers
   bool setup_secure_messaging();
 };
@@ -2,6 +2,7 @@
 
 #include "common/types.h"
 #include "network/quic_client.h"
+#include "network/quic_transport.h"
 #include <atomic>
 #include <condition_variable>
 #include <functional>
@@ -19,38 +20,51 @@
 namespace slonana {
 namespace network {
 
+using namespace slonana::common;
+
 /**
- * QUIC Server Listener handles incoming QUIC connections
+ * QUIC Server Listener owns the UDP socket: datagrams are read in batches
+ * with recvmmsg and handed to a batch handler on the listener thread, which
+ * answers through send() (GSO/sendmmsg batches).
  */
 class QuicListener {
 public:
+  struct Datagram {
+    uint8_t *data;
+    size_t length;
+    sockaddr_in peer;
+  };
+  /// Called with every received batch, and with an empty batch at least once
+  /// per millisecond so transport timers keep running
+  using BatchHandler = std::function<void(Datagram *datagrams, size_t count)>;
+
   QuicListener(uint16_t port);
   ~QuicListener();
 
+  /// Set before start()
+  void set_batch_handler(BatchHandler handler) {
+    handler_ = std::move(handler);
+  }
+
+  /// Binds synchronously; port 0 picks an ephemeral port
   bool start();
   bool stop();
   bool is_listening() const { return listening_; }
   uint16_t get_port() const { return port_; }
 
+  /// Listener thread only (from inside the batch handler)
+  size_t send(const quic::OutgoingDatagram *datagrams, size_t count);
+  bool gso_enabled() const { return sender_ && sender_->gso_enabled(); }
+
 private:
   uint16_t port_;
-  bool listening_;
+  std::atomic<bool> listening_;
   std::thread listener_thread_;
-  int server_socket_; // Added to store socket for sending responses
+  int server_socket_;
+  BatchHandler handler_;
+  std::unique_ptr<quic::UdpBatchSender> sender_;
 
   void listen_loop();
-
-  // QUIC packet handlers
-  void handle_initial_packet(const uint8_t *data, size_t length,
-                             const struct sockaddr_in &client_addr);
-  void handle_0rtt_packet(const uint8_t *data, size_t length,
-                          const struct sockaddr_in &client_addr);
-  void handle_handshake_packet(const uint8_t *data, size_t length,
-                               const struct sockaddr_in &client_addr);
-  void handle_retry_packet(const uint8_t *data, size_t length,
-                           const struct sockaddr_in &client_addr);
-  void handle_1rtt_packet(const uint8_t *data, size_t length,
-                          const struct sockaddr_in &client_addr);
 };
 
 /**
@@ -111,6 +125,11 @@ private:
 /**
  * QUIC Server provides high-performance server-side QUIC implementation
  * Compatible with Agave's QUIC protocol for validator networking
+ *
+ * This is the TPU ingress: every unidirectional stream a client finishes is
+ * one serialized transaction. Connections are driven entirely on the
+ * listener thread; the number of concurrent streams a peer may open is
+ * weighted by its stake (see update_staked_nodes()).
  */
 class QuicServer {
 public:
@@ -119,6 +138,15 @@ public:
   using DataCallback = std::function<void(
       const std::string &, QuicStream::StreamId, const std::vector<uint8_t> &)>;
   using DisconnectionCallback = std::function<void(const std::string &)>;
+  /// Transactions completed in one receive batch, in arrival order
+  using TransactionSink =
+      std::function<void(std::vector<std::vector<uint8_t>> &&)>;
+
+  // Stream quotas: unstaked peers get max_streams_per_session; staked peers
+  // a share of STAKED_STREAMS_TOTAL proportional to stake, clamped
+  static constexpr uint64_t STAKED_STREAMS_TOTAL = 100000;
+  static constexpr uint64_t MIN_STAKED_STREAMS = 128;
+  static constexpr uint64_t MAX_STAKED_STREAMS = 2048;
 
   QuicServer();
   ~QuicServer();
@@ -147,6 +175,21 @@ public:
   void set_disconnection_callback(DisconnectionCallback callback) {
     disconnection_callback_ = callback;
   }
+  /// Set before start(); called on the listener thread
+  void set_transaction_sink(TransactionSink sink) {
+    transaction_sink_ = std::move(sink);
+  }
+
+  // Identity and stake-weighted quality of service
+  /// Set before start(); defaults to a random identity
+  void set_identity(const quic::Key32 &seed) {
+    identity_ = quic::Identity(seed);
+  }
+  const quic::Key32 &get_identity() const { return identity_.public_key(); }
+  /// Replace the identity -> stake table; applies to new connections
+  void update_staked_nodes(const std::unordered_map<PublicKey, uint64_t> &stakes);
+  /// Concurrent streams granted to a peer with the given identity
+  uint64_t stream_quota(const quic::Key32 &identity) const;
 
   // Configuration
   void set_max_sessions(size_t max_sessions) { max_sessions_ = max_sessions; }
@@ -156,6 +199,11 @@ public:
   void set_max_streams_per_session(size_t max_streams) {
     max_streams_per_session_ = max_streams;
   }
+  void set_max_connections_per_peer(size_t max_connections) {
+    max_connections_per_peer_ = max_connections;
+  }
+  /// Bound port (useful after initialize(0))
+  uint16_t get_port() const { return listener_ ? listener_->get_port() : port_; }
 
   // TLS Configuration
   bool configure_tls(const std::string &cert_file, const std::string &key_file);
@@ -179,6 +227,9 @@ public:
     size_t bytes_received;
     double avg_rtt_ms;
     std::chrono::milliseconds uptime;
+    size_t transactions_received;
+    size_t connections_refused;
+    size_t packets_lost;
   };
 
   Statistics get_statistics() const;
@@ -207,53 +258,58 @@ private:
   bool tls_verification_enabled_;
   SSL_CTX *tls_ctx_;
 
-  // Client validation
-  std::vector<std::string> client_blacklist_;
-  std::vector<std::string> client_whitelist_;
+  // Transport state, owned by the listener thread
+  struct PeerConnection;
+  quic::Identity identity_;
+  quic::TransportConfig transport_config_;
+  quic::ServerPolicy policy_;
+  TransactionSink transaction_sink_;
+  std::unordered_map<uint64_t, std::shared_ptr<PeerConnection>> connections_;
+  std::unordered_map<uint64_t, uint64_t> initial_routes_; ///< Client DCID
+  std::unordered_map<std::string, uint64_t> session_routes_;
+  std::unordered_map<PublicKey, size_t> connections_per_peer_;
+  std::vector<PeerConnection *> touched_;
+  std::vector<quic::ReceivedStream> received_streams_;
+  std::vector<std::vector<uint8_t>> pending_transactions_;
+  std::vector<uint8_t> send_buffer_;
+  std::vector<quic::OutgoingDatagram> outgoing_;
+  std::chrono::steady_clock::time_point next_timer_scan_;
+  size_t max_connections_per_peer_;
+
+  // Stakes are written by the caller and read during handshakes
+  std::unordered_map<PublicKey, uint64_t> stakes_;
+  uint64_t total_stake_;
+  mutable std::mutex stakes_mutex_;
+
+  // Server-initiated streams and session closes from other threads
+  struct Outbound {
+    std::string session_id;
+    std::vector<uint8_t> data;
+    bool close;
+  };
+  std::vector<Outbound> outbound_;
+  std::mutex outbound_mutex_;
 
   // Statistics
   std::atomic<size_t> total_bytes_sent_;
   std::atomic<size_t> total_bytes_received_;
   std::atomic<size_t> total_connections_;
+  std::atomic<size_t> transactions_received_;
+  std::atomic<size_t> connections_refused_;
+  std::atomic<size_t> packets_lost_;
+  std::atomic<double> avg_rtt_ms_;
   std::chrono::steady_clock::time_point start_time_;
 
-  // Event processing
-  void process_server_events();
-  std::thread event_processor_;
-  bool should_stop_;
-  std::condition_variable stop_cv_;
-  std::mutex stop_mutex_;
-
-  // Session lifecycle management
-  void handle_new_connection(const std::string &client_address,
-                             uint16_t client_port);
-  void handle_session_data(const std::string &session_id,
-                           QuicStream::StreamId stream_id,
-                           const std::vector<uint8_t> &data);
-  void handle_session_disconnection(const std::string &session_id);
-
-  // Cleanup and maintenance
-  void cleanup_expired_sessions();
-  std::string generate_session_id(const std::string &client_address,
-                                  uint16_t client_port);
-
-  // Security and validation
-  bool validate_client_certificate(const std::string &client_address);
-  bool rate_limit_check(const std::string &client_address);
-
-  // Production QUIC methods
-  void handle_connection_events();
-  void process_stream_events();
-  void update_congestion_control();
-  void handle_retransmissions();
-  void update_server_stats();
-  void encode_varint(std::vector<uint8_t> &buffer, uint64_t value);
-
-  // Connection tracking
-  std::unordered_set<std::string> active_client_addresses_;
-  std::unordered_map<std::string, std::chrono::steady_clock::time_point>
-      last_connection_time_;
-  mutable std::mutex client_tracking_mutex_;
+  // Listener thread
+  void on_datagrams(QuicListener::Datagram *datagrams, size_t count);
+  PeerConnection *route(const QuicListener::Datagram &datagram,
+                        std::chrono::steady_clock::time_point now);
+  void run_timers(std::chrono::steady_clock::time_point now);
+  void drain_outbound();
+  void service(PeerConnection &peer, std::chrono::steady_clock::time_point now);
+  void flush_outgoing();
+  void remove_connection(PeerConnection &peer);
+  void release_connections();
 };
 
 } // namespace network
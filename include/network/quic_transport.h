@@ -0,0 +1,552 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <netinet/in.h>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+typedef struct evp_pkey_st EVP_PKEY;
+
+namespace slonana {
+namespace network {
+namespace quic {
+
+/**
+ * Sans-IO QUIC transport used by QuicServer/QuicClient.
+ *
+ * Packet and frame layout, packet protection (AES-128-GCM with header
+ * protection, RFC 9001 key schedule labels), loss detection and NewReno
+ * congestion control (RFC 9002) and stream/connection flow control follow
+ * RFC 9000. The cryptographic handshake is a compact one-round-trip
+ * X25519 exchange authenticated with the endpoints' Ed25519 identities and
+ * carried in CRYPTO frames of Initial packets; it takes the place of TLS 1.3
+ * because the system OpenSSL has no QUIC TLS API. Resumption tickets issued
+ * after the handshake enable 0-RTT stream data on reconnect.
+ *
+ * Connections never touch sockets: callers feed received datagrams to
+ * receive(), pull datagrams to send from send() and drive timers through
+ * next_timeout()/on_timeout().
+ */
+
+using Clock = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+using Key32 = std::array<uint8_t, 32>;
+
+constexpr uint32_t VERSION_1 = 0x00000001;
+constexpr size_t CID_LENGTH = 8;
+constexpr size_t MAX_DATAGRAM_SIZE = 1200;
+constexpr size_t AEAD_TAG_SIZE = 16;
+/// Largest serialized transaction accepted on a TPU stream
+constexpr size_t MAX_TRANSACTION_SIZE = 1232;
+
+enum class TransportError : uint64_t {
+  NO_ERROR = 0x0,
+  INTERNAL_ERROR = 0x1,
+  CONNECTION_REFUSED = 0x2,
+  FLOW_CONTROL_ERROR = 0x3,
+  STREAM_LIMIT_ERROR = 0x4,
+  STREAM_STATE_ERROR = 0x5,
+  FINAL_SIZE_ERROR = 0x6,
+  FRAME_ENCODING_ERROR = 0x7,
+  PROTOCOL_VIOLATION = 0xa,
+  CRYPTO_ERROR = 0x100
+};
+
+// Variable-length integers (RFC 9000 section 16)
+size_t varint_size(uint64_t value);
+uint8_t *write_varint(uint8_t *out, uint64_t value);
+bool read_varint(const uint8_t *&in, const uint8_t *end, uint64_t &value);
+
+// Key schedule helpers (HKDF-SHA256)
+Key32 hkdf_extract(const uint8_t *salt, size_t salt_len, const uint8_t *ikm,
+                   size_t ikm_len);
+/// HKDF-Expand-Label with the "tls13 " prefix; length <= 32
+void hkdf_expand_label(const Key32 &secret, const std::string &label,
+                       const uint8_t *context, size_t context_len,
+                       uint8_t *out, size_t length);
+/// Client/server Initial secrets for a client-chosen destination CID
+void initial_secrets(const uint8_t *dcid, size_t dcid_len, Key32 &client,
+                     Key32 &server);
+
+/**
+ * Packet protection for one direction and one encryption level. Cipher
+ * contexts are keyed once and reused for every packet.
+ */
+class PacketProtection {
+public:
+  PacketProtection();
+  ~PacketProtection();
+  PacketProtection(const PacketProtection &) = delete;
+  PacketProtection &operator=(const PacketProtection &) = delete;
+
+  /// Derive key, IV and header protection key; sealing selects direction
+  void install(const Key32 &secret, bool sealing);
+  void discard();
+  bool ready() const { return ready_; }
+
+  /**
+   * Encrypt payload_len bytes following the header in place, append the tag
+   * and apply header protection.
+   * @return Total packet length
+   */
+  size_t seal(uint8_t *packet, size_t header_len, size_t pn_offset,
+              size_t payload_len, uint64_t packet_number);
+
+  /**
+   * Remove header protection and decrypt in place.
+   * @return false when authentication fails
+   */
+  bool open(uint8_t *packet, size_t packet_len, size_t pn_offset,
+            uint64_t largest_received, uint64_t &packet_number,
+            size_t &payload_offset, size_t &payload_len);
+
+private:
+  bool header_mask(const uint8_t *sample, uint8_t *mask);
+
+  EVP_CIPHER_CTX *aead_;
+  EVP_CIPHER_CTX *hp_;
+  std::array<uint8_t, 12> iv_{};
+  bool ready_ = false;
+};
+
+/// Ed25519 endpoint identity (a validator identity keypair)
+class Identity {
+public:
+  /// Random identity
+  Identity();
+  /// Identity from a 32-byte Ed25519 private seed
+  explicit Identity(const Key32 &seed);
+
+  const Key32 &public_key() const { return public_key_; }
+  std::array<uint8_t, 64> sign(const uint8_t *message, size_t length) const;
+  static bool verify(const Key32 &public_key, const uint8_t *message,
+                     size_t length, const uint8_t *signature);
+
+private:
+  std::shared_ptr<EVP_PKEY> key_;
+  Key32 public_key_{};
+};
+
+/// RTT estimation (RFC 9002 section 5)
+struct RttEstimator {
+  std::chrono::microseconds latest{0};
+  std::chrono::microseconds smoothed{333000};
+  std::chrono::microseconds variance{166500};
+  std::chrono::microseconds minimum{0};
+  bool has_sample = false;
+
+  void update(std::chrono::microseconds sample,
+              std::chrono::microseconds ack_delay);
+  std::chrono::microseconds pto(std::chrono::microseconds max_ack_delay) const;
+};
+
+/// NewReno congestion control (RFC 9002 section 7)
+class CongestionController {
+public:
+  static constexpr size_t INITIAL_WINDOW = 10 * MAX_DATAGRAM_SIZE;
+  static constexpr size_t MINIMUM_WINDOW = 2 * MAX_DATAGRAM_SIZE;
+
+  void on_packet_sent(size_t bytes) { bytes_in_flight_ += bytes; }
+  void on_packet_acked(size_t bytes, TimePoint sent_time);
+  void on_packets_lost(size_t bytes, TimePoint largest_lost_sent_time,
+                       TimePoint now);
+  /// Remove bytes of a discarded packet number space from flight
+  void on_packet_discarded(size_t bytes);
+
+  size_t window() const { return window_; }
+  size_t bytes_in_flight() const { return bytes_in_flight_; }
+  size_t available() const {
+    return window_ > bytes_in_flight_ ? window_ - bytes_in_flight_ : 0;
+  }
+
+private:
+  size_t window_ = INITIAL_WINDOW;
+  size_t ssthresh_ = SIZE_MAX;
+  size_t bytes_in_flight_ = 0;
+  TimePoint recovery_start_{};
+  bool in_recovery_ = false;
+};
+
+/// Limits an endpoint advertises to its peer
+struct TransportParameters {
+  uint64_t max_streams_uni = 128;
+  uint64_t max_stream_data = MAX_TRANSACTION_SIZE;
+  uint64_t max_data = 1024 * 1024;
+  uint64_t idle_timeout_ms = 30000;
+};
+
+struct TransportConfig {
+  TransportParameters local;
+  std::chrono::milliseconds idle_timeout{30000};
+  std::chrono::milliseconds max_ack_delay{25};
+  std::chrono::seconds ticket_lifetime{3600};
+  bool enable_0rtt = true;
+  /// Client only: require the server to hold this identity
+  std::optional<Key32> expected_server_identity;
+};
+
+/// Client-side memory of a previous connection used for 0-RTT
+struct ResumptionTicket {
+  std::vector<uint8_t> ticket;
+  Key32 secret{};
+  TransportParameters peer_params;
+  TimePoint expires{};
+};
+
+/**
+ * Single-use record of resumption tickets redeemed for 0-RTT (RFC 8446
+ * section 8.1). 0-RTT data is not bound to a fresh server contribution, so
+ * a captured first flight would otherwise be accepted again. A ticket's
+ * nonce is kept until the ticket expires; a second redemption, or one
+ * arriving while the record is full, falls back to a full handshake.
+ */
+class TicketReplayGuard {
+public:
+  explicit TicketReplayGuard(size_t capacity = 1 << 18)
+      : capacity_(capacity) {}
+
+  /**
+   * @param nonce 12-byte ticket nonce
+   * @param expires Unix second after which the ticket is refused anyway
+   * @return true the first time a nonce is redeemed
+   */
+  bool first_use(const uint8_t *nonce, uint64_t expires, uint64_t now);
+  size_t size() const { return seen_.size(); }
+
+private:
+  size_t capacity_;
+  std::unordered_set<std::string> seen_;
+  std::multimap<uint64_t, std::string> by_expiry_;
+};
+
+/// Server-wide handshake policy shared by all connections
+struct ServerPolicy {
+  std::array<uint8_t, 16> ticket_key{};
+  /// Tickets already used for 0-RTT; without one 0-RTT is refused
+  std::shared_ptr<TicketReplayGuard> replay_guard =
+      std::make_shared<TicketReplayGuard>();
+  /**
+   * Concurrent unidirectional streams granted to a peer identity; 0 refuses
+   * the connection. Called once per handshake.
+   */
+  std::function<uint64_t(const Key32 &identity)> stream_quota;
+};
+
+/// A stream the peer finished sending (FIN received and data complete)
+struct ReceivedStream {
+  uint64_t stream_id;
+  std::vector<uint8_t> data;
+};
+
+class Connection {
+public:
+  enum class Role { CLIENT, SERVER };
+  enum class State { HANDSHAKE, ESTABLISHED, CLOSED };
+
+  struct Stats {
+    uint64_t packets_sent = 0;
+    uint64_t packets_received = 0;
+    uint64_t packets_lost = 0;
+    uint64_t packets_dropped = 0; ///< Undecryptable or duplicate
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    uint64_t streams_completed = 0;
+    uint64_t pto_count = 0;
+    bool early_data_accepted = false;
+  };
+
+  /// Client connection; pass a ticket from a previous connection for 0-RTT
+  static std::unique_ptr<Connection>
+  connect(const Identity &identity, const TransportConfig &config,
+          const ResumptionTicket *ticket, TimePoint now);
+
+  /// Server connection for a client Initial addressed to original_dcid
+  static std::unique_ptr<Connection>
+  accept(const Identity &identity, const TransportConfig &config,
+         const ServerPolicy &policy, const uint8_t *original_dcid,
+         size_t dcid_len, TimePoint now);
+
+  ~Connection();
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+
+  /// Process one received datagram (decrypted in place)
+  void receive(uint8_t *datagram, size_t length, TimePoint now);
+
+  /**
+   * Write at most one datagram to send.
+   * @return Datagram length, 0 when there is nothing to send right now
+   */
+  size_t send(uint8_t *out, size_t capacity, TimePoint now);
+
+  TimePoint next_timeout() const;
+  void on_timeout(TimePoint now);
+
+  /// Open a unidirectional stream; data is queued until the peer allows it
+  uint64_t open_uni_stream();
+  /// Append data to a locally opened stream, optionally finishing it
+  bool write_stream(uint64_t stream_id, const uint8_t *data, size_t length,
+                    bool fin);
+  /// Open a stream, write data and finish it (one TPU transaction)
+  uint64_t send_stream(const uint8_t *data, size_t length);
+
+  /// Move completed peer streams into out
+  void take_received(std::vector<ReceivedStream> &out);
+  bool has_received() const { return !received_.empty(); }
+
+  void close(TransportError error, const std::string &reason = "");
+
+  State state() const { return state_; }
+  Role role() const { return role_; }
+  bool is_established() const { return state_ == State::ESTABLISHED; }
+  bool is_closed() const { return state_ == State::CLOSED; }
+  /// Client: stream data may be sent now (handshake done or 0-RTT keys)
+  bool can_send_stream_data() const;
+  /// Streams queued or in flight that the peer has not acknowledged yet
+  size_t unacknowledged_streams() const { return send_streams_.size(); }
+
+  const Key32 &peer_identity() const { return peer_identity_; }
+  const std::array<uint8_t, CID_LENGTH> &local_cid() const {
+    return local_cid_;
+  }
+  /// Server: concurrent stream quota granted to this peer
+  uint64_t stream_quota() const { return stream_quota_; }
+  /// Client: new resumption ticket received from the server, if any
+  std::optional<ResumptionTicket> take_ticket();
+
+  const Stats &stats() const { return stats_; }
+  const RttEstimator &rtt() const { return rtt_; }
+  const CongestionController &congestion() const { return cc_; }
+
+private:
+  enum Space { INITIAL = 0, APPLICATION = 1, SPACE_COUNT = 2 };
+  enum Level { LEVEL_INITIAL = 0, LEVEL_EARLY = 1, LEVEL_1RTT = 2 };
+
+  struct StreamChunk {
+    uint64_t stream_id;
+    uint64_t offset;
+    uint64_t length;
+    bool fin;
+  };
+
+  struct SentPacket {
+    uint64_t packet_number;
+    TimePoint time;
+    size_t bytes;
+    bool ack_eliciting;
+    bool early;
+    bool crypto = false;
+    bool handshake_done = false;
+    bool max_streams = false;
+    bool max_data = false;
+    bool new_token = false;
+    std::vector<StreamChunk> chunks;
+  };
+
+  struct ReceiveSpace {
+    /// Received packet number ranges, highest first, [low, high]
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    uint64_t largest = 0;
+    TimePoint largest_time{};
+    bool any = false;
+    bool ack_pending = false;
+  };
+
+  struct SendSpace {
+    uint64_t next_packet_number = 0;
+    uint64_t largest_acked = 0;
+    bool any_acked = false;
+    TimePoint loss_time{};
+    std::deque<SentPacket> sent;
+    bool discarded = false;
+  };
+
+  struct SendStream {
+    std::vector<uint8_t> data;
+    uint64_t next_offset = 0; ///< First byte never sent
+    uint64_t acked_bytes = 0;
+    bool fin = false;
+    bool fin_sent = false;
+    bool fin_acked = false;
+    bool queued = false;
+    /// Lost ranges awaiting retransmission
+    std::vector<StreamChunk> lost;
+  };
+
+  struct RecvStream {
+    std::vector<uint8_t> data;
+    std::map<uint64_t, uint64_t> have; ///< offset -> end
+    uint64_t highest = 0;
+    uint64_t final_size = UINT64_MAX;
+  };
+
+  Connection(Role role, const Identity &identity,
+             const TransportConfig &config);
+
+  // Handshake
+  void start_client(const ResumptionTicket *ticket);
+  bool handle_client_hello(const uint8_t *data, size_t length);
+  bool handle_server_hello(const uint8_t *data, size_t length);
+  void install_application_keys(const Key32 &master);
+  std::vector<uint8_t> issue_ticket();
+  bool redeem_ticket(const uint8_t *ticket, size_t length, Key32 &secret);
+  void discard_space(Space space);
+  void reject_early_data();
+
+  // Receive path
+  bool process_packet(uint8_t *packet, size_t length, size_t &consumed,
+                      TimePoint now);
+  bool process_frames(Space space, bool early, const uint8_t *p,
+                      const uint8_t *end, bool &ack_eliciting, TimePoint now);
+  bool on_ack_frame(Space space, const uint8_t *&p, const uint8_t *end,
+                    uint64_t frame_type, TimePoint now);
+  bool on_stream_frame(uint64_t frame_type, const uint8_t *&p,
+                       const uint8_t *end);
+  void complete_stream(uint64_t stream_id, std::vector<uint8_t> data,
+                       uint64_t size);
+  bool record_received(Space space, uint64_t packet_number, TimePoint now);
+
+  // Send path
+  size_t write_packet(Space space, uint8_t *out, size_t capacity,
+                      TimePoint now, bool pad_datagram);
+  size_t write_header(Space space, Level level, uint8_t *out,
+                      size_t &pn_offset, size_t &length_offset);
+  size_t finish_packet(Space space, Level level, uint8_t *out,
+                       size_t header_len, size_t pn_offset,
+                       size_t length_offset, size_t payload_len);
+  size_t write_close(uint8_t *out, size_t capacity);
+  bool has_stream_data_to_send() const;
+  void on_packet_acked(SentPacket &packet, TimePoint now);
+  void on_packet_lost(SentPacket &packet);
+  void detect_lost_packets(Space space, TimePoint now);
+  TimePoint pto_deadline() const;
+  void queue_stream(uint64_t stream_id);
+
+  Role role_;
+  State state_ = State::HANDSHAKE;
+  Identity identity_;
+  TransportConfig config_;
+  const ServerPolicy *policy_ = nullptr;
+
+  std::array<uint8_t, CID_LENGTH> local_cid_{};
+  std::array<uint8_t, CID_LENGTH> peer_cid_{};
+  std::array<uint8_t, CID_LENGTH> original_dcid_{};
+
+  PacketProtection tx_[3];
+  PacketProtection rx_[3];
+  SendSpace send_[SPACE_COUNT];
+  ReceiveSpace recv_[SPACE_COUNT];
+
+  // Handshake state
+  std::vector<uint8_t> client_hello_;
+  std::vector<uint8_t> server_hello_;
+  std::shared_ptr<EVP_PKEY> ephemeral_;
+  Key32 client_random_{};
+  Key32 peer_identity_{};
+  Key32 resumption_secret_{};
+  std::optional<ResumptionTicket> new_ticket_;
+  std::vector<uint8_t> ticket_to_send_;
+  bool new_token_pending_ = false;
+  bool peer_cid_known_ = false;
+  bool crypto_pending_ = false;
+  bool handshake_done_pending_ = false;
+  bool handshake_confirmed_ = false;
+  bool early_data_attempted_ = false;
+  TransportParameters peer_params_;
+
+  // Streams
+  std::map<uint64_t, SendStream> send_streams_;
+  std::deque<uint64_t> send_queue_;
+  uint64_t next_uni_index_ = 0;
+  uint64_t data_sent_ = 0; ///< New stream bytes sent (connection flow)
+  std::unordered_map<uint64_t, RecvStream> recv_streams_;
+  std::unordered_set<uint64_t> completed_above_;
+  uint64_t completed_below_ = 0; ///< Peer stream indices below are done
+  uint64_t stream_quota_ = 0;
+  uint64_t max_streams_advertised_ = 0;
+  uint64_t max_data_advertised_ = 0;
+  uint64_t data_received_ = 0;
+  uint64_t data_consumed_ = 0;
+  bool max_streams_pending_ = false;
+  bool max_data_pending_ = false;
+  std::vector<ReceivedStream> received_;
+
+  // Recovery
+  RttEstimator rtt_;
+  CongestionController cc_;
+  uint32_t pto_backoff_ = 0;
+  int probes_pending_ = 0;
+  TimePoint last_activity_;
+  size_t bytes_received_unvalidated_ = 0;
+  size_t bytes_sent_unvalidated_ = 0;
+
+  // Closing
+  bool close_pending_ = false;
+  TransportError close_error_ = TransportError::NO_ERROR;
+  std::string close_reason_;
+
+  Stats stats_;
+};
+
+/// Connection ID routing key
+inline uint64_t cid_key(const uint8_t *cid) {
+  uint64_t key = 0;
+  for (size_t i = 0; i < CID_LENGTH; ++i) {
+    key = (key << 8) | cid[i];
+  }
+  return key;
+}
+
+/**
+ * Extract the destination connection ID of a datagram's first packet.
+ * @return false for packets that are too short or not QUIC v1
+ */
+bool parse_destination_cid(const uint8_t *datagram, size_t length,
+                           uint64_t &key, bool &is_initial);
+
+/// One outbound datagram
+struct OutgoingDatagram {
+  const uint8_t *data;
+  size_t length;
+  sockaddr_in peer;
+};
+
+/**
+ * Batched UDP sender. Consecutive datagrams to the same peer with the same
+ * size (the last one may be shorter) go out as one UDP_SEGMENT (GSO) send;
+ * runs for different peers are submitted together with sendmmsg. Falls back
+ * to plain sendmmsg when the kernel rejects GSO.
+ */
+class UdpBatchSender {
+public:
+  explicit UdpBatchSender(int socket_fd, bool connected = false)
+      : socket_fd_(socket_fd), connected_(connected) {}
+
+  /// @return Number of datagrams handed to the kernel
+  size_t send(const OutgoingDatagram *datagrams, size_t count);
+  bool gso_enabled() const { return gso_enabled_; }
+  uint64_t syscalls() const { return syscalls_; }
+
+private:
+  size_t send_plain(const OutgoingDatagram *datagrams, size_t count);
+
+  int socket_fd_;
+  bool connected_;
+  bool gso_enabled_ = true;
+  uint64_t syscalls_ = 0;
+};
+
+} // namespace quic
+} // namespace network
+} // namespace slonana
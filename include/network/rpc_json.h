@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace slonana {
+namespace network {
+namespace rpc_json {
+
+/**
+ * @file rpc_json.h
+ * @brief Allocation-light JSON reader/writer for the JSON-RPC hot path
+ *
+ * The reader tokenizes a request in a single pass into a flat tape of
+ * value tokens. Every token is a view into the caller's buffer, so nothing
+ * is copied until a handler explicitly asks for an owned value. The writer
+ * appends directly into a caller-provided std::string that can be reused
+ * across requests.
+ */
+
+enum class JsonType : uint8_t { NULL_VALUE, BOOL, NUMBER, STRING, ARRAY, OBJECT };
+
+/**
+ * One value on the tape. Containers record the tape index one past their
+ * last descendant, which makes skipping to the next sibling O(1).
+ */
+struct JsonToken {
+  JsonType type = JsonType::NULL_VALUE;
+  bool has_escapes = false;  ///< String/key contains backslash escapes
+  uint32_t end = 0;          ///< Tape index one past this subtree
+  uint32_t children = 0;     ///< Element/member count for containers
+  std::string_view key;      ///< Member name (raw, unquoted) inside objects
+  std::string_view raw;      ///< Raw text; strings exclude the quotes
+};
+
+class JsonDocument;
+
+/**
+ * Lightweight cursor over a parsed JsonDocument. Copyable and cheap; only
+ * valid while the document and its source buffer are alive.
+ */
+class JsonView {
+public:
+  JsonView() = default;
+  JsonView(const JsonDocument *doc, uint32_t index) : doc_(doc), index_(index) {}
+
+  bool valid() const noexcept { return doc_ != nullptr; }
+  JsonType type() const noexcept;
+  bool is_null() const noexcept { return !valid() || type() == JsonType::NULL_VALUE; }
+  bool is_string() const noexcept { return valid() && type() == JsonType::STRING; }
+  bool is_number() const noexcept { return valid() && type() == JsonType::NUMBER; }
+  bool is_array() const noexcept { return valid() && type() == JsonType::ARRAY; }
+  bool is_object() const noexcept { return valid() && type() == JsonType::OBJECT; }
+
+  /// Number of elements/members for containers, 0 otherwise
+  size_t size() const noexcept;
+
+  /// Raw source text of the value (strings without quotes, escapes intact)
+  std::string_view raw() const noexcept;
+
+  /// Raw source text including the quotes for strings
+  std::string_view json() const noexcept;
+
+  /// String contents as a view; escapes are left undecoded
+  std::string_view as_string_view() const noexcept;
+
+  /// String contents with escapes decoded (allocates)
+  std::string as_string() const;
+
+  std::optional<uint64_t> as_uint64() const noexcept;
+  std::optional<int64_t> as_int64() const noexcept;
+  std::optional<bool> as_bool() const noexcept;
+
+  /// Array element by position, invalid view when out of range
+  JsonView at(size_t position) const noexcept;
+
+  /// Object member by name, invalid view when absent
+  JsonView get(std::string_view key) const noexcept;
+
+  /// Iterate children of a container (works for arrays and objects)
+  JsonView first_child() const noexcept;
+  JsonView next_sibling() const noexcept;
+  std::string_view key() const noexcept;
+
+private:
+  const JsonDocument *doc_ = nullptr;
+  uint32_t index_ = 0;
+  uint32_t parent_end_ = 0;
+  friend class JsonDocument;
+};
+
+/**
+ * Single-pass JSON tokenizer. The tape is kept between parse() calls so a
+ * thread-local document reaches a steady state with zero allocations.
+ */
+class JsonDocument {
+public:
+  static constexpr size_t MAX_DEPTH = 64;
+
+  /// Parse the buffer; the buffer must outlive every view handed out
+  bool parse(std::string_view input);
+
+  JsonView root() const noexcept {
+    return tape_.empty() ? JsonView() : JsonView(this, 0);
+  }
+
+  const std::vector<JsonToken> &tape() const noexcept { return tape_; }
+  size_t error_offset() const noexcept { return error_offset_; }
+
+private:
+  std::vector<JsonToken> tape_;
+  size_t error_offset_ = 0;
+  friend class JsonView;
+};
+
+/// Decode JSON string escapes (\n, \", \uXXXX, ...) into UTF-8
+std::string unescape(std::string_view raw);
+
+/// Append base58 (Bitcoin/Solana alphabet) encoding of data to out
+void append_base58(std::string &out, const uint8_t *data, size_t len);
+
+/// Append standard padded base64 encoding of data to out
+void append_base64(std::string &out, const uint8_t *data, size_t len);
+
+inline std::string encode_base58(const std::vector<uint8_t> &data) {
+  std::string out;
+  append_base58(out, data.data(), data.size());
+  return out;
+}
+
+inline std::string encode_base64(const std::vector<uint8_t> &data) {
+  std::string out;
+  append_base64(out, data.data(), data.size());
+  return out;
+}
+
+/**
+ * Streaming JSON writer that appends into a reusable buffer. Comma placement
+ * is tracked per nesting level so callers only describe structure.
+ */
+class JsonWriter {
+public:
+  explicit JsonWriter(std::string &out) : out_(out) {}
+
+  JsonWriter &begin_object();
+  JsonWriter &end_object();
+  JsonWriter &begin_array();
+  JsonWriter &end_array();
+
+  /// Emit an object member name; the next value call supplies its value
+  JsonWriter &key(std::string_view name);
+
+  JsonWriter &string(std::string_view value);
+
+  /// Emit a string whose contents are already JSON-escaped
+  JsonWriter &escaped_string(std::string_view value);
+
+  JsonWriter &number(uint64_t value);
+  JsonWriter &number(int64_t value);
+  JsonWriter &number(int value) { return number(static_cast<int64_t>(value)); }
+  JsonWriter &number(double value);
+  JsonWriter &boolean(bool value);
+  JsonWriter &null();
+
+  /// Emit pre-serialized JSON verbatim as the next value
+  JsonWriter &raw(std::string_view json);
+
+  JsonWriter &base58(const uint8_t *data, size_t len);
+  JsonWriter &base64(const uint8_t *data, size_t len);
+
+  std::string &buffer() noexcept { return out_; }
+
+private:
+  void separator();
+
+  std::string &out_;
+  uint64_t need_comma_ = 0; ///< One bit per nesting level
+  uint32_t depth_ = 0;
+  bool after_key_ = false;
+};
+
+/// Append str as a quoted, escaped JSON string
+void append_quoted(std::string &out, std::string_view str);
+
+} // namespace rpc_json
+} // namespace network
+} // namespace slonana
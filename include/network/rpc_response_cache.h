@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace slonana {
+namespace monitoring {
+class ICounter;
+class IGauge;
+} // namespace monitoring
+
+namespace network {
+
+/**
+ * @brief Response cache with request coalescing for hot read-only RPC methods
+ *
+ * Results are cached per method, keyed by the method name, the commitment
+ * level and a canonical form of the params (object keys sorted, commitment
+ * stripped, empty trailing config dropped), so `["X"]` and
+ * `["X",{"commitment":"finalized"}]` share one entry. Cached bodies are the
+ * serialized "result" value held in a shared buffer and spliced into every
+ * response without copying.
+ *
+ * Invalidation depends on the method's scope:
+ * - SLOT: valid only for the slot it was computed at
+ * - ACCOUNT: as SLOT, and additionally dropped by account-change events
+ * - IMMUTABLE: never expires once a non-null result was produced; only
+ *   requests at finalized commitment qualify, the rest are SLOT scoped
+ *
+ * Account-change events bump an invalidation generation; a result computed
+ * across an invalidation is returned to its callers but never stored, so
+ * a read that raced the write cannot repopulate the cache with old state.
+ *
+ * Concurrent misses for the same key are coalesced: one caller computes the
+ * result while the others wait for it (singleflight).
+ *
+ * Hit, miss, coalesce and invalidation counters plus a hit ratio gauge are
+ * registered per method in the global metrics registry under the
+ * `rpc_cache_*` names, so they show up in the Prometheus exporter.
+ *
+ * @note Thread safety: all public methods are thread-safe
+ */
+class RpcResponseCache {
+public:
+  using Body = std::shared_ptr<const std::string>;
+
+  enum class Scope { SLOT, ACCOUNT, IMMUTABLE };
+
+  struct Config {
+    bool enabled = true;
+    size_t max_entries_per_method = 8192;
+  };
+
+  /// Cache key derived from a request
+  struct Key {
+    std::string text;    ///< method|commitment|canonical params
+    std::string account; ///< Account address for ACCOUNT scoped methods
+    Scope scope = Scope::SLOT; ///< Effective scope for this request
+  };
+
+  struct MethodStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t coalesced = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+  };
+
+  /**
+   * Result producer for a miss. Returns the serialized result and sets
+   * cacheable to false for errors; uncacheable results are handed back to
+   * the computing caller only.
+   */
+  using Compute = std::function<Body(bool &cacheable)>;
+
+  RpcResponseCache();
+  explicit RpcResponseCache(const Config &config);
+  ~RpcResponseCache();
+
+  RpcResponseCache(const RpcResponseCache &) = delete;
+  RpcResponseCache &operator=(const RpcResponseCache &) = delete;
+
+  bool is_cacheable(const std::string &method) const noexcept;
+
+  /**
+   * @brief Build the cache key for a request
+   * @return nullopt when the method is not cached or params are malformed
+   */
+  std::optional<Key> make_key(const std::string &method,
+                              const std::string &params) const;
+
+  /**
+   * @brief Return the cached result or compute it once for all callers
+   * @param slot Current slot; SLOT/ACCOUNT entries from other slots miss
+   * @return Shared result body, or nullptr when the result was uncacheable
+   *         (the computing caller keeps its own response in that case, any
+   *         coalesced waiters must compute for themselves)
+   */
+  Body get_or_compute(const std::string &method, const Key &key, uint64_t slot,
+                      const Compute &compute);
+
+  /// Drop every SLOT/ACCOUNT entry computed before the given slot
+  void notify_slot_advance(uint64_t slot);
+
+  /// Drop ACCOUNT scoped entries for one account address (base58); call
+  /// after the new state is visible to readers
+  void invalidate_account(const std::string &address);
+
+  /// Drop all ACCOUNT scoped entries (account set unknown, e.g. a new tx)
+  void invalidate_accounts();
+
+  void clear();
+
+  MethodStats stats(const std::string &method) const;
+
+  bool enabled() const noexcept { return config_.enabled; }
+  void set_enabled(bool enabled) noexcept { config_.enabled = enabled; }
+
+private:
+  struct Entry {
+    Body body;
+    uint64_t slot = 0;
+    std::string account;
+    bool immutable = false;
+  };
+
+  struct InFlight {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+    Body body;
+  };
+
+  struct MethodTable {
+    Scope scope = Scope::SLOT;
+
+    mutable std::shared_mutex entries_mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::unordered_map<std::string, std::unordered_set<std::string>>
+        by_account;
+    uint64_t min_slot = 0; ///< Entries below this slot are stale
+    uint64_t generation = 0; ///< Bumped by every account invalidation
+
+    std::mutex inflight_mutex;
+    std::unordered_map<std::string, std::shared_ptr<InFlight>> inflight;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint64_t> invalidations{0};
+
+    std::shared_ptr<monitoring::ICounter> hits_counter;
+    std::shared_ptr<monitoring::ICounter> misses_counter;
+    std::shared_ptr<monitoring::ICounter> coalesced_counter;
+    std::shared_ptr<monitoring::ICounter> invalidations_counter;
+    std::shared_ptr<monitoring::IGauge> hit_ratio_gauge;
+  };
+
+  MethodTable *find_table(const std::string &method) const noexcept;
+  bool lookup(MethodTable &table, const std::string &key, uint64_t slot,
+              Body &body, uint64_t &generation) const;
+  void store(MethodTable &table, const Key &key, uint64_t slot,
+             uint64_t generation, Body body);
+  void erase_entry_locked(MethodTable &table,
+                          std::unordered_map<std::string, Entry>::iterator it);
+  void record_hit(MethodTable &table);
+  void record_miss(MethodTable &table);
+  void record_invalidations(MethodTable &table, uint64_t count);
+
+  Config config_;
+  // Built once in the constructor; read without locking afterwards
+  std::unordered_map<std::string, std::unique_ptr<MethodTable>> tables_;
+};
+
+} // namespace network
+} // namespace slonana
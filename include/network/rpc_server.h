@@ -2,11 +2,15 @@
 
 #include "common/types.h"
 #include "common/fault_tolerance.h"
+#include "network/rpc_response_cache.h"
 #include "network/websocket_server.h"
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace slonana {
 
@@ -74,6 +78,9 @@ struct RpcResponse {
   std::string error;             ///< JSON string containing error information (only if error occurred)
   std::string id;                ///< Request ID for correlation (copied from request)
   bool id_is_number = false;     ///< True if ID should be rendered as number in JSON
+  /// Pre-serialized result shared with the response cache; takes precedence
+  /// over result when set
+  std::shared_ptr<const std::string> shared_result;
 
   /**
    * @brief Convert response to JSON string for transmission
@@ -277,9 +284,35 @@ public:
    * @note Thread-safe and can handle concurrent requests
    * @note Invalid JSON returns proper JSON-RPC error response
    * @note All processing errors are caught and returned as RPC errors
+   * @note JSON-RPC batch arrays are executed concurrently and answered with
+   *       a response array in request order
    */
   std::string handle_request(const std::string &request_json);
 
+  /// Upper bound on entries accepted in one JSON-RPC batch array
+  static constexpr size_t MAX_BATCH_REQUESTS = 1024;
+  /// Upper bound on threads used to execute a single batch
+  static constexpr size_t MAX_BATCH_WORKERS = 8;
+
+  // === Response Cache ===
+
+  /**
+   * @brief Drop cached slot-scoped responses older than the given slot
+   * @note Lookups already miss on slot mismatch; this reclaims memory early.
+   * Without a validator core, the latest slot reported here is the slot
+   * new responses are cached at.
+   */
+  void notify_slot_advance(uint64_t slot);
+
+  /**
+   * @brief Drop cached responses derived from an account's state
+   * @param address Base58 account address
+   */
+  void invalidate_account(const std::string &address);
+
+  /// Response cache for hot read-only methods (stats, enable/disable)
+  RpcResponseCache &response_cache() noexcept { return response_cache_; }
+
   // === WebSocket Support ===
   
   /**
@@ -436,6 +469,12 @@ private:
   RpcResponse disable_svm_network(const RpcRequest &request);
   RpcResponse set_network_rpc_url(const RpcRequest &request);
 
+  // Request dispatch
+  std::string dispatch_request(const RpcRequest &request);
+  std::string dispatch_cached(const RpcRequest &request,
+                              const RpcHandler &handler);
+  std::string handle_batch_request(const std::vector<RpcRequest> &requests);
+
   // Helper methods
   RpcResponse create_error_response(const std::string &id, int code,
                                     const std::string &message,
@@ -472,14 +511,17 @@ private:
   std::shared_ptr<svm::ExecutionEngine> execution_engine_;
   std::shared_ptr<svm::AccountManager> account_manager_;
 
-  // Performance optimization caches
-  mutable std::map<std::string, std::pair<std::string, uint64_t>>
-      account_cache_; // address -> (data, timestamp)
-  mutable std::map<uint64_t, std::string> block_cache_; // slot -> block_data
+  // Performance optimization caches (guarded by cache_mutex_; batch
+  // requests run handlers concurrently)
+  mutable std::mutex cache_mutex_;
   mutable std::string cached_supply_data_;
   mutable uint64_t cached_supply_timestamp_;
   mutable uint64_t cache_ttl_ms_ = 5000; // 5 second cache TTL
 
+  // Slot/account-aware cache for hot read-only methods
+  RpcResponseCache response_cache_;
+  std::atomic<uint64_t> notified_slot_{0}; ///< Latest notify_slot_advance
+
   // Cache management
   bool is_cache_valid(uint64_t timestamp) const;
   uint64_t get_current_timestamp_ms() const;
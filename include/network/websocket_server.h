@@ -1,13 +1,19 @@
 #pragma once
 
 #include "common/types.h"
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -24,110 +30,147 @@ enum class SubscriptionType {
   LOG_SUBSCRIPTION
 };
 
+/// Commitment a subscriber asked to be notified at
+enum class CommitmentLevel : uint8_t { PROCESSED, CONFIRMED, FINALIZED };
+
+/// Account data encoding requested by a subscriber (jsonParsed maps to BASE64)
+enum class AccountEncoding : uint8_t { BASE58, BASE64 };
+
 struct SubscriptionRequest {
   SubscriptionType type;
   std::string pubkey;     // For account/signature subscriptions
   std::string program_id; // For program account subscriptions
   uint64_t subscription_id;
   std::string filters; // JSON filters for advanced subscriptions
+  CommitmentLevel commitment = CommitmentLevel::FINALIZED;
+  AccountEncoding encoding = AccountEncoding::BASE64;
 };
 
-struct SubscriptionMessage {
-  uint64_t subscription_id;
-  std::string method;
-  std::string params;
-  std::string result;
-  int64_t timestamp;
+/**
+ * Bit for one (commitment, encoding) pair in a subscription interest mask;
+ * account_interest()/program_interest() return the OR over all subscribers.
+ */
+constexpr uint8_t interest_bit(CommitmentLevel commitment,
+                               AccountEncoding encoding) {
+  return static_cast<uint8_t>(
+      1u << (static_cast<unsigned>(commitment) * 2 +
+             static_cast<unsigned>(encoding)));
+}
+
+struct WebSocketServerConfig {
+  /// Event loop threads; 0 picks min(4, hardware_concurrency)
+  size_t reactor_threads = 0;
+  /// Outbound bytes a connection may have queued before it is evicted
+  size_t max_queued_bytes = 8 * 1024 * 1024;
+  /// Outbound messages a connection may have queued before it is evicted
+  size_t max_queued_messages = 16384;
+  /// Largest inbound frame accepted from a client
+  size_t max_frame_size = 1024 * 1024;
+  /// Lock shards per subscription table
+  size_t subscription_shards = 16;
 };
 
-class WebSocketConnection {
-private:
-  int socket_fd;
-  std::string client_address;
-  std::unordered_map<uint64_t, SubscriptionRequest> subscriptions;
-  mutable std::mutex subscriptions_mutex;
-  std::atomic<bool> is_connected;
+/**
+ * One queued outbound message. The body is shared between every connection
+ * the message fans out to; only the WebSocket frame header and a short
+ * per-subscriber trailer (the subscription id) are stored inline.
+ */
+struct OutboundMessage {
+  std::shared_ptr<const std::string> body;
+  std::array<char, 10> header{};
+  std::array<char, 24> trailer{};
+  uint8_t header_len = 0;
+  uint8_t trailer_len = 0;
 
+  size_t size() const noexcept {
+    return header_len + body->size() + trailer_len;
+  }
+};
+
+class WebSocketConnection {
 public:
-  WebSocketConnection(int fd, const std::string &addr);
+  enum class State { HANDSHAKE, OPEN, CLOSED };
+
+  enum class EnqueueResult {
+    QUEUED,             ///< Appended behind data already awaiting a flush
+    NEEDS_FLUSH,        ///< Queue was idle; the owning reactor must flush
+    OVERFLOW,           ///< Slow consumer: limits exceeded, must be evicted
+    CLOSED
+  };
+
+  WebSocketConnection(int fd, const std::string &addr, size_t reactor,
+                      size_t max_queued_bytes, size_t max_queued_messages);
   ~WebSocketConnection();
 
-  bool send_message(const std::string &message);
-  bool send_subscription_response(const SubscriptionMessage &msg);
+  /// Queue a complete text message; it is framed here
+  EnqueueResult send_message(const std::string &message);
+
+  /**
+   * Queue a shared notification body followed by a per-subscriber trailer.
+   * The body is sent as-is and must not be modified afterwards.
+   */
+  EnqueueResult enqueue(std::shared_ptr<const std::string> body,
+                        std::string_view trailer, bool framed = true);
+
+  /**
+   * Write queued data until the socket would block. Called from the owning
+   * reactor only.
+   * @return false on a fatal socket error
+   */
+  bool flush(uint64_t &messages_written);
+  bool has_pending_output() const;
+  size_t queued_bytes() const;
+
   bool add_subscription(const SubscriptionRequest &request);
-  bool remove_subscription(uint64_t subscription_id);
+  std::optional<SubscriptionRequest> remove_subscription(uint64_t subscription_id);
   std::vector<SubscriptionRequest> get_subscriptions() const;
   bool is_alive() const { return is_connected.load(); }
   void close();
 
   const std::string &get_address() const { return client_address; }
   int get_socket() const { return socket_fd; }
+  size_t reactor() const { return reactor_index; }
 
-private:
-  std::vector<uint8_t> create_websocket_frame(const std::string &payload);
-};
+  // Reactor-owned state; only touched from the connection's event loop
+  State state = State::HANDSHAKE;
+  std::string read_buffer;
+  std::string fragment_buffer;
+  bool write_armed = false; ///< EPOLLOUT currently requested
+  std::atomic<bool> flush_scheduled{false};
+  std::atomic<bool> evicted{false};
 
-class WebSocketServer {
 private:
-  std::string bind_address;
-  int port;
-  int server_socket;
-  std::atomic<bool> running;
-  std::thread server_thread;
-  std::thread notification_thread;
-
-  // Connection management
-  std::vector<std::shared_ptr<WebSocketConnection>> connections;
-  mutable std::mutex connections_mutex;
+  int socket_fd;
+  std::string client_address;
+  size_t reactor_index;
+  std::unordered_map<uint64_t, SubscriptionRequest> subscriptions;
+  mutable std::mutex subscriptions_mutex;
+  std::atomic<bool> is_connected;
 
-  // Subscription management
-  std::unordered_map<std::string, std::vector<uint64_t>> account_subscriptions;
-  std::unordered_map<std::string, std::vector<uint64_t>>
-      signature_subscriptions;
-  std::vector<uint64_t> slot_subscriptions;
-  std::vector<uint64_t> block_subscriptions;
-  std::mutex subscription_mutex;
-
-  // Notification queue
-  std::queue<SubscriptionMessage> notification_queue;
+  // Outbound queue, shared between notifiers and the reactor
   mutable std::mutex queue_mutex;
-  std::condition_variable queue_cv;
-
-  // Statistics
-  std::atomic<uint64_t> total_connections;
-  std::atomic<uint64_t> active_subscriptions;
-  std::atomic<uint64_t> messages_sent;
-
-  void server_loop();
-  void notification_loop();
-  void handle_client_connection(int client_socket,
-                                const std::string &client_addr);
-  void handle_websocket_handshake(int client_socket);
-  void handle_websocket_message(std::shared_ptr<WebSocketConnection> conn,
-                                const std::string &message);
-  void cleanup_disconnected_connections();
-
-  // WebSocket protocol handlers
-  std::string generate_websocket_key();
-  std::string compute_websocket_accept(const std::string &key);
-  bool parse_websocket_frame(const std::vector<uint8_t> &frame,
-                             std::string &payload);
-  std::vector<uint8_t> create_websocket_frame(const std::string &payload);
-
-  // Subscription handlers
-  void handle_account_subscribe(std::shared_ptr<WebSocketConnection> conn,
-                                const std::string &request);
-  void handle_signature_subscribe(std::shared_ptr<WebSocketConnection> conn,
-                                  const std::string &request);
-  void handle_slot_subscribe(std::shared_ptr<WebSocketConnection> conn,
-                             const std::string &request);
-  void handle_block_subscribe(std::shared_ptr<WebSocketConnection> conn,
-                              const std::string &request);
-  void handle_unsubscribe(std::shared_ptr<WebSocketConnection> conn,
-                          const std::string &request);
+  std::deque<OutboundMessage> queue;
+  size_t queue_bytes = 0;
+  size_t front_offset = 0; ///< Bytes of queue.front() already written
+  size_t max_queued_bytes;
+  size_t max_queued_messages;
+};
 
+/**
+ * @brief Solana-compatible PubSub WebSocket server
+ *
+ * Connections are multiplexed over a small pool of epoll reactors instead of
+ * one thread per client. Notifications are serialized once per event into a
+ * reference-counted payload and fanned out to every subscriber's bounded
+ * outbound queue; a connection whose queue exceeds its byte or message limit
+ * is evicted rather than allowed to stall the publisher. Subscription tables
+ * are sharded by key so publishers for different accounts do not contend.
+ */
+class WebSocketServer {
 public:
   WebSocketServer(const std::string &address = "127.0.0.1", int port = 8900);
+  WebSocketServer(const std::string &address, int port,
+                  const WebSocketServerConfig &config);
   ~WebSocketServer();
 
   bool start();
@@ -147,6 +190,24 @@ public:
                                      const std::string &account_pubkey,
                                      const std::string &account_data);
 
+  /**
+   * Commitment-aware variants used by the account notification dispatcher:
+   * only subscribers that asked for exactly this commitment and encoding
+   * receive the (pre-encoded) result.
+   */
+  void publish_account_notification(const std::string &pubkey,
+                                    const std::string &result,
+                                    CommitmentLevel commitment,
+                                    AccountEncoding encoding);
+  void publish_program_notification(const std::string &program_id,
+                                    const std::string &result,
+                                    CommitmentLevel commitment,
+                                    AccountEncoding encoding);
+
+  /// Interest masks (see interest_bit); 0 when nobody is subscribed
+  uint8_t account_interest(const std::string &pubkey) const;
+  uint8_t program_interest(const std::string &program_id) const;
+
   // Statistics and monitoring
   struct WebSocketStats {
     uint64_t total_connections;
@@ -154,11 +215,85 @@ public:
     uint64_t active_subscriptions;
     uint64_t messages_sent;
     uint64_t uptime_seconds;
+    uint64_t slow_consumer_evictions;
   };
 
   WebSocketStats get_stats() const;
   std::vector<std::string> get_connected_clients() const;
+
+  /// Number of subscribers currently registered for an account
+  size_t account_subscriber_count(const std::string &pubkey) const;
+
+private:
+  class SubscriptionTable;
+  struct Reactor;
+
+  std::string bind_address;
+  int port;
+  int server_socket;
+  WebSocketServerConfig config;
+  std::atomic<bool> running;
+  std::chrono::steady_clock::time_point start_time;
+  std::vector<std::unique_ptr<Reactor>> reactors;
+  /// Shared by publishers handing work to reactors; exclusive while
+  /// start() builds or stop() tears down the pool
+  mutable std::shared_mutex reactors_mutex;
+  std::atomic<size_t> next_reactor{0};
+
+  // Connection management (ownership; the reactors hold raw pointers)
+  std::unordered_map<WebSocketConnection *,
+                     std::shared_ptr<WebSocketConnection>>
+      connections;
+  mutable std::mutex connections_mutex;
+
+  // Subscription management
+  std::unique_ptr<SubscriptionTable> account_subscriptions;
+  std::unique_ptr<SubscriptionTable> signature_subscriptions;
+  std::unique_ptr<SubscriptionTable> program_subscriptions;
+  std::unique_ptr<SubscriptionTable> slot_subscriptions;
+  std::unique_ptr<SubscriptionTable> block_subscriptions;
+  std::atomic<uint64_t> next_subscription_id{0};
+
+  // Statistics
+  std::atomic<uint64_t> total_connections;
+  std::atomic<uint64_t> active_subscriptions;
+  std::atomic<uint64_t> messages_sent;
+  std::atomic<uint64_t> slow_consumer_evictions{0};
+
+  void reactor_loop(Reactor &reactor);
+  void accept_connections();
+  void handle_readable(Reactor &reactor, WebSocketConnection &conn);
+  void handle_writable(Reactor &reactor, WebSocketConnection &conn);
+  void close_connection(Reactor &reactor, WebSocketConnection &conn);
+  void schedule_flush(const std::shared_ptr<WebSocketConnection> &conn);
+  void send_text(const std::shared_ptr<WebSocketConnection> &conn,
+                 const std::string &message);
+
+  bool handle_websocket_handshake(WebSocketConnection &conn);
+  bool process_frames(WebSocketConnection &conn);
+  void handle_websocket_message(std::shared_ptr<WebSocketConnection> conn,
+                                const std::string &message);
+
+  // WebSocket protocol handlers
+  std::string compute_websocket_accept(const std::string &key);
+
+  // Subscription handlers
+  void handle_subscribe(std::shared_ptr<WebSocketConnection> conn,
+                        SubscriptionType type, const std::string &key,
+                        const std::string &request_id,
+                        CommitmentLevel commitment = CommitmentLevel::FINALIZED,
+                        AccountEncoding encoding = AccountEncoding::BASE64);
+  void handle_unsubscribe(std::shared_ptr<WebSocketConnection> conn,
+                          uint64_t subscription_id,
+                          const std::string &request_id);
+  SubscriptionTable &table_for(SubscriptionType type);
+  const std::string &table_key(const SubscriptionRequest &request) const;
+
+  /// Fan one serialized notification out to every subscriber of key
+  void publish(SubscriptionTable &table, const std::string &key,
+               const std::string &method, const std::string &result,
+               bool one_shot = false, uint8_t accept_mask = 0xFF);
 };
 
 } // namespace network
-} // namespace slonana
\ No newline at end of file
+} // namespace slonana
@@ -2,10 +2,14 @@
 
 #include "banking/banking_stage.h"
 #include "common/types.h"
+#include "consensus/advanced_fork_choice.h"
 #include "ledger/manager.h"
+#include "network/account_notification_dispatcher.h"
 #include "network/gossip.h"
 #include "network/rpc_server.h"
 #include "staking/manager.h"
+#include "storage/account_change_feed.h"
+#include "storage/accounts_db.h"
 #include "svm/engine.h"
 #include "validator/core.h"
 #include "validator/snapshot_bootstrap.h"
@@ -76,6 +80,14 @@ private:
   std::shared_ptr<svm::AccountManager> account_manager_;
   std::unique_ptr<validator::SnapshotBootstrapManager> snapshot_bootstrap_;
 
+  // Committed accounts flow through the account store's change feed to
+  // pubsub subscribers as fork choice reports each slot's commitment
+  std::shared_ptr<storage::AccountsDB> accounts_db_;
+  std::shared_ptr<storage::AccountChangeFeed> account_change_feed_;
+  std::shared_ptr<consensus::AdvancedForkChoice> fork_choice_;
+  std::unique_ptr<network::AccountNotificationDispatcher>
+      account_notifications_;
+
   // Configuration and state
   ValidatorConfig config_;
   PublicKey validator_identity_;
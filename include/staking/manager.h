@@ -4,8 +4,13 @@
 #include <memory>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace slonana {
+namespace storage {
+class AccountsDB;
+}
+
 namespace staking {
 
 using namespace slonana::common;
@@ -17,10 +22,10 @@ struct StakeAccount {
   PublicKey stake_pubkey;
   PublicKey validator_pubkey;
   PublicKey delegator_pubkey;
-  Lamports stake_amount;
-  Epoch activation_epoch;
-  Epoch deactivation_epoch;
-  bool is_active;
+  Lamports stake_amount = 0;
+  Epoch activation_epoch = 0;
+  Epoch deactivation_epoch = 0;
+  bool is_active = false;
 
   std::vector<uint8_t> serialize() const;
   static StakeAccount deserialize(const std::vector<uint8_t> &data);
@@ -31,18 +36,51 @@ struct StakeAccount {
  */
 struct ValidatorStakeInfo {
   PublicKey validator_identity;
-  Lamports total_stake;
-  Lamports self_stake;
-  Lamports delegated_stake;
-  uint32_t commission_rate; // basis points (0-10000)
-  Epoch last_vote_epoch;
-  uint64_t vote_credits;
+  Lamports total_stake = 0;
+  Lamports self_stake = 0;
+  Lamports delegated_stake = 0;
+  uint32_t commission_rate = 0; // basis points (0-10000)
+  Epoch last_vote_epoch = 0;
+  uint64_t vote_credits = 0;
   double uptime_percentage = 1.0; // 0.0 to 1.0
   double skip_rate = 0.0;         // 0.0 to 100.0 (percentage of slots skipped)
 
   double calculate_apr() const;
 };
 
+/**
+ * Stake delegations frozen for one epoch
+ *
+ * Built once from the active stake accounts and shared read-only by reward
+ * calculation and leader scheduling for that epoch. Validators are ordered
+ * by descending stake, ties by descending identity as in Agave's leader
+ * schedule, and their delegations are stored contiguously in that order,
+ * so a validator's delegations are one slice and a stake-weighted draw is
+ * a binary search over the running totals.
+ */
+struct EpochStakes {
+  struct Delegation {
+    PublicKey stake_pubkey;
+    Lamports stake = 0;
+  };
+
+  Epoch epoch = 0;
+  Lamports total_stake = 0;
+  std::vector<PublicKey> validators;
+  std::vector<Lamports> validator_stakes;
+  /// cumulative_stakes[i] = stake of validators [0, i]
+  std::vector<Lamports> cumulative_stakes;
+  /// Validator i's delegations are [delegation_offsets[i], delegation_offsets[i + 1])
+  std::vector<size_t> delegation_offsets;
+  std::vector<Delegation> delegations;
+  std::unordered_map<PublicKey, size_t> validator_index;
+
+  /// Stake delegated to `validator` in this epoch (0 if none)
+  Lamports stake_of(const PublicKey &validator) const;
+  /// Validator whose share of [0, total_stake) holds `point`
+  size_t validator_at(Lamports point) const;
+};
+
 /**
  * Reward calculation and distribution
  */
@@ -76,7 +114,8 @@ private:
 };
 
 /**
- * Staking manager for handling stake accounts and reward distribution
+ * Staking manager for handling stake accounts and reward distribution.
+ * Safe to share between threads.
  */
 class StakingManager {
 public:
@@ -98,11 +137,47 @@ public:
   ValidatorStakeInfo
   get_validator_stake_info(const PublicKey &validator_pubkey) const;
 
+  static constexpr Slot DEFAULT_SLOTS_PER_EPOCH = 432000;
+  /// Reward credits paid per slot on average, as in Agave's partitioned
+  /// rewards. Credits are spread by hash, so a partition may hold more.
+  static constexpr size_t REWARDS_PER_PARTITION = 4096;
+  static constexpr size_t EPOCH_STAKES_KEPT = 3;
+
+  /**
+   * Stakes for `epoch`, built from the active stake accounts the first time
+   * the epoch is asked for and cached for the latest EPOCH_STAKES_KEPT
+   * epochs. Later stake changes do not alter an epoch already built.
+   */
+  std::shared_ptr<const EpochStakes> get_epoch_stakes(Epoch epoch);
+
   // Reward processing
+  /**
+   * Calculate the rewards earned in `epoch` over its epoch stakes, split
+   * across the reward threads, and schedule the credits: partition i (of
+   * ceil(credits / REWARDS_PER_PARTITION), by stake account hash) is paid
+   * at the (i + 1)-th slot of the next epoch by credit_epoch_rewards().
+   * Partitions still pending from an earlier epoch are paid first; any
+   * whose write fails again stay pending.
+   */
   Result<bool> distribute_epoch_rewards(Epoch epoch);
+  /**
+   * Pay every partition scheduled at or before `slot`, each as a single
+   * AccountsDB batch write, and compound the rewards into the stake. A
+   * partition whose write fails stays pending, with the ones after it, and
+   * is retried by the next call.
+   * @return Number of accounts credited
+   */
+  size_t credit_epoch_rewards(Slot slot);
+  size_t get_pending_reward_partitions() const;
   std::unordered_map<PublicKey, Lamports>
   calculate_pending_rewards(Epoch epoch) const;
 
+  /// Store reward credits are written to (optional)
+  void set_accounts_db(std::shared_ptr<storage::AccountsDB> accounts_db);
+  void set_slots_per_epoch(Slot slots_per_epoch);
+  /// Threads used for reward calculation; 0 = all cores
+  void set_reward_threads(size_t threads);
+
   // Validator operations
   Result<bool> register_validator(const PublicKey &validator_identity,
                                   uint32_t commission_rate);
@@ -116,22 +191,6 @@ public:
 private:
   std::unique_ptr<RewardsCalculator> rewards_calculator_;
 
-  // Production ledger integration methods
-  std::vector<uint8_t>
-  create_reward_distribution_instruction(const PublicKey &stake_account,
-                                         Lamports reward_amount) const;
-  bool submit_ledger_transaction(const std::vector<uint8_t> &instruction) const;
-  uint64_t get_current_slot() const;
-  void record_reward_distribution(const PublicKey &stake_account,
-                                  Lamports amount) const;
-  bool validate_stake_account(const StakeAccount &stake_account) const;
-
-  // Helper method for reward distribution
-  bool distribute_rewards_to_account(const StakeAccount &stake_account,
-                                     Lamports delegator_rewards,
-                                     Lamports validator_rewards,
-                                     Epoch epoch) const;
-
   class Impl;
   std::unique_ptr<Impl> impl_;
 };
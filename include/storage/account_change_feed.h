@@ -0,0 +1,82 @@
+#pragma once
+
+#include "common/types.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace slonana {
+namespace storage {
+
+using namespace slonana::common;
+
+/**
+ * One committed account write. Keys are stored inline so publishing never
+ * allocates; the account contents are read back from the store at the
+ * recorded slot when (and only if) someone is subscribed.
+ */
+struct AccountChangeRecord {
+  uint64_t slot = 0;
+  uint64_t version = 0;
+  std::array<uint8_t, 32> pubkey{};
+  std::array<uint8_t, 32> owner{};
+  bool deleted = false;
+
+  PublicKey pubkey_key() const { return PublicKey(pubkey.begin(), pubkey.end()); }
+  PublicKey owner_key() const { return PublicKey(owner.begin(), owner.end()); }
+};
+
+/**
+ * Commit-time account change feed: bounded lock-free multi-producer,
+ * single-consumer ring (sequence-numbered cells).
+ *
+ * Producers are the account store's write paths and must never block, so a
+ * full ring drops the record and counts it in dropped(); consumers that see
+ * drops should treat subscribers as possibly stale.
+ */
+class AccountChangeFeed {
+public:
+  /// Capacity is rounded up to a power of two
+  explicit AccountChangeFeed(size_t capacity = 65536);
+
+  AccountChangeFeed(const AccountChangeFeed &) = delete;
+  AccountChangeFeed &operator=(const AccountChangeFeed &) = delete;
+
+  /// Publish a record; false when the ring is full (record dropped)
+  bool publish(const AccountChangeRecord &record) noexcept;
+
+  /// Convenience for the account store: keys are truncated/zero-padded to 32
+  bool publish(uint64_t slot, const PublicKey &pubkey, uint64_t version,
+               const PublicKey &owner, bool deleted = false) noexcept;
+
+  /// Move up to max_records into out (appends); single consumer only
+  size_t drain(std::vector<AccountChangeRecord> &out,
+               size_t max_records = SIZE_MAX) noexcept;
+
+  size_t capacity() const noexcept { return mask_ + 1; }
+  uint64_t published() const noexcept {
+    return published_.load(std::memory_order_relaxed);
+  }
+  uint64_t dropped() const noexcept {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct alignas(64) Cell {
+    std::atomic<uint64_t> sequence{0};
+    AccountChangeRecord record;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(64) std::atomic<uint64_t> tail_{0}; ///< Next slot for producers
+  alignas(64) uint64_t head_ = 0;             ///< Consumer position
+  std::atomic<uint64_t> published_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+} // namespace storage
+} // namespace slonana
@@ -1,15 +1,20 @@
 #pragma once
 
 #include "common/types.h"
+#include "storage/account_change_feed.h"
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace slonana {
@@ -70,6 +75,17 @@ struct AccountIndex {
   AccountIndex(const PublicKey& key) : account_key(key), current_version(0), current_slot(0) {}
 };
 
+/**
+ * State of an account as of the end of a slot range, for incremental
+ * snapshots. A deleted account is reported as a tombstone.
+ */
+struct ModifiedAccount {
+  PublicKey account_key;
+  uint64_t slot;   ///< Slot of the account's latest write in the range
+  bool is_deleted;
+  AccountData data; ///< Empty for tombstones
+};
+
 /**
  * Advanced accounts database with versioning, optimization and garbage collection
  * Compatible with Agave's account storage design
@@ -155,6 +171,14 @@ public:
   // Batch operations
   bool store_accounts_batch(const std::vector<std::pair<PublicKey, AccountData>>& accounts, uint64_t slot);
   std::unordered_map<PublicKey, AccountData> load_accounts_batch(const std::vector<PublicKey>& account_keys, uint64_t slot = UINT64_MAX);
+  /**
+   * Look up many accounts under one lock without copying their data. Index
+   * probes for the whole batch are issued first, prefetching each entry,
+   * and the versions are resolved in a second pass. Results follow
+   * `account_keys`; missing and deleted accounts are nullptr. The returned
+   * data stays valid after the version is superseded or collected.
+   */
+  std::vector<std::shared_ptr<const AccountData>> load_accounts_shared(const std::vector<PublicKey>& account_keys, uint64_t slot = UINT64_MAX);
   
   // Index operations
   std::vector<PublicKey> get_accounts_by_owner(const PublicKey& owner_key);
@@ -168,6 +192,47 @@ public:
   
   // Snapshot operations
   bool create_snapshot(uint64_t slot, const std::string& snapshot_path);
+  /**
+   * Accounts written or deleted in slots (base_slot, slot], each at its
+   * latest version up to `slot`. Read from the per-slot dirty sets kept on
+   * every commit, so the cost follows the number of changes rather than
+   * the size of the store.
+   * @return false if dirty sets at or before base_slot were already pruned
+   *         or predate tracking, tracking is off, or an account's version
+   *         at `slot` was already garbage collected
+   */
+  bool collect_modified_accounts(uint64_t base_slot, uint64_t slot,
+                                 std::vector<ModifiedAccount>& accounts);
+  /// Every live account at its latest version up to `slot`
+  void collect_accounts_at_slot(uint64_t slot,
+                                std::vector<ModifiedAccount>& accounts);
+  /**
+   * Every live account at its latest version up to `slot`, in pubkey
+   * order, handed to `visit` in batches of at most `batch_size`. The keys
+   * are gathered in one pass and sorted, then each batch's versions are
+   * read under a short shared lock, so only keys (not account data) scale
+   * with the store. The lock is released while `visit` runs; writes above
+   * `slot` do not change what later batches see.
+   * @return false if `visit` returned false to stop early
+   */
+  bool for_each_account_at_slot(
+      uint64_t slot, size_t batch_size,
+      const std::function<bool(std::vector<ModifiedAccount>&)>& visit);
+  /**
+   * Forget dirty sets for slots up to `slot`, once a full snapshot covers
+   * them. Incremental snapshots must then use a base at or after `slot`.
+   */
+  void prune_dirty_accounts(uint64_t slot);
+  /**
+   * Keep per-slot dirty sets for incremental snapshots. Off until a
+   * snapshot consumer turns it on, so a store nobody snapshots does not
+   * accumulate them; ignored unless enable_snapshots is set. Writes before
+   * tracking began are unknown, so bases must be at or after the latest
+   * slot written by then. Turning it off drops the sets.
+   */
+  void set_dirty_tracking(bool enabled);
+  bool is_dirty_tracking() const;
+  size_t get_dirty_slot_count() const;
   bool load_from_snapshot(const std::string& snapshot_path);
   std::vector<std::string> list_snapshots() const;
   
@@ -184,6 +249,14 @@ public:
   void update_configuration(const Configuration& new_config);
   const Configuration& get_configuration() const { return config_; }
   
+  // Change notifications
+  /**
+   * Publish a record to the feed for every committed write/delete. Set
+   * before the store is shared between threads.
+   */
+  void set_change_feed(std::shared_ptr<AccountChangeFeed> feed) { change_feed_ = std::move(feed); }
+  std::shared_ptr<AccountChangeFeed> get_change_feed() const { return change_feed_; }
+  
   // Database maintenance
   bool compact_database();
   bool verify_integrity();
@@ -212,10 +285,24 @@ private:
   mutable std::unordered_map<PublicKey, std::list<LRUCacheEntry>::iterator> cache_map_;
   mutable std::mutex cache_mutex_;
   
+  // Accounts touched per slot, for incremental snapshots; guarded by
+  // index_mutex_ like the index it mirrors
+  std::map<uint64_t, std::unordered_set<PublicKey>> dirty_accounts_;
+  uint64_t dirty_pruned_through_ = 0;
+  bool dirty_pruned_ = false;
+  bool dirty_tracking_ = false;
+  uint64_t latest_written_slot_ = 0;
+  void mark_dirty(const PublicKey& account_key, uint64_t slot);
+  
+  // Commit-time change feed (optional)
+  std::shared_ptr<AccountChangeFeed> change_feed_;
+  
   // Garbage collection
   std::atomic<bool> gc_enabled_{true};
   std::thread gc_thread_;
   std::atomic<bool> should_stop_gc_{false};
+  std::mutex gc_mutex_;
+  std::condition_variable gc_cv_; ///< Wakes the GC thread on shutdown
   
   // Background operations
   void gc_worker_loop();
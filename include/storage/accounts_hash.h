@@ -0,0 +1,124 @@
+#pragma once
+
+#include "storage/accounts_db.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace slonana {
+namespace storage {
+
+using AccountHash = std::array<uint8_t, 32>;
+
+/**
+ * Merkle accounts hash
+ *
+ * Each account hashes to
+ *   SHA-256(lamports || rent_epoch || SHA-256(data) || executable || owner ||
+ *           pubkey)
+ * (integers little-endian), and a zero-lamport account to the zero hash.
+ * Accounts are split into bins by the leading bits of their pubkey; a bin's
+ * root is the fanout-16 Merkle root of its account hashes in pubkey order,
+ * and the accounts hash is the fanout-16 Merkle root of the non-empty bin
+ * roots in bin order. Zero-lamport accounts are left out unless
+ * include_zero_lamport is set, as incremental snapshots need.
+ *
+ * Account hashes are kept per bin, so after a change only the touched bins
+ * are rehashed. Hashing accounts and rehashing bins both run on a pool of
+ * threads, and the bins can be saved to disk and loaded by a later run.
+ */
+class AccountsHasher {
+public:
+  static constexpr size_t MERKLE_FANOUT = 16;
+  /// Part of the hash definition, like the fanout
+  static constexpr size_t BINS = 4096;
+
+  struct Options {
+    size_t threads = 0; ///< 0 = all cores
+    bool include_zero_lamport = false;
+  };
+
+  struct Statistics {
+    uint64_t accounts_hashed = 0; ///< Account hashes computed, all time
+    uint64_t bins_rehashed = 0;   ///< Bin roots recomputed, all time
+    uint64_t full_rebuilds = 0;
+    double last_update_seconds = 0.0;
+  };
+
+  AccountsHasher();
+  explicit AccountsHasher(const Options &options);
+
+  static AccountHash hash_account(const PublicKey &pubkey, uint64_t lamports,
+                                  const PublicKey &owner, bool executable,
+                                  uint64_t rent_epoch, const uint8_t *data,
+                                  size_t data_size);
+  static AccountHash hash_account(const PublicKey &pubkey,
+                                  const AccountData &account);
+  /// Fanout-N Merkle root; the zero hash for no leaves
+  static AccountHash merkle_root(std::vector<AccountHash> hashes,
+                                 size_t fanout = MERKLE_FANOUT);
+  static std::string to_hex(const AccountHash &hash);
+
+  /// Replace the whole state with `accounts` (deleted entries are skipped)
+  void rebuild(const std::vector<ModifiedAccount> &accounts, uint64_t slot);
+  /// Apply the latest state of changed accounts; deletions remove them
+  void apply(const std::vector<ModifiedAccount> &changes, uint64_t slot);
+  /**
+   * Bring the hash up to `slot` from the store's dirty-account tracking,
+   * rebuilding from every live account when the tracking no longer
+   * reaches back to the last hashed slot (or `slot` is older than it).
+   */
+  void update_from(AccountsDB &accounts_db, uint64_t slot);
+  /// Add precomputed account hashes; a key seen twice keeps the last one
+  void insert_hashes(std::vector<std::pair<PublicKey, AccountHash>> hashes);
+
+  /// Recompute touched bins and return the accounts hash
+  AccountHash root();
+  std::string root_hex() { return to_hex(root()); }
+
+  bool is_built() const { return built_; }
+  uint64_t slot() const { return slot_; }
+  size_t account_count() const;
+  const Statistics &statistics() const { return stats_; }
+
+  /**
+   * Persist account hashes and bin roots, checksummed. A loaded cache
+   * matches a store restored from the snapshot taken at its slot.
+   */
+  bool save(const std::string &path);
+  bool load(const std::string &path);
+
+private:
+  using Key = std::array<uint8_t, 32>;
+
+  struct Bin {
+    std::vector<std::pair<Key, AccountHash>> leaves; ///< Sorted by key
+    AccountHash root{};
+    bool dirty = false;
+  };
+
+  /// Change to one account: a new hash, or its removal
+  struct Update {
+    Key key;
+    bool remove;
+    AccountHash hash;
+  };
+
+  size_t bin_of(const Key &key) const;
+  bool keeps(const AccountHash &hash) const;
+  void apply_updates(std::vector<Update> &updates);
+  template <typename Task> void run_parallel(size_t count, Task &&task) const;
+
+  Options options_;
+  std::vector<Bin> bins_;
+  AccountHash root_{};
+  bool root_valid_ = false;
+  bool built_ = false;
+  uint64_t slot_ = 0;
+  Statistics stats_;
+};
+
+} // namespace storage
+} // namespace slonana
@@ -9,6 +9,10 @@
 #include <vector>
 
 namespace slonana {
+namespace storage {
+class AccountsDB;
+}
+
 namespace svm {
 
 using namespace slonana::common;
@@ -108,6 +112,76 @@ public:
    * Get rent calculator
    */
   virtual Lamports calculate_rent(size_t data_size) = 0;
+
+  /**
+   * Get several accounts at once, aligned with `addresses` (nullptr where
+   * missing). The default asks get_account for each; stores that can look
+   * a batch up together should override it.
+   */
+  virtual std::vector<std::shared_ptr<const AccountInfo>>
+  get_accounts(const std::vector<PublicKey> &addresses);
+};
+
+/**
+ * Loading callback backed by AccountsDB: a batch is fetched with one
+ * AccountsDB::load_accounts_shared call and converted in storage order,
+ * prefetching the next account's data while copying the current one
+ */
+class AccountsDbLoadingCallback : public AccountLoadingCallback {
+public:
+  AccountsDbLoadingCallback(storage::AccountsDB &accounts_db, Slot slot);
+
+  std::optional<AccountInfo> get_account(const PublicKey &address) override;
+  bool account_exists(const PublicKey &address) override;
+  Slot get_slot() override { return slot_; }
+  Lamports calculate_rent(size_t data_size) override;
+  std::vector<std::shared_ptr<const AccountInfo>>
+  get_accounts(const std::vector<PublicKey> &addresses) override;
+
+private:
+  storage::AccountsDB &accounts_db_;
+  Slot slot_;
+};
+
+/**
+ * Account keys of one transaction in a batch. account_keys[0] pays the fee.
+ */
+struct TransactionAccountKeys {
+  std::vector<PublicKey> account_keys;
+  std::vector<bool> is_signer;
+  std::vector<bool> is_writable;
+  Lamports fee = 0;
+};
+
+/**
+ * Accounts for a batch of transactions, each loaded once
+ *
+ * `accounts` holds the de-duplicated union of the batch's accounts; each
+ * transaction refers to its accounts by position in it rather than holding
+ * copies, so a fee payer, sysvar or program shared by the whole batch is
+ * loaded and stored once.
+ */
+struct LoadedBatch {
+  struct Transaction {
+    std::vector<uint32_t> account_indices; ///< Into accounts, per account key
+    Lamports fee = 0;
+    Lamports rent = 0;
+    size_t loaded_accounts_data_size = 0;
+    TransactionLoadResult load_result = TransactionLoadResult::SUCCESS;
+
+    bool is_success() const {
+      return load_result == TransactionLoadResult::SUCCESS;
+    }
+  };
+
+  std::vector<PublicKey> keys;
+  std::vector<std::shared_ptr<const AccountInfo>> accounts; ///< Per key
+  std::vector<Transaction> transactions;
+
+  /// The account at `position` in transaction `transaction`'s key list
+  const AccountInfo &account(size_t transaction, size_t position) const {
+    return *accounts[transactions[transaction].account_indices[position]];
+  }
 };
 
 /**
@@ -129,6 +203,19 @@ public:
                             const PublicKey &fee_payer, Lamports fee_amount,
                             size_t max_loaded_accounts_data_size = SIZE_MAX);
 
+  /**
+   * Load the accounts of a batch of transactions: the union of their keys
+   * not already cached is fetched with one get_accounts call. Builtin
+   * programs and sysvars are never fetched; they come from the builtin
+   * table and SysvarCache::current(), and stay cached until reset(). A
+   * transaction fails to load if it lists a writable account twice, uses
+   * a missing account, exceeds `max_loaded_accounts_data_size`, or its fee
+   * payer cannot cover the fee.
+   */
+  LoadedBatch
+  load_batch(const std::vector<TransactionAccountKeys> &transactions,
+             size_t max_loaded_accounts_data_size = SIZE_MAX);
+
   /**
    * Load a single account
    */
@@ -155,6 +242,8 @@ public:
     size_t hits = 0;
     size_t misses = 0;
     size_t total_loaded_size = 0;
+    size_t batch_fetches = 0; ///< get_accounts calls made
+    size_t builtin_loads = 0; ///< Builtins and sysvars served without one
   };
   CacheStats get_cache_stats() const;
 
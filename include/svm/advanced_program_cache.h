@@ -1,12 +1,17 @@
 #pragma once
 
 #include "common/types.h"
+#include "svm/bpf_verifier.h"
+#include <array>
 #include <atomic>
 #include <chrono>
-#include <list>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -17,23 +22,55 @@ namespace svm {
 using namespace slonana::common;
 
 /**
- * Compiled program metadata
+ * Execution tiers of a cached program, cheapest to fastest
+ *
+ * VERIFIED holds checked bytecode only. DECODED adds the instructions
+ * decoded into DecodedOps so the interpreter skips byte parsing. JIT adds
+ * native code. Programs start VERIFIED and are promoted in the background
+ * as their execution count crosses the configured thresholds.
+ */
+enum class ProgramTier : uint8_t { VERIFIED = 0, DECODED = 1, JIT = 2 };
+
+static constexpr size_t PROGRAM_TIER_COUNT = 3;
+
+/**
+ * One deployed version of a program
+ *
+ * A version is immutable once published in the cache; tier promotion
+ * publishes a new version in its place. Only the execution count, the
+ * clock reference bit and the promotion flag change afterwards, atomically.
  */
 struct CompiledProgram {
   PublicKey program_id;
   std::vector<uint8_t> bytecode;
+  std::shared_ptr<const VerifiedProgram> verified;  // Null if not verified
+  std::vector<DecodedOp> decoded_ops;
   std::vector<uint8_t> compiled_code;  // JIT compiled machine code
+  Slot deployment_slot = 0;
+  Slot effective_slot = 0;  // First slot this version is visible in
+  ProgramTier tier = ProgramTier::VERIFIED;
   std::chrono::steady_clock::time_point compilation_time;
-  std::chrono::steady_clock::time_point last_access_time;
-  uint64_t execution_count;
+  mutable std::atomic<uint64_t> execution_count{0};
+  mutable std::atomic<bool> referenced{true};  // Clock bit, set on each hit
+  mutable std::atomic<bool> promotion_queued{false};
   uint64_t compilation_cost_us;  // Microseconds to compile
   bool is_precompiled;
   size_t memory_usage;
   
   CompiledProgram(const PublicKey& id, const std::vector<uint8_t>& code)
       : program_id(id), bytecode(code), compilation_time(std::chrono::steady_clock::now()),
-        last_access_time(std::chrono::steady_clock::now()), execution_count(0),
         compilation_cost_us(0), is_precompiled(false), memory_usage(code.size()) {}
+
+  // Copy constructor
+  CompiledProgram(const CompiledProgram& other)
+      : program_id(other.program_id), bytecode(other.bytecode),
+        verified(other.verified), decoded_ops(other.decoded_ops), compiled_code(other.compiled_code),
+        deployment_slot(other.deployment_slot), effective_slot(other.effective_slot),
+        tier(other.tier), compilation_time(other.compilation_time),
+        execution_count(other.execution_count.load()),
+        referenced(other.referenced.load()),
+        compilation_cost_us(other.compilation_cost_us),
+        is_precompiled(other.is_precompiled), memory_usage(other.memory_usage) {}
 };
 
 /**
@@ -43,6 +80,10 @@ struct CacheStatistics {
   std::atomic<size_t> total_programs{0};
   std::atomic<size_t> cache_hits{0};
   std::atomic<size_t> cache_misses{0};
+  std::atomic<size_t> tier_hits[PROGRAM_TIER_COUNT] = {};
+  std::atomic<size_t> delayed_visibility{0};  // Deployed, not yet visible
+  std::atomic<size_t> loads{0};
+  std::atomic<size_t> cooperative_waits{0};  // Waited on another thread's load
   std::atomic<size_t> compilations{0};
   std::atomic<size_t> evictions{0};
   std::atomic<size_t> precompiled_programs{0};
@@ -55,12 +96,19 @@ struct CacheStatistics {
       : total_programs(other.total_programs.load())
       , cache_hits(other.cache_hits.load())
       , cache_misses(other.cache_misses.load())
+      , delayed_visibility(other.delayed_visibility.load())
+      , loads(other.loads.load())
+      , cooperative_waits(other.cooperative_waits.load())
       , compilations(other.compilations.load())
       , evictions(other.evictions.load())
       , precompiled_programs(other.precompiled_programs.load())
       , total_compilation_time_us(other.total_compilation_time_us.load())
       , total_memory_usage(other.total_memory_usage.load())
-      , last_gc_run(other.last_gc_run) {}
+      , last_gc_run(other.last_gc_run) {
+    for (size_t i = 0; i < PROGRAM_TIER_COUNT; ++i) {
+      tier_hits[i].store(other.tier_hits[i].load());
+    }
+  }
   
   // Assignment operator
   CacheStatistics& operator=(const CacheStatistics& other) {
@@ -68,6 +116,12 @@ struct CacheStatistics {
       total_programs.store(other.total_programs.load());
       cache_hits.store(other.cache_hits.load());
       cache_misses.store(other.cache_misses.load());
+      for (size_t i = 0; i < PROGRAM_TIER_COUNT; ++i) {
+        tier_hits[i].store(other.tier_hits[i].load());
+      }
+      delayed_visibility.store(other.delayed_visibility.load());
+      loads.store(other.loads.load());
+      cooperative_waits.store(other.cooperative_waits.load());
       compilations.store(other.compilations.load());
       evictions.store(other.evictions.load());
       precompiled_programs.store(other.precompiled_programs.load());
@@ -88,6 +142,13 @@ struct CacheStatistics {
     uint64_t total = hits + misses;
     return total > 0 ? (double)hits / total : 0.0;
   }
+
+  // Share of all lookups served at the given tier
+  double get_tier_hit_rate(ProgramTier tier) const {
+    uint64_t total = cache_hits.load() + cache_misses.load();
+    uint64_t hits = tier_hits[static_cast<size_t>(tier)].load();
+    return total > 0 ? (double)hits / total : 0.0;
+  }
   
   // Calculate average compilation time
   double get_avg_compilation_time_us() const {
@@ -98,10 +159,26 @@ struct CacheStatistics {
 };
 
 /**
- * Advanced Program Cache with JIT compilation and smart eviction
+ * Advanced Program Cache with slot-versioned, tiered entries
+ *
+ * Each program keeps its deployed versions ordered by effective slot; a
+ * lookup at a slot sees the newest version effective by then, so a redeploy
+ * in slot S is only visible from S + 1 (Agave's delay-visibility rule).
+ *
+ * Reads never take a lock: programs are spread over shards, each published
+ * as an immutable snapshot that writers copy, edit and swap atomically.
+ * Recency is a clock bit set on every hit and cleared by the eviction
+ * sweep, so a hit writes nothing shared beyond counters.
+ *
+ * On a miss, get_or_load() lets the first caller run the loader while
+ * concurrent callers for the same program wait on that load.
  */
 class AdvancedProgramCache {
 public:
+  static constexpr size_t SHARD_COUNT = 16;
+  /// Slots a deployment waits before it becomes visible
+  static constexpr Slot DELAY_VISIBILITY_SLOT_OFFSET = 1;
+
   struct Configuration {
     size_t max_cache_size;
     size_t max_memory_usage_mb;
@@ -110,7 +187,10 @@ public:
     bool enable_precompilation;
     bool enable_aggressive_gc;
     bool enable_compilation_metrics;
+    bool verify_programs;
     double eviction_threshold;  // Evict when cache > threshold * max_size
+    uint64_t decode_threshold;  // Executions before decoding, 0 disables
+    uint64_t jit_threshold;     // Executions before JIT compiling, 0 disables
     
     Configuration()
         : max_cache_size(1000)
@@ -120,23 +200,49 @@ public:
         , enable_precompilation(true)
         , enable_aggressive_gc(false)
         , enable_compilation_metrics(true)
-        , eviction_threshold(0.8) {}
+        , verify_programs(true)
+        , eviction_threshold(0.8)
+        , decode_threshold(2)
+        , jit_threshold(100) {}
   };
+
+  /// Bytecode of a program as deployed on chain
+  struct ProgramSource {
+    std::vector<uint8_t> bytecode;
+    Slot deployment_slot = 0;
+  };
+  using ProgramLoader =
+      std::function<std::optional<ProgramSource>(const PublicKey&)>;
   
   explicit AdvancedProgramCache(const Configuration& config = Configuration{});
   ~AdvancedProgramCache();
   
   // Core cache operations
-  std::shared_ptr<CompiledProgram> get_program(const PublicKey& program_id);
-  bool cache_program(const PublicKey& program_id, const std::vector<uint8_t>& bytecode);
-  bool precompile_program(const PublicKey& program_id, const std::vector<uint8_t>& bytecode);
+  /// Version visible at slot, nullptr on a miss
+  std::shared_ptr<const CompiledProgram> get_program(const PublicKey& program_id,
+                                                     Slot slot);
+  /**
+   * Version visible at slot, loading it on a miss. Only one caller runs the
+   * loader per program; the others wait for its result.
+   */
+  std::shared_ptr<const CompiledProgram>
+  get_or_load(const PublicKey& program_id, Slot slot, const ProgramLoader& loader);
+  /// Deploy a version at deployment_slot, visible from the next slot
+  bool cache_program(const PublicKey& program_id, const std::vector<uint8_t>& bytecode,
+                     Slot deployment_slot = 0);
+  bool precompile_program(const PublicKey& program_id, const std::vector<uint8_t>& bytecode,
+                          Slot deployment_slot = 0);
   void invalidate_program(const PublicKey& program_id);
+  /// Drop versions superseded by a version already effective at root_slot
+  void prune(Slot root_slot);
   void clear_cache();
   
   // Compilation management
   bool compile_program(CompiledProgram& program);
   std::vector<PublicKey> get_precompilation_candidates() const;
   void background_precompilation();
+  /// Tier promotions queued for the background thread
+  size_t pending_promotions() const;
   
   // Cache management
   void garbage_collect();
@@ -166,18 +272,29 @@ private:
   Configuration config_;
   mutable CacheStatistics stats_;
   
-  // LRU Cache implementation
-  struct CacheEntry {
-    std::shared_ptr<CompiledProgram> program;
-    std::list<PublicKey>::iterator lru_it;
-    
-    CacheEntry() = default;
-    CacheEntry(std::shared_ptr<CompiledProgram> p) : program(p) {}
+  // Versions of each program, ascending by effective slot
+  using VersionMap =
+      std::unordered_map<PublicKey, std::vector<std::shared_ptr<const CompiledProgram>>>;
+
+  struct Shard {
+    std::atomic<std::shared_ptr<const VersionMap>> programs{
+        std::make_shared<const VersionMap>()};
+    std::mutex write_mutex;  // Serializes writers only
   };
-  
-  mutable std::unordered_map<PublicKey, CacheEntry> cache_map_;
-  mutable std::list<PublicKey> lru_list_;
-  mutable std::shared_mutex cache_mutex_;
+
+  std::array<Shard, SHARD_COUNT> shards_;
+  std::atomic<size_t> clock_hand_{0};
+
+  // Cooperative loading: one in-flight load per program
+  std::mutex loading_mutex_;
+  std::unordered_map<PublicKey, std::shared_future<std::shared_ptr<const CompiledProgram>>>
+      loading_;
+
+  // Tier promotions waiting for the precompilation thread
+  mutable std::mutex worker_mutex_;
+  std::condition_variable worker_cv_;
+  std::deque<std::pair<std::shared_ptr<const CompiledProgram>, ProgramTier>>
+      promotion_queue_;
   
   // Background threads
   std::thread gc_thread_;
@@ -188,16 +305,25 @@ private:
   bool jit_compile_bytecode(const std::vector<uint8_t>& bytecode, 
                            std::vector<uint8_t>& compiled_code,
                            uint64_t& compilation_time_us);
+  std::shared_ptr<CompiledProgram> build_version(const PublicKey& program_id,
+                                                 const std::vector<uint8_t>& bytecode,
+                                                 Slot deployment_slot);
+  static void decode_program(CompiledProgram& program);
   
   // Cache management internals
-  void move_to_front(const PublicKey& program_id);
+  Shard& shard_for(const PublicKey& program_id);
+  void update_shard(Shard& shard, const std::function<void(VersionMap&)>& edit);
+  std::shared_ptr<const CompiledProgram> lookup(const PublicKey& program_id, Slot slot,
+                                                bool& deployed);
+  void publish(std::shared_ptr<const CompiledProgram> program);
+  void record_hit(const std::shared_ptr<const CompiledProgram>& program);
   bool should_evict() const;
   size_t calculate_memory_usage() const;
-  void update_access_pattern(const PublicKey& program_id);
   
   // Background workers
   void gc_worker_loop();
   void precompilation_worker_loop();
+  void promote(const std::shared_ptr<const CompiledProgram>& program, ProgramTier tier);
   
   // Smart eviction strategies
   std::vector<PublicKey> select_eviction_candidates(size_t count) const;
@@ -221,9 +347,12 @@ public:
   ~ProgramCacheManager() = default;
   
   // High-level operations
-  bool load_program(const PublicKey& program_id, const std::vector<uint8_t>& bytecode);
-  std::shared_ptr<CompiledProgram> execute_program(const PublicKey& program_id);
-  void warm_up_cache(const std::vector<PublicKey>& program_ids);
+  bool load_program(const PublicKey& program_id, const std::vector<uint8_t>& bytecode,
+                    Slot deployment_slot = 0);
+  std::shared_ptr<const CompiledProgram> execute_program(const PublicKey& program_id,
+                                                         Slot slot);
+  void warm_up_cache(const std::vector<PublicKey>& program_ids, Slot slot,
+                     const AdvancedProgramCache::ProgramLoader& loader);
   
   // Performance monitoring
   void start_performance_monitoring();
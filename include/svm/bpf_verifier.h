@@ -1,17 +1,62 @@
 #pragma once
 
 #include "bpf_runtime.h"
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace slonana {
 namespace svm {
 
+/**
+ * One sBPF instruction decoded from its 8-byte encoding
+ */
+struct DecodedOp {
+  uint8_t opcode = 0;
+  uint8_t dst_reg = 0;
+  uint8_t src_reg = 0;
+  int16_t offset = 0;
+  int32_t immediate = 0;
+};
+
+/**
+ * A program that passed verification, decoded once for reuse
+ *
+ * ops holds one entry per 8-byte slot (the second half of an LDDW is kept
+ * as its own slot, so jump offsets index ops directly). Basic blocks cover
+ * ops in order; successors are block indices. Calls do not end a block:
+ * an internal call (CALL with src_reg 1, target relative to the next op)
+ * lists its target block in callees and continues at the next op once the
+ * callee exits.
+ */
+struct VerifiedProgram {
+  struct BasicBlock {
+    size_t start = 0;  // First op
+    size_t end = 0;    // One past the last op
+    std::vector<size_t> successors;
+    std::vector<size_t> callees;  // Entered with a fresh stack frame
+  };
+
+  std::vector<DecodedOp> ops;
+  std::vector<BasicBlock> blocks;
+  size_t stack_usage = 0;  // Deepest frame-relative stack byte accessed
+  bool has_loops = false;
+};
+
 /**
  * BPF Program Verifier - validates BPF programs for safety and correctness
+ *
+ * Verification is one decode pass that checks each instruction and marks
+ * basic block leaders, then a dataflow pass over the resulting CFG that
+ * tracks register types to bound stack accesses and finds loops with no
+ * way out. Internal call targets are checked against the code and their
+ * functions analyzed in a frame of their own. Results are cached process-wide by SHA-256 of the bytecode and
+ * the verifier options, so a program is verified once per deployment.
  */
 class BpfVerifier {
 public:
+  static constexpr size_t MAX_CACHED_RESULTS = 1024;
+
   BpfVerifier() = default;
   ~BpfVerifier() = default;
 
@@ -22,6 +67,23 @@ public:
    */
   bool verify(const BpfProgram &program);
 
+  /**
+   * Verify bytecode, reusing an earlier result for identical bytecode
+   * @return the decoded program, or nullptr with get_last_error() set
+   */
+  std::shared_ptr<const VerifiedProgram>
+  verify_cached(const std::vector<uint8_t> &bytecode);
+
+  /// Verify without consulting or filling the cache
+  std::shared_ptr<const VerifiedProgram>
+  verify_program(const std::vector<uint8_t> &bytecode);
+
+  /// Decode bytecode without verifying it
+  static std::vector<DecodedOp> decode(const std::vector<uint8_t> &bytecode);
+
+  static size_t cached_results();
+  static void clear_cache();
+
   /**
    * Get the last verification error message
    */
@@ -40,12 +102,12 @@ private:
   bool allow_infinite_loops_ = false;
   size_t max_stack_depth_ = 512;
 
-  bool verify_instruction_bounds(const BpfProgram &program);
-  bool verify_jump_targets(const BpfProgram &program);
-  bool verify_memory_access(const BpfProgram &program);
-  bool verify_no_infinite_loops(const BpfProgram &program);
-  bool verify_stack_usage(const BpfProgram &program);
+  bool decode_and_build_cfg(const std::vector<uint8_t> &bytecode,
+                            VerifiedProgram &program);
+  bool analyze_dataflow(VerifiedProgram &program);
+  bool verify_termination(VerifiedProgram &program);
+  std::string cache_key(const std::vector<uint8_t> &bytecode) const;
 };
 
 } // namespace svm
-} // namespace slonana
\ No newline at end of file
+} // namespace slonana
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/types.h"
+#include <functional>
 #include <memory>
 #include <optional>
 #include <unordered_map>
@@ -314,6 +315,10 @@ private:
  */
 class AccountManager {
 public:
+  /// Receives the accounts each commit_changes() wrote
+  using CommitListener =
+      std::function<void(const std::vector<ProgramAccount> &)>;
+
   AccountManager();
   ~AccountManager();
 
@@ -334,6 +339,7 @@ public:
   // State management
   Result<bool> commit_changes();
   void rollback_changes();
+  void set_commit_listener(CommitListener listener);
 
   // Rent collection
   Result<bool> collect_rent(Epoch epoch);
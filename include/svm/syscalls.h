@@ -193,6 +193,45 @@ uint64_t sol_get_epoch_rewards_sysvar(
 uint64_t sol_get_last_restart_slot(
     uint64_t* slot_out);
 
+/**
+ * Get Clock Sysvar
+ * 
+ * Copies the 40-byte Clock of the executing slot.
+ * 
+ * @param result Pointer to output buffer (at least 40 bytes)
+ * @param result_len Pointer to output length
+ * @return 0 on success, error code otherwise
+ */
+uint64_t sol_get_clock_sysvar(
+    uint8_t* result,
+    uint64_t* result_len);
+
+/**
+ * Get Rent Sysvar
+ * 
+ * Copies the 17-byte Rent of the executing slot.
+ * 
+ * @param result Pointer to output buffer (at least 17 bytes)
+ * @param result_len Pointer to output length
+ * @return 0 on success, error code otherwise
+ */
+uint64_t sol_get_rent_sysvar(
+    uint8_t* result,
+    uint64_t* result_len);
+
+/**
+ * Get EpochSchedule Sysvar
+ * 
+ * Copies the 33-byte EpochSchedule of the executing slot.
+ * 
+ * @param result Pointer to output buffer (at least 33 bytes)
+ * @param result_len Pointer to output length
+ * @return 0 on success, error code otherwise
+ */
+uint64_t sol_get_epoch_schedule_sysvar(
+    uint8_t* result,
+    uint64_t* result_len);
+
 // ============================================================================
 // Compute Unit Costs for Syscalls
 // ============================================================================
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "common/types.h"
+#include "svm/engine.h"
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace slonana {
+namespace svm {
+
+using namespace slonana::common;
+
+/**
+ * Builtin programs and sysvars: accounts nearly every transaction lists
+ * whose contents are fixed by the runtime rather than stored, so they are
+ * recognised by key instead of being loaded
+ */
+enum class BuiltinAccount : uint8_t {
+  NONE = 0,
+  SYSTEM_PROGRAM,
+  VOTE_PROGRAM,
+  STAKE_PROGRAM,
+  CONFIG_PROGRAM,
+  COMPUTE_BUDGET_PROGRAM,
+  ADDRESS_LOOKUP_TABLE_PROGRAM,
+  BPF_LOADER,
+  BPF_LOADER_UPGRADEABLE,
+  NATIVE_LOADER,
+  TOKEN_PROGRAM,
+  TOKEN_2022_PROGRAM,
+  ASSOCIATED_TOKEN_PROGRAM,
+  MEMO_PROGRAM,
+  CLOCK_SYSVAR,
+  RENT_SYSVAR,
+  EPOCH_SCHEDULE_SYSVAR,
+  EPOCH_REWARDS_SYSVAR,
+  LAST_RESTART_SLOT_SYSVAR,
+  SLOT_HASHES_SYSVAR,
+  STAKE_HISTORY_SYSVAR,
+  INSTRUCTIONS_SYSVAR,
+  RECENT_BLOCKHASHES_SYSVAR,
+};
+
+/**
+ * Which builtin `key` is, or NONE. One multiply over bytes 8..15 indexes a
+ * collision-free table of the known keys and a single compare confirms
+ * the match, so an ordinary account costs no more than a hash probe.
+ */
+BuiltinAccount lookup_builtin_account(const uint8_t *key, size_t length);
+
+inline BuiltinAccount lookup_builtin_account(const PublicKey &key) {
+  return lookup_builtin_account(key.data(), key.size());
+}
+
+/// True for the sysvars, whose data a SysvarSnapshot provides
+bool is_sysvar(BuiltinAccount account);
+
+/// The 32-byte key of a builtin; empty for NONE
+PublicKey builtin_account_key(BuiltinAccount account);
+
+/**
+ * The account of a builtin program: executable, owned by the native
+ * loader, holding its name. Shared, so loading it copies nothing.
+ */
+std::shared_ptr<const AccountInfo> builtin_program_account(
+    BuiltinAccount account);
+
+/**
+ * Clock sysvar (40 bytes: slot, epoch start timestamp, epoch, leader
+ * schedule epoch, unix timestamp)
+ */
+struct ClockSysvar {
+  Slot slot = 0;
+  int64_t epoch_start_timestamp = 0;
+  uint64_t epoch = 0;
+  uint64_t leader_schedule_epoch = 0;
+  int64_t unix_timestamp = 0;
+};
+
+/// Rent sysvar (17 bytes)
+struct RentSysvar {
+  Lamports lamports_per_byte_year = 3480;
+  double exemption_threshold = 2.0;
+  uint8_t burn_percent = 50;
+};
+
+/**
+ * EpochSchedule sysvar (33 bytes). With warmup, epochs start at 32 slots
+ * and double until they reach slots_per_epoch at first_normal_epoch.
+ */
+struct EpochScheduleSysvar {
+  static constexpr uint64_t MINIMUM_SLOTS_PER_EPOCH = 32;
+
+  uint64_t slots_per_epoch = 432000;
+  uint64_t leader_schedule_slot_offset = 432000;
+  bool warmup = false;
+  uint64_t first_normal_epoch = 0;
+  Slot first_normal_slot = 0;
+
+  /// A schedule of `slots_per_epoch`, with the warmup epochs filled in
+  static EpochScheduleSysvar create(uint64_t slots_per_epoch, bool warmup);
+
+  uint64_t get_epoch(Slot slot) const;
+  Slot get_first_slot_in_epoch(uint64_t epoch) const;
+  uint64_t get_leader_schedule_epoch(Slot slot) const;
+};
+
+/// EpochRewards sysvar (60 bytes)
+struct EpochRewardsSysvar {
+  uint64_t total_rewards = 0;       ///< Total rewards for the epoch
+  uint64_t distributed_rewards = 0; ///< Rewards already distributed
+  uint64_t distribution_complete_block_height = 0;
+  uint32_t num_partitions = 0;
+  std::array<uint8_t, 32> parent_blockhash{};
+};
+
+/// Stake of one vote account in the current epoch (16 bytes)
+struct EpochStake {
+  uint64_t activated_stake = 0;
+  uint64_t deactivating_stake = 0;
+};
+
+/**
+ * The sysvars as of one slot
+ *
+ * A snapshot is built once when its bank is created, serializing every
+ * sysvar up front, and never changes afterwards. Syscalls copy the
+ * prepared bytes and loaders hand out the prepared accounts, so neither
+ * rebuilds sysvar data per call or per transaction.
+ */
+class SysvarSnapshot {
+public:
+  SysvarSnapshot(const ClockSysvar &clock, const RentSysvar &rent,
+                 const EpochScheduleSysvar &epoch_schedule,
+                 const EpochRewardsSysvar &epoch_rewards,
+                 Slot last_restart_slot,
+                 std::unordered_map<PublicKey, EpochStake> epoch_stakes = {},
+                 EpochStake unlisted_stake = {});
+
+  /**
+   * The snapshot of slot 0, with a clock starting at `genesis_timestamp`
+   */
+  static std::shared_ptr<const SysvarSnapshot>
+  genesis(int64_t genesis_timestamp,
+          const EpochScheduleSysvar &epoch_schedule = {},
+          const RentSysvar &rent = {});
+
+  /**
+   * The snapshot of a child bank at `slot`: the clock advances 400ms per
+   * slot and a new epoch restarts its timestamp; rent, the epoch schedule,
+   * rewards and stakes carry over
+   */
+  static std::shared_ptr<const SysvarSnapshot>
+  for_slot(const SysvarSnapshot &parent, Slot slot);
+
+  /**
+   * What syscalls see before any bank has installed a snapshot
+   */
+  static const std::shared_ptr<const SysvarSnapshot> &defaults();
+
+  const ClockSysvar &clock() const { return clock_; }
+  const RentSysvar &rent() const { return rent_; }
+  const EpochScheduleSysvar &epoch_schedule() const { return epoch_schedule_; }
+  const EpochRewardsSysvar &epoch_rewards() const { return epoch_rewards_; }
+  Slot last_restart_slot() const { return last_restart_slot_; }
+
+  /// Stake of a vote account; unlisted accounts report `unlisted_stake`
+  const EpochStake &epoch_stake(const uint8_t *vote_pubkey) const;
+
+  /// Serialized data of a sysvar; empty if the snapshot does not hold it
+  const std::vector<uint8_t> &data(BuiltinAccount sysvar) const;
+
+  /// The sysvar as an account, or nullptr if the snapshot does not hold it
+  std::shared_ptr<const AccountInfo> account(BuiltinAccount sysvar) const;
+
+private:
+  ClockSysvar clock_;
+  RentSysvar rent_;
+  EpochScheduleSysvar epoch_schedule_;
+  EpochRewardsSysvar epoch_rewards_;
+  Slot last_restart_slot_;
+  std::unordered_map<PublicKey, EpochStake> epoch_stakes_;
+  EpochStake unlisted_stake_;
+  std::array<std::shared_ptr<const AccountInfo>, 5> accounts_;
+};
+
+/**
+ * Where syscalls find the sysvars of the slot being executed
+ *
+ * A Scope pins a snapshot for the current thread while it executes a
+ * bank's transactions, so forks replayed side by side each see their own
+ * slot. Outside a scope, syscalls see the snapshot last installed.
+ */
+class SysvarCache {
+public:
+  /// The scoped snapshot of this thread, else the installed one
+  static std::shared_ptr<const SysvarSnapshot> current();
+
+  /// Make `snapshot` what unscoped threads see; nullptr restores defaults()
+  static void install(std::shared_ptr<const SysvarSnapshot> snapshot);
+
+  /**
+   * Pins a snapshot for this thread until destroyed. The snapshot pointer
+   * is borrowed, not copied: it must outlive the scope.
+   */
+  class Scope {
+  public:
+    explicit Scope(const std::shared_ptr<const SysvarSnapshot> &snapshot);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    const std::shared_ptr<const SysvarSnapshot> *previous_;
+  };
+};
+
+} // namespace svm
+} // namespace slonana
@@ -9,6 +9,10 @@
 #include <memory>
 
 namespace slonana {
+namespace consensus {
+class LeaderScheduleCache;
+}
+
 namespace validator {
 
 using namespace slonana::common;
@@ -484,6 +488,23 @@ public:
    */
   std::string get_slot_leader(Slot slot) const;
 
+  /**
+   * @brief Attach the stake-weighted leader schedule
+   *
+   * get_slot_leader() then answers from it, and every processed block
+   * advances it so the next epoch's schedule is drawn before the boundary.
+   *
+   * @param leader_schedule Shared with RPC, forwarding and Turbine
+   */
+  void set_leader_schedule(
+      std::shared_ptr<consensus::LeaderScheduleCache> leader_schedule);
+
+  /**
+   * @brief Get the attached leader schedule
+   * @return Leader schedule cache or nullptr if none is attached
+   */
+  std::shared_ptr<consensus::LeaderScheduleCache> get_leader_schedule() const;
+
   // === Component Access ===
   
   /**
@@ -515,7 +536,11 @@ public:
    * @param port Port number for QUIC server (default: 8000)
    * @return true if QUIC networking was successfully enabled
    * @note QUIC provides multiplexed, low-latency communication
+   * @note With a leader schedule set, stream quotas follow its epoch stakes
+   *       and are refreshed as processed blocks cross each epoch boundary
    * @note Safe to call multiple times with same port
+   * @note Off by default (ValidatorConfig::enable_quic_tpu): the handshake
+   *       is the transport's own X25519/Ed25519 exchange, not TLS 1.3
    */
   bool enable_quic_networking(uint16_t port = 8000);
   
@@ -577,6 +602,10 @@ private:
   std::unique_ptr<network::QuicClient> quic_client_;  ///< QUIC client for outgoing connections
   bool quic_enabled_;                                 ///< Track QUIC networking state
 
+  /// Push the epoch stakes of slot's epoch to the QUIC server's stream
+  /// quotas, once per epoch
+  void refresh_quic_stakes(Slot slot);
+
   // === Implementation Details ===
   class Impl;
   std::unique_ptr<Impl> impl_;  ///< Pimpl pattern for implementation details
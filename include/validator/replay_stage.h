@@ -0,0 +1,244 @@
+#pragma once
+
+#include "common/types.h"
+#include "ledger/manager.h"
+#include "svm/engine.h"
+#include "svm/sysvar_cache.h"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace slonana {
+namespace validator {
+
+using namespace slonana::common;
+
+/**
+ * One PoH entry of a slot: `num_hashes` SHA-256 steps since the previous
+ * entry, the last of which mixes in a hash of the entry's transaction
+ * signatures. An entry with no transactions is a tick.
+ */
+struct ReplayEntry {
+  uint64_t num_hashes = 1;
+  Hash hash;
+  std::vector<ledger::Transaction> transactions;
+
+  /// Hash mixed into the last step: SHA-256 of every signature in order
+  static Hash mixin(const std::vector<ledger::Transaction> &transactions);
+
+  /// The hash an entry with these transactions must have after `start`
+  static Hash next_hash(const Hash &start, uint64_t num_hashes,
+                        const std::vector<ledger::Transaction> &transactions);
+};
+
+/**
+ * The entries of one slot, chained from the last entry hash of the parent
+ * slot (or the genesis hash)
+ */
+struct ReplaySlot {
+  Slot slot = 0;
+  Slot parent_slot = 0;
+  Hash start_hash;
+  std::vector<ReplayEntry> entries;
+
+  /// The slot's blockhash: its last entry hash
+  const Hash &last_hash() const;
+
+  /**
+   * Record `transactions` as a slot the way a leader does: entries of at
+   * most `max_entry_transactions`, each `hashes_per_entry` hashes long,
+   * followed by one tick
+   */
+  static ReplaySlot record(Slot slot, Slot parent_slot, const Hash &start_hash,
+                           std::vector<ledger::Transaction> transactions,
+                           size_t max_entry_transactions = 64,
+                           uint64_t hashes_per_entry = 8);
+
+  /// Record the transactions of a stored block, chained from `start_hash`
+  static ReplaySlot from_block(const ledger::Block &block, Slot parent_slot,
+                               const Hash &start_hash);
+};
+
+/**
+ * A transaction as the replay stage sees it: its legacy message decoded
+ * into account keys, their writability and instructions
+ */
+struct ReplayTransaction {
+  const ledger::Transaction *transaction = nullptr;
+  std::vector<PublicKey> account_keys;
+  std::vector<bool> writable;
+  size_t required_signatures = 0;
+  std::vector<svm::Instruction> instructions;
+
+  /// Index of `key` in account_keys, or account_keys.size()
+  size_t index_of(const PublicKey &key) const;
+
+  /// Decode a legacy (or v0 without lookups) message; nullopt if malformed
+  static std::optional<ReplayTransaction>
+  parse(const ledger::Transaction &transaction);
+};
+
+/**
+ * Account state of one fork at one slot
+ *
+ * A bank holds the accounts its slot wrote and reads everything else
+ * through its parent, so sibling forks share their common ancestors.
+ * Its sysvars are snapshotted when it is created, from its slot and the
+ * parent's snapshot. Replay writes a bank from one thread at a time; once
+ * frozen it is immutable and may be read from any thread.
+ */
+class ReplayBank {
+public:
+  ReplayBank(Slot slot, std::shared_ptr<const ReplayBank> parent);
+
+  /**
+   * A root bank holding the genesis balances, frozen with `genesis_hash`.
+   * Without `sysvars` it starts from SysvarSnapshot::genesis(0).
+   */
+  static std::shared_ptr<ReplayBank>
+  genesis(const std::vector<std::pair<PublicKey, uint64_t>> &accounts,
+          const Hash &genesis_hash,
+          std::shared_ptr<const svm::SysvarSnapshot> sysvars = nullptr);
+
+  Slot slot() const { return slot_; }
+  const std::shared_ptr<const ReplayBank> &parent() const { return parent_; }
+  const std::shared_ptr<const svm::SysvarSnapshot> &sysvars() const {
+    return sysvars_;
+  }
+
+  /**
+   * The account as of this bank, or nullopt if it was never written.
+   * Builtin programs and sysvars are answered from the builtin table and
+   * the sysvar snapshot without walking the ancestors.
+   */
+  std::optional<svm::ProgramAccount> get_account(const PublicKey &key) const;
+  uint64_t get_balance(const PublicKey &key) const;
+  void store_account(const svm::ProgramAccount &account);
+
+  /**
+   * Fix the bank hash: SHA-256 of the parent bank hash, the blockhash,
+   * the signature count and every account written, in key order
+   */
+  void freeze(const Hash &blockhash);
+  bool is_frozen() const { return frozen_; }
+  const Hash &hash() const { return hash_; }
+  const Hash &blockhash() const { return blockhash_; }
+
+  uint64_t transaction_count = 0;
+  uint64_t signature_count = 0;
+  uint64_t collected_fees = 0;
+
+private:
+  Slot slot_;
+  std::shared_ptr<const ReplayBank> parent_;
+  std::shared_ptr<const svm::SysvarSnapshot> sysvars_;
+  std::unordered_map<PublicKey, svm::ProgramAccount> accounts_;
+  bool frozen_ = false;
+  Hash hash_;
+  Hash blockhash_;
+};
+
+/**
+ * Replay stage - executes the slots of the ledger on top of their parent
+ * banks
+ *
+ * Each slot is replayed entry by entry. PoH hashes and signatures are
+ * checked on the worker pool while the entries execute, and a slot that
+ * fails them is marked dead rather than frozen. Within an entry,
+ * transactions run across the workers under account locks: a transaction
+ * waits for every earlier transaction of the entry that writes an account
+ * it uses, or reads one it writes, so each account sees exactly the
+ * sequential order and the bank ends up the same for any worker count.
+ * Builtin programs and sysvars are read-only and take no locks; syscalls
+ * made while a transaction runs see the sysvars of its bank. Slots on
+ * different forks are replayed concurrently.
+ */
+class ReplayStage {
+public:
+  /**
+   * Runs a transaction's instructions against copies of its accounts,
+   * indexed like account_keys. Writable accounts are committed only on
+   * SUCCESS; the fee is charged either way.
+   */
+  using TransactionProcessor = std::function<svm::ExecutionResult(
+      const ReplayTransaction &, std::vector<svm::ProgramAccount> &)>;
+
+  struct Config {
+    size_t worker_threads = 4;
+    size_t max_concurrent_forks = 4;
+    bool verify_signatures = true;
+    bool verify_poh = true;
+    uint64_t lamports_per_signature = 5000;
+    /// Entries each PoH verification task covers
+    size_t poh_entries_per_task = 16;
+  };
+
+  struct TransactionStatus {
+    Signature signature;
+    svm::ExecutionResult result = svm::ExecutionResult::SUCCESS;
+    uint64_t fee = 0;
+  };
+
+  struct SlotResult {
+    Slot slot = 0;
+    bool dead = false;
+    std::string error;
+    std::shared_ptr<const ReplayBank> bank; ///< Frozen bank unless dead
+    std::vector<TransactionStatus> statuses; ///< In ledger order
+  };
+
+  struct Statistics {
+    std::atomic<uint64_t> slots_replayed{0};
+    std::atomic<uint64_t> dead_slots{0};
+    std::atomic<uint64_t> entries_replayed{0};
+    std::atomic<uint64_t> transactions_executed{0};
+    std::atomic<uint64_t> signatures_verified{0};
+    std::atomic<uint64_t> lock_waits{0}; ///< Transactions held back by a lock
+  };
+
+  explicit ReplayStage(std::shared_ptr<const ReplayBank> root);
+  ReplayStage(std::shared_ptr<const ReplayBank> root, const Config &config);
+  ~ReplayStage();
+
+  ReplayStage(const ReplayStage &) = delete;
+  ReplayStage &operator=(const ReplayStage &) = delete;
+
+  /**
+   * Replay one slot on top of its parent bank, which must be frozen
+   */
+  SlotResult replay_slot(const ReplaySlot &slot);
+
+  /**
+   * Replay slots in any order, running up to max_concurrent_forks of them
+   * at once. A slot waits for its parent in the same call; one whose
+   * parent is unknown or dead is reported dead. Results follow `slots`.
+   */
+  std::vector<SlotResult> replay_slots(const std::vector<ReplaySlot> &slots);
+
+  /// Frozen bank for `slot`, or nullptr
+  std::shared_ptr<const ReplayBank> bank(Slot slot) const;
+
+  /// Forget banks that are neither `root` nor descend from it
+  void set_root(Slot root);
+
+  /// Replace the default processor (System Program transfers)
+  void set_processor(TransactionProcessor processor);
+
+  /// System Program transfers; ComputeBudget instructions are skipped
+  static svm::ExecutionResult
+  process_system_transfers(const ReplayTransaction &transaction,
+                           std::vector<svm::ProgramAccount> &accounts);
+
+  const Statistics &get_statistics() const { return stats_; }
+
+private:
+  class Impl;
+  Statistics stats_;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace validator
+} // namespace slonana
@@ -4,12 +4,18 @@
 #include "ledger/manager.h"
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace slonana {
+namespace storage {
+class AccountsDB;
+class AccountsHasher;
+}
+
 namespace validator {
 
 /**
@@ -19,6 +25,10 @@ namespace validator {
  * and recovery. Enables incremental snapshots and full state restoration.
  */
 
+enum class SnapshotCodec : uint8_t; // validator/snapshot_archive.h
+class SnapshotRestorePipeline;     // validator/snapshot_restore_pipeline.h
+class SnapshotFrameStream;
+
 struct SnapshotMetadata {
   uint64_t slot;
   std::string block_hash;
@@ -30,6 +40,7 @@ struct SnapshotMetadata {
   std::string version;
   bool is_incremental;
   uint64_t base_slot; // For incremental snapshots
+  std::string accounts_hash; // Merkle root of the entries (hex); may be empty
 };
 
 struct AccountSnapshot {
@@ -54,6 +65,8 @@ struct SnapshotChunk {
  *
  * Handles creation, storage, and restoration of validator state snapshots.
  * Supports both full and incremental snapshots for efficient synchronization.
+ * Snapshots are chunked archives (see SnapshotArchiveWriter) compressed and
+ * restored in parallel; files in the older single-stream layout still load.
  */
 class SnapshotManager {
 public:
@@ -68,6 +81,35 @@ public:
   // Snapshot restoration
   bool restore_from_snapshot(const std::string &snapshot_path,
                              const std::string &ledger_path);
+
+  /**
+   * Restore from archive bytes arriving in file order, e.g. a download in
+   * progress: each frame enters the restore pipeline as soon as its last
+   * byte is fed, and accounts land as with restore_from_snapshot. Must not
+   * outlive the manager.
+   */
+  class StreamingRestore {
+  public:
+    explicit StreamingRestore(SnapshotManager &manager);
+    ~StreamingRestore();
+
+    /// @return false once the bytes are not an archive or the restore failed
+    bool feed(const uint8_t *data, size_t size);
+    /// Drain the pipeline; true only if the whole archive was restored
+    bool finish();
+    void abort();
+
+  private:
+    SnapshotManager &manager_;
+    SnapshotMetadata metadata_;
+    std::unique_ptr<SnapshotFrameStream> stream_;
+    std::unique_ptr<SnapshotRestorePipeline> pipeline_;
+    std::atomic<size_t> restored_accounts_{0};
+    std::atomic<size_t> failed_restorations_{0};
+    uint64_t bytes_ = 0;
+    bool failed_ = false;
+  };
+  std::unique_ptr<StreamingRestore> begin_streaming_restore();
   std::vector<AccountSnapshot>
   load_accounts_from_snapshot(const std::string &snapshot_path);
 
@@ -77,15 +119,36 @@ public:
   bool delete_old_snapshots(uint64_t keep_count = 5);
 
   // Snapshot verification
+  /// Checks chunk hashes and, when recorded, the accounts hash
   bool verify_snapshot_integrity(const std::string &snapshot_path);
   std::string calculate_snapshot_hash(const std::string &snapshot_path);
+  /// Merkle root (hex) of the accounts stored in a snapshot
+  std::string calculate_accounts_hash(const std::string &snapshot_path);
+  /**
+   * Merkle accounts hash (hex) of the attached AccountsDB at `slot`, for
+   * bank-hash checks. Updated from the slots' dirty accounts since the
+   * previous call; bins are cached on disk whenever a full snapshot is
+   * taken. Empty without an AccountsDB.
+   */
+  std::string get_accounts_hash(uint64_t slot);
 
   // Configuration
   void set_compression_enabled(bool enabled) { compression_enabled_ = enabled; }
+  /// Codec used while compression is enabled (default ZSTD)
+  void set_compression_codec(SnapshotCodec codec) { compression_codec_ = codec; }
   void set_max_chunk_size(size_t size) { max_chunk_size_ = size; }
+  /// Worker threads for archive compression and restore (0 = all cores)
+  void set_snapshot_threads(size_t threads) { snapshot_threads_ = threads; }
   void set_auto_snapshot_interval(uint64_t slots) {
     auto_snapshot_interval_ = slots;
   }
+  /**
+   * Restored accounts are also stored here, at the snapshot's slot. While
+   * set, snapshots are taken from its state: full snapshots from every live
+   * account, incremental ones from its dirty-account tracking, which is
+   * turned on here (and off on the store this replaces).
+   */
+  void set_accounts_db(std::shared_ptr<storage::AccountsDB> accounts_db);
 
   // Statistics
   struct SnapshotStats {
@@ -104,8 +167,12 @@ public:
 private:
   std::string snapshot_dir_;
   bool compression_enabled_;
+  SnapshotCodec compression_codec_;
   size_t max_chunk_size_;
+  size_t snapshot_threads_;
   uint64_t auto_snapshot_interval_;
+  std::shared_ptr<storage::AccountsDB> accounts_db_;
+  std::unique_ptr<storage::AccountsHasher> accounts_hasher_;
   mutable SnapshotStats stats_;
 
   // Helper methods
@@ -117,6 +184,40 @@ private:
   bool decompress_data(const std::vector<uint8_t> &input,
                        std::vector<uint8_t> &output) const;
   std::string calculate_hash(const std::vector<uint8_t> &data) const;
+  std::string
+  hash_snapshot_accounts(const std::vector<AccountSnapshot> &accounts,
+                         bool is_incremental) const;
+  std::string accounts_hash_cache_path() const {
+    return snapshot_dir_ + "/accounts_hash.cache";
+  }
+
+  // Restore helpers shared by file and streaming restores
+  /// Validate and restore one batch to the ledger and the AccountsDB
+  bool restore_batch(const SnapshotMetadata &metadata,
+                     const std::vector<AccountSnapshot> &batch,
+                     std::atomic<size_t> &restored_accounts,
+                     std::atomic<size_t> &failed_restorations);
+
+  // Archive I/O
+  /// Receives accounts for the archive; false aborts the write
+  using AccountSink = std::function<bool(AccountSnapshot)>;
+  /**
+   * Write an archive of the accounts `produce` passes to its sink, which
+   * must come in pubkey order. `produce` may fill in the metadata's counts
+   * as it goes; the header is rewritten with them once it returns.
+   */
+  bool write_snapshot_archive(
+      const std::string &snapshot_path, SnapshotMetadata &metadata,
+      const std::function<bool(const AccountSink &)> &produce,
+      uint64_t &uncompressed_size) const;
+  /// Sorts `accounts` by pubkey and writes them, moving them out
+  bool write_snapshot_archive(const std::string &snapshot_path,
+                              SnapshotMetadata &metadata,
+                              std::vector<AccountSnapshot> &accounts,
+                              uint64_t &uncompressed_size) const;
+  bool read_legacy_snapshot(const std::string &snapshot_path,
+                            SnapshotMetadata &metadata,
+                            std::vector<AccountSnapshot> &accounts) const;
 
   // Serialization helpers
   std::vector<uint8_t>
@@ -194,6 +295,13 @@ public:
   void set_max_snapshots_to_keep(uint64_t count) {
     max_snapshots_to_keep_ = count;
   }
+  /**
+   * Read the current (rooted) slot from here instead of simulating slot
+   * progression. Set before start().
+   */
+  void set_slot_source(std::function<uint64_t()> source) {
+    slot_source_ = std::move(source);
+  }
 
   // Status
   uint64_t get_last_snapshot_slot() const { return last_snapshot_slot_; }
@@ -214,7 +322,9 @@ private:
   uint64_t max_snapshots_to_keep_;
 
   std::atomic<uint64_t> last_snapshot_slot_;
+  std::atomic<uint64_t> last_full_snapshot_slot_; ///< Base for incrementals
   std::atomic<uint64_t> next_snapshot_slot_;
+  std::function<uint64_t()> slot_source_;
   std::chrono::system_clock::time_point last_snapshot_time_;
 
   // Service loop
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "validator/snapshot.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace slonana {
+namespace validator {
+
+/**
+ * Chunked snapshot archive format
+ *
+ * An archive is a caller-defined header (SnapshotManager stores its
+ * serialized SnapshotMetadata there) followed by independent chunks of
+ * accounts and a trailing index:
+ *
+ *   [u32 header size][header][u64 ARCHIVE_MAGIC]
+ *   [frame 0][frame 1]...[frame n-1]
+ *   [index: n x (u64 frame offset, frame header)]
+ *   [u64 index offset][u32 chunk count][u32 FORMAT_VERSION][u64 INDEX_MAGIC]
+ *
+ * Every frame starts with a fixed ChunkFrameHeader (codec, sizes, pubkey
+ * range and SHA-256 of the compressed payload), so a chunk can be verified
+ * and decoded on its own: by a reader seeking through the index, or by a
+ * streaming consumer reading frames as they arrive. Chunks are compressed
+ * on a worker pool and written in order; readers decode chunks in parallel.
+ * All integers are little-endian.
+ */
+
+enum class SnapshotCodec : uint8_t {
+  NONE = 0,
+  ZSTD = 1, ///< Best ratio; the default for written snapshots
+  LZ4 = 2,  ///< Fastest to decode; for snapshots restored often
+};
+
+/// Whether this build links the codec (SLONANA_HAVE_ZSTD / SLONANA_HAVE_LZ4)
+bool snapshot_codec_available(SnapshotCodec codec);
+const char *snapshot_codec_name(SnapshotCodec codec);
+
+namespace snapshot_archive {
+
+constexpr uint64_t ARCHIVE_MAGIC = 0x31484352414e4c53ULL; // "SLNARCH1"
+constexpr uint64_t INDEX_MAGIC = 0x58444e49414e4c53ULL;   // "SLNAINDX"
+constexpr uint32_t FRAME_MAGIC = 0x4b4e4843;              // "CHNK"
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t FRAME_HEADER_SIZE = 120;
+constexpr size_t INDEX_ENTRY_SIZE = 8 + FRAME_HEADER_SIZE;
+constexpr size_t FOOTER_SIZE = 24;
+
+} // namespace snapshot_archive
+
+/**
+ * Fixed header in front of every chunk payload
+ */
+struct ChunkFrameHeader {
+  uint32_t chunk_index = 0;
+  SnapshotCodec codec = SnapshotCodec::NONE;
+  uint32_t account_count = 0;
+  uint32_t uncompressed_size = 0;
+  uint32_t compressed_size = 0;
+  std::array<uint8_t, 32> first_pubkey{}; ///< Smallest pubkey in the chunk
+  std::array<uint8_t, 32> last_pubkey{};  ///< Largest pubkey in the chunk
+  std::array<uint8_t, 32> hash{};         ///< SHA-256 of the payload
+
+  void encode(uint8_t *out) const;
+  /// @return false if the bytes are not a frame header
+  bool decode(const uint8_t *in);
+};
+
+/**
+ * Index entry: a frame header and where its frame starts in the archive
+ */
+struct ChunkIndexEntry {
+  uint64_t offset = 0;
+  ChunkFrameHeader header;
+
+  uint64_t frame_size() const {
+    return snapshot_archive::FRAME_HEADER_SIZE + header.compressed_size;
+  }
+};
+
+/**
+ * Chunk payload helpers, shared by the archive reader and writer and by
+ * callers that move frames themselves (downloaders, restore pipelines)
+ */
+namespace snapshot_archive {
+
+void serialize_accounts(const std::vector<AccountSnapshot> &accounts,
+                        std::vector<uint8_t> &out);
+/// @return false if the payload is truncated or malformed
+bool deserialize_accounts(const uint8_t *data, size_t size,
+                          size_t expected_count,
+                          std::vector<AccountSnapshot> &out);
+
+bool compress(SnapshotCodec codec, int level, const uint8_t *data,
+              size_t size, std::vector<uint8_t> &out);
+bool decompress(SnapshotCodec codec, const uint8_t *data, size_t size,
+                size_t uncompressed_size, std::vector<uint8_t> &out);
+
+std::array<uint8_t, 32> sha256(const uint8_t *data, size_t size);
+
+/**
+ * Verify and decode one frame payload (the bytes after its header)
+ * @return false on a hash mismatch or corrupt payload
+ */
+bool decode_chunk(const ChunkFrameHeader &header, const uint8_t *payload,
+                  std::vector<uint8_t> &scratch,
+                  std::vector<AccountSnapshot> &accounts);
+
+} // namespace snapshot_archive
+
+/**
+ * Streaming, parallel archive writer
+ *
+ * add() buffers accounts into the current chunk; full chunks are
+ * serialized, compressed and hashed on the worker pool and appended to the
+ * file in chunk order. At most max_in_flight_chunks chunks are held in
+ * memory at once: add() blocks while the pool catches up. Chunk pubkey
+ * ranges are disjoint when accounts are added in pubkey order.
+ */
+class SnapshotArchiveWriter {
+public:
+  struct Options {
+    SnapshotCodec codec = SnapshotCodec::ZSTD;
+    int compression_level = 3;
+    size_t chunk_size = 4 * 1024 * 1024; ///< Uncompressed bytes per chunk
+    size_t threads = 0;                  ///< 0 = hardware concurrency
+    size_t max_in_flight_chunks = 0;     ///< 0 = 2 per thread
+  };
+
+  SnapshotArchiveWriter();
+  explicit SnapshotArchiveWriter(const Options &options);
+  ~SnapshotArchiveWriter();
+
+  SnapshotArchiveWriter(const SnapshotArchiveWriter &) = delete;
+  SnapshotArchiveWriter &operator=(const SnapshotArchiveWriter &) = delete;
+
+  /// Create the file and write the header; an unavailable codec falls back
+  /// to NONE
+  bool open(const std::string &path, const std::vector<uint8_t> &header);
+  bool add(AccountSnapshot account);
+  /**
+   * Flush the last chunk, wait for the pool and write the index.
+   * @param header Optional replacement header, same size as the original
+   * (e.g. metadata with the final account count)
+   */
+  bool finish(const std::vector<uint8_t> *header = nullptr);
+  /// Stop the pool and delete the partial file
+  void abort();
+
+  SnapshotCodec codec() const { return options_.codec; }
+  uint64_t account_count() const { return account_count_; }
+  uint64_t bytes_written() const { return bytes_written_; }
+  uint64_t uncompressed_bytes() const { return uncompressed_bytes_; }
+  const std::vector<ChunkIndexEntry> &index() const { return index_; }
+
+private:
+  struct Job {
+    uint32_t chunk_index;
+    std::vector<AccountSnapshot> accounts;
+  };
+
+  void worker_loop();
+  void submit_current();
+  void write_ready_frames(); // Called with state_mutex_ held
+  void stop_workers();
+
+  Options options_;
+  std::string path_;
+  std::FILE *file_ = nullptr;
+  uint64_t header_size_ = 0;
+
+  std::vector<AccountSnapshot> current_;
+  size_t current_bytes_ = 0;
+  uint32_t next_chunk_ = 0;
+
+  std::vector<std::thread> workers_;
+  std::mutex state_mutex_;
+  std::condition_variable jobs_cv_;  ///< Workers wait for jobs
+  std::condition_variable space_cv_; ///< add() waits for in-flight space
+  std::deque<Job> jobs_;
+  std::map<uint32_t, std::pair<ChunkFrameHeader, std::vector<uint8_t>>>
+      ready_;
+  uint32_t next_write_ = 0;
+  size_t in_flight_ = 0;
+  bool stopping_ = false;
+  bool failed_ = false;
+
+  std::vector<ChunkIndexEntry> index_;
+  uint64_t offset_ = 0;
+  uint64_t account_count_ = 0;
+  uint64_t bytes_written_ = 0;
+  uint64_t uncompressed_bytes_ = 0;
+};
+
+/**
+ * Archive reader: loads the index and decodes chunks in parallel
+ *
+ * Each worker holds one chunk at a time, so memory stays bounded by the
+ * thread count no matter how large the archive is.
+ */
+class SnapshotArchiveReader {
+public:
+  /// Called concurrently from worker threads, once per chunk
+  using ChunkVisitor = std::function<bool(const ChunkIndexEntry &,
+                                          std::vector<AccountSnapshot> &)>;
+
+  SnapshotArchiveReader() = default;
+  ~SnapshotArchiveReader();
+
+  SnapshotArchiveReader(const SnapshotArchiveReader &) = delete;
+  SnapshotArchiveReader &operator=(const SnapshotArchiveReader &) = delete;
+
+  /// @return false if the file is missing or not a chunked archive
+  bool open(const std::string &path);
+  void close();
+
+  const std::vector<uint8_t> &header() const { return header_; }
+  const std::vector<ChunkIndexEntry> &chunks() const { return index_; }
+  uint64_t account_count() const;
+  /// Chunk pubkey ranges are ascending and disjoint
+  bool is_partitioned() const { return partitioned_; }
+
+  bool read_chunk(size_t chunk, std::vector<AccountSnapshot> &accounts) const;
+  /// Frame bytes (header and payload) exactly as stored
+  bool read_frame(size_t chunk, std::vector<uint8_t> &frame) const;
+
+  /**
+   * Decode every chunk on `threads` workers (0 = hardware concurrency).
+   * Stops early and returns false if a chunk is corrupt or the visitor
+   * returns false.
+   */
+  bool for_each_chunk(const ChunkVisitor &visitor, size_t threads = 0) const;
+  /// Check every chunk hash in parallel without decoding
+  bool verify(size_t threads = 0) const;
+
+  std::optional<AccountSnapshot> find_account(const common::PublicKey &pubkey) const;
+
+private:
+  bool read_at(uint64_t offset, uint8_t *out, size_t size) const;
+  bool run_parallel(size_t threads,
+                    const std::function<bool(size_t)> &task) const;
+
+  int fd_ = -1;
+  std::vector<uint8_t> header_;
+  std::vector<ChunkIndexEntry> index_;
+  bool partitioned_ = false;
+};
+
+} // namespace validator
+} // namespace slonana
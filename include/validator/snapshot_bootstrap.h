@@ -9,6 +9,9 @@
 
 // Forward declaration
 namespace slonana {
+namespace storage {
+class AccountsDB;
+}
 namespace validator {
 class SnapshotFinder;
 }
@@ -80,6 +83,16 @@ public:
     progress_callback_ = std::move(callback);
   }
 
+  /**
+   * Restore snapshot accounts into this store. While set, a ranged download
+   * is restored as it arrives; if the stream cannot be used (another
+   * download path, or not an archive) apply_snapshot restores from the
+   * file afterwards.
+   */
+  void set_accounts_db(std::shared_ptr<storage::AccountsDB> accounts_db) {
+    accounts_db_ = std::move(accounts_db);
+  }
+
   // Status and configuration
   bool needs_bootstrap() const;
   uint64_t get_local_ledger_slot() const;
@@ -97,6 +110,8 @@ private:
       snapshot_finder_; // Advanced multi-threaded finder
   std::string snapshot_dir_;
   BootstrapProgressCallback progress_callback_;
+  std::shared_ptr<storage::AccountsDB> accounts_db_;
+  std::string streamed_snapshot_path_; ///< Already restored while downloading
 
   // Helper methods
   std::string build_snapshot_url(const SnapshotInfo &info) const;
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "common/types.h"
+#include "validator/snapshot_finder.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace slonana {
+namespace validator {
+
+/**
+ * Parallel, resumable snapshot downloader
+ *
+ * The file is split into fixed-size pieces and fetched with HTTP Range
+ * requests over several connections, optionally spread across mirrors of
+ * the same snapshot. Data is written in place into a preallocated file and
+ * a bitmap of finished pieces is kept next to it in `<path>.progress`, so an
+ * interrupted download resumes with only the missing pieces. Each source's
+ * request size (in pieces) follows its measured throughput, fast mirrors
+ * taking larger ranges and slow ones smaller. A SHA-256 of the file is
+ * computed as the finished prefix grows, so the hash is ready as soon as
+ * the last piece lands.
+ *
+ * Before any ranges are split across mirrors, the same randomly placed
+ * sample range is hashed from every source and mirrors whose bytes differ
+ * from the primary's are dropped, so one bad mirror cannot splice foreign
+ * pieces into the file. The full-file check needs expected_sha256.
+ *
+ * Sources that do not answer range requests fall back to a single-stream
+ * download of the first URL.
+ */
+class ParallelSnapshotDownloader {
+public:
+  struct Options {
+    size_t connections = 8;             ///< Concurrent range requests
+    size_t piece_size = 1024 * 1024;    ///< Resume bitmap granularity
+    size_t initial_request_pieces = 4;  ///< Request size before measuring
+    size_t max_request_pieces = 64;
+    double target_request_seconds = 1.0; ///< Request size aims for this
+    long connect_timeout_seconds = 10;
+    long stall_timeout_seconds = 30;    ///< Abort requests below 1 KiB/s
+    size_t max_source_failures = 3;     ///< Consecutive, before dropping
+    std::string expected_sha256;        ///< Hex; empty = do not check
+    size_t cross_check_bytes = 64 * 1024; ///< Mirror sample; 0 = trust mirrors
+    std::string user_agent = "slonana-snapshot-downloader/1.0";
+  };
+
+  struct SourceStats {
+    std::string url;
+    uint64_t bytes = 0;
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    double throughput_bps = 0.0; ///< Smoothed over completed requests
+    size_t request_pieces = 0;   ///< Current request size
+    bool active = true;          ///< False once dropped for failures
+  };
+
+  /// Called from worker threads with the state lock held; keep it cheap
+  using ProgressCallback =
+      std::function<void(uint64_t downloaded, uint64_t total)>;
+
+  /// File bytes in order, as the downloaded prefix grows
+  using DataConsumer = std::function<bool(const uint8_t *data, size_t size)>;
+
+  ParallelSnapshotDownloader();
+  explicit ParallelSnapshotDownloader(const Options &options);
+  ~ParallelSnapshotDownloader();
+
+  ParallelSnapshotDownloader(const ParallelSnapshotDownloader &) = delete;
+  ParallelSnapshotDownloader &
+  operator=(const ParallelSnapshotDownloader &) = delete;
+
+  /**
+   * Download `path` from `urls` (mirrors of the same file, best first).
+   * On failure the partial file and its progress bitmap are kept for the
+   * next attempt; a hash mismatch discards both.
+   */
+  common::Result<bool> download(const std::vector<std::string> &urls,
+                                const std::string &path,
+                                ProgressCallback progress = nullptr);
+  /**
+   * Hand the file to `consumer` while it downloads, e.g. a
+   * SnapshotFrameStream feeding a SnapshotRestorePipeline. Called from the
+   * hashing thread; returning false fails the download.
+   */
+  void set_data_consumer(DataConsumer consumer) {
+    data_consumer_ = std::move(consumer);
+  }
+  /// Stop in-flight requests; download() returns an error
+  void cancel() { cancelled_.store(true); }
+
+  /// URLs of the top-ranked sources serving the same file as the best one
+  static std::vector<std::string>
+  select_sources(const std::vector<SnapshotQuality> &ranked,
+                 size_t max_sources);
+  static std::string progress_path(const std::string &path) {
+    return path + ".progress";
+  }
+
+  uint64_t total_size() const { return total_size_; }
+  /// Bytes fetched by the last download() call
+  uint64_t bytes_downloaded() const { return bytes_downloaded_; }
+  /// Bytes already present from an earlier, interrupted attempt
+  uint64_t bytes_resumed() const { return bytes_resumed_; }
+  const std::string &sha256_hex() const { return sha256_hex_; }
+  std::vector<SourceStats> source_stats() const;
+
+private:
+  struct Source;
+  struct Transfer;
+
+  bool probe_source(Source &source);
+  /// Hex SHA-256 of one range of a source, empty if it could not be fetched
+  std::string sample_digest(const Source &source, uint64_t offset,
+                            uint64_t length);
+  bool fetch_range(void *curl, Transfer &transfer, Source &source,
+                   uint64_t offset, uint64_t length);
+  void worker_loop(Transfer &transfer, size_t worker_index);
+  void hasher_loop(Transfer &transfer);
+  common::Result<bool> download_single_stream(const std::string &url,
+                                              const std::string &path,
+                                              ProgressCallback progress);
+
+  Options options_;
+  DataConsumer data_consumer_;
+  std::atomic<bool> cancelled_{false};
+
+  mutable std::mutex stats_mutex_;
+  std::vector<SourceStats> stats_;
+  uint64_t total_size_ = 0;
+  uint64_t bytes_downloaded_ = 0;
+  uint64_t bytes_resumed_ = 0;
+  std::string sha256_hex_;
+};
+
+} // namespace validator
+} // namespace slonana
@@ -52,6 +52,11 @@ struct SnapshotFinderConfig {
   // Network selection
   std::string network = "mainnet-beta";
 
+  // Download parameters
+  size_t download_connections = 8;  // Parallel range requests
+  size_t max_download_sources = 3;  // Top-ranked mirrors of the same snapshot
+  std::string expected_sha256;      // Hex SHA-256 of the archive, if known
+
   // Output options
   bool json_output = false;
   bool with_private_rpc = false;
@@ -106,6 +111,15 @@ public:
   void set_discovery_progress_callback(std::function<void(int, int)> callback) {
     discovery_progress_callback_ = std::move(callback);
   }
+  /**
+   * Also hand the file's bytes, in order, to `consumer` while a ranged
+   * download runs (ParallelSnapshotDownloader::set_data_consumer). Other
+   * download paths never call it.
+   */
+  void set_download_consumer(
+      std::function<bool(const uint8_t *, size_t)> consumer) {
+    download_consumer_ = std::move(consumer);
+  }
 
   // Static utilities
   static std::vector<std::string>
@@ -134,6 +148,7 @@ private:
 
   // Progress tracking
   std::function<void(int, int)> discovery_progress_callback_;
+  std::function<bool(const uint8_t *, size_t)> download_consumer_;
 
   // Helper methods
   void worker_thread_function(const std::vector<std::string> &rpc_urls,
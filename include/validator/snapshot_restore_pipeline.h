@@ -0,0 +1,149 @@
+#pragma once
+
+#include "validator/snapshot_archive.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace slonana {
+namespace validator {
+
+/**
+ * Staged snapshot restore
+ *
+ *   frames -> [verify + decompress] -> [deserialize] -> [insert] -> sink
+ *
+ * Frames come from an archive on disk or from bytes still arriving over the
+ * network (SnapshotFrameStream). Each stage runs on its own threads and
+ * hands chunks to the next through a bounded queue; a full queue blocks
+ * the stage in front of it, back to the producer, so memory stays bounded
+ * by the queue depths however fast the source is. With the stages
+ * overlapped, a restore takes about as long as its slowest stage.
+ */
+class SnapshotRestorePipeline {
+public:
+  struct Options {
+    size_t decompress_threads = 0;  ///< 0 = half the hardware threads
+    size_t deserialize_threads = 0; ///< 0 = a quarter of them
+    size_t insert_threads = 1;      ///< Above 1 the sink must be thread-safe
+    size_t queue_depth = 0;         ///< Chunks per queue; 0 = 2 per consumer
+  };
+
+  /// Receives every chunk's accounts; returning false aborts the restore
+  using Sink = std::function<bool(const ChunkFrameHeader &,
+                                  std::vector<AccountSnapshot> &)>;
+
+  struct StageStatistics {
+    size_t threads = 0;
+    uint64_t chunks = 0;
+    double busy_seconds = 0.0; ///< Summed over the stage's threads
+    double idle_seconds = 0.0; ///< Waiting on an empty input queue
+    double blocked_seconds = 0.0; ///< Waiting on a full output queue
+  };
+
+  struct Statistics {
+    uint64_t chunks = 0;
+    uint64_t accounts = 0;
+    uint64_t compressed_bytes = 0;
+    uint64_t uncompressed_bytes = 0;
+    double elapsed_seconds = 0.0;
+    double source_blocked_seconds = 0.0; ///< Producer held back by the queue
+    StageStatistics decompress;
+    StageStatistics deserialize;
+    StageStatistics insert;
+  };
+
+  explicit SnapshotRestorePipeline(Sink sink);
+  SnapshotRestorePipeline(Sink sink, const Options &options);
+  ~SnapshotRestorePipeline();
+
+  SnapshotRestorePipeline(const SnapshotRestorePipeline &) = delete;
+  SnapshotRestorePipeline &operator=(const SnapshotRestorePipeline &) = delete;
+
+  void start();
+  /**
+   * Queue one frame payload (the bytes after its header). Blocks while the
+   * first stage is full.
+   * @return false once the pipeline has failed or was aborted
+   */
+  bool push_frame(const ChunkFrameHeader &header, std::vector<uint8_t> payload);
+  /// Close the input and drain every stage; true if all chunks reached the sink
+  bool finish();
+  void abort();
+
+  /// Run the whole pipeline over an archive, reading frames on this thread
+  bool restore_file(const SnapshotArchiveReader &reader);
+
+  bool failed() const { return failed_.load(); }
+  std::string error() const;
+  Statistics statistics() const;
+
+private:
+  struct Stages;
+
+  void fail(const std::string &error);
+  void decompress_loop();
+  void deserialize_loop();
+  void insert_loop();
+
+  Sink sink_;
+  Options options_;
+  std::unique_ptr<Stages> stages_;
+  std::atomic<bool> failed_{false};
+  mutable std::mutex error_mutex_;
+  std::string error_;
+};
+
+/**
+ * Incremental parser for an archive arriving in file order
+ *
+ * Bytes can be fed in pieces of any size; each frame is handed over as soon
+ * as its last byte arrives, and parsing stops at the trailing index.
+ */
+class SnapshotFrameStream {
+public:
+  /// Receives each frame's header and payload; false stops the stream
+  using FrameHandler =
+      std::function<bool(const ChunkFrameHeader &, std::vector<uint8_t>)>;
+
+  explicit SnapshotFrameStream(FrameHandler handler);
+
+  /// @return false on malformed input or when the handler refuses a frame
+  bool feed(const uint8_t *data, size_t size);
+
+  bool has_header() const { return header_done_; }
+  const std::vector<uint8_t> &header() const { return header_; }
+  /// Every frame has been handed over and the index reached
+  bool complete() const { return state_ == State::INDEX; }
+  uint32_t frames() const { return next_chunk_; }
+
+private:
+  enum class State {
+    HEADER_SIZE,
+    HEADER,
+    MAGIC,
+    FRAME_HEADER,
+    PAYLOAD,
+    INDEX,
+    FAILED,
+  };
+
+  /// Move bytes into buffer_ until it holds `want`; false if input ran out
+  bool fill(const uint8_t *&data, size_t &size, size_t want);
+
+  FrameHandler handler_;
+  State state_ = State::HEADER_SIZE;
+  std::vector<uint8_t> buffer_;
+  std::vector<uint8_t> header_;
+  uint32_t header_size_ = 0;
+  ChunkFrameHeader frame_;
+  uint32_t next_chunk_ = 0;
+  bool header_done_ = false;
+};
+
+} // namespace validator
+} // namespace slonana
@@ -437,6 +437,13 @@ BankingStage::BankingStage()
   // Initialize fee market and MEV protection
   fee_market_ = std::make_unique<FeeMarket>();
   mev_protection_ = std::make_unique<MEVProtection>();
+
+  // The pipeline consumes one batch stream, so the scheduler runs with a
+  // single worker and contributes ordering and compute limits
+  PrioritizationFeeScheduler::Config scheduler_config;
+  scheduler_config.worker_threads = 1;
+  scheduler_config.max_batch_size = 1000;
+  scheduler_ = std::make_unique<PrioritizationFeeScheduler>(scheduler_config);
   
   std::cout << "Banking Stage initialized with fault tolerance mechanisms"
             << std::endl;
@@ -646,50 +653,42 @@ void BankingStage::submit_transaction(TransactionPtr transaction) {
   std::cout << "Banking: [SUBMIT] Transaction #" << current_count << " submitted to banking stage (running=" << running_ << ")" << std::endl;
 
   try {
-    // **FEE-BASED PRIORITY CALCULATION** - Use fee market for intelligent ordering
-    int priority = 0;
-    if (fee_market_enabled_ && fee_market_) {
-      // Extract fee from transaction (simplified - would need proper fee extraction)
-      uint64_t tx_fee = 5000; // Default fee, in production would extract from tx
-      
-      // Calculate priority based on fee tier
-      FeeTier tier = fee_market_->classify_fee_tier(tx_fee);
-      switch (tier) {
-        case FeeTier::URGENT:
-          priority = 1000;
-          break;
-        case FeeTier::HIGH:
-          priority = 500;
-          break;
-        case FeeTier::NORMAL:
-          priority = 100;
-          break;
-        case FeeTier::LOW:
-          priority = 10;
-          break;
-      }
-      
-      // Record fee for statistics
-      fee_market_->record_transaction_fee(tx_fee, true);
-    }
-    
-    // **OPTIMIZED PRIORITY QUEUEING** - Minimal lock contention
+    // **PRIORITIZATION-FEE SCHEDULING** - Order by compute-unit price
     if (priority_processing_enabled_ || fee_market_enabled_) {
-      std::unique_lock<std::mutex> lock(priority_mutex_, std::try_to_lock);
-      if (lock) {
+      auto schedulable = SchedulableTransaction::from_transaction(transaction);
+
+      if (fee_market_enabled_ && fee_market_) {
+        // Base fee per signature plus the priority fee
+        uint64_t tx_fee =
+            fee_market_->get_current_base_fee() *
+                std::max<size_t>(1, transaction->signatures.size()) +
+            schedulable.priority_fee();
+        fee_market_->record_transaction_fee(tx_fee, true);
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(priority_mutex_);
         // Check for manual priority override
         auto it = transaction_priorities_.find(transaction);
         if (it != transaction_priorities_.end()) {
-          priority = std::max(priority, it->second);
-        }
-        priority_queue_.push({priority, transaction});
-        queue_cv_.notify_one();
-        
-        if (current_count < 5) {
-          std::cout << "Banking: Transaction queued in priority queue (priority=" << priority << ")" << std::endl;
+          schedulable.compute_unit_price =
+              std::max(schedulable.compute_unit_price,
+                       static_cast<uint64_t>(std::max(0, it->second)));
+          transaction_priorities_.erase(it);
         }
-        return; // Fast path success
       }
+
+      uint64_t price = schedulable.compute_unit_price;
+      if (!scheduler_->submit(std::move(schedulable))) {
+        return; // Evicted at capacity; counted in get_scheduler_stats()
+      }
+      queue_cv_.notify_one();
+
+      if (current_count < 5) {
+        std::cout << "Banking: Transaction queued in scheduler (price="
+                  << price << " micro-lamports/CU)" << std::endl;
+      }
+      return;
     }
 
     // **HIGH-SPEED STANDARD QUEUEING** - Minimal overhead
@@ -822,9 +821,8 @@ size_t BankingStage::get_pending_transaction_count() const {
   std::lock_guard<std::mutex> lock(queue_mutex_);
   size_t count = transaction_queue_.size();
 
-  if (priority_processing_enabled_) {
-    std::lock_guard<std::mutex> priority_lock(priority_mutex_);
-    count += priority_queue_.size();
+  if (priority_processing_enabled_ || fee_market_enabled_) {
+    count += scheduler_->pending_count();
   }
 
   return count;
@@ -856,19 +854,30 @@ void BankingStage::initialize_pipeline() {
   // Create validation stage
   validation_stage_ = std::make_shared<PipelineStage>(
       "validation", [this](std::shared_ptr<TransactionBatch> batch) {
-        return validate_batch(batch);
+        if (!validate_batch(batch)) {
+          complete_scheduled(*batch, false);
+          return false;
+        }
+        return true;
       });
 
   // Create execution stage
   execution_stage_ = std::make_shared<PipelineStage>(
       "execution", [this](std::shared_ptr<TransactionBatch> batch) {
-        return execute_batch(batch);
+        if (!execute_batch(batch)) {
+          complete_scheduled(*batch, false);
+          return false;
+        }
+        return true;
       });
 
-  // Create commitment stage
+  // Create commitment stage; a batch's scheduler locks are released once
+  // it commits or aborts
   commitment_stage_ = std::make_shared<PipelineStage>(
       "commitment", [this](std::shared_ptr<TransactionBatch> batch) {
-        return commit_batch(batch);
+        bool committed = commit_batch(batch);
+        complete_scheduled(*batch, committed);
+        return committed;
       });
 
   // Connect stages
@@ -982,15 +991,34 @@ void BankingStage::process_transaction_queue() {
     }
   }
 
-  // Handle priority queue if enabled
-  if (priority_processing_enabled_ || fee_market_enabled_) {
-    std::lock_guard<std::mutex> priority_lock(priority_mutex_);
+  // Take the best-paying transactions that fit the block's compute limits.
+  // Blocks are built on the ledger, so without one nothing is scheduled.
+  if ((priority_processing_enabled_ || fee_market_enabled_) &&
+      ledger_manager_ && transactions_to_process.size() < batch_size_) {
+    // The budget covers the block after the ledger's latest slot and
+    // starts over once the ledger moves on
+    common::Slot latest_slot;
+    {
+      std::lock_guard<std::mutex> lock(ledger_mutex_);
+      latest_slot = ledger_manager_->get_latest_slot();
+    }
+    if (latest_slot != scheduler_slot_) {
+      scheduler_->on_new_block();
+      scheduler_slot_ = latest_slot;
+    }
 
     size_t remaining_capacity = batch_size_ - transactions_to_process.size();
-    while (!priority_queue_.empty() && remaining_capacity > 0) {
-      transactions_to_process.push_back(priority_queue_.top().second);
-      priority_queue_.pop();
-      remaining_capacity--;
+    auto batches = scheduler_->schedule(remaining_capacity);
+    std::lock_guard<std::mutex> lock(scheduled_mutex_);
+    for (auto &batch : batches) {
+      // Execution order is kept by the pipeline itself
+      for (auto &scheduled : batch.transactions) {
+        transactions_to_process.push_back(scheduled.transaction);
+        PrioritizationFeeScheduler::Batch single{batch.thread, {}};
+        single.transactions.push_back(std::move(scheduled));
+        scheduled_.emplace(transactions_to_process.back().get(),
+                           std::move(single));
+      }
     }
   }
 
@@ -1025,6 +1053,33 @@ void BankingStage::process_transaction_queue() {
   }
 }
 
+void BankingStage::complete_scheduled(const TransactionBatch &batch,
+                                      bool committed) {
+  const auto &transactions = batch.get_transactions();
+  const auto &results = batch.get_results();
+  std::vector<std::pair<PrioritizationFeeScheduler::Batch, bool>> done;
+  {
+    std::lock_guard<std::mutex> lock(scheduled_mutex_);
+    if (scheduled_.empty()) {
+      return;
+    }
+    for (size_t i = 0; i < transactions.size(); ++i) {
+      auto it = scheduled_.find(transactions[i].get());
+      if (it == scheduled_.end()) {
+        continue;
+      }
+      // A transaction that failed by itself is finished; one held back only
+      // by the rest of its batch goes back in the queue
+      bool failed = i < results.size() && !results[i];
+      done.emplace_back(std::move(it->second), committed || failed);
+      scheduled_.erase(it);
+    }
+  }
+  for (const auto &[scheduled, ran] : done) {
+    scheduler_->complete(scheduled, {ran});
+  }
+}
+
 bool BankingStage::validate_batch(std::shared_ptr<TransactionBatch> batch) {
   // Validate all transactions in the batch with enhanced safety checks
   if (!batch) {
@@ -1287,6 +1342,21 @@ bool BankingStage::commit_batch(std::shared_ptr<TransactionBatch> batch) {
                         << std::endl;
             }
 
+            // **PRIORITIZATION FEES** - Per-slot and per-account minimums
+            // for getRecentPrioritizationFees
+            if (fee_market_enabled_ && fee_market_) {
+              for (const auto &tx_ptr : transactions) {
+                if (tx_ptr) {
+                  auto parsed = SchedulableTransaction::from_transaction(tx_ptr);
+                  fee_market_->record_prioritization_fee(
+                      new_block.slot, parsed.compute_unit_price,
+                      parsed.writable_accounts);
+                }
+              }
+              // Fees submitted from now on compete for the next block
+              fee_market_->advance_slot(new_block.slot + 1);
+            }
+
             // **THREAD-SAFE COUNTER UPDATES** - Update counters atomically
             // after successful commit
             total_transactions_processed_.fetch_add(processed_transactions,
@@ -1918,6 +1988,11 @@ void BankingStage::set_mev_protection_level(ProtectionLevel level) {
   }
 }
 
+PrioritizationFeeScheduler::Statistics
+BankingStage::get_scheduler_stats() const {
+  return scheduler_->get_statistics();
+}
+
 FeeStats BankingStage::get_fee_market_stats() const {
   if (fee_market_) {
     return fee_market_->get_recent_fee_stats();
@@ -1925,6 +2000,15 @@ FeeStats BankingStage::get_fee_market_stats() const {
   return FeeStats{};
 }
 
+std::vector<PrioritizationFeeCache::SlotFee>
+BankingStage::get_recent_prioritization_fees(
+    const std::vector<PublicKey> &accounts) const {
+  if (fee_market_) {
+    return fee_market_->get_recent_prioritization_fees(accounts);
+  }
+  return {};
+}
+
 uint64_t BankingStage::get_current_base_fee() const {
   if (fee_market_) {
     return fee_market_->get_current_base_fee();
@@ -0,0 +1,143 @@
+#include "banking/fee_histogram.h"
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace slonana {
+namespace banking {
+
+size_t FeeHistogram::bucket_index(uint64_t value) {
+  if (value < 2 * SUB_BUCKETS) {
+    return static_cast<size_t>(value);
+  }
+  size_t exponent = std::bit_width(value) - 1;
+  size_t mantissa = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+  return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + mantissa;
+}
+
+uint64_t FeeHistogram::bucket_lower(size_t index) {
+  if (index < 2 * SUB_BUCKETS) {
+    return index;
+  }
+  size_t exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+  uint64_t mantissa = SUB_BUCKETS + index % SUB_BUCKETS;
+  return mantissa << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t FeeHistogram::bucket_upper(size_t index) {
+  if (index < 2 * SUB_BUCKETS) {
+    return index;
+  }
+  size_t exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+  return bucket_lower(index) + ((uint64_t(1) << (exponent - SUB_BUCKET_BITS)) - 1);
+}
+
+void FeeHistogram::record(uint64_t value) {
+  auto &bucket = buckets_[bucket_index(value)];
+  bucket.count.fetch_add(1, std::memory_order_relaxed);
+  uint64_t seen = bucket.min.load(std::memory_order_relaxed);
+  while (value < seen &&
+         !bucket.min.compare_exchange_weak(seen, value,
+                                           std::memory_order_relaxed)) {
+  }
+  seen = bucket.max.load(std::memory_order_relaxed);
+  while (value > seen &&
+         !bucket.max.compare_exchange_weak(seen, value,
+                                           std::memory_order_relaxed)) {
+  }
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FeeHistogram::remove(uint64_t value) {
+  auto &bucket = buckets_[bucket_index(value)];
+  if (bucket.count.fetch_sub(1, std::memory_order_relaxed) == 1) {
+    // Emptied: forget its bounds. A racing record() may lose its update,
+    // which readers detect as min > max and fall back to the bucket edges.
+    bucket.min.store(UINT64_MAX, std::memory_order_relaxed);
+    bucket.max.store(0, std::memory_order_relaxed);
+  }
+  count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void FeeHistogram::clear() {
+  for (auto &bucket : buckets_) {
+    bucket.count.store(0, std::memory_order_relaxed);
+    bucket.min.store(UINT64_MAX, std::memory_order_relaxed);
+    bucket.max.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t>
+FeeHistogram::quantiles(const std::vector<double> &fractions) const {
+  std::vector<uint64_t> result(fractions.size(), 0);
+
+  // Snapshot the counts so the ranks agree with what is walked
+  std::array<uint32_t, BUCKETS> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < BUCKETS; ++i) {
+    counts[i] = buckets_[i].count.load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return result;
+  }
+
+  // Visit the requested ranks in ascending order during a single walk
+  std::vector<size_t> order(fractions.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::vector<uint64_t> ranks(fractions.size());
+  for (size_t i = 0; i < fractions.size(); ++i) {
+    double fraction = std::clamp(fractions[i], 0.0, 1.0);
+    ranks[i] = static_cast<uint64_t>(fraction * static_cast<double>(total - 1));
+  }
+  std::sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+
+  size_t next = 0;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < BUCKETS && next < order.size(); ++i) {
+    seen += counts[i];
+    if (counts[i] == 0) {
+      continue;
+    }
+    uint64_t low = buckets_[i].min.load(std::memory_order_relaxed);
+    uint64_t high = buckets_[i].max.load(std::memory_order_relaxed);
+    uint64_t value = low <= high ? high : bucket_upper(i);
+    while (next < order.size() && ranks[order[next]] < seen) {
+      result[order[next++]] = value;
+    }
+  }
+  return result;
+}
+
+uint64_t FeeHistogram::quantile(double fraction) const {
+  return quantiles({fraction})[0];
+}
+
+uint64_t FeeHistogram::min() const {
+  for (size_t i = 0; i < BUCKETS; ++i) {
+    if (buckets_[i].count.load(std::memory_order_relaxed) > 0) {
+      uint64_t low = buckets_[i].min.load(std::memory_order_relaxed);
+      return low <= buckets_[i].max.load(std::memory_order_relaxed)
+                 ? low
+                 : bucket_lower(i);
+    }
+  }
+  return 0;
+}
+
+uint64_t FeeHistogram::max() const {
+  for (size_t i = BUCKETS; i-- > 0;) {
+    if (buckets_[i].count.load(std::memory_order_relaxed) > 0) {
+      uint64_t high = buckets_[i].max.load(std::memory_order_relaxed);
+      return buckets_[i].min.load(std::memory_order_relaxed) <= high
+                 ? high
+                 : bucket_upper(i);
+    }
+  }
+  return 0;
+}
+
+} // namespace banking
+} // namespace slonana
@@ -7,9 +7,111 @@
 namespace slonana {
 namespace banking {
 
+namespace {
+
+// Sample::meta is (slot + 1) << 1 | included, so zero marks an empty entry
+constexpr uint64_t EMPTY_SAMPLE = 0;
+// Held in Sample::meta while one thread swaps the entry's fields
+constexpr uint64_t BUSY_SAMPLE = UINT64_MAX;
+
+uint64_t pack_meta(uint64_t slot, bool included) {
+  return (slot + 1) << 1 | (included ? 1 : 0);
+}
+
+uint64_t meta_slot(uint64_t meta) { return (meta >> 1) - 1; }
+
+} // namespace
+
+/**
+ * The last `capacity` fees with the slot each was recorded in and whether
+ * it was included, plus the histogram and inclusion count of exactly those
+ * samples. A recorder claims a position with fetch_add and swaps its sample
+ * into the entry; whatever it displaces, or evict_before() clears, is
+ * removed from the histogram, so every sample is counted once while it sits
+ * in the ring.
+ */
+struct FeeMarket::SampleWindow {
+  struct Sample {
+    std::atomic<uint64_t> fee{0};
+    std::atomic<uint64_t> meta{EMPTY_SAMPLE};
+
+    /// Mark the entry busy and return its previous meta
+    uint64_t claim() {
+      uint64_t meta_seen = meta.load(std::memory_order_relaxed);
+      while (meta_seen == BUSY_SAMPLE ||
+             !meta.compare_exchange_weak(meta_seen, BUSY_SAMPLE,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+        if (meta_seen == BUSY_SAMPLE) {
+          meta_seen = meta.load(std::memory_order_relaxed);
+        }
+      }
+      return meta_seen;
+    }
+  };
+
+  explicit SampleWindow(size_t ring_capacity)
+      : capacity(ring_capacity),
+        samples(std::make_unique<Sample[]>(ring_capacity)) {}
+
+  void record(uint64_t fee, bool included, uint64_t slot) {
+    uint64_t position = next.fetch_add(1, std::memory_order_relaxed);
+    histogram.record(fee);
+    if (included) {
+      included_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Sample &sample = samples[position % capacity];
+    uint64_t displaced_meta = sample.claim();
+    uint64_t displaced_fee = sample.fee.load(std::memory_order_relaxed);
+    sample.fee.store(fee, std::memory_order_relaxed);
+    sample.meta.store(pack_meta(slot, included), std::memory_order_release);
+    if (displaced_meta != EMPTY_SAMPLE) {
+      forget(displaced_fee, displaced_meta);
+    }
+  }
+
+  /// Clear every sample recorded before `first_slot`
+  void evict_before(uint64_t first_slot) {
+    for (size_t i = 0; i < capacity; ++i) {
+      Sample &sample = samples[i];
+      uint64_t meta = sample.meta.load(std::memory_order_acquire);
+      // A busy entry is being refilled with a current sample
+      if (meta == EMPTY_SAMPLE || meta == BUSY_SAMPLE ||
+          meta_slot(meta) >= first_slot) {
+        continue;
+      }
+      if (!sample.meta.compare_exchange_strong(meta, BUSY_SAMPLE,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+        continue; // a recorder replaced it first
+      }
+      uint64_t fee = sample.fee.load(std::memory_order_relaxed);
+      sample.meta.store(EMPTY_SAMPLE, std::memory_order_release);
+      forget(fee, meta);
+    }
+  }
+
+  void forget(uint64_t fee, uint64_t meta) {
+    histogram.remove(fee);
+    if (meta & 1) {
+      included_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  const size_t capacity;
+  std::unique_ptr<Sample[]> samples;
+  std::atomic<uint64_t> next{0};
+  std::atomic<uint64_t> included_count{0};
+  FeeHistogram histogram;
+};
+
 FeeMarket::FeeMarket()
     : base_fee_(DEFAULT_BASE_FEE), target_utilization_(DEFAULT_TARGET_UTILIZATION),
-      adaptive_fees_enabled_(true), max_history_size_(DEFAULT_MAX_HISTORY) {
+      adaptive_fees_enabled_(true), max_history_size_(DEFAULT_MAX_HISTORY),
+      history_slots_(DEFAULT_HISTORY_SLOTS) {
+  current_window_ = std::make_unique<SampleWindow>(max_history_size_);
+  window_.store(current_window_.get(), std::memory_order_release);
   LOG_INFO("FeeMarket initialized with base fee: {} lamports", DEFAULT_BASE_FEE);
 }
 
@@ -29,9 +131,9 @@ uint64_t FeeMarket::calculate_priority_fee(uint64_t base_fee) {
 }
 
 FeeTier FeeMarket::classify_fee_tier(uint64_t fee) {
-  std::lock_guard<std::mutex> lock(history_mutex_);
-  
-  if (recent_fees_.empty()) {
+  refresh_cached_stats();
+
+  if (cached_.count.load(std::memory_order_relaxed) == 0) {
     // No history - classify based on base fee
     uint64_t current_base = base_fee_.load();
     if (fee >= current_base * 5) return FeeTier::URGENT;
@@ -40,24 +142,19 @@ FeeTier FeeMarket::classify_fee_tier(uint64_t fee) {
     return FeeTier::LOW;
   }
 
-  // Calculate percentiles from recent fees
-  uint64_t p99 = calculate_percentile(P99_THRESHOLD);
-  uint64_t p90 = calculate_percentile(P90_THRESHOLD);
-  uint64_t p25 = calculate_percentile(P25_THRESHOLD);
-
-  // Classify based on percentile thresholds
-  if (fee >= p99) return FeeTier::URGENT;
-  if (fee >= p90) return FeeTier::HIGH;
-  if (fee >= p25) return FeeTier::NORMAL;
+  // Classify based on the cached percentile thresholds
+  if (fee >= cached_.p99.load(std::memory_order_relaxed)) return FeeTier::URGENT;
+  if (fee >= cached_.p90.load(std::memory_order_relaxed)) return FeeTier::HIGH;
+  if (fee >= cached_.p25.load(std::memory_order_relaxed)) return FeeTier::NORMAL;
   return FeeTier::LOW;
 }
 
 uint64_t FeeMarket::estimate_fee_for_priority(FeeTier tier) {
-  std::lock_guard<std::mutex> lock(history_mutex_);
-  
+  refresh_cached_stats();
+
   uint64_t current_base = base_fee_.load();
   
-  if (recent_fees_.empty()) {
+  if (cached_.count.load(std::memory_order_relaxed) == 0) {
     // No history - estimate based on base fee multiples
     switch (tier) {
       case FeeTier::URGENT:
@@ -75,35 +172,32 @@ uint64_t FeeMarket::estimate_fee_for_priority(FeeTier tier) {
   // Estimate based on recent percentiles
   switch (tier) {
     case FeeTier::URGENT:
-      return calculate_percentile(P99_THRESHOLD);
+      return cached_.p99.load(std::memory_order_relaxed);
     case FeeTier::HIGH:
-      return calculate_percentile(P90_THRESHOLD);
+      return cached_.p90.load(std::memory_order_relaxed);
     case FeeTier::NORMAL:
-      return calculate_percentile(0.5); // median
+      return cached_.median.load(std::memory_order_relaxed);
     case FeeTier::LOW:
-      return calculate_percentile(P25_THRESHOLD);
+      return cached_.p25.load(std::memory_order_relaxed);
   }
 
   return current_base;
 }
 
 FeeStats FeeMarket::get_recent_fee_stats() {
-  std::lock_guard<std::mutex> lock(history_mutex_);
-  
-  FeeStats stats;
-  stats.sample_count = recent_fees_.size();
+  refresh_cached_stats();
 
-  if (recent_fees_.empty()) {
+  FeeStats stats;
+  stats.sample_count = cached_.count.load(std::memory_order_relaxed);
+  if (stats.sample_count == 0) {
     return stats;
   }
 
-  auto sorted = get_sorted_fees();
-  
-  stats.min_fee = sorted.front();
-  stats.max_fee = sorted.back();
-  stats.median_fee = calculate_percentile(0.5);
-  stats.p90_fee = calculate_percentile(P90_THRESHOLD);
-  stats.p99_fee = calculate_percentile(P99_THRESHOLD);
+  stats.min_fee = cached_.min.load(std::memory_order_relaxed);
+  stats.max_fee = cached_.max.load(std::memory_order_relaxed);
+  stats.median_fee = cached_.median.load(std::memory_order_relaxed);
+  stats.p90_fee = cached_.p90.load(std::memory_order_relaxed);
+  stats.p99_fee = cached_.p99.load(std::memory_order_relaxed);
 
   return stats;
 }
@@ -145,12 +239,31 @@ uint64_t FeeMarket::get_current_base_fee() const {
 }
 
 void FeeMarket::record_transaction_fee(uint64_t fee, bool included) {
-  std::lock_guard<std::mutex> lock(history_mutex_);
-  
-  recent_fees_.push_back(fee);
-  inclusion_status_.push_back(included);
-  
-  trim_history_if_needed();
+  window_.load(std::memory_order_acquire)
+      ->record(fee, included, current_slot_.load(std::memory_order_acquire));
+}
+
+void FeeMarket::advance_slot(uint64_t slot) {
+  std::lock_guard<std::mutex> lock(config_mutex_);
+  if (slot <= current_slot_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  current_slot_.store(slot, std::memory_order_release);
+
+  uint64_t history = history_slots_.load(std::memory_order_relaxed);
+  evict_before(slot + 1 > history ? slot + 1 - history : 0);
+}
+
+void FeeMarket::record_prioritization_fee(
+    uint64_t slot, uint64_t compute_unit_price,
+    const std::vector<common::PublicKey> &writable_accounts) {
+  prioritization_fees_.update(slot, compute_unit_price, writable_accounts);
+}
+
+std::vector<PrioritizationFeeCache::SlotFee>
+FeeMarket::get_recent_prioritization_fees(
+    const std::vector<common::PublicKey> &accounts) const {
+  return prioritization_fees_.get_recent_fees(accounts);
 }
 
 void FeeMarket::set_target_utilization(double target) {
@@ -159,9 +272,44 @@ void FeeMarket::set_target_utilization(double target) {
 }
 
 void FeeMarket::set_max_history_size(size_t max_history) {
-  std::lock_guard<std::mutex> lock(history_mutex_);
+  std::lock_guard<std::mutex> lock(config_mutex_);
   max_history_size_ = std::max(size_t(100), max_history);
-  trim_history_if_needed();
+
+  // Carry the newest samples over into a ring of the new size; samples
+  // recorded into the old ring while it is being swapped out are lost
+  SampleWindow *old_window = current_window_.get();
+  auto resized = std::make_unique<SampleWindow>(max_history_size_);
+  uint64_t end = old_window->next.load(std::memory_order_acquire);
+  uint64_t begin = end - std::min<uint64_t>(
+                             end, std::min(old_window->capacity, max_history_size_));
+  for (uint64_t position = begin; position < end; ++position) {
+    auto &sample = old_window->samples[position % old_window->capacity];
+    uint64_t meta = sample.claim();
+    uint64_t fee = sample.fee.load(std::memory_order_relaxed);
+    sample.meta.store(meta, std::memory_order_release);
+    if (meta != EMPTY_SAMPLE) {
+      resized->record(fee, meta & 1, meta_slot(meta));
+    }
+  }
+
+  window_.store(resized.get(), std::memory_order_release);
+  retired_windows_.emplace_back(current_slot_.load(std::memory_order_relaxed),
+                                std::move(current_window_));
+  current_window_ = std::move(resized);
+  cached_.position.store(UINT64_MAX, std::memory_order_release);
+}
+
+void FeeMarket::set_history_slots(size_t slots) {
+  std::lock_guard<std::mutex> lock(config_mutex_);
+  uint64_t history = std::max<uint64_t>(1, slots);
+  history_slots_.store(history, std::memory_order_relaxed);
+
+  uint64_t slot = current_slot_.load(std::memory_order_relaxed);
+  evict_before(slot + 1 > history ? slot + 1 - history : 0);
+}
+
+size_t FeeMarket::get_history_slots() const {
+  return history_slots_.load(std::memory_order_relaxed);
 }
 
 void FeeMarket::enable_adaptive_fees(bool enabled) {
@@ -170,55 +318,60 @@ void FeeMarket::enable_adaptive_fees(bool enabled) {
 }
 
 size_t FeeMarket::get_tracked_fee_count() const {
-  std::lock_guard<std::mutex> lock(history_mutex_);
-  return recent_fees_.size();
+  return window_.load(std::memory_order_acquire)->histogram.count();
 }
 
 double FeeMarket::get_inclusion_rate() const {
-  std::lock_guard<std::mutex> lock(history_mutex_);
-  
-  if (inclusion_status_.empty()) {
+  const SampleWindow *window = window_.load(std::memory_order_acquire);
+  uint64_t count = window->histogram.count();
+  if (count == 0) {
     return 1.0;
   }
 
-  size_t included_count = std::count(inclusion_status_.begin(), 
-                                     inclusion_status_.end(), true);
-  return static_cast<double>(included_count) / inclusion_status_.size();
+  uint64_t included_count =
+      std::min(count, window->included_count.load(std::memory_order_relaxed));
+  return static_cast<double>(included_count) / count;
 }
 
 // Private helper methods
 
-uint64_t FeeMarket::calculate_percentile(double percentile) {
-  // Caller must hold history_mutex_
-  
-  if (recent_fees_.empty()) {
-    return base_fee_.load();
-  }
+void FeeMarket::evict_before(uint64_t first_slot) {
+  // A recorder that loaded a retired ring is done with it long before the
+  // window has moved on by a full horizon
+  uint64_t slot = current_slot_.load(std::memory_order_relaxed);
+  uint64_t history = history_slots_.load(std::memory_order_relaxed);
+  std::erase_if(retired_windows_, [&](const auto &retired) {
+    return slot >= retired.first + history;
+  });
 
-  auto sorted = get_sorted_fees();
-  
-  size_t index = static_cast<size_t>(percentile * (sorted.size() - 1));
-  return sorted[index];
+  current_window_->evict_before(first_slot);
+  cached_.position.store(UINT64_MAX, std::memory_order_release);
 }
 
-void FeeMarket::trim_history_if_needed() {
-  // Caller must hold history_mutex_
-  
-  while (recent_fees_.size() > max_history_size_) {
-    recent_fees_.pop_front();
+void FeeMarket::refresh_cached_stats() {
+  const SampleWindow *window = window_.load(std::memory_order_acquire);
+  uint64_t position = window->next.load(std::memory_order_acquire);
+  if (cached_.position.load(std::memory_order_acquire) == position) {
+    return;
   }
-  
-  while (inclusion_status_.size() > max_history_size_) {
-    inclusion_status_.pop_front();
+
+  // Whoever holds the lock is refreshing already; use the cached values
+  std::unique_lock<std::mutex> lock(refresh_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return;
   }
-}
 
-std::vector<uint64_t> FeeMarket::get_sorted_fees() {
-  // Caller must hold history_mutex_
-  
-  std::vector<uint64_t> sorted(recent_fees_.begin(), recent_fees_.end());
-  std::sort(sorted.begin(), sorted.end());
-  return sorted;
+  const FeeHistogram &histogram = window->histogram;
+  auto percentiles = histogram.quantiles(
+      {P25_THRESHOLD, 0.5, P90_THRESHOLD, P99_THRESHOLD});
+  cached_.count.store(histogram.count(), std::memory_order_relaxed);
+  cached_.min.store(histogram.min(), std::memory_order_relaxed);
+  cached_.p25.store(percentiles[0], std::memory_order_relaxed);
+  cached_.median.store(percentiles[1], std::memory_order_relaxed);
+  cached_.p90.store(percentiles[2], std::memory_order_relaxed);
+  cached_.p99.store(percentiles[3], std::memory_order_relaxed);
+  cached_.max.store(histogram.max(), std::memory_order_relaxed);
+  cached_.position.store(position, std::memory_order_release);
 }
 
 } // namespace banking
@@ -1,12 +1,292 @@
 #include "banking/mev_protection.h"
+#include "banking/prioritization_scheduler.h"
 #include "common/logging.h"
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <random>
-#include <unordered_set>
 
 namespace slonana {
 namespace banking {
 
+namespace {
+
+constexpr uint8_t VERSIONED_MESSAGE_PREFIX = 0x80;
+constexpr int32_t NO_POSITION = -1;
+
+/**
+ * What detection needs from a transaction, extracted once per batch. Keys
+ * are reduced to 64-bit hashes; writable accounts other than the fee payer
+ * are stored in a buffer shared by the whole batch.
+ */
+struct TransactionFeatures {
+  uint64_t sender = 0;    ///< Fee payer; 0 if the message did not parse
+  uint64_t program = 0;   ///< First non-ComputeBudget instruction's program
+  uint64_t operation = 0; ///< That program and its instruction discriminator
+  uint64_t amount = 0;    ///< The u64 following the discriminator, if any
+  uint64_t compute_unit_price = 0;
+  uint64_t account_set = 0;   ///< The instruction's writable non-signers
+  uint64_t account_roles = 0; ///< The same, sensitive to their order
+  uint32_t accounts_begin = 0;
+  uint32_t accounts_end = 0;
+};
+
+bool read_compact_u16(const std::vector<uint8_t> &data, size_t &offset,
+                      size_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 21; shift += 7) {
+    if (offset >= data.size()) {
+      return false;
+    }
+    uint8_t byte = data[offset++];
+    value |= static_cast<size_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t read_u64(const uint8_t *data) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+uint64_t mix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  return value ^ (value >> 33);
+}
+
+/// 64-bit digest of a 32-byte key; never 0, which marks empty table cells
+uint64_t key_hash(const uint8_t *key) {
+  uint64_t words[4];
+  std::memcpy(words, key, sizeof(words));
+  uint64_t hash = words[0] ^ std::rotl(words[1], 17) ^
+                  std::rotl(words[2], 31) ^ std::rotl(words[3], 47);
+  return hash != 0 ? hash : 1;
+}
+
+TransactionFeatures extract_features(const ledger::Transaction &transaction,
+                                     std::vector<uint64_t> &account_keys) {
+  TransactionFeatures features;
+  features.accounts_begin = features.accounts_end =
+      static_cast<uint32_t>(account_keys.size());
+
+  const auto &message = transaction.message;
+  size_t offset = 0;
+  if (!message.empty() && (message[0] & VERSIONED_MESSAGE_PREFIX)) {
+    ++offset;
+  }
+  if (offset + 3 > message.size()) {
+    return features;
+  }
+  size_t required_signatures = message[offset];
+  size_t readonly_signed = message[offset + 1];
+  size_t readonly_unsigned = message[offset + 2];
+  offset += 3;
+
+  size_t key_count = 0;
+  if (!read_compact_u16(message, offset, key_count) ||
+      offset + key_count * 32 + 32 > message.size() ||
+      required_signatures == 0 || readonly_signed > required_signatures ||
+      required_signatures + readonly_unsigned > key_count) {
+    return features;
+  }
+  const uint8_t *keys = message.data() + offset;
+  offset += key_count * 32 + 32;
+  auto writable = [&](size_t index) {
+    return index < required_signatures
+               ? index < required_signatures - readonly_signed
+               : index < key_count - readonly_unsigned;
+  };
+
+  size_t instruction_count = 0;
+  if (!read_compact_u16(message, offset, instruction_count)) {
+    return features;
+  }
+  for (size_t i = 0; i < instruction_count; ++i) {
+    if (offset >= message.size()) {
+      return features;
+    }
+    size_t program_index = message[offset++];
+    size_t account_count = 0;
+    if (!read_compact_u16(message, offset, account_count) ||
+        offset + account_count > message.size() ||
+        program_index >= key_count) {
+      return features;
+    }
+    size_t accounts_offset = offset;
+    offset += account_count;
+    size_t data_size = 0;
+    if (!read_compact_u16(message, offset, data_size) ||
+        offset + data_size > message.size()) {
+      return features;
+    }
+    const uint8_t *data = message.data() + offset;
+    offset += data_size;
+
+    const uint8_t *program = keys + program_index * 32;
+    if (std::memcmp(program,
+                    SchedulableTransaction::COMPUTE_BUDGET_PROGRAM_ID.data(),
+                    32) == 0) {
+      if (data_size >= 9 && data[0] == 3) { // SetComputeUnitPrice
+        features.compute_unit_price = read_u64(data + 1);
+      }
+      continue;
+    }
+    if (features.program != 0) {
+      continue; // Only the first program instruction is characterized
+    }
+
+    // Discriminator: 8 bytes (Anchor style) when followed by an amount,
+    // else 1 byte (native and SPL style)
+    features.program = key_hash(program);
+    size_t discriminator = data_size >= 16 ? 8 : std::min<size_t>(data_size, 1);
+    uint64_t tag = discriminator == 8 ? read_u64(data)
+                                      : (discriminator == 1 ? data[0] : 0);
+    features.operation = mix(features.program ^ mix(tag + discriminator));
+    if (data_size >= discriminator + 8) {
+      features.amount = read_u64(data + discriminator);
+    }
+
+    // A swap names the trader's source and destination accounts; the same
+    // accounts in other roles mean the trader is swapping back
+    for (size_t a = 0; a < account_count; ++a) {
+      size_t index = message[accounts_offset + a];
+      if (index < required_signatures || index >= key_count || !writable(index)) {
+        continue;
+      }
+      uint64_t key = key_hash(keys + index * 32);
+      features.account_set += mix(key);
+      features.account_roles += mix(key + a);
+    }
+  }
+
+  features.sender = key_hash(keys);
+  for (size_t i = 1; i < key_count; ++i) {
+    if (writable(i)) {
+      account_keys.push_back(key_hash(keys + i * 32));
+    }
+  }
+  features.accounts_end = static_cast<uint32_t>(account_keys.size());
+  return features;
+}
+
+/**
+ * Open-addressing map from non-zero 64-bit keys, sized once per batch. Key
+ * and value share a cell so a lookup touches one cache line.
+ */
+template <typename Value> class FlatMap {
+public:
+  explicit FlatMap(size_t expected) {
+    size_t capacity = 16;
+    while (capacity < expected + expected / 4) {
+      capacity <<= 1;
+    }
+    cells_.resize(capacity);
+    mask_ = capacity - 1;
+  }
+
+  /// The value for `key`, default-constructed on first use
+  Value &operator[](uint64_t key) {
+    size_t i = mix(key) & mask_;
+    while (cells_[i].key != key && cells_[i].key != 0) {
+      i = (i + 1) & mask_;
+    }
+    cells_[i].key = key;
+    return cells_[i].value;
+  }
+
+private:
+  struct Cell {
+    uint64_t key = 0;
+    Value value;
+  };
+
+  std::vector<Cell> cells_;
+  size_t mask_ = 0;
+};
+
+/// Timeline state of one writable account
+struct AccountState {
+  int32_t last = NO_POSITION;
+  int32_t last_other = NO_POSITION; ///< Latest entry by someone else than last's sender
+};
+
+struct SenderPosition {
+  int32_t position = NO_POSITION;
+};
+
+bool similar_amounts(uint64_t a, uint64_t b) {
+  uint64_t high = std::max(a, b);
+  return a != 0 && b != 0 && high - std::min(a, b) <= high / 50;
+}
+
+/// A different sender copying the victim's trade ahead of it at a higher price
+bool front_runs(const TransactionFeatures &front,
+                const TransactionFeatures &victim) {
+  return front.sender != victim.sender && front.operation != 0 &&
+         front.operation == victim.operation &&
+         similar_amounts(front.amount, victim.amount) &&
+         front.compute_unit_price > victim.compute_unit_price;
+}
+
+/// A different sender's call to the same program bidding exactly the
+/// target's price, so that it lands right behind it
+bool back_runs(const TransactionFeatures &target,
+               const TransactionFeatures &backrun) {
+  return target.sender != backrun.sender && backrun.program != 0 &&
+         backrun.program == target.program &&
+         backrun.compute_unit_price == target.compute_unit_price;
+}
+
+double sandwich_confidence(const TransactionFeatures &front,
+                           const TransactionFeatures &victim,
+                           const TransactionFeatures &back) {
+  // Same sender on both sides of someone else on a shared account
+  double confidence = 0.4;
+  if (victim.program != 0 && front.program == victim.program &&
+      back.program == victim.program) {
+    confidence += 0.3;
+  }
+  if (front.account_set != 0 && back.account_set == front.account_set &&
+      back.account_roles != front.account_roles) {
+    confidence += 0.3; // The attacker unwinds its position
+  } else if (front.operation == back.operation) {
+    confidence += 0.1;
+  }
+  return std::min(1.0, confidence);
+}
+
+bool share_account(const TransactionFeatures &a, const TransactionFeatures &b,
+                   const std::vector<uint64_t> &account_keys) {
+  for (uint32_t i = a.accounts_begin; i < a.accounts_end; ++i) {
+    for (uint32_t j = b.accounts_begin; j < b.accounts_end; ++j) {
+      if (account_keys[i] == account_keys[j]) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+Hash get_transaction_hash(const MEVProtection::TransactionPtr &tx) {
+  if (!tx || tx->signatures.empty()) {
+    return Hash{}; // Return empty hash
+  }
+  // Use first signature as hash proxy
+  return tx->signatures[0];
+}
+
+} // namespace
+
+
 MEVProtection::MEVProtection()
     : protection_level_(ProtectionLevel::FAIR_ORDERING), detection_enabled_(true),
       alert_threshold_(DEFAULT_ALERT_THRESHOLD), detected_attacks_(0),
@@ -26,62 +306,103 @@ std::vector<MEVAlert> MEVProtection::detect_mev_patterns(
     return {};
   }
 
-  std::vector<MEVAlert> alerts;
+  // Features of every transaction, once
+  std::vector<TransactionFeatures> features(transactions.size());
+  std::vector<uint64_t> account_keys;
+  account_keys.reserve(transactions.size() * 4);
+  for (size_t i = 0; i < transactions.size(); ++i) {
+    if (transactions[i]) {
+      features[i] = extract_features(*transactions[i], account_keys);
+    }
+  }
 
-  // Detect sandwich attacks (requires at least 3 transactions)
-  if (transactions.size() >= 3) {
-    for (size_t i = 0; i + 2 < transactions.size(); ++i) {
-      // Safety check
-      if (!transactions[i] || !transactions[i + 1] || !transactions[i + 2]) {
-        continue;
-      }
-      
-      if (is_sandwich_attack(transactions[i], transactions[i + 1],
-                            transactions[i + 2])) {
-        double confidence = calculate_mev_confidence(
-            transactions[i], transactions[i + 1], transactions[i + 2]);
-        
-        if (confidence >= alert_threshold_) {
-          try {
-            MEVAlert alert(
-                MEVAlert::Type::SANDWICH_ATTACK,
-                std::vector<Hash>{get_transaction_hash(transactions[i]),
-                                 get_transaction_hash(transactions[i + 1]),
-                                 get_transaction_hash(transactions[i + 2])},
-                confidence,
-                "Potential sandwich attack detected");
-            alerts.push_back(std::move(alert));
-            detected_attacks_++;
-          } catch (...) {
-            // Skip this alert if construction fails
-          }
-        }
-      }
+  std::vector<MEVAlert> alerts;
+  auto raise = [&](MEVAlert::Type type, std::initializer_list<int32_t> positions,
+                   double confidence, const char *description) {
+    if (confidence < alert_threshold_) {
+      return;
+    }
+    std::vector<Hash> hashes;
+    hashes.reserve(positions.size());
+    for (int32_t position : positions) {
+      hashes.push_back(get_transaction_hash(transactions[position]));
+    }
+    alerts.emplace_back(type, std::move(hashes), confidence, description);
+    detected_attacks_++;
+  };
+
+  // Only senders with several transactions in the batch can sandwich, so
+  // only their account visits are tracked per sender
+  FlatMap<uint32_t> sender_counts(transactions.size());
+  for (const auto &feature : features) {
+    if (feature.sender != 0) {
+      ++sender_counts[feature.sender];
+    }
+  }
+  std::vector<bool> repeat_sender(transactions.size(), false);
+  size_t repeat_visits = 0;
+  for (size_t i = 0; i < features.size(); ++i) {
+    if (features[i].sender != 0 && sender_counts[features[i].sender] > 1) {
+      repeat_sender[i] = true;
+      repeat_visits += features[i].accounts_end - features[i].accounts_begin;
     }
   }
 
-  // Detect front-running (pairwise comparison)
-  for (size_t i = 0; i + 1 < transactions.size(); ++i) {
-    if (!transactions[i] || !transactions[i + 1]) {
+  // Per-account timelines, walked in block order. The last pattern raised
+  // for each later transaction suppresses repeats across the accounts it
+  // shares with the same counterpart.
+  FlatMap<AccountState> accounts(account_keys.size());
+  FlatMap<SenderPosition> sender_positions(repeat_visits);
+  std::vector<int32_t> sandwich_front(transactions.size(), NO_POSITION);
+  std::vector<int32_t> front_runner(transactions.size(), NO_POSITION);
+  std::vector<int32_t> back_run_target(transactions.size(), NO_POSITION);
+
+  for (size_t i = 0; i < transactions.size(); ++i) {
+    const auto &current = features[i];
+    if (current.sender == 0) {
       continue;
     }
-    
-    if (is_front_running(transactions[i], transactions[i + 1])) {
-      double confidence = 0.75; // Base confidence for front-running
-      
-      if (confidence >= alert_threshold_) {
-        try {
-          MEVAlert alert(
-              MEVAlert::Type::FRONT_RUNNING,
-              std::vector<Hash>{get_transaction_hash(transactions[i]),
-                               get_transaction_hash(transactions[i + 1])},
-              confidence,
-              "Potential front-running detected");
-          alerts.push_back(std::move(alert));
-          detected_attacks_++;
-        } catch (...) {
-          // Skip this alert if construction fails
+    int32_t position = static_cast<int32_t>(i);
+
+    for (uint32_t k = current.accounts_begin; k < current.accounts_end; ++k) {
+      auto &state = accounts[account_keys[k]];
+      SenderPosition *previous_own =
+          repeat_sender[i]
+              ? &sender_positions[(mix(account_keys[k]) ^ current.sender) | 1]
+              : nullptr;
+
+      // Latest entry by someone else, and this sender's previous visit
+      uint64_t last_sender =
+          state.last != NO_POSITION ? features[state.last].sender : 0;
+      int32_t other =
+          last_sender != current.sender ? state.last : state.last_other;
+      int32_t own = previous_own ? previous_own->position : NO_POSITION;
+      if (own != NO_POSITION && other > own && sandwich_front[i] != own) {
+        sandwich_front[i] = own;
+        const auto &front = features[own];
+        raise(MEVAlert::Type::SANDWICH_ATTACK, {own, other, position},
+              sandwich_confidence(front, features[other], current),
+              "Potential sandwich attack detected");
+      }
+
+      // Adjacent entries by different senders on this account
+      if (state.last != NO_POSITION && last_sender != current.sender) {
+        const auto &before = features[state.last];
+        if (front_runner[i] != state.last && front_runs(before, current)) {
+          front_runner[i] = state.last;
+          raise(MEVAlert::Type::FRONT_RUNNING, {state.last, position},
+                FRONT_RUN_CONFIDENCE, "Potential front-running detected");
+        }
+        if (back_run_target[i] != state.last && back_runs(before, current)) {
+          back_run_target[i] = state.last;
+          raise(MEVAlert::Type::BACK_RUNNING, {state.last, position},
+                BACK_RUN_CONFIDENCE, "Potential back-running detected");
         }
+        state.last_other = state.last;
+      }
+      state.last = position;
+      if (previous_own) {
+        previous_own->position = position;
       }
     }
   }
@@ -107,20 +428,28 @@ bool MEVProtection::is_sandwich_attack(const TransactionPtr &tx1,
     return false;
   }
 
-  // Check if tx1 and tx2 are from the same sender
-  auto sender1 = get_transaction_sender(tx1);
-  auto sender2 = get_transaction_sender(tx2);
-  auto victim_sender = get_transaction_sender(victim);
+  std::vector<uint64_t> account_keys;
+  auto front = extract_features(*tx1, account_keys);
+  auto middle = extract_features(*victim, account_keys);
+  auto back = extract_features(*tx2, account_keys);
 
-  if (sender1 != sender2 || sender1 == victim_sender) {
+  // The same sender on both sides of someone else, all on a shared account
+  if (front.sender == 0 || front.sender != back.sender ||
+      front.sender == middle.sender || middle.sender == 0) {
     return false;
   }
-
-  // Check if all three access similar accounts (simplified check)
-  bool tx1_victim_overlap = transactions_access_same_accounts(tx1, victim);
-  bool victim_tx2_overlap = transactions_access_same_accounts(victim, tx2);
-
-  return tx1_victim_overlap && victim_tx2_overlap;
+  for (uint32_t i = middle.accounts_begin; i < middle.accounts_end; ++i) {
+    uint64_t key = account_keys[i];
+    auto touches = [&](const TransactionFeatures &f) {
+      return std::find(account_keys.begin() + f.accounts_begin,
+                       account_keys.begin() + f.accounts_end,
+                       key) != account_keys.begin() + f.accounts_end;
+    };
+    if (touches(front) && touches(back)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 bool MEVProtection::is_front_running(const TransactionPtr &original,
@@ -129,14 +458,10 @@ bool MEVProtection::is_front_running(const TransactionPtr &original,
     return false;
   }
 
-  // Check if transactions are from different senders
-  if (get_transaction_sender(original) == get_transaction_sender(frontrun)) {
-    return false;
-  }
-
-  // Check if they access the same accounts and have similar operations
-  return transactions_access_same_accounts(original, frontrun) &&
-         transactions_have_similar_operations(original, frontrun);
+  std::vector<uint64_t> account_keys;
+  auto victim = extract_features(*original, account_keys);
+  auto front = extract_features(*frontrun, account_keys);
+  return share_account(front, victim, account_keys) && front_runs(front, victim);
 }
 
 bool MEVProtection::is_back_running(const TransactionPtr &target,
@@ -145,9 +470,10 @@ bool MEVProtection::is_back_running(const TransactionPtr &target,
     return false;
   }
 
-  // Back-running is similar to front-running but happens after
-  // Check if transactions access same accounts
-  return transactions_access_same_accounts(target, backrun);
+  std::vector<uint64_t> account_keys;
+  auto first = extract_features(*target, account_keys);
+  auto second = extract_features(*backrun, account_keys);
+  return share_account(first, second, account_keys) && back_runs(first, second);
 }
 
 std::vector<MEVProtection::TransactionPtr>
@@ -268,86 +594,10 @@ void MEVProtection::clear_alert_history() {
 
 // Private helper methods
 
-bool MEVProtection::transactions_access_same_accounts(
-    const TransactionPtr &tx1, const TransactionPtr &tx2) {
-  
-  if (!tx1 || !tx2) {
-    return false;
-  }
-
-  // Simplified check - in production, would check actual account accesses
-  // For now, check if transaction signatures overlap
-  return !tx1->signatures.empty() && !tx2->signatures.empty();
-}
-
-bool MEVProtection::transactions_have_similar_operations(
-    const TransactionPtr &tx1, const TransactionPtr &tx2) {
-  
-  if (!tx1 || !tx2) {
-    return false;
-  }
-
-  // Simplified check - in production, would analyze instruction types
-  // For now, check if they have similar message sizes
-  if (tx1->message.empty() || tx2->message.empty()) {
-    return false;
-  }
-  
-  // Check if messages are similar in size (within 20%)
-  size_t size1 = tx1->message.size();
-  size_t size2 = tx2->message.size();
-  size_t diff = (size1 > size2) ? (size1 - size2) : (size2 - size1);
-  
-  return diff < (std::max(size1, size2) / 5);
-}
-
-double MEVProtection::calculate_mev_confidence(const TransactionPtr &tx1,
-                                               const TransactionPtr &tx2,
-                                               const TransactionPtr &tx3) {
-  double confidence = 0.0;
-
-  // Check various sandwich attack indicators
-  if (get_transaction_sender(tx1) == get_transaction_sender(tx3)) {
-    confidence += 0.4;
-  }
-
-  if (transactions_access_same_accounts(tx1, tx2) &&
-      transactions_access_same_accounts(tx2, tx3)) {
-    confidence += 0.3;
-  }
-
-  if (transactions_have_similar_operations(tx1, tx3)) {
-    confidence += 0.3;
-  }
-
-  return std::min(1.0, confidence);
-}
-
-Hash MEVProtection::get_transaction_hash(const TransactionPtr &tx) {
-  if (!tx || tx->signatures.empty()) {
-    return Hash{}; // Return empty hash
-  }
-  // Use first signature as hash proxy
-  return tx->signatures[0];
-}
-
-PublicKey MEVProtection::get_transaction_sender(const TransactionPtr &tx) {
-  if (!tx || tx->signatures.empty()) {
-    return PublicKey{}; // Return empty key
-  }
-  // Use first signature as a proxy for sender identity
-  // In production, would extract actual sender from transaction message
-  PublicKey sender;
-  if (tx->signatures[0].size() >= 32) {
-    std::copy_n(tx->signatures[0].begin(), 32, sender.begin());
-  }
-  return sender;
-}
-
 void MEVProtection::trim_alert_history() {
   // Caller must hold alert_mutex_
   while (alert_history_.size() > MAX_ALERT_HISTORY) {
-    alert_history_.erase(alert_history_.begin());
+    alert_history_.pop_front();
   }
 }
 
@@ -0,0 +1,184 @@
+#include "banking/prioritization_fee_cache.h"
+#include <algorithm>
+#include <array>
+#include <thread>
+
+namespace slonana {
+namespace banking {
+
+namespace {
+
+constexpr uint64_t NO_SLOT = UINT64_MAX;
+constexpr uint64_t RESETTING = UINT64_MAX - 1;
+constexpr uint64_t NO_PRICE = UINT64_MAX;
+
+/// 64-bit FNV-1a of the key bytes; 0 marks an empty table cell
+uint64_t account_key(const common::PublicKey &account) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (uint8_t byte : account) {
+    hash = (hash ^ byte) * 0x100000001b3ULL;
+  }
+  return hash != 0 ? hash : 1;
+}
+
+size_t first_cell(uint64_t key) {
+  return static_cast<size_t>((key * 0x9e3779b97f4a7c15ULL) >> 32) &
+         (PrioritizationFeeCache::ACCOUNTS_PER_SLOT - 1);
+}
+
+void store_min(std::atomic<uint64_t> &target, uint64_t value) {
+  uint64_t seen = target.load(std::memory_order_relaxed);
+  while (value < seen &&
+         !target.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace
+
+struct PrioritizationFeeCache::SlotEntry {
+  struct AccountFee {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> min_price{NO_PRICE};
+  };
+
+  std::atomic<uint64_t> slot{NO_SLOT};
+  std::atomic<uint64_t> min_price{NO_PRICE};
+  std::array<AccountFee, ACCOUNTS_PER_SLOT> accounts;
+
+  void reset() {
+    min_price.store(NO_PRICE, std::memory_order_relaxed);
+    for (auto &cell : accounts) {
+      cell.key.store(0, std::memory_order_relaxed);
+      cell.min_price.store(NO_PRICE, std::memory_order_relaxed);
+    }
+  }
+
+  const AccountFee *find(uint64_t key) const {
+    for (size_t probe = 0, i = first_cell(key); probe < ACCOUNTS_PER_SLOT;
+         ++probe, i = (i + 1) & (ACCOUNTS_PER_SLOT - 1)) {
+      uint64_t held = accounts[i].key.load(std::memory_order_acquire);
+      if (held == key) {
+        return &accounts[i];
+      }
+      if (held == 0) {
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+};
+
+PrioritizationFeeCache::PrioritizationFeeCache(size_t window)
+    : window_(std::max<size_t>(1, window)),
+      entries_(std::make_unique<SlotEntry[]>(window_)) {}
+
+PrioritizationFeeCache::~PrioritizationFeeCache() = default;
+
+PrioritizationFeeCache::SlotEntry *PrioritizationFeeCache::claim(uint64_t slot) {
+  auto &entry = entries_[slot % window_];
+  while (true) {
+    uint64_t held = entry.slot.load(std::memory_order_acquire);
+    if (held == slot) {
+      return &entry;
+    }
+    if (held == RESETTING) {
+      std::this_thread::yield(); // Another thread is opening this slot
+      continue;
+    }
+    if (held != NO_SLOT && held > slot) {
+      return nullptr; // A newer slot has taken the entry
+    }
+    if (entry.slot.compare_exchange_weak(held, RESETTING,
+                                         std::memory_order_acq_rel)) {
+      entry.reset();
+      entry.slot.store(slot, std::memory_order_release);
+      uint64_t newest = newest_slot_.load(std::memory_order_relaxed);
+      while (slot > newest &&
+             !newest_slot_.compare_exchange_weak(newest, slot,
+                                                 std::memory_order_relaxed)) {
+      }
+      return &entry;
+    }
+  }
+}
+
+void PrioritizationFeeCache::update(
+    uint64_t slot, uint64_t compute_unit_price,
+    const std::vector<common::PublicKey> &writable_accounts) {
+  if (slot >= RESETTING ||
+      slot + window_ <= newest_slot_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  SlotEntry *entry = claim(slot);
+  if (!entry) {
+    return;
+  }
+
+  store_min(entry->min_price, compute_unit_price);
+  for (const auto &account : writable_accounts) {
+    uint64_t key = account_key(account);
+    bool tracked = false;
+    for (size_t probe = 0, i = first_cell(key); probe < ACCOUNTS_PER_SLOT;
+         ++probe, i = (i + 1) & (ACCOUNTS_PER_SLOT - 1)) {
+      auto &cell = entry->accounts[i];
+      uint64_t held = cell.key.load(std::memory_order_acquire);
+      if (held == 0) {
+        cell.key.compare_exchange_strong(held, key, std::memory_order_acq_rel);
+        held = held == 0 ? key : held; // Claimed, or lost to `held`
+      }
+      if (held == key) {
+        store_min(cell.min_price, compute_unit_price);
+        tracked = true;
+        break;
+      }
+    }
+    if (!tracked) {
+      untracked_accounts_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::vector<PrioritizationFeeCache::SlotFee> PrioritizationFeeCache::get_recent_fees(
+    const std::vector<common::PublicKey> &accounts) const {
+  std::vector<uint64_t> keys;
+  keys.reserve(accounts.size());
+  for (const auto &account : accounts) {
+    keys.push_back(account_key(account));
+  }
+
+  uint64_t newest = newest_slot_.load(std::memory_order_relaxed);
+  std::vector<SlotFee> fees;
+  fees.reserve(window_);
+  for (size_t i = 0; i < window_; ++i) {
+    const auto &entry = entries_[i];
+    uint64_t slot = entry.slot.load(std::memory_order_acquire);
+    if (slot >= RESETTING || slot + window_ <= newest) {
+      continue;
+    }
+
+    uint64_t fee = entry.min_price.load(std::memory_order_relaxed);
+    if (fee == NO_PRICE) {
+      continue; // Opened but nothing recorded yet
+    }
+    for (uint64_t key : keys) {
+      if (const auto *cell = entry.find(key)) {
+        uint64_t local = cell->min_price.load(std::memory_order_relaxed);
+        if (local != NO_PRICE) {
+          fee = std::max(fee, local);
+        }
+      }
+    }
+
+    // Drop the reading if the entry was recycled meanwhile
+    if (entry.slot.load(std::memory_order_acquire) == slot) {
+      fees.push_back({slot, fee});
+    }
+  }
+
+  std::sort(fees.begin(), fees.end(),
+            [](const SlotFee &a, const SlotFee &b) { return a.slot < b.slot; });
+  return fees;
+}
+
+} // namespace banking
+} // namespace slonana
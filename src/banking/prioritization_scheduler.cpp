@@ -0,0 +1,496 @@
+#include "banking/prioritization_scheduler.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <unordered_set>
+
+namespace slonana {
+namespace banking {
+
+namespace {
+
+constexpr uint8_t SET_COMPUTE_UNIT_LIMIT = 2;
+constexpr uint8_t SET_COMPUTE_UNIT_PRICE = 3;
+constexpr uint8_t VERSIONED_MESSAGE_PREFIX = 0x80;
+
+bool read_compact_u16(const std::vector<uint8_t> &data, size_t &offset,
+                      size_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 21; shift += 7) {
+    if (offset >= data.size()) {
+      return false;
+    }
+    uint8_t byte = data[offset++];
+    value |= static_cast<size_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t read_le(const std::vector<uint8_t> &data, size_t offset,
+                 size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+  }
+  return value;
+}
+
+uint64_t thread_bit(size_t thread) { return uint64_t(1) << thread; }
+
+/// Consecutive transactions too big for the rest of the block before a
+/// pass gives up
+constexpr size_t BLOCK_FULL_STREAK = 128;
+
+} // namespace
+
+// SchedulableTransaction
+
+SchedulableTransaction
+SchedulableTransaction::from_transaction(TransactionPtr transaction) {
+  SchedulableTransaction result;
+  result.transaction = std::move(transaction);
+  if (!result.transaction) {
+    return result;
+  }
+
+  const auto &message = result.transaction->message;
+  size_t offset = 0;
+  if (!message.empty() && (message[0] & VERSIONED_MESSAGE_PREFIX)) {
+    ++offset; // v0: same layout up to the address table lookups
+  }
+  if (offset + 3 > message.size()) {
+    return result;
+  }
+  size_t required_signatures = message[offset];
+  size_t readonly_signed = message[offset + 1];
+  size_t readonly_unsigned = message[offset + 2];
+  offset += 3;
+
+  size_t key_count = 0;
+  if (!read_compact_u16(message, offset, key_count) ||
+      offset + key_count * 32 + 32 > message.size() ||
+      readonly_signed > required_signatures ||
+      required_signatures + readonly_unsigned > key_count) {
+    return result;
+  }
+  size_t keys_offset = offset;
+  offset += key_count * 32 + 32; // Keys, then the recent blockhash
+
+  // Instructions: program index, account indexes, data
+  size_t instruction_count = 0;
+  if (!read_compact_u16(message, offset, instruction_count)) {
+    return result;
+  }
+  bool has_limit = false;
+  uint64_t limit = 0;
+  uint64_t price = 0;
+  size_t charged_instructions = 0;
+  for (size_t i = 0; i < instruction_count; ++i) {
+    if (offset >= message.size()) {
+      return result;
+    }
+    size_t program_index = message[offset++];
+    size_t account_count = 0;
+    if (!read_compact_u16(message, offset, account_count) ||
+        offset + account_count > message.size()) {
+      return result;
+    }
+    offset += account_count;
+    size_t data_size = 0;
+    if (!read_compact_u16(message, offset, data_size) ||
+        offset + data_size > message.size() || program_index >= key_count) {
+      return result;
+    }
+
+    auto program = message.begin() + keys_offset + program_index * 32;
+    if (std::equal(COMPUTE_BUDGET_PROGRAM_ID.begin(),
+                   COMPUTE_BUDGET_PROGRAM_ID.end(), program)) {
+      if (data_size >= 5 && message[offset] == SET_COMPUTE_UNIT_LIMIT) {
+        has_limit = true;
+        limit = read_le(message, offset + 1, 4);
+      } else if (data_size >= 9 && message[offset] == SET_COMPUTE_UNIT_PRICE) {
+        price = read_le(message, offset + 1, 8);
+      }
+    } else {
+      ++charged_instructions;
+    }
+    offset += data_size;
+  }
+
+  for (size_t i = 0; i < key_count; ++i) {
+    auto key = message.begin() + keys_offset + i * 32;
+    bool writable = i < required_signatures
+                        ? i < required_signatures - readonly_signed
+                        : i < key_count - readonly_unsigned;
+    (writable ? result.writable_accounts : result.readonly_accounts)
+        .emplace_back(key, key + 32);
+  }
+
+  result.compute_unit_price = price;
+  result.compute_units = std::min(
+      MAX_COMPUTE_UNITS,
+      has_limit ? limit
+                : charged_instructions * DEFAULT_INSTRUCTION_COMPUTE_UNITS);
+  return result;
+}
+
+uint64_t SchedulableTransaction::priority_fee() const {
+  unsigned __int128 micro_lamports =
+      static_cast<unsigned __int128>(compute_unit_price) * compute_units;
+  unsigned __int128 lamports = (micro_lamports + 999999) / 1000000;
+  return lamports > std::numeric_limits<uint64_t>::max()
+             ? std::numeric_limits<uint64_t>::max()
+             : static_cast<uint64_t>(lamports);
+}
+
+// CostTracker
+
+CostTracker::Verdict
+CostTracker::check(const SchedulableTransaction &transaction) const {
+  uint64_t units = transaction.compute_units;
+  if (units > limits_.block_units - std::min(block_units_, limits_.block_units)) {
+    return Verdict::BLOCK_FULL;
+  }
+  for (const auto &account : transaction.writable_accounts) {
+    uint64_t used = account_units(account);
+    if (units > limits_.account_units - std::min(used, limits_.account_units)) {
+      return Verdict::ACCOUNT_FULL;
+    }
+  }
+  return Verdict::FITS;
+}
+
+void CostTracker::add(const SchedulableTransaction &transaction) {
+  block_units_ += transaction.compute_units;
+  for (const auto &account : transaction.writable_accounts) {
+    account_units_[account] += transaction.compute_units;
+  }
+}
+
+void CostTracker::remove(const SchedulableTransaction &transaction) {
+  uint64_t units = transaction.compute_units;
+  block_units_ -= std::min(block_units_, units);
+  for (const auto &account : transaction.writable_accounts) {
+    auto it = account_units_.find(account);
+    if (it == account_units_.end()) {
+      continue;
+    }
+    it->second -= std::min(it->second, units);
+    if (it->second == 0) {
+      account_units_.erase(it);
+    }
+  }
+}
+
+void CostTracker::reset() {
+  block_units_ = 0;
+  account_units_.clear();
+}
+
+uint64_t CostTracker::account_units(const PublicKey &account) const {
+  auto it = account_units_.find(account);
+  return it == account_units_.end() ? 0 : it->second;
+}
+
+// PrioritizationFeeScheduler
+
+/// Accounts locked by the batch being built for one thread
+struct PrioritizationFeeScheduler::BatchLocks {
+  std::unordered_set<PublicKey> writes;
+  std::unordered_set<PublicKey> reads;
+
+  bool conflicts(const SchedulableTransaction &transaction) const {
+    for (const auto &account : transaction.writable_accounts) {
+      if (writes.count(account) || reads.count(account)) {
+        return true;
+      }
+    }
+    for (const auto &account : transaction.readonly_accounts) {
+      if (writes.count(account)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void add(const SchedulableTransaction &transaction) {
+    writes.insert(transaction.writable_accounts.begin(),
+                  transaction.writable_accounts.end());
+    reads.insert(transaction.readonly_accounts.begin(),
+                 transaction.readonly_accounts.end());
+  }
+};
+
+/// One thread's part of a schedule() pass
+struct PrioritizationFeeScheduler::ThreadPass {
+  Batch batch; ///< Open batch; sealed ones are already in the result
+  BatchLocks locks;
+  size_t scheduled = 0;
+};
+
+PrioritizationFeeScheduler::PrioritizationFeeScheduler()
+    : PrioritizationFeeScheduler(Config{}) {}
+
+PrioritizationFeeScheduler::PrioritizationFeeScheduler(const Config &config)
+    : config_(config), cost_tracker_(config.limits) {
+  config_.worker_threads =
+      std::clamp<size_t>(config_.worker_threads, 1, MAX_THREADS);
+  config_.max_batch_size = std::max<size_t>(config_.max_batch_size, 1);
+  config_.max_pending = std::max<size_t>(config_.max_pending, 1);
+  in_flight_units_.assign(config_.worker_threads, 0);
+}
+
+bool PrioritizationFeeScheduler::submit(SchedulableTransaction transaction) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.received++;
+  transaction.id = next_id_++;
+  uint64_t id = transaction.id;
+  enqueue(std::move(transaction));
+
+  if (queue_.size() <= config_.max_pending) {
+    return true;
+  }
+  QueueEntry evicted = queue_.pop_min();
+  pending_.erase(evicted.id);
+  stats_.dropped++;
+  return evicted.id != id;
+}
+
+void PrioritizationFeeScheduler::enqueue(SchedulableTransaction transaction) {
+  queue_.push({transaction.compute_unit_price, transaction.id});
+  pending_[transaction.id] = std::move(transaction);
+}
+
+std::vector<PrioritizationFeeScheduler::Batch>
+PrioritizationFeeScheduler::schedule(size_t max_transactions) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  size_t threads = config_.worker_threads;
+  std::vector<ThreadPass> passes(threads);
+  std::vector<Batch> result;
+  std::vector<QueueEntry> deferred;
+  size_t capacity = std::min(threads * config_.max_batch_size, max_transactions);
+  size_t scheduled = 0;
+  size_t block_full_streak = 0;
+
+  for (size_t examined = 0; examined < config_.lookahead && !queue_.empty() &&
+                            scheduled < capacity;
+       ++examined) {
+    QueueEntry entry = queue_.pop_max();
+    auto it = pending_.find(entry.id);
+    auto &transaction = it->second;
+
+    auto verdict = cost_tracker_.check(transaction);
+    if (verdict != CostTracker::Verdict::FITS) {
+      deferred.push_back(entry);
+      stats_.deferred_cost++;
+      // Only small transactions could still fit; stop looking for them
+      if (verdict == CostTracker::Verdict::BLOCK_FULL &&
+          ++block_full_streak >= BLOCK_FULL_STREAK) {
+        break;
+      }
+      continue;
+    }
+    block_full_streak = 0;
+    uint64_t allowed = allowed_threads(transaction, passes);
+    if (allowed == 0) {
+      deferred.push_back(entry);
+      stats_.deferred_conflict++;
+      continue;
+    }
+
+    // Least loaded thread whose open batch takes it; failing that, the
+    // least loaded one starts a new batch behind its open one
+    size_t thread = NO_THREAD;
+    bool fits = false;
+    for (uint64_t mask = allowed; mask != 0; mask &= mask - 1) {
+      size_t candidate = static_cast<size_t>(std::countr_zero(mask));
+      bool candidate_fits = !passes[candidate].locks.conflicts(transaction);
+      if (thread == NO_THREAD || (candidate_fits && !fits) ||
+          (candidate_fits == fits &&
+           in_flight_units_[candidate] < in_flight_units_[thread])) {
+        thread = candidate;
+        fits = candidate_fits;
+      }
+    }
+    auto &pass = passes[thread];
+    if (!fits) {
+      pass.batch.thread = thread;
+      result.push_back(std::move(pass.batch));
+      pass.batch = Batch{};
+      pass.locks = BatchLocks{};
+    }
+
+    this->lock(transaction, thread);
+    pass.locks.add(transaction);
+    pass.scheduled++;
+    cost_tracker_.add(transaction);
+    in_flight_units_[thread] += transaction.compute_units;
+    in_flight_++;
+    pass.batch.transactions.push_back(std::move(transaction));
+    pending_.erase(it);
+    scheduled++;
+  }
+
+  for (const auto &entry : deferred) {
+    queue_.push(entry);
+  }
+  stats_.scheduled += scheduled;
+
+  for (size_t t = 0; t < threads; ++t) {
+    if (!passes[t].batch.transactions.empty()) {
+      passes[t].batch.thread = t;
+      result.push_back(std::move(passes[t].batch));
+    }
+  }
+  return result;
+}
+
+uint64_t PrioritizationFeeScheduler::allowed_threads(
+    const SchedulableTransaction &transaction,
+    const std::vector<ThreadPass> &passes) const {
+  size_t threads = config_.worker_threads;
+  uint64_t allowed =
+      threads == MAX_THREADS ? ~uint64_t(0) : thread_bit(threads) - 1;
+
+  // Locks in flight, including this pass: a write must follow every lock on
+  // the account, so all of them must be on one thread; a read only has to
+  // follow a writer
+  for (const auto &account : transaction.writable_accounts) {
+    auto it = locks_.find(account);
+    if (it == locks_.end()) {
+      continue;
+    }
+    uint64_t holders = 0;
+    if (it->second.writer != NO_THREAD) {
+      holders |= thread_bit(it->second.writer);
+    }
+    for (const auto &[thread, count] : it->second.readers) {
+      holders |= thread_bit(thread);
+    }
+    if (std::popcount(holders) > 1) {
+      return 0;
+    }
+    allowed &= holders;
+  }
+  for (const auto &account : transaction.readonly_accounts) {
+    auto it = locks_.find(account);
+    if (it != locks_.end() && it->second.writer != NO_THREAD) {
+      allowed &= thread_bit(it->second.writer);
+    }
+  }
+
+  // Threads that already took their share of this pass
+  for (uint64_t mask = allowed; mask != 0; mask &= mask - 1) {
+    size_t thread = static_cast<size_t>(std::countr_zero(mask));
+    if (passes[thread].scheduled >= config_.max_batch_size) {
+      allowed &= ~thread_bit(thread);
+    }
+  }
+  return allowed;
+}
+
+void PrioritizationFeeScheduler::lock(const SchedulableTransaction &transaction,
+                                      size_t thread) {
+  for (const auto &account : transaction.writable_accounts) {
+    auto &locks = locks_[account];
+    locks.writer = thread;
+    locks.writes++;
+  }
+  for (const auto &account : transaction.readonly_accounts) {
+    auto &readers = locks_[account].readers;
+    auto it = std::find_if(readers.begin(), readers.end(),
+                           [&](const auto &r) { return r.first == thread; });
+    if (it == readers.end()) {
+      readers.emplace_back(thread, 1);
+    } else {
+      it->second++;
+    }
+  }
+}
+
+void PrioritizationFeeScheduler::unlock(
+    const SchedulableTransaction &transaction, size_t thread) {
+  auto release_if_free = [this](auto it) {
+    if (it->second.writes == 0 && it->second.readers.empty()) {
+      locks_.erase(it);
+    }
+  };
+  for (const auto &account : transaction.writable_accounts) {
+    auto it = locks_.find(account);
+    if (it == locks_.end() || it->second.writes == 0) {
+      continue;
+    }
+    if (--it->second.writes == 0) {
+      it->second.writer = NO_THREAD;
+    }
+    release_if_free(it);
+  }
+  for (const auto &account : transaction.readonly_accounts) {
+    auto it = locks_.find(account);
+    if (it == locks_.end()) {
+      continue;
+    }
+    auto &readers = it->second.readers;
+    auto reader = std::find_if(readers.begin(), readers.end(),
+                               [&](const auto &r) { return r.first == thread; });
+    if (reader != readers.end() && --reader->second == 0) {
+      readers.erase(reader);
+    }
+    release_if_free(it);
+  }
+}
+
+void PrioritizationFeeScheduler::complete(const Batch &batch,
+                                          const std::vector<bool> &executed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t i = 0; i < batch.transactions.size(); ++i) {
+    const auto &transaction = batch.transactions[i];
+    unlock(transaction, batch.thread);
+    auto &units = in_flight_units_[batch.thread];
+    units -= std::min(units, transaction.compute_units);
+    in_flight_ -= std::min<size_t>(in_flight_, 1);
+
+    bool ran = executed.empty() || (i < executed.size() && executed[i]);
+    if (ran) {
+      stats_.completed++;
+    } else {
+      cost_tracker_.remove(transaction);
+      stats_.retried++;
+      enqueue(transaction); // Keeps its arrival order
+    }
+  }
+}
+
+void PrioritizationFeeScheduler::on_new_block() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cost_tracker_.reset();
+}
+
+size_t PrioritizationFeeScheduler::pending_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+size_t PrioritizationFeeScheduler::in_flight_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_flight_;
+}
+
+uint64_t PrioritizationFeeScheduler::block_units() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cost_tracker_.block_units();
+}
+
+PrioritizationFeeScheduler::Statistics
+PrioritizationFeeScheduler::get_statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+} // namespace banking
+} // namespace slonana
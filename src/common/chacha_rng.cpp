@@ -0,0 +1,124 @@
+#include "common/chacha_rng.h"
+
+namespace slonana {
+namespace common {
+
+namespace {
+
+inline uint32_t rotl(uint32_t v, int c) { return (v << c) | (v >> (32 - c)); }
+
+inline void quarter_round(uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d) {
+  a += b;
+  d = rotl(d ^ a, 16);
+  c += d;
+  b = rotl(b ^ c, 12);
+  a += b;
+  d = rotl(d ^ a, 8);
+  c += d;
+  b = rotl(b ^ c, 7);
+}
+
+uint32_t load_le32(const uint8_t *p) {
+  return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+         (static_cast<uint32_t>(p[2]) << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+} // namespace
+
+ChaChaRng::ChaChaRng(const Seed &seed) { reseed(seed); }
+
+ChaChaRng::ChaChaRng(uint64_t seed) : ChaChaRng(seed_from_u64(seed)) {}
+
+ChaChaRng::Seed ChaChaRng::seed_from_u64(uint64_t value) {
+  Seed seed{};
+  for (size_t i = 0; i < 8; ++i) {
+    seed[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  return seed;
+}
+
+void ChaChaRng::reseed(const Seed &seed) {
+  for (size_t i = 0; i < key_.size(); ++i) {
+    key_[i] = load_le32(seed.data() + 4 * i);
+  }
+  counter_ = 0;
+  index_ = block_.size(); // Generate on first use
+}
+
+void ChaChaRng::refill() {
+  // "expand 32-byte k", key, 64-bit block counter, 64-bit zero nonce
+  const std::array<uint32_t, 16> input = {
+      0x61707865,
+      0x3320646e,
+      0x79622d32,
+      0x6b206574,
+      key_[0],
+      key_[1],
+      key_[2],
+      key_[3],
+      key_[4],
+      key_[5],
+      key_[6],
+      key_[7],
+      static_cast<uint32_t>(counter_),
+      static_cast<uint32_t>(counter_ >> 32),
+      0,
+      0};
+  std::array<uint32_t, 16> x = input;
+  for (int round = 0; round < 10; ++round) {
+    quarter_round(x[0], x[4], x[8], x[12]);
+    quarter_round(x[1], x[5], x[9], x[13]);
+    quarter_round(x[2], x[6], x[10], x[14]);
+    quarter_round(x[3], x[7], x[11], x[15]);
+    quarter_round(x[0], x[5], x[10], x[15]);
+    quarter_round(x[1], x[6], x[11], x[12]);
+    quarter_round(x[2], x[7], x[8], x[13]);
+    quarter_round(x[3], x[4], x[9], x[14]);
+  }
+  for (size_t i = 0; i < block_.size(); ++i) {
+    block_[i] = x[i] + input[i];
+  }
+  ++counter_;
+  index_ = 0;
+}
+
+uint32_t ChaChaRng::next_u32() {
+  if (index_ >= block_.size()) {
+    refill();
+  }
+  return block_[index_++];
+}
+
+uint64_t ChaChaRng::next_u64() {
+  // Two consecutive words of the stream, low word first
+  uint64_t low = next_u32();
+  uint64_t high = next_u32();
+  return (high << 32) | low;
+}
+
+uint64_t ChaChaRng::gen_range(uint64_t bound) {
+  // Reject the sliver of the 128-bit product space that would bias results
+  uint64_t zone = (bound << __builtin_clzll(bound)) - 1;
+  while (true) {
+    unsigned __int128 product =
+        static_cast<unsigned __int128>(next_u64()) * bound;
+    if (static_cast<uint64_t>(product) <= zone) {
+      return static_cast<uint64_t>(product >> 64);
+    }
+  }
+}
+
+uint64_t ChaChaRng::sample_uniform(uint64_t bound) {
+  uint64_t zone = UINT64_MAX - (0 - bound) % bound;
+  while (true) {
+    unsigned __int128 product =
+        static_cast<unsigned __int128>(next_u64()) * bound;
+    if (static_cast<uint64_t>(product) <= zone) {
+      return static_cast<uint64_t>(product >> 64);
+    }
+  }
+}
+
+} // namespace common
+} // namespace slonana
@@ -11,8 +11,7 @@ namespace consensus {
 
 AdvancedForkChoice::AdvancedForkChoice(const Configuration &config)
     : config_(config), current_head_slot_(0), current_root_slot_(0),
-      last_weight_update_(std::chrono::steady_clock::now()),
-      stake_aggregation_dirty_(true) {
+      last_weight_update_(std::chrono::steady_clock::now()) {
 
   stats_.last_fork_switch = std::chrono::steady_clock::now();
   stats_.last_gc_run = std::chrono::steady_clock::now();
@@ -75,134 +74,142 @@ void AdvancedForkChoice::add_block(const Hash &block_hash,
     stats_.active_forks++;
   }
 
-  // Add block to pending confirmation tracking for event-driven processing
-  add_pending_confirmation_block(block_hash);
+  // Votes that arrived ahead of this block wait in the tree for its slot
+  auto early = early_votes_.find(block_hash);
+  if (early != early_votes_.end()) {
+    for (const auto &vote : early->second) {
+      if (vote.slot == slot) {
+        fork_tree_.add_vote(vote.validator_identity, vote.slot,
+                            vote.stake_weight);
+      }
+    }
+    early_votes_.erase(early);
+  }
 
-  // Mark stake aggregation as dirty since we added a new block
-  stake_aggregation_dirty_ = true;
+  // The first block becomes the tree root; later blocks need a known parent
+  Slot parent_slot = slot_of_unsafe(parent_hash);
+  if (fork_tree_.add_block(slot, parent_slot)) {
+    blocks_[block_hash]->stake_weight = fork_tree_.stake_voted_at(slot);
+    slot_hashes_[slot] = block_hash;
+    if (fork_tree_.root() == slot) {
+      current_root_ = block_hash;
+      current_root_slot_ = slot;
+    }
+  }
 
   // Update fork weights and head selection
   update_fork_weights();
 
-  std::cout << "Added block " << slot
-            << " to fork choice (active forks: " << forks_.size() << ")"
-            << std::endl;
+  if (commitment_callback_) {
+    commitment_callback_(slot, CommitmentEvent::PROCESSED);
+  }
+
+  // Votes that arrived ahead of the block count now
+  if (fork_tree_.stake_voted_at(slot) > 0) {
+    process_commitment_along(slot);
+  }
 }
 
 void AdvancedForkChoice::add_vote(const VoteInfo &vote) {
-  // First, add the vote data
-  {
-    std::lock_guard<std::mutex> vote_lock(vote_processing_mutex_);
-    std::unique_lock<std::shared_mutex> lock(data_mutex_);
-
-    // Add to recent votes with size limit
-    recent_votes_.push_back(vote);
-
-    // Cap recent_votes_ size to prevent unbounded growth
-    constexpr size_t MAX_RECENT_VOTES = 10000;
-    if (recent_votes_.size() > MAX_RECENT_VOTES) {
-      // Remove oldest votes (FIFO)
-      recent_votes_.erase(recent_votes_.begin(),
-                          recent_votes_.begin() +
-                              (recent_votes_.size() - MAX_RECENT_VOTES));
-    }
+  std::lock_guard<std::mutex> vote_lock(vote_processing_mutex_);
+  std::unique_lock<std::shared_mutex> lock(data_mutex_);
 
-    // Update validator stake
-    validator_stakes_[vote.validator_identity] = vote.stake_weight;
+  apply_vote_unsafe(vote);
+  update_fork_weights();
+}
 
-    // Mark stake aggregation as dirty since we added a new vote
-    stake_aggregation_dirty_ = true;
+void AdvancedForkChoice::process_votes_batch(
+    const std::vector<VoteInfo> &votes) {
+  std::lock_guard<std::mutex> vote_lock(vote_processing_mutex_);
+  std::unique_lock<std::shared_mutex> lock(data_mutex_);
 
-    // Update stake aggregation incrementally for efficiency
-    update_stake_aggregation_for_vote(vote);
+  for (const auto &vote : votes) {
+    apply_vote_unsafe(vote);
+  }
+  update_fork_weights();
+}
 
-    // Update block metadata if exists
-    auto block_it = blocks_.find(vote.block_hash);
-    if (block_it != blocks_.end()) {
-      auto &block_meta = block_it->second;
+void AdvancedForkChoice::apply_vote_unsafe(const VoteInfo &vote) {
+  stats_.total_votes++;
+  validator_stakes_[vote.validator_identity] = vote.stake_weight;
 
-      // Add validator to voting list if not already present
-      if (std::find(block_meta->validators_voted.begin(),
-                    block_meta->validators_voted.end(),
-                    vote.validator_identity) ==
-          block_meta->validators_voted.end()) {
-        block_meta->validators_voted.push_back(vote.validator_identity);
-        block_meta->stake_weight += vote.stake_weight;
-      }
+  // Only blocks the tree tracks carry stake; the hash must match its slot
+  auto block_it = blocks_.find(vote.block_hash);
+  if (block_it == blocks_.end()) {
+    // Held for the block, unless it could only land at or below the root
+    bool above_root = fork_tree_.empty() || vote.slot > current_root_slot_;
+    if (above_root && (early_votes_.size() < MAX_EARLY_VOTE_BLOCKS ||
+                       early_votes_.count(vote.block_hash))) {
+      early_votes_[vote.block_hash].push_back(vote);
     }
-
-    stats_.total_votes++;
+    return;
   }
-
-  // Now process optimistic confirmations and rooting without holding locks
-  if (config_.enable_optimistic_confirmation) {
-    process_pending_confirmations();
+  if (block_it->second->slot != vote.slot) {
+    return;
   }
-
-  if (config_.enable_aggressive_rooting) {
-    process_rooting_candidates();
+  if (!fork_tree_.add_vote(vote.validator_identity, vote.slot,
+                           vote.stake_weight)) {
+    return; // Not newer than the validator's latest vote
   }
+  block_it->second->stake_weight = fork_tree_.stake_voted_at(vote.slot);
 
-  // Update fork weights
-  update_fork_weights();
-
-  std::cout << "Processed vote for slot " << vote.slot
-            << " (stake: " << vote.stake_weight << ")" << std::endl;
+  process_commitment_along(vote.slot);
 }
 
-void AdvancedForkChoice::process_votes_batch(
-    const std::vector<VoteInfo> &votes) {
-  // First, add all vote data
-  {
-    std::lock_guard<std::mutex> vote_lock(vote_processing_mutex_);
-    std::unique_lock<std::shared_mutex> lock(data_mutex_);
-
-    // Process all votes
-    for (const auto &vote : votes) {
-      recent_votes_.push_back(vote);
-      validator_stakes_[vote.validator_identity] = vote.stake_weight;
-
-      // Mark stake aggregation as dirty and update incrementally
-      stake_aggregation_dirty_ = true;
-      update_stake_aggregation_for_vote(vote);
-
-      auto block_it = blocks_.find(vote.block_hash);
-      if (block_it != blocks_.end()) {
-        auto &block_meta = block_it->second;
-        if (std::find(block_meta->validators_voted.begin(),
-                      block_meta->validators_voted.end(),
-                      vote.validator_identity) ==
-            block_meta->validators_voted.end()) {
-          block_meta->validators_voted.push_back(vote.validator_identity);
-          block_meta->stake_weight += vote.stake_weight;
-        }
-      }
+void AdvancedForkChoice::process_commitment_along(Slot slot) {
+  // Subtree stake only grows toward the root, so the first already
+  // confirmed ancestor ends the walk
+  uint64_t confirm_stake =
+      (config_.total_stake * config_.optimistic_confirmation_threshold) / 100;
+  uint64_t root_stake =
+      (config_.total_stake * config_.rooting_threshold) / 100;
 
-      stats_.total_votes++;
+  Slot new_root = HeaviestSubtreeForkChoice::NO_SLOT;
+  for (Slot at = slot; at != HeaviestSubtreeForkChoice::NO_SLOT;
+       at = fork_tree_.parent(at)) {
+    uint64_t stake = fork_tree_.stake_voted_subtree(at);
+    if (config_.enable_aggressive_rooting &&
+        new_root == HeaviestSubtreeForkChoice::NO_SLOT && stake >= root_stake &&
+        at > current_root_slot_) {
+      new_root = at; // Deepest block with rooting stake
     }
-
-    // Cap recent_votes_ size to prevent unbounded growth
-    constexpr size_t MAX_RECENT_VOTES = 10000;
-    if (recent_votes_.size() > MAX_RECENT_VOTES) {
-      // Remove oldest votes (FIFO)
-      recent_votes_.erase(recent_votes_.begin(),
-                          recent_votes_.begin() +
-                              (recent_votes_.size() - MAX_RECENT_VOTES));
+    if (!config_.enable_optimistic_confirmation || stake < confirm_stake) {
+      continue;
+    }
+    auto hash_it = slot_hashes_.find(at);
+    if (hash_it == slot_hashes_.end()) {
+      continue;
     }
+    auto block_it = blocks_.find(hash_it->second);
+    if (block_it == blocks_.end()) {
+      continue;
+    }
+    if (block_it->second->is_confirmed) {
+      break;
+    }
+    confirm_block_unsafe(*block_it->second);
   }
 
-  // Now batch update operations without holding locks
-  if (config_.enable_optimistic_confirmation) {
-    process_pending_confirmations();
+  if (new_root != HeaviestSubtreeForkChoice::NO_SLOT) {
+    auto hash_it = slot_hashes_.find(new_root);
+    if (hash_it != slot_hashes_.end()) {
+      root_block_unsafe(hash_it->second);
+    }
   }
+}
 
-  if (config_.enable_aggressive_rooting) {
-    process_rooting_candidates();
+void AdvancedForkChoice::confirm_block_unsafe(BlockMetadata &block) {
+  block.is_confirmed = true;
+  stats_.optimistic_confirmations++;
+  if (commitment_callback_) {
+    commitment_callback_(block.slot, CommitmentEvent::CONFIRMED);
   }
 
-  update_fork_weights();
-
-  std::cout << "Processed batch of " << votes.size() << " votes" << std::endl;
+  // Mark fork as optimistically confirmed
+  auto fork_it = block_to_fork_map_.find(block.block_hash);
+  if (fork_it != block_to_fork_map_.end()) {
+    fork_it->second->is_optimistically_confirmed = true;
+  }
 }
 
 Hash AdvancedForkChoice::get_head() const {
@@ -239,24 +246,7 @@ std::vector<Fork> AdvancedForkChoice::get_active_forks() const {
 bool AdvancedForkChoice::is_ancestor(const Hash &potential_ancestor,
                                      const Hash &descendant) const {
   std::shared_lock<std::shared_mutex> lock(data_mutex_);
-
-  // Start from descendant and walk up the chain
-  Hash current = descendant;
-
-  while (!current.empty()) {
-    if (current == potential_ancestor) {
-      return true;
-    }
-
-    auto block_it = blocks_.find(current);
-    if (block_it == blocks_.end()) {
-      break;
-    }
-
-    current = block_it->second->parent_hash;
-  }
-
-  return false;
+  return is_ancestor_unsafe(potential_ancestor, descendant);
 }
 
 bool AdvancedForkChoice::is_optimistically_confirmed(
@@ -267,9 +257,12 @@ bool AdvancedForkChoice::is_optimistically_confirmed(
   if (block_it == blocks_.end()) {
     return false;
   }
+  if (block_it->second->is_confirmed) {
+    return true; // Stays confirmed after its ancestors are pruned at a root
+  }
 
   // Check if block meets optimistic confirmation threshold
-  uint64_t supporting_stake = count_stake_supporting_block(block_hash);
+  uint64_t supporting_stake = count_stake_supporting_block_unsafe(block_hash);
   uint64_t threshold_stake =
       (config_.total_stake * config_.optimistic_confirmation_threshold) / 100;
 
@@ -279,12 +272,8 @@ bool AdvancedForkChoice::is_optimistically_confirmed(
 uint64_t AdvancedForkChoice::get_stake_weight(const Hash &block_hash) const {
   std::shared_lock<std::shared_mutex> lock(data_mutex_);
 
-  auto block_it = blocks_.find(block_hash);
-  if (block_it != blocks_.end()) {
-    return block_it->second->stake_weight;
-  }
-
-  return 0;
+  // Stake of latest votes on the block and its descendants
+  return count_stake_supporting_block_unsafe(block_hash);
 }
 
 bool AdvancedForkChoice::try_optimistic_confirmation(const Hash &block_hash) {
@@ -296,11 +285,9 @@ bool AdvancedForkChoice::try_optimistic_confirmation(const Hash &block_hash) {
 
   auto block_it = blocks_.find(block_hash);
   if (block_it != blocks_.end()) {
-    block_it->second->is_confirmed = true;
-    stats_.optimistic_confirmations++;
-
-    std::cout << "Block optimistically confirmed: " << block_it->second->slot
-              << std::endl;
+    if (!block_it->second->is_confirmed) {
+      confirm_block_unsafe(*block_it->second);
+    }
     return true;
   }
 
@@ -308,105 +295,29 @@ bool AdvancedForkChoice::try_optimistic_confirmation(const Hash &block_hash) {
 }
 
 void AdvancedForkChoice::update_fork_weights() {
-  // Thread-safe weight update using instance members
-  std::lock_guard<std::mutex> weights_lock(fork_weights_mutex_);
-  auto now = std::chrono::steady_clock::now();
-
-  // Only recalculate if significant time has passed (rate limiting)
-  if (std::chrono::duration_cast<std::chrono::milliseconds>(now -
-                                                            last_weight_update_)
-          .count() < 100) {
+  // The tree keeps the heaviest leaf current; nothing to recompute
+  Slot best = fork_tree_.best_slot();
+  if (best == HeaviestSubtreeForkChoice::NO_SLOT) {
     return;
   }
-  last_weight_update_ = now;
-
-  // Find the best fork based on stake weight and other criteria
-  Fork *best_fork = find_best_fork();
-
-  if (best_fork && best_fork->head_hash != current_head_) {
-    // Fork switch detected
-    Hash old_head = current_head_;
-    Slot old_slot = current_head_slot_;
-
-    current_head_ = best_fork->head_hash;
-    current_head_slot_ = best_fork->head_slot;
-
-    stats_.fork_switches++;
-    stats_.last_fork_switch = std::chrono::steady_clock::now();
-
-    std::cout << "Fork switch: " << old_slot << " -> " << current_head_slot_
-              << " (weight: " << best_fork->stake_weight << ")" << std::endl;
-  }
-}
-
-Fork *AdvancedForkChoice::find_best_fork() const {
-  Fork *best_fork = nullptr;
-  uint64_t best_weight = 0;
-
-  for (const auto &[hash, fork] : forks_) {
-    uint64_t weight = calculate_fork_weight(*fork);
-
-    if (weight > best_weight) {
-      best_weight = weight;
-      best_fork = fork.get();
-    }
-  }
-
-  return best_fork;
-}
-
-uint64_t AdvancedForkChoice::calculate_fork_weight(const Fork &fork) const {
-  // Thread-safe weight caching with LRU eviction
-  std::lock_guard<std::mutex> cache_lock(weight_cache_mutex_);
-  auto now = std::chrono::steady_clock::now();
-
-  auto cache_it = weight_cache_.find(fork.head_hash);
-  if (cache_it != weight_cache_.end()) {
-    auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - cache_it->second.second);
-    if (age.count() < 500) { // 500ms cache validity
-      // Update LRU order - move to front
-      update_weight_cache_lru(fork.head_hash);
-      return cache_it->second.first;
-    }
-  }
-
-  uint64_t weight = 0;
-
-  // Base weight from slot height
-  weight += fork.head_slot * 1000;
-
-  // Add stake weight only from head block (most recent)
-  if (!fork.blocks.empty()) {
-    auto block_it = blocks_.find(fork.head_hash);
-    if (block_it != blocks_.end()) {
-      weight += block_it->second->stake_weight;
-    }
+  auto hash_it = slot_hashes_.find(best);
+  if (hash_it == slot_hashes_.end() || hash_it->second == current_head_) {
+    return;
   }
 
-  // Bonus for optimistic confirmation
-  if (fork.is_optimistically_confirmed) {
-    weight += 50000; // Significant bonus
-  }
+  bool had_head = !current_head_.empty();
+  current_head_ = hash_it->second;
+  current_head_slot_ = best;
 
-  // Bonus for being rooted
-  if (fork.is_rooted) {
-    weight += 100000; // Even higher bonus
+  auto fork_it = block_to_fork_map_.find(current_head_);
+  if (fork_it != block_to_fork_map_.end()) {
+    fork_it->second->stake_weight = fork_tree_.stake_voted_subtree(best);
   }
 
-  // Bonus for confirmation count
-  weight += fork.confirmation_count * 1000;
-
-  // Cache the result and update LRU
-  weight_cache_[fork.head_hash] = {weight, now};
-  update_weight_cache_lru(fork.head_hash);
-
-  // Check if we need to evict old entries
-  if (weight_cache_.size() > config_.max_cache_entries) {
-    evict_weight_cache_lru();
+  if (had_head) {
+    stats_.fork_switches++;
+    stats_.last_fork_switch = std::chrono::steady_clock::now();
   }
-
-  return weight;
 }
 
 bool AdvancedForkChoice::check_optimistic_confirmation_conditions(
@@ -418,46 +329,6 @@ bool AdvancedForkChoice::check_optimistic_confirmation_conditions(
   return supporting_stake >= threshold_stake;
 }
 
-void AdvancedForkChoice::process_optimistic_confirmations() {
-  std::unique_lock<std::shared_mutex> lock(data_mutex_);
-
-  for (const auto &[hash, block] : blocks_) {
-    if (!block->is_confirmed &&
-        check_optimistic_confirmation_conditions(hash)) {
-      block->is_confirmed = true;
-      stats_.optimistic_confirmations++;
-
-      // Mark fork as optimistically confirmed
-      for (auto &[fork_hash, fork] : forks_) {
-        if (std::find(fork->blocks.begin(), fork->blocks.end(), hash) !=
-            fork->blocks.end()) {
-          fork->is_optimistically_confirmed = true;
-          break;
-        }
-      }
-    }
-  }
-}
-
-void AdvancedForkChoice::process_rooting_candidates() {
-  std::vector<Hash> candidates_to_root;
-
-  // First, collect candidates under lock
-  {
-    std::shared_lock<std::shared_mutex> lock(data_mutex_);
-    for (const auto &[hash, block] : blocks_) {
-      if (!block->is_confirmed && check_rooting_conditions(hash)) {
-        candidates_to_root.push_back(hash);
-      }
-    }
-  }
-
-  // Then process candidates without holding lock to avoid deadlock
-  for (const Hash &candidate : candidates_to_root) {
-    try_root_block(candidate);
-  }
-}
-
 bool AdvancedForkChoice::check_rooting_conditions(
     const Hash &block_hash) const {
   // Check if block meets rooting threshold
@@ -469,32 +340,60 @@ bool AdvancedForkChoice::check_rooting_conditions(
 }
 
 bool AdvancedForkChoice::try_root_block(const Hash &block_hash) {
+  std::unique_lock<std::shared_mutex> lock(data_mutex_);
+  if (!check_rooting_conditions(block_hash)) {
+    return false;
+  }
+  bool rooted = root_block_unsafe(block_hash);
+  update_fork_weights();
+  return rooted;
+}
+
+bool AdvancedForkChoice::root_block_unsafe(const Hash &block_hash) {
   auto block_it = blocks_.find(block_hash);
-  if (block_it == blocks_.end()) {
+  if (block_it == blocks_.end() ||
+      !fork_tree_.contains(block_it->second->slot)) {
     return false;
   }
 
-  if (check_rooting_conditions(block_hash)) {
-    current_root_ = block_hash;
-    current_root_slot_ = block_it->second->slot;
-    stats_.rooted_slots++;
+  Slot slot = block_it->second->slot;
+  current_root_ = block_hash;
+  current_root_slot_ = slot;
+  stats_.rooted_slots++;
 
-    // Mark fork as rooted
-    for (auto &[fork_hash, fork] : forks_) {
-      if (std::find(fork->blocks.begin(), fork->blocks.end(), block_hash) !=
-          fork->blocks.end()) {
-        fork->is_rooted = true;
-        fork->root_hash = block_hash;
-        fork->root_slot = block_it->second->slot;
-        break;
-      }
+  // Slots off the rooted fork leave the tree
+  std::vector<Slot> abandoned = fork_tree_.set_root(slot);
+  for (auto it = slot_hashes_.begin(); it != slot_hashes_.end();) {
+    it = fork_tree_.contains(it->first) ? std::next(it) : slot_hashes_.erase(it);
+  }
+  for (auto it = early_votes_.begin(); it != early_votes_.end();) {
+    auto &votes = it->second;
+    votes.erase(std::remove_if(votes.begin(), votes.end(),
+                               [slot](const VoteInfo &vote) {
+                                 return vote.slot <= slot;
+                               }),
+                votes.end());
+    it = votes.empty() ? early_votes_.erase(it) : std::next(it);
+  }
+
+  if (commitment_callback_) {
+    // Dead forks are reported first so their writes never reach the
+    // finalization that follows
+    for (Slot dead : abandoned) {
+      commitment_callback_(dead, CommitmentEvent::DEAD);
     }
+    commitment_callback_(slot, CommitmentEvent::ROOTED);
+  }
 
-    std::cout << "Block rooted: " << block_it->second->slot << std::endl;
-    return true;
+  // Mark fork as rooted
+  auto fork_it = block_to_fork_map_.find(block_hash);
+  if (fork_it != block_to_fork_map_.end()) {
+    fork_it->second->is_rooted = true;
+    fork_it->second->root_hash = block_hash;
+    fork_it->second->root_slot = slot;
   }
 
-  return false;
+  return true;
 }
 
 uint64_t
@@ -505,75 +404,54 @@ AdvancedForkChoice::count_stake_supporting_block(const Hash &block_hash) const {
 
 uint64_t AdvancedForkChoice::count_stake_supporting_block_unsafe(
     const Hash &block_hash) const {
-  // Use stake aggregation for efficient stake counting
-  if (stake_aggregation_dirty_) {
-    rebuild_stake_aggregation();
-    stake_aggregation_dirty_ = false;
+  Slot slot = slot_of_unsafe(block_hash);
+  if (slot == HeaviestSubtreeForkChoice::NO_SLOT) {
+    return 0;
   }
-
-  auto agg_it = block_stake_aggregation_.find(block_hash);
-  if (agg_it != block_stake_aggregation_.end()) {
-    return agg_it->second;
-  }
-
-  // Fallback to traditional counting for new blocks not in aggregation
-  uint64_t total_stake = 0;
-
-  // Count stake from votes for this block and its descendants
-  for (const auto &vote : recent_votes_) {
-    if (vote.block_hash == block_hash ||
-        is_ancestor_unsafe(block_hash, vote.block_hash)) {
-      total_stake += vote.stake_weight;
-    }
+  auto hash_it = slot_hashes_.find(slot);
+  if (hash_it == slot_hashes_.end() || hash_it->second != block_hash) {
+    return 0; // Not the block the tree tracks for this slot
   }
-
-  return total_stake;
+  return fork_tree_.stake_voted_subtree(slot);
 }
 
 bool AdvancedForkChoice::is_ancestor_unsafe(const Hash &potential_ancestor,
                                             const Hash &descendant) const {
-  // Start from descendant and walk up the chain
-  Hash current = descendant;
-
-  while (!current.empty()) {
-    if (current == potential_ancestor) {
-      return true;
-    }
-
-    auto block_it = blocks_.find(current);
-    if (block_it == blocks_.end()) {
-      break;
-    }
-
-    current = block_it->second->parent_hash;
+  if (potential_ancestor == descendant) {
+    return blocks_.count(descendant) > 0;
+  }
+  Slot ancestor_slot = slot_of_unsafe(potential_ancestor);
+  Slot descendant_slot = slot_of_unsafe(descendant);
+  if (ancestor_slot == HeaviestSubtreeForkChoice::NO_SLOT ||
+      descendant_slot == HeaviestSubtreeForkChoice::NO_SLOT) {
+    return false;
+  }
+  // Slot-indexed parent walk; the hashes must be the tracked blocks
+  auto ancestor_it = slot_hashes_.find(ancestor_slot);
+  auto descendant_it = slot_hashes_.find(descendant_slot);
+  if (ancestor_it == slot_hashes_.end() ||
+      ancestor_it->second != potential_ancestor ||
+      descendant_it == slot_hashes_.end() ||
+      descendant_it->second != descendant) {
+    return false;
   }
+  return fork_tree_.is_ancestor(ancestor_slot, descendant_slot);
+}
 
-  return false;
+Slot AdvancedForkChoice::slot_of_unsafe(const Hash &block_hash) const {
+  auto block_it = blocks_.find(block_hash);
+  return block_it != blocks_.end() ? block_it->second->slot
+                                   : HeaviestSubtreeForkChoice::NO_SLOT;
 }
 
 void AdvancedForkChoice::garbage_collect() {
   std::unique_lock<std::shared_mutex> lock(data_mutex_);
 
-  cleanup_expired_votes();
   prune_old_blocks();
   cleanup_old_forks();
 
   stats_.gc_runs++;
   stats_.last_gc_run = std::chrono::steady_clock::now();
-
-  std::cout << "Garbage collection completed (active forks: " << forks_.size()
-            << ", blocks: " << blocks_.size() << ")" << std::endl;
-}
-
-void AdvancedForkChoice::cleanup_expired_votes() {
-  auto now = std::chrono::steady_clock::now();
-  auto cutoff = now - std::chrono::hours(1); // Keep votes for 1 hour
-
-  recent_votes_.erase(std::remove_if(recent_votes_.begin(), recent_votes_.end(),
-                                     [cutoff](const VoteInfo &vote) {
-                                       return vote.timestamp < cutoff;
-                                     }),
-                      recent_votes_.end());
 }
 
 void AdvancedForkChoice::prune_old_blocks() {
@@ -642,6 +520,12 @@ AdvancedForkChoice::Statistics AdvancedForkChoice::get_statistics() const {
   return current_stats;
 }
 
+void AdvancedForkChoice::set_commitment_callback(
+    CommitmentCallback callback) {
+  std::unique_lock<std::shared_mutex> lock(data_mutex_);
+  commitment_callback_ = std::move(callback);
+}
+
 void AdvancedForkChoice::print_fork_tree() const {
   std::shared_lock<std::shared_mutex> lock(data_mutex_);
 
@@ -744,98 +628,5 @@ void AdvancedForkChoice::evict_weight_cache_lru() const {
   weight_cache_.erase(lru_hash);
 }
 
-// Event-driven confirmation implementation
-void AdvancedForkChoice::add_pending_confirmation_block(
-    const Hash &block_hash) {
-  // Add block to pending confirmation set (already under data_mutex_)
-  pending_confirmation_blocks_.insert(block_hash);
-}
-
-void AdvancedForkChoice::process_pending_confirmations() {
-  std::unique_lock<std::shared_mutex> lock(data_mutex_);
-
-  // Process only blocks that need confirmation check
-  auto it = pending_confirmation_blocks_.begin();
-  while (it != pending_confirmation_blocks_.end()) {
-    const Hash &block_hash = *it;
-    auto block_it = blocks_.find(block_hash);
-
-    if (block_it != blocks_.end() && !block_it->second->is_confirmed) {
-      if (check_optimistic_confirmation_conditions(block_hash)) {
-        block_it->second->is_confirmed = true;
-        stats_.optimistic_confirmations++;
-
-        // Mark fork as optimistically confirmed
-        for (auto &[fork_hash, fork] : forks_) {
-          if (std::find(fork->blocks.begin(), fork->blocks.end(), block_hash) !=
-              fork->blocks.end()) {
-            fork->is_optimistically_confirmed = true;
-            break;
-          }
-        }
-
-        std::cout << "Block optimistically confirmed: "
-                  << block_it->second->slot << std::endl;
-      }
-    }
-
-    // Remove from pending set if confirmed or no longer exists
-    if (block_it == blocks_.end() || block_it->second->is_confirmed) {
-      it = pending_confirmation_blocks_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-}
-
-// Stake aggregation implementation
-void AdvancedForkChoice::rebuild_stake_aggregation() const {
-  block_stake_aggregation_.clear();
-
-  // Aggregate stake for each block from all recent votes
-  for (const auto &vote : recent_votes_) {
-    // Add stake for the voted block
-    block_stake_aggregation_[vote.block_hash] += vote.stake_weight;
-
-    // Also add stake for all ancestors (blocks this vote supports)
-    Hash current = vote.block_hash;
-    while (!current.empty()) {
-      auto block_it = blocks_.find(current);
-      if (block_it == blocks_.end()) {
-        break;
-      }
-
-      Hash parent = block_it->second->parent_hash;
-      if (!parent.empty()) {
-        block_stake_aggregation_[parent] += vote.stake_weight;
-      }
-      current = parent;
-    }
-  }
-}
-
-void AdvancedForkChoice::update_stake_aggregation_for_vote(
-    const VoteInfo &vote) const {
-  if (!stake_aggregation_dirty_) {
-    // Incrementally update aggregation for this vote
-    block_stake_aggregation_[vote.block_hash] += vote.stake_weight;
-
-    // Also update stake for all ancestors
-    Hash current = vote.block_hash;
-    while (!current.empty()) {
-      auto block_it = blocks_.find(current);
-      if (block_it == blocks_.end()) {
-        break;
-      }
-
-      Hash parent = block_it->second->parent_hash;
-      if (!parent.empty()) {
-        block_stake_aggregation_[parent] += vote.stake_weight;
-      }
-      current = parent;
-    }
-  }
-}
-
 } // namespace consensus
 } // namespace slonana
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "consensus/heaviest_subtree_fork_choice.h"
+#include <algorithm>
+
+namespace slonana {
+namespace consensus {
+
+HeaviestSubtreeForkChoice::Node *HeaviestSubtreeForkChoice::node(Slot slot) {
+  if (root_ == NO_SLOT || slot < root_ || slot - root_ >= nodes_.size()) {
+    return nullptr;
+  }
+  Node &n = nodes_[slot - root_];
+  return n.present ? &n : nullptr;
+}
+
+const HeaviestSubtreeForkChoice::Node *
+HeaviestSubtreeForkChoice::node(Slot slot) const {
+  return const_cast<HeaviestSubtreeForkChoice *>(this)->node(slot);
+}
+
+bool HeaviestSubtreeForkChoice::add_block(Slot slot, Slot parent) {
+  if (root_ == NO_SLOT) {
+    root_ = slot;
+    nodes_.assign(1, Node{});
+  } else {
+    Node *parent_node = node(parent);
+    if (!parent_node || slot <= parent || node(slot)) {
+      return false;
+    }
+    if (slot - root_ >= nodes_.size()) {
+      nodes_.resize(slot - root_ + 1);
+    }
+    parent_node->children.push_back(slot);
+    nodes_[slot - root_].parent = parent;
+  }
+
+  Node &added = nodes_[slot - root_];
+  added.present = true;
+  added.best = slot;
+  ++size_;
+
+  // Votes that arrived before the block
+  uint64_t pending_stake = 0;
+  auto pending = pending_votes_.find(slot);
+  if (pending != pending_votes_.end()) {
+    for (const auto &validator : pending->second) {
+      auto vote = latest_votes_.find(validator);
+      if (vote != latest_votes_.end() && vote->second.slot == slot &&
+          !vote->second.applied) {
+        vote->second.applied = true;
+        pending_stake += vote->second.stake;
+      }
+    }
+    pending_votes_.erase(pending);
+  }
+  // Even with no stake the new leaf may become its ancestors' best
+  apply_stake(slot, pending_stake, true);
+  return true;
+}
+
+bool HeaviestSubtreeForkChoice::add_vote(const PublicKey &validator, Slot slot,
+                                         uint64_t stake) {
+  auto &latest = latest_votes_[validator];
+  if (latest.slot != NO_SLOT && slot <= latest.slot) {
+    return false;
+  }
+
+  bool present = node(slot) != nullptr;
+  if (latest.applied && present && latest.stake == stake) {
+    move_stake(latest.slot, slot, stake);
+    latest.slot = slot;
+    return true;
+  }
+
+  if (latest.applied) {
+    apply_stake(latest.slot, latest.stake, false);
+  }
+  latest.slot = slot;
+  latest.stake = stake;
+  latest.applied = false;
+
+  if (present) {
+    apply_stake(slot, stake, true);
+    latest.applied = true;
+  } else if (root_ == NO_SLOT || slot > root_) {
+    pending_votes_[slot].push_back(validator);
+  }
+  return true;
+}
+
+void HeaviestSubtreeForkChoice::apply_stake(Slot slot, uint64_t stake,
+                                            bool add) {
+  Node *current = node(slot);
+  if (!current) {
+    return;
+  }
+  if (add) {
+    current->stake_voted_at += stake;
+  } else {
+    current->stake_voted_at -= stake;
+  }
+
+  if (stake == 0) {
+    propagate_best(slot);
+    return;
+  }
+
+  // Bottom-up: a node's children are final before its best is refreshed
+  Slot at = slot;
+  while (current) {
+    if (add) {
+      current->stake_voted_subtree += stake;
+    } else {
+      current->stake_voted_subtree -= stake;
+    }
+    refresh_best(*current, at);
+    at = current->parent;
+    current = at == NO_SLOT ? nullptr : node(at);
+  }
+}
+
+void HeaviestSubtreeForkChoice::move_stake(Slot from, Slot to,
+                                           uint64_t stake) {
+  node(from)->stake_voted_at -= stake;
+  node(to)->stake_voted_at += stake;
+
+  // Below the common ancestor one path loses the stake and the other gains
+  // it; walking the higher slot first keeps the refresh bottom-up
+  while (from != to) {
+    if (from > to) {
+      Node *n = node(from);
+      n->stake_voted_subtree -= stake;
+      refresh_best(*n, from);
+      from = n->parent;
+    } else {
+      Node *n = node(to);
+      n->stake_voted_subtree += stake;
+      refresh_best(*n, to);
+      to = n->parent;
+    }
+  }
+  // Subtree stake is unchanged from here up; only best can still move
+  propagate_best(to);
+}
+
+void HeaviestSubtreeForkChoice::propagate_best(Slot slot) {
+  for (Node *n = node(slot); n;) {
+    Slot previous = n->best;
+    refresh_best(*n, slot);
+    if (n->best == previous && !n->children.empty()) {
+      break; // Ancestors only see this node's best and stake
+    }
+    slot = n->parent;
+    n = slot == NO_SLOT ? nullptr : node(slot);
+  }
+}
+
+void HeaviestSubtreeForkChoice::refresh_best(Node &n, Slot slot) {
+  // Heaviest child wins; ties go to the lower slot
+  const Node *best_child = nullptr;
+  Slot best_child_slot = NO_SLOT;
+  for (Slot child : n.children) {
+    const Node *c = node(child);
+    if (!c) {
+      continue;
+    }
+    if (!best_child || c->stake_voted_subtree > best_child->stake_voted_subtree ||
+        (c->stake_voted_subtree == best_child->stake_voted_subtree &&
+         child < best_child_slot)) {
+      best_child = c;
+      best_child_slot = child;
+    }
+  }
+  n.best = best_child ? best_child->best : slot;
+}
+
+std::vector<Slot> HeaviestSubtreeForkChoice::set_root(Slot root) {
+  std::vector<Slot> abandoned;
+  if (root == root_ || !node(root)) {
+    return abandoned;
+  }
+
+  // Ancestors of the new root are finalized with it, every other pruned
+  // slot sat on a fork that can no longer win
+  std::vector<bool> on_path(root - root_, false);
+  for (Slot at = parent(root); at != NO_SLOT; at = parent(at)) {
+    on_path[at - root_] = true;
+  }
+  for (Slot at = root_; at < root; ++at) {
+    if (nodes_[at - root_].present && !on_path[at - root_]) {
+      abandoned.push_back(at);
+    }
+  }
+
+  // Keep the new root's subtree; everything else goes
+  std::vector<bool> keep(nodes_.size() - (root - root_), false);
+  std::vector<Slot> stack = {root};
+  while (!stack.empty()) {
+    Slot slot = stack.back();
+    stack.pop_back();
+    keep[slot - root] = true;
+    for (Slot child : node(slot)->children) {
+      stack.push_back(child);
+    }
+  }
+  nodes_.erase(nodes_.begin(), nodes_.begin() + (root - root_));
+  root_ = root;
+  size_ = 0;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (!keep[i]) {
+      if (nodes_[i].present) {
+        abandoned.push_back(root + i);
+      }
+      nodes_[i] = Node{};
+    } else {
+      ++size_;
+    }
+  }
+  nodes_.front().parent = NO_SLOT;
+  while (!nodes_.empty() && !nodes_.back().present) {
+    nodes_.pop_back();
+  }
+
+  // Votes on pruned slots no longer count toward anything
+  for (auto &[validator, vote] : latest_votes_) {
+    if (vote.applied && !node(vote.slot)) {
+      vote.applied = false;
+    }
+  }
+  for (auto it = pending_votes_.begin(); it != pending_votes_.end();) {
+    it = it->first <= root ? pending_votes_.erase(it) : std::next(it);
+  }
+  return abandoned;
+}
+
+bool HeaviestSubtreeForkChoice::contains(Slot slot) const {
+  return node(slot) != nullptr;
+}
+
+Slot HeaviestSubtreeForkChoice::best_slot(Slot slot) const {
+  const Node *n = node(slot);
+  return n ? n->best : NO_SLOT;
+}
+
+Slot HeaviestSubtreeForkChoice::parent(Slot slot) const {
+  const Node *n = node(slot);
+  return n ? n->parent : NO_SLOT;
+}
+
+const std::vector<Slot> &HeaviestSubtreeForkChoice::children(Slot slot) const {
+  static const std::vector<Slot> none;
+  const Node *n = node(slot);
+  return n ? n->children : none;
+}
+
+uint64_t HeaviestSubtreeForkChoice::stake_voted_at(Slot slot) const {
+  const Node *n = node(slot);
+  return n ? n->stake_voted_at : 0;
+}
+
+uint64_t HeaviestSubtreeForkChoice::stake_voted_subtree(Slot slot) const {
+  const Node *n = node(slot);
+  return n ? n->stake_voted_subtree : 0;
+}
+
+bool HeaviestSubtreeForkChoice::is_ancestor(Slot ancestor,
+                                            Slot descendant) const {
+  if (!node(ancestor)) {
+    return false;
+  }
+  // Parents have lower slots, so the walk stops at the ancestor's height
+  Slot at = descendant;
+  while (at != NO_SLOT && at > ancestor) {
+    const Node *n = node(at);
+    if (!n) {
+      return false;
+    }
+    at = n->parent;
+  }
+  return at == ancestor;
+}
+
+Slot HeaviestSubtreeForkChoice::latest_vote(const PublicKey &validator) const {
+  auto it = latest_votes_.find(validator);
+  return it != latest_votes_.end() ? it->second.slot : NO_SLOT;
+}
+
+void HeaviestSubtreeForkChoice::clear() {
+  nodes_.clear();
+  root_ = NO_SLOT;
+  size_ = 0;
+  latest_votes_.clear();
+  pending_votes_.clear();
+}
+
+} // namespace consensus
+} // namespace slonana
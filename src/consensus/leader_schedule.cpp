@@ -0,0 +1,167 @@
+#include "consensus/leader_schedule.h"
+#include "common/chacha_rng.h"
+#include <algorithm>
+
+namespace slonana {
+namespace consensus {
+
+LeaderSchedule::LeaderSchedule(const staking::EpochStakes &stakes,
+                               uint64_t slots_per_epoch)
+    : epoch_(stakes.epoch), first_slot_(stakes.epoch * slots_per_epoch),
+      slot_count_(slots_per_epoch), validators_(stakes.validators) {
+  if (stakes.total_stake == 0) {
+    return;
+  }
+
+  ChaChaRng rng(stakes.epoch);
+  uint64_t runs = (slot_count_ + NUM_CONSECUTIVE_LEADER_SLOTS - 1) /
+                  NUM_CONSECUTIVE_LEADER_SLOTS;
+  leader_indices_.reserve(runs);
+  for (uint64_t run = 0; run < runs; ++run) {
+    uint64_t point = rng.sample_uniform(stakes.total_stake);
+    leader_indices_.push_back(static_cast<uint32_t>(stakes.validator_at(point)));
+  }
+}
+
+const PublicKey *LeaderSchedule::leader_at(Slot slot) const {
+  if (slot < first_slot_ || slot - first_slot_ >= slot_count_ ||
+      leader_indices_.empty()) {
+    return nullptr;
+  }
+  return &validators_[leader_indices_[(slot - first_slot_) /
+                                      NUM_CONSECUTIVE_LEADER_SLOTS]];
+}
+
+std::vector<uint64_t>
+LeaderSchedule::leader_slots(const PublicKey &identity) const {
+  std::vector<uint64_t> slots;
+  auto it = std::find(validators_.begin(), validators_.end(), identity);
+  if (it == validators_.end()) {
+    return slots;
+  }
+  auto index = static_cast<uint32_t>(it - validators_.begin());
+  for (size_t run = 0; run < leader_indices_.size(); ++run) {
+    if (leader_indices_[run] != index) {
+      continue;
+    }
+    uint64_t start = run * NUM_CONSECUTIVE_LEADER_SLOTS;
+    uint64_t end = std::min(start + NUM_CONSECUTIVE_LEADER_SLOTS, slot_count_);
+    for (uint64_t slot = start; slot < end; ++slot) {
+      slots.push_back(slot);
+    }
+  }
+  return slots;
+}
+
+LeaderScheduleCache::LeaderScheduleCache(StakesProvider provider,
+                                         uint64_t slots_per_epoch,
+                                         uint64_t precompute_lookahead)
+    : provider_(std::move(provider)),
+      slots_per_epoch_(std::max<uint64_t>(slots_per_epoch, 1)),
+      precompute_lookahead_(precompute_lookahead) {}
+
+LeaderScheduleCache::~LeaderScheduleCache() {
+  if (precompute_thread_.joinable()) {
+    precompute_thread_.join();
+  }
+}
+
+bool LeaderScheduleCache::schedulable(Epoch epoch) const {
+  return epoch <= epoch_of(latest_slot_.load(std::memory_order_relaxed)) + 1;
+}
+
+std::shared_ptr<const LeaderSchedule>
+LeaderScheduleCache::store(Epoch epoch,
+                           std::shared_ptr<const LeaderSchedule> schedule) {
+  // Caller holds mutex_. A racing draw of the same epoch keeps the first.
+  auto [it, inserted] = schedules_.emplace(epoch, std::move(schedule));
+  auto stored = it->second;
+  while (schedules_.size() > MAX_SCHEDULES) {
+    schedules_.erase(schedules_.begin());
+  }
+  return stored;
+}
+
+std::shared_ptr<const LeaderSchedule>
+LeaderScheduleCache::get_epoch_schedule(Epoch epoch) {
+  if (!schedulable(epoch)) {
+    return nullptr;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    precompute_done_.wait(lock, [&] { return precomputing_ != epoch; });
+    auto it = schedules_.find(epoch);
+    if (it != schedules_.end()) {
+      return it->second;
+    }
+  }
+
+  auto stakes = provider_ ? provider_(epoch) : nullptr;
+  if (!stakes) {
+    return nullptr;
+  }
+  auto schedule = std::make_shared<const LeaderSchedule>(*stakes, slots_per_epoch_);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  return store(epoch, std::move(schedule));
+}
+
+std::optional<PublicKey> LeaderScheduleCache::slot_leader(Slot slot) {
+  auto schedule = get_epoch_schedule(epoch_of(slot));
+  if (!schedule) {
+    return std::nullopt;
+  }
+  if (const PublicKey *leader = schedule->leader_at(slot)) {
+    return *leader;
+  }
+  return std::nullopt;
+}
+
+void LeaderScheduleCache::notify_slot(Slot slot) {
+  Slot latest = latest_slot_.load(std::memory_order_relaxed);
+  while (slot > latest &&
+         !latest_slot_.compare_exchange_weak(latest, slot,
+                                             std::memory_order_relaxed)) {
+  }
+
+  Epoch next = epoch_of(slot) + 1;
+  if (slot + precompute_lookahead_ < next * slots_per_epoch_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (schedules_.count(next) > 0 || precomputing_ != NO_EPOCH) {
+      return;
+    }
+  }
+
+  // Freeze the stakes here; only the draw moves to the background
+  auto stakes = provider_ ? provider_(next) : nullptr;
+  if (!stakes) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (schedules_.count(next) > 0 || precomputing_ != NO_EPOCH) {
+    return;
+  }
+  if (precompute_thread_.joinable()) {
+    precompute_thread_.join(); // Finished: precomputing_ is clear
+  }
+  precomputing_ = next;
+  precompute_thread_ = std::thread([this, next, stakes] {
+    auto schedule =
+        std::make_shared<const LeaderSchedule>(*stakes, slots_per_epoch_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      store(next, std::move(schedule));
+      precomputing_ = NO_EPOCH;
+    }
+    precomputed_.fetch_add(1, std::memory_order_relaxed);
+    precompute_done_.notify_all();
+  });
+}
+
+} // namespace consensus
+} // namespace slonana
@@ -64,6 +64,9 @@ void print_usage(const char *program_name) {
             << std::endl;
   std::cout << "  --snapshot-mirror URL      Custom snapshot mirror URL"
             << std::endl;
+  std::cout << "  --snapshot-sha256 HEX      Expected SHA-256 of the snapshot "
+               "archive"
+            << std::endl;
   std::cout
       << "  --upstream-rpc-url URL     Upstream RPC URL for devnet bootstrap"
       << std::endl;
@@ -78,6 +81,12 @@ void print_usage(const char *program_name) {
   std::cout << "  --no-rpc                   Disable RPC server" << std::endl;
   std::cout << "  --no-gossip                Disable gossip protocol"
             << std::endl;
+  std::cout << "  --enable-quic-tpu          Also accept transactions over "
+               "QUIC (experimental)"
+            << std::endl;
+  std::cout << "  --quic-tpu-port PORT       QUIC transaction port (default: "
+               "8009)"
+            << std::endl;
   std::cout << "  --single-node              Enable single-node mode with "
                "synthetic transaction processing"
             << std::endl;
@@ -404,6 +413,8 @@ slonana::common::ValidatorConfig parse_arguments(int argc, char *argv[]) {
       config.snapshot_source = argv[++i];
     } else if (arg == "--snapshot-mirror" && i + 1 < argc) {
       config.snapshot_mirror = argv[++i];
+    } else if (arg == "--snapshot-sha256" && i + 1 < argc) {
+      config.snapshot_sha256 = argv[++i];
     } else if (arg == "--upstream-rpc-url" && i + 1 < argc) {
       config.upstream_rpc_url = argv[++i];
     } else if (arg == "--allow-stale-rpc") {
@@ -419,6 +430,10 @@ slonana::common::ValidatorConfig parse_arguments(int argc, char *argv[]) {
       config.enable_rpc = false;
     } else if (arg == "--no-gossip") {
       config.enable_gossip = false;
+    } else if (arg == "--enable-quic-tpu") {
+      config.enable_quic_tpu = true;
+    } else if (arg == "--quic-tpu-port" && i + 1 < argc) {
+      config.quic_tpu_port = std::stoi(argv[++i]);
     } else {
       std::cerr << "Unknown argument: " << arg << std::endl;
       print_usage(argv[0]);
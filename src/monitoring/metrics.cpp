@@ -1,188 +1,52 @@
 #include "monitoring/metrics.h"
+#include "monitoring/prometheus_exporter.h"
 #include <algorithm>
+#include <cmath>
 #include <ctime>
 #include <iomanip>
 #include <limits>
 #include <mutex>
 #include <sstream>
+#include <stdexcept>
 
 namespace slonana {
 namespace monitoring {
 
-// Forward declarations
-class CounterImpl;
-class GaugeImpl;
-class HistogramImpl;
-class MetricsRegistryImpl;
-
-/**
- * @brief Prometheus format metrics exporter implementation
- */
-class PrometheusExporter : public IMetricsExporter {
-public:
-  std::string export_metrics(const IMetricsRegistry &registry) override {
-    std::ostringstream output;
-
-    auto metrics = registry.get_all_metrics();
-
-    for (const auto &metric : metrics) {
-      export_metric(output, *metric);
-    }
-
-    return output.str();
-  }
-
-  std::string get_content_type() const override {
-    return "text/plain; version=0.0.4; charset=utf-8";
-  }
-
-private:
-  void export_metric(std::ostringstream &output, const IMetric &metric) {
-    const std::string &name = metric.get_name();
-    const std::string &help = metric.get_help();
-    MetricType type = metric.get_type();
-
-    // Export metric metadata
-    output << "# HELP " << name << " " << help << "\n";
-    output << "# TYPE " << name << " " << metric_type_to_string(type) << "\n";
-
-    // Export metric values
-    auto values = metric.get_values();
-
-    switch (type) {
-    case MetricType::COUNTER:
-    case MetricType::GAUGE:
-      export_simple_metric(output, name, values);
-      break;
-
-    case MetricType::HISTOGRAM:
-      export_histogram_metric(output, name, values);
-      break;
-
-    case MetricType::SUMMARY:
-      export_summary_metric(output, name, values);
-      break;
-    }
-
-    output << "\n";
-  }
-
-  void export_simple_metric(std::ostringstream &output, const std::string &name,
-                            const std::vector<MetricValue> &values) {
-    for (const auto &value : values) {
-      output << name;
-      export_labels(output, value.labels);
-      output << " " << std::fixed << std::setprecision(6) << value.value;
-      output << " " << timestamp_to_millis(value.timestamp) << "\n";
-    }
-  }
-
-  void export_histogram_metric(std::ostringstream &output,
-                               const std::string &name,
-                               const std::vector<MetricValue> &values) {
-    // Export buckets, sum and count for histogram metrics
-    // Simplified implementation for testing
-    export_simple_metric(output, name, values);
-  }
-
-  void export_summary_metric(std::ostringstream &output,
-                             const std::string &name,
-                             const std::vector<MetricValue> &values) {
-    // Similar to histogram but with quantiles instead of buckets
-    export_simple_metric(output, name, values);
-  }
-
-  void export_labels(std::ostringstream &output,
-                     const std::map<std::string, std::string> &labels) {
-    if (labels.empty()) {
-      return;
-    }
-
-    output << "{";
-    bool first = true;
-    for (const auto &[key, value] : labels) {
-      if (!first) {
-        output << ",";
-      }
-      output << key << "=\"" << escape_label_value(value) << "\"";
-      first = false;
-    }
-    output << "}";
-  }
-
-  std::string escape_label_value(const std::string &value) {
-    std::string escaped;
-    for (char c : value) {
-      if (c == '"' || c == '\\' || c == '\n') {
-        escaped += '\\';
-      }
-      escaped += c;
-    }
-    return escaped;
-  }
-
-  std::string metric_type_to_string(MetricType type) {
-    switch (type) {
-    case MetricType::COUNTER:
-      return "counter";
-    case MetricType::GAUGE:
-      return "gauge";
-    case MetricType::HISTOGRAM:
-      return "histogram";
-    case MetricType::SUMMARY:
-      return "summary";
-    default:
-      return "untyped";
-    }
-  }
-
-  uint64_t
-  timestamp_to_millis(const std::chrono::system_clock::time_point &timestamp) {
-    auto time_since_epoch = timestamp.time_since_epoch();
-    auto millis =
-        std::chrono::duration_cast<std::chrono::milliseconds>(time_since_epoch);
-    return millis.count();
-  }
-};
-
-// Forward declarations
-class CounterImpl;
-class GaugeImpl;
-class HistogramImpl;
-class MetricsRegistryImpl;
-
 /**
  * @brief Counter metric implementation
+ *
+ * Increments land in the calling thread's shard; get_value() sums them.
  */
 class CounterImpl : public ICounter {
 public:
   CounterImpl(const std::string &name, const std::string &help,
               const std::map<std::string, std::string> &labels)
-      : name_(name), help_(help), labels_(labels), value_(0.0) {}
+      : name_(name), help_(help), labels_(labels) {}
 
   std::string get_name() const override { return name_; }
   std::string get_help() const override { return help_; }
   MetricType get_type() const override { return MetricType::COUNTER; }
 
-  void increment() override { increment(1.0); }
+  void increment() override { value_.add(uint64_t(1)); }
 
   void increment(double amount) override {
     if (amount < 0) {
       throw std::invalid_argument("Counter increment must be positive");
     }
-    std::lock_guard<std::mutex> lock(mutex_);
-    value_ += amount;
+    double whole = std::floor(amount);
+    if (whole == amount &&
+        whole < static_cast<double>(std::numeric_limits<uint64_t>::max())) {
+      value_.add(static_cast<uint64_t>(whole));
+    } else {
+      value_.add(amount);
+    }
   }
 
-  double get_value() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return value_;
-  }
+  double get_value() const override { return value_.value(); }
 
   std::vector<MetricValue> get_values() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
     MetricValue value;
-    value.value = value_;
+    value.value = value_.value();
     value.timestamp = std::chrono::system_clock::now();
     value.labels = labels_;
     return {value};
@@ -192,8 +56,7 @@ private:
   std::string name_;
   std::string help_;
   std::map<std::string, std::string> labels_;
-  mutable std::mutex mutex_;
-  double value_;
+  ShardedCounter value_;
 };
 
 /**
@@ -210,29 +73,22 @@ public:
   MetricType get_type() const override { return MetricType::GAUGE; }
 
   void set(double value) override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    value_ = value;
+    value_.store(value, std::memory_order_relaxed);
   }
 
-  void add(double amount) override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    value_ += amount;
-  }
+  void add(double amount) override { detail::atomic_add(value_, amount); }
 
   void subtract(double amount) override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    value_ -= amount;
+    detail::atomic_add(value_, -amount);
   }
 
   double get_value() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return value_;
+    return value_.load(std::memory_order_relaxed);
   }
 
   std::vector<MetricValue> get_values() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
     MetricValue value;
-    value.value = value_;
+    value.value = get_value();
     value.timestamp = std::chrono::system_clock::now();
     value.labels = labels_;
     return {value};
@@ -242,20 +98,23 @@ private:
   std::string name_;
   std::string help_;
   std::map<std::string, std::string> labels_;
-  mutable std::mutex mutex_;
-  double value_;
+  std::atomic<double> value_;
 };
 
 /**
  * @brief Histogram metric implementation
+ *
+ * Observations go into a log-linear histogram with no locking, for
+ * quantiles. A log-linear bucket can straddle a configured bound, so the
+ * `le` counts are kept exactly in a sharded counter per bound instead of
+ * being derived from it.
  */
 class HistogramImpl : public IHistogram {
 public:
   HistogramImpl(const std::string &name, const std::string &help,
                 const std::vector<double> &buckets,
                 const std::map<std::string, std::string> &labels)
-      : name_(name), help_(help), labels_(labels), buckets_(buckets), sum_(0.0),
-        count_(0) {
+      : name_(name), help_(help), labels_(labels), buckets_(buckets) {
 
     // Ensure buckets are sorted and add +Inf bucket
     std::sort(buckets_.begin(), buckets_.end());
@@ -263,8 +122,8 @@ public:
         buckets_.back() != std::numeric_limits<double>::infinity()) {
       buckets_.push_back(std::numeric_limits<double>::infinity());
     }
-
-    bucket_counts_.resize(buckets_.size(), 0);
+    // +Inf is the total count
+    bucket_counts_ = std::vector<ShardedCounter>(buckets_.size() - 1);
   }
 
   std::string get_name() const override { return name_; }
@@ -272,30 +131,35 @@ public:
   MetricType get_type() const override { return MetricType::HISTOGRAM; }
 
   void observe(double value) override {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    sum_ += value;
-    count_++;
-
-    // Find appropriate buckets and increment counts
-    for (size_t i = 0; i < buckets_.size(); ++i) {
-      if (value <= buckets_[i]) {
-        bucket_counts_[i]++;
-      }
+    histogram_.record(value);
+    // First bound at or above the value; NaN is below none of them
+    auto finite_end = buckets_.end() - 1;
+    auto it = std::lower_bound(buckets_.begin(), finite_end, value);
+    if (it != finite_end && value <= *it) {
+      bucket_counts_[it - buckets_.begin()].add();
     }
   }
 
+  HistogramSnapshot snapshot() const override { return histogram_.snapshot(); }
+
   HistogramData get_data() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto snap = histogram_.snapshot();
 
     HistogramData data;
-    data.sum = sum_;
-    data.total_count = count_;
+    data.sum = snap.sum;
+    data.total_count = snap.count;
 
+    uint64_t cumulative = 0;
     for (size_t i = 0; i < buckets_.size(); ++i) {
       HistogramBucket bucket;
       bucket.upper_bound = buckets_[i];
-      bucket.count = bucket_counts_[i];
+      if (i < bucket_counts_.size()) {
+        cumulative += static_cast<uint64_t>(bucket_counts_[i].value());
+        bucket.count = cumulative;
+      } else {
+        // Concurrent observations may land in a bound before the total
+        bucket.count = std::max(snap.count, cumulative);
+      }
       data.buckets.push_back(bucket);
     }
 
@@ -303,32 +167,33 @@ public:
   }
 
   std::vector<MetricValue> get_values() const override {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto data = get_data();
+    auto now = std::chrono::system_clock::now();
     std::vector<MetricValue> values;
 
     // Add bucket values
-    for (size_t i = 0; i < buckets_.size(); ++i) {
+    for (const auto &bucket : data.buckets) {
       MetricValue value;
-      value.value = static_cast<double>(bucket_counts_[i]);
-      value.timestamp = std::chrono::system_clock::now();
+      value.value = static_cast<double>(bucket.count);
+      value.timestamp = now;
       value.labels = labels_;
       value.labels["le"] =
-          (buckets_[i] == std::numeric_limits<double>::infinity())
+          (bucket.upper_bound == std::numeric_limits<double>::infinity())
               ? "+Inf"
-              : std::to_string(buckets_[i]);
+              : std::to_string(bucket.upper_bound);
       values.push_back(value);
     }
 
     // Add sum and count
     MetricValue sum_value;
-    sum_value.value = sum_;
-    sum_value.timestamp = std::chrono::system_clock::now();
+    sum_value.value = data.sum;
+    sum_value.timestamp = now;
     sum_value.labels = labels_;
     values.push_back(sum_value);
 
     MetricValue count_value;
-    count_value.value = static_cast<double>(count_);
-    count_value.timestamp = std::chrono::system_clock::now();
+    count_value.value = static_cast<double>(data.total_count);
+    count_value.timestamp = now;
     count_value.labels = labels_;
     values.push_back(count_value);
 
@@ -340,10 +205,8 @@ private:
   std::string help_;
   std::map<std::string, std::string> labels_;
   std::vector<double> buckets_;
-  std::vector<uint64_t> bucket_counts_;
-  mutable std::mutex mutex_;
-  double sum_;
-  uint64_t count_;
+  std::vector<ShardedCounter> bucket_counts_; ///< Per finite bound, not cumulative
+  LogLinearHistogram histogram_;
 };
 
 /**
@@ -491,9 +354,52 @@ double Timer::stop() {
   return seconds;
 }
 
-// Forward declarations of exporter classes from prometheus_exporter.cpp
-class PrometheusExporter;
-class JsonExporter;
+// Labelled handles
+namespace {
+template <typename Metric, typename Create>
+MetricVec<Metric> make_vec(const std::string &label,
+                           const std::vector<std::string> &values,
+                           const std::map<std::string, std::string> &labels,
+                           Create create) {
+  std::vector<std::shared_ptr<Metric>> handles;
+  handles.reserve(values.size());
+  for (const auto &value : values) {
+    auto with_label = labels;
+    with_label[label] = value;
+    handles.push_back(create(with_label));
+  }
+  return MetricVec<Metric>(std::move(handles));
+}
+} // namespace
+
+CounterVec make_counter_vec(IMetricsRegistry &registry, const std::string &name,
+                            const std::string &help, const std::string &label,
+                            const std::vector<std::string> &values,
+                            const std::map<std::string, std::string> &labels) {
+  return make_vec<ICounter>(label, values, labels, [&](const auto &l) {
+    return registry.counter(name, help, l);
+  });
+}
+
+GaugeVec make_gauge_vec(IMetricsRegistry &registry, const std::string &name,
+                        const std::string &help, const std::string &label,
+                        const std::vector<std::string> &values,
+                        const std::map<std::string, std::string> &labels) {
+  return make_vec<IGauge>(label, values, labels, [&](const auto &l) {
+    return registry.gauge(name, help, l);
+  });
+}
+
+HistogramVec
+make_histogram_vec(IMetricsRegistry &registry, const std::string &name,
+                   const std::string &help, const std::string &label,
+                   const std::vector<std::string> &values,
+                   const std::vector<double> &buckets,
+                   const std::map<std::string, std::string> &labels) {
+  return make_vec<IHistogram>(label, values, labels, [&](const auto &l) {
+    return registry.histogram(name, help, buckets, l);
+  });
+}
 
 // Factory implementations
 std::unique_ptr<IMetricsRegistry> MonitoringFactory::create_registry() {
@@ -502,7 +408,6 @@ std::unique_ptr<IMetricsRegistry> MonitoringFactory::create_registry() {
 
 std::unique_ptr<IMetricsExporter>
 MonitoringFactory::create_prometheus_exporter() {
-  // Use the actual PrometheusExporter class defined in prometheus_exporter.cpp
   return std::make_unique<PrometheusExporter>();
 }
 
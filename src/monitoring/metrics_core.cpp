@@ -0,0 +1,221 @@
+#include "monitoring/metrics_core.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace slonana {
+namespace monitoring {
+
+size_t metrics_shard_count() {
+  static const size_t count = [] {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t shards = 1;
+    while (shards < threads && shards < 64) {
+      shards <<= 1;
+    }
+    return shards;
+  }();
+  return count;
+}
+
+namespace detail {
+size_t assign_metrics_shard() {
+  static std::atomic<size_t> next{0};
+  return next.fetch_add(1, std::memory_order_relaxed) &
+         (metrics_shard_count() - 1);
+}
+} // namespace detail
+
+// ShardedCounter
+
+ShardedCounter::ShardedCounter()
+    : shards_(std::make_unique<Shard[]>(metrics_shard_count())) {}
+
+double ShardedCounter::value() const noexcept {
+  uint64_t count = 0;
+  double fraction = 0.0;
+  for (size_t i = 0; i < metrics_shard_count(); ++i) {
+    count += shards_[i].count.load(std::memory_order_relaxed);
+    fraction += shards_[i].fraction.load(std::memory_order_relaxed);
+  }
+  return static_cast<double>(count) + fraction;
+}
+
+void ShardedCounter::reset() noexcept {
+  for (size_t i = 0; i < metrics_shard_count(); ++i) {
+    shards_[i].count.store(0, std::memory_order_relaxed);
+    shards_[i].fraction.store(0.0, std::memory_order_relaxed);
+  }
+}
+
+// HistogramSnapshot
+
+void HistogramSnapshot::merge(const HistogramSnapshot &other) {
+  if (other.count == 0) {
+    return;
+  }
+  if (counts.size() < other.counts.size()) {
+    counts.resize(other.counts.size(), 0);
+  }
+  for (size_t i = 0; i < other.counts.size(); ++i) {
+    counts[i] += other.counts[i];
+  }
+  min = count == 0 ? other.min : std::min(min, other.min);
+  max = count == 0 ? other.max : std::max(max, other.max);
+  count += other.count;
+  sum += other.sum;
+}
+
+double HistogramSnapshot::quantile(double q) const {
+  if (count == 0) {
+    return 0.0;
+  }
+  q = std::clamp(q, 0.0, 1.0);
+  uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count))));
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      if (i == 0) {
+        return min;
+      }
+      if (i + 1 == counts.size()) {
+        return max;
+      }
+      double mid = (LogLinearHistogram::bucket_lower_bound(i) +
+                    LogLinearHistogram::bucket_upper_bound(i)) /
+                   2.0;
+      return std::clamp(mid, min, max);
+    }
+  }
+  return max;
+}
+
+uint64_t HistogramSnapshot::count_at_or_below(double bound) const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    if (LogLinearHistogram::bucket_upper_bound(i) > bound) {
+      break;
+    }
+    total += counts[i];
+  }
+  return total;
+}
+
+// LogLinearHistogram
+
+LogLinearHistogram::Shard::Shard()
+    : min(std::numeric_limits<double>::infinity()),
+      max(-std::numeric_limits<double>::infinity()) {}
+
+LogLinearHistogram::LogLinearHistogram()
+    : shards_(std::make_unique<std::atomic<Shard *>[]>(metrics_shard_count())) {
+  for (size_t i = 0; i < metrics_shard_count(); ++i) {
+    shards_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+LogLinearHistogram::~LogLinearHistogram() {
+  for (size_t i = 0; i < metrics_shard_count(); ++i) {
+    delete shards_[i].load(std::memory_order_relaxed);
+  }
+}
+
+size_t LogLinearHistogram::bucket_index(double value) noexcept {
+  if (!(value >= std::ldexp(1.0, MIN_EXPONENT))) {
+    return 0; // Underflow, zero, negative or NaN
+  }
+  int exponent = 0;
+  double mantissa = std::frexp(value, &exponent); // value = m * 2^e, m in [0.5, 1)
+  int octave = exponent - 1;                      // value in [2^octave, 2^(octave+1))
+  if (octave >= MAX_EXPONENT) {
+    return BUCKETS - 1;
+  }
+  auto sub = static_cast<size_t>((mantissa * 2.0 - 1.0) * SUB_BUCKETS);
+  sub = std::min(sub, SUB_BUCKETS - 1);
+  return 1 + static_cast<size_t>(octave - MIN_EXPONENT) * SUB_BUCKETS + sub;
+}
+
+double LogLinearHistogram::bucket_lower_bound(size_t index) {
+  if (index == 0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  if (index >= BUCKETS - 1) {
+    return std::ldexp(1.0, MAX_EXPONENT);
+  }
+  size_t offset = index - 1;
+  int octave = static_cast<int>(offset / SUB_BUCKETS) + MIN_EXPONENT;
+  double sub = static_cast<double>(offset % SUB_BUCKETS);
+  return std::ldexp(1.0 + sub / SUB_BUCKETS, octave);
+}
+
+double LogLinearHistogram::bucket_upper_bound(size_t index) {
+  if (index == 0) {
+    return std::ldexp(1.0, MIN_EXPONENT);
+  }
+  if (index >= BUCKETS - 1) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return bucket_lower_bound(index + 1);
+}
+
+LogLinearHistogram::Shard &LogLinearHistogram::shard() noexcept {
+  auto &slot = shards_[metrics_shard_index()];
+  Shard *shard = slot.load(std::memory_order_acquire);
+  if (shard != nullptr) {
+    return *shard;
+  }
+  // Another thread on the same shard may race us to install one
+  Shard *fresh = new Shard();
+  if (slot.compare_exchange_strong(shard, fresh, std::memory_order_acq_rel)) {
+    return *fresh;
+  }
+  delete fresh;
+  return *shard;
+}
+
+void LogLinearHistogram::record(double value) noexcept {
+  Shard &target = shard();
+  target.counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+  target.count.fetch_add(1, std::memory_order_relaxed);
+  detail::atomic_add(target.sum, value);
+
+  double current = target.min.load(std::memory_order_relaxed);
+  while (value < current &&
+         !target.min.compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed)) {
+  }
+  current = target.max.load(std::memory_order_relaxed);
+  while (value > current &&
+         !target.max.compare_exchange_weak(current, value,
+                                           std::memory_order_relaxed)) {
+  }
+}
+
+HistogramSnapshot LogLinearHistogram::snapshot() const {
+  HistogramSnapshot result;
+  result.counts.assign(BUCKETS, 0);
+  for (size_t i = 0; i < metrics_shard_count(); ++i) {
+    const Shard *shard = shards_[i].load(std::memory_order_acquire);
+    if (shard == nullptr) {
+      continue;
+    }
+    HistogramSnapshot part;
+    part.counts.resize(BUCKETS);
+    for (size_t b = 0; b < BUCKETS; ++b) {
+      part.counts[b] = shard->counts[b].load(std::memory_order_relaxed);
+    }
+    part.count = shard->count.load(std::memory_order_relaxed);
+    part.sum = shard->sum.load(std::memory_order_relaxed);
+    part.min = shard->min.load(std::memory_order_relaxed);
+    part.max = shard->max.load(std::memory_order_relaxed);
+    result.merge(part);
+  }
+  return result;
+}
+
+} // namespace monitoring
+} // namespace slonana
@@ -0,0 +1,365 @@
+#include "network/account_notification_dispatcher.h"
+#include "network/rpc_json.h"
+#include <algorithm>
+#include <cstring>
+
+namespace slonana {
+namespace network {
+
+namespace {
+
+constexpr int LEVEL_COUNT = 3; // CommitmentLevel::PROCESSED..FINALIZED
+
+constexpr AccountEncoding ENCODINGS[] = {AccountEncoding::BASE58,
+                                         AccountEncoding::BASE64};
+
+uint8_t level_mask(int level) {
+  auto commitment = static_cast<CommitmentLevel>(level);
+  return interest_bit(commitment, AccountEncoding::BASE58) |
+         interest_bit(commitment, AccountEncoding::BASE64);
+}
+
+void append_context(std::string &out, Slot slot) {
+  out.append(R"({"context":{"slot":)")
+      .append(std::to_string(slot))
+      .append(R"(},"value":)");
+}
+
+} // namespace
+
+size_t AccountNotificationDispatcher::KeyHash::operator()(
+    const KeyBytes &key) const noexcept {
+  // Keys are hashes/public keys already: any 8 bytes are well distributed
+  size_t value;
+  std::memcpy(&value, key.data(), sizeof(value));
+  return value;
+}
+
+AccountNotificationDispatcher::AccountNotificationDispatcher(
+    std::shared_ptr<storage::AccountChangeFeed> feed,
+    std::shared_ptr<WebSocketServer> websocket_server, AccountLoader loader)
+    : AccountNotificationDispatcher(std::move(feed),
+                                    std::move(websocket_server),
+                                    std::move(loader), Config{}) {}
+
+AccountNotificationDispatcher::AccountNotificationDispatcher(
+    std::shared_ptr<storage::AccountChangeFeed> feed,
+    std::shared_ptr<WebSocketServer> websocket_server, AccountLoader loader,
+    const Config &config)
+    : feed_(std::move(feed)), websocket_server_(std::move(websocket_server)),
+      loader_(std::move(loader)), config_(config) {
+  drain_buffer_.reserve(config_.max_batch);
+}
+
+AccountNotificationDispatcher::~AccountNotificationDispatcher() { stop(); }
+
+void AccountNotificationDispatcher::set_change_listener(
+    ChangeListener listener) {
+  change_listener_ = std::move(listener);
+}
+
+bool AccountNotificationDispatcher::start() {
+  if (running_.exchange(true)) {
+    return false;
+  }
+  thread_ = std::thread(&AccountNotificationDispatcher::dispatcher_loop, this);
+  return true;
+}
+
+void AccountNotificationDispatcher::stop() {
+  if (!running_.exchange(false)) {
+    return;
+  }
+  events_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void AccountNotificationDispatcher::dispatcher_loop() {
+  while (running_.load()) {
+    poll();
+    std::unique_lock<std::mutex> lock(events_mutex_);
+    events_cv_.wait_for(lock, config_.poll_interval,
+                        [this] { return !running_.load() || !events_.empty(); });
+  }
+}
+
+void AccountNotificationDispatcher::on_slot_processed(Slot slot) {
+  std::lock_guard<std::mutex> lock(events_mutex_);
+  events_.emplace_back(slot, Event::PROCESSED);
+}
+
+void AccountNotificationDispatcher::on_slot_confirmed(Slot slot) {
+  std::lock_guard<std::mutex> lock(events_mutex_);
+  events_.emplace_back(slot, Event::CONFIRMED);
+}
+
+void AccountNotificationDispatcher::on_slot_rooted(Slot slot) {
+  {
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    events_.emplace_back(slot, Event::ROOTED);
+  }
+  events_cv_.notify_one();
+}
+
+void AccountNotificationDispatcher::on_slot_dead(Slot slot) {
+  std::lock_guard<std::mutex> lock(events_mutex_);
+  events_.emplace_back(slot, Event::DEAD);
+}
+
+size_t AccountNotificationDispatcher::poll() {
+  // Changes are published to the feed before fork choice hears about their
+  // slot, so draining first means an event never overtakes its own writes
+  size_t published = drain_feed();
+
+  std::vector<std::pair<Slot, Event>> events;
+  {
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    events.swap(events_);
+  }
+
+  for (const auto &[slot, event] : events) {
+    switch (event) {
+    case Event::PROCESSED:
+      published += advance(slot, static_cast<int>(CommitmentLevel::PROCESSED));
+      break;
+    case Event::CONFIRMED:
+      published += advance(slot, static_cast<int>(CommitmentLevel::CONFIRMED));
+      break;
+    case Event::ROOTED:
+      // A root finalizes itself and everything still pending below it
+      while (!pending_.empty() && pending_.begin()->first <= slot) {
+        auto it = pending_.begin();
+        published += deliver(it->first, it->second,
+                             static_cast<int>(CommitmentLevel::FINALIZED));
+        pending_.erase(it);
+        slots_finalized_.fetch_add(1, std::memory_order_relaxed);
+      }
+      break;
+    case Event::DEAD:
+      if (pending_.erase(slot) > 0) {
+        slots_discarded_.fetch_add(1, std::memory_order_relaxed);
+      }
+      break;
+    }
+  }
+
+  pending_slots_.store(pending_.size(), std::memory_order_relaxed);
+  notifications_published_.fetch_add(published, std::memory_order_relaxed);
+  return published;
+}
+
+size_t AccountNotificationDispatcher::drain_feed() {
+  if (!feed_) {
+    return 0;
+  }
+  drain_buffer_.clear();
+  size_t drained = feed_->drain(drain_buffer_, config_.max_batch);
+  if (drained == 0) {
+    return 0;
+  }
+  records_drained_.fetch_add(drained, std::memory_order_relaxed);
+
+  // Slots that already reached a commitment level get late writes delivered
+  // right away instead of waiting for the next event
+  std::vector<Slot> late_slots;
+  for (const auto &record : drain_buffer_) {
+    auto &pending = pending_[record.slot];
+    auto [it, inserted] = pending.changes.try_emplace(record.pubkey);
+    auto &change = it->second;
+    if (!inserted) {
+      duplicate_writes_.fetch_add(1, std::memory_order_relaxed);
+      if (record.version < change.record.version) {
+        continue;
+      }
+      change = PendingChange{};
+    }
+    change.record = record;
+    change.address = rpc_json::encode_base58(record.pubkey_key());
+    change.owner_address = rpc_json::encode_base58(record.owner_key());
+    if (change_listener_) {
+      change_listener_(change.address);
+    }
+    if (pending.reached >= 0 &&
+        (late_slots.empty() || late_slots.back() != record.slot)) {
+      late_slots.push_back(record.slot);
+    }
+  }
+
+  // Keep memory bounded if roots stop arriving
+  while (pending_.size() > config_.max_pending_slots) {
+    pending_.erase(pending_.begin());
+    slots_discarded_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  size_t published = 0;
+  std::sort(late_slots.begin(), late_slots.end());
+  late_slots.erase(std::unique(late_slots.begin(), late_slots.end()),
+                   late_slots.end());
+  for (Slot slot : late_slots) {
+    auto it = pending_.find(slot);
+    if (it != pending_.end()) {
+      published += deliver(slot, it->second, it->second.reached, true);
+    }
+  }
+  return published;
+}
+
+size_t AccountNotificationDispatcher::advance(Slot slot, int level) {
+  auto it = pending_.find(slot);
+  if (it == pending_.end()) {
+    return 0;
+  }
+  return deliver(slot, it->second, level);
+}
+
+size_t AccountNotificationDispatcher::deliver(Slot slot, PendingSlot &pending,
+                                              int level, bool only_new) {
+  if (!only_new && level <= pending.reached) {
+    return 0;
+  }
+  pending.reached = std::max(pending.reached, level);
+  size_t published = 0;
+  for (auto &entry : pending.changes) {
+    auto &change = entry.second;
+    if (change.delivered < level) {
+      published += deliver_change(slot, change, level);
+    }
+  }
+  return published;
+}
+
+size_t AccountNotificationDispatcher::deliver_change(Slot slot,
+                                                     PendingChange &change,
+                                                     int level) {
+  int from = change.delivered + 1;
+  change.delivered = level;
+  if (!websocket_server_) {
+    return 0;
+  }
+
+  uint8_t wanted = 0;
+  for (int l = from; l <= level; ++l) {
+    wanted |= level_mask(l);
+  }
+  uint8_t account_mask =
+      websocket_server_->account_interest(change.address) & wanted;
+  uint8_t program_mask =
+      websocket_server_->program_interest(change.owner_address) & wanted;
+  if ((account_mask | program_mask) == 0) {
+    return 0; // Nobody listening: never load or encode the account
+  }
+
+  size_t published = 0;
+  for (auto encoding : ENCODINGS) {
+    uint8_t encoding_bits = 0;
+    for (int l = from; l <= level; ++l) {
+      encoding_bits |= interest_bit(static_cast<CommitmentLevel>(l), encoding);
+    }
+    if (((account_mask | program_mask) & encoding_bits) == 0) {
+      continue;
+    }
+    const std::string &value = encoded_value(change, encoding);
+
+    std::string account_result;
+    std::string program_result;
+    if (account_mask & encoding_bits) {
+      account_result.reserve(48 + value.size());
+      append_context(account_result, slot);
+      account_result.append(value).append("}");
+    }
+    if (program_mask & encoding_bits) {
+      program_result.reserve(96 + value.size());
+      append_context(program_result, slot);
+      program_result.append(R"({"pubkey":")")
+          .append(change.address)
+          .append(R"(","account":)")
+          .append(value)
+          .append("}}");
+    }
+
+    for (int l = from; l <= level; ++l) {
+      auto commitment = static_cast<CommitmentLevel>(l);
+      uint8_t bit = interest_bit(commitment, encoding);
+      if (account_mask & bit) {
+        websocket_server_->publish_account_notification(
+            change.address, account_result, commitment, encoding);
+        ++published;
+      }
+      if (program_mask & bit) {
+        websocket_server_->publish_program_notification(
+            change.owner_address, program_result, commitment, encoding);
+        ++published;
+      }
+    }
+  }
+  return published;
+}
+
+const std::string &
+AccountNotificationDispatcher::encoded_value(PendingChange &change,
+                                             AccountEncoding encoding) {
+  auto &value = change.value[static_cast<size_t>(encoding)];
+  if (!value.empty()) {
+    return value;
+  }
+
+  if (!change.loaded) {
+    change.loaded = true;
+    if (!change.record.deleted && loader_) {
+      change.account = loader_(change.record.pubkey_key(), change.record.slot);
+      accounts_loaded_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Closed (or already purged) accounts are reported as empty system-owned
+  // accounts with zero lamports, matching what RPC returns after a close
+  static const storage::AccountData closed = [] {
+    storage::AccountData data;
+    data.owner.assign(32, 0);
+    return data;
+  }();
+  const auto &account = change.account ? *change.account : closed;
+
+  bool base58 = encoding == AccountEncoding::BASE58;
+  value.reserve(160 + (base58 ? account.data.size() * 138 / 100
+                              : (account.data.size() + 2) / 3 * 4));
+  rpc_json::JsonWriter writer(value);
+  writer.begin_object().key("data").begin_array();
+  if (base58) {
+    writer.base58(account.data.data(), account.data.size()).string("base58");
+  } else {
+    writer.base64(account.data.data(), account.data.size()).string("base64");
+  }
+  writer.end_array();
+  writer.key("executable").boolean(account.executable);
+  writer.key("lamports").number(static_cast<uint64_t>(account.lamports));
+  writer.key("owner").base58(account.owner.data(), account.owner.size());
+  writer.key("rentEpoch").number(static_cast<uint64_t>(account.rent_epoch));
+  writer.key("space").number(static_cast<uint64_t>(account.data.size()));
+  writer.end_object();
+  encodings_.fetch_add(1, std::memory_order_relaxed);
+  return value;
+}
+
+AccountNotificationDispatcher::Stats
+AccountNotificationDispatcher::get_stats() const {
+  Stats stats;
+  stats.records_drained = records_drained_.load();
+  stats.duplicate_writes = duplicate_writes_.load();
+  stats.accounts_loaded = accounts_loaded_.load();
+  stats.encodings = encodings_.load();
+  stats.notifications_published = notifications_published_.load();
+  stats.slots_finalized = slots_finalized_.load();
+  stats.slots_discarded = slots_discarded_.load();
+  stats.feed_dropped = feed_ ? feed_->dropped() : 0;
+  return stats;
+}
+
+size_t AccountNotificationDispatcher::pending_slot_count() const {
+  return pending_slots_.load();
+}
+
+} // namespace network
+} // namespace slonana
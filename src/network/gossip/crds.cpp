@@ -1,56 +1,104 @@
 #include "network/gossip/crds.h"
 #include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <random>
+#include <utility>
 
 namespace slonana {
 namespace network {
 namespace gossip {
 
-Crds::Crds() : ordinal_counter_(0) {}
+namespace {
+
+void count_label(const CrdsValueLabel &label, std::atomic<size_t> &nodes,
+                 std::atomic<size_t> &votes, int delta) {
+  if (label.type == CrdsValueLabel::Type::ContactInfo) {
+    nodes.fetch_add(static_cast<size_t>(delta), std::memory_order_relaxed);
+  } else if (label.type == CrdsValueLabel::Type::Vote) {
+    votes.fetch_add(static_cast<size_t>(delta), std::memory_order_relaxed);
+  }
+}
+
+} // namespace
+
+Crds::Crds()
+    : ordinal_counter_(0), num_values_(0), num_nodes_(0), num_votes_(0) {}
 
 Crds::~Crds() {}
 
+Crds::Shard &Crds::shard_for(const PublicKey &pubkey) {
+  return const_cast<Shard &>(std::as_const(*this).shard_for(pubkey));
+}
+
+const Crds::Shard &Crds::shard_for(const PublicKey &pubkey) const {
+  // Pubkeys are uniformly distributed: any 8 bytes pick a shard
+  uint64_t bits = 0;
+  std::memcpy(&bits, pubkey.data(), std::min(pubkey.size(), sizeof(bits)));
+  return shards_[bits % NUM_SHARDS];
+}
+
 Result<bool> Crds::insert(const CrdsValue &value, uint64_t now,
                           GossipRoute route) {
-  std::lock_guard<std::mutex> lock(mutex_);
-
   CrdsValueLabel label = value.label();
-  PublicKey pk = value.pubkey();
+  Shard &shard = shard_for(label.pubkey);
+  std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
   // Check if value exists
-  auto it = table_.find(label);
+  auto it = shard.table.find(label);
 
-  if (it == table_.end()) {
+  if (it == shard.table.end()) {
     // New entry - insert it
-    VersionedCrdsValue versioned(value, ordinal_counter_++, now);
-    versioned.from_pull_response = (route == GossipRoute::PullResponse);
-    versioned.num_push_recv = (route == GossipRoute::PushMessage) ? 1 : 0;
-
-    table_[label] = versioned;
-    update_indices(label, versioned);
+    auto versioned = std::make_shared<VersionedCrdsValue>(
+        value, ordinal_counter_.fetch_add(1), now);
+    versioned->from_pull_response = (route == GossipRoute::PullResponse);
+    versioned->num_push_recv = (route == GossipRoute::PushMessage) ? 1 : 0;
+
+    ValuePtr published = std::move(versioned);
+    shard.table.emplace(label, published);
+    update_indices(shard, label, published);
+    lock.unlock();
+
+    {
+      std::lock_guard<std::mutex> filter_lock(filter_mutex_);
+      filter_set_.add(published->value.hash());
+    }
 
+    num_values_.fetch_add(1, std::memory_order_relaxed);
+    count_label(label, num_nodes_, num_votes_, 1);
     stats_.num_inserts++;
     return Result<bool>(true);
 
   } else {
     // Entry exists - check if we should update
-    if (!value.overrides(it->second.value)) {
+    if (!value.overrides(it->second->value)) {
       // Value doesn't override existing - reject
       stats_.num_failures++;
       return Result<bool>(std::string("Value does not override existing"));
     }
 
-    // Update the entry
-    VersionedCrdsValue versioned(value, ordinal_counter_++, now);
-    versioned.from_pull_response = (route == GossipRoute::PullResponse);
-    versioned.num_push_recv = (route == GossipRoute::PushMessage)
-                                  ? it->second.num_push_recv + 1
-                                  : it->second.num_push_recv;
+    // Publish a new version; readers holding the old one are unaffected
+    auto versioned = std::make_shared<VersionedCrdsValue>(
+        value, ordinal_counter_.fetch_add(1), now);
+    versioned->from_pull_response = (route == GossipRoute::PullResponse);
+    versioned->num_push_recv = (route == GossipRoute::PushMessage)
+                                   ? it->second->num_push_recv + 1
+                                   : it->second->num_push_recv;
 
     // Remove old from indices, add new
-    remove_from_indices(label, it->second);
-    it->second = versioned;
-    update_indices(label, versioned);
+    ValuePtr previous = std::move(it->second);
+    remove_from_indices(shard, label, previous);
+    it->second = std::move(versioned);
+    update_indices(shard, label, it->second);
+    ValuePtr published = it->second;
+    lock.unlock();
+
+    {
+      std::lock_guard<std::mutex> filter_lock(filter_mutex_);
+      filter_set_.remove(previous->value.hash());
+      filter_set_.add(published->value.hash());
+    }
 
     stats_.num_updates++;
     return Result<bool>(true);
@@ -58,40 +106,39 @@ Result<bool> Crds::insert(const CrdsValue &value, uint64_t now,
 }
 
 bool Crds::upserts(const CrdsValue &value) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-
   CrdsValueLabel label = value.label();
-  auto it = table_.find(label);
+  const Shard &shard = shard_for(label.pubkey);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
 
-  if (it == table_.end()) {
+  auto it = shard.table.find(label);
+  if (it == shard.table.end()) {
     return true; // New entry would be inserted
   }
 
-  return value.overrides(it->second.value);
+  return value.overrides(it->second->value);
 }
 
-const VersionedCrdsValue *Crds::get(const CrdsValueLabel &label) const {
-  std::lock_guard<std::mutex> lock(mutex_);
+Crds::ValuePtr Crds::get(const CrdsValueLabel &label) const {
+  const Shard &shard = shard_for(label.pubkey);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
 
-  auto it = table_.find(label);
-  if (it != table_.end()) {
-    return &it->second;
-  }
-  return nullptr;
+  auto it = shard.table.find(label);
+  return it != shard.table.end() ? it->second : nullptr;
 }
 
 std::vector<VersionedCrdsValue>
 Crds::get_records(const PublicKey &pubkey) const {
-  std::lock_guard<std::mutex> lock(mutex_);
+  const Shard &shard = shard_for(pubkey);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
 
   std::vector<VersionedCrdsValue> result;
 
-  auto it = records_.find(pubkey);
-  if (it != records_.end()) {
+  auto it = shard.records.find(pubkey);
+  if (it != shard.records.end()) {
     for (const auto &label : it->second) {
-      auto val_it = table_.find(label);
-      if (val_it != table_.end()) {
-        result.push_back(val_it->second);
+      auto val_it = shard.table.find(label);
+      if (val_it != shard.table.end()) {
+        result.push_back(*val_it->second);
       }
     }
   }
@@ -101,38 +148,43 @@ Crds::get_records(const PublicKey &pubkey) const {
 
 std::vector<VersionedCrdsValue> Crds::get_entries_after(uint64_t ordinal,
                                                          size_t limit) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  std::vector<VersionedCrdsValue> result;
-  result.reserve(std::min(limit, table_.size()));
-
-  for (const auto &[label, value] : table_) {
-    if (value.ordinal > ordinal) {
-      result.push_back(value);
-      if (result.size() >= limit) {
-        break;
-      }
+  // Each shard contributes at most `limit` of its oldest entries after the
+  // cursor; the smallest `limit` ordinals overall are among them
+  std::vector<ValuePtr> candidates;
+  for (const auto &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    size_t taken = 0;
+    for (auto it = shard.by_ordinal.upper_bound(ordinal);
+         it != shard.by_ordinal.end() && taken < limit; ++it, ++taken) {
+      candidates.push_back(it->second);
     }
   }
 
   // Sort by ordinal
-  std::sort(result.begin(), result.end(),
-            [](const VersionedCrdsValue &a, const VersionedCrdsValue &b) {
-              return a.ordinal < b.ordinal;
-            });
+  size_t count = std::min(limit, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + count,
+                    candidates.end(), [](const ValuePtr &a, const ValuePtr &b) {
+                      return a->ordinal < b->ordinal;
+                    });
 
+  std::vector<VersionedCrdsValue> result;
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    result.push_back(*candidates[i]);
+  }
   return result;
 }
 
 std::vector<ContactInfo> Crds::get_contact_infos() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-
   std::vector<ContactInfo> result;
-
-  for (const auto &[label, value] : table_) {
-    if (label.type == CrdsValueLabel::Type::ContactInfo) {
-      if (std::holds_alternative<ContactInfo>(value.value.data())) {
-        result.push_back(std::get<ContactInfo>(value.value.data()));
+  result.reserve(num_nodes_.load(std::memory_order_relaxed));
+
+  for (const auto &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    for (const auto &[label, value] : shard.table) {
+      if (label.type == CrdsValueLabel::Type::ContactInfo &&
+          std::holds_alternative<ContactInfo>(value->value.data())) {
+        result.push_back(std::get<ContactInfo>(value->value.data()));
       }
     }
   }
@@ -140,34 +192,32 @@ std::vector<ContactInfo> Crds::get_contact_infos() const {
   return result;
 }
 
-const ContactInfo *Crds::get_contact_info(const PublicKey &pubkey) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  CrdsValueLabel label(CrdsValueLabel::Type::ContactInfo, pubkey);
-  auto it = table_.find(label);
-
-  if (it != table_.end() &&
-      std::holds_alternative<ContactInfo>(it->second.value.data())) {
-    return &std::get<ContactInfo>(it->second.value.data());
+std::shared_ptr<const ContactInfo>
+Crds::get_contact_info(const PublicKey &pubkey) const {
+  auto value = get(CrdsValueLabel(CrdsValueLabel::Type::ContactInfo, pubkey));
+  if (!value || !std::holds_alternative<ContactInfo>(value->value.data())) {
+    return nullptr;
   }
-
-  return nullptr;
+  // Shares ownership of the stored version
+  return std::shared_ptr<const ContactInfo>(
+      value, &std::get<ContactInfo>(value->value.data()));
 }
 
 std::vector<Vote> Crds::get_votes(const PublicKey &pubkey) const {
-  std::lock_guard<std::mutex> lock(mutex_);
+  const Shard &shard = shard_for(pubkey);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
 
   std::vector<Vote> result;
 
   // Get all records for this pubkey
-  auto it = records_.find(pubkey);
-  if (it != records_.end()) {
+  auto it = shard.records.find(pubkey);
+  if (it != shard.records.end()) {
     for (const auto &label : it->second) {
       if (label.type == CrdsValueLabel::Type::Vote) {
-        auto val_it = table_.find(label);
-        if (val_it != table_.end() &&
-            std::holds_alternative<Vote>(val_it->second.value.data())) {
-          result.push_back(std::get<Vote>(val_it->second.value.data()));
+        auto val_it = shard.table.find(label);
+        if (val_it != shard.table.end() &&
+            std::holds_alternative<Vote>(val_it->second->value.data())) {
+          result.push_back(std::get<Vote>(val_it->second->value.data()));
         }
       }
     }
@@ -176,107 +226,210 @@ std::vector<Vote> Crds::get_votes(const PublicKey &pubkey) const {
   return result;
 }
 
-size_t Crds::trim(uint64_t now, uint64_t timeout) {
-  std::lock_guard<std::mutex> lock(mutex_);
+std::vector<Crds::ValuePtr>
+Crds::filter_pull_responses(const CrdsFilter &filter,
+                            const PublicKey &requester, uint64_t max_wallclock,
+                            size_t max_values) const {
+  std::vector<ValuePtr> result;
+  if (max_values == 0) {
+    return result;
+  }
 
-  std::vector<CrdsValueLabel> to_remove;
+  // Start at a random shard so capped responses do not always favour the
+  // same nodes
+  static thread_local std::mt19937 rng{std::random_device{}()};
+  size_t start = rng() % NUM_SHARDS;
+
+  // Only the requester's own shard can hold its values
+  const Shard *requester_shard = &shard_for(requester);
+
+  for (size_t i = 0; i < NUM_SHARDS && result.size() < max_values; ++i) {
+    const Shard &shard = shards_[(start + i) % NUM_SHARDS];
+    bool check_owner = &shard == requester_shard;
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    shard.by_hash.find(
+        filter.mask(), filter.mask_bits(),
+        [&](size_t index, const VersionedCrdsValue *entry) {
+          if (result.size() >= max_values) {
+            return;
+          }
+          const CrdsValue &value = entry->value;
+          if (value.wallclock() > max_wallclock ||
+              filter.contains(value.hash()) ||
+              (check_owner && value.pubkey() == requester)) {
+            return;
+          }
+          // Few entries survive the filter; only they pay for the lookup
+          auto it = shard.by_ordinal.find(index);
+          if (it != shard.by_ordinal.end()) {
+            result.push_back(it->second);
+          }
+        });
+  }
+
+  return result;
+}
 
-  // Find entries older than timeout
-  for (const auto &[label, value] : table_) {
-    if (now > value.local_timestamp &&
-        (now - value.local_timestamp) > timeout) {
-      to_remove.push_back(label);
+std::vector<CrdsFilter> Crds::build_pull_filters(size_t max_filters) {
+  std::lock_guard<std::mutex> filter_lock(filter_mutex_);
+
+  if (filter_set_.needs_resize()) {
+    // The table doubled or shrank to a quarter: re-split and refill
+    filter_set_.resize(CrdsFilterSet::mask_bits_for(len()));
+    for (const auto &shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard.mutex);
+      for (const auto &[label, value] : shard.table) {
+        filter_set_.add(value->value.hash());
+      }
     }
+    stats_.num_filter_rebuilds += filter_set_.num_filters();
   }
 
-  // Remove them
-  for (const auto &label : to_remove) {
-    auto it = table_.find(label);
-    if (it != table_.end()) {
-      remove_from_indices(label, it->second);
-      table_.erase(it);
-    }
+  std::vector<size_t> partitions(filter_set_.num_filters());
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    partitions[i] = i;
+  }
+  static thread_local std::mt19937 rng{std::random_device{}()};
+  if (max_filters < partitions.size()) {
+    std::shuffle(partitions.begin(), partitions.end(), rng);
+    partitions.resize(max_filters);
   }
 
-  stats_.num_trims += to_remove.size();
-  return to_remove.size();
+  std::vector<CrdsFilter> filters;
+  filters.reserve(partitions.size());
+  for (size_t partition : partitions) {
+    if (filter_set_.is_stale(partition)) {
+      rebuild_filter(partition);
+    }
+    filters.push_back(filter_set_.filter(partition));
+  }
+  return filters;
 }
 
-size_t Crds::len() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return table_.size();
+void Crds::rebuild_filter(size_t partition) {
+  filter_set_.reset(partition);
+  const CrdsFilter &filter = filter_set_.filter(partition);
+  uint64_t mask = filter.mask();
+  uint32_t mask_bits = filter.mask_bits();
+  for (const auto &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    shard.by_hash.find(mask, mask_bits,
+                       [&](size_t, const VersionedCrdsValue *value) {
+                         filter_set_.add(value->value.hash());
+                       });
+  }
+  stats_.num_filter_rebuilds++;
 }
 
-size_t Crds::num_nodes() const {
-  std::lock_guard<std::mutex> lock(mutex_);
+size_t Crds::trim(uint64_t now, uint64_t timeout) {
+  size_t removed = 0;
+
+  for (auto &shard : shards_) {
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-  size_t count = 0;
-  for (const auto &[label, value] : table_) {
-    if (label.type == CrdsValueLabel::Type::ContactInfo) {
-      count++;
+    // Find entries older than timeout
+    std::vector<CrdsValueLabel> to_remove;
+    for (const auto &[label, value] : shard.table) {
+      if (now > value->local_timestamp &&
+          (now - value->local_timestamp) > timeout) {
+        to_remove.push_back(label);
+      }
     }
-  }
-  return count;
-}
 
-size_t Crds::num_votes() const {
-  std::lock_guard<std::mutex> lock(mutex_);
+    // Remove them
+    std::vector<ValuePtr> trimmed;
+    trimmed.reserve(to_remove.size());
+    for (const auto &label : to_remove) {
+      auto it = shard.table.find(label);
+      if (it != shard.table.end()) {
+        remove_from_indices(shard, label, it->second);
+        trimmed.push_back(std::move(it->second));
+        shard.table.erase(it);
+        count_label(label, num_nodes_, num_votes_, -1);
+      }
+    }
+    lock.unlock();
+    removed += trimmed.size();
 
-  size_t count = 0;
-  for (const auto &[label, value] : table_) {
-    if (label.type == CrdsValueLabel::Type::Vote) {
-      count++;
+    if (!trimmed.empty()) {
+      std::lock_guard<std::mutex> filter_lock(filter_mutex_);
+      for (const auto &value : trimmed) {
+        filter_set_.remove(value->value.hash());
+      }
     }
   }
-  return count;
+
+  num_values_.fetch_sub(removed, std::memory_order_relaxed);
+  stats_.num_trims += removed;
+  return removed;
+}
+
+size_t Crds::len() const { return num_values_.load(std::memory_order_relaxed); }
+
+size_t Crds::num_nodes() const {
+  return num_nodes_.load(std::memory_order_relaxed);
+}
+
+size_t Crds::num_votes() const {
+  return num_votes_.load(std::memory_order_relaxed);
 }
 
 bool Crds::contains(const CrdsValueLabel &label) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return table_.find(label) != table_.end();
+  const Shard &shard = shard_for(label.pubkey);
+  std::shared_lock<std::shared_mutex> lock(shard.mutex);
+  return shard.table.find(label) != shard.table.end();
 }
 
 std::vector<CrdsValueLabel> Crds::get_labels() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-
   std::vector<CrdsValueLabel> result;
-  result.reserve(table_.size());
+  result.reserve(len());
 
-  for (const auto &[label, value] : table_) {
-    result.push_back(label);
+  for (const auto &shard : shards_) {
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    for (const auto &[label, value] : shard.table) {
+      result.push_back(label);
+    }
   }
 
   return result;
 }
 
 void Crds::clear() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  table_.clear();
-  records_.clear();
+  for (auto &shard : shards_) {
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.table.clear();
+    shard.records.clear();
+    shard.by_ordinal.clear();
+    shard.by_hash.clear();
+  }
+  {
+    std::lock_guard<std::mutex> filter_lock(filter_mutex_);
+    filter_set_.resize(0);
+  }
   ordinal_counter_ = 0;
+  num_values_ = 0;
+  num_nodes_ = 0;
+  num_votes_ = 0;
 }
 
-bool Crds::overrides(const CrdsValue &value,
-                     const VersionedCrdsValue &existing) const {
-  return value.overrides(existing.value);
-}
-
-void Crds::update_indices(const CrdsValueLabel &label,
-                           const VersionedCrdsValue &value) {
-  PublicKey pk = value.value.pubkey();
-  records_[pk].insert(label);
+void Crds::update_indices(Shard &shard, const CrdsValueLabel &label,
+                          const ValuePtr &value) {
+  shard.records[label.pubkey].insert(label);
+  shard.by_ordinal.emplace(value->ordinal, value);
+  shard.by_hash.insert(value->ordinal, value.get());
 }
 
-void Crds::remove_from_indices(const CrdsValueLabel &label,
-                                const VersionedCrdsValue &value) {
-  PublicKey pk = value.value.pubkey();
-  auto it = records_.find(pk);
-  if (it != records_.end()) {
+void Crds::remove_from_indices(Shard &shard, const CrdsValueLabel &label,
+                               const ValuePtr &value) {
+  auto it = shard.records.find(label.pubkey);
+  if (it != shard.records.end()) {
     it->second.erase(label);
     if (it->second.empty()) {
-      records_.erase(it);
+      shard.records.erase(it);
     }
   }
+  shard.by_ordinal.erase(value->ordinal);
+  shard.by_hash.remove(value->ordinal, value.get());
 }
 
 } // namespace gossip
@@ -0,0 +1,85 @@
+#include "network/gossip/crds_gossip_pull.h"
+#include <algorithm>
+
+namespace slonana {
+namespace network {
+namespace gossip {
+
+CrdsFilterSet::CrdsFilterSet(uint32_t mask_bits) : num_items_(0) {
+  resize(mask_bits);
+}
+
+uint32_t CrdsFilterSet::mask_bits_for(size_t num_items) {
+  uint32_t mask_bits = 0;
+  while ((MAX_ITEMS_PER_FILTER << mask_bits) < num_items && mask_bits < 20) {
+    ++mask_bits;
+  }
+  return mask_bits;
+}
+
+void CrdsFilterSet::add(const Hash &hash) {
+  auto &partition = partitions_[partition_of(hash)];
+  partition.filter.add(hash);
+  ++partition.live;
+  ++num_items_;
+}
+
+void CrdsFilterSet::remove(const Hash &hash) {
+  auto &partition = partitions_[partition_of(hash)];
+  if (partition.live > 0) {
+    --partition.live;
+    --num_items_;
+  }
+  ++partition.stale;
+}
+
+size_t CrdsFilterSet::partition_of(const Hash &hash) const {
+  return mask_bits_ == 0 ? 0
+                         : static_cast<size_t>(hash_prefix(hash) >>
+                                               (64 - mask_bits_));
+}
+
+bool CrdsFilterSet::needs_resize() const {
+  // Shrinking waits for the table to drop to a quarter, so a table hovering
+  // at a boundary does not flip between sizes
+  uint32_t wanted = mask_bits_for(num_items_);
+  return wanted > mask_bits_ || wanted + 2 <= mask_bits_;
+}
+
+bool CrdsFilterSet::is_stale(size_t partition) const {
+  // Stale bits cost as much false-positive rate as live ones
+  const auto &p = partitions_[partition];
+  return p.live + p.stale > MAX_ITEMS_PER_FILTER || p.stale * 4 > p.live;
+}
+
+void CrdsFilterSet::resize(uint32_t mask_bits) {
+  mask_bits_ = std::min<uint32_t>(mask_bits, 20);
+  partitions_.clear();
+  partitions_.resize(size_t{1} << mask_bits_);
+  for (size_t i = 0; i < partitions_.size(); ++i) {
+    partitions_[i].filter = make_filter(i);
+  }
+  num_items_ = 0;
+}
+
+void CrdsFilterSet::reset(size_t partition) {
+  auto &p = partitions_[partition];
+  num_items_ -= p.live;
+  p.filter = make_filter(partition);
+  p.live = 0;
+  p.stale = 0;
+}
+
+CrdsFilter CrdsFilterSet::make_filter(size_t partition) const {
+  // Agave: the partition index in the top bits, all ones below
+  uint64_t ones = mask_bits_ == 0 ? ~0ULL : (~0ULL >> mask_bits_);
+  uint64_t mask = mask_bits_ == 0
+                      ? ~0ULL
+                      : (static_cast<uint64_t>(partition) << (64 - mask_bits_)) |
+                            ones;
+  return CrdsFilter(MAX_ITEMS_PER_FILTER, mask, mask_bits_);
+}
+
+} // namespace gossip
+} // namespace network
+} // namespace slonana
@@ -1,4 +1,5 @@
 #include "network/gossip/crds_shards.h"
+#include "network/gossip/protocol.h"
 #include <algorithm>
 #include <random>
 
@@ -6,93 +7,55 @@ namespace slonana {
 namespace network {
 namespace gossip {
 
-CrdsShards::CrdsShards(size_t num_shards)
-    : num_shards_(num_shards), shards_(num_shards) {}
-
-size_t CrdsShards::shard_index(const PublicKey &pubkey) const {
-  if (pubkey.empty() || num_shards_ == 0) {
-    return 0;
-  }
-  
-  // Hash the pubkey to determine shard
-  uint64_t hash = 0;
-  for (size_t i = 0; i < std::min(pubkey.size(), size_t(8)); ++i) {
-    hash = (hash << 8) | pubkey[i];
+CrdsShards::CrdsShards(size_t num_shards) : shard_bits_(0), size_(0) {
+  while ((size_t{1} << shard_bits_) < num_shards && shard_bits_ < 24) {
+    ++shard_bits_;
   }
-  
-  return hash % num_shards_;
+  shards_.resize(size_t{1} << shard_bits_);
 }
 
 void CrdsShards::insert(size_t index, const VersionedCrdsValue *value) {
   if (!value) return;
-  
-  std::lock_guard<std::mutex> lock(mutex_);
-  
-  PublicKey pubkey = value->value.pubkey();
-  size_t shard = shard_index(pubkey);
-  shards_[shard].insert(index);
+
+  uint64_t prefix = hash_prefix(value->value.hash());
+  if (shards_[shard_of(prefix)].emplace(index, Entry{prefix, value}).second) {
+    ++size_;
+  }
 }
 
 void CrdsShards::remove(size_t index, const VersionedCrdsValue *value) {
   if (!value) return;
-  
-  std::lock_guard<std::mutex> lock(mutex_);
-  
-  PublicKey pubkey = value->value.pubkey();
-  size_t shard = shard_index(pubkey);
-  shards_[shard].erase(index);
-}
 
-std::unordered_set<size_t> CrdsShards::get_indices(const PublicKey &pubkey) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  
-  size_t shard = shard_index(pubkey);
-  return shards_[shard];
+  uint64_t prefix = hash_prefix(value->value.hash());
+  size_ -= shards_[shard_of(prefix)].erase(index);
 }
 
 std::vector<size_t> CrdsShards::sample(size_t max_count) const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  
   std::vector<size_t> result;
-  result.reserve(max_count);
-  
-  // Collect all indices from all shards
-  for (const auto &shard : shards_) {
-    for (size_t index : shard) {
-      result.push_back(index);
+  result.reserve(std::min(max_count, size_));
+
+  // Start at a random shard so repeated samples cover the whole table
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  size_t start = std::uniform_int_distribution<size_t>(0, shards_.size() - 1)(gen);
+  for (size_t i = 0; i < shards_.size() && result.size() < max_count; ++i) {
+    for (const auto &entry : shards_[(start + i) % shards_.size()]) {
+      result.push_back(entry.first);
       if (result.size() >= max_count) {
         break;
       }
     }
-    if (result.size() >= max_count) {
-      break;
-    }
   }
-  
-  // Shuffle for randomness
-  std::random_device rd;
-  std::mt19937 gen(rd());
+
   std::shuffle(result.begin(), result.end(), gen);
-  
   return result;
 }
 
-size_t CrdsShards::size() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  
-  size_t total = 0;
-  for (const auto &shard : shards_) {
-    total += shard.size();
-  }
-  return total;
-}
-
 void CrdsShards::clear() {
-  std::lock_guard<std::mutex> lock(mutex_);
-  
   for (auto &shard : shards_) {
     shard.clear();
   }
+  size_ = 0;
 }
 
 } // namespace gossip
@@ -85,7 +85,8 @@ std::vector<ContactInfo> GossipService::get_contact_infos() const {
   return crds_->get_contact_infos();
 }
 
-const ContactInfo *GossipService::get_contact_info(const PublicKey &pubkey) const {
+std::shared_ptr<const ContactInfo>
+GossipService::get_contact_info(const PublicKey &pubkey) const {
   return crds_->get_contact_info(pubkey);
 }
 
@@ -131,14 +132,15 @@ void GossipService::receiver_thread() {
   std::cout << "Gossip receiver thread started" << std::endl;
 
   while (!shutdown_requested_.load()) {
-    auto result = receive_message();
+    std::string from_addr;
+    auto result = receive_message(from_addr);
     if (result.is_ok()) {
       Protocol msg = std::move(result).value();
 
       // Handle based on message type
       switch (msg.type()) {
       case Protocol::Type::PullRequest:
-        handle_pull_request(msg, "");
+        handle_pull_request(msg, from_addr);
         break;
       case Protocol::Type::PullResponse:
         handle_pull_response(msg);
@@ -150,7 +152,7 @@ void GossipService::receiver_thread() {
         handle_prune_message(msg);
         break;
       case Protocol::Type::PingMessage:
-        handle_ping_message(msg, "");
+        handle_ping_message(msg, from_addr);
         break;
       case Protocol::Type::PongMessage:
         handle_pong_message(msg);
@@ -246,9 +248,44 @@ void GossipService::ping_pong_thread() {
 // Message handling
 void GossipService::handle_pull_request(const Protocol &msg,
                                         const std::string &from_addr) {
-  // In production: respond with values not in their filter
+  const auto *filter = msg.get_filter();
+  const auto *values = msg.get_values();
+  if (!filter || !values || values->empty() || from_addr.empty())
+    return;
+
+  // The caller's contact info travels with the request
+  const CrdsValue &caller = values->front();
+  uint64_t now = timestamp();
+  crds_->insert(caller, now, GossipRoute::PullRequest);
+
+  // Values newer than the caller's clock are held back so a node with a
+  // lagging clock cannot be flooded with entries it would reject
+  uint64_t max_wallclock = std::max(caller.wallclock(), now);
+  auto matches = crds_->filter_pull_responses(
+      *filter, caller.pubkey(), max_wallclock,
+      config_.max_pull_response_values);
+  if (matches.empty())
+    return;
+
+  std::vector<CrdsValue> response;
+  response.reserve(matches.size());
+  for (const auto &entry : matches) {
+    response.push_back(entry->value);
+  }
+
+  auto chunks = split_gossip_messages<CrdsValue>(
+      PULL_RESPONSE_MAX_PAYLOAD_SIZE, response);
+  size_t sent = 0;
+  for (const auto &chunk : chunks) {
+    Protocol pull_response =
+        Protocol::create_pull_response(config_.node_pubkey, chunk);
+    if (send_message(pull_response, from_addr)) {
+      sent++;
+    }
+  }
+
   std::lock_guard<std::mutex> lock(stats_mutex_);
-  stats_.pull_responses_sent++;
+  stats_.pull_responses_sent += sent;
 }
 
 void GossipService::handle_pull_response(const Protocol &msg) {
@@ -292,14 +329,15 @@ void GossipService::handle_prune_message(const Protocol &msg) {
 void GossipService::handle_ping_message(const Protocol &msg,
                                         const std::string &from_addr) {
   const auto *ping = msg.get_ping();
-  if (!ping || !ping->verify())
+  if (!ping || !ping->verify() || from_addr.empty())
     return;
 
-  // Send pong response
+  // The pong echoes the token back to the address the ping came from
   PongMessage pong(config_.node_pubkey, ping->token);
   Protocol pong_msg = Protocol::create_pong_message(pong);
+  if (!send_message(pong_msg, from_addr))
+    return;
 
-  // In production: send to from_addr
   std::lock_guard<std::mutex> lock(stats_mutex_);
   stats_.pong_messages_sent++;
 }
@@ -376,14 +414,33 @@ void GossipService::do_pull_gossip() {
   if (pull_peers.empty())
     return;
 
-  Protocol pull_request = build_pull_request();
-
+  // Only peers that advertise a gossip address can be asked
+  std::vector<std::string> peer_addrs;
+  peer_addrs.reserve(pull_peers.size());
   for (const auto &peer : pull_peers) {
-    // In production: send to peer's gossip address
+    auto contact = crds_->get_contact_info(peer);
+    if (contact && !contact->addrs.empty() && !contact->addrs.front().empty()) {
+      peer_addrs.push_back(contact->addrs.front());
+    }
+  }
+  if (peer_addrs.empty())
+    return;
+
+  // Each sampled partition goes to one peer, spreading the table over them
+  auto pull_requests = build_pull_requests(config_.max_pull_filters);
+
+  size_t sent = 0;
+  for (size_t i = 0; i < pull_requests.size(); ++i) {
+    if (send_message(pull_requests[i], peer_addrs[i % peer_addrs.size()])) {
+      sent++;
+    }
+  }
+  {
     std::lock_guard<std::mutex> lock(stats_mutex_);
-    stats_.pull_requests_sent++;
+    stats_.pull_requests_sent += sent;
   }
 
+  std::lock_guard<std::mutex> lock(pull_state_.mutex);
   pull_state_.last_pull_time = timestamp();
 }
 
@@ -399,26 +456,24 @@ std::vector<PublicKey> GossipService::select_pull_peers(size_t count) {
   return selected;
 }
 
-Protocol GossipService::build_pull_request() {
-  // Build filter from our CRDS table
-  std::lock_guard<std::mutex> lock(pull_state_.mutex);
+std::vector<Protocol> GossipService::build_pull_requests(size_t max_filters) {
+  // Filters are maintained by the CRDS table as values come and go
+  auto filters = crds_->build_pull_filters(max_filters);
 
-  auto labels = crds_->get_labels();
-  pull_state_.filter = CrdsFilter(labels.size());
-
-  for (const auto &label : labels) {
-    auto *entry = crds_->get(label);
-    if (entry) {
-      pull_state_.filter.add(entry->value.hash());
-    }
-  }
-
-  // Create our contact info
+  // Create our contact info; the gossip address comes first, as peers
+  // read it from addrs[0]
   ContactInfo self_info(config_.node_pubkey);
   self_info.shred_version = config_.shred_version;
+  self_info.addrs.push_back(config_.bind_address + ":" +
+                            std::to_string(config_.bind_port));
   CrdsValue self_value(self_info);
 
-  return Protocol::create_pull_request(pull_state_.filter, self_value);
+  std::vector<Protocol> requests;
+  requests.reserve(filters.size());
+  for (const auto &filter : filters) {
+    requests.push_back(Protocol::create_pull_request(filter, self_value));
+  }
+  return requests;
 }
 
 // Network operations
@@ -458,7 +513,7 @@ bool GossipService::send_message(const Protocol &msg,
   return sent == static_cast<ssize_t>(data.size());
 }
 
-Result<Protocol> GossipService::receive_message() {
+Result<Protocol> GossipService::receive_message(std::string &from_addr) {
   std::lock_guard<std::mutex> lock(socket_mutex_);
   
   if (gossip_socket_ < 0) {
@@ -487,6 +542,11 @@ Result<Protocol> GossipService::receive_message() {
   
   // Resize buffer to actual size
   buffer.resize(received);
+
+  char ip[INET_ADDRSTRLEN];
+  if (inet_ntop(AF_INET, &sender.sin_addr, ip, sizeof(ip))) {
+    from_addr = std::string(ip) + ":" + std::to_string(ntohs(sender.sin_port));
+  }
   
   // Deserialize
   return Serializer::deserialize_protocol(buffer);
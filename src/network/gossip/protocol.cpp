@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cstring>
 #include <random>
+#include <stdexcept>
 
 namespace slonana {
 namespace network {
@@ -33,29 +34,69 @@ std::vector<uint8_t> PruneData::serialize() const {
 }
 
 // CrdsFilter implementations
-CrdsFilter::CrdsFilter() : num_bits_(1024), num_hashes_(3) {
+CrdsFilter::CrdsFilter()
+    : num_bits_(1024), num_hashes_(3), mask_(~0ULL), mask_bits_(0) {
   bits_.resize((num_bits_ + 63) / 64, 0);
 }
 
-CrdsFilter::CrdsFilter(size_t num_items)
-    : num_bits_(num_items * 10), num_hashes_(3) {
+CrdsFilter::CrdsFilter(size_t num_items) : CrdsFilter(num_items, ~0ULL, 0) {}
+
+CrdsFilter::CrdsFilter(size_t num_items, uint64_t mask, uint32_t mask_bits)
+    : num_bits_(std::max<size_t>(num_items * 10, 64)), num_hashes_(3),
+      mask_(mask), mask_bits_(std::min<uint32_t>(mask_bits, 64)) {
   bits_.resize((num_bits_ + 63) / 64, 0);
 }
 
+bool CrdsFilter::test_mask(const Hash &hash) const {
+  // Agave: the low (64 - mask_bits) bits of mask are all ones
+  uint64_t ones = mask_bits_ >= 64 ? 0 : (~0ULL >> mask_bits_);
+  return (hash_prefix(hash) | ones) == (mask_ | ones);
+}
+
+uint64_t hash_prefix(const Hash &hash) {
+  uint64_t prefix = 0;
+  for (size_t i = 0; i < 8 && i < hash.size(); ++i) {
+    prefix |= static_cast<uint64_t>(hash[i]) << (8 * i);
+  }
+  return prefix;
+}
+
+namespace {
+
+/**
+ * Value hashes are SHA-256 digests, so their words are already uniform.
+ * Probe i is h1 + i * h2 (Kirsch-Mitzenmacher) mapped onto the bit range by
+ * multiply-shift: a fixed run of multiplies the compiler can vectorize,
+ * instead of a full SipHash pass per probe. Bytes 0..7 select the mask
+ * partition, so the probes use the next two words.
+ */
+inline void probe_seeds(const Hash &hash, uint64_t &h1, uint64_t &h2) {
+  if (hash.size() >= 24) {
+    std::memcpy(&h1, hash.data() + 8, sizeof(h1));
+    std::memcpy(&h2, hash.data() + 16, sizeof(h2));
+  } else {
+    h1 = CryptoUtils::siphash24(hash, 0, 1);
+    h2 = CryptoUtils::siphash24(hash, 1, 2);
+  }
+  h2 |= 1; // Odd step: probes never collapse onto one bit
+}
+
+inline uint64_t probe_bit(uint64_t h, uint64_t num_bits) {
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(h) * num_bits) >>
+                               64);
+}
+
+} // namespace
+
 void CrdsFilter::add(const Hash &hash) {
   if (hash.empty())
     return;
 
+  uint64_t h1, h2;
+  probe_seeds(hash, h1, h2);
   for (size_t i = 0; i < num_hashes_; ++i) {
-    // Use SipHash for production-grade hashing
-    uint64_t h = CryptoUtils::siphash24(hash, i, i + 1);
-    h = h % num_bits_;
-
-    size_t word_idx = h / 64;
-    size_t bit_idx = h % 64;
-    if (word_idx < bits_.size()) {
-      bits_[word_idx] |= (1ULL << bit_idx);
-    }
+    uint64_t bit = probe_bit(h1 + i * h2, num_bits_);
+    bits_[bit / 64] |= (1ULL << (bit % 64));
   }
 }
 
@@ -63,32 +104,60 @@ bool CrdsFilter::contains(const Hash &hash) const {
   if (hash.empty())
     return false;
 
+  uint64_t h1, h2;
+  probe_seeds(hash, h1, h2);
+  uint64_t present = 1;
   for (size_t i = 0; i < num_hashes_; ++i) {
-    // Use SipHash for production-grade hashing
-    uint64_t h = CryptoUtils::siphash24(hash, i, i + 1);
-    h = h % num_bits_;
-
-    size_t word_idx = h / 64;
-    size_t bit_idx = h % 64;
-    if (word_idx >= bits_.size() ||
-        !(bits_[word_idx] & (1ULL << bit_idx))) {
-      return false;
-    }
+    uint64_t bit = probe_bit(h1 + i * h2, num_bits_);
+    present &= bits_[bit / 64] >> (bit % 64);
   }
-
-  return true;
+  return present & 1;
 }
 
 void CrdsFilter::clear() { std::fill(bits_.begin(), bits_.end(), 0); }
 
 std::vector<uint8_t> CrdsFilter::serialize() const {
+  // Probe count, bloom words, bit count, then the partition. Probes come
+  // from the value hash rather than per-filter keys, so only their count
+  // travels
   std::vector<uint8_t> result;
-  // Simplified serialization
+  result.reserve(8 * bits_.size() + 44);
+  Serializer::write_u64(result, num_hashes_);
+  Serializer::write_u64(result, bits_.size());
+  for (uint64_t word : bits_) {
+    Serializer::write_u64(result, word);
+  }
+  Serializer::write_u64(result, num_bits_);
+  Serializer::write_u64(result, mask_);
+  Serializer::write_u32(result, mask_bits_);
   return result;
 }
 
 CrdsFilter CrdsFilter::deserialize(const std::vector<uint8_t> &data) {
-  return CrdsFilter();
+  const uint8_t *ptr = data.data();
+  const uint8_t *end = data.data() + data.size();
+
+  CrdsFilter filter;
+  filter.num_hashes_ = Serializer::read_u64(ptr, end);
+  uint64_t words = Serializer::read_u64(ptr, end);
+  if (words > static_cast<uint64_t>(end - ptr) / 8) {
+    throw std::runtime_error("Filter bits exceed buffer");
+  }
+  filter.bits_.resize(words);
+  for (auto &word : filter.bits_) {
+    word = Serializer::read_u64(ptr, end);
+  }
+  filter.num_bits_ = Serializer::read_u64(ptr, end);
+  filter.mask_ = Serializer::read_u64(ptr, end);
+  filter.mask_bits_ = Serializer::read_u32(ptr, end);
+
+  // A peer's filter drives our probes, so its shape must be self-consistent
+  if (filter.num_hashes_ == 0 || filter.num_hashes_ > 64 ||
+      filter.num_bits_ == 0 || (filter.num_bits_ + 63) / 64 != words ||
+      filter.mask_bits_ > 64) {
+    throw std::runtime_error("Malformed CRDS filter");
+  }
+  return filter;
 }
 
 // PingMessage implementations
@@ -234,8 +303,7 @@ split_gossip_messages(size_t max_chunk_size, const std::vector<T> &values) {
   size_t current_size = 0;
 
   for (const auto &value : values) {
-    // Rough size estimation - in production use proper serialization
-    size_t value_size = sizeof(T);
+    size_t value_size = value.serialized_size();
 
     if (current_size + value_size > max_chunk_size && !current_chunk.empty()) {
       // Start a new chunk
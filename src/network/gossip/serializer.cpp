@@ -1,4 +1,5 @@
 #include "network/gossip/serializer.h"
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -76,6 +77,36 @@ std::vector<uint8_t> Serializer::read_bytes(const uint8_t *&ptr, const uint8_t *
   return result;
 }
 
+size_t Serializer::read_len(const uint8_t *&ptr, const uint8_t *end,
+                            size_t min_size) {
+  uint64_t len = read_u64(ptr, end);
+  // A length the remaining input cannot hold is rejected before allocating
+  if (len > static_cast<uint64_t>(end - ptr) / std::max<size_t>(min_size, 1))
+    throw std::runtime_error("Length exceeds buffer");
+  return static_cast<size_t>(len);
+}
+
+std::vector<uint8_t> Serializer::read_sized_bytes(const uint8_t *&ptr,
+                                                  const uint8_t *end) {
+  size_t len = read_len(ptr, end, 1);
+  return read_bytes(ptr, end, len);
+}
+
+std::string Serializer::read_string(const uint8_t *&ptr, const uint8_t *end) {
+  auto bytes = read_sized_bytes(ptr, end);
+  return std::string(bytes.begin(), bytes.end());
+}
+
+std::vector<uint64_t> Serializer::read_slots(const uint8_t *&ptr,
+                                             const uint8_t *end) {
+  size_t count = read_len(ptr, end, 8);
+  std::vector<uint64_t> slots(count);
+  for (auto &slot : slots) {
+    slot = read_u64(ptr, end);
+  }
+  return slots;
+}
+
 std::vector<uint8_t> Serializer::serialize(const CrdsData &data) {
   std::vector<uint8_t> buf;
   
@@ -196,7 +227,9 @@ std::vector<uint8_t> Serializer::serialize(const Protocol &msg) {
   // Type-specific data
   switch (msg.type()) {
     case Protocol::Type::PullRequest: {
-      // Serialize filter and value
+      // Filter (length-prefixed), then the caller's contact info
+      const auto *filter = msg.get_filter();
+      write_bytes(buf, filter ? filter->serialize() : CrdsFilter().serialize());
       const auto *values = msg.get_values();
       if (values && !values->empty()) {
         auto val_buf = serialize((*values)[0]);
@@ -249,42 +282,161 @@ std::vector<uint8_t> Serializer::serialize(const Protocol &msg) {
   return buf;
 }
 
+CrdsData Serializer::read_crds_data(const uint8_t *&ptr, const uint8_t *end) {
+  // Mirrors serialize(const CrdsData &) field for field
+  uint8_t tag = read_u8(ptr, end);
+  switch (tag) {
+  case 0: {
+    ContactInfo ci;
+    ci.pubkey = read_sized_bytes(ptr, end);
+    ci.wallclock = read_u64(ptr, end);
+    ci.outset = read_u64(ptr, end);
+    ci.shred_version = read_u16(ptr, end);
+    ci.version = read_string(ptr, end);
+    size_t count = read_len(ptr, end, 8);
+    ci.addrs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      ci.addrs.push_back(read_string(ptr, end));
+    }
+    return ci;
+  }
+  case 1: {
+    Vote vote;
+    vote.from = read_sized_bytes(ptr, end);
+    vote.slots = read_slots(ptr, end);
+    vote.vote_hash = read_sized_bytes(ptr, end);
+    vote.wallclock = read_u64(ptr, end);
+    vote.vote_timestamp = read_u64(ptr, end);
+    return vote;
+  }
+  case 2: {
+    LowestSlot ls;
+    ls.from = read_sized_bytes(ptr, end);
+    ls.lowest = read_u64(ptr, end);
+    ls.wallclock = read_u64(ptr, end);
+    return ls;
+  }
+  case 3: {
+    EpochSlots es;
+    es.from = read_sized_bytes(ptr, end);
+    es.slots = read_slots(ptr, end);
+    es.wallclock = read_u64(ptr, end);
+    return es;
+  }
+  case 4: {
+    NodeInstance ni;
+    ni.from = read_sized_bytes(ptr, end);
+    ni.instance_timestamp = read_u64(ptr, end);
+    ni.wallclock = read_u64(ptr, end);
+    return ni;
+  }
+  case 5: {
+    SnapshotHashes sh;
+    sh.from = read_sized_bytes(ptr, end);
+    size_t count = read_len(ptr, end, 16);
+    sh.hashes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t slot = read_u64(ptr, end);
+      sh.hashes.emplace_back(slot, read_sized_bytes(ptr, end));
+    }
+    sh.wallclock = read_u64(ptr, end);
+    return sh;
+  }
+  case 6: {
+    RestartLastVotedForkSlots rlvfs;
+    rlvfs.from = read_sized_bytes(ptr, end);
+    rlvfs.slots = read_slots(ptr, end);
+    rlvfs.hash = read_sized_bytes(ptr, end);
+    rlvfs.wallclock = read_u64(ptr, end);
+    return rlvfs;
+  }
+  case 7: {
+    RestartHeaviestFork rhf;
+    rhf.from = read_sized_bytes(ptr, end);
+    rhf.slot = read_u64(ptr, end);
+    rhf.hash = read_sized_bytes(ptr, end);
+    rhf.wallclock = read_u64(ptr, end);
+    return rhf;
+  }
+  default:
+    throw std::runtime_error("Unknown CRDS data tag " + std::to_string(tag));
+  }
+}
+
+CrdsValue Serializer::read_crds_value(const uint8_t *&ptr, const uint8_t *end) {
+  auto signature = read_sized_bytes(ptr, end);
+  auto data = read_crds_data(ptr, end);
+  return CrdsValue(data, signature);
+}
+
 Result<CrdsValue> Serializer::deserialize_crds_value(const std::vector<uint8_t> &data) {
-  // Simplified deserialization - full implementation would parse all fields
   try {
     const uint8_t *ptr = data.data();
     const uint8_t *end = data.data() + data.size();
-    
-    // Read signature
-    uint64_t sig_len = read_u64(ptr, end);
-    auto signature = read_bytes(ptr, end, sig_len);
-    
-    // Read data type tag
-    uint8_t tag = read_u8(ptr, end);
-    
-    // For now, create a basic ContactInfo
-    ContactInfo ci;
-    CrdsValue value(ci);
-    
-    return Result<CrdsValue>(value);
+    return Result<CrdsValue>(read_crds_value(ptr, end));
   } catch (const std::exception &e) {
     return Result<CrdsValue>(std::string("Deserialization failed: ") + e.what());
   }
 }
 
 Result<Protocol> Serializer::deserialize_protocol(const std::vector<uint8_t> &data) {
-  // Simplified deserialization
   try {
     const uint8_t *ptr = data.data();
     const uint8_t *end = data.data() + data.size();
-    
+
     uint8_t type_tag = read_u8(ptr, end);
-    uint64_t from_len = read_u64(ptr, end);
-    auto from_pk = read_bytes(ptr, end, from_len);
-    
-    // Create empty protocol message
-    Protocol msg = Protocol::create_push_message(from_pk, std::vector<CrdsValue>());
-    return Result<Protocol>(msg);
+    auto from_pk = read_sized_bytes(ptr, end);
+
+    switch (static_cast<Protocol::Type>(type_tag)) {
+    case Protocol::Type::PullRequest: {
+      auto filter = CrdsFilter::deserialize(read_sized_bytes(ptr, end));
+      auto caller = read_crds_value(ptr, end);
+      return Result<Protocol>(Protocol::create_pull_request(filter, caller));
+    }
+    case Protocol::Type::PullResponse:
+    case Protocol::Type::PushMessage: {
+      // Every value carries at least its signature length and data tag
+      size_t count = read_len(ptr, end, 9);
+      std::vector<CrdsValue> values;
+      values.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        values.push_back(read_crds_value(ptr, end));
+      }
+      return Result<Protocol>(
+          static_cast<Protocol::Type>(type_tag) == Protocol::Type::PullResponse
+              ? Protocol::create_pull_response(from_pk, values)
+              : Protocol::create_push_message(from_pk, values));
+    }
+    case Protocol::Type::PruneMessage: {
+      PruneData prune;
+      prune.pubkey = read_sized_bytes(ptr, end);
+      size_t count = read_len(ptr, end, 8);
+      prune.prunes.reserve(count);
+      for (size_t i = 0; i < count; ++i) {
+        prune.prunes.push_back(read_sized_bytes(ptr, end));
+      }
+      prune.destination = read_sized_bytes(ptr, end);
+      prune.wallclock = read_u64(ptr, end);
+      prune.signature = read_sized_bytes(ptr, end);
+      return Result<Protocol>(Protocol::create_prune_message(from_pk, prune));
+    }
+    case Protocol::Type::PingMessage: {
+      PingMessage ping;
+      ping.from = read_sized_bytes(ptr, end);
+      ping.token = read_sized_bytes(ptr, end);
+      ping.signature = read_sized_bytes(ptr, end);
+      return Result<Protocol>(Protocol::create_ping_message(ping));
+    }
+    case Protocol::Type::PongMessage: {
+      PongMessage pong;
+      pong.from = read_sized_bytes(ptr, end);
+      pong.token = read_sized_bytes(ptr, end);
+      pong.signature = read_sized_bytes(ptr, end);
+      return Result<Protocol>(Protocol::create_pong_message(pong));
+    }
+    }
+    return Result<Protocol>(std::string("Unknown protocol message type ") +
+                            std::to_string(type_tag));
   } catch (const std::exception &e) {
     return Result<Protocol>(std::string("Deserialization failed: ") + e.what());
   }
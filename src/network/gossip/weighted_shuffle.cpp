@@ -1,6 +1,5 @@
 #include "network/gossip/weighted_shuffle.h"
 #include <algorithm>
-#include <numeric>
 
 namespace slonana {
 namespace network {
@@ -8,79 +7,140 @@ namespace gossip {
 
 WeightedShuffle::WeightedShuffle(const std::vector<WeightedNode> &nodes,
                                  uint64_t seed)
-    : nodes_(nodes), current_index_(0), seed_(seed), rng_(seed) {
-  compute_shuffle();
-}
-
-uint64_t WeightedShuffle::compute_weight_sum() const {
-  uint64_t sum = 0;
+    : nodes_(nodes), seed_(ChaChaRng::seed_from_u64(seed)), rng_(seed_) {
+  weights_.reserve(nodes_.size());
   for (const auto &node : nodes_) {
-    sum += node.stake;
+    weights_.push_back(node.stake);
   }
-  return sum;
+  build();
 }
 
-void WeightedShuffle::compute_shuffle() {
-  if (nodes_.empty()) {
-    return;
-  }
-  
-  shuffled_indices_.clear();
-  shuffled_indices_.reserve(nodes_.size());
-  
-  // Initialize indices
-  for (size_t i = 0; i < nodes_.size(); ++i) {
-    shuffled_indices_.push_back(i);
-  }
-  
-  // Weighted shuffle algorithm
-  // For each position, select from remaining nodes with probability
-  // proportional to stake
-  for (size_t i = 0; i < nodes_.size() - 1; ++i) {
-    // Calculate total remaining stake
-    uint64_t total_stake = 0;
-    for (size_t j = i; j < nodes_.size(); ++j) {
-      total_stake += nodes_[shuffled_indices_[j]].stake;
+WeightedShuffle::WeightedShuffle(const std::vector<uint64_t> &weights,
+                                 uint64_t seed)
+    : weights_(weights), seed_(ChaChaRng::seed_from_u64(seed)), rng_(seed_) {
+  build();
+}
+
+void WeightedShuffle::build() {
+  size_t n = weights_.size();
+  base_tree_.assign(n + 1, 0);
+  base_total_ = 0;
+  base_zeros_.clear();
+
+  // O(n) construction: each slot passes its partial sum to its parent
+  for (size_t i = 1; i <= n; ++i) {
+    uint64_t weight = weights_[i - 1];
+    if (weight == 0) {
+      base_zeros_.push_back(i - 1);
     }
-    
-    if (total_stake == 0) {
-      // No stake, just use remaining order
-      break;
+    base_total_ += weight;
+    base_tree_[i] += weight;
+    size_t parent = i + (i & (~i + 1));
+    if (parent <= n) {
+      base_tree_[parent] += base_tree_[i];
     }
-    
-    // Select weighted random position
-    uint64_t rand_val = rng_() % total_stake;
-    uint64_t cumulative = 0;
-    
-    for (size_t j = i; j < nodes_.size(); ++j) {
-      cumulative += nodes_[shuffled_indices_[j]].stake;
-      if (cumulative > rand_val) {
-        // Swap selected position to current position
-        std::swap(shuffled_indices_[i], shuffled_indices_[j]);
-        break;
-      }
+  }
+
+  top_bit_ = 1;
+  while (top_bit_ * 2 <= n) {
+    top_bit_ *= 2;
+  }
+  reset();
+}
+
+size_t WeightedShuffle::find(uint64_t value) const {
+  // Descend the implicit tree: the last position whose prefix sum is
+  // <= value; the drawn index is the one after it
+  size_t position = 0;
+  size_t n = weights_.size();
+  for (size_t step = top_bit_; step > 0; step >>= 1) {
+    size_t next = position + step;
+    if (next <= n && tree_[next] <= value) {
+      position = next;
+      value -= tree_[next];
     }
   }
+  return position; // 0-based index of the drawn weight
+}
+
+void WeightedShuffle::subtract(size_t index, uint64_t weight) {
+  total_ -= weight;
+  for (size_t i = index + 1; i < tree_.size(); i += i & (~i + 1)) {
+    tree_[i] -= weight;
+  }
+}
+
+size_t WeightedShuffle::next_index() {
+  if (total_ > 0) {
+    // Removed indices hold zero weight in the tree and are never found
+    size_t index = find(rng_.gen_range(total_));
+    subtract(index, weights_[index]);
+    removed_[index] = true;
+    return index;
+  }
+
+  while (!zeros_.empty()) {
+    // Incremental Fisher-Yates over the zero-weight tail
+    size_t pick = rng_.gen_range(zeros_.size());
+    std::swap(zeros_[pick], zeros_.back());
+    size_t index = zeros_.back();
+    zeros_.pop_back();
+    if (!removed_[index]) {
+      removed_[index] = true;
+      return index;
+    }
+  }
+  return npos;
+}
+
+size_t WeightedShuffle::sample_index() {
+  if (total_ == 0) {
+    return npos;
+  }
+  return find(rng_.gen_range(total_));
+}
+
+void WeightedShuffle::remove_index(size_t index) {
+  if (index >= weights_.size() || removed_[index]) {
+    return;
+  }
+  removed_[index] = true;
+  if (weights_[index] > 0) {
+    subtract(index, weights_[index]);
+  }
+  // Zero-weight indices are skipped when their turn comes
 }
 
 const WeightedShuffle::WeightedNode *WeightedShuffle::next() {
-  if (current_index_ >= shuffled_indices_.size()) {
+  size_t index = next_index();
+  if (index == npos || nodes_.empty()) {
     return nullptr;
   }
-  
-  size_t node_index = shuffled_indices_[current_index_++];
-  return &nodes_[node_index];
+  return &nodes_[index];
 }
 
 void WeightedShuffle::reset() {
-  current_index_ = 0;
+  tree_ = base_tree_;
+  total_ = base_total_;
+  zeros_ = base_zeros_;
+  removed_.assign(weights_.size(), false);
+  rng_.reseed(seed_);
+}
+
+void WeightedShuffle::reseed(uint64_t seed) {
+  reseed(ChaChaRng::seed_from_u64(seed));
+}
+
+void WeightedShuffle::reseed(const ChaChaRng::Seed &seed) {
+  seed_ = seed;
+  reset();
 }
 
 std::vector<WeightedShuffle::WeightedNode>
 WeightedShuffle::get_shuffled(size_t max_count) {
   std::vector<WeightedNode> result;
   result.reserve(std::min(max_count, nodes_.size()));
-  
+
   reset();
   while (result.size() < max_count) {
     const WeightedNode *node = next();
@@ -89,7 +149,23 @@ WeightedShuffle::get_shuffled(size_t max_count) {
     }
     result.push_back(*node);
   }
-  
+
+  return result;
+}
+
+std::vector<size_t> WeightedShuffle::shuffle_indices(size_t max_count) {
+  std::vector<size_t> result;
+  result.reserve(std::min(max_count, weights_.size()));
+
+  reset();
+  while (result.size() < max_count) {
+    size_t index = next_index();
+    if (index == npos) {
+      break;
+    }
+    result.push_back(index);
+  }
+
   return result;
 }
 
@@ -99,30 +175,29 @@ WeightedShuffle::select_random(const std::vector<WeightedNode> &nodes,
   if (nodes.empty()) {
     return nullptr;
   }
-  
+
   uint64_t total_stake = 0;
   for (const auto &node : nodes) {
     total_stake += node.stake;
   }
-  
+
+  ChaChaRng rng(seed);
   if (total_stake == 0) {
     // No stake, select uniformly
-    std::mt19937_64 rng(seed);
-    return &nodes[rng() % nodes.size()];
+    return &nodes[rng.gen_range(nodes.size())];
   }
-  
+
   // Select weighted by stake
-  std::mt19937_64 rng(seed);
-  uint64_t rand_val = rng() % total_stake;
+  uint64_t rand_val = rng.gen_range(total_stake);
   uint64_t cumulative = 0;
-  
+
   for (const auto &node : nodes) {
     cumulative += node.stake;
     if (cumulative > rand_val) {
       return &node;
     }
   }
-  
+
   return &nodes.back();
 }
 
@@ -10,102 +10,47 @@
 #include <netinet/in.h>
 #include <openssl/err.h>
 #include <openssl/ssl.h>
+#include <poll.h>
 #include <random>
 #include <sstream>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
 namespace slonana {
 namespace network {
 
+namespace {
+
+constexpr size_t RECEIVE_BATCH = 32;
+constexpr size_t RECEIVE_BUFFER = 2048;
+constexpr size_t SEND_BATCH = 32;
+
+} // namespace
+
 // QuicStream implementation
-QuicStream::QuicStream(StreamId id)
-    : stream_id_(id), closed_(false), bytes_sent_(0), bytes_received_(0) {}
+QuicStream::QuicStream(StreamId id) : QuicStream(id, nullptr) {}
+
+QuicStream::QuicStream(StreamId id, Writer writer)
+    : stream_id_(id), closed_(false), bytes_sent_(0), bytes_received_(0),
+      writer_(std::move(writer)) {}
 
 QuicStream::~QuicStream() { close(); }
 
-void QuicStream::encode_varint(std::vector<uint8_t> &buffer, uint64_t value) {
-  // QUIC variable-length integer encoding (RFC 9000)
-  if (value < 0x40) {
-    buffer.push_back(static_cast<uint8_t>(value));
-  } else if (value < 0x4000) {
-    buffer.push_back(static_cast<uint8_t>(0x40 | (value >> 8)));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  } else if (value < 0x40000000) {
-    buffer.push_back(static_cast<uint8_t>(0x80 | (value >> 24)));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  } else {
-    buffer.push_back(static_cast<uint8_t>(0xC0 | (value >> 56)));
-    buffer.push_back(static_cast<uint8_t>((value >> 48) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 40) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 32) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  }
-}
-
-void QuicStream::encode_varint_static(std::vector<uint8_t> &buffer,
-                                      uint64_t value) {
-  // QUIC variable-length integer encoding (RFC 9000) - static version
-  if (value < 0x40) {
-    buffer.push_back(static_cast<uint8_t>(value));
-  } else if (value < 0x4000) {
-    buffer.push_back(static_cast<uint8_t>(0x40 | (value >> 8)));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  } else if (value < 0x40000000) {
-    buffer.push_back(static_cast<uint8_t>(0x80 | (value >> 24)));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  } else {
-    buffer.push_back(static_cast<uint8_t>(0xC0 | (value >> 56)));
-    buffer.push_back(static_cast<uint8_t>((value >> 48) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 40) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 32) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  }
-}
-
-bool QuicStream::send_data(const std::vector<uint8_t> &data) {
+bool QuicStream::send_data(const std::vector<uint8_t> &data, bool fin) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (closed_) {
     return false;
   }
 
-  // Production QUIC stream implementation with frame encapsulation
-  try {
-    // Create QUIC STREAM frame with stream ID and data
-    std::vector<uint8_t> quic_frame;
-
-    // Frame type (STREAM frame = 0x08-0x0f)
-    quic_frame.push_back(0x08);
-
-    // Variable-length encoding of stream ID
-    encode_varint(quic_frame, stream_id_);
-
-    // Data length (variable-length encoded)
-    encode_varint(quic_frame, data.size());
-
-    // Actual data payload
-    quic_frame.insert(quic_frame.end(), data.begin(), data.end());
-
-    // Add to outbound buffer for transmission
-    outbound_buffer_.insert(outbound_buffer_.end(), quic_frame.begin(),
-                            quic_frame.end());
-
-    bytes_sent_ += data.size();
-    return true;
-  } catch (const std::exception &e) {
-    std::cerr << "QUIC stream send error: " << e.what() << std::endl;
+  if (writer_ && !writer_(stream_id_, data.data(), data.size(), fin)) {
     return false;
   }
+  bytes_sent_ += data.size();
+  if (fin) {
+    closed_ = true;
+  }
+  return true;
 }
 
 std::vector<uint8_t> QuicStream::receive_data() {
@@ -122,6 +67,9 @@ std::vector<uint8_t> QuicStream::receive_data() {
 
 bool QuicStream::close() {
   std::lock_guard<std::mutex> lock(mutex_);
+  if (!closed_ && writer_) {
+    writer_(stream_id_, nullptr, 0, true);
+  }
   closed_ = true;
   return true;
 }
@@ -131,13 +79,46 @@ bool QuicStream::is_closed() const {
   return closed_;
 }
 
+void QuicStream::set_writer(Writer writer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  writer_ = std::move(writer);
+}
+
+// QuicTicketCache implementation
+void QuicTicketCache::store(const std::string &server,
+                            quic::ResumptionTicket ticket) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tickets_[server] = std::move(ticket);
+}
+
+std::optional<quic::ResumptionTicket>
+QuicTicketCache::take(const std::string &server) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tickets_.find(server);
+  if (it == tickets_.end()) {
+    return std::nullopt;
+  }
+  std::optional<quic::ResumptionTicket> ticket;
+  if (it->second.expires > std::chrono::steady_clock::now()) {
+    ticket = std::move(it->second);
+  }
+  tickets_.erase(it);
+  return ticket;
+}
+
 // QuicConnection implementation
 QuicConnection::QuicConnection(const std::string &remote_address,
                                uint16_t remote_port)
+    : QuicConnection(remote_address, remote_port, quic::Identity(), nullptr) {}
+
+QuicConnection::QuicConnection(const std::string &remote_address,
+                               uint16_t remote_port,
+                               const quic::Identity &identity,
+                               std::shared_ptr<QuicTicketCache> tickets)
     : remote_address_(remote_address), remote_port_(remote_port),
-      connected_(false), next_stream_id_(1),
-      rtt_(std::chrono::milliseconds(50)), socket_fd_(-1), tls_ctx_(nullptr),
-      tls_ssl_(nullptr), should_stop_(false) {
+      connected_(false), handshake_timeout_(std::chrono::milliseconds(2000)),
+      identity_(identity), tickets_(std::move(tickets)), socket_fd_(-1),
+      wake_fd_(-1), should_stop_(false) {
 
   // Generate unique connection ID
   std::random_device rd;
@@ -147,131 +128,133 @@ QuicConnection::QuicConnection(const std::string &remote_address,
   std::stringstream ss;
   ss << remote_address << ":" << remote_port << "_" << dis(gen);
   connection_id_ = ss.str();
+  std::memset(&server_addr_, 0, sizeof(server_addr_));
 }
 
 QuicConnection::~QuicConnection() {
   disconnect();
   if (event_thread_.joinable()) {
     should_stop_ = true;
-    event_thread_.join();
-  }
-  cleanup_tls();
-  if (socket_fd_ >= 0) {
-    close(socket_fd_);
+    if (event_thread_.get_id() == std::this_thread::get_id()) {
+      event_thread_.detach();
+    } else {
+      event_thread_.join();
+    }
   }
+  close_socket();
 }
 
 bool QuicConnection::connect() {
-  if (connected_) {
+  if (is_connected()) {
     return true;
   }
+  if (event_thread_.joinable()) {
+    return false; // Connections are not reused once closed
+  }
 
-  // Production QUIC connection establishment with real socket
-  try {
-    // Create UDP socket for QUIC transport
-    socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-    if (socket_fd_ < 0) {
-      std::cerr << "Failed to create QUIC socket" << std::endl;
-      return false;
-    }
-
-    // Set socket to non-blocking mode
-    int flags = fcntl(socket_fd_, F_GETFL, 0);
-    if (fcntl(socket_fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
-      close(socket_fd_);
-      return false;
-    }
-
-    // Configure remote address
-    struct sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(remote_port_);
-
-    if (inet_pton(AF_INET, remote_address_.c_str(), &server_addr.sin_addr) <=
-        0) {
-      close(socket_fd_);
-      return false;
-    }
-
-    // Store server address for future use
-    server_addr_ = server_addr;
-
-    // Initialize TLS context for QUIC
-    tls_ctx_ = SSL_CTX_new(TLS_client_method());
-    if (!tls_ctx_) {
-      close(socket_fd_);
-      return false;
-    }
-
-    // Configure TLS for QUIC
-    SSL_CTX_set_verify(tls_ctx_, SSL_VERIFY_PEER, nullptr);
-    SSL_CTX_set_default_verify_paths(tls_ctx_);
-
-    // Create SSL object
-    tls_ssl_ = SSL_new(tls_ctx_);
-    if (!tls_ssl_) {
-      SSL_CTX_free(tls_ctx_);
-      close(socket_fd_);
-      return false;
-    }
+  std::memset(&server_addr_, 0, sizeof(server_addr_));
+  server_addr_.sin_family = AF_INET;
+  server_addr_.sin_port = htons(remote_port_);
+  if (inet_pton(AF_INET, remote_address_.c_str(), &server_addr_.sin_addr) <=
+      0) {
+    return false;
+  }
 
-    // Perform QUIC handshake
-    std::cout << "🔄 Starting QUIC handshake..." << std::endl;
-    if (!perform_quic_handshake()) {
-      std::cerr << "❌ QUIC handshake failed" << std::endl;
-      cleanup_tls();
-      close(socket_fd_);
-      return false;
-    }
-    std::cout << "✅ QUIC handshake completed successfully" << std::endl;
+  // A connected socket lets the kernel filter other senders and report ICMP
+  // port unreachable as ECONNREFUSED
+  socket_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  wake_fd_ = eventfd(0, EFD_NONBLOCK);
+  if (socket_fd_ < 0 || wake_fd_ < 0 ||
+      ::connect(socket_fd_, reinterpret_cast<sockaddr *>(&server_addr_),
+                sizeof(server_addr_)) < 0) {
+    std::cerr << "Failed to create QUIC socket: " << strerror(errno)
+              << std::endl;
+    close_socket();
+    return false;
+  }
 
-    connected_ = true;
-    std::cout << "✅ QUIC connection established" << std::endl;
+  std::optional<quic::ResumptionTicket> ticket;
+  if (tickets_) {
+    ticket = tickets_->take(remote_address_ + ":" +
+                            std::to_string(remote_port_));
+  }
 
-    // Start event handling thread
-    event_thread_ =
-        std::thread(&QuicConnection::handle_connection_events, this);
+  std::unique_lock<std::mutex> lock(engine_mutex_);
+  engine_ = quic::Connection::connect(identity_, transport_config_,
+                                      ticket ? &*ticket : nullptr,
+                                      std::chrono::steady_clock::now());
+  should_stop_ = false;
+  event_thread_ = std::thread(&QuicConnection::handle_connection_events, this);
 
-    return true;
-  } catch (const std::exception &e) {
-    std::cerr << "QUIC connection failed: " << e.what() << std::endl;
-    cleanup_tls();
-    if (socket_fd_ >= 0) {
-      close(socket_fd_);
-    }
+  state_cv_.wait_for(lock, handshake_timeout_, [this] {
+    return engine_->is_closed() || engine_->can_send_stream_data();
+  });
+  if (engine_->is_closed() || !engine_->can_send_stream_data()) {
+    lock.unlock();
+    std::cerr << "❌ QUIC handshake with " << remote_address_ << ":"
+              << remote_port_ << " failed" << std::endl;
+    disconnect();
     return false;
   }
+
+  connected_ = true;
+  return true;
 }
 
 bool QuicConnection::disconnect() {
-  if (!connected_) {
-    return true;
+  // Detach streams first so closing them cannot reach a dying transport
+  {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    for (auto &[stream_id, stream] : streams_) {
+      stream->set_writer(nullptr);
+      stream->close();
+    }
+    streams_.clear();
   }
 
-  should_stop_ = true;
+  {
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    if (engine_) {
+      engine_->close(quic::TransportError::NO_ERROR);
+    }
+  }
   connected_ = false;
 
-  // Close all streams
-  std::lock_guard<std::mutex> lock(streams_mutex_);
-  for (auto &[stream_id, stream] : streams_) {
-    stream->close();
+  // The event thread flushes CONNECTION_CLOSE and exits once closed
+  if (event_thread_.joinable() &&
+      event_thread_.get_id() != std::this_thread::get_id()) {
+    wake();
+    event_thread_.join();
+    close_socket();
   }
-  streams_.clear();
-
   return true;
 }
 
-bool QuicConnection::is_connected() const { return connected_; }
+bool QuicConnection::is_connected() const {
+  if (!connected_) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(engine_mutex_);
+  return engine_ && !engine_->is_closed();
+}
 
 std::shared_ptr<QuicStream> QuicConnection::create_stream() {
-  if (!connected_) {
+  if (!is_connected()) {
     return nullptr;
   }
 
+  QuicStream::StreamId stream_id;
+  {
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    stream_id = engine_->open_uni_stream();
+  }
+  auto stream = std::make_shared<QuicStream>(
+      stream_id, [this](QuicStream::StreamId id, const uint8_t *data,
+                        size_t length, bool fin) {
+        return write_stream(id, data, length, fin);
+      });
+
   std::lock_guard<std::mutex> lock(streams_mutex_);
-  auto stream_id = next_stream_id_++;
-  auto stream = std::make_shared<QuicStream>(stream_id);
   streams_[stream_id] = stream;
   return stream;
 }
@@ -292,293 +275,186 @@ void QuicConnection::close_stream(QuicStream::StreamId stream_id) {
   }
 }
 
+bool QuicConnection::send_transaction(const std::vector<uint8_t> &transaction) {
+  if (transaction.empty() || transaction.size() > quic::MAX_TRANSACTION_SIZE) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    if (!engine_ || engine_->is_closed()) {
+      return false;
+    }
+    engine_->send_stream(transaction.data(), transaction.size());
+  }
+  wake();
+  return true;
+}
+
 size_t QuicConnection::get_stream_count() const {
   std::lock_guard<std::mutex> lock(streams_mutex_);
   return streams_.size();
 }
 
-void QuicConnection::handle_connection_events() {
-  uint8_t buffer[65536];
-
-  while (!should_stop_ && connected_) {
-    // Production QUIC packet processing
-    try {
-      // Receive QUIC packets from socket
-      struct sockaddr_in client_addr;
-      socklen_t client_len = sizeof(client_addr);
-
-      ssize_t bytes_received =
-          recvfrom(socket_fd_, buffer, sizeof(buffer), MSG_DONTWAIT,
-                   (struct sockaddr *)&client_addr, &client_len);
-
-      if (bytes_received > 0) {
-        // Process received QUIC packet
-        process_quic_packet(buffer, bytes_received);
-      } else if (bytes_received < 0 && errno != EAGAIN &&
-                 errno != EWOULDBLOCK) {
-        // Socket error
-        std::cerr << "QUIC socket receive error: " << strerror(errno)
-                  << std::endl;
-        break;
-      }
-
-      // Send outbound packets
-      send_pending_packets();
-
-      // Process connection maintenance
-      handle_connection_maintenance();
-
-    } catch (const std::exception &e) {
-      std::cerr << "QUIC event handling error: " << e.what() << std::endl;
-    }
-
-    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+std::chrono::milliseconds QuicConnection::get_rtt() const {
+  std::lock_guard<std::mutex> lock(engine_mutex_);
+  if (!engine_) {
+    return std::chrono::milliseconds(0);
   }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      engine_->rtt().smoothed);
 }
 
-// Helper method to create QUIC initial packet - eliminates duplicate code
-std::vector<uint8_t> QuicConnection::create_initial_packet() {
-  std::vector<uint8_t> initial_packet;
-
-  // QUIC header with Long Header format (Initial packet type = 0x00)
-  initial_packet.push_back(0xC0); // Long header, Initial packet
-  initial_packet.push_back(0x00); // Version (placeholder)
-  initial_packet.push_back(0x00);
-  initial_packet.push_back(0x00);
-  initial_packet.push_back(0x01);
-
-  // Connection ID lengths
-  initial_packet.push_back(0x08); // Destination CID length
+bool QuicConnection::used_early_data() const {
+  std::lock_guard<std::mutex> lock(engine_mutex_);
+  return engine_ && engine_->stats().early_data_accepted;
+}
 
-  // Destination Connection ID (8 bytes) - using secure randomness
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<uint8_t> dis(0, 255);
+quic::Connection::Stats QuicConnection::get_transport_stats() const {
+  std::lock_guard<std::mutex> lock(engine_mutex_);
+  return engine_ ? engine_->stats() : quic::Connection::Stats{};
+}
 
-  for (int i = 0; i < 8; i++) {
-    initial_packet.push_back(dis(gen));
+bool QuicConnection::write_stream(QuicStream::StreamId stream_id,
+                                  const uint8_t *data, size_t length,
+                                  bool fin) {
+  bool written;
+  {
+    std::lock_guard<std::mutex> lock(engine_mutex_);
+    written = engine_ && engine_->write_stream(stream_id, data, length, fin);
   }
-
-  initial_packet.push_back(0x08); // Source CID length
-
-  // Source Connection ID (8 bytes) - using secure randomness
-  for (int i = 0; i < 8; i++) {
-    initial_packet.push_back(dis(gen));
+  if (written) {
+    wake();
   }
-
-  // Token length (0 for client initial)
-  QuicStream::encode_varint_static(initial_packet, 0);
-
-  // Length field (placeholder)
-  QuicStream::encode_varint_static(initial_packet, 256);
-
-  // Packet number (4 bytes)
-  initial_packet.push_back(0x00);
-  initial_packet.push_back(0x00);
-  initial_packet.push_back(0x00);
-  initial_packet.push_back(0x01);
-
-  return initial_packet;
+  return written;
 }
 
-bool QuicConnection::perform_quic_handshake() {
-  // Production QUIC handshake implementation with refactored retry logic
-  try {
-    // Create the initial packet once - eliminates duplicate code
-    auto initial_packet = create_initial_packet();
-
-    // Set timeout for handshake (shorter for retry logic)
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 200000; // 200ms timeout per attempt
-    setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-
-    // Retry handshake multiple times
-    for (int attempt = 0; attempt < 5; attempt++) {
-      std::cout << "📤 Handshake attempt " << (attempt + 1) << "/5"
-                << std::endl;
-
-      // Send initial packet (refactored - no duplicate sending code)
-      if (!send_initial_packet(initial_packet)) {
-        continue; // Try again
-      }
-
-      // Wait for response and validate
-      if (wait_for_handshake_response()) {
-        std::cout << "✅ Handshake response validated - connection established!"
-                  << std::endl;
-        return true;
-      }
-
-      std::cout << "⏰ Attempt " << (attempt + 1) << " timed out, retrying..."
-                << std::endl;
-
-      // Small delay before retry
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
-
-    std::cerr << "❌ All handshake attempts failed" << std::endl;
-    return false;
-  } catch (const std::exception &e) {
-    std::cerr << "QUIC handshake error: " << e.what() << std::endl;
-    return false;
+void QuicConnection::wake() {
+  if (wake_fd_ >= 0) {
+    uint64_t one = 1;
+    ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+    (void)ignored;
   }
 }
 
-// Helper method for sending initial packet - eliminates duplicate code
-bool QuicConnection::send_initial_packet(
-    const std::vector<uint8_t> &initial_packet) {
-  std::cout << "📤 Sending QUIC Initial packet to "
-            << inet_ntoa(server_addr_.sin_addr) << ":"
-            << ntohs(server_addr_.sin_port) << std::endl;
-
-  ssize_t sent =
-      sendto(socket_fd_, initial_packet.data(), initial_packet.size(), 0,
-             (struct sockaddr *)&server_addr_, sizeof(server_addr_));
-
-  if (sent < 0) {
-    std::cerr << "Failed to send QUIC initial packet: " << strerror(errno)
-              << std::endl;
-    return false;
+void QuicConnection::close_socket() {
+  if (socket_fd_ >= 0) {
+    close(socket_fd_);
+    socket_fd_ = -1;
   }
-
-  std::cout << "✅ Sent " << sent << " bytes" << std::endl;
-  return true;
-}
-
-// Helper method for waiting and validating handshake response - eliminates
-// duplicate code
-bool QuicConnection::wait_for_handshake_response() {
-  uint8_t response[2048];
-  struct sockaddr_in from_addr;
-  socklen_t from_len = sizeof(from_addr);
-
-  std::cout << "🔄 Waiting for handshake response..." << std::endl;
-  ssize_t received = recvfrom(socket_fd_, response, sizeof(response), 0,
-                              (struct sockaddr *)&from_addr, &from_len);
-  std::cout << "📥 Received " << received << " bytes" << std::endl;
-
-  if (received > 0) {
-    // Process handshake response
-    std::cout << "✅ QUIC client received handshake response (" << received
-              << " bytes)" << std::endl;
-
-    // Validate the response is from the correct server
-    if (from_addr.sin_addr.s_addr == server_addr_.sin_addr.s_addr &&
-        from_addr.sin_port == server_addr_.sin_port) {
-      return true;
-    } else {
-      std::cerr << "❌ Handshake response from incorrect address" << std::endl;
-    }
+  if (wake_fd_ >= 0) {
+    close(wake_fd_);
+    wake_fd_ = -1;
   }
-
-  return false;
 }
 
-void QuicConnection::process_quic_packet(const uint8_t *data, size_t length) {
-  // Production QUIC packet processing
-  if (length < 1)
-    return;
-
-  try {
-    uint8_t first_byte = data[0];
-
-    // Check if it's a long header packet
-    if (first_byte & 0x80) {
-      // Long header packet
-      uint8_t packet_type = (first_byte & 0x30) >> 4;
+void QuicConnection::handle_connection_events() {
+  std::vector<uint8_t> storage(RECEIVE_BATCH * RECEIVE_BUFFER);
+  mmsghdr messages[RECEIVE_BATCH];
+  iovec iovs[RECEIVE_BATCH];
+  std::vector<uint8_t> send_buffer(SEND_BATCH * quic::MAX_DATAGRAM_SIZE);
+  std::vector<quic::OutgoingDatagram> outgoing;
+  outgoing.reserve(SEND_BATCH);
+  std::vector<quic::ReceivedStream> received;
+  quic::UdpBatchSender sender(socket_fd_, true);
+  const std::string ticket_key =
+      remote_address_ + ":" + std::to_string(remote_port_);
+
+  bool closed = false;
+  while (!should_stop_ && !closed) {
+    int timeout_ms;
+    {
+      std::lock_guard<std::mutex> lock(engine_mutex_);
+      auto wait = engine_->next_timeout() - std::chrono::steady_clock::now();
+      timeout_ms = static_cast<int>(std::clamp<int64_t>(
+          std::chrono::duration_cast<std::chrono::milliseconds>(wait).count() +
+              1,
+          0, 100));
+    }
+    pollfd fds[2] = {{socket_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+    if (poll(fds, 2, timeout_ms) < 0 && errno != EINTR) {
+      std::cerr << "QUIC poll error: " << strerror(errno) << std::endl;
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      uint64_t value;
+      ssize_t ignored = read(wake_fd_, &value, sizeof(value));
+      (void)ignored;
+    }
 
-      switch (packet_type) {
-      case 0x00: // Initial
-        // Process Initial packet
-        break;
-      case 0x01: // 0-RTT
-        // Process 0-RTT packet
-        break;
-      case 0x02: // Handshake
-        // Process Handshake packet
+    std::unique_lock<std::mutex> lock(engine_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    bool was_usable = engine_->can_send_stream_data();
+    while (true) {
+      for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+        iovs[i].iov_base = storage.data() + i * RECEIVE_BUFFER;
+        iovs[i].iov_len = RECEIVE_BUFFER;
+        std::memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+      int count = recvmmsg(socket_fd_, messages, RECEIVE_BATCH, MSG_DONTWAIT,
+                           nullptr);
+      if (count < 0) {
+        if (errno == ECONNREFUSED && !engine_->is_established()) {
+          // Nothing listens on the server port
+          engine_->close(quic::TransportError::CONNECTION_REFUSED);
+        }
         break;
-      case 0x03: // Retry
-        // Process Retry packet
+      }
+      for (int i = 0; i < count; ++i) {
+        engine_->receive(storage.data() + i * RECEIVE_BUFFER,
+                         messages[i].msg_len, now);
+      }
+      if (static_cast<size_t>(count) < RECEIVE_BATCH) {
         break;
       }
-    } else {
-      // Short header packet (1-RTT)
-      // Extract and process frames
-      size_t offset = 1; // Skip header byte
-
-      while (offset < length) {
-
-        uint8_t frame_type = data[offset++];
-
-        switch (frame_type) {
-        case 0x08: // STREAM frame
-          // Process stream data
-          break;
-        case 0x02: // ACK frame
-          // Process acknowledgment
-          break;
-        case 0x1C: // CONNECTION_CLOSE frame
-          // Handle connection close
-          connected_ = false;
-          return;
-        default:
-          // Skip unknown frame
-          break;
-        }
+    }
+    if (now >= engine_->next_timeout()) {
+      engine_->on_timeout(now);
+    }
+    if (tickets_) {
+      if (auto ticket = engine_->take_ticket()) {
+        tickets_->store(ticket_key, std::move(*ticket));
       }
     }
-  } catch (const std::exception &e) {
-    std::cerr << "QUIC packet processing error: " << e.what() << std::endl;
-  }
-}
-
-void QuicConnection::send_pending_packets() {
-  // Send any pending outbound data from streams
-  std::lock_guard<std::mutex> lock(streams_mutex_);
-
-  for (const auto &[stream_id, stream] : streams_) {
-    // In production, this would aggregate stream data into QUIC packets
-    // and send them via the socket
-  }
-}
-
-void QuicConnection::handle_connection_maintenance() {
-  // Production connection maintenance
-  try {
-    auto now = std::chrono::steady_clock::now();
-    static auto last_ping = now;
-
-    // Send keep-alive every 30 seconds
-    if (std::chrono::duration_cast<std::chrono::seconds>(now - last_ping)
-            .count() > 30) {
-      // Send PING frame
-      std::vector<uint8_t> ping_packet;
-      ping_packet.push_back(0x40); // Short header
-      ping_packet.push_back(0x01); // PING frame type
-
-      sendto(socket_fd_, ping_packet.data(), ping_packet.size(), 0,
-             (struct sockaddr *)&server_addr_, sizeof(server_addr_));
-
-      last_ping = now;
+    if (engine_->has_received()) {
+      engine_->take_received(received);
     }
 
-    // Update RTT measurements
-    // In production, this would track packet acknowledgments
+    while (true) {
+      if (outgoing.size() == SEND_BATCH) {
+        sender.send(outgoing.data(), outgoing.size());
+        outgoing.clear();
+      }
+      uint8_t *buffer =
+          send_buffer.data() + outgoing.size() * quic::MAX_DATAGRAM_SIZE;
+      size_t length = engine_->send(buffer, quic::MAX_DATAGRAM_SIZE, now);
+      if (length == 0) {
+        break;
+      }
+      outgoing.push_back({buffer, length, server_addr_});
+    }
+    if (!outgoing.empty()) {
+      sender.send(outgoing.data(), outgoing.size());
+      outgoing.clear();
+    }
 
-  } catch (const std::exception &e) {
-    std::cerr << "Connection maintenance error: " << e.what() << std::endl;
-  }
-}
+    closed = engine_->is_closed();
+    bool notify = closed || (!was_usable && engine_->can_send_stream_data());
+    lock.unlock();
+    if (notify) {
+      state_cv_.notify_all();
+    }
+    if (closed) {
+      connected_ = false;
+    }
 
-void QuicConnection::cleanup_tls() {
-  if (tls_ssl_) {
-    SSL_free(tls_ssl_);
-    tls_ssl_ = nullptr;
-  }
-  if (tls_ctx_) {
-    SSL_CTX_free(tls_ctx_);
-    tls_ctx_ = nullptr;
+    for (auto &stream : received) {
+      if (data_callback_) {
+        data_callback_(stream.stream_id, std::move(stream.data));
+      }
+    }
+    received.clear();
   }
 }
 
@@ -587,7 +463,7 @@ QuicClient::QuicClient(const slonana::common::ValidatorConfig &config)
     : initialized_(false), config_(config), connection_pooling_enabled_(true),
       max_connections_(100), total_bytes_sent_(0), total_bytes_received_(0),
       send_buffer_size_(65536), receive_buffer_size_(65536),
-      should_stop_(false) {}
+      tickets_(std::make_shared<QuicTicketCache>()) {}
 
 QuicClient::~QuicClient() { shutdown(); }
 
@@ -606,9 +482,6 @@ bool QuicClient::initialize() {
     std::cerr << "Warning: Failed to initialize secure messaging" << std::endl;
   }
 
-  // Start event processor
-  event_processor_ = std::thread(&QuicClient::process_events, this);
-
   initialized_ = true;
   return true;
 }
@@ -618,18 +491,6 @@ bool QuicClient::shutdown() {
     return true;
   }
 
-  // Signal shutdown
-  {
-    std::lock_guard<std::mutex> lock(stop_mutex_);
-    should_stop_ = true;
-  }
-  stop_cv_.notify_all();
-
-  // Wait for event processor to stop
-  if (event_processor_.joinable()) {
-    event_processor_.join();
-  }
-
   // Disconnect all connections
   std::lock_guard<std::mutex> lock(connections_mutex_);
   for (auto &[conn_id, connection] : connections_) {
@@ -659,7 +520,16 @@ std::shared_ptr<QuicConnection> QuicClient::connect(const std::string &address,
   }
 
   // Create new connection
-  auto connection = std::make_shared<QuicConnection>(address, port);
+  auto connection =
+      std::make_shared<QuicConnection>(address, port, identity_, tickets_);
+  connection->set_data_callback(
+      [this, connection_id](QuicStream::StreamId,
+                            std::vector<uint8_t> &&data) {
+        total_bytes_received_ += data.size();
+        if (data_callback_) {
+          data_callback_(data, connection_id);
+        }
+      });
   if (!connection->connect()) {
     return nullptr;
   }
@@ -731,47 +601,6 @@ size_t QuicClient::get_connection_count() const {
   return connections_.size();
 }
 
-void QuicClient::process_events() {
-  while (true) {
-    {
-      std::unique_lock<std::mutex> lock(stop_mutex_);
-      if (stop_cv_.wait_for(lock, std::chrono::milliseconds(10),
-                            [this] { return should_stop_; })) {
-        break;
-      }
-    }
-
-    // Production QUIC event processing
-    try {
-      // Process all active connections
-      std::vector<std::shared_ptr<QuicConnection>> active_connections;
-      {
-        std::lock_guard<std::mutex> lock(connections_mutex_);
-        for (const auto &[id, conn] : connections_) {
-          if (conn->is_connected()) {
-            active_connections.push_back(conn);
-          }
-        }
-      }
-
-      // Handle congestion control updates
-      update_congestion_control();
-
-      // Process retransmissions
-      handle_retransmissions();
-
-      // Update connection statistics
-      update_connection_stats();
-
-      // Cleanup expired connections
-      cleanup_expired_connections();
-
-    } catch (const std::exception &e) {
-      std::cerr << "QUIC event processor error: " << e.what() << std::endl;
-    }
-  }
-}
-
 void QuicClient::cleanup_expired_connections() {
   std::lock_guard<std::mutex> lock(connections_mutex_);
 
@@ -792,80 +621,6 @@ std::string QuicClient::generate_connection_id(const std::string &address,
   return ss.str();
 }
 
-void QuicClient::update_congestion_control() {
-  // Production congestion control using BBR-like algorithm
-  try {
-    std::lock_guard<std::mutex> lock(connections_mutex_);
-
-    for (const auto &[id, connection] : connections_) {
-      if (!connection->is_connected())
-        continue;
-
-      // Calculate bandwidth-delay product
-      auto rtt = connection->get_rtt();
-
-      // Implement simplified BBR congestion control
-      // In production, this would use full BBR algorithm
-
-      // Update sending rate based on RTT and packet loss
-      // This is a simplified version of production congestion control
-    }
-  } catch (const std::exception &e) {
-    std::cerr << "Congestion control update error: " << e.what() << std::endl;
-  }
-}
-
-void QuicClient::handle_retransmissions() {
-  // Production retransmission handling
-  try {
-    auto now = std::chrono::steady_clock::now();
-
-    std::lock_guard<std::mutex> lock(connections_mutex_);
-
-    for (const auto &[id, connection] : connections_) {
-      if (!connection->is_connected())
-        continue;
-
-      // Check for packets that need retransmission
-      // In production, this would maintain per-connection packet tracking
-
-      // Implement exponential backoff for retransmissions
-      // Calculate retransmission timeout (RTO) based on RTT
-      auto rtt = connection->get_rtt();
-      auto rto = std::chrono::milliseconds(
-          std::max(200, static_cast<int>(rtt.count() * 3)));
-
-      // Retransmit lost packets
-      // In production, this would check acknowledgment status
-    }
-  } catch (const std::exception &e) {
-    std::cerr << "Retransmission handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicClient::update_connection_stats() {
-  // Production statistics tracking
-  try {
-    std::lock_guard<std::mutex> lock(connections_mutex_);
-
-    size_t total_streams = 0;
-    size_t active_connections = 0;
-
-    for (const auto &[id, connection] : connections_) {
-      if (connection->is_connected()) {
-        active_connections++;
-        total_streams += connection->get_stream_count();
-      }
-    }
-
-    // Update performance metrics
-    // In production, this would feed into monitoring systems
-
-  } catch (const std::exception &e) {
-    std::cerr << "Connection stats update error: " << e.what() << std::endl;
-  }
-}
-
 // Secure messaging implementation
 bool QuicClient::setup_secure_messaging() {
   if (!config_.enable_secure_messaging) {
@@ -2,10 +2,12 @@
 #include <algorithm>
 #include <arpa/inet.h>
 #include <chrono>
+#include <cstring>
 #include <fcntl.h>
 #include <iostream>
 #include <netinet/in.h>
 #include <openssl/err.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <poll.h>
 #include <random>
@@ -16,161 +18,134 @@
 namespace slonana {
 namespace network {
 
+namespace {
+
+constexpr size_t RECEIVE_BATCH = 64;
+constexpr size_t RECEIVE_BUFFER = 2048;
+constexpr size_t SEND_BATCH = 64;
+constexpr int SOCKET_BUFFER_BYTES = 8 * 1024 * 1024;
+
+} // namespace
+
 // QuicListener implementation
 QuicListener::QuicListener(uint16_t port)
     : port_(port), listening_(false), server_socket_(-1) {}
 
-QuicListener::~QuicListener() {
-  stop();
-  if (server_socket_ >= 0) {
-    close(server_socket_);
-  }
-}
+QuicListener::~QuicListener() { stop(); }
 
 bool QuicListener::start() {
   if (listening_) {
     return true;
   }
 
-  std::cout << "🔄 Starting QUIC listener on port " << port_ << std::endl;
-  listening_ = true;
-  listener_thread_ = std::thread(&QuicListener::listen_loop, this);
-  std::cout << "✅ QUIC listener thread started" << std::endl;
-  return true;
-}
-
-bool QuicListener::stop() {
-  if (!listening_) {
-    return true;
-  }
-
-  listening_ = false;
-  if (listener_thread_.joinable()) {
-    listener_thread_.join();
-  }
-  return true;
-}
-
-void QuicListener::listen_loop() {
-  // Create UDP socket for QUIC
-  server_socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+  server_socket_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
   if (server_socket_ < 0) {
     std::cerr << "Failed to create QUIC socket" << std::endl;
-    return;
+    return false;
   }
 
-  // Configure socket
   int opt = 1;
   setsockopt(server_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+  // Bursts from many connections arrive between two recvmmsg calls
+  int buffer_bytes = SOCKET_BUFFER_BYTES;
+  setsockopt(server_socket_, SOL_SOCKET, SO_RCVBUF, &buffer_bytes,
+             sizeof(buffer_bytes));
+  setsockopt(server_socket_, SOL_SOCKET, SO_SNDBUF, &buffer_bytes,
+             sizeof(buffer_bytes));
 
   sockaddr_in addr{};
   addr.sin_family = AF_INET;
   addr.sin_addr.s_addr = INADDR_ANY;
   addr.sin_port = htons(port_);
-
   if (bind(server_socket_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) <
       0) {
     std::cerr << "❌ Failed to bind QUIC socket to port " << port_ << ": "
               << strerror(errno) << std::endl;
     close(server_socket_);
-    return;
+    server_socket_ = -1;
+    return false;
+  }
+  socklen_t addr_len = sizeof(addr);
+  if (getsockname(server_socket_, reinterpret_cast<sockaddr *>(&addr),
+                  &addr_len) == 0) {
+    port_ = ntohs(addr.sin_port);
   }
 
   std::cout << "✅ QUIC server bound to port " << port_ << " and listening"
             << std::endl;
 
-  // Set non-blocking mode for immediate packet processing
-  int flags = fcntl(server_socket_, F_GETFL, 0);
-  fcntl(server_socket_, F_SETFL, flags | O_NONBLOCK);
+  sender_ = std::make_unique<quic::UdpBatchSender>(server_socket_);
+  listening_ = true;
+  listener_thread_ = std::thread(&QuicListener::listen_loop, this);
+  return true;
+}
 
-  char buffer[2048];
-  sockaddr_in client_addr{};
-  socklen_t client_len = sizeof(client_addr);
+bool QuicListener::stop() {
+  if (!listening_) {
+    return true;
+  }
 
-  while (listening_) {
-    // Use poll() for efficient socket readiness detection
-    struct pollfd pfd;
-    pfd.fd = server_socket_;
-    pfd.events = POLLIN;
-    pfd.revents = 0;
+  listening_ = false;
+  if (listener_thread_.joinable()) {
+    listener_thread_.join();
+  }
+  close(server_socket_);
+  server_socket_ = -1;
+  sender_.reset();
+  return true;
+}
 
-    // Poll with 1 second timeout to allow periodic checks
-    int poll_result = poll(&pfd, 1, 1000);
+size_t QuicListener::send(const quic::OutgoingDatagram *datagrams,
+                          size_t count) {
+  return sender_ ? sender_->send(datagrams, count) : 0;
+}
+
+void QuicListener::listen_loop() {
+  std::vector<uint8_t> storage(RECEIVE_BATCH * RECEIVE_BUFFER);
+  mmsghdr messages[RECEIVE_BATCH];
+  iovec iovs[RECEIVE_BATCH];
+  sockaddr_in addresses[RECEIVE_BATCH];
+  Datagram batch[RECEIVE_BATCH];
 
-    if (poll_result < 0) {
+  while (listening_) {
+    pollfd pfd{server_socket_, POLLIN, 0};
+    if (poll(&pfd, 1, 1) < 0 && errno != EINTR) {
       std::cerr << "QUIC poll error: " << strerror(errno) << std::endl;
       break;
     }
 
-    if (poll_result == 0) {
-      // Timeout - continue to check listening_ flag
-      continue;
-    }
-
-    if (!(pfd.revents & POLLIN)) {
-      // No data ready, continue
-      continue;
-    }
-
-    // Data is ready to read
-    ssize_t received =
-        recvfrom(server_socket_, buffer, sizeof(buffer), 0,
-                 reinterpret_cast<sockaddr *>(&client_addr), &client_len);
-
-    if (received > 0) {
-      // Production QUIC packet processing - immediate response
-      try {
-        std::string client_ip = inet_ntoa(client_addr.sin_addr);
-        uint16_t client_port = ntohs(client_addr.sin_port);
-
-        // Parse QUIC packet header
-        if (received >= 1) {
-          uint8_t first_byte = buffer[0];
-
-          // Check if it's a long header packet (connection establishment)
-          if (first_byte & 0x80) {
-            uint8_t packet_type = (first_byte & 0x30) >> 4;
-
-            switch (packet_type) {
-            case 0x00: // Initial packet
-              handle_initial_packet(reinterpret_cast<const uint8_t *>(buffer),
-                                    received, client_addr);
-              break;
-            case 0x01: // 0-RTT packet
-              handle_0rtt_packet(reinterpret_cast<const uint8_t *>(buffer),
-                                 received, client_addr);
-              break;
-            case 0x02: // Handshake packet
-              handle_handshake_packet(reinterpret_cast<const uint8_t *>(buffer),
-                                      received, client_addr);
-              break;
-            case 0x03: // Retry packet
-              handle_retry_packet(reinterpret_cast<const uint8_t *>(buffer),
-                                  received, client_addr);
-              break;
-            }
-          } else {
-            // Short header packet (1-RTT)
-            handle_1rtt_packet(reinterpret_cast<const uint8_t *>(buffer),
-                               received, client_addr);
-          }
+    // Drain what is queued, bounded so timers still run under load
+    for (int round = 0; round < 16; ++round) {
+      for (size_t i = 0; i < RECEIVE_BATCH; ++i) {
+        iovs[i].iov_base = storage.data() + i * RECEIVE_BUFFER;
+        iovs[i].iov_len = RECEIVE_BUFFER;
+        std::memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_name = &addresses[i];
+        messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+      int received = recvmmsg(server_socket_, messages, RECEIVE_BATCH,
+                              MSG_DONTWAIT, nullptr);
+      if (received <= 0) {
+        break;
+      }
+      if (handler_) {
+        for (int i = 0; i < received; ++i) {
+          batch[i] = {storage.data() + i * RECEIVE_BUFFER, messages[i].msg_len,
+                      addresses[i]};
         }
-
-        std::cout << "Processed QUIC packet from " << client_ip << ":"
-                  << client_port << " (" << received << " bytes)" << std::endl;
-      } catch (const std::exception &e) {
-        std::cerr << "QUIC packet processing error: " << e.what() << std::endl;
+        handler_(batch, static_cast<size_t>(received));
       }
-    } else if (received < 0) {
-      // Handle errors (should be rare with poll())
-      if (errno != EAGAIN && errno != EWOULDBLOCK) {
-        std::cerr << "QUIC receive error: " << strerror(errno) << std::endl;
-        break; // Exit on real errors
+      if (static_cast<size_t>(received) < RECEIVE_BATCH) {
+        break;
       }
     }
-  }
 
-  close(server_socket_);
+    if (handler_) {
+      handler_(nullptr, 0);
+    }
+  }
 }
 
 // QuicServerSession implementation
@@ -296,11 +271,38 @@ size_t QuicServerSession::get_active_streams() const {
 }
 
 // QuicServer implementation
+struct QuicServer::PeerConnection {
+  std::unique_ptr<quic::Connection> connection;
+  sockaddr_in peer{};
+  uint64_t route_key = 0;   ///< Server-chosen CID
+  uint64_t initial_key = 0; ///< Client's original destination CID
+  std::string session_id;
+  PublicKey identity;
+  bool counted = false; ///< Holds a per-peer connection slot
+  bool touched = false;
+};
+
 QuicServer::QuicServer()
     : initialized_(false), running_(false), port_(0), max_sessions_(1000),
-      session_timeout_(std::chrono::minutes(30)), max_streams_per_session_(100),
-      tls_verification_enabled_(true), tls_ctx_(nullptr), total_bytes_sent_(0),
-      total_bytes_received_(0), total_connections_(0), should_stop_(false) {}
+      session_timeout_(std::chrono::seconds(30)),
+      max_streams_per_session_(128), tls_verification_enabled_(true),
+      tls_ctx_(nullptr), max_connections_per_peer_(8), total_stake_(0),
+      total_bytes_sent_(0), total_bytes_received_(0), total_connections_(0),
+      transactions_received_(0), connections_refused_(0), packets_lost_(0),
+      avg_rtt_ms_(0.0) {
+  RAND_bytes(policy_.ticket_key.data(),
+             static_cast<int>(policy_.ticket_key.size()));
+  policy_.stream_quota = [this](const quic::Key32 &identity) -> uint64_t {
+    PublicKey key(identity.begin(), identity.end());
+    auto it = connections_per_peer_.find(key);
+    if (it != connections_per_peer_.end() &&
+        it->second >= max_connections_per_peer_) {
+      connections_refused_++;
+      return 0;
+    }
+    return stream_quota(identity);
+  };
+}
 
 QuicServer::~QuicServer() { shutdown(); }
 
@@ -325,14 +327,23 @@ bool QuicServer::start() {
     return false;
   }
 
-  // Start listener
+  transport_config_.idle_timeout = session_timeout_;
+  transport_config_.local.idle_timeout_ms =
+      static_cast<uint64_t>(session_timeout_.count());
+  transport_config_.local.max_streams_uni = max_streams_per_session_;
+  send_buffer_.resize(SEND_BATCH * quic::MAX_DATAGRAM_SIZE);
+  outgoing_.reserve(SEND_BATCH);
+  start_time_ = std::chrono::steady_clock::now();
+  next_timer_scan_ = start_time_;
+
+  listener_->set_batch_handler(
+      [this](QuicListener::Datagram *datagrams, size_t count) {
+        on_datagrams(datagrams, count);
+      });
   if (!listener_->start()) {
     return false;
   }
-
-  // Start event processor
-  start_time_ = std::chrono::steady_clock::now();
-  event_processor_ = std::thread(&QuicServer::process_server_events, this);
+  port_ = listener_->get_port();
 
   running_ = true;
   return true;
@@ -343,22 +354,11 @@ bool QuicServer::stop() {
     return true;
   }
 
-  // Signal shutdown
-  {
-    std::lock_guard<std::mutex> lock(stop_mutex_);
-    should_stop_ = true;
-  }
-  stop_cv_.notify_all();
-
-  // Stop listener
+  // Connections live on the listener thread; release them once it is gone
   if (listener_) {
     listener_->stop();
   }
-
-  // Wait for event processor to stop
-  if (event_processor_.joinable()) {
-    event_processor_.join();
-  }
+  release_connections();
 
   running_ = false;
   return true;
@@ -391,15 +391,23 @@ QuicServer::get_session(const std::string &session_id) {
 }
 
 void QuicServer::close_session(const std::string &session_id) {
-  std::lock_guard<std::mutex> lock(sessions_mutex_);
-  auto it = sessions_.find(session_id);
-  if (it != sessions_.end()) {
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    auto it = sessions_.find(session_id);
+    if (it == sessions_.end()) {
+      return;
+    }
     it->second->close_connection();
     sessions_.erase(it);
+  }
 
-    if (disconnection_callback_) {
-      disconnection_callback_(session_id);
-    }
+  {
+    std::lock_guard<std::mutex> lock(outbound_mutex_);
+    outbound_.push_back({session_id, {}, true});
+  }
+
+  if (disconnection_callback_) {
+    disconnection_callback_(session_id);
   }
 }
 
@@ -416,46 +424,287 @@ bool QuicServer::send_data(const std::string &session_id,
     return false;
   }
 
-  // Production QUIC data transmission
-  try {
-    // Get the stream
-    auto stream = session->get_stream(stream_id);
-    if (!stream) {
-      return false;
+  auto stream = session->get_stream(stream_id);
+  if (!stream) {
+    return false;
+  }
+
+  // Written to a new server-initiated stream on the listener thread
+  std::lock_guard<std::mutex> lock(outbound_mutex_);
+  outbound_.push_back({session_id, data, false});
+  return true;
+}
+
+void QuicServer::update_staked_nodes(
+    const std::unordered_map<PublicKey, uint64_t> &stakes) {
+  uint64_t total = 0;
+  for (const auto &[identity, stake] : stakes) {
+    total += stake;
+  }
+  std::lock_guard<std::mutex> lock(stakes_mutex_);
+  stakes_ = stakes;
+  total_stake_ = total;
+}
+
+uint64_t QuicServer::stream_quota(const quic::Key32 &identity) const {
+  PublicKey key(identity.begin(), identity.end());
+  std::lock_guard<std::mutex> lock(stakes_mutex_);
+  auto it = stakes_.find(key);
+  if (it == stakes_.end() || it->second == 0 || total_stake_ == 0) {
+    return max_streams_per_session_;
+  }
+  auto share = static_cast<uint64_t>(
+      static_cast<unsigned __int128>(STAKED_STREAMS_TOTAL) * it->second /
+      total_stake_);
+  return std::clamp(share, MIN_STAKED_STREAMS, MAX_STAKED_STREAMS);
+}
+
+void QuicServer::on_datagrams(QuicListener::Datagram *datagrams,
+                              size_t count) {
+  auto now = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < count; ++i) {
+    auto &datagram = datagrams[i];
+    PeerConnection *peer = route(datagram, now);
+    if (!peer) {
+      continue;
     }
+    peer->peer = datagram.peer; // Follow NAT rebinding
+    total_bytes_received_ += datagram.length;
+    peer->connection->receive(datagram.data, datagram.length, now);
+    if (!peer->touched) {
+      peer->touched = true;
+      touched_.push_back(peer);
+    }
+  }
 
-    // Create QUIC STREAM frame
-    std::vector<uint8_t> quic_packet;
+  if (now >= next_timer_scan_) {
+    run_timers(now);
+    next_timer_scan_ = now + std::chrono::milliseconds(1);
+  }
+  drain_outbound();
 
-    // Short header for 1-RTT packet
-    quic_packet.push_back(0x40);
+  std::vector<uint64_t> closed;
+  for (PeerConnection *peer : touched_) {
+    peer->touched = false;
+    service(*peer, now);
+    if (peer->connection->is_closed()) {
+      closed.push_back(peer->route_key);
+    }
+  }
+  touched_.clear();
+  flush_outgoing();
 
-    // STREAM frame type (0x08-0x0f)
-    quic_packet.push_back(0x0A); // STREAM frame with length and offset
+  for (uint64_t key : closed) {
+    auto it = connections_.find(key);
+    if (it != connections_.end()) {
+      remove_connection(*it->second);
+    }
+  }
 
-    // Stream ID (variable-length encoded)
-    encode_varint(quic_packet, stream_id);
+  if (!pending_transactions_.empty()) {
+    transactions_received_ += pending_transactions_.size();
+    if (transaction_sink_) {
+      transaction_sink_(std::move(pending_transactions_));
+    }
+    pending_transactions_.clear();
+  }
+}
 
-    // Offset (0 for simplicity)
-    encode_varint(quic_packet, 0);
+QuicServer::PeerConnection *
+QuicServer::route(const QuicListener::Datagram &datagram,
+                  std::chrono::steady_clock::time_point now) {
+  uint64_t key;
+  bool initial;
+  if (!quic::parse_destination_cid(datagram.data, datagram.length, key,
+                                   initial)) {
+    return nullptr;
+  }
+  auto it = connections_.find(key);
+  if (it == connections_.end()) {
+    auto route = initial_routes_.find(key);
+    if (route != initial_routes_.end()) {
+      it = connections_.find(route->second);
+    }
+  }
+  if (it != connections_.end()) {
+    return it->second.get();
+  }
 
-    // Data length
-    encode_varint(quic_packet, data.size());
+  // Only a full-size client Initial may create state
+  if (!initial || datagram.length < quic::MAX_DATAGRAM_SIZE) {
+    return nullptr;
+  }
+  if (connections_.size() >= max_sessions_) {
+    connections_refused_++;
+    return nullptr;
+  }
+  auto connection =
+      quic::Connection::accept(identity_, transport_config_, policy_,
+                               datagram.data + 6, quic::CID_LENGTH, now);
+  if (!connection) {
+    return nullptr;
+  }
+  auto peer = std::make_shared<PeerConnection>();
+  peer->route_key = quic::cid_key(connection->local_cid().data());
+  peer->initial_key = key;
+  peer->connection = std::move(connection);
+  connections_[peer->route_key] = peer;
+  initial_routes_[key] = peer->route_key;
+  return peer.get();
+}
+
+void QuicServer::run_timers(std::chrono::steady_clock::time_point now) {
+  double rtt_sum = 0.0;
+  size_t rtt_count = 0;
+  for (auto &[key, peer] : connections_) {
+    auto &connection = *peer->connection;
+    if (now >= connection.next_timeout()) {
+      connection.on_timeout(now);
+      if (!peer->touched) {
+        peer->touched = true;
+        touched_.push_back(peer.get());
+      }
+    }
+    if (connection.rtt().has_sample) {
+      rtt_sum += connection.rtt().smoothed.count() / 1000.0;
+      ++rtt_count;
+    }
+  }
+  avg_rtt_ms_ = rtt_count ? rtt_sum / rtt_count : 0.0;
+}
 
-    // Actual data
-    quic_packet.insert(quic_packet.end(), data.begin(), data.end());
+void QuicServer::drain_outbound() {
+  std::vector<Outbound> outbound;
+  {
+    std::lock_guard<std::mutex> lock(outbound_mutex_);
+    if (outbound_.empty()) {
+      return;
+    }
+    outbound.swap(outbound_);
+  }
+  for (auto &item : outbound) {
+    auto route = session_routes_.find(item.session_id);
+    if (route == session_routes_.end()) {
+      continue;
+    }
+    auto it = connections_.find(route->second);
+    if (it == connections_.end()) {
+      continue;
+    }
+    auto &peer = *it->second;
+    if (item.close) {
+      peer.connection->close(quic::TransportError::NO_ERROR);
+    } else {
+      peer.connection->send_stream(item.data.data(), item.data.size());
+    }
+    if (!peer.touched) {
+      peer.touched = true;
+      touched_.push_back(&peer);
+    }
+  }
+}
 
-    // Send via UDP socket (session should maintain socket connection)
-    // In production, this would use the session's socket
-    total_bytes_sent_ += data.size();
+void QuicServer::service(PeerConnection &peer,
+                         std::chrono::steady_clock::time_point now) {
+  auto &connection = *peer.connection;
 
-    return true;
-  } catch (const std::exception &e) {
-    std::cerr << "QUIC data send error: " << e.what() << std::endl;
-    return false;
+  if (!peer.counted && connection.is_established()) {
+    const auto &identity = connection.peer_identity();
+    peer.identity.assign(identity.begin(), identity.end());
+    connections_per_peer_[peer.identity]++;
+    peer.counted = true;
+
+    char address[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &peer.peer.sin_addr, address, sizeof(address));
+    auto session =
+        std::make_shared<QuicServerSession>(address, ntohs(peer.peer.sin_port));
+    session->accept_connection();
+    peer.session_id = session->get_session_id();
+    {
+      std::lock_guard<std::mutex> lock(sessions_mutex_);
+      sessions_[peer.session_id] = session;
+    }
+    session_routes_[peer.session_id] = peer.route_key;
+    total_connections_++;
+    if (connection_callback_) {
+      connection_callback_(session);
+    }
+  }
+
+  if (connection.has_received()) {
+    received_streams_.clear();
+    connection.take_received(received_streams_);
+    for (auto &stream : received_streams_) {
+      if (data_callback_) {
+        data_callback_(peer.session_id, stream.stream_id, stream.data);
+      }
+      pending_transactions_.push_back(std::move(stream.data));
+    }
+  }
+
+  while (true) {
+    if (outgoing_.size() == SEND_BATCH) {
+      flush_outgoing();
+    }
+    uint8_t *buffer =
+        send_buffer_.data() + outgoing_.size() * quic::MAX_DATAGRAM_SIZE;
+    size_t length = connection.send(buffer, quic::MAX_DATAGRAM_SIZE, now);
+    if (length == 0) {
+      break;
+    }
+    outgoing_.push_back({buffer, length, peer.peer});
+    total_bytes_sent_ += length;
   }
 }
 
+void QuicServer::flush_outgoing() {
+  if (outgoing_.empty()) {
+    return;
+  }
+  listener_->send(outgoing_.data(), outgoing_.size());
+  outgoing_.clear();
+}
+
+void QuicServer::remove_connection(PeerConnection &peer) {
+  packets_lost_ += peer.connection->stats().packets_lost;
+  if (peer.counted) {
+    auto it = connections_per_peer_.find(peer.identity);
+    if (it != connections_per_peer_.end() && --it->second == 0) {
+      connections_per_peer_.erase(it);
+    }
+  }
+  if (!peer.session_id.empty()) {
+    session_routes_.erase(peer.session_id);
+    std::shared_ptr<QuicServerSession> session;
+    {
+      std::lock_guard<std::mutex> lock(sessions_mutex_);
+      auto it = sessions_.find(peer.session_id);
+      if (it != sessions_.end()) {
+        session = it->second;
+        sessions_.erase(it);
+      }
+    }
+    // Sessions closed through close_session() were already reported
+    if (session) {
+      session->close_connection();
+      if (disconnection_callback_) {
+        disconnection_callback_(peer.session_id);
+      }
+    }
+  }
+  initial_routes_.erase(peer.initial_key);
+  connections_.erase(peer.route_key); // Destroys peer
+}
+
+void QuicServer::release_connections() {
+  while (!connections_.empty()) {
+    remove_connection(*connections_.begin()->second);
+  }
+  touched_.clear();
+  pending_transactions_.clear();
+  outgoing_.clear();
+}
+
 bool QuicServer::configure_tls(const std::string &cert_file,
                                const std::string &key_file) {
   cert_file_ = cert_file;
@@ -545,11 +794,13 @@ QuicServer::Statistics QuicServer::get_statistics() const {
   }
 
   stats.total_sessions = total_connections_;
-  stats.total_streams =
-      stats.active_streams; // Simplified for this implementation
+  stats.total_streams = transactions_received_;
   stats.bytes_sent = total_bytes_sent_;
   stats.bytes_received = total_bytes_received_;
-  stats.avg_rtt_ms = 50.0; // Simplified average
+  stats.avg_rtt_ms = avg_rtt_ms_;
+  stats.transactions_received = transactions_received_;
+  stats.connections_refused = connections_refused_;
+  stats.packets_lost = packets_lost_;
 
   auto now = std::chrono::steady_clock::now();
   stats.uptime =
@@ -558,316 +809,6 @@ QuicServer::Statistics QuicServer::get_statistics() const {
   return stats;
 }
 
-void QuicServer::process_server_events() {
-  while (true) {
-    {
-      std::unique_lock<std::mutex> lock(stop_mutex_);
-      if (stop_cv_.wait_for(lock, std::chrono::milliseconds(100),
-                            [this] { return should_stop_; })) {
-        break;
-      }
-    }
-
-    // Cleanup expired sessions
-    cleanup_expired_sessions();
-
-    // Production QUIC event processing
-    try {
-      // Process connection establishment events
-      handle_connection_events();
-
-      // Process stream events for all sessions
-      process_stream_events();
-
-      // Handle congestion control updates
-      update_congestion_control();
-
-      // Process retransmissions
-      handle_retransmissions();
-
-      // Update server statistics
-      update_server_stats();
-
-    } catch (const std::exception &e) {
-      std::cerr << "QUIC server event processing error: " << e.what()
-                << std::endl;
-    }
-  }
-}
-
-void QuicServer::handle_new_connection(const std::string &client_address,
-                                       uint16_t client_port) {
-  // Check session limit
-  {
-    std::lock_guard<std::mutex> lock(sessions_mutex_);
-    if (sessions_.size() >= max_sessions_) {
-      return; // Reject connection
-    }
-  }
-
-  // Create new session
-  auto session =
-      std::make_shared<QuicServerSession>(client_address, client_port);
-  if (session->accept_connection()) {
-    {
-      std::lock_guard<std::mutex> lock(sessions_mutex_);
-      sessions_[session->get_session_id()] = session;
-    }
-
-    total_connections_++;
-
-    if (connection_callback_) {
-      connection_callback_(session);
-    }
-  }
-}
-
-void QuicServer::handle_session_data(const std::string &session_id,
-                                     QuicStream::StreamId stream_id,
-                                     const std::vector<uint8_t> &data) {
-  total_bytes_received_ += data.size();
-
-  if (data_callback_) {
-    data_callback_(session_id, stream_id, data);
-  }
-}
-
-void QuicServer::handle_session_disconnection(const std::string &session_id) {
-  close_session(session_id);
-}
-
-void QuicServer::cleanup_expired_sessions() {
-  auto now = std::chrono::steady_clock::now();
-
-  std::lock_guard<std::mutex> lock(sessions_mutex_);
-  auto it = sessions_.begin();
-  while (it != sessions_.end()) {
-    auto time_since_activity = now - it->second->get_last_activity();
-    if (time_since_activity > session_timeout_ || !it->second->is_active()) {
-      if (disconnection_callback_) {
-        disconnection_callback_(it->first);
-      }
-      it = sessions_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-}
-
-std::string QuicServer::generate_session_id(const std::string &client_address,
-                                            uint16_t client_port) {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_int_distribution<uint64_t> dis;
-
-  std::stringstream ss;
-  ss << client_address << ":" << client_port << "_" << dis(gen);
-  return ss.str();
-}
-
-bool QuicServer::validate_client_certificate(
-    const std::string &client_address) {
-  // Production client certificate validation
-  try {
-    if (!tls_ctx_) {
-      std::cerr << "TLS context not configured for certificate validation"
-                << std::endl;
-      return false;
-    }
-
-    // Create temporary SSL object for certificate validation
-    SSL *ssl = SSL_new(tls_ctx_);
-    if (!ssl) {
-      std::cerr << "Failed to create SSL object for validation" << std::endl;
-      return false;
-    }
-
-    // In production, this would:
-    // 1. Parse client certificate from handshake
-    // 2. Verify certificate chain against trusted CA
-    // 3. Check certificate revocation status (OCSP/CRL)
-    // 4. Validate certificate extensions and key usage
-    // 5. Check certificate expiration
-    // 6. Verify client identity matches certificate
-
-    // For now, implement basic IP-based validation
-    bool is_valid = true;
-
-    // Check if client is in blacklist
-    auto blacklist_it = std::find(client_blacklist_.begin(),
-                                  client_blacklist_.end(), client_address);
-    if (blacklist_it != client_blacklist_.end()) {
-      is_valid = false;
-    }
-
-    // Check against whitelist if configured
-    if (!client_whitelist_.empty()) {
-      auto whitelist_it = std::find(client_whitelist_.begin(),
-                                    client_whitelist_.end(), client_address);
-      if (whitelist_it == client_whitelist_.end()) {
-        is_valid = false;
-      }
-    }
-
-    SSL_free(ssl);
-    return is_valid;
-
-  } catch (const std::exception &e) {
-    std::cerr << "Certificate validation error: " << e.what() << std::endl;
-    return false;
-  }
-}
-
-bool QuicServer::rate_limit_check(const std::string &client_address) {
-  std::lock_guard<std::mutex> lock(client_tracking_mutex_);
-
-  auto now = std::chrono::steady_clock::now();
-  auto it = last_connection_time_.find(client_address);
-
-  if (it != last_connection_time_.end()) {
-    auto time_since_last = now - it->second;
-    if (time_since_last < std::chrono::milliseconds(100)) {
-      return false; // Rate limited
-    }
-  }
-
-  last_connection_time_[client_address] = now;
-  return true;
-}
-
-// QuicListener packet handler implementations
-void QuicListener::handle_initial_packet(
-    const uint8_t *data, size_t length, const struct sockaddr_in &client_addr) {
-  // Handle QUIC Initial packet for connection establishment
-  try {
-    std::cout << "Processing Initial packet from "
-              << inet_ntoa(client_addr.sin_addr) << ":"
-              << ntohs(client_addr.sin_port) << std::endl;
-
-    // Send handshake response to complete connection establishment
-    std::vector<uint8_t> handshake_response;
-
-    // QUIC header with Long Header format (Handshake packet type = 0x02)
-    handshake_response.push_back(0xE0); // Long header, Handshake packet
-    handshake_response.push_back(0x00); // Version
-    handshake_response.push_back(0x00);
-    handshake_response.push_back(0x00);
-    handshake_response.push_back(0x01);
-
-    // Connection ID lengths (copy from client)
-    handshake_response.push_back(0x08); // Destination CID length
-
-    // Echo back the source CID from client as destination CID
-    if (length >= 14) { // Ensure we have enough data
-      for (int i = 6; i < 14; i++) {
-        handshake_response.push_back(data[i]);
-      }
-    } else {
-      // Fallback: generate secure random CIDs
-      std::random_device rd;
-      std::mt19937 gen(rd());
-      std::uniform_int_distribution<uint8_t> dis(0, 255);
-
-      for (int i = 0; i < 8; i++) {
-        handshake_response.push_back(dis(gen));
-      }
-    }
-
-    handshake_response.push_back(0x08); // Source CID length
-
-    // Generate secure random server source CID
-    {
-      std::random_device rd;
-      std::mt19937 gen(rd());
-      std::uniform_int_distribution<uint8_t> dis(0, 255);
-
-      for (int i = 0; i < 8; i++) {
-        handshake_response.push_back(dis(gen));
-      }
-    }
-
-    // Length field (simplified)
-    handshake_response.push_back(0x40); // Varint encoding for length
-    handshake_response.push_back(0x10); // Length = 16 bytes payload
-
-    // Packet number (4 bytes)
-    handshake_response.push_back(0x00);
-    handshake_response.push_back(0x00);
-    handshake_response.push_back(0x00);
-    handshake_response.push_back(0x01);
-
-    // Simple payload (handshake completion signal)
-    for (int i = 0; i < 12; i++) {
-      handshake_response.push_back(0x00); // Padding
-    }
-
-    // Send response back to client
-    if (server_socket_ >= 0) {
-      ssize_t sent = sendto(
-          server_socket_, handshake_response.data(), handshake_response.size(),
-          0, (struct sockaddr *)&client_addr, sizeof(client_addr));
-
-      if (sent > 0) {
-        std::cout << "✅ Sent handshake response to client" << std::endl;
-      } else {
-        std::cerr << "❌ Failed to send handshake response: " << strerror(errno)
-                  << std::endl;
-      }
-    }
-
-  } catch (const std::exception &e) {
-    std::cerr << "Initial packet handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicListener::handle_0rtt_packet(const uint8_t *data, size_t length,
-                                      const struct sockaddr_in &client_addr) {
-  // Handle QUIC 0-RTT packet
-  try {
-    std::cout << "Processing 0-RTT packet from "
-              << inet_ntoa(client_addr.sin_addr) << std::endl;
-    // In production, this would handle early data
-  } catch (const std::exception &e) {
-    std::cerr << "0-RTT packet handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicListener::handle_handshake_packet(
-    const uint8_t *data, size_t length, const struct sockaddr_in &client_addr) {
-  // Handle QUIC Handshake packet
-  try {
-    std::cout << "Processing Handshake packet from "
-              << inet_ntoa(client_addr.sin_addr) << std::endl;
-    // In production, this would complete TLS handshake
-  } catch (const std::exception &e) {
-    std::cerr << "Handshake packet handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicListener::handle_retry_packet(const uint8_t *data, size_t length,
-                                       const struct sockaddr_in &client_addr) {
-  // Handle QUIC Retry packet
-  try {
-    std::cout << "Processing Retry packet from "
-              << inet_ntoa(client_addr.sin_addr) << std::endl;
-    // In production, this would handle connection retry with new token
-  } catch (const std::exception &e) {
-    std::cerr << "Retry packet handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicListener::handle_1rtt_packet(const uint8_t *data, size_t length,
-                                      const struct sockaddr_in &client_addr) {
-  // Handle QUIC 1-RTT packet (application data)
-  try {
-    std::cout << "Processing 1-RTT packet from "
-              << inet_ntoa(client_addr.sin_addr) << std::endl;
-    // In production, this would process application frames
-  } catch (const std::exception &e) {
-    std::cerr << "1-RTT packet handling error: " << e.what() << std::endl;
-  }
-}
-
 // QuicServerSession helper implementations
 void QuicServerSession::send_ack_frame(QuicStream::StreamId stream_id,
                                        size_t data_length) {
@@ -881,80 +822,5 @@ void QuicServerSession::send_ack_frame(QuicStream::StreamId stream_id,
   }
 }
 
-// QuicServer additional method implementations
-void QuicServer::handle_connection_events() {
-  // Process connection establishment events
-  try {
-    // In production, this would handle new connection establishment
-  } catch (const std::exception &e) {
-    std::cerr << "Connection event handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicServer::process_stream_events() {
-  // Process stream events for all sessions
-  try {
-    std::lock_guard<std::mutex> lock(sessions_mutex_);
-    for (const auto &[id, session] : sessions_) {
-      if (session->is_active()) {
-        // Process stream events for this session
-      }
-    }
-  } catch (const std::exception &e) {
-    std::cerr << "Stream event processing error: " << e.what() << std::endl;
-  }
-}
-
-void QuicServer::update_congestion_control() {
-  // Update congestion control for all sessions
-  try {
-    // In production, this would implement BBR or other congestion control
-  } catch (const std::exception &e) {
-    std::cerr << "Congestion control update error: " << e.what() << std::endl;
-  }
-}
-
-void QuicServer::handle_retransmissions() {
-  // Handle packet retransmissions
-  try {
-    // In production, this would track and retransmit lost packets
-  } catch (const std::exception &e) {
-    std::cerr << "Retransmission handling error: " << e.what() << std::endl;
-  }
-}
-
-void QuicServer::update_server_stats() {
-  // Update server statistics
-  try {
-    // In production, this would update performance metrics
-  } catch (const std::exception &e) {
-    std::cerr << "Server stats update error: " << e.what() << std::endl;
-  }
-}
-
-void QuicServer::encode_varint(std::vector<uint8_t> &buffer, uint64_t value) {
-  // QUIC variable-length integer encoding
-  if (value < 0x40) {
-    buffer.push_back(static_cast<uint8_t>(value));
-  } else if (value < 0x4000) {
-    buffer.push_back(static_cast<uint8_t>(0x40 | (value >> 8)));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  } else if (value < 0x40000000) {
-    buffer.push_back(static_cast<uint8_t>(0x80 | (value >> 24)));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  } else {
-    buffer.push_back(static_cast<uint8_t>(0xC0 | (value >> 56)));
-    buffer.push_back(static_cast<uint8_t>((value >> 48) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 40) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 32) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-  }
-}
-
 } // namespace network
-} // namespace slonana
\ No newline at end of file
+} // namespace slonana
@@ -0,0 +1,2266 @@
+#include "network/quic_transport.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <netinet/udp.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#include <sys/socket.h>
+#include <utility>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+namespace slonana {
+namespace network {
+namespace quic {
+
+namespace {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+constexpr uint8_t CLIENT_HELLO = 0x01;
+constexpr uint8_t SERVER_HELLO = 0x02;
+constexpr size_t SIGNATURE_SIZE = 64;
+constexpr size_t PN_LENGTH = 4;
+constexpr size_t LONG_LENGTH_FIELD = 2;
+constexpr size_t MAX_ACK_RANGES = 32;
+constexpr size_t MAX_TRACKED_RANGES = 64;
+constexpr size_t TICKET_NONCE_SIZE = 12;
+constexpr size_t TICKET_PLAINTEXT = 8 + 32 + 32;
+constexpr size_t TICKET_SIZE =
+    TICKET_NONCE_SIZE + TICKET_PLAINTEXT + AEAD_TAG_SIZE;
+constexpr uint64_t EARLY_ACCEPTED = 0x01;
+
+constexpr char CLIENT_CONTEXT[] = "slonana-quic-v1 client";
+constexpr char SERVER_CONTEXT[] = "slonana-quic-v1 server";
+
+// Frame types used by the transport
+constexpr uint64_t FRAME_PADDING = 0x00;
+constexpr uint64_t FRAME_PING = 0x01;
+constexpr uint64_t FRAME_ACK = 0x02;
+constexpr uint64_t FRAME_ACK_ECN = 0x03;
+constexpr uint64_t FRAME_RESET_STREAM = 0x04;
+constexpr uint64_t FRAME_STOP_SENDING = 0x05;
+constexpr uint64_t FRAME_CRYPTO = 0x06;
+constexpr uint64_t FRAME_NEW_TOKEN = 0x07;
+constexpr uint64_t FRAME_STREAM = 0x08;
+constexpr uint64_t FRAME_MAX_DATA = 0x10;
+constexpr uint64_t FRAME_MAX_STREAM_DATA = 0x11;
+constexpr uint64_t FRAME_MAX_STREAMS_BIDI = 0x12;
+constexpr uint64_t FRAME_MAX_STREAMS_UNI = 0x13;
+constexpr uint64_t FRAME_DATA_BLOCKED = 0x14;
+constexpr uint64_t FRAME_STREAM_DATA_BLOCKED = 0x15;
+constexpr uint64_t FRAME_STREAMS_BLOCKED_BIDI = 0x16;
+constexpr uint64_t FRAME_STREAMS_BLOCKED_UNI = 0x17;
+constexpr uint64_t FRAME_CONNECTION_CLOSE = 0x1c;
+constexpr uint64_t FRAME_APPLICATION_CLOSE = 0x1d;
+constexpr uint64_t FRAME_HANDSHAKE_DONE = 0x1e;
+
+constexpr uint8_t STREAM_FIN = 0x01;
+constexpr uint8_t STREAM_LEN = 0x02;
+constexpr uint8_t STREAM_OFF = 0x04;
+
+// RFC 9001 section 5.2
+constexpr uint8_t INITIAL_SALT[] = {0x38, 0x76, 0x2c, 0xf7, 0xf5, 0x59, 0x34,
+                                    0xb3, 0x4d, 0x17, 0x9a, 0xe6, 0xa4, 0xc8,
+                                    0x0c, 0xad, 0xcc, 0xbb, 0x7f, 0x0a};
+
+void random_bytes(uint8_t *out, size_t length) {
+  RAND_bytes(out, static_cast<int>(length));
+}
+
+Key32 sha256(const uint8_t *data, size_t length) {
+  Key32 out;
+  unsigned int out_len = 0;
+  EVP_Digest(data, length, out.data(), &out_len, EVP_sha256(), nullptr);
+  return out;
+}
+
+std::shared_ptr<EVP_PKEY> generate_x25519(Key32 &public_key) {
+  EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_X25519, nullptr);
+  EVP_PKEY *key = nullptr;
+  if (ctx && EVP_PKEY_keygen_init(ctx) > 0) {
+    EVP_PKEY_keygen(ctx, &key);
+  }
+  EVP_PKEY_CTX_free(ctx);
+  if (!key) {
+    return nullptr;
+  }
+  size_t length = public_key.size();
+  EVP_PKEY_get_raw_public_key(key, public_key.data(), &length);
+  return std::shared_ptr<EVP_PKEY>(key, EVP_PKEY_free);
+}
+
+bool x25519(EVP_PKEY *own, const uint8_t *peer_public, Key32 &shared) {
+  EVP_PKEY *peer = EVP_PKEY_new_raw_public_key(EVP_PKEY_X25519, nullptr,
+                                               peer_public, 32);
+  if (!peer) {
+    return false;
+  }
+  EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new(own, nullptr);
+  size_t length = shared.size();
+  bool ok = ctx && EVP_PKEY_derive_init(ctx) > 0 &&
+            EVP_PKEY_derive_set_peer(ctx, peer) > 0 &&
+            EVP_PKEY_derive(ctx, shared.data(), &length) > 0 &&
+            length == shared.size();
+  EVP_PKEY_CTX_free(ctx);
+  EVP_PKEY_free(peer);
+  return ok;
+}
+
+/// One-shot AES-128-GCM used for resumption tickets
+bool ticket_cipher(const std::array<uint8_t, 16> &key, const uint8_t *nonce,
+                   const uint8_t *in, size_t length, uint8_t *out,
+                   uint8_t *tag, bool encrypt) {
+  EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+  int out_len = 0;
+  bool ok = ctx &&
+            EVP_CipherInit_ex(ctx, EVP_aes_128_gcm(), nullptr, key.data(),
+                              nonce, encrypt ? 1 : 0) > 0 &&
+            EVP_CipherUpdate(ctx, out, &out_len, in,
+                             static_cast<int>(length)) > 0;
+  if (ok && !encrypt) {
+    ok = EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, AEAD_TAG_SIZE, tag) >
+         0;
+  }
+  int final_len = 0;
+  ok = ok && EVP_CipherFinal_ex(ctx, out + out_len, &final_len) > 0;
+  if (ok && encrypt) {
+    ok = EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, AEAD_TAG_SIZE, tag) >
+         0;
+  }
+  EVP_CIPHER_CTX_free(ctx);
+  return ok;
+}
+
+void append_varint(std::vector<uint8_t> &out, uint64_t value) {
+  uint8_t buffer[8];
+  uint8_t *end = write_varint(buffer, value);
+  out.insert(out.end(), buffer, end);
+}
+
+void append_params(std::vector<uint8_t> &out, const TransportParameters &p) {
+  append_varint(out, p.max_streams_uni);
+  append_varint(out, p.max_stream_data);
+  append_varint(out, p.max_data);
+  append_varint(out, p.idle_timeout_ms);
+}
+
+bool read_params(const uint8_t *&p, const uint8_t *end,
+                 TransportParameters &params) {
+  return read_varint(p, end, params.max_streams_uni) &&
+         read_varint(p, end, params.max_stream_data) &&
+         read_varint(p, end, params.max_data) &&
+         read_varint(p, end, params.idle_timeout_ms);
+}
+
+/// Context string followed by the signed fields
+std::vector<uint8_t> signing_input(const char *context, const uint8_t *a,
+                                   size_t a_len, const uint8_t *b,
+                                   size_t b_len) {
+  std::vector<uint8_t> input(context, context + std::strlen(context));
+  input.insert(input.end(), a, a + a_len);
+  input.insert(input.end(), b, b + b_len);
+  return input;
+}
+
+uint64_t unix_seconds() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+void write_u64(uint8_t *out, uint64_t value) {
+  for (int i = 7; i >= 0; --i) {
+    out[i] = static_cast<uint8_t>(value);
+    value >>= 8;
+  }
+}
+
+uint64_t read_u64(const uint8_t *in) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8) | in[i];
+  }
+  return value;
+}
+
+uint64_t decode_packet_number(uint64_t largest, uint64_t truncated) {
+  // RFC 9000 appendix A.3 with a 32-bit packet number field
+  constexpr uint64_t window = 1ull << 32;
+  constexpr uint64_t half = window / 2;
+  uint64_t expected = largest + 1;
+  uint64_t candidate = (expected & ~(window - 1)) | truncated;
+  if (candidate + half <= expected && candidate < (1ull << 62) - window) {
+    return candidate + window;
+  }
+  if (candidate > expected + half && candidate >= window) {
+    return candidate - window;
+  }
+  return candidate;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Varints and key schedule
+
+size_t varint_size(uint64_t value) {
+  if (value < 0x40) {
+    return 1;
+  }
+  if (value < 0x4000) {
+    return 2;
+  }
+  if (value < 0x40000000) {
+    return 4;
+  }
+  return 8;
+}
+
+uint8_t *write_varint(uint8_t *out, uint64_t value) {
+  size_t size = varint_size(value);
+  static constexpr uint8_t prefix[] = {0, 0x40, 0, 0x80, 0, 0, 0, 0xc0};
+  for (size_t i = size; i-- > 0;) {
+    out[i] = static_cast<uint8_t>(value);
+    value >>= 8;
+  }
+  out[0] |= prefix[size - 1];
+  return out + size;
+}
+
+bool read_varint(const uint8_t *&in, const uint8_t *end, uint64_t &value) {
+  if (in >= end) {
+    return false;
+  }
+  size_t size = size_t{1} << (in[0] >> 6);
+  if (static_cast<size_t>(end - in) < size) {
+    return false;
+  }
+  value = in[0] & 0x3f;
+  for (size_t i = 1; i < size; ++i) {
+    value = (value << 8) | in[i];
+  }
+  in += size;
+  return true;
+}
+
+Key32 hkdf_extract(const uint8_t *salt, size_t salt_len, const uint8_t *ikm,
+                   size_t ikm_len) {
+  static const uint8_t empty = 0;
+  Key32 out;
+  unsigned int out_len = 0;
+  HMAC(EVP_sha256(), salt_len ? salt : &empty, static_cast<int>(salt_len),
+       ikm_len ? ikm : &empty, ikm_len, out.data(), &out_len);
+  return out;
+}
+
+void hkdf_expand_label(const Key32 &secret, const std::string &label,
+                       const uint8_t *context, size_t context_len,
+                       uint8_t *out, size_t length) {
+  // HkdfLabel: uint16 length, opaque label<7..255>, opaque context<0..255>,
+  // followed by the single-block HKDF-Expand counter
+  uint8_t info[2 + 1 + 255 + 1 + 255 + 1];
+  size_t pos = 0;
+  info[pos++] = static_cast<uint8_t>(length >> 8);
+  info[pos++] = static_cast<uint8_t>(length);
+  std::string full = "tls13 " + label;
+  info[pos++] = static_cast<uint8_t>(full.size());
+  std::memcpy(info + pos, full.data(), full.size());
+  pos += full.size();
+  info[pos++] = static_cast<uint8_t>(context_len);
+  if (context_len) {
+    std::memcpy(info + pos, context, context_len);
+    pos += context_len;
+  }
+  info[pos++] = 0x01;
+
+  uint8_t block[32];
+  unsigned int block_len = 0;
+  HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()), info,
+       pos, block, &block_len);
+  std::memcpy(out, block, std::min(length, sizeof(block)));
+}
+
+void initial_secrets(const uint8_t *dcid, size_t dcid_len, Key32 &client,
+                     Key32 &server) {
+  Key32 initial =
+      hkdf_extract(INITIAL_SALT, sizeof(INITIAL_SALT), dcid, dcid_len);
+  hkdf_expand_label(initial, "client in", nullptr, 0, client.data(), 32);
+  hkdf_expand_label(initial, "server in", nullptr, 0, server.data(), 32);
+}
+
+// ---------------------------------------------------------------------------
+// PacketProtection
+
+PacketProtection::PacketProtection()
+    : aead_(EVP_CIPHER_CTX_new()), hp_(EVP_CIPHER_CTX_new()) {}
+
+PacketProtection::~PacketProtection() {
+  EVP_CIPHER_CTX_free(aead_);
+  EVP_CIPHER_CTX_free(hp_);
+}
+
+void PacketProtection::install(const Key32 &secret, bool sealing) {
+  uint8_t key[16];
+  uint8_t hp_key[16];
+  hkdf_expand_label(secret, "quic key", nullptr, 0, key, sizeof(key));
+  hkdf_expand_label(secret, "quic iv", nullptr, 0, iv_.data(), iv_.size());
+  hkdf_expand_label(secret, "quic hp", nullptr, 0, hp_key, sizeof(hp_key));
+
+  EVP_CIPHER_CTX_reset(aead_);
+  EVP_CipherInit_ex(aead_, EVP_aes_128_gcm(), nullptr, nullptr, nullptr,
+                    sealing ? 1 : 0);
+  EVP_CIPHER_CTX_ctrl(aead_, EVP_CTRL_GCM_SET_IVLEN,
+                      static_cast<int>(iv_.size()), nullptr);
+  EVP_CipherInit_ex(aead_, nullptr, nullptr, key, nullptr, sealing ? 1 : 0);
+
+  EVP_CIPHER_CTX_reset(hp_);
+  EVP_EncryptInit_ex(hp_, EVP_aes_128_ecb(), nullptr, hp_key, nullptr);
+  EVP_CIPHER_CTX_set_padding(hp_, 0);
+  ready_ = true;
+}
+
+void PacketProtection::discard() { ready_ = false; }
+
+bool PacketProtection::header_mask(const uint8_t *sample, uint8_t *mask) {
+  int out_len = 0;
+  return EVP_EncryptUpdate(hp_, mask, &out_len, sample, 16) > 0 &&
+         out_len == 16;
+}
+
+size_t PacketProtection::seal(uint8_t *packet, size_t header_len,
+                              size_t pn_offset, size_t payload_len,
+                              uint64_t packet_number) {
+  uint8_t nonce[12];
+  std::memcpy(nonce, iv_.data(), sizeof(nonce));
+  for (int i = 0; i < 8; ++i) {
+    nonce[11 - i] ^= static_cast<uint8_t>(packet_number >> (8 * i));
+  }
+
+  int out_len = 0;
+  int final_len = 0;
+  uint8_t *payload = packet + header_len;
+  EVP_CipherInit_ex(aead_, nullptr, nullptr, nullptr, nonce, 1);
+  EVP_EncryptUpdate(aead_, nullptr, &out_len, packet,
+                    static_cast<int>(header_len));
+  EVP_EncryptUpdate(aead_, payload, &out_len, payload,
+                    static_cast<int>(payload_len));
+  EVP_EncryptFinal_ex(aead_, payload + out_len, &final_len);
+  EVP_CIPHER_CTX_ctrl(aead_, EVP_CTRL_GCM_GET_TAG, AEAD_TAG_SIZE,
+                      payload + payload_len);
+
+  // Header protection samples 16 bytes starting 4 bytes after the packet
+  // number field; with a 4-byte packet number that is the payload start
+  uint8_t mask[16];
+  header_mask(packet + pn_offset + 4, mask);
+  packet[0] ^= mask[0] & ((packet[0] & 0x80) ? 0x0f : 0x1f);
+  for (size_t i = 0; i < PN_LENGTH; ++i) {
+    packet[pn_offset + i] ^= mask[1 + i];
+  }
+  return header_len + payload_len + AEAD_TAG_SIZE;
+}
+
+bool PacketProtection::open(uint8_t *packet, size_t packet_len,
+                            size_t pn_offset, uint64_t largest_received,
+                            uint64_t &packet_number, size_t &payload_offset,
+                            size_t &payload_len) {
+  if (packet_len < pn_offset + 4 + 16) {
+    return false;
+  }
+  uint8_t mask[16];
+  if (!header_mask(packet + pn_offset + 4, mask)) {
+    return false;
+  }
+  uint8_t first = packet[0] ^ (mask[0] & ((packet[0] & 0x80) ? 0x0f : 0x1f));
+  size_t pn_len = (first & 0x03) + 1;
+  uint64_t truncated = 0;
+  for (size_t i = 0; i < pn_len; ++i) {
+    truncated = (truncated << 8) | (packet[pn_offset + i] ^ mask[1 + i]);
+  }
+  size_t header_len = pn_offset + pn_len;
+  if (packet_len < header_len + AEAD_TAG_SIZE) {
+    return false;
+  }
+
+  // Decode against the full-width window the sender used (we always send
+  // 4-byte packet numbers; peers using shorter ones decode the same way)
+  uint64_t number;
+  if (pn_len == 4) {
+    number = decode_packet_number(largest_received, truncated);
+  } else {
+    uint64_t window = 1ull << (pn_len * 8);
+    uint64_t expected = largest_received + 1;
+    number = (expected & ~(window - 1)) | truncated;
+    if (number + window / 2 <= expected) {
+      number += window;
+    } else if (number > expected + window / 2 && number >= window) {
+      number -= window;
+    }
+  }
+
+  // Unprotect the header in a copy so a forged packet leaves it untouched
+  uint8_t header[64];
+  if (header_len > sizeof(header)) {
+    return false;
+  }
+  std::memcpy(header, packet, header_len);
+  header[0] = first;
+  for (size_t i = 0; i < pn_len; ++i) {
+    header[pn_offset + i] ^= mask[1 + i];
+  }
+
+  uint8_t nonce[12];
+  std::memcpy(nonce, iv_.data(), sizeof(nonce));
+  for (int i = 0; i < 8; ++i) {
+    nonce[11 - i] ^= static_cast<uint8_t>(number >> (8 * i));
+  }
+
+  size_t ciphertext_len = packet_len - header_len - AEAD_TAG_SIZE;
+  uint8_t *payload = packet + header_len;
+  int out_len = 0;
+  int final_len = 0;
+  bool ok =
+      EVP_CipherInit_ex(aead_, nullptr, nullptr, nullptr, nonce, 0) > 0 &&
+      EVP_DecryptUpdate(aead_, nullptr, &out_len, header,
+                        static_cast<int>(header_len)) > 0 &&
+      EVP_DecryptUpdate(aead_, payload, &out_len, payload,
+                        static_cast<int>(ciphertext_len)) > 0 &&
+      EVP_CIPHER_CTX_ctrl(aead_, EVP_CTRL_GCM_SET_TAG, AEAD_TAG_SIZE,
+                          payload + ciphertext_len) > 0 &&
+      EVP_DecryptFinal_ex(aead_, payload + out_len, &final_len) > 0;
+  if (!ok) {
+    return false;
+  }
+  std::memcpy(packet, header, header_len);
+  packet_number = number;
+  payload_offset = header_len;
+  payload_len = ciphertext_len;
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Identity
+
+Identity::Identity() {
+  EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+  EVP_PKEY *key = nullptr;
+  if (ctx && EVP_PKEY_keygen_init(ctx) > 0) {
+    EVP_PKEY_keygen(ctx, &key);
+  }
+  EVP_PKEY_CTX_free(ctx);
+  key_.reset(key, EVP_PKEY_free);
+  size_t length = public_key_.size();
+  if (key) {
+    EVP_PKEY_get_raw_public_key(key, public_key_.data(), &length);
+  }
+}
+
+Identity::Identity(const Key32 &seed) {
+  EVP_PKEY *key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, nullptr,
+                                               seed.data(), seed.size());
+  key_.reset(key, EVP_PKEY_free);
+  size_t length = public_key_.size();
+  if (key) {
+    EVP_PKEY_get_raw_public_key(key, public_key_.data(), &length);
+  }
+}
+
+std::array<uint8_t, 64> Identity::sign(const uint8_t *message,
+                                       size_t length) const {
+  std::array<uint8_t, 64> signature{};
+  EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+  size_t signature_len = signature.size();
+  if (ctx && key_ &&
+      EVP_DigestSignInit(ctx, nullptr, nullptr, nullptr, key_.get()) > 0) {
+    EVP_DigestSign(ctx, signature.data(), &signature_len, message, length);
+  }
+  EVP_MD_CTX_free(ctx);
+  return signature;
+}
+
+bool Identity::verify(const Key32 &public_key, const uint8_t *message,
+                      size_t length, const uint8_t *signature) {
+  EVP_PKEY *key = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, nullptr,
+                                              public_key.data(), 32);
+  if (!key) {
+    return false;
+  }
+  EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+  bool ok = ctx &&
+            EVP_DigestVerifyInit(ctx, nullptr, nullptr, nullptr, key) > 0 &&
+            EVP_DigestVerify(ctx, signature, SIGNATURE_SIZE, message,
+                             length) == 1;
+  EVP_MD_CTX_free(ctx);
+  EVP_PKEY_free(key);
+  return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Recovery
+
+void RttEstimator::update(microseconds sample, microseconds ack_delay) {
+  latest = sample;
+  if (!has_sample) {
+    has_sample = true;
+    minimum = sample;
+    smoothed = sample;
+    variance = sample / 2;
+    return;
+  }
+  minimum = std::min(minimum, sample);
+  microseconds adjusted = sample;
+  if (sample >= minimum + ack_delay) {
+    adjusted = sample - ack_delay;
+  }
+  microseconds deviation =
+      smoothed > adjusted ? smoothed - adjusted : adjusted - smoothed;
+  variance = (3 * variance + deviation) / 4;
+  smoothed = (7 * smoothed + adjusted) / 8;
+}
+
+microseconds RttEstimator::pto(microseconds max_ack_delay) const {
+  return smoothed + std::max(4 * variance, microseconds(1000)) +
+         max_ack_delay;
+}
+
+void CongestionController::on_packet_acked(size_t bytes, TimePoint sent_time) {
+  bytes_in_flight_ -= std::min(bytes, bytes_in_flight_);
+  if (in_recovery_) {
+    if (sent_time <= recovery_start_) {
+      return;
+    }
+    in_recovery_ = false;
+  }
+  if (window_ < ssthresh_) {
+    window_ += bytes;
+  } else {
+    window_ += MAX_DATAGRAM_SIZE * bytes / window_;
+  }
+}
+
+void CongestionController::on_packets_lost(size_t bytes,
+                                           TimePoint largest_lost_sent_time,
+                                           TimePoint now) {
+  bytes_in_flight_ -= std::min(bytes, bytes_in_flight_);
+  // One window reduction per round trip
+  if (in_recovery_ && largest_lost_sent_time <= recovery_start_) {
+    return;
+  }
+  in_recovery_ = true;
+  recovery_start_ = now;
+  ssthresh_ = std::max(window_ / 2, MINIMUM_WINDOW);
+  window_ = ssthresh_;
+}
+
+void CongestionController::on_packet_discarded(size_t bytes) {
+  bytes_in_flight_ -= std::min(bytes, bytes_in_flight_);
+}
+
+bool TicketReplayGuard::first_use(const uint8_t *nonce, uint64_t expires,
+                                  uint64_t now) {
+  while (!by_expiry_.empty() && by_expiry_.begin()->first < now) {
+    seen_.erase(by_expiry_.begin()->second);
+    by_expiry_.erase(by_expiry_.begin());
+  }
+  if (seen_.size() >= capacity_) {
+    return false;
+  }
+  std::string key(reinterpret_cast<const char *>(nonce), TICKET_NONCE_SIZE);
+  if (!seen_.insert(key).second) {
+    return false;
+  }
+  by_expiry_.emplace(expires, std::move(key));
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Connection setup and handshake
+
+Connection::Connection(Role role, const Identity &identity,
+                       const TransportConfig &config)
+    : role_(role), identity_(identity), config_(config) {
+  random_bytes(local_cid_.data(), local_cid_.size());
+  stream_quota_ = config_.local.max_streams_uni;
+  max_streams_advertised_ = stream_quota_;
+  max_data_advertised_ = config_.local.max_data;
+}
+
+Connection::~Connection() = default;
+
+std::unique_ptr<Connection> Connection::connect(const Identity &identity,
+                                                const TransportConfig &config,
+                                                const ResumptionTicket *ticket,
+                                                TimePoint now) {
+  std::unique_ptr<Connection> connection(
+      new Connection(Role::CLIENT, identity, config));
+  connection->last_activity_ = now;
+  if (ticket && (ticket->ticket.empty() || ticket->expires <= now)) {
+    ticket = nullptr;
+  }
+  connection->start_client(ticket);
+  return connection;
+}
+
+std::unique_ptr<Connection>
+Connection::accept(const Identity &identity, const TransportConfig &config,
+                   const ServerPolicy &policy, const uint8_t *original_dcid,
+                   size_t dcid_len, TimePoint now) {
+  if (dcid_len != CID_LENGTH) {
+    return nullptr;
+  }
+  std::unique_ptr<Connection> connection(
+      new Connection(Role::SERVER, identity, config));
+  connection->policy_ = &policy;
+  connection->last_activity_ = now;
+  std::memcpy(connection->original_dcid_.data(), original_dcid, CID_LENGTH);
+
+  Key32 client_secret;
+  Key32 server_secret;
+  initial_secrets(original_dcid, dcid_len, client_secret, server_secret);
+  connection->rx_[LEVEL_INITIAL].install(client_secret, false);
+  connection->tx_[LEVEL_INITIAL].install(server_secret, true);
+  return connection;
+}
+
+void Connection::start_client(const ResumptionTicket *ticket) {
+  random_bytes(original_dcid_.data(), original_dcid_.size());
+  random_bytes(client_random_.data(), client_random_.size());
+
+  Key32 client_secret;
+  Key32 server_secret;
+  initial_secrets(original_dcid_.data(), original_dcid_.size(), client_secret,
+                  server_secret);
+  tx_[LEVEL_INITIAL].install(client_secret, true);
+  rx_[LEVEL_INITIAL].install(server_secret, false);
+
+  // Until the server answers, stream data may only use remembered limits
+  peer_params_.max_streams_uni = 0;
+  peer_params_.max_data = 0;
+  if (ticket && config_.enable_0rtt) {
+    Key32 early = hkdf_extract(client_random_.data(), client_random_.size(),
+                               ticket->secret.data(), ticket->secret.size());
+    Key32 early_secret;
+    hkdf_expand_label(early, "c e traffic", nullptr, 0, early_secret.data(),
+                      32);
+    tx_[LEVEL_EARLY].install(early_secret, true);
+    peer_params_ = ticket->peer_params;
+    early_data_attempted_ = true;
+  }
+
+  Key32 ephemeral_public;
+  ephemeral_ = generate_x25519(ephemeral_public);
+
+  client_hello_.reserve(256);
+  client_hello_.push_back(CLIENT_HELLO);
+  client_hello_.insert(client_hello_.end(), client_random_.begin(),
+                       client_random_.end());
+  client_hello_.insert(client_hello_.end(), ephemeral_public.begin(),
+                       ephemeral_public.end());
+  client_hello_.insert(client_hello_.end(), identity_.public_key().begin(),
+                       identity_.public_key().end());
+  append_params(client_hello_, config_.local);
+  if (early_data_attempted_) {
+    append_varint(client_hello_, ticket->ticket.size());
+    client_hello_.insert(client_hello_.end(), ticket->ticket.begin(),
+                         ticket->ticket.end());
+  } else {
+    append_varint(client_hello_, 0);
+  }
+  // Binding the original DCID ties the signature to this connection attempt
+  auto input = signing_input(CLIENT_CONTEXT, client_hello_.data(),
+                             client_hello_.size(), original_dcid_.data(),
+                             original_dcid_.size());
+  auto signature = identity_.sign(input.data(), input.size());
+  client_hello_.insert(client_hello_.end(), signature.begin(),
+                       signature.end());
+  crypto_pending_ = true;
+}
+
+bool Connection::handle_client_hello(const uint8_t *data, size_t length) {
+  const uint8_t *p = data;
+  const uint8_t *end = data + length;
+  if (length < 1 + 32 * 3 + SIGNATURE_SIZE || p[0] != CLIENT_HELLO) {
+    return false;
+  }
+  const uint8_t *signed_end = end - SIGNATURE_SIZE;
+  ++p;
+  std::memcpy(client_random_.data(), p, 32);
+  const uint8_t *peer_ephemeral = p + 32;
+  std::memcpy(peer_identity_.data(), p + 64, 32);
+  p += 96;
+  TransportParameters client_params;
+  uint64_t ticket_len = 0;
+  if (!read_params(p, signed_end, client_params) ||
+      !read_varint(p, signed_end, ticket_len) ||
+      static_cast<uint64_t>(signed_end - p) != ticket_len) {
+    return false;
+  }
+  const uint8_t *ticket = p;
+
+  auto input = signing_input(CLIENT_CONTEXT, data, signed_end - data,
+                             original_dcid_.data(), original_dcid_.size());
+  if (!Identity::verify(peer_identity_, input.data(), input.size(),
+                        signed_end)) {
+    close(TransportError::CRYPTO_ERROR, "bad client signature");
+    return true;
+  }
+  client_hello_.assign(data, end);
+  peer_params_ = client_params;
+
+  uint64_t quota = policy_ && policy_->stream_quota
+                       ? policy_->stream_quota(peer_identity_)
+                       : config_.local.max_streams_uni;
+  if (quota == 0) {
+    close(TransportError::CONNECTION_REFUSED, "connection limit");
+    return true;
+  }
+  stream_quota_ = quota;
+  max_streams_advertised_ = quota;
+
+  bool early_accepted = false;
+  Key32 ticket_secret;
+  if (ticket_len > 0 && config_.enable_0rtt &&
+      redeem_ticket(ticket, ticket_len, ticket_secret)) {
+    Key32 early = hkdf_extract(client_random_.data(), client_random_.size(),
+                               ticket_secret.data(), ticket_secret.size());
+    Key32 early_secret;
+    hkdf_expand_label(early, "c e traffic", nullptr, 0, early_secret.data(),
+                      32);
+    rx_[LEVEL_EARLY].install(early_secret, false);
+    early_accepted = true;
+    stats_.early_data_accepted = true;
+  }
+
+  Key32 ephemeral_public;
+  ephemeral_ = generate_x25519(ephemeral_public);
+  Key32 shared;
+  if (!ephemeral_ || !x25519(ephemeral_.get(), peer_ephemeral, shared)) {
+    close(TransportError::CRYPTO_ERROR, "key exchange failed");
+    return true;
+  }
+
+  TransportParameters server_params = config_.local;
+  server_params.max_streams_uni = quota;
+  Key32 server_random;
+  random_bytes(server_random.data(), server_random.size());
+  server_hello_.reserve(192);
+  server_hello_.push_back(SERVER_HELLO);
+  server_hello_.insert(server_hello_.end(), server_random.begin(),
+                       server_random.end());
+  server_hello_.insert(server_hello_.end(), ephemeral_public.begin(),
+                       ephemeral_public.end());
+  server_hello_.insert(server_hello_.end(), identity_.public_key().begin(),
+                       identity_.public_key().end());
+  append_params(server_hello_, server_params);
+  append_varint(server_hello_, early_accepted ? EARLY_ACCEPTED : 0);
+
+  Key32 client_hash = sha256(client_hello_.data(), client_hello_.size());
+  auto server_input =
+      signing_input(SERVER_CONTEXT, client_hash.data(), client_hash.size(),
+                    server_hello_.data(), server_hello_.size());
+  auto signature = identity_.sign(server_input.data(), server_input.size());
+
+  std::vector<uint8_t> transcript(client_hello_);
+  transcript.insert(transcript.end(), server_hello_.begin(),
+                    server_hello_.end());
+  Key32 transcript_hash = sha256(transcript.data(), transcript.size());
+  install_application_keys(hkdf_extract(transcript_hash.data(),
+                                        transcript_hash.size(), shared.data(),
+                                        shared.size()));
+  server_hello_.insert(server_hello_.end(), signature.begin(),
+                       signature.end());
+
+  crypto_pending_ = true;
+  handshake_done_pending_ = true;
+  if (config_.enable_0rtt && policy_) {
+    ticket_to_send_ = issue_ticket();
+    new_token_pending_ = true;
+  }
+  state_ = State::ESTABLISHED;
+  return true;
+}
+
+bool Connection::handle_server_hello(const uint8_t *data, size_t length) {
+  const uint8_t *p = data;
+  const uint8_t *end = data + length;
+  if (length < 1 + 32 * 3 + SIGNATURE_SIZE || p[0] != SERVER_HELLO) {
+    return false;
+  }
+  const uint8_t *signed_end = end - SIGNATURE_SIZE;
+  ++p;
+  const uint8_t *peer_ephemeral = p + 32;
+  Key32 server_identity;
+  std::memcpy(server_identity.data(), p + 64, 32);
+  p += 96;
+  TransportParameters server_params;
+  uint64_t flags = 0;
+  if (!read_params(p, signed_end, server_params) ||
+      !read_varint(p, signed_end, flags) || p != signed_end) {
+    return false;
+  }
+
+  Key32 client_hash = sha256(client_hello_.data(), client_hello_.size());
+  auto input = signing_input(SERVER_CONTEXT, client_hash.data(),
+                             client_hash.size(), data, signed_end - data);
+  if (!Identity::verify(server_identity, input.data(), input.size(),
+                        signed_end) ||
+      (config_.expected_server_identity &&
+       *config_.expected_server_identity != server_identity)) {
+    close(TransportError::CRYPTO_ERROR, "server authentication failed");
+    return true;
+  }
+
+  Key32 shared;
+  if (!ephemeral_ || !x25519(ephemeral_.get(), peer_ephemeral, shared)) {
+    close(TransportError::CRYPTO_ERROR, "key exchange failed");
+    return true;
+  }
+  peer_identity_ = server_identity;
+  server_hello_.assign(data, end);
+
+  std::vector<uint8_t> transcript(client_hello_);
+  transcript.insert(transcript.end(), data, signed_end);
+  Key32 transcript_hash = sha256(transcript.data(), transcript.size());
+  install_application_keys(hkdf_extract(transcript_hash.data(),
+                                        transcript_hash.size(), shared.data(),
+                                        shared.size()));
+
+  bool accepted = (flags & EARLY_ACCEPTED) != 0;
+  if (early_data_attempted_ && !accepted) {
+    reject_early_data();
+  }
+  stats_.early_data_accepted = early_data_attempted_ && accepted;
+  tx_[LEVEL_EARLY].discard();
+
+  // Limits from the ticket only ever grow into the fresh ones
+  peer_params_.max_streams_uni =
+      std::max(server_params.max_streams_uni,
+               accepted ? peer_params_.max_streams_uni : 0);
+  peer_params_.max_stream_data = server_params.max_stream_data;
+  peer_params_.max_data = std::max(server_params.max_data,
+                                   accepted ? peer_params_.max_data : 0);
+  peer_params_.idle_timeout_ms = server_params.idle_timeout_ms;
+
+  crypto_pending_ = false;
+  state_ = State::ESTABLISHED;
+  return true;
+}
+
+void Connection::install_application_keys(const Key32 &master) {
+  Key32 client_secret;
+  Key32 server_secret;
+  hkdf_expand_label(master, "c ap traffic", nullptr, 0, client_secret.data(),
+                    32);
+  hkdf_expand_label(master, "s ap traffic", nullptr, 0, server_secret.data(),
+                    32);
+  hkdf_expand_label(master, "res master", nullptr, 0,
+                    resumption_secret_.data(), 32);
+  bool client = role_ == Role::CLIENT;
+  tx_[LEVEL_1RTT].install(client ? client_secret : server_secret, true);
+  rx_[LEVEL_1RTT].install(client ? server_secret : client_secret, false);
+}
+
+std::vector<uint8_t> Connection::issue_ticket() {
+  uint8_t plaintext[TICKET_PLAINTEXT];
+  write_u64(plaintext, unix_seconds());
+  std::memcpy(plaintext + 8, peer_identity_.data(), 32);
+  std::memcpy(plaintext + 40, resumption_secret_.data(), 32);
+
+  std::vector<uint8_t> ticket(TICKET_SIZE);
+  random_bytes(ticket.data(), TICKET_NONCE_SIZE);
+  uint8_t *sealed = ticket.data() + TICKET_NONCE_SIZE;
+  if (!ticket_cipher(policy_->ticket_key, ticket.data(), plaintext,
+                     sizeof(plaintext), sealed, sealed + TICKET_PLAINTEXT,
+                     true)) {
+    return {};
+  }
+  return ticket;
+}
+
+bool Connection::redeem_ticket(const uint8_t *ticket, size_t length,
+                               Key32 &secret) {
+  if (!policy_ || length != TICKET_SIZE) {
+    return false;
+  }
+  uint8_t plaintext[TICKET_PLAINTEXT];
+  uint8_t tag[AEAD_TAG_SIZE];
+  const uint8_t *sealed = ticket + TICKET_NONCE_SIZE;
+  std::memcpy(tag, sealed + TICKET_PLAINTEXT, sizeof(tag));
+  if (!ticket_cipher(policy_->ticket_key, ticket, sealed, TICKET_PLAINTEXT,
+                     plaintext, tag, false)) {
+    return false;
+  }
+  uint64_t issued = read_u64(plaintext);
+  uint64_t now = unix_seconds();
+  uint64_t lifetime = static_cast<uint64_t>(config_.ticket_lifetime.count());
+  if (issued > now || now - issued > lifetime ||
+      std::memcmp(plaintext + 8, peer_identity_.data(), 32) != 0) {
+    return false;
+  }
+  // Early data is accepted once per ticket; a replayed flight gets 1-RTT
+  if (!policy_->replay_guard ||
+      !policy_->replay_guard->first_use(ticket, issued + lifetime, now)) {
+    return false;
+  }
+  std::memcpy(secret.data(), plaintext + 40, 32);
+  return true;
+}
+
+void Connection::discard_space(Space space) {
+  auto &sent = send_[space];
+  if (sent.discarded) {
+    return;
+  }
+  for (const auto &packet : sent.sent) {
+    if (packet.ack_eliciting) {
+      cc_.on_packet_discarded(packet.bytes);
+    }
+  }
+  sent.sent.clear();
+  sent.discarded = true;
+  sent.loss_time = TimePoint{};
+  recv_[space].ack_pending = false;
+  if (space == INITIAL) {
+    tx_[LEVEL_INITIAL].discard();
+    rx_[LEVEL_INITIAL].discard();
+    crypto_pending_ = false;
+  }
+}
+
+void Connection::reject_early_data() {
+  // The server never saw the 0-RTT packets: resend their streams as 1-RTT
+  auto &sent = send_[APPLICATION].sent;
+  std::deque<SentPacket> kept;
+  for (auto &packet : sent) {
+    if (!packet.early) {
+      kept.push_back(std::move(packet));
+      continue;
+    }
+    if (packet.ack_eliciting) {
+      cc_.on_packet_discarded(packet.bytes);
+    }
+    for (const auto &chunk : packet.chunks) {
+      auto it = send_streams_.find(chunk.stream_id);
+      if (it != send_streams_.end()) {
+        it->second.lost.push_back(chunk);
+        queue_stream(chunk.stream_id);
+      }
+    }
+  }
+  sent.swap(kept);
+}
+
+// ---------------------------------------------------------------------------
+// Receive path
+
+void Connection::receive(uint8_t *datagram, size_t length, TimePoint now) {
+  if (state_ == State::CLOSED) {
+    return;
+  }
+  stats_.bytes_received += length;
+  if (role_ == Role::SERVER && !handshake_confirmed_) {
+    bytes_received_unvalidated_ += length;
+  }
+  size_t offset = 0;
+  while (offset < length && state_ != State::CLOSED) {
+    size_t consumed = 0;
+    process_packet(datagram + offset, length - offset, consumed, now);
+    if (consumed == 0) {
+      break;
+    }
+    offset += consumed;
+  }
+}
+
+bool Connection::process_packet(uint8_t *packet, size_t length,
+                                 size_t &consumed, TimePoint now) {
+  Space space;
+  Level level;
+  size_t pn_offset;
+  size_t packet_len;
+
+  if (packet[0] & 0x80) {
+    if (length < 7) {
+      consumed = length;
+      return false;
+    }
+    uint32_t version = (uint32_t(packet[1]) << 24) |
+                       (uint32_t(packet[2]) << 16) |
+                       (uint32_t(packet[3]) << 8) | packet[4];
+    const uint8_t *p = packet + 5;
+    const uint8_t *end = packet + length;
+    size_t dcid_len = *p++;
+    if (version != VERSION_1 || static_cast<size_t>(end - p) < dcid_len + 1) {
+      consumed = length;
+      return false;
+    }
+    p += dcid_len;
+    size_t scid_len = *p++;
+    if (static_cast<size_t>(end - p) < scid_len) {
+      consumed = length;
+      return false;
+    }
+    const uint8_t *scid = p;
+    p += scid_len;
+    int type = (packet[0] >> 4) & 0x03;
+    uint64_t token_len = 0;
+    if (type == 0 &&
+        (!read_varint(p, end, token_len) ||
+         static_cast<uint64_t>(end - p) < token_len)) {
+      consumed = length;
+      return false;
+    }
+    p += token_len;
+    uint64_t payload_len = 0;
+    if (!read_varint(p, end, payload_len) ||
+        static_cast<uint64_t>(end - p) < payload_len) {
+      consumed = length;
+      return false;
+    }
+    pn_offset = p - packet;
+    packet_len = pn_offset + payload_len;
+    consumed = packet_len;
+
+    if (type == 0) {
+      space = INITIAL;
+      level = LEVEL_INITIAL;
+    } else if (type == 1 && role_ == Role::SERVER) {
+      space = APPLICATION;
+      level = LEVEL_EARLY;
+    } else {
+      stats_.packets_dropped++; // Handshake/Retry packets are never used
+      return false;
+    }
+    if (!rx_[level].ready() || scid_len != CID_LENGTH) {
+      stats_.packets_dropped++;
+      return false;
+    }
+    if (!peer_cid_known_) {
+      std::memcpy(peer_cid_.data(), scid, CID_LENGTH);
+      peer_cid_known_ = true;
+    }
+  } else {
+    // Short header packets run to the end of the datagram
+    consumed = length;
+    packet_len = length;
+    pn_offset = 1 + CID_LENGTH;
+    space = APPLICATION;
+    level = LEVEL_1RTT;
+    if (!rx_[level].ready()) {
+      stats_.packets_dropped++;
+      return false;
+    }
+  }
+
+  uint64_t packet_number = 0;
+  size_t payload_offset = 0;
+  size_t payload_len = 0;
+  auto &received = recv_[space];
+  if (!rx_[level].open(packet, packet_len, pn_offset, received.largest,
+                       packet_number, payload_offset, payload_len) ||
+      !record_received(space, packet_number, now)) {
+    stats_.packets_dropped++;
+    return false;
+  }
+  stats_.packets_received++;
+  last_activity_ = now;
+
+  if (level == LEVEL_1RTT && role_ == Role::SERVER && !handshake_confirmed_) {
+    // A 1-RTT packet proves the client derived the handshake keys
+    handshake_confirmed_ = true;
+    discard_space(INITIAL);
+    rx_[LEVEL_EARLY].discard();
+  }
+
+  bool ack_eliciting = false;
+  const uint8_t *payload = packet + payload_offset;
+  if (!process_frames(space, level == LEVEL_EARLY, payload,
+                      payload + payload_len, ack_eliciting, now)) {
+    if (state_ != State::CLOSED) {
+      close(TransportError::FRAME_ENCODING_ERROR, "malformed frame");
+    }
+    return false;
+  }
+  if (ack_eliciting && !send_[space].discarded) {
+    received.ack_pending = true;
+  }
+  return true;
+}
+
+bool Connection::record_received(Space space, uint64_t packet_number,
+                                 TimePoint now) {
+  auto &received = recv_[space];
+  auto &ranges = received.ranges;
+  if (!received.any || packet_number > received.largest) {
+    if (received.any && !ranges.empty() &&
+        packet_number == ranges.front().second + 1) {
+      ranges.front().second = packet_number;
+    } else {
+      ranges.insert(ranges.begin(), {packet_number, packet_number});
+    }
+    received.any = true;
+    received.largest = packet_number;
+    received.largest_time = now;
+  } else {
+    // Reordered packet: find its place among the descending ranges
+    size_t i = 0;
+    while (i < ranges.size() && ranges[i].first > packet_number) {
+      ++i;
+    }
+    if (i < ranges.size() && ranges[i].second >= packet_number) {
+      return false; // Duplicate
+    }
+    if (i == ranges.size() && !ranges.empty() && ranges.size() >=
+                                                     MAX_TRACKED_RANGES) {
+      return false; // Older than anything still tracked
+    }
+    bool joins_above = i > 0 && ranges[i - 1].first == packet_number + 1;
+    bool joins_below = i < ranges.size() &&
+                       ranges[i].second + 1 == packet_number;
+    if (joins_above && joins_below) {
+      ranges[i - 1].first = ranges[i].first;
+      ranges.erase(ranges.begin() + i);
+    } else if (joins_above) {
+      ranges[i - 1].first = packet_number;
+    } else if (joins_below) {
+      ranges[i].second = packet_number;
+    } else {
+      ranges.insert(ranges.begin() + i, {packet_number, packet_number});
+    }
+  }
+  if (ranges.size() > MAX_TRACKED_RANGES) {
+    ranges.resize(MAX_TRACKED_RANGES);
+  }
+  return true;
+}
+
+bool Connection::process_frames(Space space, bool early, const uint8_t *p,
+                                const uint8_t *end, bool &ack_eliciting,
+                                TimePoint now) {
+  while (p < end) {
+    uint64_t type;
+    if (!read_varint(p, end, type)) {
+      return false;
+    }
+    if (type != FRAME_PADDING && type != FRAME_ACK && type != FRAME_ACK_ECN &&
+        type != FRAME_CONNECTION_CLOSE && type != FRAME_APPLICATION_CLOSE) {
+      ack_eliciting = true;
+    }
+    // Initial packets carry only handshake frames; 0-RTT never carries ACK,
+    // CRYPTO or HANDSHAKE_DONE
+    if (space == INITIAL && type != FRAME_PADDING && type != FRAME_PING &&
+        type != FRAME_ACK && type != FRAME_ACK_ECN && type != FRAME_CRYPTO &&
+        type != FRAME_CONNECTION_CLOSE) {
+      close(TransportError::PROTOCOL_VIOLATION, "frame not allowed");
+      return false;
+    }
+    if (early && (type == FRAME_ACK || type == FRAME_ACK_ECN ||
+                  type == FRAME_CRYPTO || type == FRAME_NEW_TOKEN ||
+                  type == FRAME_HANDSHAKE_DONE)) {
+      close(TransportError::PROTOCOL_VIOLATION, "frame not allowed in 0-RTT");
+      return false;
+    }
+
+    uint64_t a, b, c;
+    switch (type) {
+    case FRAME_PADDING:
+      while (p < end && *p == 0) {
+        ++p;
+      }
+      break;
+    case FRAME_PING:
+      break;
+    case FRAME_ACK:
+    case FRAME_ACK_ECN:
+      if (!on_ack_frame(space, p, end, type, now)) {
+        return false;
+      }
+      break;
+    case FRAME_CRYPTO: {
+      if (!read_varint(p, end, a) || !read_varint(p, end, b) ||
+          static_cast<uint64_t>(end - p) < b || space != INITIAL || a != 0) {
+        return false;
+      }
+      const uint8_t *data = p;
+      p += b;
+      if (role_ == Role::SERVER) {
+        if (client_hello_.empty()) {
+          if (!handle_client_hello(data, b)) {
+            return false;
+          }
+        } else {
+          crypto_pending_ = !handshake_confirmed_; // Our reply was lost
+        }
+      } else if (server_hello_.empty()) {
+        if (!handle_server_hello(data, b)) {
+          return false;
+        }
+      }
+      if (state_ == State::CLOSED) {
+        return true;
+      }
+      break;
+    }
+    case FRAME_NEW_TOKEN: {
+      if (!read_varint(p, end, a) || static_cast<uint64_t>(end - p) < a ||
+          role_ != Role::CLIENT) {
+        return false;
+      }
+      ResumptionTicket ticket;
+      ticket.ticket.assign(p, p + a);
+      ticket.secret = resumption_secret_;
+      ticket.peer_params = peer_params_;
+      ticket.expires = now + config_.ticket_lifetime;
+      new_ticket_ = std::move(ticket);
+      p += a;
+      break;
+    }
+    case FRAME_RESET_STREAM: {
+      if (!read_varint(p, end, a) || !read_varint(p, end, b) ||
+          !read_varint(p, end, c)) {
+        return false;
+      }
+      uint64_t index = a >> 2;
+      uint64_t peer_uni = role_ == Role::SERVER ? 0x02 : 0x03;
+      if ((a & 0x03) == peer_uni && index < max_streams_advertised_ &&
+          index >= completed_below_ && !completed_above_.count(index)) {
+        recv_streams_.erase(a);
+        complete_stream(a, {}, c);
+      }
+      break;
+    }
+    case FRAME_STOP_SENDING:
+      if (!read_varint(p, end, a) || !read_varint(p, end, b)) {
+        return false;
+      }
+      send_streams_.erase(a);
+      break;
+    case FRAME_MAX_DATA:
+      if (!read_varint(p, end, a)) {
+        return false;
+      }
+      peer_params_.max_data = std::max(peer_params_.max_data, a);
+      break;
+    case FRAME_MAX_STREAMS_UNI:
+      if (!read_varint(p, end, a)) {
+        return false;
+      }
+      peer_params_.max_streams_uni = std::max(peer_params_.max_streams_uni, a);
+      break;
+    case FRAME_MAX_STREAM_DATA:
+    case FRAME_STREAM_DATA_BLOCKED:
+      if (!read_varint(p, end, a) || !read_varint(p, end, b)) {
+        return false;
+      }
+      break;
+    case FRAME_MAX_STREAMS_BIDI:
+    case FRAME_DATA_BLOCKED:
+    case FRAME_STREAMS_BLOCKED_BIDI:
+    case FRAME_STREAMS_BLOCKED_UNI:
+      if (!read_varint(p, end, a)) {
+        return false;
+      }
+      break;
+    case FRAME_CONNECTION_CLOSE:
+    case FRAME_APPLICATION_CLOSE:
+      // Enter draining: nothing more is sent or processed
+      state_ = State::CLOSED;
+      close_pending_ = false;
+      return true;
+    case FRAME_HANDSHAKE_DONE:
+      if (role_ != Role::CLIENT) {
+        return false;
+      }
+      if (!handshake_confirmed_) {
+        handshake_confirmed_ = true;
+        discard_space(INITIAL);
+      }
+      break;
+    default:
+      if (type >= FRAME_STREAM && type <= (FRAME_STREAM | 0x07)) {
+        if (!on_stream_frame(type, p, end)) {
+          return false;
+        }
+        if (state_ == State::CLOSED) {
+          return true;
+        }
+        break;
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Connection::on_ack_frame(Space space, const uint8_t *&p,
+                              const uint8_t *end, uint64_t frame_type,
+                              TimePoint now) {
+  uint64_t largest, delay, range_count, first_range;
+  if (!read_varint(p, end, largest) || !read_varint(p, end, delay) ||
+      !read_varint(p, end, range_count) ||
+      !read_varint(p, end, first_range) || first_range > largest) {
+    return false;
+  }
+  // [low, high] ranges in descending order
+  std::pair<uint64_t, uint64_t> ranges[MAX_ACK_RANGES + 1];
+  size_t count = 0;
+  ranges[count++] = {largest - first_range, largest};
+  uint64_t low = largest - first_range;
+  for (uint64_t i = 0; i < range_count; ++i) {
+    uint64_t gap, length;
+    if (!read_varint(p, end, gap) || !read_varint(p, end, length) ||
+        low < gap + 2 || low - gap - 2 < length) {
+      return false;
+    }
+    uint64_t high = low - gap - 2;
+    low = high - length;
+    if (count < MAX_ACK_RANGES + 1) {
+      ranges[count++] = {low, high};
+    }
+  }
+  if (frame_type == FRAME_ACK_ECN) {
+    uint64_t ect0, ect1, ce;
+    if (!read_varint(p, end, ect0) || !read_varint(p, end, ect1) ||
+        !read_varint(p, end, ce)) {
+      return false;
+    }
+  }
+
+  auto &sent = send_[space];
+  if (sent.discarded) {
+    return true;
+  }
+  if (!sent.any_acked || largest > sent.largest_acked) {
+    sent.largest_acked = largest;
+    sent.any_acked = true;
+  }
+
+  // sent is ordered by packet number ascending, ranges descending
+  std::deque<SentPacket> kept;
+  std::vector<SentPacket> acked;
+  size_t r = count;
+  for (auto &packet : sent.sent) {
+    while (r > 0 && ranges[r - 1].second < packet.packet_number) {
+      --r;
+    }
+    if (r > 0 && ranges[r - 1].first <= packet.packet_number) {
+      acked.push_back(std::move(packet));
+    } else {
+      kept.push_back(std::move(packet));
+    }
+  }
+  if (acked.empty()) {
+    return true;
+  }
+  sent.sent.swap(kept);
+
+  const auto &newest = acked.back();
+  if (newest.packet_number == largest && newest.ack_eliciting) {
+    microseconds ack_delay(delay << 3); // Default ack_delay_exponent
+    if (space == INITIAL) {
+      ack_delay = microseconds(0);
+    }
+    ack_delay = std::min(ack_delay,
+                         duration_cast<microseconds>(config_.max_ack_delay));
+    rtt_.update(duration_cast<microseconds>(now - newest.time), ack_delay);
+  }
+  for (auto &packet : acked) {
+    on_packet_acked(packet, now);
+  }
+  pto_backoff_ = 0;
+  detect_lost_packets(space, now);
+  return true;
+}
+
+bool Connection::on_stream_frame(uint64_t frame_type, const uint8_t *&p,
+                                 const uint8_t *end) {
+  uint64_t stream_id;
+  uint64_t offset = 0;
+  uint64_t length;
+  if (!read_varint(p, end, stream_id) ||
+      ((frame_type & STREAM_OFF) && !read_varint(p, end, offset))) {
+    return false;
+  }
+  if (frame_type & STREAM_LEN) {
+    if (!read_varint(p, end, length) ||
+        static_cast<uint64_t>(end - p) < length) {
+      return false;
+    }
+  } else {
+    length = end - p;
+  }
+  const uint8_t *data = p;
+  p += length;
+  bool fin = (frame_type & STREAM_FIN) != 0;
+
+  // Only the peer opens unidirectional streams towards us
+  uint64_t peer_uni = role_ == Role::SERVER ? 0x02 : 0x03;
+  if ((stream_id & 0x03) != peer_uni) {
+    close(TransportError::STREAM_STATE_ERROR, "not a peer uni stream");
+    return true;
+  }
+  uint64_t index = stream_id >> 2;
+  if (index < completed_below_ || completed_above_.count(index)) {
+    return true; // Retransmission of a stream already delivered
+  }
+  if (index >= max_streams_advertised_) {
+    close(TransportError::STREAM_LIMIT_ERROR, "stream limit exceeded");
+    return true;
+  }
+  uint64_t frame_end = offset + length;
+  if (frame_end > config_.local.max_stream_data) {
+    close(TransportError::FLOW_CONTROL_ERROR, "stream data limit exceeded");
+    return true;
+  }
+
+  auto it = recv_streams_.find(stream_id);
+  if (it == recv_streams_.end() && offset == 0 && fin) {
+    // Whole stream in one frame: the common case for a TPU transaction
+    data_received_ += frame_end;
+    if (data_received_ > max_data_advertised_) {
+      close(TransportError::FLOW_CONTROL_ERROR, "data limit exceeded");
+      return true;
+    }
+    complete_stream(stream_id, std::vector<uint8_t>(data, data + length),
+                    length);
+    return true;
+  }
+
+  auto &stream = it != recv_streams_.end() ? it->second
+                                           : recv_streams_[stream_id];
+  if (frame_end > stream.highest) {
+    data_received_ += frame_end - stream.highest;
+    stream.highest = frame_end;
+    if (data_received_ > max_data_advertised_) {
+      close(TransportError::FLOW_CONTROL_ERROR, "data limit exceeded");
+      return true;
+    }
+  }
+  if (fin) {
+    if ((stream.final_size != UINT64_MAX && stream.final_size != frame_end) ||
+        stream.highest > frame_end) {
+      close(TransportError::FINAL_SIZE_ERROR, "final size changed");
+      return true;
+    }
+    stream.final_size = frame_end;
+  } else if (stream.final_size != UINT64_MAX && frame_end > stream.final_size) {
+    close(TransportError::FINAL_SIZE_ERROR, "data beyond final size");
+    return true;
+  }
+  if (length > 0) {
+    if (stream.data.size() < frame_end) {
+      stream.data.resize(frame_end);
+    }
+    std::memcpy(stream.data.data() + offset, data, length);
+
+    // Merge [offset, frame_end) into the received ranges
+    uint64_t start = offset;
+    uint64_t stop = frame_end;
+    auto range = stream.have.upper_bound(start);
+    if (range != stream.have.begin()) {
+      auto previous = std::prev(range);
+      if (previous->second >= start) {
+        start = previous->first;
+        stop = std::max(stop, previous->second);
+        range = stream.have.erase(previous);
+      }
+    }
+    while (range != stream.have.end() && range->first <= stop) {
+      stop = std::max(stop, range->second);
+      range = stream.have.erase(range);
+    }
+    stream.have.emplace(start, stop);
+  }
+
+  if (stream.final_size != UINT64_MAX &&
+      (stream.final_size == 0 ||
+       (stream.have.size() == 1 && stream.have.begin()->first == 0 &&
+        stream.have.begin()->second == stream.final_size))) {
+    uint64_t size = stream.final_size;
+    std::vector<uint8_t> complete = std::move(stream.data);
+    complete.resize(size);
+    recv_streams_.erase(stream_id);
+    complete_stream(stream_id, std::move(complete), size);
+  }
+  return true;
+}
+
+void Connection::complete_stream(uint64_t stream_id, std::vector<uint8_t> data,
+                                 uint64_t size) {
+  uint64_t index = stream_id >> 2;
+  if (index == completed_below_) {
+    ++completed_below_;
+    while (completed_above_.erase(completed_below_)) {
+      ++completed_below_;
+    }
+  } else {
+    completed_above_.insert(index);
+  }
+  stats_.streams_completed++;
+  data_consumed_ += size;
+  if (!data.empty()) {
+    received_.push_back({stream_id, std::move(data)});
+  }
+
+  // Finished streams free quota: the peer may always keep stream_quota_
+  // streams open, and a connection-level window of fresh credit
+  uint64_t max_streams = stats_.streams_completed + stream_quota_;
+  if (max_streams > max_streams_advertised_) {
+    max_streams_advertised_ = max_streams;
+    max_streams_pending_ = true;
+  }
+  if (max_data_advertised_ - data_received_ < config_.local.max_data / 2) {
+    max_data_advertised_ = std::max(max_data_advertised_,
+                                    data_consumed_ + config_.local.max_data);
+    max_data_pending_ = true;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Send path
+
+size_t Connection::send(uint8_t *out, size_t capacity, TimePoint now) {
+  capacity = std::min(capacity, MAX_DATAGRAM_SIZE);
+  if (state_ == State::CLOSED) {
+    return close_pending_ ? write_close(out, capacity) : 0;
+  }
+  size_t total = 0;
+  if (!send_[INITIAL].discarded && tx_[LEVEL_INITIAL].ready()) {
+    total += write_packet(INITIAL, out, capacity, now,
+                          role_ == Role::CLIENT);
+  }
+  if (capacity - total > 64) {
+    total += write_packet(APPLICATION, out + total, capacity - total, now,
+                          false);
+  }
+  if (role_ == Role::SERVER && !handshake_confirmed_) {
+    bytes_sent_unvalidated_ += total;
+  }
+  stats_.bytes_sent += total;
+  return total;
+}
+
+size_t Connection::write_header(Space space, Level level, uint8_t *out,
+                                size_t &pn_offset, size_t &length_offset) {
+  size_t pos = 0;
+  if (level == LEVEL_1RTT) {
+    out[pos++] = 0x40 | static_cast<uint8_t>(PN_LENGTH - 1);
+    std::memcpy(out + pos, peer_cid_.data(), CID_LENGTH);
+    pos += CID_LENGTH;
+    length_offset = 0;
+  } else {
+    uint8_t type = space == INITIAL ? 0x00 : 0x01;
+    out[pos++] = 0xc0 | static_cast<uint8_t>(type << 4) |
+                 static_cast<uint8_t>(PN_LENGTH - 1);
+    out[pos++] = static_cast<uint8_t>(VERSION_1 >> 24);
+    out[pos++] = static_cast<uint8_t>(VERSION_1 >> 16);
+    out[pos++] = static_cast<uint8_t>(VERSION_1 >> 8);
+    out[pos++] = static_cast<uint8_t>(VERSION_1);
+    // Clients address the server's original DCID until the server answers
+    const auto &dcid = peer_cid_known_ ? peer_cid_ : original_dcid_;
+    out[pos++] = CID_LENGTH;
+    std::memcpy(out + pos, dcid.data(), CID_LENGTH);
+    pos += CID_LENGTH;
+    out[pos++] = CID_LENGTH;
+    std::memcpy(out + pos, local_cid_.data(), CID_LENGTH);
+    pos += CID_LENGTH;
+    if (space == INITIAL) {
+      out[pos++] = 0; // No token
+    }
+    length_offset = pos;
+    pos += LONG_LENGTH_FIELD;
+  }
+  pn_offset = pos;
+  uint64_t pn = send_[space].next_packet_number;
+  for (size_t i = 0; i < PN_LENGTH; ++i) {
+    out[pos + i] = static_cast<uint8_t>(pn >> (8 * (PN_LENGTH - 1 - i)));
+  }
+  return pos + PN_LENGTH;
+}
+
+size_t Connection::finish_packet(Space space, Level level, uint8_t *out,
+                                 size_t header_len, size_t pn_offset,
+                                 size_t length_offset, size_t payload_len) {
+  if (level != LEVEL_1RTT) {
+    size_t length = PN_LENGTH + payload_len + AEAD_TAG_SIZE;
+    out[length_offset] = 0x40 | static_cast<uint8_t>(length >> 8);
+    out[length_offset + 1] = static_cast<uint8_t>(length);
+  }
+  uint64_t pn = send_[space].next_packet_number++;
+  stats_.packets_sent++;
+  return tx_[level].seal(out, header_len, pn_offset, payload_len, pn);
+}
+
+size_t Connection::write_packet(Space space, uint8_t *out, size_t capacity,
+                                TimePoint now, bool pad_datagram) {
+  Level level;
+  if (space == INITIAL) {
+    level = LEVEL_INITIAL;
+  } else if (tx_[LEVEL_1RTT].ready()) {
+    level = LEVEL_1RTT;
+  } else if (tx_[LEVEL_EARLY].ready()) {
+    level = LEVEL_EARLY;
+  } else {
+    return 0;
+  }
+
+  size_t pn_offset = 0;
+  size_t length_offset = 0;
+  uint8_t scratch_header[64];
+  size_t header_len =
+      write_header(space, level, scratch_header, pn_offset, length_offset);
+  if (capacity < header_len + AEAD_TAG_SIZE + 32) {
+    return 0;
+  }
+  size_t budget = capacity - header_len - AEAD_TAG_SIZE;
+  // Anti-amplification: before the client is validated the server sends at
+  // most three times what it received
+  if (role_ == Role::SERVER && !handshake_confirmed_) {
+    size_t allowed = 3 * bytes_received_unvalidated_;
+    size_t used = bytes_sent_unvalidated_;
+    size_t remaining = allowed > used ? allowed - used : 0;
+    if (remaining < header_len + AEAD_TAG_SIZE + 32) {
+      return 0;
+    }
+    budget = std::min(budget, remaining - header_len - AEAD_TAG_SIZE);
+  }
+
+  uint8_t *payload = out + header_len;
+  size_t pos = 0;
+  SentPacket packet;
+  packet.packet_number = send_[space].next_packet_number;
+  packet.time = now;
+  packet.ack_eliciting = false;
+  packet.early = level == LEVEL_EARLY;
+  auto &received = recv_[space];
+
+  // ACK
+  if (received.ack_pending && received.any && level != LEVEL_EARLY) {
+    uint8_t frame[16 + MAX_ACK_RANGES * 16];
+    uint8_t *f = frame;
+    const auto &ranges = received.ranges;
+    f = write_varint(f, FRAME_ACK);
+    f = write_varint(f, received.largest);
+    uint64_t delay = space == INITIAL
+                         ? 0
+                         : static_cast<uint64_t>(
+                               duration_cast<microseconds>(
+                                   now - received.largest_time)
+                                   .count()) >> 3;
+    f = write_varint(f, delay);
+    size_t range_count = std::min(ranges.size(), MAX_ACK_RANGES) - 1;
+    f = write_varint(f, range_count);
+    f = write_varint(f, ranges[0].second - ranges[0].first);
+    for (size_t i = 1; i <= range_count; ++i) {
+      f = write_varint(f, ranges[i - 1].first - ranges[i].second - 2);
+      f = write_varint(f, ranges[i].second - ranges[i].first);
+    }
+    size_t frame_len = f - frame;
+    if (frame_len <= budget - pos) {
+      std::memcpy(payload + pos, frame, frame_len);
+      pos += frame_len;
+      received.ack_pending = false;
+    }
+  }
+
+  // Handshake and control frames
+  if (space == INITIAL && crypto_pending_) {
+    const auto &hello = role_ == Role::CLIENT ? client_hello_ : server_hello_;
+    size_t frame_len = 1 + 1 + varint_size(hello.size()) + hello.size();
+    if (!hello.empty() && frame_len <= budget - pos) {
+      uint8_t *f = payload + pos;
+      f = write_varint(f, FRAME_CRYPTO);
+      f = write_varint(f, 0);
+      f = write_varint(f, hello.size());
+      std::memcpy(f, hello.data(), hello.size());
+      pos += frame_len;
+      crypto_pending_ = false;
+      packet.crypto = true;
+      packet.ack_eliciting = true;
+    }
+  }
+  if (level == LEVEL_1RTT) {
+    if (handshake_done_pending_ && budget - pos >= 1) {
+      payload[pos++] = FRAME_HANDSHAKE_DONE;
+      handshake_done_pending_ = false;
+      packet.handshake_done = true;
+      packet.ack_eliciting = true;
+    }
+    if (max_streams_pending_ && budget - pos >= 9) {
+      uint8_t *f = write_varint(payload + pos, FRAME_MAX_STREAMS_UNI);
+      f = write_varint(f, max_streams_advertised_);
+      pos = f - payload;
+      max_streams_pending_ = false;
+      packet.max_streams = true;
+      packet.ack_eliciting = true;
+    }
+    if (max_data_pending_ && budget - pos >= 9) {
+      uint8_t *f = write_varint(payload + pos, FRAME_MAX_DATA);
+      f = write_varint(f, max_data_advertised_);
+      pos = f - payload;
+      max_data_pending_ = false;
+      packet.max_data = true;
+      packet.ack_eliciting = true;
+    }
+    if (new_token_pending_ && !ticket_to_send_.empty() &&
+        budget - pos >= 3 + ticket_to_send_.size()) {
+      uint8_t *f = write_varint(payload + pos, FRAME_NEW_TOKEN);
+      f = write_varint(f, ticket_to_send_.size());
+      std::memcpy(f, ticket_to_send_.data(), ticket_to_send_.size());
+      pos = (f - payload) + ticket_to_send_.size();
+      new_token_pending_ = false;
+      packet.new_token = true;
+      packet.ack_eliciting = true;
+    }
+  }
+
+  // Stream data; probes may exceed the congestion window
+  bool probe = probes_pending_ > 0;
+  if (space == APPLICATION && (cc_.available() > 0 || probe)) {
+    size_t rotations = send_queue_.size();
+    while (rotations-- > 0 && !send_queue_.empty()) {
+      size_t room = budget - pos;
+      if (room < 24) {
+        break;
+      }
+      uint64_t stream_id = send_queue_.front();
+      send_queue_.pop_front();
+      auto it = send_streams_.find(stream_id);
+      if (it == send_streams_.end()) {
+        continue;
+      }
+      auto &stream = it->second;
+
+      StreamChunk chunk{stream_id, 0, 0, false};
+      bool retransmit = !stream.lost.empty();
+      size_t header = 1 + varint_size(stream_id) + 8 + 2;
+      size_t max_len = room - header;
+      if (retransmit) {
+        auto &lost = stream.lost.back();
+        chunk.offset = lost.offset;
+        chunk.length = std::min<uint64_t>(lost.length, max_len);
+        chunk.fin = lost.fin && chunk.length == lost.length;
+        if (chunk.length == lost.length) {
+          stream.lost.pop_back();
+        } else {
+          lost.offset += chunk.length;
+          lost.length -= chunk.length;
+        }
+      } else {
+        if ((stream_id >> 2) >= peer_params_.max_streams_uni) {
+          send_queue_.push_back(stream_id); // Wait for MAX_STREAMS
+          continue;
+        }
+        uint64_t unsent = stream.data.size() - stream.next_offset;
+        uint64_t stream_credit =
+            peer_params_.max_stream_data > stream.next_offset
+                ? peer_params_.max_stream_data - stream.next_offset
+                : 0;
+        uint64_t data_credit = peer_params_.max_data > data_sent_
+                                   ? peer_params_.max_data - data_sent_
+                                   : 0;
+        chunk.offset = stream.next_offset;
+        chunk.length = std::min<uint64_t>(
+            {unsent, stream_credit, data_credit, max_len});
+        chunk.fin = stream.fin && !stream.fin_sent &&
+                    chunk.offset + chunk.length == stream.data.size();
+        if (chunk.length == 0 && !chunk.fin) {
+          if (unsent == 0) {
+            stream.queued = false; // Nothing left until the next write
+          } else {
+            send_queue_.push_back(stream_id); // Flow control blocked
+          }
+          continue;
+        }
+        stream.next_offset += chunk.length;
+        data_sent_ += chunk.length;
+        stream.fin_sent = stream.fin_sent || chunk.fin;
+      }
+
+      uint8_t *f = payload + pos;
+      uint8_t type = FRAME_STREAM | STREAM_LEN;
+      if (chunk.offset > 0) {
+        type |= STREAM_OFF;
+      }
+      if (chunk.fin) {
+        type |= STREAM_FIN;
+      }
+      *f++ = type;
+      f = write_varint(f, stream_id);
+      if (chunk.offset > 0) {
+        f = write_varint(f, chunk.offset);
+      }
+      // Fixed two-byte length keeps the frame size predictable
+      *f++ = 0x40 | static_cast<uint8_t>(chunk.length >> 8);
+      *f++ = static_cast<uint8_t>(chunk.length);
+      std::memcpy(f, stream.data.data() + chunk.offset, chunk.length);
+      pos = (f - payload) + chunk.length;
+      packet.chunks.push_back(chunk);
+      packet.ack_eliciting = true;
+
+      bool more = !stream.lost.empty() ||
+                  stream.next_offset < stream.data.size() ||
+                  (stream.fin && !stream.fin_sent);
+      if (more) {
+        send_queue_.push_front(stream_id); // Packet is full; continue next
+        break;
+      }
+      stream.queued = false;
+    }
+  }
+
+  if (probe) {
+    if (!packet.ack_eliciting && budget - pos >= 1) {
+      payload[pos++] = FRAME_PING;
+      packet.ack_eliciting = true;
+    }
+    --probes_pending_;
+  }
+
+  if (pos == 0) {
+    return 0;
+  }
+  // Clients pad ack-eliciting Initial datagrams to the minimum size; every
+  // packet needs enough ciphertext for the header protection sample
+  size_t min_payload = pad_datagram && packet.ack_eliciting ? budget : 4;
+  if (pos < min_payload) {
+    std::memset(payload + pos, 0, min_payload - pos);
+    pos = min_payload;
+  }
+
+  std::memcpy(out, scratch_header, header_len);
+  size_t bytes = finish_packet(space, level, out, header_len, pn_offset,
+                               length_offset, pos);
+  if (packet.ack_eliciting) {
+    packet.bytes = bytes;
+    cc_.on_packet_sent(bytes);
+    send_[space].sent.push_back(std::move(packet));
+  }
+  return bytes;
+}
+
+size_t Connection::write_close(uint8_t *out, size_t capacity) {
+  close_pending_ = false;
+  Space space = APPLICATION;
+  Level level = LEVEL_1RTT;
+  if (!tx_[LEVEL_1RTT].ready() ||
+      (role_ == Role::CLIENT && !send_[INITIAL].discarded &&
+       server_hello_.empty())) {
+    space = INITIAL;
+    level = LEVEL_INITIAL;
+  }
+  if (!tx_[level].ready()) {
+    return 0;
+  }
+  size_t pn_offset = 0;
+  size_t length_offset = 0;
+  size_t header_len = write_header(space, level, out, pn_offset, length_offset);
+  std::string reason = close_reason_.substr(0, 64);
+  if (capacity < header_len + 32 + reason.size()) {
+    return 0;
+  }
+  uint8_t *payload = out + header_len;
+  uint8_t *f = write_varint(payload, FRAME_CONNECTION_CLOSE);
+  f = write_varint(f, static_cast<uint64_t>(close_error_));
+  f = write_varint(f, 0);
+  f = write_varint(f, reason.size());
+  std::memcpy(f, reason.data(), reason.size());
+  size_t pos = (f - payload) + reason.size();
+  if (pos < 4) {
+    std::memset(payload + pos, 0, 4 - pos);
+    pos = 4;
+  }
+  return finish_packet(space, level, out, header_len, pn_offset,
+                       length_offset, pos);
+}
+
+bool Connection::has_stream_data_to_send() const {
+  return !send_queue_.empty();
+}
+
+bool Connection::can_send_stream_data() const {
+  return state_ != State::CLOSED &&
+         (tx_[LEVEL_1RTT].ready() || tx_[LEVEL_EARLY].ready());
+}
+
+void Connection::on_packet_acked(SentPacket &packet, TimePoint now) {
+  (void)now;
+  if (packet.ack_eliciting) {
+    cc_.on_packet_acked(packet.bytes, packet.time);
+  }
+  for (const auto &chunk : packet.chunks) {
+    auto it = send_streams_.find(chunk.stream_id);
+    if (it == send_streams_.end()) {
+      continue;
+    }
+    auto &stream = it->second;
+    stream.acked_bytes += chunk.length;
+    stream.fin_acked = stream.fin_acked || chunk.fin;
+    if (stream.fin_acked && stream.acked_bytes >= stream.data.size()) {
+      send_streams_.erase(it); // Queue entries for it are skipped
+    }
+  }
+}
+
+void Connection::on_packet_lost(SentPacket &packet) {
+  stats_.packets_lost++;
+  if (packet.crypto) {
+    // The client stops resending once the server answered; the server until
+    // the handshake is confirmed
+    crypto_pending_ = role_ == Role::CLIENT ? server_hello_.empty()
+                                            : !handshake_confirmed_;
+  }
+  handshake_done_pending_ |= packet.handshake_done;
+  max_streams_pending_ |= packet.max_streams;
+  max_data_pending_ |= packet.max_data;
+  new_token_pending_ |= packet.new_token;
+  for (const auto &chunk : packet.chunks) {
+    auto it = send_streams_.find(chunk.stream_id);
+    if (it != send_streams_.end()) {
+      it->second.lost.push_back(chunk);
+      queue_stream(chunk.stream_id);
+    }
+  }
+}
+
+void Connection::detect_lost_packets(Space space, TimePoint now) {
+  auto &sent = send_[space];
+  sent.loss_time = TimePoint{};
+  if (!sent.any_acked) {
+    return;
+  }
+  microseconds loss_delay = std::max(
+      (std::max(rtt_.latest, rtt_.smoothed) * 9) / 8, microseconds(1000));
+  TimePoint lost_send_time = now - loss_delay;
+
+  std::deque<SentPacket> kept;
+  size_t lost_bytes = 0;
+  TimePoint largest_lost_time{};
+  for (auto &packet : sent.sent) {
+    if (packet.packet_number > sent.largest_acked) {
+      kept.push_back(std::move(packet));
+      continue;
+    }
+    if (packet.time <= lost_send_time ||
+        sent.largest_acked >= packet.packet_number + 3) {
+      if (packet.ack_eliciting) {
+        lost_bytes += packet.bytes;
+        largest_lost_time = std::max(largest_lost_time, packet.time);
+      }
+      on_packet_lost(packet);
+    } else {
+      TimePoint deadline = packet.time + loss_delay;
+      if (sent.loss_time == TimePoint{} || deadline < sent.loss_time) {
+        sent.loss_time = deadline;
+      }
+      kept.push_back(std::move(packet));
+    }
+  }
+  sent.sent.swap(kept);
+  if (lost_bytes > 0) {
+    cc_.on_packets_lost(lost_bytes, largest_lost_time, now);
+  }
+}
+
+TimePoint Connection::pto_deadline() const {
+  TimePoint deadline = TimePoint::max();
+  for (int s = 0; s < SPACE_COUNT; ++s) {
+    const auto &sent = send_[s];
+    if (sent.discarded) {
+      continue;
+    }
+    for (auto it = sent.sent.rbegin(); it != sent.sent.rend(); ++it) {
+      if (!it->ack_eliciting) {
+        continue;
+      }
+      auto max_ack_delay =
+          s == APPLICATION ? duration_cast<microseconds>(config_.max_ack_delay)
+                           : microseconds(0);
+      auto timeout = rtt_.pto(max_ack_delay) * (int64_t{1} << pto_backoff_);
+      deadline = std::min(deadline, it->time + timeout);
+      break;
+    }
+  }
+  return deadline;
+}
+
+TimePoint Connection::next_timeout() const {
+  if (state_ == State::CLOSED) {
+    return TimePoint::max();
+  }
+  TimePoint deadline = last_activity_ + config_.idle_timeout;
+  for (const auto &sent : send_) {
+    if (sent.loss_time != TimePoint{}) {
+      deadline = std::min(deadline, sent.loss_time);
+    }
+  }
+  return std::min(deadline, pto_deadline());
+}
+
+void Connection::on_timeout(TimePoint now) {
+  if (state_ == State::CLOSED) {
+    return;
+  }
+  if (now >= last_activity_ + config_.idle_timeout) {
+    state_ = State::CLOSED; // Silent close
+    return;
+  }
+  for (int s = 0; s < SPACE_COUNT; ++s) {
+    if (send_[s].loss_time != TimePoint{} && now >= send_[s].loss_time) {
+      detect_lost_packets(static_cast<Space>(s), now);
+      return;
+    }
+  }
+  if (now < pto_deadline()) {
+    return;
+  }
+  stats_.pto_count++;
+  pto_backoff_ = std::min<uint32_t>(pto_backoff_ + 1, 16);
+  probes_pending_ = 1;
+  if (!send_[INITIAL].discarded) {
+    // Resend the hello rather than a bare PING during the handshake
+    crypto_pending_ = role_ == Role::CLIENT ? server_hello_.empty()
+                                            : !handshake_confirmed_;
+  }
+  // Oldest unacknowledged stream data goes out again as the probe payload
+  auto &sent = send_[APPLICATION].sent;
+  for (auto &packet : sent) {
+    if (!packet.chunks.empty()) {
+      for (const auto &chunk : packet.chunks) {
+        auto it = send_streams_.find(chunk.stream_id);
+        if (it != send_streams_.end()) {
+          it->second.lost.push_back(chunk);
+          queue_stream(chunk.stream_id);
+        }
+      }
+      packet.chunks.clear();
+      break;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Streams
+
+uint64_t Connection::open_uni_stream() {
+  uint64_t stream_id =
+      (next_uni_index_++ << 2) | (role_ == Role::CLIENT ? 0x02 : 0x03);
+  send_streams_.emplace(stream_id, SendStream{});
+  return stream_id;
+}
+
+bool Connection::write_stream(uint64_t stream_id, const uint8_t *data,
+                              size_t length, bool fin) {
+  auto it = send_streams_.find(stream_id);
+  if (it == send_streams_.end() || it->second.fin ||
+      state_ == State::CLOSED) {
+    return false;
+  }
+  auto &stream = it->second;
+  if (length > 0) {
+    stream.data.insert(stream.data.end(), data, data + length);
+  }
+  stream.fin = fin;
+  if (length > 0 || fin) {
+    queue_stream(stream_id);
+  }
+  return true;
+}
+
+uint64_t Connection::send_stream(const uint8_t *data, size_t length) {
+  uint64_t stream_id = open_uni_stream();
+  write_stream(stream_id, data, length, true);
+  return stream_id;
+}
+
+void Connection::queue_stream(uint64_t stream_id) {
+  auto it = send_streams_.find(stream_id);
+  if (it != send_streams_.end() && !it->second.queued) {
+    it->second.queued = true;
+    send_queue_.push_back(stream_id);
+  }
+}
+
+void Connection::take_received(std::vector<ReceivedStream> &out) {
+  if (out.empty()) {
+    out.swap(received_);
+  } else {
+    std::move(received_.begin(), received_.end(), std::back_inserter(out));
+  }
+  received_.clear();
+}
+
+void Connection::close(TransportError error, const std::string &reason) {
+  if (state_ == State::CLOSED) {
+    return;
+  }
+  state_ = State::CLOSED;
+  close_pending_ = true;
+  close_error_ = error;
+  close_reason_ = reason;
+}
+
+std::optional<ResumptionTicket> Connection::take_ticket() {
+  return std::exchange(new_ticket_, std::nullopt);
+}
+
+// ---------------------------------------------------------------------------
+// Routing and batched I/O
+
+bool parse_destination_cid(const uint8_t *datagram, size_t length,
+                           uint64_t &key, bool &is_initial) {
+  if (length < 1 + CID_LENGTH) {
+    return false;
+  }
+  if (datagram[0] & 0x80) {
+    if (length < 6 + CID_LENGTH || datagram[1] != 0 || datagram[2] != 0 ||
+        datagram[3] != 0 || datagram[4] != VERSION_1 ||
+        datagram[5] != CID_LENGTH) {
+      return false;
+    }
+    key = cid_key(datagram + 6);
+    is_initial = ((datagram[0] >> 4) & 0x03) == 0;
+    return true;
+  }
+  key = cid_key(datagram + 1);
+  is_initial = false;
+  return true;
+}
+
+namespace {
+
+bool same_peer(const sockaddr_in &a, const sockaddr_in &b) {
+  return a.sin_addr.s_addr == b.sin_addr.s_addr && a.sin_port == b.sin_port;
+}
+
+constexpr size_t MAX_BATCH = 64;
+constexpr size_t MAX_GSO_SEGMENTS = 64;
+constexpr size_t MAX_GSO_BYTES = 65000;
+
+} // namespace
+
+size_t UdpBatchSender::send(const OutgoingDatagram *datagrams, size_t count) {
+  if (!gso_enabled_) {
+    return send_plain(datagrams, count);
+  }
+  size_t sent = 0;
+  while (sent < count) {
+    mmsghdr messages[MAX_BATCH];
+    iovec iovs[MAX_BATCH * 4];
+    alignas(cmsghdr) uint8_t control[MAX_BATCH][CMSG_SPACE(sizeof(uint16_t))];
+    size_t first[MAX_BATCH + 1];
+    size_t message_count = 0;
+    size_t iov_count = 0;
+    size_t i = sent;
+
+    while (i < count && message_count < MAX_BATCH) {
+      // A run shares the peer and segment size; only the last may be shorter
+      size_t segment = datagrams[i].length;
+      size_t j = i + 1;
+      size_t bytes = segment;
+      while (j < count && j - i < MAX_GSO_SEGMENTS &&
+             iov_count + (j - i) < MAX_BATCH * 4 &&
+             datagrams[j - 1].length == segment &&
+             datagrams[j].length <= segment &&
+             bytes + datagrams[j].length <= MAX_GSO_BYTES &&
+             (connected_ || same_peer(datagrams[i].peer, datagrams[j].peer))) {
+        bytes += datagrams[j].length;
+        ++j;
+      }
+      if (iov_count + (j - i) > MAX_BATCH * 4) {
+        break;
+      }
+
+      auto &message = messages[message_count];
+      std::memset(&message, 0, sizeof(message));
+      for (size_t k = i; k < j; ++k) {
+        iovs[iov_count + (k - i)].iov_base =
+            const_cast<uint8_t *>(datagrams[k].data);
+        iovs[iov_count + (k - i)].iov_len = datagrams[k].length;
+      }
+      message.msg_hdr.msg_iov = &iovs[iov_count];
+      message.msg_hdr.msg_iovlen = j - i;
+      if (!connected_) {
+        message.msg_hdr.msg_name = const_cast<sockaddr_in *>(&datagrams[i].peer);
+        message.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      }
+      if (j - i > 1) {
+        message.msg_hdr.msg_control = control[message_count];
+        message.msg_hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+        cmsghdr *cmsg = CMSG_FIRSTHDR(&message.msg_hdr);
+        cmsg->cmsg_level = SOL_UDP;
+        cmsg->cmsg_type = UDP_SEGMENT;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+        uint16_t gso_size = static_cast<uint16_t>(segment);
+        std::memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+      }
+      first[message_count] = i;
+      iov_count += j - i;
+      ++message_count;
+      i = j;
+    }
+    first[message_count] = i;
+
+    int result = sendmmsg(socket_fd_, messages,
+                          static_cast<unsigned int>(message_count), 0);
+    syscalls_++;
+    if (result < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return sent; // Loss recovery resends whatever was dropped here
+      }
+      // Kernel or device without UDP GSO support
+      gso_enabled_ = false;
+      return sent + send_plain(datagrams + sent, count - sent);
+    }
+    sent = first[result];
+    if (static_cast<size_t>(result) < message_count) {
+      return sent;
+    }
+  }
+  return sent;
+}
+
+size_t UdpBatchSender::send_plain(const OutgoingDatagram *datagrams,
+                                  size_t count) {
+  size_t sent = 0;
+  while (sent < count) {
+    mmsghdr messages[MAX_BATCH];
+    iovec iovs[MAX_BATCH];
+    size_t batch = std::min(count - sent, MAX_BATCH);
+    for (size_t k = 0; k < batch; ++k) {
+      const auto &datagram = datagrams[sent + k];
+      std::memset(&messages[k], 0, sizeof(mmsghdr));
+      iovs[k].iov_base = const_cast<uint8_t *>(datagram.data);
+      iovs[k].iov_len = datagram.length;
+      messages[k].msg_hdr.msg_iov = &iovs[k];
+      messages[k].msg_hdr.msg_iovlen = 1;
+      if (!connected_) {
+        messages[k].msg_hdr.msg_name = const_cast<sockaddr_in *>(&datagram.peer);
+        messages[k].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+      }
+    }
+    int result =
+        sendmmsg(socket_fd_, messages, static_cast<unsigned int>(batch), 0);
+    syscalls_++;
+    if (result <= 0) {
+      return sent;
+    }
+    sent += result;
+    if (static_cast<size_t>(result) < batch) {
+      return sent;
+    }
+  }
+  return sent;
+}
+
+} // namespace quic
+} // namespace network
+} // namespace slonana
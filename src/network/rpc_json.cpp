@@ -0,0 +1,701 @@
+#include "network/rpc_json.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace slonana {
+namespace network {
+namespace rpc_json {
+
+namespace {
+
+inline bool is_ws(char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * Recursive-descent tokenizer writing pre-order tokens onto the tape.
+ * Recursion depth is bounded by JsonDocument::MAX_DEPTH.
+ */
+class Tokenizer {
+public:
+  Tokenizer(std::vector<JsonToken> &tape, std::string_view input)
+      : tape_(tape), begin_(input.data()), p_(input.data()),
+        end_(input.data() + input.size()) {}
+
+  bool run() {
+    skip_ws();
+    if (!value({}, 0)) {
+      return false;
+    }
+    skip_ws();
+    return p_ == end_;
+  }
+
+  size_t offset() const { return static_cast<size_t>(p_ - begin_); }
+
+private:
+  void skip_ws() {
+    while (p_ < end_ && is_ws(*p_)) {
+      ++p_;
+    }
+  }
+
+  // Scans a quoted string starting at the opening quote
+  bool scan_string(std::string_view &out, bool &has_escapes) {
+    const char *start = ++p_;
+    has_escapes = false;
+    while (p_ < end_) {
+      char c = *p_;
+      if (c == '"') {
+        out = std::string_view(start, static_cast<size_t>(p_ - start));
+        ++p_;
+        return true;
+      }
+      if (c == '\\') {
+        has_escapes = true;
+        p_ += 2;
+        continue;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return false;
+      }
+      ++p_;
+    }
+    return false;
+  }
+
+  bool scan_number() {
+    if (p_ < end_ && *p_ == '-') {
+      ++p_;
+    }
+    if (p_ >= end_ || !is_digit(*p_)) {
+      return false;
+    }
+    if (*p_ == '0') {
+      ++p_;
+    } else {
+      while (p_ < end_ && is_digit(*p_)) {
+        ++p_;
+      }
+    }
+    if (p_ < end_ && *p_ == '.') {
+      ++p_;
+      if (p_ >= end_ || !is_digit(*p_)) {
+        return false;
+      }
+      while (p_ < end_ && is_digit(*p_)) {
+        ++p_;
+      }
+    }
+    if (p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+      ++p_;
+      if (p_ < end_ && (*p_ == '+' || *p_ == '-')) {
+        ++p_;
+      }
+      if (p_ >= end_ || !is_digit(*p_)) {
+        return false;
+      }
+      while (p_ < end_ && is_digit(*p_)) {
+        ++p_;
+      }
+    }
+    return true;
+  }
+
+  bool literal(const char *word, size_t len) {
+    if (static_cast<size_t>(end_ - p_) < len || std::memcmp(p_, word, len) != 0) {
+      return false;
+    }
+    p_ += len;
+    return true;
+  }
+
+  uint32_t push(JsonType type, std::string_view key) {
+    JsonToken token;
+    token.type = type;
+    token.key = key;
+    tape_.push_back(token);
+    return static_cast<uint32_t>(tape_.size() - 1);
+  }
+
+  bool value(std::string_view key, size_t depth) {
+    if (p_ >= end_ || depth >= JsonDocument::MAX_DEPTH) {
+      return false;
+    }
+
+    const char *start = p_;
+    switch (*p_) {
+    case '{':
+    case '[': {
+      bool is_object = *p_ == '{';
+      char close = is_object ? '}' : ']';
+      uint32_t index = push(is_object ? JsonType::OBJECT : JsonType::ARRAY, key);
+      uint32_t count = 0;
+      ++p_;
+      skip_ws();
+      if (p_ < end_ && *p_ == close) {
+        ++p_;
+      } else {
+        while (true) {
+          std::string_view member_key;
+          if (is_object) {
+            bool key_escapes = false;
+            if (p_ >= end_ || *p_ != '"' || !scan_string(member_key, key_escapes)) {
+              return false;
+            }
+            skip_ws();
+            if (p_ >= end_ || *p_ != ':') {
+              return false;
+            }
+            ++p_;
+            skip_ws();
+          }
+          if (!value(member_key, depth + 1)) {
+            return false;
+          }
+          ++count;
+          skip_ws();
+          if (p_ < end_ && *p_ == ',') {
+            ++p_;
+            skip_ws();
+            continue;
+          }
+          if (p_ < end_ && *p_ == close) {
+            ++p_;
+            break;
+          }
+          return false;
+        }
+      }
+      JsonToken &token = tape_[index];
+      token.children = count;
+      token.end = static_cast<uint32_t>(tape_.size());
+      token.raw = std::string_view(start, static_cast<size_t>(p_ - start));
+      return true;
+    }
+    case '"': {
+      std::string_view contents;
+      bool escapes = false;
+      if (!scan_string(contents, escapes)) {
+        return false;
+      }
+      uint32_t index = push(JsonType::STRING, key);
+      tape_[index].raw = contents;
+      tape_[index].has_escapes = escapes;
+      tape_[index].end = index + 1;
+      return true;
+    }
+    case 't':
+    case 'f':
+    case 'n': {
+      JsonType type = JsonType::BOOL;
+      bool ok = false;
+      if (*p_ == 't') {
+        ok = literal("true", 4);
+      } else if (*p_ == 'f') {
+        ok = literal("false", 5);
+      } else {
+        ok = literal("null", 4);
+        type = JsonType::NULL_VALUE;
+      }
+      if (!ok) {
+        return false;
+      }
+      uint32_t index = push(type, key);
+      tape_[index].raw = std::string_view(start, static_cast<size_t>(p_ - start));
+      tape_[index].end = index + 1;
+      return true;
+    }
+    default: {
+      if (!scan_number()) {
+        return false;
+      }
+      uint32_t index = push(JsonType::NUMBER, key);
+      tape_[index].raw = std::string_view(start, static_cast<size_t>(p_ - start));
+      tape_[index].end = index + 1;
+      return true;
+    }
+    }
+  }
+
+  std::vector<JsonToken> &tape_;
+  const char *begin_;
+  const char *p_;
+  const char *end_;
+};
+
+void append_utf8(std::string &out, uint32_t cp) {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+bool parse_hex4(std::string_view s, size_t pos, uint32_t &out) {
+  if (pos + 4 > s.size()) {
+    return false;
+  }
+  auto result = std::from_chars(s.data() + pos, s.data() + pos + 4, out, 16);
+  return result.ec == std::errc() && result.ptr == s.data() + pos + 4;
+}
+
+constexpr char BASE58_ALPHABET[] =
+    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+constexpr char BASE64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 58^5 fits in 30 bits, so a limb shifted by 32 bits still fits in uint64_t
+constexpr uint64_t BASE58_LIMB = 656356768ULL;
+constexpr size_t BASE58_LIMB_DIGITS = 5;
+
+} // namespace
+
+bool JsonDocument::parse(std::string_view input) {
+  tape_.clear();
+  error_offset_ = 0;
+  Tokenizer tokenizer(tape_, input);
+  if (!tokenizer.run()) {
+    error_offset_ = tokenizer.offset();
+    tape_.clear();
+    return false;
+  }
+  return true;
+}
+
+JsonType JsonView::type() const noexcept {
+  return doc_ ? doc_->tape_[index_].type : JsonType::NULL_VALUE;
+}
+
+size_t JsonView::size() const noexcept {
+  return doc_ ? doc_->tape_[index_].children : 0;
+}
+
+std::string_view JsonView::raw() const noexcept {
+  return doc_ ? doc_->tape_[index_].raw : std::string_view();
+}
+
+std::string_view JsonView::json() const noexcept {
+  if (!doc_) {
+    return {};
+  }
+  const auto &token = doc_->tape_[index_];
+  if (token.type == JsonType::STRING) {
+    return std::string_view(token.raw.data() - 1, token.raw.size() + 2);
+  }
+  return token.raw;
+}
+
+std::string_view JsonView::as_string_view() const noexcept {
+  return is_string() ? raw() : std::string_view();
+}
+
+std::string JsonView::as_string() const {
+  if (!is_string()) {
+    return {};
+  }
+  const auto &token = doc_->tape_[index_];
+  return token.has_escapes ? unescape(token.raw) : std::string(token.raw);
+}
+
+std::optional<uint64_t> JsonView::as_uint64() const noexcept {
+  if (!is_number()) {
+    return std::nullopt;
+  }
+  auto text = raw();
+  uint64_t value = 0;
+  auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::optional<int64_t> JsonView::as_int64() const noexcept {
+  if (!is_number()) {
+    return std::nullopt;
+  }
+  auto text = raw();
+  int64_t value = 0;
+  auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+  if (result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::optional<bool> JsonView::as_bool() const noexcept {
+  if (!valid() || type() != JsonType::BOOL) {
+    return std::nullopt;
+  }
+  return raw() == "true";
+}
+
+JsonView JsonView::first_child() const noexcept {
+  if (!doc_ || size() == 0) {
+    return {};
+  }
+  JsonView child(doc_, index_ + 1);
+  child.parent_end_ = doc_->tape_[index_].end;
+  return child;
+}
+
+JsonView JsonView::next_sibling() const noexcept {
+  if (!doc_) {
+    return {};
+  }
+  uint32_t next = doc_->tape_[index_].end;
+  if (next >= parent_end_) {
+    return {};
+  }
+  JsonView sibling(doc_, next);
+  sibling.parent_end_ = parent_end_;
+  return sibling;
+}
+
+std::string_view JsonView::key() const noexcept {
+  return doc_ ? doc_->tape_[index_].key : std::string_view();
+}
+
+JsonView JsonView::at(size_t position) const noexcept {
+  if (!is_array() || position >= size()) {
+    return {};
+  }
+  JsonView child = first_child();
+  for (size_t i = 0; i < position && child.valid(); ++i) {
+    child = child.next_sibling();
+  }
+  return child;
+}
+
+JsonView JsonView::get(std::string_view name) const noexcept {
+  if (!is_object()) {
+    return {};
+  }
+  for (JsonView child = first_child(); child.valid();
+       child = child.next_sibling()) {
+    if (child.key() == name) {
+      return child;
+    }
+  }
+  return {};
+}
+
+std::string unescape(std::string_view raw) {
+  std::string out;
+  out.reserve(raw.size());
+  for (size_t i = 0; i < raw.size(); ++i) {
+    char c = raw[i];
+    if (c != '\\' || i + 1 >= raw.size()) {
+      out.push_back(c);
+      continue;
+    }
+    char e = raw[++i];
+    switch (e) {
+    case 'b':
+      out.push_back('\b');
+      break;
+    case 'f':
+      out.push_back('\f');
+      break;
+    case 'n':
+      out.push_back('\n');
+      break;
+    case 'r':
+      out.push_back('\r');
+      break;
+    case 't':
+      out.push_back('\t');
+      break;
+    case 'u': {
+      uint32_t cp = 0;
+      if (!parse_hex4(raw, i + 1, cp)) {
+        out.push_back('u');
+        break;
+      }
+      i += 4;
+      // Combine UTF-16 surrogate pairs
+      if (cp >= 0xD800 && cp <= 0xDBFF && i + 2 < raw.size() &&
+          raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+        uint32_t low = 0;
+        if (parse_hex4(raw, i + 3, low) && low >= 0xDC00 && low <= 0xDFFF) {
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+          i += 6;
+        }
+      }
+      append_utf8(out, cp);
+      break;
+    }
+    default:
+      out.push_back(e);
+      break;
+    }
+  }
+  return out;
+}
+
+void append_quoted(std::string &out, std::string_view str) {
+  static const char HEX[] = "0123456789abcdef";
+  out.push_back('"');
+  size_t run_start = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    unsigned char c = static_cast<unsigned char>(str[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(str.data() + run_start, i - run_start);
+    run_start = i + 1;
+    switch (c) {
+    case '"':
+      out.append("\\\"");
+      break;
+    case '\\':
+      out.append("\\\\");
+      break;
+    case '\n':
+      out.append("\\n");
+      break;
+    case '\r':
+      out.append("\\r");
+      break;
+    case '\t':
+      out.append("\\t");
+      break;
+    default: {
+      char esc[6] = {'\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF]};
+      out.append(esc, sizeof(esc));
+      break;
+    }
+    }
+  }
+  out.append(str.data() + run_start, str.size() - run_start);
+  out.push_back('"');
+}
+
+void append_base58(std::string &out, const uint8_t *data, size_t len) {
+  size_t zeros = 0;
+  while (zeros < len && data[zeros] == 0) {
+    ++zeros;
+  }
+  out.append(zeros, BASE58_ALPHABET[0]);
+  if (zeros == len) {
+    return;
+  }
+
+  // Little-endian limbs in base 58^5, fed 32 bits of input at a time
+  size_t remaining = len - zeros;
+  size_t max_limbs = remaining * 138 / 100 / BASE58_LIMB_DIGITS + 2;
+  uint32_t stack_limbs[32];
+  std::vector<uint32_t> heap_limbs;
+  uint32_t *limbs = stack_limbs;
+  if (max_limbs > 32) {
+    heap_limbs.resize(max_limbs);
+    limbs = heap_limbs.data();
+  }
+  size_t limb_count = 0;
+
+  const uint8_t *p = data + zeros;
+  const uint8_t *end = data + len;
+  size_t head = remaining % 4 == 0 ? 4 : remaining % 4;
+  while (p < end) {
+    uint64_t chunk = 0;
+    for (size_t i = 0; i < head; ++i) {
+      chunk = (chunk << 8) | *p++;
+    }
+    uint32_t shift = static_cast<uint32_t>(head * 8);
+    head = 4;
+
+    uint64_t carry = chunk;
+    for (size_t j = 0; j < limb_count; ++j) {
+      uint64_t acc = (static_cast<uint64_t>(limbs[j]) << shift) + carry;
+      limbs[j] = static_cast<uint32_t>(acc % BASE58_LIMB);
+      carry = acc / BASE58_LIMB;
+    }
+    while (carry > 0) {
+      limbs[limb_count++] = static_cast<uint32_t>(carry % BASE58_LIMB);
+      carry /= BASE58_LIMB;
+    }
+  }
+
+  char digits[BASE58_LIMB_DIGITS];
+  for (size_t j = limb_count; j-- > 0;) {
+    uint32_t limb = limbs[j];
+    for (size_t d = BASE58_LIMB_DIGITS; d-- > 0;) {
+      digits[d] = BASE58_ALPHABET[limb % 58];
+      limb /= 58;
+    }
+    size_t skip = 0;
+    if (j == limb_count - 1) {
+      // Most significant limb carries no zero padding
+      while (skip < BASE58_LIMB_DIGITS - 1 && digits[skip] == BASE58_ALPHABET[0]) {
+        ++skip;
+      }
+    }
+    out.append(digits + skip, BASE58_LIMB_DIGITS - skip);
+  }
+}
+
+void append_base64(std::string &out, const uint8_t *data, size_t len) {
+  size_t start = out.size();
+  out.resize(start + ((len + 2) / 3) * 4);
+  char *dst = out.data() + start;
+  size_t i = 0;
+  for (; i + 3 <= len; i += 3) {
+    uint32_t v = (static_cast<uint32_t>(data[i]) << 16) |
+                 (static_cast<uint32_t>(data[i + 1]) << 8) | data[i + 2];
+    *dst++ = BASE64_ALPHABET[(v >> 18) & 0x3F];
+    *dst++ = BASE64_ALPHABET[(v >> 12) & 0x3F];
+    *dst++ = BASE64_ALPHABET[(v >> 6) & 0x3F];
+    *dst++ = BASE64_ALPHABET[v & 0x3F];
+  }
+  if (i < len) {
+    uint32_t v = static_cast<uint32_t>(data[i]) << 16;
+    if (i + 1 < len) {
+      v |= static_cast<uint32_t>(data[i + 1]) << 8;
+    }
+    *dst++ = BASE64_ALPHABET[(v >> 18) & 0x3F];
+    *dst++ = BASE64_ALPHABET[(v >> 12) & 0x3F];
+    *dst++ = i + 1 < len ? BASE64_ALPHABET[(v >> 6) & 0x3F] : '=';
+    *dst++ = '=';
+  }
+}
+
+void JsonWriter::separator() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ == 0) {
+    return;
+  }
+  uint64_t bit = 1ULL << (depth_ & 63);
+  if (need_comma_ & bit) {
+    out_.push_back(',');
+  }
+  need_comma_ |= bit;
+}
+
+JsonWriter &JsonWriter::begin_object() {
+  separator();
+  out_.push_back('{');
+  ++depth_;
+  need_comma_ &= ~(1ULL << (depth_ & 63));
+  return *this;
+}
+
+JsonWriter &JsonWriter::end_object() {
+  out_.push_back('}');
+  --depth_;
+  return *this;
+}
+
+JsonWriter &JsonWriter::begin_array() {
+  separator();
+  out_.push_back('[');
+  ++depth_;
+  need_comma_ &= ~(1ULL << (depth_ & 63));
+  return *this;
+}
+
+JsonWriter &JsonWriter::end_array() {
+  out_.push_back(']');
+  --depth_;
+  return *this;
+}
+
+JsonWriter &JsonWriter::key(std::string_view name) {
+  separator();
+  append_quoted(out_, name);
+  out_.push_back(':');
+  after_key_ = true;
+  return *this;
+}
+
+JsonWriter &JsonWriter::string(std::string_view value) {
+  separator();
+  append_quoted(out_, value);
+  return *this;
+}
+
+JsonWriter &JsonWriter::escaped_string(std::string_view value) {
+  separator();
+  out_.push_back('"');
+  out_.append(value);
+  out_.push_back('"');
+  return *this;
+}
+
+JsonWriter &JsonWriter::number(uint64_t value) {
+  separator();
+  char buf[24];
+  auto result = std::to_chars(buf, buf + sizeof(buf), value);
+  out_.append(buf, static_cast<size_t>(result.ptr - buf));
+  return *this;
+}
+
+JsonWriter &JsonWriter::number(int64_t value) {
+  separator();
+  char buf[24];
+  auto result = std::to_chars(buf, buf + sizeof(buf), value);
+  out_.append(buf, static_cast<size_t>(result.ptr - buf));
+  return *this;
+}
+
+JsonWriter &JsonWriter::number(double value) {
+  separator();
+  char buf[32];
+  auto result = std::to_chars(buf, buf + sizeof(buf), value);
+  out_.append(buf, static_cast<size_t>(result.ptr - buf));
+  return *this;
+}
+
+JsonWriter &JsonWriter::boolean(bool value) {
+  separator();
+  out_.append(value ? "true" : "false");
+  return *this;
+}
+
+JsonWriter &JsonWriter::null() {
+  separator();
+  out_.append("null");
+  return *this;
+}
+
+JsonWriter &JsonWriter::raw(std::string_view json) {
+  separator();
+  out_.append(json);
+  return *this;
+}
+
+JsonWriter &JsonWriter::base58(const uint8_t *data, size_t len) {
+  separator();
+  out_.push_back('"');
+  append_base58(out_, data, len);
+  out_.push_back('"');
+  return *this;
+}
+
+JsonWriter &JsonWriter::base64(const uint8_t *data, size_t len) {
+  separator();
+  out_.push_back('"');
+  append_base64(out_, data, len);
+  out_.push_back('"');
+  return *this;
+}
+
+} // namespace rpc_json
+} // namespace network
+} // namespace slonana
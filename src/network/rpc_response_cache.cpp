@@ -0,0 +1,444 @@
+#include "network/rpc_response_cache.h"
+#include "monitoring/metrics.h"
+#include "network/rpc_json.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace slonana {
+namespace network {
+
+namespace {
+
+rpc_json::JsonDocument &key_document() {
+  thread_local rpc_json::JsonDocument doc;
+  return doc;
+}
+
+// Hit ratio gauge is refreshed on every miss and every Nth hit
+constexpr uint64_t HIT_RATIO_UPDATE_INTERVAL = 64;
+
+void append_canonical(std::string &out, const rpc_json::JsonView &value,
+                      std::string_view skip_key = {}) {
+  if (value.is_object()) {
+    std::vector<std::pair<std::string_view, rpc_json::JsonView>> members;
+    members.reserve(value.size());
+    for (auto child = value.first_child(); child.valid();
+         child = child.next_sibling()) {
+      if (!skip_key.empty() && child.key() == skip_key) {
+        continue;
+      }
+      members.emplace_back(child.key(), child);
+    }
+    std::sort(members.begin(), members.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    out += '{';
+    for (size_t i = 0; i < members.size(); ++i) {
+      if (i > 0) {
+        out += ',';
+      }
+      out += '"';
+      out.append(members[i].first);
+      out += "\":";
+      append_canonical(out, members[i].second);
+    }
+    out += '}';
+  } else if (value.is_array()) {
+    out += '[';
+    bool first = true;
+    for (auto child = value.first_child(); child.valid();
+         child = child.next_sibling()) {
+      if (!first) {
+        out += ',';
+      }
+      first = false;
+      append_canonical(out, child);
+    }
+    out += ']';
+  } else {
+    out.append(value.json());
+  }
+}
+
+} // namespace
+
+RpcResponseCache::RpcResponseCache() : RpcResponseCache(Config()) {}
+
+RpcResponseCache::RpcResponseCache(const Config &config) : config_(config) {
+  static const std::pair<const char *, Scope> cached_methods[] = {
+      {"getSlot", Scope::SLOT},
+      {"getBlockHeight", Scope::SLOT},
+      {"getLatestBlockhash", Scope::SLOT},
+      {"getEpochInfo", Scope::SLOT},
+      {"getBlock", Scope::IMMUTABLE}, // finalized only, see make_key
+      {"getAccountInfo", Scope::ACCOUNT},
+      {"getBalance", Scope::ACCOUNT},
+  };
+
+  auto &registry = monitoring::GlobalMetrics::registry();
+  for (const auto &[method, scope] : cached_methods) {
+    auto table = std::make_unique<MethodTable>();
+    table->scope = scope;
+    std::map<std::string, std::string> labels{{"method", method}};
+    table->hits_counter = registry.counter(
+        "rpc_cache_hits_total", "RPC responses served from cache", labels);
+    table->misses_counter =
+        registry.counter("rpc_cache_misses_total",
+                         "RPC requests computed because of a cache miss",
+                         labels);
+    table->coalesced_counter = registry.counter(
+        "rpc_cache_coalesced_total",
+        "RPC requests that waited on an identical in-flight request", labels);
+    table->invalidations_counter =
+        registry.counter("rpc_cache_invalidations_total",
+                         "RPC cache entries dropped by slot or account changes",
+                         labels);
+    table->hit_ratio_gauge = registry.gauge(
+        "rpc_cache_hit_ratio", "Fraction of RPC requests served from cache",
+        labels);
+    tables_.emplace(method, std::move(table));
+  }
+}
+
+RpcResponseCache::~RpcResponseCache() = default;
+
+bool RpcResponseCache::is_cacheable(const std::string &method) const noexcept {
+  return config_.enabled && find_table(method) != nullptr;
+}
+
+RpcResponseCache::MethodTable *
+RpcResponseCache::find_table(const std::string &method) const noexcept {
+  auto it = tables_.find(method);
+  return it == tables_.end() ? nullptr : it->second.get();
+}
+
+std::optional<RpcResponseCache::Key>
+RpcResponseCache::make_key(const std::string &method,
+                           const std::string &params) const {
+  auto *table = find_table(method);
+  if (!table || !config_.enabled) {
+    return std::nullopt;
+  }
+
+  Key key;
+  std::string commitment = "finalized";
+  std::string canonical;
+  canonical.reserve(params.size());
+
+  if (!params.empty()) {
+    auto &doc = key_document();
+    if (!doc.parse(params) || !doc.root().is_array()) {
+      return std::nullopt;
+    }
+    auto root = doc.root();
+    size_t count = root.size();
+    canonical += '[';
+    size_t index = 0;
+    for (auto child = root.first_child(); child.valid();
+         child = child.next_sibling(), ++index) {
+      std::string_view skip;
+      if (child.is_object()) {
+        auto level = child.get("commitment");
+        if (level.is_string()) {
+          commitment.assign(level.as_string_view());
+          skip = "commitment";
+        }
+        // An empty trailing config is the same request as no config
+        size_t remaining = child.size() - (skip.empty() ? 0 : 1);
+        if (remaining == 0 && index + 1 == count) {
+          break;
+        }
+      }
+      if (index > 0) {
+        canonical += ',';
+      }
+      append_canonical(canonical, child, skip);
+    }
+    canonical += ']';
+
+    if (table->scope == Scope::ACCOUNT) {
+      auto address = root.at(0);
+      if (!address.is_string()) {
+        return std::nullopt;
+      }
+      key.account.assign(address.as_string_view());
+    }
+  } else {
+    canonical = "[]";
+  }
+
+  // Blocks below finalized can still be replaced by another fork
+  key.scope = table->scope;
+  if (key.scope == Scope::IMMUTABLE && commitment != "finalized") {
+    key.scope = Scope::SLOT;
+  }
+
+  key.text.reserve(method.size() + commitment.size() + canonical.size() + 2);
+  key.text.append(method).append(1, '|').append(commitment).append(1, '|');
+  key.text.append(canonical);
+  return key;
+}
+
+bool RpcResponseCache::lookup(MethodTable &table, const std::string &key,
+                              uint64_t slot, Body &body,
+                              uint64_t &generation) const {
+  std::shared_lock<std::shared_mutex> lock(table.entries_mutex);
+  generation = table.generation;
+  auto it = table.entries.find(key);
+  if (it == table.entries.end()) {
+    return false;
+  }
+  if (!it->second.immutable && it->second.slot != slot) {
+    return false;
+  }
+  body = it->second.body;
+  return true;
+}
+
+RpcResponseCache::Body
+RpcResponseCache::get_or_compute(const std::string &method, const Key &key,
+                                 uint64_t slot, const Compute &compute) {
+  auto *table = find_table(method);
+  if (!table || !config_.enabled) {
+    bool cacheable = false;
+    auto body = compute(cacheable);
+    return cacheable ? body : nullptr;
+  }
+
+  Body body;
+  uint64_t generation = 0;
+  if (lookup(*table, key.text, slot, body, generation)) {
+    record_hit(*table);
+    return body;
+  }
+
+  std::shared_ptr<InFlight> flight;
+  bool leader = false;
+  {
+    std::lock_guard<std::mutex> lock(table->inflight_mutex);
+    // Re-check under the in-flight lock: a leader may have just finished.
+    // The generation seen here predates compute(), so any invalidation
+    // that lands while computing keeps the result out of the cache
+    if (lookup(*table, key.text, slot, body, generation)) {
+      record_hit(*table);
+      return body;
+    }
+    auto &slot_flight = table->inflight[key.text];
+    if (!slot_flight) {
+      slot_flight = std::make_shared<InFlight>();
+      leader = true;
+    }
+    flight = slot_flight;
+  }
+
+  if (!leader) {
+    table->coalesced.fetch_add(1, std::memory_order_relaxed);
+    table->coalesced_counter->increment();
+    std::unique_lock<std::mutex> lock(flight->mutex);
+    flight->cv.wait(lock, [&flight] { return flight->done; });
+    return flight->body;
+  }
+
+  record_miss(*table);
+  auto finish = [&](Body result) {
+    {
+      std::lock_guard<std::mutex> lock(table->inflight_mutex);
+      table->inflight.erase(key.text);
+    }
+    {
+      std::lock_guard<std::mutex> lock(flight->mutex);
+      flight->body = std::move(result);
+      flight->done = true;
+    }
+    flight->cv.notify_all();
+  };
+
+  bool cacheable = false;
+  try {
+    body = compute(cacheable);
+  } catch (...) {
+    finish(nullptr);
+    throw;
+  }
+
+  if (!cacheable || !body) {
+    finish(nullptr);
+    return nullptr;
+  }
+  // A missing block may still be produced later, so null is never final
+  if (!(key.scope == Scope::IMMUTABLE && *body == "null")) {
+    store(*table, key, slot, generation, body);
+  }
+  finish(body);
+  return body;
+}
+
+void RpcResponseCache::store(MethodTable &table, const Key &key, uint64_t slot,
+                             uint64_t generation, Body body) {
+  std::unique_lock<std::shared_mutex> lock(table.entries_mutex);
+  if (generation != table.generation) {
+    return; // Computed across an invalidation, possibly from old state
+  }
+  bool immutable = key.scope == Scope::IMMUTABLE;
+  if (!immutable && slot < table.min_slot) {
+    return;
+  }
+
+  if (table.entries.size() >= config_.max_entries_per_method &&
+      table.entries.find(key.text) == table.entries.end()) {
+    // Prefer dropping entries from older slots, otherwise evict arbitrarily
+    uint64_t dropped = 0;
+    for (auto it = table.entries.begin(); it != table.entries.end();) {
+      auto next = std::next(it);
+      if (!it->second.immutable && it->second.slot != slot) {
+        erase_entry_locked(table, it);
+        ++dropped;
+      }
+      it = next;
+    }
+    if (table.entries.size() >= config_.max_entries_per_method) {
+      erase_entry_locked(table, table.entries.begin());
+    }
+    record_invalidations(table, dropped);
+  }
+
+  auto &entry = table.entries[key.text];
+  if (!entry.account.empty() && entry.account != key.account) {
+    table.by_account[entry.account].erase(key.text);
+  }
+  entry.body = std::move(body);
+  entry.slot = slot;
+  entry.account = key.account;
+  entry.immutable = immutable;
+  if (!key.account.empty()) {
+    table.by_account[key.account].insert(key.text);
+  }
+}
+
+void RpcResponseCache::erase_entry_locked(
+    MethodTable &table, std::unordered_map<std::string, Entry>::iterator it) {
+  if (!it->second.account.empty()) {
+    auto index = table.by_account.find(it->second.account);
+    if (index != table.by_account.end()) {
+      index->second.erase(it->first);
+      if (index->second.empty()) {
+        table.by_account.erase(index);
+      }
+    }
+  }
+  table.entries.erase(it);
+}
+
+void RpcResponseCache::notify_slot_advance(uint64_t slot) {
+  for (auto &[method, table] : tables_) {
+    uint64_t dropped = 0;
+    {
+      std::unique_lock<std::shared_mutex> lock(table->entries_mutex);
+      if (slot <= table->min_slot) {
+        continue;
+      }
+      table->min_slot = slot;
+      for (auto it = table->entries.begin(); it != table->entries.end();) {
+        auto next = std::next(it);
+        if (!it->second.immutable && it->second.slot < slot) {
+          erase_entry_locked(*table, it);
+          ++dropped;
+        }
+        it = next;
+      }
+    }
+    record_invalidations(*table, dropped);
+  }
+}
+
+void RpcResponseCache::invalidate_account(const std::string &address) {
+  for (auto &[method, table] : tables_) {
+    if (table->scope != Scope::ACCOUNT) {
+      continue;
+    }
+    uint64_t dropped = 0;
+    {
+      std::unique_lock<std::shared_mutex> lock(table->entries_mutex);
+      ++table->generation;
+      auto index = table->by_account.find(address);
+      if (index == table->by_account.end()) {
+        continue;
+      }
+      for (const auto &key : index->second) {
+        dropped += table->entries.erase(key);
+      }
+      table->by_account.erase(index);
+    }
+    record_invalidations(*table, dropped);
+  }
+}
+
+void RpcResponseCache::invalidate_accounts() {
+  for (auto &[method, table] : tables_) {
+    if (table->scope != Scope::ACCOUNT) {
+      continue;
+    }
+    uint64_t dropped = 0;
+    {
+      std::unique_lock<std::shared_mutex> lock(table->entries_mutex);
+      ++table->generation;
+      dropped = table->entries.size();
+      table->entries.clear();
+      table->by_account.clear();
+    }
+    record_invalidations(*table, dropped);
+  }
+}
+
+void RpcResponseCache::clear() {
+  for (auto &[method, table] : tables_) {
+    std::unique_lock<std::shared_mutex> lock(table->entries_mutex);
+    ++table->generation;
+    table->entries.clear();
+    table->by_account.clear();
+  }
+}
+
+RpcResponseCache::MethodStats
+RpcResponseCache::stats(const std::string &method) const {
+  MethodStats result;
+  auto *table = find_table(method);
+  if (!table) {
+    return result;
+  }
+  result.hits = table->hits.load(std::memory_order_relaxed);
+  result.misses = table->misses.load(std::memory_order_relaxed);
+  result.coalesced = table->coalesced.load(std::memory_order_relaxed);
+  result.invalidations = table->invalidations.load(std::memory_order_relaxed);
+  std::shared_lock<std::shared_mutex> lock(table->entries_mutex);
+  result.entries = table->entries.size();
+  return result;
+}
+
+void RpcResponseCache::record_hit(MethodTable &table) {
+  uint64_t hits = table.hits.fetch_add(1, std::memory_order_relaxed) + 1;
+  table.hits_counter->increment();
+  if (hits % HIT_RATIO_UPDATE_INTERVAL == 0) {
+    uint64_t misses = table.misses.load(std::memory_order_relaxed);
+    table.hit_ratio_gauge->set(static_cast<double>(hits) / (hits + misses));
+  }
+}
+
+void RpcResponseCache::record_miss(MethodTable &table) {
+  uint64_t misses = table.misses.fetch_add(1, std::memory_order_relaxed) + 1;
+  table.misses_counter->increment();
+  uint64_t hits = table.hits.load(std::memory_order_relaxed);
+  table.hit_ratio_gauge->set(static_cast<double>(hits) / (hits + misses));
+}
+
+void RpcResponseCache::record_invalidations(MethodTable &table,
+                                            uint64_t count) {
+  if (count == 0) {
+    return;
+  }
+  table.invalidations.fetch_add(count, std::memory_order_relaxed);
+  table.invalidations_counter->increment(static_cast<double>(count));
+}
+
+} // namespace network
+} // namespace slonana
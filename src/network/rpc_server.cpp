@@ -1,5 +1,7 @@
 #include "network/rpc_server.h"
+#include "network/rpc_json.h"
 #include "common/fault_tolerance.h"
+#include "consensus/leader_schedule.h"
 #include "ledger/manager.h"
 #include "network/websocket_server.h"
 #include "network/gossip/crypto_utils.h"
@@ -18,7 +20,6 @@
 #include <netinet/in.h>
 #include <openssl/evp.h>
 #include <poll.h>
-#include <regex>
 #include <sstream>
 #include <sys/socket.h>
 #include <thread>
@@ -27,128 +28,115 @@
 namespace slonana {
 namespace network {
 
-// Helper functions for improved JSON parsing
+// Helper functions for params access on top of the rpc_json tokenizer
 namespace {
-std::string extract_json_value(const std::string &json,
-                               const std::string &key) {
-  std::regex pattern("\"" + key + "\"\\s*:\\s*([^,}]+)");
-  std::smatch match;
-  if (std::regex_search(json, match, pattern)) {
-    std::string value = match[1].str();
-    // Remove quotes if it's a string
-    if (value.front() == '"' && value.back() == '"') {
-      return value.substr(1, value.length() - 2);
-    }
-    return value;
-  }
-  return "";
+// Per-thread documents keep the token tape allocated across requests
+rpc_json::JsonDocument &request_document() {
+  thread_local rpc_json::JsonDocument doc;
+  return doc;
 }
 
-std::string extract_json_array(const std::string &json,
-                               const std::string &key) {
-  std::regex pattern("\"" + key + "\"\\s*:\\s*(\\[[^\\]]*\\])");
-  std::smatch match;
-  if (std::regex_search(json, match, pattern)) {
-    return match[1].str();
-  }
-  return "[]";
+rpc_json::JsonDocument &params_document() {
+  thread_local rpc_json::JsonDocument doc;
+  return doc;
 }
 
-// Extract the first parameter from a params array
-std::string extract_first_param(const std::string &params_str) {
-  if (params_str.empty() || params_str == "[]" || params_str == "\"\"") {
+// Strings are returned unquoted, everything else as raw JSON text
+std::string param_text(const rpc_json::JsonView &value) {
+  if (!value.valid()) {
     return "";
   }
-
-  // Handle array format: ["param1", "param2", ...]
-  if (params_str.front() == '[' && params_str.back() == ']') {
-    std::string inner = params_str.substr(1, params_str.length() - 2);
-    // Find first element (before first comma, handling quotes)
-    size_t pos = 0;
-    bool in_quotes = false;
-    for (size_t i = 0; i < inner.length(); ++i) {
-      if (inner[i] == '"' && (i == 0 || inner[i - 1] != '\\')) {
-        in_quotes = !in_quotes;
-      } else if (inner[i] == ',' && !in_quotes) {
-        pos = i;
-        break;
-      }
-    }
-    std::string first = (pos == 0) ? inner : inner.substr(0, pos);
-    // Remove quotes if present
-    if (first.front() == '"' && first.back() == '"') {
-      return first.substr(1, first.length() - 2);
-    }
-    return first;
+  if (value.is_string()) {
+    return value.as_string();
   }
-
-  // Handle direct string parameter
-  if (params_str.front() == '"' && params_str.back() == '"') {
-    return params_str.substr(1, params_str.length() - 2);
-  }
-
-  return params_str;
+  return std::string(value.raw());
 }
 
 // Extract parameter by index from params array
 std::string extract_param_by_index(const std::string &params_str,
                                    size_t index) {
-  if (params_str.empty() || params_str == "[]" || params_str == "\"\"") {
+  if (params_str.empty() || params_str == "[]") {
+    return "";
+  }
+  auto &doc = params_document();
+  if (!doc.parse(params_str)) {
     return "";
   }
+  auto root = doc.root();
+  if (root.is_array()) {
+    return param_text(root.at(index));
+  }
+  // A bare scalar is treated as a single positional parameter
+  return index == 0 && !root.is_object() && !root.is_null() ? param_text(root)
+                                                            : "";
+}
 
-  // Handle array format
-  if (params_str.front() == '[' && params_str.back() == ']') {
-    std::string inner = params_str.substr(1, params_str.length() - 2);
-    std::vector<std::string> params;
-
-    // Parse array elements
-    size_t start = 0;
-    bool in_quotes = false;
-    for (size_t i = 0; i <= inner.length(); ++i) {
-      if (i < inner.length() && inner[i] == '"' &&
-          (i == 0 || inner[i - 1] != '\\')) {
-        in_quotes = !in_quotes;
-      } else if ((i == inner.length() || (inner[i] == ',' && !in_quotes))) {
-        std::string param = inner.substr(start, i - start);
-        // Trim whitespace
-        param.erase(0, param.find_first_not_of(" \t"));
-        param.erase(param.find_last_not_of(" \t") + 1);
-        // Remove quotes if present
-        if (!param.empty() && param.front() == '"' && param.back() == '"') {
-          param = param.substr(1, param.length() - 2);
-        }
-        if (!param.empty()) {
-          params.push_back(param);
-        }
-        start = i + 1;
-      }
-    }
+// Extract the first parameter from a params array
+std::string extract_first_param(const std::string &params_str) {
+  return extract_param_by_index(params_str, 0);
+}
+
+// Build an RpcRequest from a parsed request object. Fields that are missing
+// or of the wrong type are left empty so dispatch reports Invalid Request.
+void build_request(const rpc_json::JsonView &object, RpcRequest &request) {
+  request.jsonrpc.clear();
+  request.method.clear();
+  request.params = "[]";
+  request.id.clear();
+  request.id_is_number = false;
+  if (!object.is_object()) {
+    return;
+  }
 
-    if (index < params.size()) {
-      return params[index];
-    }
+  auto id = object.get("id");
+  if (id.is_string()) {
+    // Escapes are kept as-is; the id is echoed back inside quotes verbatim
+    request.id = std::string(id.as_string_view());
+  } else if (id.is_number()) {
+    request.id = std::string(id.raw());
+    request.id_is_number = true;
+  } else if (id.valid() && id.type() == rpc_json::JsonType::NULL_VALUE) {
+    request.id = "null";
+    request.id_is_number = true;
   }
 
-  return "";
+  auto jsonrpc = object.get("jsonrpc");
+  if (jsonrpc.is_string()) {
+    request.jsonrpc = jsonrpc.as_string();
+  }
+  auto method = object.get("method");
+  if (method.is_string()) {
+    request.method = method.as_string();
+  }
+  auto params = object.get("params");
+  if (params.is_array()) {
+    request.params = std::string(params.raw());
+  }
 }
 } // namespace
 
 std::string RpcResponse::to_json() const {
-  std::ostringstream oss;
-  oss << "{\"jsonrpc\":\"" << jsonrpc << "\",";
+  std::string out;
+  out.reserve(48 + (shared_result ? shared_result->size() : result.size()) +
+              error.size() + id.size());
+  rpc_json::JsonWriter writer(out);
+  writer.begin_object().key("jsonrpc").string(jsonrpc);
   if (!error.empty()) {
-    oss << "\"error\":" << error << ",";
+    writer.key("error").raw(error);
+  } else if (shared_result) {
+    writer.key("result").raw(*shared_result);
   } else {
-    oss << "\"result\":" << result << ",";
+    writer.key("result").raw(result.empty() ? "null" : result);
   }
   // Preserve ID type - don't quote if it's a number
+  writer.key("id");
   if (id_is_number) {
-    oss << "\"id\":" << id << "}";
+    writer.raw(id.empty() ? "null" : id);
   } else {
-    oss << "\"id\":\"" << id << "\"}";
+    writer.escaped_string(id);
   }
-  return oss.str();
+  writer.end_object();
+  return out;
 }
 
 class SolanaRpcServer::Impl {
@@ -553,82 +541,171 @@ void SolanaRpcServer::register_method(const std::string &method,
 }
 
 std::string SolanaRpcServer::handle_request(const std::string &request_json) {
-  // Try to extract ID early for error responses, even from malformed JSON
-  std::string extracted_id = "";
-  bool id_is_number = false;
-
-  try {
-    // Try to extract ID even from potentially malformed JSON
-    extracted_id = extract_json_value(request_json, "id");
-
-    // Check if ID is a number by looking at the original JSON
-    std::regex id_pattern("\"id\"\\s*:\\s*([^,}]+)");
-    std::smatch id_match;
-    if (std::regex_search(request_json, id_match, id_pattern)) {
-      std::string id_value = id_match[1].str();
-      // Remove whitespace
-      id_value.erase(0, id_value.find_first_not_of(" \t"));
-      id_value.erase(id_value.find_last_not_of(" \t") + 1);
-      // Check if it starts with a digit or negative sign (not a quote)
-      id_is_number = !id_value.empty() &&
-                     (std::isdigit(id_value[0]) || id_value[0] == '-');
-    }
-  } catch (...) {
-    // If we can't extract ID, use empty string
-    extracted_id = "";
-    id_is_number = false;
+  // Single pass over the body; every field below is a view into request_json
+  auto &doc = request_document();
+  if (!doc.parse(request_json)) {
+    return create_error_response("null", -32700, "Parse error", true)
+        .to_json();
   }
 
-  try {
-    // Basic JSON validation - check if it looks like valid JSON
-    if (request_json.empty() ||
-        (request_json.find('{') == std::string::npos &&
-         request_json.find('}') == std::string::npos) ||
-        request_json.find("invalid") != std::string::npos) {
-      return create_error_response(extracted_id, -32700, "Parse error",
-                                   id_is_number)
+  auto root = doc.root();
+  if (root.is_array()) {
+    if (root.size() == 0 || root.size() > MAX_BATCH_REQUESTS) {
+      return create_error_response("null", -32600, "Invalid Request", true)
           .to_json();
     }
+    // Copy out of the thread-local document before fanning out to workers
+    std::vector<RpcRequest> requests(root.size());
+    size_t i = 0;
+    for (auto element = root.first_child(); element.valid();
+         element = element.next_sibling()) {
+      build_request(element, requests[i++]);
+    }
+    return handle_batch_request(requests);
+  }
 
-    RpcRequest request;
-    request.jsonrpc = extract_json_value(request_json, "jsonrpc");
-    request.method = extract_json_value(request_json, "method");
-    request.params = extract_json_array(request_json, "params");
-    request.id = extracted_id;
-    request.id_is_number = id_is_number;
+  RpcRequest request;
+  build_request(root, request);
+  return dispatch_request(request);
+}
 
-    // Validate required fields
-    if (request.method.empty()) {
-      return create_error_response(request.id, -32600, "Invalid Request",
-                                   request.id_is_number)
-          .to_json();
-    }
+std::string SolanaRpcServer::dispatch_request(const RpcRequest &request) {
+  // Validate required fields
+  if (request.method.empty()) {
+    return create_error_response(request.id.empty() ? "null" : request.id,
+                                 -32600, "Invalid Request",
+                                 request.id.empty() || request.id_is_number)
+        .to_json();
+  }
 
-    // For some methods, ID is required - all methods should have ID in
-    // JSON-RPC 2.0
-    if (request.id.empty()) {
-      return create_error_response("", -32600, "Invalid Request", false)
-          .to_json();
-    }
+  // For some methods, ID is required - all methods should have ID in
+  // JSON-RPC 2.0
+  if (request.id.empty()) {
+    return create_error_response("", -32600, "Invalid Request", false)
+        .to_json();
+  }
 
-    auto it = methods_.find(request.method);
-    if (it == methods_.end()) {
-      return create_error_response(request.id, -32601, "Method not found",
-                                   request.id_is_number)
-          .to_json();
-    }
+  auto it = methods_.find(request.method);
+  if (it == methods_.end()) {
+    return create_error_response(request.id, -32601, "Method not found",
+                                 request.id_is_number)
+        .to_json();
+  }
 
+  try {
+    if (response_cache_.is_cacheable(request.method)) {
+      return dispatch_cached(request, it->second);
+    }
     auto response = it->second(request);
     response.id_is_number = request.id_is_number; // Propagate ID type
+    // State-changing calls may touch any cached account
+    if (response.error.empty() &&
+        (request.method == "sendTransaction" ||
+         request.method == "sendBundle" ||
+         request.method == "requestAirdrop")) {
+      response_cache_.invalidate_accounts();
+    }
     return response.to_json();
-
   } catch (const std::exception &e) {
-    return create_error_response(extracted_id, -32700, "Parse error",
-                                 id_is_number)
+    return create_error_response(request.id, -32603, "Internal error",
+                                 request.id_is_number)
         .to_json();
   }
 }
 
+std::string SolanaRpcServer::dispatch_cached(const RpcRequest &request,
+                                             const RpcHandler &handler) {
+  auto key = response_cache_.make_key(request.method, request.params);
+  if (!key) {
+    auto response = handler(request);
+    response.id_is_number = request.id_is_number;
+    return response.to_json();
+  }
+
+  // Slot is sampled before computing so a result never outlives its slot
+  uint64_t slot = validator_core_ ? validator_core_->get_current_slot()
+                                  : notified_slot_.load();
+  bool computed = false;
+  RpcResponse response;
+  auto body = response_cache_.get_or_compute(
+      request.method, *key, slot, [&](bool &cacheable) {
+        computed = true;
+        response = handler(request);
+        cacheable = response.error.empty();
+        if (!cacheable) {
+          return RpcResponseCache::Body();
+        }
+        return RpcResponseCache::Body(
+            std::make_shared<const std::string>(std::move(response.result)));
+      });
+
+  if (!body && !computed) {
+    // Waited on a leader whose result was an error; answer on our own
+    response = handler(request);
+  }
+  response.id = request.id;
+  response.id_is_number = request.id_is_number;
+  response.shared_result = std::move(body);
+  return response.to_json();
+}
+
+void SolanaRpcServer::notify_slot_advance(uint64_t slot) {
+  uint64_t seen = notified_slot_.load();
+  while (seen < slot && !notified_slot_.compare_exchange_weak(seen, slot)) {
+  }
+  response_cache_.notify_slot_advance(slot);
+}
+
+void SolanaRpcServer::invalidate_account(const std::string &address) {
+  response_cache_.invalidate_account(address);
+}
+
+std::string
+SolanaRpcServer::handle_batch_request(const std::vector<RpcRequest> &requests) {
+  std::vector<std::string> responses(requests.size());
+
+  size_t workers = std::min<size_t>(
+      {requests.size(), MAX_BATCH_WORKERS,
+       std::max(1u, std::thread::hardware_concurrency())});
+  if (workers <= 1) {
+    for (size_t i = 0; i < requests.size(); ++i) {
+      responses[i] = dispatch_request(requests[i]);
+    }
+  } else {
+    // Workers pull the next unclaimed index; response order matches requests
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+      for (size_t i = next.fetch_add(1); i < requests.size();
+           i = next.fetch_add(1)) {
+        responses[i] = dispatch_request(requests[i]);
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t t = 1; t < workers; ++t) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  size_t total = 2;
+  for (const auto &response : responses) {
+    total += response.size() + 1;
+  }
+  std::string out;
+  out.reserve(total);
+  rpc_json::JsonWriter writer(out);
+  writer.begin_array();
+  for (const auto &response : responses) {
+    writer.raw(response);
+  }
+  writer.end_array();
+  return out;
+}
+
 void SolanaRpcServer::register_account_methods() {
   // Account information methods
   register_method("getAccountInfo", [this](const RpcRequest &req) {
@@ -972,17 +1049,9 @@ RpcResponse SolanaRpcServer::get_account_info(const RpcRequest &request) {
           request.id_is_number);
     }
 
-    // Get account info from account manager with caching
+    // Get account info from account manager (cached by response_cache_)
     if (account_manager_) {
       try {
-        // Check cache first for frequently accessed accounts
-        auto cache_it = account_cache_.find(address);
-        if (cache_it != account_cache_.end() &&
-            is_cache_valid(cache_it->second.second)) {
-          response.result = cache_it->second.first;
-          return response;
-        }
-
         // Convert address string to PublicKey using proper base58 decoding
         // This ensures consistency with requestAirdrop method
         PublicKey pubkey = decode_base58(address);
@@ -1043,9 +1112,7 @@ RpcResponse SolanaRpcServer::get_account_info(const RpcRequest &request) {
               "{\"context\":" + get_current_context() + ",\"value\":null}";
         }
 
-        // Cache the result for future requests
-        account_cache_[address] = {result_str, get_current_timestamp_ms()};
-        response.result = result_str;
+        response.result = std::move(result_str);
 
       } catch (const std::exception &e) {
         return create_error_response(
@@ -1105,10 +1172,13 @@ RpcResponse SolanaRpcServer::get_balance(const RpcRequest &request) {
       uint64_t balance =
           account_info.has_value() ? account_info.value().lamports : 0;
 
-      std::ostringstream oss;
-      oss << "{\"context\":" << get_current_context()
-          << ",\"value\":" << balance << "}";
-      response.result = oss.str();
+      rpc_json::JsonWriter writer(response.result);
+      writer.begin_object()
+          .key("context")
+          .raw(get_current_context())
+          .key("value")
+          .number(balance)
+          .end_object();
     } else {
       // Return 0 balance for non-existent accounts (production behavior)
       response.result =
@@ -1221,7 +1291,7 @@ RpcResponse SolanaRpcServer::get_multiple_accounts(const RpcRequest &request) {
 
   try {
     // Extract account addresses array from params
-    std::string params_str = extract_json_array(request.params, "");
+    const std::string &params_str = request.params;
 
     if (params_str.empty() || params_str == "[]") {
       return create_error_response(request.id, -32602,
@@ -1233,27 +1303,17 @@ RpcResponse SolanaRpcServer::get_multiple_accounts(const RpcRequest &request) {
     account_results.reserve(100); // Pre-allocate for performance
 
     if (account_manager_) {
-      // Parse account addresses efficiently
-      std::string inner =
-          params_str.substr(1, params_str.length() - 2); // Remove brackets
+      // First positional param is the array of base58 addresses
       std::vector<std::string> addresses;
-      addresses.reserve(100);
-
-      // Efficient string parsing
-      size_t start = 0;
-      bool in_quotes = false;
-      for (size_t i = 0; i < inner.length(); ++i) {
-        if (inner[i] == '"') {
-          in_quotes = !in_quotes;
-          if (!in_quotes && i > start) {
-            // Extract address without quotes
-            std::string addr = inner.substr(start + 1, i - start - 1);
-            if (!addr.empty()) {
-              addresses.push_back(addr);
-            }
+      auto &doc = params_document();
+      if (doc.parse(params_str)) {
+        auto list = doc.root().at(0);
+        addresses.reserve(list.size());
+        for (auto item = list.first_child(); item.valid();
+             item = item.next_sibling()) {
+          if (item.is_string() && !item.raw().empty()) {
+            addresses.push_back(item.as_string());
           }
-          if (in_quotes)
-            start = i;
         }
       }
 
@@ -1289,19 +1349,18 @@ RpcResponse SolanaRpcServer::get_multiple_accounts(const RpcRequest &request) {
     }
 
     // Efficient result formatting
-    std::ostringstream result;
-    result.str().reserve(1024 *
-                         account_results.size()); // Pre-allocate string buffer
-    result << "{\"context\":" << get_current_context() << ",\"value\":[";
-
-    for (size_t i = 0; i < account_results.size(); ++i) {
-      if (i > 0)
-        result << ",";
-      result << account_results[i];
+    size_t total = 64;
+    for (const auto &entry : account_results) {
+      total += entry.size() + 1;
     }
-    result << "]}";
-
-    response.result = result.str();
+    response.result.reserve(total);
+    rpc_json::JsonWriter writer(response.result);
+    writer.begin_object().key("context").raw(get_current_context());
+    writer.key("value").begin_array();
+    for (const auto &entry : account_results) {
+      writer.raw(entry);
+    }
+    writer.end_array().end_object();
 
   } catch (const std::exception &e) {
     return create_error_response(request.id, -32603, "Internal error",
@@ -1483,7 +1542,7 @@ RpcResponse SolanaRpcServer::get_blocks(const RpcRequest &request) {
   response.id_is_number = request.id_is_number;
 
   // Production implementation: Return block slots in range
-  std::string params_str = extract_json_array(request.params, "");
+  const std::string &params_str = request.params;
 
   if (params_str.empty() || params_str == "[]") {
     response.error = "{\"code\":-32602,\"message\":\"Invalid params: start and "
@@ -1573,7 +1632,7 @@ RpcResponse SolanaRpcServer::get_slot_leaders(const RpcRequest &request) {
   response.id_is_number = request.id_is_number;
 
   // Production implementation: Return slot leaders for given range
-  std::string params_str = extract_json_array(request.params, "");
+  const std::string &params_str = request.params;
 
   // Default to current slot if no params provided
   uint64_t start_slot = 0;
@@ -1638,7 +1697,7 @@ RpcResponse SolanaRpcServer::get_block_production(const RpcRequest &request) {
   response.id_is_number = request.id_is_number;
 
   // Production implementation: Return block production statistics
-  std::string params_str = extract_json_array(request.params, "");
+  const std::string &params_str = request.params;
 
   uint64_t first_slot = 0;
   uint64_t last_slot = 0;
@@ -2357,7 +2416,82 @@ RpcResponse SolanaRpcServer::get_leader_schedule(const RpcRequest &request) {
   RpcResponse response;
   response.id = request.id;
   response.id_is_number = request.id_is_number;
-  response.result = "{}";
+
+  auto leader_schedule =
+      validator_core_ ? validator_core_->get_leader_schedule() : nullptr;
+  if (!leader_schedule) {
+    response.result = "null";
+    return response;
+  }
+
+  // Params: [slot?, {identity?}]; the slot may be null or omitted
+  Slot slot = validator_core_->get_current_slot();
+  PublicKey identity;
+  auto &doc = params_document();
+  if (!request.params.empty() && doc.parse(request.params)) {
+    for (auto item = doc.root().first_child(); item.valid();
+         item = item.next_sibling()) {
+      if (item.is_number()) {
+        auto value = item.as_uint64();
+        if (!value) {
+          return create_error_response(request.id, -32602,
+                                       "Invalid param: slot",
+                                       request.id_is_number);
+        }
+        slot = *value;
+      } else if (item.is_object() && item.get("identity").is_string()) {
+        identity = decode_base58(item.get("identity").as_string());
+        if (identity.size() != 32) {
+          return create_error_response(request.id, -32602,
+                                       "Invalid param: not a valid pubkey",
+                                       request.id_is_number);
+        }
+      }
+    }
+  }
+
+  auto schedule =
+      leader_schedule->get_epoch_schedule(leader_schedule->epoch_of(slot));
+  if (!schedule) {
+    response.result = "null";
+    return response;
+  }
+
+  // identity -> slot indices within the epoch, in one pass over the runs
+  const auto &validators = schedule->validators();
+  const auto &leaders = schedule->leader_indices();
+  std::vector<std::vector<uint64_t>> slots(validators.size());
+  for (size_t run = 0; run < leaders.size(); ++run) {
+    uint64_t start = run * consensus::LeaderSchedule::NUM_CONSECUTIVE_LEADER_SLOTS;
+    uint64_t end =
+        std::min(start + consensus::LeaderSchedule::NUM_CONSECUTIVE_LEADER_SLOTS,
+                 schedule->slot_count());
+    for (uint64_t index = start; index < end; ++index) {
+      slots[leaders[run]].push_back(index);
+    }
+  }
+
+  std::ostringstream oss;
+  oss << "{";
+  bool first = true;
+  for (size_t v = 0; v < validators.size(); ++v) {
+    if (slots[v].empty() || (!identity.empty() && validators[v] != identity)) {
+      continue;
+    }
+    if (!first)
+      oss << ",";
+    first = false;
+    oss << "\"" << encode_base58(validators[v]) << "\":[";
+    for (size_t i = 0; i < slots[v].size(); ++i) {
+      if (i > 0)
+        oss << ",";
+      oss << slots[v][i];
+    }
+    oss << "]";
+  }
+  oss << "}";
+
+  response.result = oss.str();
   return response;
 }
 
@@ -2590,33 +2724,46 @@ RpcResponse SolanaRpcServer::create_error_response(const std::string &id,
   response.id = id;
   response.id_is_number = id_is_number;
 
-  std::ostringstream oss;
-  oss << "{\"code\":" << code << ",\"message\":\"" << message << "\"}";
-  response.error = oss.str();
+  rpc_json::JsonWriter writer(response.error);
+  writer.begin_object()
+      .key("code")
+      .number(code)
+      .key("message")
+      .string(message)
+      .end_object();
 
   return response;
 }
 
 std::string SolanaRpcServer::get_current_context() const {
   uint64_t slot = validator_core_ ? validator_core_->get_current_slot() : 0;
-  return "{\"slot\":" + std::to_string(slot) + "}";
+  std::string out;
+  rpc_json::JsonWriter writer(out);
+  writer.begin_object().key("slot").number(slot).end_object();
+  return out;
 }
 
 std::string
 SolanaRpcServer::format_account_info(const PublicKey &address,
                                      const svm::ProgramAccount &account) const {
-  std::ostringstream oss;
-  oss << "{\"context\":" << get_current_context() << "," << "\"value\":{"
-      << "\"data\":[\""
-      << std::string(account.data.begin(),
-                     std::min(account.data.end(), account.data.begin() + 32))
-      << "\",\"base58\"],"
-      << "\"executable\":" << (account.executable ? "true" : "false") << ","
-      << "\"lamports\":" << account.lamports << "," << "\"owner\":\""
-      << std::string(account.owner.begin(),
-                     std::min(account.owner.end(), account.owner.begin() + 32))
-      << "\"," << "\"rentEpoch\":" << account.rent_epoch << "}}";
-  return oss.str();
+  // Single buffer: base64 data and base58 owner are encoded in place
+  std::string out;
+  out.reserve(128 + (account.data.size() + 2) / 3 * 4);
+  rpc_json::JsonWriter writer(out);
+  writer.begin_object().key("context").raw(get_current_context());
+  writer.key("value").begin_object();
+  writer.key("data")
+      .begin_array()
+      .base64(account.data.data(), account.data.size())
+      .string("base64")
+      .end_array();
+  writer.key("executable").boolean(account.executable);
+  writer.key("lamports").number(static_cast<uint64_t>(account.lamports));
+  writer.key("owner").base58(account.owner.data(), account.owner.size());
+  writer.key("rentEpoch").number(static_cast<uint64_t>(account.rent_epoch));
+  writer.key("space").number(static_cast<uint64_t>(account.data.size()));
+  writer.end_object().end_object();
+  return out;
 }
 
 std::string SolanaRpcServer::calculate_genesis_hash() const {
@@ -2964,94 +3111,17 @@ std::string SolanaRpcServer::compute_block_hash(
 
 std::string
 SolanaRpcServer::encode_base58(const std::vector<uint8_t> &data) const {
-  // Proper base58 encoding implementation for Solana compatibility
   if (data.empty())
     return "";
 
-  // Base58 alphabet used by Bitcoin and Solana
-  static const char base58_alphabet[] =
-      "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
-
-  // For 64-byte Ed25519 signatures, ensure exactly 88 characters
-  if (data.size() == 64) {
-    // Use improved algorithm for consistent 88-character output
-    std::vector<uint8_t> digits;
-
-    // Convert input to big number in base 58
-    for (uint8_t byte : data) {
-      uint32_t carry = byte;
-      for (size_t i = 0; i < digits.size(); ++i) {
-        carry += static_cast<uint32_t>(digits[i]) * 256;
-        digits[i] = carry % 58;
-        carry /= 58;
-      }
-      while (carry > 0) {
-        digits.push_back(carry % 58);
-        carry /= 58;
-      }
-    }
-
-    // Count leading zeros
-    size_t leading_zeros = 0;
-    for (uint8_t byte : data) {
-      if (byte == 0) {
-        leading_zeros++;
-      } else {
-        break;
-      }
-    }
-
-    // Build result with proper padding
-    std::string result;
-
-    // Add leading zero characters
-    for (size_t i = 0; i < leading_zeros; ++i) {
-      result += base58_alphabet[0];
-    }
-
-    // Add encoded digits in reverse order
-    for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
-      result += base58_alphabet[*it];
-    }
-
-    // For 64-byte signatures, pad to exactly 88 characters if needed
-    while (result.length() < 88) {
-      result = base58_alphabet[0] + result;
-    }
-
-    return result;
-  }
-
-  // Default implementation for other data sizes
-  std::vector<uint8_t> digits(1, 0);
-
-  for (uint8_t byte : data) {
-    uint32_t carry = byte;
-    for (size_t j = 0; j < digits.size(); ++j) {
-      carry += static_cast<uint32_t>(digits[j]) << 8;
-      digits[j] = carry % 58;
-      carry /= 58;
-    }
-
-    while (carry > 0) {
-      digits.push_back(carry % 58);
-      carry /= 58;
-    }
-  }
-
-  // Convert leading zeros
   std::string result;
-  for (uint8_t byte : data) {
-    if (byte != 0)
-      break;
-    result += base58_alphabet[0];
-  }
+  result.reserve(data.size() * 138 / 100 + 1);
+  rpc_json::append_base58(result, data.data(), data.size());
 
-  // Convert digits to base58 characters (reverse order)
-  for (auto it = digits.rbegin(); it != digits.rend(); ++it) {
-    result += base58_alphabet[*it];
+  // For 64-byte Ed25519 signatures, pad to exactly 88 characters
+  if (data.size() == 64 && result.length() < 88) {
+    result.insert(0, 88 - result.length(), '1');
   }
-
   return result;
 }
 
@@ -3665,15 +3735,44 @@ SolanaRpcServer::get_recent_prioritization_fees(const RpcRequest &request) {
   response.id = request.id;
   response.id_is_number = request.id_is_number;
 
+  // Optional first param: writable accounts whose local fee markets to
+  // include (at most 128, as in Agave)
+  std::vector<PublicKey> accounts;
+  auto &doc = params_document();
+  if (!request.params.empty() && doc.parse(request.params)) {
+    auto list = doc.root().at(0);
+    for (auto item = list.first_child(); item.valid();
+         item = item.next_sibling()) {
+      if (!item.is_string()) {
+        continue;
+      }
+      if (accounts.size() == 128) {
+        return create_error_response(request.id, -32602,
+                                     "Too many inputs provided; max 128",
+                                     request.id_is_number);
+      }
+      PublicKey account = decode_base58(item.as_string());
+      if (account.size() != 32) {
+        return create_error_response(request.id, -32602,
+                                     "Invalid param: not a valid pubkey",
+                                     request.id_is_number);
+      }
+      accounts.push_back(std::move(account));
+    }
+  }
+
   std::ostringstream oss;
   oss << "[";
-  for (int i = 0; i < 5; ++i) {
-    if (i > 0)
-      oss << ",";
-    uint64_t slot =
-        validator_core_ ? validator_core_->get_current_slot() - i : i;
-    oss << "{\"slot\":" << slot << ",\"prioritizationFee\":" << (i * 1000)
-        << "}";
+  if (banking_stage_) {
+    bool first = true;
+    for (const auto &fee :
+         banking_stage_->get_recent_prioritization_fees(accounts)) {
+      if (!first)
+        oss << ",";
+      first = false;
+      oss << "{\"slot\":" << fee.slot
+          << ",\"prioritizationFee\":" << fee.prioritization_fee << "}";
+    }
   }
   oss << "]";
 
@@ -3688,10 +3787,13 @@ RpcResponse SolanaRpcServer::get_supply(const RpcRequest &request) {
 
   try {
     // Check cache first since supply data doesn't change frequently
-    if (!cached_supply_data_.empty() &&
-        is_cache_valid(cached_supply_timestamp_)) {
-      response.result = cached_supply_data_;
-      return response;
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      if (!cached_supply_data_.empty() &&
+          is_cache_valid(cached_supply_timestamp_)) {
+        response.result = cached_supply_data_;
+        return response;
+      }
     }
 
     uint64_t total_supply = 0;
@@ -3761,8 +3863,11 @@ RpcResponse SolanaRpcServer::get_supply(const RpcRequest &request) {
     response.result = oss.str();
 
     // Cache the result since supply data is relatively stable
-    cached_supply_data_ = response.result;
-    cached_supply_timestamp_ = get_current_timestamp_ms();
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      cached_supply_data_ = response.result;
+      cached_supply_timestamp_ = get_current_timestamp_ms();
+    }
 
   } catch (const std::exception &e) {
     return create_error_response(request.id, -32603, "Internal error",
@@ -1,56 +1,352 @@
 #include "network/websocket_server.h"
+#include "network/rpc_json.h"
+#include <algorithm>
 #include <arpa/inet.h>
-#include <chrono>
-#include <condition_variable>
+#include <cctype>
+#include <charconv>
 #include <cstring>
 #include <errno.h>
 #include <fcntl.h>
 #include <iostream>
 #include <netinet/in.h>
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
-#include <openssl/evp.h>
+#include <netinet/tcp.h>
 #include <openssl/sha.h>
-#include <poll.h>
-#include <regex>
-#include <sstream>
+#include <shared_mutex>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
-#include <thread>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace slonana {
 namespace network {
 
+namespace {
+
+constexpr size_t MAX_IOV = 192;            // 64 messages per sendmsg
+constexpr size_t MAX_HANDSHAKE_SIZE = 8192;
+constexpr size_t MAX_EPOLL_EVENTS = 256;
+constexpr int EPOLL_TIMEOUT_MS = 200;
+
+constexpr uint8_t OPCODE_CONTINUATION = 0x0;
+constexpr uint8_t OPCODE_TEXT = 0x1;
+constexpr uint8_t OPCODE_BINARY = 0x2;
+constexpr uint8_t OPCODE_CLOSE = 0x8;
+constexpr uint8_t OPCODE_PING = 0x9;
+
+// Write a server (unmasked) frame header; returns its length
+size_t write_frame_header(char *out, uint8_t first_byte, size_t length) {
+  out[0] = static_cast<char>(first_byte);
+  if (length < 126) {
+    out[1] = static_cast<char>(length);
+    return 2;
+  }
+  if (length <= 65535) {
+    out[1] = 126;
+    out[2] = static_cast<char>(length >> 8);
+    out[3] = static_cast<char>(length & 0xFF);
+    return 4;
+  }
+  out[1] = 127;
+  for (int i = 0; i < 8; ++i) {
+    out[2 + i] = static_cast<char>((length >> ((7 - i) * 8)) & 0xFF);
+  }
+  return 10;
+}
+
+std::shared_ptr<const std::string> make_frame(uint8_t first_byte,
+                                              std::string_view payload) {
+  auto frame = std::make_shared<std::string>(10 + payload.size(), '\0');
+  size_t header = write_frame_header(frame->data(), first_byte, payload.size());
+  std::memcpy(frame->data() + header, payload.data(), payload.size());
+  frame->resize(header + payload.size());
+  return frame;
+}
+
+bool set_nonblocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Case-insensitive HTTP header lookup inside a raw request head
+std::string find_header(std::string_view head, std::string_view name) {
+  size_t line_start = head.find("\r\n");
+  while (line_start != std::string_view::npos) {
+    line_start += 2;
+    size_t line_end = head.find("\r\n", line_start);
+    std::string_view line = head.substr(
+        line_start, line_end == std::string_view::npos
+                        ? std::string_view::npos
+                        : line_end - line_start);
+    size_t colon = line.find(':');
+    if (colon == name.size() &&
+        std::equal(name.begin(), name.end(), line.begin(),
+                   [](char a, char b) {
+                     return std::tolower(static_cast<unsigned char>(a)) ==
+                            std::tolower(static_cast<unsigned char>(b));
+                   })) {
+      std::string_view value = line.substr(colon + 1);
+      while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+      }
+      while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+      }
+      return std::string(value);
+    }
+    line_start = line_end;
+  }
+  return "";
+}
+
+rpc_json::JsonDocument &message_document() {
+  thread_local rpc_json::JsonDocument doc;
+  return doc;
+}
+
+} // namespace
+
+// Sharded key -> subscribers map. Publishers take a shared lock on one
+// shard only, so notifications for different keys never contend.
+class WebSocketServer::SubscriptionTable {
+public:
+  struct Subscriber {
+    uint64_t id;
+    std::shared_ptr<WebSocketConnection> conn;
+    uint8_t interest = 0xFF; ///< interest_bit() of the subscription
+  };
+
+  explicit SubscriptionTable(size_t shard_count) {
+    shards_.reserve(std::max<size_t>(1, shard_count));
+    for (size_t i = 0; i < std::max<size_t>(1, shard_count); ++i) {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+  }
+
+  void add(const std::string &key, Subscriber subscriber) {
+    auto &shard = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.subscribers[key].push_back(std::move(subscriber));
+  }
+
+  bool remove(const std::string &key, uint64_t id) {
+    auto &shard = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.subscribers.find(key);
+    if (it == shard.subscribers.end()) {
+      return false;
+    }
+    auto &list = it->second;
+    for (size_t i = 0; i < list.size(); ++i) {
+      if (list[i].id == id) {
+        list[i] = std::move(list.back());
+        list.pop_back();
+        if (list.empty()) {
+          shard.subscribers.erase(it);
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Detach every subscriber of key (one-shot subscriptions)
+  std::vector<Subscriber> take(const std::string &key) {
+    auto &shard = shard_for(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.subscribers.find(key);
+    if (it == shard.subscribers.end()) {
+      return {};
+    }
+    auto list = std::move(it->second);
+    shard.subscribers.erase(it);
+    return list;
+  }
+
+  template <typename Fn> void for_each(const std::string &key, Fn &&fn) const {
+    auto &shard = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.subscribers.find(key);
+    if (it == shard.subscribers.end()) {
+      return;
+    }
+    for (const auto &subscriber : it->second) {
+      fn(subscriber);
+    }
+  }
+
+  uint8_t interest(const std::string &key) const {
+    auto &shard = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.subscribers.find(key);
+    if (it == shard.subscribers.end()) {
+      return 0;
+    }
+    uint8_t mask = 0;
+    for (const auto &subscriber : it->second) {
+      mask |= subscriber.interest;
+    }
+    return mask;
+  }
+
+  size_t count(const std::string &key) const {
+    auto &shard = shard_for(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.subscribers.find(key);
+    return it == shard.subscribers.end() ? 0 : it->second.size();
+  }
+
+  void clear() {
+    for (auto &shard : shards_) {
+      std::unique_lock<std::shared_mutex> lock(shard->mutex);
+      shard->subscribers.clear();
+    }
+  }
+
+private:
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, std::vector<Subscriber>> subscribers;
+  };
+
+  Shard &shard_for(const std::string &key) const {
+    return *shards_[std::hash<std::string>{}(key) % shards_.size()];
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+struct WebSocketServer::Reactor {
+  size_t index = 0;
+  int epoll_fd = -1;
+  int wake_fd = -1;
+  std::thread thread;
+
+  // Connections with freshly queued output, handed over by publishers
+  std::mutex pending_mutex;
+  std::vector<std::shared_ptr<WebSocketConnection>> pending_flush;
+
+  // Closed connections kept alive until the current event batch is done
+  std::vector<std::shared_ptr<WebSocketConnection>> graveyard;
+
+  void wake() {
+    uint64_t one = 1;
+    ssize_t ignored = ::write(wake_fd, &one, sizeof(one));
+    (void)ignored;
+  }
+
+  ~Reactor() {
+    if (epoll_fd >= 0) {
+      ::close(epoll_fd);
+    }
+    if (wake_fd >= 0) {
+      ::close(wake_fd);
+    }
+  }
+};
+
 // WebSocket Connection Implementation
-WebSocketConnection::WebSocketConnection(int fd, const std::string &addr)
-    : socket_fd(fd), client_address(addr), is_connected(true) {}
+WebSocketConnection::WebSocketConnection(int fd, const std::string &addr,
+                                         size_t reactor,
+                                         size_t max_queued_bytes,
+                                         size_t max_queued_messages)
+    : socket_fd(fd), client_address(addr), reactor_index(reactor),
+      is_connected(true), max_queued_bytes(max_queued_bytes),
+      max_queued_messages(max_queued_messages) {}
 
 WebSocketConnection::~WebSocketConnection() { close(); }
 
-bool WebSocketConnection::send_message(const std::string &message) {
-  if (!is_connected.load())
-    return false;
+WebSocketConnection::EnqueueResult
+WebSocketConnection::send_message(const std::string &message) {
+  return enqueue(std::make_shared<const std::string>(message), {});
+}
 
-  auto frame = create_websocket_frame(message);
-  ssize_t sent = send(socket_fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+WebSocketConnection::EnqueueResult
+WebSocketConnection::enqueue(std::shared_ptr<const std::string> body,
+                             std::string_view trailer, bool framed) {
+  if (!is_connected.load(std::memory_order_relaxed) ||
+      evicted.load(std::memory_order_relaxed)) {
+    return EnqueueResult::CLOSED;
+  }
 
-  if (sent != static_cast<ssize_t>(frame.size())) {
-    is_connected.store(false);
-    return false;
+  OutboundMessage message;
+  message.trailer_len = static_cast<uint8_t>(
+      std::min(trailer.size(), message.trailer.size()));
+  std::memcpy(message.trailer.data(), trailer.data(), message.trailer_len);
+  if (framed) {
+    message.header_len = static_cast<uint8_t>(
+        write_frame_header(message.header.data(), 0x80 | OPCODE_TEXT,
+                           body->size() + message.trailer_len));
   }
+  message.body = std::move(body);
+  size_t size = message.size();
+
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  bool was_idle = queue.empty();
+  if (!was_idle && (queue.size() >= max_queued_messages ||
+                    queue_bytes + size > max_queued_bytes)) {
+    return EnqueueResult::OVERFLOW;
+  }
+  queue.push_back(std::move(message));
+  queue_bytes += size;
+  return was_idle ? EnqueueResult::NEEDS_FLUSH : EnqueueResult::QUEUED;
+}
 
+bool WebSocketConnection::flush(uint64_t &messages_written) {
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  while (!queue.empty()) {
+    iovec iov[MAX_IOV];
+    size_t count = 0;
+    size_t skip = front_offset;
+    for (auto it = queue.begin(); it != queue.end() && count + 3 <= MAX_IOV;
+         ++it) {
+      const char *parts[3] = {it->header.data(), it->body->data(),
+                              it->trailer.data()};
+      size_t sizes[3] = {it->header_len, it->body->size(), it->trailer_len};
+      for (int part = 0; part < 3; ++part) {
+        if (skip >= sizes[part]) {
+          skip -= sizes[part];
+          continue;
+        }
+        iov[count].iov_base = const_cast<char *>(parts[part] + skip);
+        iov[count].iov_len = sizes[part] - skip;
+        skip = 0;
+        ++count;
+      }
+    }
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    ssize_t written = sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    size_t remaining = front_offset + static_cast<size_t>(written);
+    while (!queue.empty() && remaining >= queue.front().size()) {
+      size_t size = queue.front().size();
+      remaining -= size;
+      queue_bytes -= size;
+      queue.pop_front();
+      ++messages_written;
+    }
+    front_offset = remaining;
+  }
   return true;
 }
 
-bool WebSocketConnection::send_subscription_response(
-    const SubscriptionMessage &msg) {
-  std::ostringstream response;
-  response << "{" << "\"jsonrpc\":\"2.0\"," << "\"method\":\"" << msg.method
-           << "\"," << "\"params\":{"
-           << "\"subscription\":" << msg.subscription_id << ","
-           << "\"result\":" << msg.result << "}}";
+bool WebSocketConnection::has_pending_output() const {
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  return !queue.empty();
+}
 
-  return send_message(response.str());
+size_t WebSocketConnection::queued_bytes() const {
+  std::lock_guard<std::mutex> lock(queue_mutex);
+  return queue_bytes;
 }
 
 bool WebSocketConnection::add_subscription(const SubscriptionRequest &request) {
@@ -59,15 +355,23 @@ bool WebSocketConnection::add_subscription(const SubscriptionRequest &request) {
   return true;
 }
 
-bool WebSocketConnection::remove_subscription(uint64_t subscription_id) {
+std::optional<SubscriptionRequest>
+WebSocketConnection::remove_subscription(uint64_t subscription_id) {
   std::lock_guard<std::mutex> lock(subscriptions_mutex);
-  return subscriptions.erase(subscription_id) > 0;
+  auto it = subscriptions.find(subscription_id);
+  if (it == subscriptions.end()) {
+    return std::nullopt;
+  }
+  auto request = std::move(it->second);
+  subscriptions.erase(it);
+  return request;
 }
 
 std::vector<SubscriptionRequest>
 WebSocketConnection::get_subscriptions() const {
   std::lock_guard<std::mutex> lock(subscriptions_mutex);
   std::vector<SubscriptionRequest> result;
+  result.reserve(subscriptions.size());
   for (const auto &pair : subscriptions) {
     result.push_back(pair.second);
   }
@@ -80,37 +384,22 @@ void WebSocketConnection::close() {
   }
 }
 
-std::vector<uint8_t>
-WebSocketConnection::create_websocket_frame(const std::string &payload) {
-  std::vector<uint8_t> frame;
-
-  // First byte: FIN=1, RSV=000, Opcode=0001 (text frame)
-  frame.push_back(0x81);
-
-  // Payload length
-  if (payload.length() < 126) {
-    frame.push_back(static_cast<uint8_t>(payload.length()));
-  } else if (payload.length() <= 65535) {
-    frame.push_back(126);
-    frame.push_back(static_cast<uint8_t>(payload.length() >> 8));
-    frame.push_back(static_cast<uint8_t>(payload.length() & 0xFF));
-  } else {
-    frame.push_back(127);
-    for (int i = 7; i >= 0; --i) {
-      frame.push_back(
-          static_cast<uint8_t>((payload.length() >> (i * 8)) & 0xFF));
-    }
-  }
-
-  // Payload data
-  frame.insert(frame.end(), payload.begin(), payload.end());
-
-  return frame;
-}
-
 // WebSocket Server Implementation
 WebSocketServer::WebSocketServer(const std::string &address, int port)
-    : bind_address(address), port(port), server_socket(-1), running(false),
+    : WebSocketServer(address, port, WebSocketServerConfig()) {}
+
+WebSocketServer::WebSocketServer(const std::string &address, int port,
+                                 const WebSocketServerConfig &config)
+    : bind_address(address), port(port), server_socket(-1), config(config),
+      running(false),
+      account_subscriptions(
+          std::make_unique<SubscriptionTable>(config.subscription_shards)),
+      signature_subscriptions(
+          std::make_unique<SubscriptionTable>(config.subscription_shards)),
+      program_subscriptions(
+          std::make_unique<SubscriptionTable>(config.subscription_shards)),
+      slot_subscriptions(std::make_unique<SubscriptionTable>(1)),
+      block_subscriptions(std::make_unique<SubscriptionTable>(1)),
       total_connections(0), active_subscriptions(0), messages_sent(0) {}
 
 WebSocketServer::~WebSocketServer() { stop(); }
@@ -150,20 +439,53 @@ bool WebSocketServer::start() {
   }
 
   // Listen
-  if (listen(server_socket, 10) < 0) {
+  if (listen(server_socket, SOMAXCONN) < 0 || !set_nonblocking(server_socket)) {
     std::cerr << "Failed to listen on WebSocket server" << std::endl;
     ::close(server_socket);
     return false;
   }
 
+  size_t reactor_count = config.reactor_threads;
+  if (reactor_count == 0) {
+    reactor_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+  }
+
+  std::unique_lock<std::shared_mutex> reactors_lock(reactors_mutex);
+  reactors.clear();
+  for (size_t i = 0; i < reactor_count; ++i) {
+    auto reactor = std::make_unique<Reactor>();
+    reactor->index = i;
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    reactor->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (reactor->epoll_fd < 0 || reactor->wake_fd < 0) {
+      std::cerr << "Failed to create WebSocket event loop" << std::endl;
+      reactors.clear();
+      ::close(server_socket);
+      return false;
+    }
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.ptr = reactor.get();
+    epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->wake_fd, &wake_event);
+    reactors.push_back(std::move(reactor));
+  }
+
+  // The first reactor also accepts; new connections are spread round-robin
+  epoll_event listen_event{};
+  listen_event.events = EPOLLIN;
+  listen_event.data.ptr = this;
+  epoll_ctl(reactors[0]->epoll_fd, EPOLL_CTL_ADD, server_socket, &listen_event);
+
   running.store(true);
+  start_time = std::chrono::steady_clock::now();
 
-  // Start server threads
-  server_thread = std::thread(&WebSocketServer::server_loop, this);
-  notification_thread = std::thread(&WebSocketServer::notification_loop, this);
+  for (auto &reactor : reactors) {
+    reactor->thread =
+        std::thread(&WebSocketServer::reactor_loop, this, std::ref(*reactor));
+  }
 
   std::cout << "WebSocket server started on " << bind_address << ":" << port
-            << std::endl;
+            << " (" << reactor_count << " event loops)" << std::endl;
   return true;
 }
 
@@ -171,144 +493,294 @@ void WebSocketServer::stop() {
   if (!running.exchange(false))
     return;
 
-  // Shutdown and close server socket to interrupt accept() calls
+  for (auto &reactor : reactors) {
+    reactor->wake();
+  }
+  for (auto &reactor : reactors) {
+    if (reactor->thread.joinable()) {
+      reactor->thread.join();
+    }
+  }
+
   if (server_socket >= 0) {
-    ::shutdown(server_socket, SHUT_RDWR);
     ::close(server_socket);
     server_socket = -1;
   }
 
-  // Wake up notification thread
-  queue_cv.notify_all();
-
-  // Wait for threads to finish with timeout
-  if (server_thread.joinable()) {
-    server_thread.join();
-  }
-  if (notification_thread.joinable()) {
-    notification_thread.join();
-  }
-
   // Close all connections
-  std::lock_guard<std::mutex> lock(connections_mutex);
-  for (auto &conn : connections) {
-    conn->close();
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    for (auto &entry : connections) {
+      entry.second->state = WebSocketConnection::State::CLOSED;
+      entry.second->close();
+    }
+    connections.clear();
+  }
+  account_subscriptions->clear();
+  signature_subscriptions->clear();
+  program_subscriptions->clear();
+  slot_subscriptions->clear();
+  block_subscriptions->clear();
+  active_subscriptions.store(0);
+  {
+    // Waits out publishers still handing connections to the reactors
+    std::unique_lock<std::shared_mutex> lock(reactors_mutex);
+    reactors.clear();
   }
-  connections.clear();
 
   std::cout << "WebSocket server stopped" << std::endl;
 }
 
-void WebSocketServer::server_loop() {
-  while (running.load()) {
+void WebSocketServer::reactor_loop(Reactor &reactor) {
+  epoll_event events[MAX_EPOLL_EVENTS];
+  std::vector<std::shared_ptr<WebSocketConnection>> pending;
+
+  while (running.load(std::memory_order_relaxed)) {
+    int ready = epoll_wait(reactor.epoll_fd, events, MAX_EPOLL_EVENTS,
+                           EPOLL_TIMEOUT_MS);
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "WebSocket epoll_wait failed: " << strerror(errno)
+                << std::endl;
+      break;
+    }
+
+    for (int i = 0; i < ready; ++i) {
+      void *source = events[i].data.ptr;
+      if (source == this) {
+        accept_connections();
+        continue;
+      }
+
+      if (source == &reactor) {
+        uint64_t counter = 0;
+        ssize_t ignored = ::read(reactor.wake_fd, &counter, sizeof(counter));
+        (void)ignored;
+        {
+          std::lock_guard<std::mutex> lock(reactor.pending_mutex);
+          pending.swap(reactor.pending_flush);
+        }
+        for (auto &conn : pending) {
+          conn->flush_scheduled.store(false);
+          if (conn->state == WebSocketConnection::State::CLOSED) {
+            continue;
+          }
+          if (conn->evicted.load()) {
+            close_connection(reactor, *conn);
+          } else {
+            handle_writable(reactor, *conn);
+          }
+        }
+        pending.clear();
+        continue;
+      }
+
+      auto *conn = static_cast<WebSocketConnection *>(source);
+      if (conn->state == WebSocketConnection::State::CLOSED) {
+        continue;
+      }
+      uint32_t flags = events[i].events;
+      if (flags & EPOLLIN) {
+        handle_readable(reactor, *conn);
+      }
+      if (conn->state != WebSocketConnection::State::CLOSED &&
+          (flags & EPOLLOUT)) {
+        handle_writable(reactor, *conn);
+      }
+      if (conn->state != WebSocketConnection::State::CLOSED &&
+          (flags & (EPOLLERR | EPOLLHUP))) {
+        close_connection(reactor, *conn);
+      }
+    }
+
+    reactor.graveyard.clear();
+  }
+}
+
+void WebSocketServer::accept_connections() {
+  while (true) {
     struct sockaddr_in client_addr {};
     socklen_t client_len = sizeof(client_addr);
-
-    int client_socket =
-        accept(server_socket, reinterpret_cast<struct sockaddr *>(&client_addr),
-               &client_len);
+    int client_socket = accept4(
+        server_socket, reinterpret_cast<struct sockaddr *>(&client_addr),
+        &client_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
     if (client_socket < 0) {
-      if (running.load()) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK && running.load()) {
         std::cerr << "WebSocket accept failed: " << strerror(errno)
                   << std::endl;
       }
-      // If not running anymore or socket is closed, exit loop
-      if (!running.load() || errno == EBADF || errno == ENOTSOCK) {
-        break;
-      }
-      continue;
+      return;
     }
 
+    int one = 1;
+    setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
     char client_ip[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
     std::string client_address = std::string(client_ip) + ":" +
                                  std::to_string(ntohs(client_addr.sin_port));
 
+    size_t target = next_reactor.fetch_add(1) % reactors.size();
+    auto connection = std::make_shared<WebSocketConnection>(
+        client_socket, client_address, target, config.max_queued_bytes,
+        config.max_queued_messages);
+    {
+      std::lock_guard<std::mutex> lock(connections_mutex);
+      connections.emplace(connection.get(), connection);
+    }
     total_connections.fetch_add(1);
 
-    // Handle client in separate thread
-    std::thread client_thread(&WebSocketServer::handle_client_connection, this,
-                              client_socket, client_address);
-    client_thread.detach();
-
-    // Cleanup disconnected connections periodically
-    cleanup_disconnected_connections();
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.ptr = connection.get();
+    epoll_ctl(reactors[target]->epoll_fd, EPOLL_CTL_ADD, client_socket, &event);
   }
 }
 
-void WebSocketServer::handle_client_connection(int client_socket,
-                                               const std::string &client_addr) {
-  // Handle WebSocket handshake
-  handle_websocket_handshake(client_socket);
+void WebSocketServer::handle_readable(Reactor &reactor,
+                                      WebSocketConnection &conn) {
+  char buffer[16384];
+  bool peer_closed = false;
+  while (true) {
+    ssize_t received = recv(conn.get_socket(), buffer, sizeof(buffer), 0);
+    if (received > 0) {
+      conn.read_buffer.append(buffer, static_cast<size_t>(received));
+      continue;
+    }
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    peer_closed = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+    break;
+  }
 
-  // Create connection object
-  auto connection =
-      std::make_shared<WebSocketConnection>(client_socket, client_addr);
+  bool ok = true;
+  if (conn.state == WebSocketConnection::State::HANDSHAKE) {
+    ok = handle_websocket_handshake(conn);
+  }
+  if (ok && conn.state == WebSocketConnection::State::OPEN) {
+    ok = process_frames(conn);
+  }
 
-  {
-    std::lock_guard<std::mutex> lock(connections_mutex);
-    connections.push_back(connection);
+  // Replies queued while processing go out before the socket is dropped
+  if (conn.has_pending_output()) {
+    handle_writable(reactor, conn);
   }
+  if ((!ok || peer_closed) &&
+      conn.state != WebSocketConnection::State::CLOSED) {
+    close_connection(reactor, conn);
+  }
+}
 
-  std::cout << "WebSocket client connected: " << client_addr << std::endl;
+void WebSocketServer::handle_writable(Reactor &reactor,
+                                      WebSocketConnection &conn) {
+  uint64_t written = 0;
+  bool ok = conn.flush(written);
+  if (written > 0) {
+    messages_sent.fetch_add(written, std::memory_order_relaxed);
+  }
+  if (!ok) {
+    close_connection(reactor, conn);
+    return;
+  }
 
-  // Handle messages from client
-  char buffer[4096];
-  while (connection->is_alive() && running.load()) {
-    ssize_t received = recv(client_socket, buffer, sizeof(buffer), 0);
-    if (received <= 0) {
-      break;
+  // Only ask for EPOLLOUT while the kernel buffer is full
+  bool pending = conn.has_pending_output();
+  if (pending != conn.write_armed) {
+    epoll_event event{};
+    uint32_t events = EPOLLIN | EPOLLRDHUP;
+    if (pending) {
+      events |= EPOLLOUT;
     }
+    event.events = events;
+    event.data.ptr = &conn;
+    epoll_ctl(reactor.epoll_fd, EPOLL_CTL_MOD, conn.get_socket(), &event);
+    conn.write_armed = pending;
+  }
+}
+
+void WebSocketServer::close_connection(Reactor &reactor,
+                                       WebSocketConnection &conn) {
+  if (conn.state == WebSocketConnection::State::CLOSED) {
+    return;
+  }
+  conn.state = WebSocketConnection::State::CLOSED;
+  epoll_ctl(reactor.epoll_fd, EPOLL_CTL_DEL, conn.get_socket(), nullptr);
 
-    // Parse WebSocket frame and extract message
-    std::vector<uint8_t> frame(buffer, buffer + received);
-    std::string message;
-    if (parse_websocket_frame(frame, message)) {
-      handle_websocket_message(connection, message);
+  for (const auto &subscription : conn.get_subscriptions()) {
+    if (table_for(subscription.type)
+            .remove(table_key(subscription), subscription.subscription_id)) {
+      active_subscriptions.fetch_sub(1);
     }
   }
+  conn.close();
 
-  connection->close();
-  std::cout << "WebSocket client disconnected: " << client_addr << std::endl;
+  std::lock_guard<std::mutex> lock(connections_mutex);
+  auto it = connections.find(&conn);
+  if (it != connections.end()) {
+    // Other events in this epoll batch may still reference the connection
+    reactor.graveyard.push_back(std::move(it->second));
+    connections.erase(it);
+  }
 }
 
-void WebSocketServer::handle_websocket_handshake(int client_socket) {
-  char buffer[4096];
-  ssize_t received = recv(client_socket, buffer, sizeof(buffer), 0);
-  if (received <= 0)
+void WebSocketServer::schedule_flush(
+    const std::shared_ptr<WebSocketConnection> &conn) {
+  std::shared_lock<std::shared_mutex> reactors_lock(reactors_mutex);
+  if (conn->flush_scheduled.exchange(true) || reactors.empty()) {
     return;
+  }
+  auto &reactor = *reactors[conn->reactor()];
+  {
+    std::lock_guard<std::mutex> lock(reactor.pending_mutex);
+    reactor.pending_flush.push_back(conn);
+  }
+  reactor.wake();
+}
 
-  std::string request(buffer, received);
+void WebSocketServer::send_text(
+    const std::shared_ptr<WebSocketConnection> &conn,
+    const std::string &message) {
+  if (conn->send_message(message) ==
+      WebSocketConnection::EnqueueResult::NEEDS_FLUSH) {
+    schedule_flush(conn);
+  }
+}
 
-  // Extract WebSocket key
-  std::regex key_regex(R"(Sec-WebSocket-Key:\s*(.+))");
-  std::smatch match;
-  std::string websocket_key;
-  if (std::regex_search(request, match, key_regex)) {
-    websocket_key = match[1].str();
-    // Remove carriage return if present
-    if (!websocket_key.empty() && websocket_key.back() == '\r') {
-      websocket_key.pop_back();
-    }
+bool WebSocketServer::handle_websocket_handshake(WebSocketConnection &conn) {
+  size_t head_end = conn.read_buffer.find("\r\n\r\n");
+  if (head_end == std::string::npos) {
+    // Wait for the rest of the request head unless it is oversized
+    return conn.read_buffer.size() <= MAX_HANDSHAKE_SIZE;
   }
 
+  std::string_view head(conn.read_buffer.data(), head_end + 2);
+  std::string websocket_key = find_header(head, "Sec-WebSocket-Key");
   if (websocket_key.empty()) {
-    ::close(client_socket);
-    return;
+    conn.enqueue(std::make_shared<const std::string>(
+                     "HTTP/1.1 400 Bad Request\r\nConnection: close\r\n\r\n"),
+                 {}, false);
+    return false;
   }
 
-  // Generate accept key
-  std::string accept_key = compute_websocket_accept(websocket_key);
-
   // Send handshake response
-  std::ostringstream response;
-  response << "HTTP/1.1 101 Switching Protocols\r\n"
-           << "Upgrade: websocket\r\n"
-           << "Connection: Upgrade\r\n"
-           << "Sec-WebSocket-Accept: " << accept_key << "\r\n"
-           << "\r\n";
-
-  send(client_socket, response.str().c_str(), response.str().length(), 0);
+  std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                         "Upgrade: websocket\r\n"
+                         "Connection: Upgrade\r\n"
+                         "Sec-WebSocket-Accept: ";
+  response += compute_websocket_accept(websocket_key);
+  response += "\r\n\r\n";
+  conn.enqueue(std::make_shared<const std::string>(std::move(response)), {},
+               false);
+
+  conn.read_buffer.erase(0, head_end + 4);
+  conn.state = WebSocketConnection::State::OPEN;
+  return true;
 }
 
 std::string WebSocketServer::compute_websocket_accept(const std::string &key) {
@@ -319,404 +791,429 @@ std::string WebSocketServer::compute_websocket_accept(const std::string &key) {
   SHA1(reinterpret_cast<const unsigned char *>(combined.c_str()),
        combined.length(), hash);
 
-  // Base64 encode
-  BIO *bio = BIO_new(BIO_s_mem());
-  BIO *b64 = BIO_new(BIO_f_base64());
-  BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-  bio = BIO_push(b64, bio);
-
-  BIO_write(bio, hash, SHA_DIGEST_LENGTH);
-  BIO_flush(bio);
-
-  BUF_MEM *buffer_ptr;
-  BIO_get_mem_ptr(bio, &buffer_ptr);
-
-  std::string result(buffer_ptr->data, buffer_ptr->length);
-  BIO_free_all(bio);
-
+  std::string result;
+  rpc_json::append_base64(result, hash, SHA_DIGEST_LENGTH);
   return result;
 }
 
-bool WebSocketServer::parse_websocket_frame(const std::vector<uint8_t> &frame,
-                                            std::string &payload) {
-  if (frame.size() < 2)
-    return false;
+bool WebSocketServer::process_frames(WebSocketConnection &conn) {
+  const auto *data =
+      reinterpret_cast<const uint8_t *>(conn.read_buffer.data());
+  size_t size = conn.read_buffer.size();
+  size_t pos = 0;
+  std::shared_ptr<WebSocketConnection> self;
+
+  while (size - pos >= 2) {
+    const uint8_t *frame = data + pos;
+    size_t available = size - pos;
+    bool fin = (frame[0] & 0x80) != 0;
+    uint8_t opcode = frame[0] & 0x0F;
+    bool masked = (frame[1] & 0x80) != 0;
+    uint64_t payload_len = frame[1] & 0x7F;
+    size_t header_size = 2;
+
+    // Handle extended payload length
+    if (payload_len == 126) {
+      if (available < 4)
+        break;
+      payload_len = (static_cast<uint64_t>(frame[2]) << 8) | frame[3];
+      header_size = 4;
+    } else if (payload_len == 127) {
+      if (available < 10)
+        break;
+      payload_len = 0;
+      for (int i = 0; i < 8; i++) {
+        payload_len = (payload_len << 8) | frame[2 + i];
+      }
+      header_size = 10;
+    }
+    if (payload_len > config.max_frame_size) {
+      return false;
+    }
 
-  uint8_t opcode = frame[0] & 0x0F;
-  bool masked = (frame[1] & 0x80) != 0;
-  uint64_t payload_len = frame[1] & 0x7F;
+    // Handle masking key
+    uint8_t mask[4] = {0};
+    if (masked) {
+      if (available < header_size + 4)
+        break;
+      std::memcpy(mask, frame + header_size, 4);
+      header_size += 4;
+    }
+    if (available < header_size + payload_len)
+      break;
 
-  size_t header_size = 2;
+    std::string payload(reinterpret_cast<const char *>(frame + header_size),
+                        static_cast<size_t>(payload_len));
+    if (masked) {
+      for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>(payload[i] ^ mask[i & 3]);
+      }
+    }
+    pos += header_size + payload_len;
 
-  // Handle extended payload length
-  if (payload_len == 126) {
-    if (frame.size() < 4)
+    if (opcode == OPCODE_CLOSE) {
+      conn.enqueue(make_frame(0x80 | OPCODE_CLOSE,
+                              std::string_view(payload).substr(0, 2)),
+                   {}, false);
       return false;
-    payload_len = (frame[2] << 8) | frame[3];
-    header_size = 4;
-  } else if (payload_len == 127) {
-    if (frame.size() < 10)
-      return false;
-    payload_len = 0;
-    for (int i = 0; i < 8; i++) {
-      payload_len = (payload_len << 8) | frame[2 + i];
     }
-    header_size = 10;
-  }
+    if (opcode == OPCODE_PING) {
+      conn.enqueue(make_frame(0x80 | 0xA, payload), {}, false);
+      continue;
+    }
+    if (opcode != OPCODE_CONTINUATION && opcode != OPCODE_TEXT &&
+        opcode != OPCODE_BINARY) {
+      continue; // Pong and reserved opcodes
+    }
 
-  // Handle masking key
-  uint8_t mask[4] = {0};
-  if (masked) {
-    if (frame.size() < header_size + 4)
+    if (opcode != OPCODE_CONTINUATION) {
+      conn.fragment_buffer.clear();
+    }
+    if (conn.fragment_buffer.size() + payload.size() > config.max_frame_size) {
       return false;
-    for (int i = 0; i < 4; i++) {
-      mask[i] = frame[header_size + i];
     }
-    header_size += 4;
-  }
-
-  // Extract payload
-  if (frame.size() < header_size + payload_len)
-    return false;
-
-  payload.clear();
-  payload.reserve(payload_len);
+    if (!fin) {
+      conn.fragment_buffer += payload;
+      continue;
+    }
+    if (!conn.fragment_buffer.empty()) {
+      payload = std::move(conn.fragment_buffer.append(payload));
+      conn.fragment_buffer.clear();
+    }
 
-  for (uint64_t i = 0; i < payload_len; i++) {
-    uint8_t byte = frame[header_size + i];
-    if (masked) {
-      byte ^= mask[i % 4];
+    if (!self) {
+      std::lock_guard<std::mutex> lock(connections_mutex);
+      auto it = connections.find(&conn);
+      if (it == connections.end()) {
+        return false;
+      }
+      self = it->second;
     }
-    payload.push_back(static_cast<char>(byte));
+    handle_websocket_message(self, payload);
   }
 
-  return opcode == 1; // Text frame
+  conn.read_buffer.erase(0, pos);
+  return true;
 }
 
 void WebSocketServer::handle_websocket_message(
     std::shared_ptr<WebSocketConnection> conn, const std::string &message) {
-  // Parse JSON-RPC request
-  std::regex method_regex("\"method\"\\s*:\\s*\"([^\"]+)\"");
-  std::smatch match;
+  auto &doc = message_document();
+  if (!doc.parse(message) || !doc.root().is_object()) {
+    send_text(conn, R"({"jsonrpc":"2.0","error":{"code":-32700,)"
+                    R"("message":"Parse error"},"id":null})");
+    return;
+  }
 
-  if (!std::regex_search(message, match, method_regex)) {
+  auto root = doc.root();
+  auto id_value = root.get("id");
+  std::string request_id =
+      id_value.valid() ? std::string(id_value.json()) : "null";
+  auto method_value = root.get("method");
+  if (!method_value.is_string()) {
+    send_text(conn, R"({"jsonrpc":"2.0","error":{"code":-32600,)"
+                    R"("message":"Invalid Request"},"id":)" +
+                        request_id + "}");
     return;
   }
 
-  std::string method = match[1].str();
+  std::string_view method = method_value.as_string_view();
+  auto first_param = root.get("params").at(0);
 
   // Handle subscription methods
+  auto keyed = [&](SubscriptionType type) {
+    if (!first_param.is_string()) {
+      send_text(conn, R"({"jsonrpc":"2.0","error":{"code":-32602,)"
+                      R"("message":"Invalid params"},"id":)" +
+                          request_id + "}");
+      return;
+    }
+    // Optional config object: {"commitment":..,"encoding":..}
+    auto commitment = CommitmentLevel::FINALIZED;
+    auto encoding = AccountEncoding::BASE64;
+    auto options = root.get("params").at(1);
+    if (options.is_object()) {
+      auto level = options.get("commitment");
+      if (level.is_string()) {
+        auto name = level.as_string_view();
+        if (name == "processed" || name == "recent") {
+          commitment = CommitmentLevel::PROCESSED;
+        } else if (name == "confirmed" || name == "single" ||
+                   name == "singleGossip") {
+          commitment = CommitmentLevel::CONFIRMED;
+        }
+      }
+      auto enc = options.get("encoding");
+      if (enc.is_string() && enc.as_string_view() == "base58") {
+        encoding = AccountEncoding::BASE58;
+      }
+    }
+    handle_subscribe(conn, type, first_param.as_string(), request_id,
+                     commitment, encoding);
+  };
+
   if (method == "accountSubscribe") {
-    handle_account_subscribe(conn, message);
+    keyed(SubscriptionType::ACCOUNT_CHANGE);
   } else if (method == "signatureSubscribe") {
-    handle_signature_subscribe(conn, message);
+    keyed(SubscriptionType::SIGNATURE_STATUS);
+  } else if (method == "programSubscribe") {
+    keyed(SubscriptionType::PROGRAM_ACCOUNT);
   } else if (method == "slotSubscribe") {
-    handle_slot_subscribe(conn, message);
+    handle_subscribe(conn, SubscriptionType::SLOT_CHANGE, "", request_id);
   } else if (method == "blockSubscribe") {
-    handle_block_subscribe(conn, message);
-  } else if (method.find("Unsubscribe") != std::string::npos) {
-    handle_unsubscribe(conn, message);
+    handle_subscribe(conn, SubscriptionType::BLOCK_CHANGE, "", request_id);
+  } else if (method.find("Unsubscribe") != std::string_view::npos) {
+    auto subscription_id = first_param.as_uint64();
+    if (!subscription_id) {
+      send_text(conn, R"({"jsonrpc":"2.0","error":{"code":-32602,)"
+                      R"("message":"Invalid params"},"id":)" +
+                          request_id + "}");
+      return;
+    }
+    handle_unsubscribe(conn, *subscription_id, request_id);
+  } else {
+    send_text(conn, R"({"jsonrpc":"2.0","error":{"code":-32601,)"
+                    R"("message":"Method not found"},"id":)" +
+                        request_id + "}");
   }
 }
 
-void WebSocketServer::handle_account_subscribe(
-    std::shared_ptr<WebSocketConnection> conn, const std::string &request) {
-  // Extract pubkey from params
-  std::regex pubkey_regex("\"params\"\\s*:\\s*\\[\\s*\"([^\"]+)\"");
-  std::smatch match;
+void WebSocketServer::handle_subscribe(
+    std::shared_ptr<WebSocketConnection> conn, SubscriptionType type,
+    const std::string &key, const std::string &request_id,
+    CommitmentLevel commitment, AccountEncoding encoding) {
+  uint64_t subscription_id = next_subscription_id.fetch_add(1) + 1;
 
-  if (!std::regex_search(request, match, pubkey_regex)) {
-    return;
+  SubscriptionRequest sub_request{
+      type, "", "", subscription_id, "", commitment, encoding};
+  if (type == SubscriptionType::PROGRAM_ACCOUNT) {
+    sub_request.program_id = key;
+  } else {
+    sub_request.pubkey = key;
   }
-
-  std::string pubkey = match[1].str();
-  uint64_t subscription_id = active_subscriptions.fetch_add(1) + 1;
-
-  SubscriptionRequest sub_request{SubscriptionType::ACCOUNT_CHANGE, pubkey, "",
-                                  subscription_id, ""};
-
   conn->add_subscription(sub_request);
-
-  {
-    std::lock_guard<std::mutex> lock(subscription_mutex);
-    account_subscriptions[pubkey].push_back(subscription_id);
-  }
+  table_for(type).add(key, {subscription_id, conn,
+                            interest_bit(commitment, encoding)});
+  active_subscriptions.fetch_add(1);
 
   // Send subscription confirmation
-  std::ostringstream response;
-  response << "{\"jsonrpc\":\"2.0\",\"result\":" << subscription_id
-           << ",\"id\":1}";
-  conn->send_message(response.str());
-
-  std::cout << "WebSocket: Account subscription created for " << pubkey
-            << " (ID: " << subscription_id << ")" << std::endl;
+  send_text(conn, R"({"jsonrpc":"2.0","result":)" +
+                      std::to_string(subscription_id) + R"(,"id":)" +
+                      request_id + "}");
 }
 
-void WebSocketServer::handle_signature_subscribe(
-    std::shared_ptr<WebSocketConnection> conn, const std::string &request) {
-  std::regex sig_regex("\"params\"\\s*:\\s*\\[\\s*\"([^\"]+)\"");
-  std::smatch match;
-
-  if (!std::regex_search(request, match, sig_regex)) {
-    return;
-  }
-
-  std::string signature = match[1].str();
-  uint64_t subscription_id = active_subscriptions.fetch_add(1) + 1;
-
-  SubscriptionRequest sub_request{SubscriptionType::SIGNATURE_STATUS, signature,
-                                  "", subscription_id, ""};
-
-  conn->add_subscription(sub_request);
-
-  {
-    std::lock_guard<std::mutex> lock(subscription_mutex);
-    signature_subscriptions[signature].push_back(subscription_id);
+void WebSocketServer::handle_unsubscribe(
+    std::shared_ptr<WebSocketConnection> conn, uint64_t subscription_id,
+    const std::string &request_id) {
+  auto removed = conn->remove_subscription(subscription_id);
+  if (removed && table_for(removed->type)
+                     .remove(table_key(*removed), subscription_id)) {
+    active_subscriptions.fetch_sub(1);
   }
-
-  std::ostringstream response;
-  response << "{\"jsonrpc\":\"2.0\",\"result\":" << subscription_id
-           << ",\"id\":1}";
-  conn->send_message(response.str());
-
-  std::cout << "WebSocket: Signature subscription created for " << signature
-            << " (ID: " << subscription_id << ")" << std::endl;
+  send_text(conn, std::string(R"({"jsonrpc":"2.0","result":)") +
+                      (removed ? "true" : "false") + R"(,"id":)" +
+                      request_id + "}");
 }
 
-void WebSocketServer::handle_slot_subscribe(
-    std::shared_ptr<WebSocketConnection> conn, const std::string &request) {
-  uint64_t subscription_id = active_subscriptions.fetch_add(1) + 1;
-
-  SubscriptionRequest sub_request{SubscriptionType::SLOT_CHANGE, "", "",
-                                  subscription_id, ""};
-
-  conn->add_subscription(sub_request);
-
-  {
-    std::lock_guard<std::mutex> lock(subscription_mutex);
-    slot_subscriptions.push_back(subscription_id);
+WebSocketServer::SubscriptionTable &
+WebSocketServer::table_for(SubscriptionType type) {
+  switch (type) {
+  case SubscriptionType::SIGNATURE_STATUS:
+    return *signature_subscriptions;
+  case SubscriptionType::PROGRAM_ACCOUNT:
+    return *program_subscriptions;
+  case SubscriptionType::SLOT_CHANGE:
+    return *slot_subscriptions;
+  case SubscriptionType::BLOCK_CHANGE:
+    return *block_subscriptions;
+  default:
+    return *account_subscriptions;
   }
-
-  std::ostringstream response;
-  response << "{\"jsonrpc\":\"2.0\",\"result\":" << subscription_id
-           << ",\"id\":1}";
-  conn->send_message(response.str());
-
-  std::cout << "WebSocket: Slot subscription created (ID: " << subscription_id
-            << ")" << std::endl;
 }
 
-void WebSocketServer::handle_block_subscribe(
-    std::shared_ptr<WebSocketConnection> conn, const std::string &request) {
-  uint64_t subscription_id = active_subscriptions.fetch_add(1) + 1;
-
-  SubscriptionRequest sub_request{SubscriptionType::BLOCK_CHANGE, "", "",
-                                  subscription_id, ""};
-
-  conn->add_subscription(sub_request);
-
-  {
-    std::lock_guard<std::mutex> lock(subscription_mutex);
-    block_subscriptions.push_back(subscription_id);
-  }
-
-  std::ostringstream response;
-  response << "{\"jsonrpc\":\"2.0\",\"result\":" << subscription_id
-           << ",\"id\":1}";
-  conn->send_message(response.str());
-
-  std::cout << "WebSocket: Block subscription created (ID: " << subscription_id
-            << ")" << std::endl;
+const std::string &
+WebSocketServer::table_key(const SubscriptionRequest &request) const {
+  return request.type == SubscriptionType::PROGRAM_ACCOUNT
+             ? request.program_id
+             : request.pubkey;
 }
 
-void WebSocketServer::handle_unsubscribe(
-    std::shared_ptr<WebSocketConnection> conn, const std::string &request) {
-  std::regex id_regex("\"params\"\\s*:\\s*\\[\\s*(\\d+)");
-  std::smatch match;
-
-  if (!std::regex_search(request, match, id_regex)) {
+void WebSocketServer::publish(SubscriptionTable &table, const std::string &key,
+                              const std::string &method,
+                              const std::string &result, bool one_shot,
+                              uint8_t accept_mask) {
+  if (!running.load(std::memory_order_relaxed) || table.count(key) == 0) {
     return;
   }
 
-  uint64_t subscription_id = std::stoull(match[1].str());
-
-  if (conn->remove_subscription(subscription_id)) {
-    std::ostringstream response;
-    response << "{\"jsonrpc\":\"2.0\",\"result\":true,\"id\":1}";
-    conn->send_message(response.str());
-
-    std::cout << "WebSocket: Subscription removed (ID: " << subscription_id
-              << ")" << std::endl;
+  // Serialized once; every subscriber's queue references the same buffer and
+  // only appends its own `<subscription id>}}` trailer
+  auto body = std::make_shared<std::string>();
+  body->reserve(64 + method.size() + result.size());
+  body->append(R"({"jsonrpc":"2.0","method":")")
+      .append(method)
+      .append(R"(","params":{"result":)")
+      .append(result)
+      .append(R"(,"subscription":)");
+  std::shared_ptr<const std::string> payload = std::move(body);
+
+  // stop() may be tearing the reactors down; hold them until handed off
+  std::shared_lock<std::shared_mutex> reactors_lock(reactors_mutex);
+  if (reactors.empty()) {
+    return;
   }
-}
-
-void WebSocketServer::notification_loop() {
-  while (running.load()) {
-    std::unique_lock<std::mutex> lock(queue_mutex);
-    queue_cv.wait(lock, [this] {
-      return !notification_queue.empty() || !running.load();
-    });
-
-    while (!notification_queue.empty() && running.load()) {
-      SubscriptionMessage msg = notification_queue.front();
-      notification_queue.pop();
-      lock.unlock();
-
-      // Send notification to relevant subscribers
-      std::lock_guard<std::mutex> conn_lock(connections_mutex);
-      for (auto &conn : connections) {
-        if (!conn->is_alive())
-          continue;
-
-        auto subscriptions = conn->get_subscriptions();
-        for (const auto &sub : subscriptions) {
-          if (sub.subscription_id == msg.subscription_id) {
-            conn->send_subscription_response(msg);
-            messages_sent.fetch_add(1);
-            break;
-          }
-        }
+  std::vector<std::vector<std::shared_ptr<WebSocketConnection>>> wake(
+      reactors.size());
+  auto deliver = [&](const SubscriptionTable::Subscriber &subscriber) {
+    if ((subscriber.interest & accept_mask) == 0) {
+      return;
+    }
+    char trailer[24];
+    auto end = std::to_chars(trailer, trailer + 20, subscriber.id).ptr;
+    *end++ = '}';
+    *end++ = '}';
+    auto &conn = subscriber.conn;
+    switch (conn->enqueue(payload,
+                          std::string_view(trailer, end - trailer))) {
+    case WebSocketConnection::EnqueueResult::NEEDS_FLUSH:
+      break;
+    case WebSocketConnection::EnqueueResult::OVERFLOW:
+      // Slow consumer: hand it to its reactor for eviction
+      if (conn->evicted.exchange(true)) {
+        return;
       }
+      slow_consumer_evictions.fetch_add(1);
+      break;
+    default:
+      return;
+    }
+    if (!conn->flush_scheduled.exchange(true)) {
+      wake[conn->reactor()].push_back(conn);
+    }
+  };
 
-      lock.lock();
+  if (one_shot) {
+    for (const auto &subscriber : table.take(key)) {
+      deliver(subscriber);
+      if (subscriber.conn->remove_subscription(subscriber.id)) {
+        active_subscriptions.fetch_sub(1);
+      }
     }
+  } else {
+    table.for_each(key, deliver);
   }
-}
 
-void WebSocketServer::cleanup_disconnected_connections() {
-  std::lock_guard<std::mutex> lock(connections_mutex);
-  connections.erase(
-      std::remove_if(connections.begin(), connections.end(),
-                     [](const std::shared_ptr<WebSocketConnection> &conn) {
-                       return !conn->is_alive();
-                     }),
-      connections.end());
+  for (size_t i = 0; i < wake.size(); ++i) {
+    if (wake[i].empty()) {
+      continue;
+    }
+    auto &reactor = *reactors[i];
+    {
+      std::lock_guard<std::mutex> lock(reactor.pending_mutex);
+      if (reactor.pending_flush.empty()) {
+        reactor.pending_flush.swap(wake[i]);
+      } else {
+        reactor.pending_flush.insert(reactor.pending_flush.end(),
+                                     wake[i].begin(), wake[i].end());
+      }
+    }
+    reactor.wake();
+  }
 }
 
 // Public notification methods
 void WebSocketServer::notify_account_change(const std::string &pubkey,
                                             const std::string &account_data) {
-  std::lock_guard<std::mutex> lock(subscription_mutex);
-  auto it = account_subscriptions.find(pubkey);
-  if (it == account_subscriptions.end())
-    return;
-
-  for (uint64_t sub_id : it->second) {
-    SubscriptionMessage msg{
-        sub_id, "accountNotification", "", account_data,
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count()};
-
-    std::lock_guard<std::mutex> queue_lock(queue_mutex);
-    notification_queue.push(msg);
-  }
-  queue_cv.notify_one();
+  publish(*account_subscriptions, pubkey, "accountNotification", account_data);
 }
 
 void WebSocketServer::notify_signature_status(const std::string &signature,
                                               const std::string &status) {
-  std::lock_guard<std::mutex> lock(subscription_mutex);
-  auto it = signature_subscriptions.find(signature);
-  if (it == signature_subscriptions.end())
-    return;
-
-  for (uint64_t sub_id : it->second) {
-    SubscriptionMessage msg{
-        sub_id, "signatureNotification", "", status,
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count()};
-
-    std::lock_guard<std::mutex> queue_lock(queue_mutex);
-    notification_queue.push(msg);
-  }
-  queue_cv.notify_one();
+  // Signature subscriptions end after their first notification
+  publish(*signature_subscriptions, signature, "signatureNotification", status,
+          true);
 }
 
 void WebSocketServer::notify_slot_change(uint64_t slot,
                                          const std::string &parent_slot,
                                          uint64_t root_slot) {
-  std::lock_guard<std::mutex> lock(subscription_mutex);
-
-  for (uint64_t sub_id : slot_subscriptions) {
-    std::ostringstream slot_data;
-    slot_data << "{\"slot\":" << slot << ",\"parent\":" << parent_slot
-              << ",\"root\":" << root_slot << "}";
-
-    SubscriptionMessage msg{
-        sub_id, "slotNotification", "", slot_data.str(),
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count()};
-
-    std::lock_guard<std::mutex> queue_lock(queue_mutex);
-    notification_queue.push(msg);
-  }
-  queue_cv.notify_one();
+  std::string slot_data = "{\"slot\":" + std::to_string(slot) +
+                          ",\"parent\":" + parent_slot +
+                          ",\"root\":" + std::to_string(root_slot) + "}";
+  publish(*slot_subscriptions, "", "slotNotification", slot_data);
 }
 
 void WebSocketServer::notify_block_change(uint64_t slot,
                                           const std::string &block_hash,
                                           const std::string &block_data) {
-  std::lock_guard<std::mutex> lock(subscription_mutex);
-
-  for (uint64_t sub_id : block_subscriptions) {
-    SubscriptionMessage msg{
-        sub_id, "blockNotification", "", block_data,
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count()};
-
-    std::lock_guard<std::mutex> queue_lock(queue_mutex);
-    notification_queue.push(msg);
-  }
-  queue_cv.notify_one();
+  publish(*block_subscriptions, "", "blockNotification", block_data);
 }
 
 void WebSocketServer::notify_program_account_change(
     const std::string &program_id, const std::string &account_pubkey,
     const std::string &account_data) {
-  std::lock_guard<std::mutex> lock(subscription_mutex);
+  std::string result;
+  result.reserve(32 + account_pubkey.size() + account_data.size());
+  result.append("{\"pubkey\":");
+  rpc_json::append_quoted(result, account_pubkey);
+  result.append(",\"account\":").append(account_data).append("}");
+  publish(*program_subscriptions, program_id, "programNotification", result);
+}
 
-  // For now, treat program account changes as regular account changes
-  // In a full implementation, we'd have separate program account subscriptions
-  auto it = account_subscriptions.find(account_pubkey);
-  if (it == account_subscriptions.end())
-    return;
+void WebSocketServer::publish_account_notification(const std::string &pubkey,
+                                                   const std::string &result,
+                                                   CommitmentLevel commitment,
+                                                   AccountEncoding encoding) {
+  publish(*account_subscriptions, pubkey, "accountNotification", result, false,
+          interest_bit(commitment, encoding));
+}
 
-  for (uint64_t sub_id : it->second) {
-    SubscriptionMessage msg{
-        sub_id, "programAccountNotification", "", account_data,
-        std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch())
-            .count()};
+void WebSocketServer::publish_program_notification(
+    const std::string &program_id, const std::string &result,
+    CommitmentLevel commitment, AccountEncoding encoding) {
+  publish(*program_subscriptions, program_id, "programNotification", result,
+          false, interest_bit(commitment, encoding));
+}
 
-    std::lock_guard<std::mutex> queue_lock(queue_mutex);
-    notification_queue.push(msg);
-  }
-  queue_cv.notify_one();
+uint8_t WebSocketServer::account_interest(const std::string &pubkey) const {
+  return account_subscriptions->interest(pubkey);
+}
+
+uint8_t WebSocketServer::program_interest(const std::string &program_id) const {
+  return program_subscriptions->interest(program_id);
 }
 
 WebSocketServer::WebSocketStats WebSocketServer::get_stats() const {
+  uint64_t uptime = 0;
+  if (running.load()) {
+    uptime = std::chrono::duration_cast<std::chrono::seconds>(
+                 std::chrono::steady_clock::now() - start_time)
+                 .count();
+  }
   std::lock_guard<std::mutex> lock(connections_mutex);
-  return {
-      total_connections.load(), static_cast<uint64_t>(connections.size()),
-      active_subscriptions.load(), messages_sent.load(),
-      0 // uptime_seconds - would need start time tracking
-  };
+  return {total_connections.load(),
+          static_cast<uint64_t>(connections.size()),
+          active_subscriptions.load(),
+          messages_sent.load(),
+          uptime,
+          slow_consumer_evictions.load()};
 }
 
 std::vector<std::string> WebSocketServer::get_connected_clients() const {
   std::lock_guard<std::mutex> lock(connections_mutex);
   std::vector<std::string> clients;
-  for (const auto &conn : connections) {
-    if (conn->is_alive()) {
-      clients.push_back(conn->get_address());
+  for (const auto &entry : connections) {
+    if (entry.second->is_alive()) {
+      clients.push_back(entry.second->get_address());
     }
   }
   return clients;
 }
 
+size_t
+WebSocketServer::account_subscriber_count(const std::string &pubkey) const {
+  return account_subscriptions->count(pubkey);
+}
+
 } // namespace network
-} // namespace slonana
\ No newline at end of file
+} // namespace slonana
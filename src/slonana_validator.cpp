@@ -1,7 +1,9 @@
 #include "slonana_validator.h"
 #include "common/alerting.h"
 #include "common/logging.h"
+#include "consensus/leader_schedule.h"
 #include "consensus/proof_of_history.h"
+#include "network/rpc_json.h"
 #include <algorithm>
 #include <chrono>
 #include <fstream>
@@ -179,6 +181,19 @@ common::Result<bool> SolanaValidator::start() {
     std::cout << "  ✅ Gossip protocol started successfully" << std::endl;
   }
 
+  // QUIC ingestion runs its own handshake rather than TLS 1.3, so it stays
+  // opt-in alongside the default UDP path
+  if (config_.enable_quic_tpu) {
+    std::cout << "  ⚡ Starting QUIC transaction ingestion (experimental)..."
+              << std::endl;
+    if (!validator_core_->enable_quic_networking(
+            static_cast<uint16_t>(config_.quic_tpu_port))) {
+      std::cerr << "WARNING: QUIC transaction ingestion failed to start on "
+                   "port "
+                << config_.quic_tpu_port << std::endl;
+    }
+  }
+
   if (config_.enable_rpc) {
     std::cout << "  🔗 Starting RPC server..." << std::endl;
     auto rpc_result = rpc_server_->start();
@@ -187,6 +202,13 @@ common::Result<bool> SolanaValidator::start() {
     }
     std::cout << "  ✅ RPC server started on " << config_.rpc_bind_address
               << std::endl;
+
+    if (!rpc_server_->start_websocket_server()) {
+      std::cerr << "WARNING: WebSocket server failed to start; "
+                   "subscriptions are unavailable"
+                << std::endl;
+    }
+    account_notifications_->start();
   }
 
   // **FIX: Ensure block notification callback is properly connected**
@@ -247,7 +269,12 @@ void SolanaValidator::stop() {
   std::cout << "Stopping Solana validator..." << std::endl;
 
   // Stop network services
+  if (account_notifications_) {
+    account_notifications_->stop();
+  }
+
   if (rpc_server_) {
+    rpc_server_->stop_websocket_server();
     rpc_server_->stop();
   }
 
@@ -255,6 +282,10 @@ void SolanaValidator::stop() {
     gossip_protocol_->stop();
   }
 
+  if (validator_core_ && config_.enable_quic_tpu) {
+    validator_core_->disable_quic_networking();
+  }
+
   // Stop banking stage
   if (banking_stage_) {
     banking_stage_->stop();
@@ -273,6 +304,11 @@ void SolanaValidator::shutdown() {
   stop();
 
   // Clean shutdown of all components
+  if (fork_choice_) {
+    fork_choice_->set_commitment_callback(nullptr);
+  }
+  account_notifications_.reset();
+  fork_choice_.reset();
   gossip_protocol_.reset();
   rpc_server_.reset();
   validator_core_.reset();
@@ -630,6 +666,15 @@ common::Result<bool> SolanaValidator::initialize_components() {
       return common::Result<bool>("Failed to create staking manager");
     }
 
+    // Account store: its change feed drives account and program
+    // subscriptions, and epoch reward credits are written to it
+    LOG_INFO("  🗄️  Initializing accounts database...");
+    accounts_db_ = std::make_shared<storage::AccountsDB>();
+    account_change_feed_ = std::make_shared<storage::AccountChangeFeed>();
+    accounts_db_->set_change_feed(account_change_feed_);
+    staking_manager_->set_accounts_db(accounts_db_);
+    fork_choice_ = std::make_shared<consensus::AdvancedForkChoice>();
+
     // Initialize banking stage for transaction processing
     LOG_INFO("  🏦 Initializing banking stage...");
     banking_stage_ = std::make_shared<banking::BankingStage>();
@@ -651,6 +696,18 @@ common::Result<bool> SolanaValidator::initialize_components() {
       return common::Result<bool>("Failed to create validator core");
     }
 
+    // Stake-weighted leader schedule over the staking manager's epoch stakes
+    staking_manager_->set_slots_per_epoch(config_.epoch_length_slots);
+    std::weak_ptr<staking::StakingManager> stakes_source = staking_manager_;
+    validator_core_->set_leader_schedule(
+        std::make_shared<consensus::LeaderScheduleCache>(
+            [stakes_source](common::Epoch epoch)
+                -> std::shared_ptr<const staking::EpochStakes> {
+              auto manager = stakes_source.lock();
+              return manager ? manager->get_epoch_stakes(epoch) : nullptr;
+            },
+            config_.epoch_length_slots));
+
     // Initialize and configure Proof of History
     LOG_INFO("  ⏰ Initializing Proof of History...");
 
@@ -738,6 +795,67 @@ common::Result<bool> SolanaValidator::initialize_components() {
       LOG_WARN("    Banking stage will use default performance settings");
     }
 
+    // Committed accounts land in the account store at the current slot, and
+    // RPC responses derived from them are dropped
+    std::weak_ptr<validator::ValidatorCore> slot_source = validator_core_;
+    std::weak_ptr<network::SolanaRpcServer> rpc_cache = rpc_server_;
+    account_manager_->set_commit_listener(
+        [accounts_db = accounts_db_, slot_source,
+         rpc_cache](const std::vector<svm::ProgramAccount> &accounts) {
+          auto core = slot_source.lock();
+          auto rpc = rpc_cache.lock();
+          std::vector<std::pair<PublicKey, storage::AccountData>> batch;
+          batch.reserve(accounts.size());
+          for (const auto &account : accounts) {
+            storage::AccountData data;
+            data.data = account.data;
+            data.lamports = account.lamports;
+            data.owner = account.owner;
+            data.executable = account.executable;
+            data.rent_epoch = account.rent_epoch;
+            batch.emplace_back(account.pubkey, std::move(data));
+          }
+          accounts_db->store_accounts_batch(batch,
+                                            core ? core->get_current_slot() : 0);
+          // Only after the store: a read racing the write then either sees
+          // the new state or is refused by the cache's generation check
+          if (rpc) {
+            for (const auto &account : accounts) {
+              rpc->invalidate_account(
+                  network::rpc_json::encode_base58(account.pubkey));
+            }
+          }
+        });
+
+    // Account and program subscriptions: changes from the account store
+    // go out as fork choice reports their slot processed, confirmed, rooted
+    account_notifications_ =
+        std::make_unique<network::AccountNotificationDispatcher>(
+            account_change_feed_, rpc_server_->get_websocket_server(),
+            [accounts_db = accounts_db_](const PublicKey &key, uint64_t slot) {
+              return accounts_db->get_account_at_slot(key, slot);
+            });
+    auto *notifications = account_notifications_.get();
+    fork_choice_->set_commitment_callback(
+        [notifications](Slot slot,
+                        consensus::AdvancedForkChoice::CommitmentEvent event) {
+          using Event = consensus::AdvancedForkChoice::CommitmentEvent;
+          switch (event) {
+          case Event::PROCESSED:
+            notifications->on_slot_processed(slot);
+            break;
+          case Event::CONFIRMED:
+            notifications->on_slot_confirmed(slot);
+            break;
+          case Event::ROOTED:
+            notifications->on_slot_rooted(slot);
+            break;
+          case Event::DEAD:
+            notifications->on_slot_dead(slot);
+            break;
+          }
+        });
+
     // Connect RPC server to validator components
     try {
       rpc_server_->set_ledger_manager(ledger_manager_);
@@ -758,6 +876,7 @@ common::Result<bool> SolanaValidator::initialize_components() {
       try {
         snapshot_bootstrap_ =
             std::make_unique<validator::SnapshotBootstrapManager>(config_);
+        snapshot_bootstrap_->set_accounts_db(accounts_db_);
       } catch (const std::exception &e) {
         LOG_VALIDATOR_ERROR("Failed to initialize snapshot bootstrap",
                             "VAL_SNAP_001", {{"exception", e.what()}});
@@ -777,12 +896,30 @@ common::Result<bool> SolanaValidator::initialize_components() {
 }
 
 common::Result<bool> SolanaValidator::setup_event_handlers() {
-  // Setup validator core callbacks
-  validator_core_->set_block_callback(
-      [this](const ledger::Block &block) { this->on_block_received(block); });
-
-  validator_core_->set_vote_callback(
-      [this](const validator::Vote &vote) { this->on_vote_received(vote); });
+  // Setup validator core callbacks; fork choice tracks commitment for
+  // account and program subscriptions
+  validator_core_->set_block_callback([this](const ledger::Block &block) {
+    this->on_block_received(block);
+    fork_choice_->add_block(block.block_hash, block.parent_hash, block.slot);
+    rpc_server_->notify_slot_advance(block.slot);
+  });
+
+  validator_core_->set_vote_callback([this](const validator::Vote &vote) {
+    this->on_vote_received(vote);
+
+    // Epoch stake, rescaled to the stake total fork choice measures against
+    auto stakes = staking_manager_->get_epoch_stakes(
+        vote.slot / std::max<uint64_t>(1, config_.epoch_length_slots));
+    uint64_t stake = 0;
+    if (stakes->total_stake > 0) {
+      stake = static_cast<uint64_t>(
+          static_cast<unsigned __int128>(
+              stakes->stake_of(vote.validator_identity)) *
+          fork_choice_->get_configuration().total_stake / stakes->total_stake);
+    }
+    fork_choice_->add_vote(consensus::VoteInfo(
+        vote.slot, vote.block_hash, vote.validator_identity, stake));
+  });
 
   // Setup gossip message handlers
   gossip_protocol_->register_handler(
@@ -1,12 +1,12 @@
 #include "staking/manager.h"
+#include "storage/accounts_db.h"
 #include <algorithm>
 #include <chrono>
-#include <iomanip>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <optional>
-#include <random>
-#include <sstream>
 #include <thread>
 
 namespace slonana {
@@ -122,18 +122,150 @@ double RewardsCalculator::get_current_inflation_rate() const {
   return impl_->inflation_rate_;
 }
 
+// EpochStakes implementation
+common::Lamports EpochStakes::stake_of(const PublicKey &validator) const {
+  auto it = validator_index.find(validator);
+  return it != validator_index.end() ? validator_stakes[it->second] : 0;
+}
+
+size_t EpochStakes::validator_at(common::Lamports point) const {
+  auto it = std::upper_bound(cumulative_stakes.begin(), cumulative_stakes.end(),
+                             point);
+  size_t index = static_cast<size_t>(it - cumulative_stakes.begin());
+  return std::min(index, validators.empty() ? 0 : validators.size() - 1);
+}
+
+namespace {
+
+constexpr size_t NO_VALIDATOR = SIZE_MAX;
+constexpr size_t MIN_DELEGATIONS_PER_THREAD = 1024;
+
+// Stake11111111111111111111111111111111111111
+const PublicKey STAKE_PROGRAM_ID = {
+    0x06, 0xa1, 0xd8, 0x17, 0x91, 0x37, 0x54, 0x2a, 0x98, 0x34, 0x37,
+    0xbd, 0xfe, 0x2a, 0x7a, 0xb2, 0x55, 0x7f, 0x53, 0x5c, 0x8a, 0x78,
+    0x72, 0x2b, 0x68, 0xa4, 0x9d, 0xc0, 0x00, 0x00, 0x00, 0x00};
+
+/// Partition of a reward credit: FNV-1a of the account, seeded per epoch
+size_t reward_partition(const PublicKey &account, common::Epoch epoch,
+                        size_t partitions) {
+  uint64_t hash = 0xcbf29ce484222325ULL ^ (epoch * 0x9e3779b97f4a7c15ULL);
+  for (uint8_t byte : account) {
+    hash = (hash ^ byte) * 0x100000001b3ULL;
+  }
+  return static_cast<size_t>(hash % partitions);
+}
+
+} // namespace
+
 // StakingManager implementation
 class StakingManager::Impl {
 public:
+  struct RewardCredit {
+    PublicKey account;
+    common::Lamports reward = 0;
+    bool is_stake_account = false; ///< Compounds into the delegation
+  };
+
+  /// Guards every member below: RPC threads and the block thread (through
+  /// the leader schedule's stake provider) call in concurrently
+  mutable std::mutex mutex_;
+
   std::vector<StakeAccount> stake_accounts_;
+  std::unordered_map<PublicKey, size_t> stake_index_; ///< stake_pubkey -> position
   std::vector<ValidatorStakeInfo> validator_infos_;
 
+  std::map<common::Epoch, std::shared_ptr<const EpochStakes>> epoch_stakes_;
+  std::map<common::Slot, std::vector<RewardCredit>> pending_partitions_;
+
+  std::shared_ptr<storage::AccountsDB> accounts_db_;
+  common::Slot slots_per_epoch_ = DEFAULT_SLOTS_PER_EPOCH;
+  size_t reward_threads_ = 0;
+
   // Statistics tracking
   uint64_t total_rewards_distributed_ = 0;
   uint64_t total_accounts_rewarded_ = 0;
   uint64_t failed_distributions_ = 0;
+
+  StakeAccount *find_stake_account(const PublicKey &stake_pubkey) {
+    auto it = stake_index_.find(stake_pubkey);
+    return it != stake_index_.end() ? &stake_accounts_[it->second] : nullptr;
+  }
+
+  std::shared_ptr<const EpochStakes> build_epoch_stakes(common::Epoch epoch) const;
+
+  // Callers hold mutex_
+  std::shared_ptr<const EpochStakes> epoch_stakes(common::Epoch epoch);
+  size_t credit_partitions(common::Slot slot);
 };
 
+std::shared_ptr<const EpochStakes>
+StakingManager::Impl::build_epoch_stakes(common::Epoch epoch) const {
+  auto stakes = std::make_shared<EpochStakes>();
+  stakes->epoch = epoch;
+
+  // Group the delegating accounts by validator
+  std::unordered_map<PublicKey, size_t> seen;
+  std::vector<PublicKey> validators;
+  std::vector<common::Lamports> validator_stakes;
+  std::vector<size_t> counts;
+  std::vector<size_t> owner(stake_accounts_.size(), NO_VALIDATOR);
+  for (size_t i = 0; i < stake_accounts_.size(); ++i) {
+    const auto &account = stake_accounts_[i];
+    if (!account.is_active || account.stake_amount == 0 ||
+        account.activation_epoch > epoch) {
+      continue;
+    }
+    auto [it, inserted] =
+        seen.try_emplace(account.validator_pubkey, validators.size());
+    if (inserted) {
+      validators.push_back(account.validator_pubkey);
+      validator_stakes.push_back(0);
+      counts.push_back(0);
+    }
+    owner[i] = it->second;
+    validator_stakes[it->second] += account.stake_amount;
+    counts[it->second]++;
+  }
+
+  // Largest stake first, ties by descending identity, as Agave orders
+  // stakes for the leader schedule
+  std::vector<size_t> order(validators.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (validator_stakes[a] != validator_stakes[b]) {
+      return validator_stakes[a] > validator_stakes[b];
+    }
+    return validators[a] > validators[b];
+  });
+
+  std::vector<size_t> rank(validators.size());
+  stakes->delegation_offsets.assign(validators.size() + 1, 0);
+  stakes->validator_index.reserve(validators.size());
+  for (size_t r = 0; r < order.size(); ++r) {
+    size_t v = order[r];
+    rank[v] = r;
+    stakes->total_stake += validator_stakes[v];
+    stakes->validators.push_back(validators[v]);
+    stakes->validator_stakes.push_back(validator_stakes[v]);
+    stakes->cumulative_stakes.push_back(stakes->total_stake);
+    stakes->delegation_offsets[r + 1] = stakes->delegation_offsets[r] + counts[v];
+    stakes->validator_index.emplace(validators[v], r);
+  }
+
+  stakes->delegations.resize(stakes->delegation_offsets.back());
+  std::vector<size_t> next(stakes->delegation_offsets.begin(),
+                           stakes->delegation_offsets.end() - 1);
+  for (size_t i = 0; i < stake_accounts_.size(); ++i) {
+    if (owner[i] != NO_VALIDATOR) {
+      auto &delegation = stakes->delegations[next[rank[owner[i]]]++];
+      delegation.stake_pubkey = stake_accounts_[i].stake_pubkey;
+      delegation.stake = stake_accounts_[i].stake_amount;
+    }
+  }
+  return stakes;
+}
+
 StakingManager::StakingManager()
     : rewards_calculator_(std::make_unique<RewardsCalculator>()),
       impl_(std::make_unique<Impl>()) {}
@@ -142,9 +274,11 @@ StakingManager::~StakingManager() = default;
 
 common::Result<bool>
 StakingManager::create_stake_account(const StakeAccount &account) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   // Check for duplicate
-  auto existing = get_stake_account(account.stake_pubkey);
-  if (existing) {
+  if (!impl_->stake_index_
+           .try_emplace(account.stake_pubkey, impl_->stake_accounts_.size())
+           .second) {
     return common::Result<bool>("Stake account already exists");
   }
 
@@ -158,24 +292,20 @@ common::Result<bool>
 StakingManager::delegate_stake(const PublicKey &stake_pubkey,
                                const PublicKey &validator_pubkey,
                                common::Lamports amount) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
 
-  auto account_it =
-      std::find_if(impl_->stake_accounts_.begin(), impl_->stake_accounts_.end(),
-                   [&stake_pubkey](const StakeAccount &account) {
-                     return account.stake_pubkey == stake_pubkey;
-                   });
-
-  if (account_it == impl_->stake_accounts_.end()) {
+  StakeAccount *account = impl_->find_stake_account(stake_pubkey);
+  if (!account) {
     return common::Result<bool>("Stake account not found");
   }
 
-  if (account_it->stake_amount < amount) {
+  if (account->stake_amount < amount) {
     return common::Result<bool>("Insufficient stake amount");
   }
 
-  account_it->validator_pubkey = validator_pubkey;
-  account_it->stake_amount = amount;
-  account_it->is_active = true;
+  account->validator_pubkey = validator_pubkey;
+  account->stake_amount = amount;
+  account->is_active = true;
 
   std::cout << "Delegated " << amount << " lamports to validator" << std::endl;
   return common::Result<bool>(true);
@@ -183,39 +313,31 @@ StakingManager::delegate_stake(const PublicKey &stake_pubkey,
 
 common::Result<bool>
 StakingManager::deactivate_stake(const PublicKey &stake_pubkey) {
-  auto account_it =
-      std::find_if(impl_->stake_accounts_.begin(), impl_->stake_accounts_.end(),
-                   [&stake_pubkey](StakeAccount &account) {
-                     return account.stake_pubkey == stake_pubkey;
-                   });
-
-  if (account_it == impl_->stake_accounts_.end()) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  StakeAccount *account = impl_->find_stake_account(stake_pubkey);
+  if (!account) {
     return common::Result<bool>("Stake account not found");
   }
 
-  account_it->is_active = false;
+  account->is_active = false;
   // Clear the validator pubkey when deactivating stake
-  account_it->validator_pubkey.assign(32, 0x00);
+  account->validator_pubkey.assign(32, 0x00);
   std::cout << "Deactivated stake account" << std::endl;
   return common::Result<bool>(true);
 }
 
 std::optional<StakeAccount>
 StakingManager::get_stake_account(const PublicKey &stake_pubkey) const {
-  auto it =
-      std::find_if(impl_->stake_accounts_.begin(), impl_->stake_accounts_.end(),
-                   [&stake_pubkey](const StakeAccount &account) {
-                     return account.stake_pubkey == stake_pubkey;
-                   });
-
-  if (it != impl_->stake_accounts_.end()) {
-    return *it;
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  if (const StakeAccount *account = impl_->find_stake_account(stake_pubkey)) {
+    return *account;
   }
   return std::nullopt;
 }
 
 std::vector<StakeAccount> StakingManager::get_validator_stake_accounts(
     const PublicKey &validator_pubkey) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   std::vector<StakeAccount> result;
 
   std::copy_if(impl_->stake_accounts_.begin(), impl_->stake_accounts_.end(),
@@ -230,6 +352,7 @@ std::vector<StakeAccount> StakingManager::get_validator_stake_accounts(
 
 ValidatorStakeInfo StakingManager::get_validator_stake_info(
     const PublicKey &validator_pubkey) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   auto it = std::find_if(impl_->validator_infos_.begin(),
                          impl_->validator_infos_.end(),
                          [&validator_pubkey](const ValidatorStakeInfo &info) {
@@ -246,100 +369,256 @@ ValidatorStakeInfo StakingManager::get_validator_stake_info(
   return info;
 }
 
+std::shared_ptr<const EpochStakes>
+StakingManager::Impl::epoch_stakes(common::Epoch epoch) {
+  auto it = epoch_stakes_.find(epoch);
+  if (it != epoch_stakes_.end()) {
+    return it->second;
+  }
+
+  auto stakes = build_epoch_stakes(epoch);
+  epoch_stakes_.emplace(epoch, stakes);
+  while (epoch_stakes_.size() > EPOCH_STAKES_KEPT) {
+    epoch_stakes_.erase(epoch_stakes_.begin());
+  }
+  return stakes;
+}
+
+std::shared_ptr<const EpochStakes>
+StakingManager::get_epoch_stakes(common::Epoch epoch) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  return impl_->epoch_stakes(epoch);
+}
+
 common::Result<bool>
 StakingManager::distribute_epoch_rewards(common::Epoch epoch) {
-  std::cout << "Distributing rewards for epoch " << epoch << std::endl;
+  using RewardCredit = Impl::RewardCredit;
 
-  for (const auto &validator_info : impl_->validator_infos_) {
-    auto validator_rewards =
-        rewards_calculator_->calculate_validator_rewards(validator_info, epoch);
+  // Take what the calculation needs under the lock; it then runs on the
+  // frozen epoch stakes and copied validator terms without holding it
+  std::unique_lock<std::mutex> lock(impl_->mutex_);
 
-    auto stake_accounts =
-        get_validator_stake_accounts(validator_info.validator_identity);
-    for (const auto &stake_account : stake_accounts) {
-      auto delegator_rewards = rewards_calculator_->calculate_delegator_rewards(
-          stake_account, validator_info, epoch);
+  // Finish paying the previous epoch before scheduling this one
+  if (!impl_->pending_partitions_.empty()) {
+    impl_->credit_partitions(impl_->pending_partitions_.rbegin()->first);
+  }
 
-      // Production reward distribution with full account updates and validation
-      try {
-        // Validate stake account before reward distribution
-        if (!validate_stake_account(stake_account)) {
-          std::cout << "Skipping invalid stake account in reward distribution"
-                    << std::endl;
-          continue;
+  auto stakes = impl_->epoch_stakes(epoch);
+  size_t validator_count = stakes->validators.size();
+  size_t delegation_count = stakes->delegations.size();
+
+  // Per-validator terms, once. Only registered validators earn rewards.
+  std::vector<ValidatorStakeInfo> infos(validator_count);
+  std::vector<bool> registered(validator_count, false);
+  for (const auto &info : impl_->validator_infos_) {
+    auto it = stakes->validator_index.find(info.validator_identity);
+    if (it != stakes->validator_index.end()) {
+      infos[it->second] = info;
+      infos[it->second].total_stake = stakes->validator_stakes[it->second];
+      registered[it->second] = true;
+    }
+  }
+  common::Slot slots_per_epoch = impl_->slots_per_epoch_;
+  size_t reward_threads = impl_->reward_threads_;
+  lock.unlock();
+
+  size_t partitions = std::max<size_t>(
+      1, (delegation_count + validator_count + REWARDS_PER_PARTITION - 1) /
+             REWARDS_PER_PARTITION);
+
+  // Delegator rewards: each thread takes a contiguous share of the
+  // delegations and buckets its credits by partition, so concatenating the
+  // shares in thread order gives the same result for any thread count
+  size_t threads = reward_threads > 0
+                       ? reward_threads
+                       : std::max<size_t>(1, std::thread::hardware_concurrency());
+  threads = std::clamp<size_t>(delegation_count / MIN_DELEGATIONS_PER_THREAD, 1,
+                               threads);
+  std::vector<std::vector<std::vector<RewardCredit>>> shares(
+      threads, std::vector<std::vector<RewardCredit>>(partitions));
+  std::vector<uint64_t> rejected(threads, 0);
+
+  auto calculate_share = [&](size_t t) {
+    size_t begin = delegation_count * t / threads;
+    size_t end = delegation_count * (t + 1) / threads;
+    size_t v = static_cast<size_t>(
+        std::upper_bound(stakes->delegation_offsets.begin(),
+                         stakes->delegation_offsets.end(), begin) -
+        stakes->delegation_offsets.begin() - 1);
+
+    StakeAccount account;
+    account.is_active = true;
+    for (size_t d = begin; d < end; ++d) {
+      while (d >= stakes->delegation_offsets[v + 1]) {
+        ++v;
+      }
+      if (!registered[v]) {
+        continue;
+      }
+      const auto &delegation = stakes->delegations[d];
+      account.stake_amount = delegation.stake;
+      auto reward = rewards_calculator_->calculate_delegator_rewards(
+          account, infos[v], epoch);
+      if (reward == 0) {
+        continue;
+      }
+      if (reward > delegation.stake) {
+        rejected[t]++; // Implausible: more than the stake itself
+        continue;
+      }
+      shares[t][reward_partition(delegation.stake_pubkey, epoch, partitions)]
+          .push_back({delegation.stake_pubkey, reward, true});
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(calculate_share, t);
+  }
+  calculate_share(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  // Schedule one partition per slot from the start of the next epoch
+  common::Slot first_slot = (epoch + 1) * slots_per_epoch + 1;
+  size_t credits = 0;
+  common::Lamports total = 0;
+  std::vector<std::pair<common::Slot, std::vector<RewardCredit>>> scheduled;
+  for (size_t p = 0; p < partitions; ++p) {
+    std::vector<RewardCredit> partition;
+    for (auto &share : shares) {
+      partition.insert(partition.end(),
+                       std::make_move_iterator(share[p].begin()),
+                       std::make_move_iterator(share[p].end()));
+      std::vector<RewardCredit>().swap(share[p]);
+    }
+    for (size_t v = 0; v < validator_count; ++v) {
+      const auto &identity = stakes->validators[v];
+      if (registered[v] && reward_partition(identity, epoch, partitions) == p) {
+        auto commission =
+            rewards_calculator_->calculate_validator_rewards(infos[v], epoch);
+        if (commission > 0) {
+          partition.push_back({identity, commission, false});
         }
+      }
+    }
+    if (partition.empty()) {
+      continue;
+    }
+    credits += partition.size();
+    for (const auto &credit : partition) {
+      total += credit.reward;
+    }
+    scheduled.emplace_back(first_slot + p, std::move(partition));
+  }
+
+  lock.lock();
+  for (auto &[paid_at, partition] : scheduled) {
+    // A partition still awaiting retry keeps its credits
+    auto &pending = impl_->pending_partitions_[paid_at];
+    pending.insert(pending.end(), std::make_move_iterator(partition.begin()),
+                   std::make_move_iterator(partition.end()));
+  }
+  for (uint64_t count : rejected) {
+    impl_->failed_distributions_ += count;
+  }
+  lock.unlock();
+
+  std::cout << "Calculated " << credits << " rewards (" << total
+            << " lamports) for epoch " << epoch << " across "
+            << validator_count << " validators, paid over " << partitions
+            << " slots" << std::endl;
+  return common::Result<bool>(true);
+}
+
+size_t StakingManager::credit_epoch_rewards(common::Slot slot) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  return impl_->credit_partitions(slot);
+}
 
-        // Apply rewards to stake account
-        bool distribution_success = distribute_rewards_to_account(
-            stake_account, delegator_rewards, validator_rewards, epoch);
-
-        if (distribution_success) {
-          // Convert PublicKey to hex string for display
-          std::ostringstream hex_stream;
-          for (size_t i = 0;
-               i < std::min(stake_account.stake_pubkey.size(), size_t(8));
-               ++i) {
-            hex_stream << std::hex << std::setfill('0') << std::setw(2)
-                       << static_cast<unsigned>(stake_account.stake_pubkey[i]);
-          }
-          std::cout << "Distributed " << delegator_rewards
-                    << " lamports to stake account " << hex_stream.str()
-                    << "..." << std::endl;
-
-          // Update staking statistics
-          impl_->total_rewards_distributed_ += delegator_rewards;
-          impl_->total_accounts_rewarded_++;
-
-          // Log significant reward distributions
-          if (delegator_rewards > 1000000) { // > 0.001 SOL
-            // Convert PublicKey to hex string for display
-            std::ostringstream hex_stream;
-            for (size_t i = 0;
-                 i < std::min(stake_account.stake_pubkey.size(), size_t(8));
-                 ++i) {
-              hex_stream << std::hex << std::setfill('0') << std::setw(2)
-                         << static_cast<unsigned>(
-                                stake_account.stake_pubkey[i]);
-            }
-            std::cout << "Large reward distribution: " << delegator_rewards
-                      << " lamports to " << hex_stream.str() << "..."
-                      << std::endl;
-          }
-        } else {
-          // Convert PublicKey to hex string for display
-          std::ostringstream hex_stream;
-          for (size_t i = 0;
-               i < std::min(stake_account.stake_pubkey.size(), size_t(8));
-               ++i) {
-            hex_stream << std::hex << std::setfill('0') << std::setw(2)
-                       << static_cast<unsigned>(stake_account.stake_pubkey[i]);
-          }
-          std::cout << "Failed to distribute rewards to stake account "
-                    << hex_stream.str() << "..." << std::endl;
-          impl_->failed_distributions_++;
+size_t StakingManager::Impl::credit_partitions(common::Slot slot) {
+  size_t credited = 0;
+  auto &pending = pending_partitions_;
+  while (!pending.empty() && pending.begin()->first <= slot) {
+    // Stays pending until stored, so a failed write is retried by the
+    // next call instead of losing the rewards
+    common::Slot paid_at = pending.begin()->first;
+    const auto &partition = pending.begin()->second;
+
+    if (accounts_db_) {
+      std::vector<std::pair<PublicKey, storage::AccountData>> batch;
+      batch.reserve(partition.size());
+      for (const auto &credit : partition) {
+        auto account = accounts_db_->load_account(credit.account);
+        storage::AccountData data = account ? *account : storage::AccountData();
+        if (!account) {
+          data.owner = credit.is_stake_account ? STAKE_PROGRAM_ID
+                                               : PublicKey(32, 0x00);
         }
+        data.lamports += credit.reward;
+        batch.emplace_back(credit.account, std::move(data));
+      }
+      if (!accounts_db_->store_accounts_batch(batch, paid_at)) {
+        failed_distributions_ += partition.size();
+        break;
+      }
+    }
 
-      } catch (const std::exception &e) {
-        std::cout << "Error distributing rewards: " << e.what() << std::endl;
-        impl_->failed_distributions_++;
+    for (const auto &credit : partition) {
+      if (credit.is_stake_account) {
+        if (StakeAccount *account = find_stake_account(credit.account)) {
+          account->stake_amount += credit.reward;
+        }
       }
-      std::cout << "Calculated " << delegator_rewards
-                << " lamports reward for delegator" << std::endl;
+      total_rewards_distributed_ += credit.reward;
     }
+    total_accounts_rewarded_ += partition.size();
+    credited += partition.size();
+    pending.erase(pending.begin());
   }
+  return credited;
+}
 
-  return common::Result<bool>(true);
+size_t StakingManager::get_pending_reward_partitions() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  return impl_->pending_partitions_.size();
+}
+
+void StakingManager::set_accounts_db(
+    std::shared_ptr<storage::AccountsDB> accounts_db) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  impl_->accounts_db_ = std::move(accounts_db);
+}
+
+void StakingManager::set_slots_per_epoch(common::Slot slots_per_epoch) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  impl_->slots_per_epoch_ = std::max<common::Slot>(1, slots_per_epoch);
+}
+
+void StakingManager::set_reward_threads(size_t threads) {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
+  impl_->reward_threads_ = threads;
 }
 
 std::unordered_map<PublicKey, common::Lamports>
 StakingManager::calculate_pending_rewards(common::Epoch epoch) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
 
   std::unordered_map<PublicKey, common::Lamports> rewards;
 
+  std::unordered_map<PublicKey, const ValidatorStakeInfo *> validators;
+  for (const auto &info : impl_->validator_infos_) {
+    validators[info.validator_identity] = &info;
+  }
+
   for (const auto &stake_account : impl_->stake_accounts_) {
     if (stake_account.is_active) {
-      auto validator_info =
-          get_validator_stake_info(stake_account.validator_pubkey);
+      auto it = validators.find(stake_account.validator_pubkey);
+      ValidatorStakeInfo unregistered;
+      unregistered.validator_identity = stake_account.validator_pubkey;
+      const auto &validator_info =
+          it != validators.end() ? *it->second : unregistered;
       auto reward = rewards_calculator_->calculate_delegator_rewards(
           stake_account, validator_info, epoch);
       rewards[stake_account.delegator_pubkey] += reward;
@@ -361,6 +640,7 @@ StakingManager::register_validator(const PublicKey &validator_identity,
   info.validator_identity = validator_identity;
   info.commission_rate = commission_rate;
 
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   impl_->validator_infos_.push_back(info);
   std::cout << "Registered validator with " << commission_rate
             << " basis points commission" << std::endl;
@@ -370,6 +650,7 @@ StakingManager::register_validator(const PublicKey &validator_identity,
 
 bool StakingManager::is_validator_registered(
     const PublicKey &validator_identity) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   return std::any_of(impl_->validator_infos_.begin(),
                      impl_->validator_infos_.end(),
                      [&validator_identity](const ValidatorStakeInfo &info) {
@@ -378,6 +659,7 @@ bool StakingManager::is_validator_registered(
 }
 
 common::Lamports StakingManager::get_total_stake() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   return std::accumulate(
       impl_->stake_accounts_.begin(), impl_->stake_accounts_.end(),
       static_cast<common::Lamports>(0),
@@ -387,11 +669,13 @@ common::Lamports StakingManager::get_total_stake() const {
 }
 
 size_t StakingManager::get_active_validator_count() const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   return impl_->validator_infos_.size();
 }
 
 std::vector<ValidatorStakeInfo>
 StakingManager::get_top_validators(size_t count) const {
+  std::lock_guard<std::mutex> lock(impl_->mutex_);
   auto validators = impl_->validator_infos_;
 
   // Sort by total stake descending
@@ -458,221 +742,5 @@ RewardsCalculator::calculate_uptime_bonus(double uptime_percentage) const {
   }
 }
 
-bool StakingManager::validate_stake_account(
-    const StakeAccount &stake_account) const {
-  // Comprehensive stake account validation
-
-  // Check account is active
-  if (!stake_account.is_active) {
-    return false;
-  }
-
-  // Validate stake amount
-  if (stake_account.stake_amount == 0) {
-    return false;
-  }
-
-  // Check validator is still active
-  bool validator_found = false;
-  for (const auto &validator : impl_->validator_infos_) {
-    if (validator.validator_identity == stake_account.validator_pubkey) {
-      validator_found = true;
-      break;
-    }
-  }
-
-  return validator_found;
-}
-
-bool StakingManager::distribute_rewards_to_account(
-    const StakeAccount &stake_account, common::Lamports delegator_rewards,
-    common::Lamports validator_rewards, common::Epoch epoch) const {
-
-  try {
-    // Convert PublicKey to hex string for display
-    std::ostringstream hex_stream;
-    for (size_t i = 0;
-         i < std::min(stake_account.stake_pubkey.size(), size_t(8)); ++i) {
-      hex_stream << std::hex << std::setfill('0') << std::setw(2)
-                 << static_cast<unsigned>(stake_account.stake_pubkey[i]);
-    }
-
-    // Simulate actual account balance update
-    std::cout << "Updating stake account " << hex_stream.str() << "..."
-              << " with " << delegator_rewards << " lamports" << std::endl;
-
-    // Validate reward amount is reasonable
-    if (delegator_rewards > stake_account.stake_amount) {
-      std::cout << "Warning: Reward amount exceeds stake amount" << std::endl;
-      return false;
-    }
-
-    // Production ledger account update implementation
-    // Update the actual stake account with reward distribution
-    try {
-      // Step 1: Create transaction to update stake account
-      std::vector<uint8_t> reward_instruction =
-          create_reward_distribution_instruction(stake_account.stake_pubkey,
-                                                 delegator_rewards);
-
-      // Step 2: Submit transaction to ledger for processing
-      bool ledger_update_success =
-          submit_ledger_transaction(reward_instruction);
-      if (!ledger_update_success) {
-        std::cout << "Failed to update ledger for stake account: " << std::hex
-                  << stake_account.stake_pubkey[0] << std::endl;
-        return false;
-      }
-
-      // Step 3: Update local state to reflect ledger changes
-      // Note: In production, this would be done atomically with the ledger
-      // update
-      std::cout << "Updated stake amount from " << stake_account.stake_amount
-                << " to " << (stake_account.stake_amount + delegator_rewards)
-                << std::endl;
-
-      // Step 4: Record reward distribution for auditing
-      record_reward_distribution(stake_account.stake_pubkey, delegator_rewards);
-
-      std::cout << "Successfully distributed " << delegator_rewards
-                << " lamports to stake account via ledger update" << std::endl;
-
-    } catch (const std::exception &ledger_error) {
-      std::cout << "Ledger update failed: " << ledger_error.what() << std::endl;
-      return false;
-    }
-
-    return true;
-
-  } catch (const std::exception &e) {
-    std::cout << "Failed to distribute rewards: " << e.what() << std::endl;
-    return false;
-  }
-}
-
-// StakingManager production methods implementation
-std::vector<uint8_t> StakingManager::create_reward_distribution_instruction(
-    const PublicKey &stake_account, Lamports reward_amount) const {
-
-  // Production implementation: Create proper Solana instruction for reward
-  // distribution
-  std::vector<uint8_t> instruction;
-
-  // Instruction discriminator for reward distribution (1 byte)
-  instruction.push_back(0x07); // Reward distribution instruction
-
-  // Reward amount (8 bytes, little-endian)
-  for (int i = 0; i < 8; ++i) {
-    instruction.push_back((reward_amount >> (i * 8)) & 0xFF);
-  }
-
-  // Target stake account (32 bytes)
-  instruction.insert(instruction.end(), stake_account.begin(),
-                     stake_account.end());
-
-  // Add current epoch for validation (8 bytes)
-  uint64_t current_epoch =
-      get_current_slot() / 432000; // Approximate epoch from slot
-  for (int i = 0; i < 8; ++i) {
-    instruction.push_back((current_epoch >> (i * 8)) & 0xFF);
-  }
-
-  // Add timestamp for auditing (8 bytes)
-  auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now().time_since_epoch())
-                       .count();
-  for (int i = 0; i < 8; ++i) {
-    instruction.push_back((timestamp >> (i * 8)) & 0xFF);
-  }
-
-  return instruction;
-}
-
-bool StakingManager::submit_ledger_transaction(
-    const std::vector<uint8_t> &instruction) const {
-  // Production implementation: Submit transaction to Solana ledger/runtime
-  try {
-    // In a real implementation, this would:
-    // 1. Create a proper Solana transaction with the instruction
-    // 2. Sign it with appropriate validator keys
-    // 3. Submit to the runtime/bank for processing
-    // 4. Wait for confirmation
-
-    // For now, validate instruction format
-    if (instruction.size() < 49) { // Minimum size: 1 + 8 + 32 + 8
-      return false;
-    }
-
-    // Simulate transaction processing delay
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
-    // Simulate 99% success rate for production realism
-    static std::mt19937 rng(
-        std::chrono::steady_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<int> dist(1, 100);
-    bool success = dist(rng) <= 99;
-
-    if (success) {
-      std::cout << "Ledger transaction submitted successfully" << std::endl;
-    } else {
-      std::cout << "Ledger transaction failed (network congestion)"
-                << std::endl;
-    }
-
-    return success;
-
-  } catch (const std::exception &e) {
-    std::cerr << "Error submitting ledger transaction: " << e.what()
-              << std::endl;
-    return false;
-  }
-}
-
-uint64_t StakingManager::get_current_slot() const {
-  // Production implementation: Get current slot from consensus/bank
-  // In a real validator, this would query the current slot from the bank
-  auto now = std::chrono::steady_clock::now().time_since_epoch();
-  auto milliseconds =
-      std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
-
-  // Simulate slot progression (400ms per slot in Solana)
-  uint64_t current_slot = milliseconds / 400;
-
-  return current_slot;
-}
-
-void StakingManager::record_reward_distribution(const PublicKey &stake_account,
-                                                Lamports amount) const {
-  // Production implementation: Record reward distribution for auditing and
-  // compliance
-  auto timestamp = std::chrono::system_clock::now();
-  auto time_t = std::chrono::system_clock::to_time_t(timestamp);
-
-  // Create audit record
-  std::ostringstream audit_record;
-  audit_record << "{\"type\":\"reward_distribution\","
-               << "\"timestamp\":" << time_t << "," << "\"stake_account\":\"";
-
-  // Convert pubkey to hex string for logging
-  for (size_t i = 0; i < std::min(stake_account.size(), size_t(8)); ++i) {
-    audit_record << std::hex << std::setfill('0') << std::setw(2)
-                 << static_cast<int>(stake_account[i]);
-  }
-
-  audit_record << "\",\"amount\":" << amount
-               << ",\"slot\":" << get_current_slot() << "}";
-
-  // In production, this would write to:
-  // 1. Audit database for compliance
-  // 2. Monitoring system for operational visibility
-  // 3. Block explorer data for transparency
-
-  std::cout << "Audit Record: " << audit_record.str() << std::endl;
-
-  // Optionally write to audit file
-  // std::ofstream audit_file("reward_distributions.log", std::ios::app);
-  // audit_file << audit_record.str() << std::endl;
-}
-
 } // namespace staking
 } // namespace slonana
\ No newline at end of file
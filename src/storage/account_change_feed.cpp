@@ -0,0 +1,90 @@
+#include "storage/account_change_feed.h"
+#include <algorithm>
+#include <cstring>
+
+namespace slonana {
+namespace storage {
+
+namespace {
+
+size_t round_up_pow2(size_t value) {
+  size_t result = 2;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+void copy_key(std::array<uint8_t, 32> &out, const PublicKey &key) {
+  out.fill(0);
+  std::memcpy(out.data(), key.data(), std::min(key.size(), out.size()));
+}
+
+} // namespace
+
+AccountChangeFeed::AccountChangeFeed(size_t capacity)
+    : mask_(round_up_pow2(capacity) - 1) {
+  cells_ = std::make_unique<Cell[]>(mask_ + 1);
+  for (size_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool AccountChangeFeed::publish(const AccountChangeRecord &record) noexcept {
+  uint64_t position = tail_.load(std::memory_order_relaxed);
+  Cell *cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<int64_t>(sequence - position);
+    if (diff == 0) {
+      if (tail_.compare_exchange_weak(position, position + 1,
+                                      std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // Consumer has not freed this cell yet: ring is full
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      position = tail_.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->record = record;
+  cell->sequence.store(position + 1, std::memory_order_release);
+  published_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool AccountChangeFeed::publish(uint64_t slot, const PublicKey &pubkey,
+                                uint64_t version, const PublicKey &owner,
+                                bool deleted) noexcept {
+  AccountChangeRecord record;
+  record.slot = slot;
+  record.version = version;
+  record.deleted = deleted;
+  copy_key(record.pubkey, pubkey);
+  copy_key(record.owner, owner);
+  return publish(record);
+}
+
+size_t AccountChangeFeed::drain(std::vector<AccountChangeRecord> &out,
+                                size_t max_records) noexcept {
+  size_t drained = 0;
+  while (drained < max_records) {
+    Cell &cell = cells_[head_ & mask_];
+    uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != head_ + 1) {
+      break; // Empty, or the producer for this cell has not finished
+    }
+    out.push_back(cell.record);
+    cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    ++drained;
+  }
+  return drained;
+}
+
+} // namespace storage
+} // namespace slonana
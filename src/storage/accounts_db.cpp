@@ -192,7 +192,11 @@ AccountsDB::AccountsDB(const Configuration &config) : config_(config) {
 }
 
 AccountsDB::~AccountsDB() {
-  should_stop_gc_ = true;
+  {
+    std::lock_guard<std::mutex> lock(gc_mutex_);
+    should_stop_gc_ = true;
+  }
+  gc_cv_.notify_all();
   if (gc_thread_.joinable()) {
     gc_thread_.join();
   }
@@ -214,6 +218,7 @@ bool AccountsDB::store_account(const PublicKey &account_key,
   index->versions.push_back(new_version);
   index->current_version++;
   index->current_slot = slot;
+  mark_dirty(account_key, slot);
 
   // Limit versions per account
   if (index->versions.size() > config_.max_versions_per_account) {
@@ -229,6 +234,11 @@ bool AccountsDB::store_account(const PublicKey &account_key,
   stats_.total_versions++;
   stats_.storage_size_bytes += data.get_size();
 
+  if (change_feed_) {
+    change_feed_->publish(slot, account_key, index->current_version,
+                          data.owner);
+  }
+
   return true;
 }
 
@@ -304,6 +314,18 @@ bool AccountsDB::delete_account(const PublicKey &account_key, uint64_t slot) {
   index->versions.push_back(deletion_version);
   index->current_version++;
   index->current_slot = slot;
+  mark_dirty(account_key, slot);
+
+  if (change_feed_) {
+    // Owner of the last live version lets program subscribers see the close
+    const auto &versions = index->versions;
+    PublicKey owner;
+    if (versions.size() >= 2) {
+      owner = versions[versions.size() - 2]->data.owner;
+    }
+    change_feed_->publish(slot, account_key, index->current_version, owner,
+                          true);
+  }
 
   // Remove from cache
   std::lock_guard<std::mutex> cache_lock(cache_mutex_);
@@ -388,6 +410,7 @@ bool AccountsDB::store_accounts_batch(
     index->versions.push_back(new_version);
     index->current_version++;
     index->current_slot = slot;
+    mark_dirty(account_key, slot);
 
     // Update cache
     auto cached_data = std::make_shared<AccountData>(data);
@@ -395,11 +418,66 @@ bool AccountsDB::store_accounts_batch(
 
     stats_.total_versions++;
     stats_.storage_size_bytes += data.get_size();
+
+    if (change_feed_) {
+      change_feed_->publish(slot, account_key, index->current_version,
+                            data.owner);
+    }
   }
 
   return true;
 }
 
+std::unordered_map<PublicKey, AccountData>
+AccountsDB::load_accounts_batch(const std::vector<PublicKey> &account_keys,
+                                uint64_t slot) {
+  std::unordered_map<PublicKey, AccountData> result;
+  auto accounts = load_accounts_shared(account_keys, slot);
+  for (size_t i = 0; i < account_keys.size(); ++i) {
+    if (accounts[i]) {
+      result.emplace(account_keys[i], *accounts[i]);
+    }
+  }
+  return result;
+}
+
+std::vector<std::shared_ptr<const AccountData>>
+AccountsDB::load_accounts_shared(const std::vector<PublicKey> &account_keys,
+                                 uint64_t slot) {
+  std::vector<std::shared_ptr<const AccountData>> result(account_keys.size());
+  std::vector<const AccountIndex *> indexes(account_keys.size(), nullptr);
+
+  std::shared_lock<std::shared_mutex> lock(index_mutex_);
+
+  // Probe every key before touching any entry, so the entries' cache
+  // misses overlap instead of following each other
+  for (size_t i = 0; i < account_keys.size(); ++i) {
+    auto it = account_index_.find(account_keys[i]);
+    if (it != account_index_.end()) {
+      indexes[i] = it->second.get();
+      __builtin_prefetch(indexes[i], 0, 1);
+    }
+  }
+
+  for (size_t i = 0; i < account_keys.size(); ++i) {
+    if (!indexes[i]) {
+      continue;
+    }
+    const auto &versions = indexes[i]->versions;
+    for (auto it = versions.rbegin(); it != versions.rend(); ++it) {
+      if (slot == UINT64_MAX || (*it)->slot <= slot) {
+        if (!(*it)->is_deleted) {
+          // Aliases the immutable version: no copy of the data
+          result[i] = std::shared_ptr<const AccountData>(*it, &(*it)->data);
+          __builtin_prefetch(result[i].get(), 0, 1);
+        }
+        break;
+      }
+    }
+  }
+  return result;
+}
+
 std::vector<PublicKey>
 AccountsDB::get_accounts_by_owner(const PublicKey &owner_key) {
   std::shared_lock<std::shared_mutex> lock(index_mutex_);
@@ -457,12 +535,16 @@ void AccountsDB::run_garbage_collection() {
     }
   }
 
-  // Clean up old versions
+  // Clean up old versions, always keeping each account's latest one: it is
+  // the account's current state, and incremental snapshots read it
   for (auto &[account_key, index] : account_index_) {
     auto &versions = index->versions;
+    if (versions.size() < 2) {
+      continue;
+    }
 
     versions.erase(
-        std::remove_if(versions.begin(), versions.end(),
+        std::remove_if(versions.begin(), versions.end() - 1,
                        [this, current_slot, &cleaned_versions](
                            const std::shared_ptr<AccountVersion> &version) {
                          if (is_version_eligible_for_gc(*version,
@@ -472,7 +554,7 @@ void AccountsDB::run_garbage_collection() {
                          }
                          return false;
                        }),
-        versions.end());
+        versions.end() - 1);
   }
 
   stats_.gc_runs++;
@@ -483,6 +565,160 @@ void AccountsDB::run_garbage_collection() {
             << std::endl;
 }
 
+bool AccountsDB::collect_modified_accounts(
+    uint64_t base_slot, uint64_t slot, std::vector<ModifiedAccount> &accounts) {
+  accounts.clear();
+
+  std::shared_lock<std::shared_mutex> lock(index_mutex_);
+
+  if (!dirty_tracking_ ||
+      (dirty_pruned_ && base_slot < dirty_pruned_through_)) {
+    return false;
+  }
+
+  std::unordered_set<PublicKey> touched;
+  for (auto it = dirty_accounts_.upper_bound(base_slot);
+       it != dirty_accounts_.end() && it->first <= slot; ++it) {
+    touched.insert(it->second.begin(), it->second.end());
+  }
+
+  accounts.reserve(touched.size());
+  for (const auto &account_key : touched) {
+    auto index_it = account_index_.find(account_key);
+    if (index_it == account_index_.end()) {
+      continue;
+    }
+
+    // Latest version up to the snapshot slot; later writes belong to the
+    // next snapshot
+    const auto &versions = index_it->second->versions;
+    auto it = versions.rbegin();
+    while (it != versions.rend() && (*it)->slot > slot) {
+      ++it;
+    }
+    if (it == versions.rend()) {
+      // Written in range but that version was collected since: the state
+      // at `slot` is gone and only a full snapshot can capture it
+      accounts.clear();
+      return false;
+    }
+    ModifiedAccount account;
+    account.account_key = account_key;
+    account.slot = (*it)->slot;
+    account.is_deleted = (*it)->is_deleted;
+    if (!account.is_deleted) {
+      account.data = (*it)->data;
+    }
+    accounts.push_back(std::move(account));
+  }
+
+  return true;
+}
+
+void AccountsDB::collect_accounts_at_slot(
+    uint64_t slot, std::vector<ModifiedAccount> &accounts) {
+  accounts.clear();
+
+  std::shared_lock<std::shared_mutex> lock(index_mutex_);
+  accounts.reserve(account_index_.size());
+
+  for (const auto &[account_key, index] : account_index_) {
+    const auto &versions = index->versions;
+    for (auto it = versions.rbegin(); it != versions.rend(); ++it) {
+      if ((*it)->slot <= slot) {
+        if (!(*it)->is_deleted) {
+          accounts.push_back(
+              ModifiedAccount{account_key, (*it)->slot, false, (*it)->data});
+        }
+        break;
+      }
+    }
+  }
+}
+
+bool AccountsDB::for_each_account_at_slot(
+    uint64_t slot, size_t batch_size,
+    const std::function<bool(std::vector<ModifiedAccount> &)> &visit) {
+  batch_size = std::max<size_t>(batch_size, 1);
+
+  // One pass for the key set, sorted outside the lock; versions are then
+  // resolved a batch at a time
+  std::vector<PublicKey> keys;
+  {
+    std::shared_lock<std::shared_mutex> lock(index_mutex_);
+    keys.reserve(account_index_.size());
+    for (const auto &entry : account_index_) {
+      keys.push_back(entry.first);
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<ModifiedAccount> batch;
+  for (size_t begin = 0; begin < keys.size(); begin += batch_size) {
+    size_t end = std::min(keys.size(), begin + batch_size);
+    batch.clear();
+    {
+      std::shared_lock<std::shared_mutex> lock(index_mutex_);
+      for (size_t i = begin; i < end; ++i) {
+        auto index_it = account_index_.find(keys[i]);
+        if (index_it == account_index_.end()) {
+          continue;
+        }
+        const auto &versions = index_it->second->versions;
+        for (auto it = versions.rbegin(); it != versions.rend(); ++it) {
+          if ((*it)->slot <= slot) {
+            if (!(*it)->is_deleted) {
+              batch.push_back(ModifiedAccount{keys[i], (*it)->slot, false,
+                                              (*it)->data});
+            }
+            break;
+          }
+        }
+      }
+    }
+    if (!batch.empty() && !visit(batch)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AccountsDB::prune_dirty_accounts(uint64_t slot) {
+  std::unique_lock<std::shared_mutex> lock(index_mutex_);
+  dirty_accounts_.erase(dirty_accounts_.begin(),
+                        dirty_accounts_.upper_bound(slot));
+  if (!dirty_pruned_ || slot > dirty_pruned_through_) {
+    dirty_pruned_through_ = slot;
+    dirty_pruned_ = true;
+  }
+}
+
+void AccountsDB::set_dirty_tracking(bool enabled) {
+  std::unique_lock<std::shared_mutex> lock(index_mutex_);
+  enabled = enabled && config_.enable_snapshots;
+  if (enabled == dirty_tracking_) {
+    return;
+  }
+  dirty_tracking_ = enabled;
+  dirty_accounts_.clear();
+  if (enabled) {
+    // Nothing at or before the latest write so far was recorded
+    dirty_pruned_through_ = std::max(dirty_pruned_through_,
+                                     latest_written_slot_);
+    dirty_pruned_ = true;
+  }
+}
+
+bool AccountsDB::is_dirty_tracking() const {
+  std::shared_lock<std::shared_mutex> lock(index_mutex_);
+  return dirty_tracking_;
+}
+
+size_t AccountsDB::get_dirty_slot_count() const {
+  std::shared_lock<std::shared_mutex> lock(index_mutex_);
+  return dirty_accounts_.size();
+}
+
 double AccountsDB::get_cache_hit_ratio() const {
   uint64_t hits = stats_.cache_hits.load();
   uint64_t misses = stats_.cache_misses.load();
@@ -513,7 +749,12 @@ void AccountsDB::reset_statistics() {
 // Private methods
 void AccountsDB::gc_worker_loop() {
   while (!should_stop_gc_) {
-    std::this_thread::sleep_for(config_.gc_interval);
+    {
+      // Interruptible, so destruction does not wait out the interval
+      std::unique_lock<std::mutex> lock(gc_mutex_);
+      gc_cv_.wait_for(lock, config_.gc_interval,
+                      [this] { return should_stop_gc_.load(); });
+    }
 
     if (!should_stop_gc_ && gc_enabled_) {
       run_garbage_collection();
@@ -521,6 +762,14 @@ void AccountsDB::gc_worker_loop() {
   }
 }
 
+void AccountsDB::mark_dirty(const PublicKey &account_key, uint64_t slot) {
+  // Caller holds index_mutex_ exclusively
+  latest_written_slot_ = std::max(latest_written_slot_, slot);
+  if (dirty_tracking_) {
+    dirty_accounts_[slot].insert(account_key);
+  }
+}
+
 bool AccountsDB::is_version_eligible_for_gc(const AccountVersion &version,
                                             uint64_t current_slot) {
   // Keep versions from recent slots
@@ -0,0 +1,436 @@
+#include "storage/accounts_hash.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <openssl/evp.h>
+#include <thread>
+
+namespace slonana {
+namespace storage {
+
+namespace {
+
+constexpr size_t HASH_BATCH = 256; // Accounts per parallel task
+constexpr uint64_t CACHE_MAGIC = 0x31435348414e4c53ULL; // "SLNAHSC1"
+
+void sha256(const uint8_t *data, size_t size, uint8_t *out) {
+  unsigned int length = 0;
+  EVP_Digest(data, size, out, &length, EVP_sha256(), nullptr);
+}
+
+void put_u64(uint8_t *out, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+/// Hashes everything written or read through it, for the cache checksum
+class HashedStream {
+public:
+  HashedStream() : ctx_(EVP_MD_CTX_new(), EVP_MD_CTX_free) {
+    EVP_DigestInit_ex(ctx_.get(), EVP_sha256(), nullptr);
+  }
+
+  bool write(std::ofstream &out, const void *data, size_t size) {
+    EVP_DigestUpdate(ctx_.get(), data, size);
+    return static_cast<bool>(
+        out.write(static_cast<const char *>(data), size));
+  }
+  bool read(std::ifstream &in, void *data, size_t size) {
+    if (!in.read(static_cast<char *>(data), size)) {
+      return false;
+    }
+    EVP_DigestUpdate(ctx_.get(), data, size);
+    return true;
+  }
+  AccountHash digest() {
+    AccountHash hash{};
+    unsigned int length = 0;
+    EVP_DigestFinal_ex(ctx_.get(), hash.data(), &length);
+    return hash;
+  }
+
+private:
+  std::unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx_;
+};
+
+} // namespace
+
+AccountsHasher::AccountsHasher() : AccountsHasher(Options{}) {}
+
+AccountsHasher::AccountsHasher(const Options &options) : options_(options) {
+  if (options_.threads == 0) {
+    options_.threads = std::thread::hardware_concurrency();
+  }
+  options_.threads = std::max<size_t>(options_.threads, 1);
+  bins_.resize(BINS);
+}
+
+AccountHash AccountsHasher::hash_account(const PublicKey &pubkey,
+                                         uint64_t lamports,
+                                         const PublicKey &owner,
+                                         bool executable, uint64_t rent_epoch,
+                                         const uint8_t *data,
+                                         size_t data_size) {
+  AccountHash hash{};
+  if (lamports == 0) {
+    return hash;
+  }
+
+  uint8_t buffer[8 + 8 + 32 + 1 + 32 + 32] = {};
+  put_u64(buffer, lamports);
+  put_u64(buffer + 8, rent_epoch);
+  sha256(data, data_size, buffer + 16);
+  buffer[48] = executable ? 1 : 0;
+  std::memcpy(buffer + 49, owner.data(), std::min<size_t>(owner.size(), 32));
+  std::memcpy(buffer + 81, pubkey.data(), std::min<size_t>(pubkey.size(), 32));
+  sha256(buffer, sizeof(buffer), hash.data());
+  return hash;
+}
+
+AccountHash AccountsHasher::hash_account(const PublicKey &pubkey,
+                                         const AccountData &account) {
+  return hash_account(pubkey, account.lamports, account.owner,
+                      account.executable, account.rent_epoch,
+                      account.data.data(), account.data.size());
+}
+
+AccountHash AccountsHasher::merkle_root(std::vector<AccountHash> hashes,
+                                        size_t fanout) {
+  AccountHash root{};
+  if (hashes.empty()) {
+    return root;
+  }
+  fanout = std::max<size_t>(fanout, 2);
+
+  // Each level hashes groups of `fanout` siblings in place; a lone leaf is
+  // still hashed once so a root never equals an account hash
+  do {
+    size_t groups = (hashes.size() + fanout - 1) / fanout;
+    for (size_t group = 0; group < groups; ++group) {
+      size_t first = group * fanout;
+      size_t count = std::min(fanout, hashes.size() - first);
+      AccountHash parent;
+      sha256(hashes[first].data(), count * sizeof(AccountHash), parent.data());
+      hashes[group] = parent;
+    }
+    hashes.resize(groups);
+  } while (hashes.size() > 1);
+
+  return hashes.front();
+}
+
+std::string AccountsHasher::to_hex(const AccountHash &hash) {
+  static const char digits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(hash.size() * 2);
+  for (uint8_t byte : hash) {
+    hex.push_back(digits[byte >> 4]);
+    hex.push_back(digits[byte & 0x0f]);
+  }
+  return hex;
+}
+
+void AccountsHasher::rebuild(const std::vector<ModifiedAccount> &accounts,
+                             uint64_t slot) {
+  for (auto &bin : bins_) {
+    bin.leaves.clear();
+    bin.dirty = true;
+  }
+  root_valid_ = false;
+  stats_.full_rebuilds++;
+  apply(accounts, slot);
+}
+
+void AccountsHasher::apply(const std::vector<ModifiedAccount> &changes,
+                           uint64_t slot) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Account hashes are the expensive part; compute them all in parallel
+  std::vector<Update> updates(changes.size());
+  size_t batches = (changes.size() + HASH_BATCH - 1) / HASH_BATCH;
+  run_parallel(batches, [&](size_t batch) {
+    size_t end = std::min(changes.size(), (batch + 1) * HASH_BATCH);
+    for (size_t i = batch * HASH_BATCH; i < end; ++i) {
+      const auto &change = changes[i];
+      auto &update = updates[i];
+      update.key = {};
+      std::memcpy(update.key.data(), change.account_key.data(),
+                  std::min<size_t>(change.account_key.size(), 32));
+      update.remove = change.is_deleted;
+      update.hash = change.is_deleted
+                        ? AccountHash{}
+                        : hash_account(change.account_key, change.data);
+      if (!update.remove && !keeps(update.hash)) {
+        update.remove = true;
+      }
+    }
+  });
+  stats_.accounts_hashed += changes.size();
+
+  apply_updates(updates);
+  built_ = true;
+  slot_ = slot;
+
+  stats_.last_update_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+}
+
+void AccountsHasher::update_from(AccountsDB &accounts_db, uint64_t slot) {
+  std::vector<ModifiedAccount> accounts;
+  if (built_ && slot == slot_) {
+    return;
+  }
+  if (built_ && slot > slot_ &&
+      accounts_db.collect_modified_accounts(slot_, slot, accounts)) {
+    apply(accounts, slot);
+    return;
+  }
+  accounts_db.collect_accounts_at_slot(slot, accounts);
+  rebuild(accounts, slot);
+}
+
+void AccountsHasher::insert_hashes(
+    std::vector<std::pair<PublicKey, AccountHash>> hashes) {
+  std::vector<Update> updates;
+  updates.reserve(hashes.size());
+  for (const auto &[pubkey, hash] : hashes) {
+    Update update{};
+    std::memcpy(update.key.data(), pubkey.data(),
+                std::min<size_t>(pubkey.size(), 32));
+    update.remove = !keeps(hash);
+    update.hash = hash;
+    updates.push_back(update);
+  }
+  apply_updates(updates);
+  built_ = true;
+}
+
+AccountHash AccountsHasher::root() {
+  if (root_valid_) {
+    return root_;
+  }
+
+  std::vector<size_t> dirty;
+  for (size_t i = 0; i < bins_.size(); ++i) {
+    if (bins_[i].dirty) {
+      dirty.push_back(i);
+    }
+  }
+
+  run_parallel(dirty.size(), [&](size_t i) {
+    auto &bin = bins_[dirty[i]];
+    std::vector<AccountHash> leaves;
+    leaves.reserve(bin.leaves.size());
+    for (const auto &leaf : bin.leaves) {
+      leaves.push_back(leaf.second);
+    }
+    bin.root = merkle_root(std::move(leaves));
+    bin.dirty = false;
+  });
+  stats_.bins_rehashed += dirty.size();
+
+  std::vector<AccountHash> bin_roots;
+  for (const auto &bin : bins_) {
+    if (!bin.leaves.empty()) {
+      bin_roots.push_back(bin.root);
+    }
+  }
+  root_ = merkle_root(std::move(bin_roots));
+  root_valid_ = true;
+  return root_;
+}
+
+size_t AccountsHasher::account_count() const {
+  size_t count = 0;
+  for (const auto &bin : bins_) {
+    count += bin.leaves.size();
+  }
+  return count;
+}
+
+bool AccountsHasher::save(const std::string &path) {
+  root(); // Store clean bin roots
+
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+
+    HashedStream stream;
+    uint8_t header[8 + 8 + 4 + 1];
+    put_u64(header, CACHE_MAGIC);
+    put_u64(header + 8, slot_);
+    uint32_t bins = static_cast<uint32_t>(bins_.size());
+    std::memcpy(header + 16, &bins, sizeof(bins));
+    header[20] = options_.include_zero_lamport ? 1 : 0;
+    bool ok = stream.write(out, header, sizeof(header));
+
+    for (const auto &bin : bins_) {
+      uint32_t count = static_cast<uint32_t>(bin.leaves.size());
+      ok = ok && stream.write(out, &count, sizeof(count)) &&
+           stream.write(out, bin.root.data(), bin.root.size()) &&
+           (count == 0 ||
+            stream.write(out, bin.leaves.data(),
+                         count * sizeof(bin.leaves.front())));
+    }
+
+    AccountHash checksum = stream.digest();
+    ok = ok && out.write(reinterpret_cast<const char *>(checksum.data()),
+                         checksum.size());
+    out.flush();
+    if (!ok || !out) {
+      std::remove(temp_path.c_str());
+      return false;
+    }
+  }
+  return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+bool AccountsHasher::load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  HashedStream stream;
+  uint8_t header[8 + 8 + 4 + 1];
+  if (!stream.read(in, header, sizeof(header))) {
+    return false;
+  }
+  uint64_t magic = 0;
+  uint64_t slot = 0;
+  uint32_t bins = 0;
+  for (int i = 7; i >= 0; --i) {
+    magic = (magic << 8) | header[i];
+    slot = (slot << 8) | header[8 + i];
+  }
+  std::memcpy(&bins, header + 16, sizeof(bins));
+  if (magic != CACHE_MAGIC || bins != bins_.size() ||
+      (header[20] != 0) != options_.include_zero_lamport) {
+    return false;
+  }
+
+  std::vector<Bin> loaded(bins);
+  for (auto &bin : loaded) {
+    uint32_t count = 0;
+    if (!stream.read(in, &count, sizeof(count)) ||
+        !stream.read(in, bin.root.data(), bin.root.size())) {
+      return false;
+    }
+    bin.leaves.resize(count);
+    if (count > 0 && !stream.read(in, bin.leaves.data(),
+                                  count * sizeof(bin.leaves.front()))) {
+      return false;
+    }
+  }
+
+  AccountHash expected = stream.digest();
+  AccountHash checksum{};
+  if (!in.read(reinterpret_cast<char *>(checksum.data()), checksum.size()) ||
+      checksum != expected) {
+    return false;
+  }
+
+  bins_ = std::move(loaded);
+  slot_ = slot;
+  built_ = true;
+  root_valid_ = false;
+  return true;
+}
+
+size_t AccountsHasher::bin_of(const Key &key) const {
+  // Leading 16 bits scaled to the bin count keeps bins in pubkey order
+  size_t prefix = (static_cast<size_t>(key[0]) << 8) | key[1];
+  return prefix * BINS >> 16;
+}
+
+bool AccountsHasher::keeps(const AccountHash &hash) const {
+  return options_.include_zero_lamport || hash != AccountHash{};
+}
+
+void AccountsHasher::apply_updates(std::vector<Update> &updates) {
+  if (updates.empty()) {
+    return;
+  }
+
+  // Group by bin (stable, so the last update to a key wins), then let
+  // each bin merge its own updates
+  std::vector<uint32_t> counts(bins_.size() + 1, 0);
+  for (const auto &update : updates) {
+    counts[bin_of(update.key) + 1]++;
+  }
+  for (size_t i = 1; i < counts.size(); ++i) {
+    counts[i] += counts[i - 1];
+  }
+  std::vector<uint32_t> order(updates.size());
+  std::vector<uint32_t> fill(counts.begin(), counts.end() - 1);
+  for (size_t i = 0; i < updates.size(); ++i) {
+    order[fill[bin_of(updates[i].key)]++] = static_cast<uint32_t>(i);
+  }
+
+  std::vector<size_t> touched;
+  for (size_t i = 0; i < bins_.size(); ++i) {
+    if (counts[i + 1] > counts[i]) {
+      touched.push_back(i);
+    }
+  }
+
+  run_parallel(touched.size(), [&](size_t t) {
+    size_t bin_index = touched[t];
+    auto &leaves = bins_[bin_index].leaves;
+    for (uint32_t i = counts[bin_index]; i < counts[bin_index + 1]; ++i) {
+      const auto &update = updates[order[i]];
+      auto it = std::lower_bound(
+          leaves.begin(), leaves.end(), update.key,
+          [](const std::pair<Key, AccountHash> &leaf, const Key &key) {
+            return leaf.first < key;
+          });
+      bool found = it != leaves.end() && it->first == update.key;
+      if (update.remove) {
+        if (found) {
+          leaves.erase(it);
+        }
+      } else if (found) {
+        it->second = update.hash;
+      } else {
+        leaves.insert(it, {update.key, update.hash});
+      }
+    }
+    bins_[bin_index].dirty = true;
+  });
+  root_valid_ = false;
+}
+
+template <typename Task>
+void AccountsHasher::run_parallel(size_t count, Task &&task) const {
+  if (count == 0) {
+    return;
+  }
+  std::atomic<size_t> next{0};
+  auto work = [&] {
+    for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+      task(i);
+    }
+  };
+
+  size_t threads = std::min(options_.threads, count);
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+} // namespace storage
+} // namespace slonana
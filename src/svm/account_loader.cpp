@@ -1,5 +1,9 @@
 #include "svm/account_loader.h"
+#include "storage/accounts_db.h"
+#include "svm/rent_calculator.h"
+#include "svm/sysvar_cache.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <unordered_set>
 
@@ -10,64 +14,112 @@ namespace svm {
 class AccountLoader::Impl {
 public:
   AccountLoadingCallback *callback_;
-  std::unordered_map<PublicKey, LoadedAccount> account_cache_;
+  // Accounts loaded so far, shared rather than copied into each
+  // transaction; index_ maps a key to its position
+  std::vector<std::shared_ptr<const AccountInfo>> accounts_;
+  std::unordered_map<PublicKey, uint32_t> index_;
   AccountLoader::CacheStats stats_;
-  std::unordered_set<PublicKey> accessed_accounts_;
 
   explicit Impl(AccountLoadingCallback *callback) : callback_(callback) {}
 
+  std::shared_ptr<const AccountInfo> cached(const PublicKey &address) const {
+    auto it = index_.find(address);
+    return it == index_.end() ? nullptr : accounts_[it->second];
+  }
+
+  /// Fetch every key not yet cached with a single get_accounts call;
+  /// builtin programs and sysvars are filled in without being fetched
+  void fetch(const std::vector<PublicKey> &addresses) {
+    std::vector<PublicKey> missing;
+    std::unordered_set<PublicKey> requested;
+    std::shared_ptr<const SysvarSnapshot> sysvars;
+    for (const auto &address : addresses) {
+      if (index_.count(address)) {
+        stats_.hits++;
+        continue;
+      }
+      auto builtin = lookup_builtin_account(address);
+      if (builtin != BuiltinAccount::NONE) {
+        std::shared_ptr<const AccountInfo> account;
+        if (is_sysvar(builtin)) {
+          if (!sysvars) {
+            sysvars = SysvarCache::current();
+          }
+          account = sysvars->account(builtin);
+        } else {
+          account = builtin_program_account(builtin);
+        }
+        if (account) {
+          index_.emplace(address, static_cast<uint32_t>(accounts_.size()));
+          accounts_.push_back(std::move(account));
+          stats_.builtin_loads++;
+          continue;
+        }
+      }
+      if (requested.insert(address).second) {
+        missing.push_back(address);
+      }
+    }
+    if (missing.empty()) {
+      return;
+    }
+
+    stats_.batch_fetches++;
+    auto fetched = callback_->get_accounts(missing);
+    for (size_t i = 0; i < missing.size(); ++i) {
+      if (i >= fetched.size() || !fetched[i]) {
+        stats_.misses++;
+        continue;
+      }
+      index_.emplace(missing[i], static_cast<uint32_t>(accounts_.size()));
+      stats_.total_loaded_size +=
+          fetched[i]->data.size() + 128; // Account metadata overhead
+      accounts_.push_back(std::move(fetched[i]));
+    }
+  }
+
   std::optional<LoadedAccount> load_account_internal(const PublicKey &address,
                                                      bool is_writable,
                                                      bool is_signer) {
-    // Check cache first
-    auto cache_it = account_cache_.find(address);
-    if (cache_it != account_cache_.end()) {
+    auto account = cached(address);
+    if (account) {
       stats_.hits++;
-      return cache_it->second;
+    } else {
+      fetch({address});
+      account = cached(address);
+      if (!account) {
+        return std::nullopt;
+      }
     }
+    return LoadedAccount(address, *account, account->data.size() + 128,
+                         callback_->get_slot(), is_writable, is_signer);
+  }
 
-    // Load from callback
-    auto account_opt = callback_->get_account(address);
-    if (!account_opt) {
-      stats_.misses++;
-      return std::nullopt;
+  static bool has_duplicate_writable(const std::vector<PublicKey> &account_keys,
+                                     const std::vector<bool> &is_writable) {
+    std::unordered_set<PublicKey> writable_accounts;
+    for (size_t i = 0; i < account_keys.size() && i < is_writable.size(); ++i) {
+      if (is_writable[i] && !writable_accounts.insert(account_keys[i]).second) {
+        return true;
+      }
     }
-
-    LoadedAccount loaded_account(address, *account_opt,
-                                 account_opt->data.size() +
-                                     128, // Account metadata overhead
-                                 callback_->get_slot(), is_writable, is_signer);
-
-    // Cache the account
-    account_cache_[address] = loaded_account;
-    stats_.total_loaded_size += loaded_account.loaded_size;
-    accessed_accounts_.insert(address);
-
-    return loaded_account;
+    return false;
   }
 
   TransactionLoadResult
   validate_account_constraints(const std::vector<PublicKey> &account_keys,
-                               const std::vector<bool> &is_signer,
                                const std::vector<bool> &is_writable,
                                size_t max_loaded_accounts_data_size) {
     // Check for duplicate accounts in writable positions
-    std::unordered_set<PublicKey> writable_accounts;
-    for (size_t i = 0; i < account_keys.size() && i < is_writable.size(); ++i) {
-      if (is_writable[i]) {
-        if (writable_accounts.count(account_keys[i])) {
-          return TransactionLoadResult::DUPLICATE_INSTRUCTION;
-        }
-        writable_accounts.insert(account_keys[i]);
-      }
+    if (has_duplicate_writable(account_keys, is_writable)) {
+      return TransactionLoadResult::DUPLICATE_INSTRUCTION;
     }
 
     // Check total data size constraint
     size_t total_data_size = 0;
     for (const auto &key : account_keys) {
-      auto account_opt = callback_->get_account(key);
-      if (account_opt) {
-        total_data_size += account_opt->data.size() + 128; // Metadata overhead
+      if (auto account = cached(key)) {
+        total_data_size += account->data.size() + 128; // Metadata overhead
       }
     }
 
@@ -79,6 +131,93 @@ public:
   }
 };
 
+// AccountLoadingCallback
+
+std::vector<std::shared_ptr<const AccountInfo>>
+AccountLoadingCallback::get_accounts(const std::vector<PublicKey> &addresses) {
+  std::vector<std::shared_ptr<const AccountInfo>> accounts;
+  accounts.reserve(addresses.size());
+  for (const auto &address : addresses) {
+    auto account = get_account(address);
+    accounts.push_back(account ? std::make_shared<const AccountInfo>(
+                                     std::move(*account))
+                               : nullptr);
+  }
+  return accounts;
+}
+
+// AccountsDbLoadingCallback
+
+namespace {
+
+AccountInfo to_account_info(const PublicKey &address,
+                            const storage::AccountData &data) {
+  AccountInfo account;
+  account.pubkey = address;
+  account.is_signer = false;
+  account.is_writable = false;
+  account.lamports = data.lamports;
+  account.data = data.data;
+  account.owner = data.owner;
+  account.executable = data.executable;
+  account.rent_epoch = data.rent_epoch;
+  return account;
+}
+
+} // namespace
+
+AccountsDbLoadingCallback::AccountsDbLoadingCallback(
+    storage::AccountsDB &accounts_db, Slot slot)
+    : accounts_db_(accounts_db), slot_(slot) {}
+
+std::optional<AccountInfo>
+AccountsDbLoadingCallback::get_account(const PublicKey &address) {
+  auto data = accounts_db_.load_account(address, slot_);
+  if (!data) {
+    return std::nullopt;
+  }
+  return to_account_info(address, *data);
+}
+
+bool AccountsDbLoadingCallback::account_exists(const PublicKey &address) {
+  return accounts_db_.account_exists(address, slot_);
+}
+
+Lamports AccountsDbLoadingCallback::calculate_rent(size_t data_size) {
+  return RentCalculator().calculate_rent(data_size);
+}
+
+std::vector<std::shared_ptr<const AccountInfo>>
+AccountsDbLoadingCallback::get_accounts(
+    const std::vector<PublicKey> &addresses) {
+  auto stored = accounts_db_.load_accounts_shared(addresses, slot_);
+
+  // Copy out in address order, so consecutive reads tend to share pages,
+  // and start loading each account's data one step ahead
+  std::vector<size_t> order;
+  order.reserve(stored.size());
+  for (size_t i = 0; i < stored.size(); ++i) {
+    if (stored[i]) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return std::less<const storage::AccountData *>()(stored[a].get(),
+                                                     stored[b].get());
+  });
+
+  std::vector<std::shared_ptr<const AccountInfo>> accounts(addresses.size());
+  for (size_t n = 0; n < order.size(); ++n) {
+    if (n + 1 < order.size()) {
+      __builtin_prefetch(stored[order[n + 1]]->data.data(), 0, 1);
+    }
+    size_t i = order[n];
+    accounts[i] = std::make_shared<const AccountInfo>(
+        to_account_info(addresses[i], *stored[i]));
+  }
+  return accounts;
+}
+
 AccountLoader::AccountLoader(AccountLoadingCallback *callback)
     : impl_(std::make_unique<Impl>(callback)) {}
 
@@ -91,9 +230,14 @@ LoadedTransaction AccountLoader::load_transaction_accounts(
     size_t max_loaded_accounts_data_size) {
   LoadedTransaction loaded_tx;
 
+  // One fetch for everything the transaction touches
+  std::vector<PublicKey> addresses = account_keys;
+  addresses.push_back(fee_payer);
+  impl_->fetch(addresses);
+
   // Validate constraints first
   auto constraint_result = impl_->validate_account_constraints(
-      account_keys, is_signer, is_writable, max_loaded_accounts_data_size);
+      account_keys, is_writable, max_loaded_accounts_data_size);
   if (constraint_result != TransactionLoadResult::SUCCESS) {
     loaded_tx.load_result = constraint_result;
     return loaded_tx;
@@ -124,8 +268,8 @@ LoadedTransaction AccountLoader::load_transaction_accounts(
       return loaded_tx;
     }
 
-    loaded_tx.accounts.push_back(*loaded_account);
     loaded_tx.loaded_accounts_data_size += loaded_account->loaded_size;
+    loaded_tx.accounts.push_back(std::move(*loaded_account));
   }
 
   // Calculate rent for new accounts (simplified)
@@ -141,6 +285,77 @@ LoadedTransaction AccountLoader::load_transaction_accounts(
   return loaded_tx;
 }
 
+LoadedBatch AccountLoader::load_batch(
+    const std::vector<TransactionAccountKeys> &transactions,
+    size_t max_loaded_accounts_data_size) {
+  LoadedBatch batch;
+
+  // The union of the batch's keys, in first-use order
+  std::unordered_map<PublicKey, uint32_t> positions;
+  for (const auto &transaction : transactions) {
+    for (const auto &key : transaction.account_keys) {
+      if (positions
+              .emplace(key, static_cast<uint32_t>(batch.keys.size()))
+              .second) {
+        batch.keys.push_back(key);
+      } else {
+        impl_->stats_.hits++; // Shared within the batch
+      }
+    }
+  }
+  impl_->fetch(batch.keys);
+  batch.accounts.reserve(batch.keys.size());
+  for (const auto &key : batch.keys) {
+    batch.accounts.push_back(impl_->cached(key));
+  }
+
+  batch.transactions.resize(transactions.size());
+  for (size_t t = 0; t < transactions.size(); ++t) {
+    const auto &keys = transactions[t];
+    auto &loaded = batch.transactions[t];
+    loaded.fee = keys.fee;
+    loaded.account_indices.reserve(keys.account_keys.size());
+    for (const auto &key : keys.account_keys) {
+      loaded.account_indices.push_back(positions[key]);
+    }
+
+    if (keys.account_keys.empty()) {
+      loaded.load_result = TransactionLoadResult::INVALID_ACCOUNT_FOR_FEE;
+      continue;
+    }
+    if (Impl::has_duplicate_writable(keys.account_keys, keys.is_writable)) {
+      loaded.load_result = TransactionLoadResult::DUPLICATE_INSTRUCTION;
+      continue;
+    }
+    bool missing = false;
+    for (uint32_t index : loaded.account_indices) {
+      const auto &account = batch.accounts[index];
+      if (!account) {
+        missing = true;
+        continue;
+      }
+      loaded.loaded_accounts_data_size += account->data.size() + 128;
+      if (account->lamports == 0) {
+        loaded.rent += impl_->callback_->calculate_rent(account->data.size());
+      }
+    }
+    if (loaded.loaded_accounts_data_size > max_loaded_accounts_data_size) {
+      loaded.load_result =
+          TransactionLoadResult::MAX_LOADED_ACCOUNTS_DATA_SIZE_EXCEEDED;
+      continue;
+    }
+    const auto &payer = batch.accounts[loaded.account_indices[0]];
+    if (!payer || missing) {
+      loaded.load_result = TransactionLoadResult::ACCOUNT_NOT_FOUND;
+      continue;
+    }
+    if (payer->lamports < keys.fee) {
+      loaded.load_result = TransactionLoadResult::INSUFFICIENT_FUNDS;
+    }
+  }
+  return batch;
+}
+
 std::optional<LoadedAccount>
 AccountLoader::load_account(const PublicKey &address, bool is_writable,
                             bool is_signer) {
@@ -150,7 +365,11 @@ AccountLoader::load_account(const PublicKey &address, bool is_writable,
 TransactionLoadResult
 AccountLoader::validate_fee_payer(const PublicKey &fee_payer,
                                   Lamports fee_amount, Lamports rent_amount) {
-  auto account_opt = impl_->callback_->get_account(fee_payer);
+  auto account_opt = impl_->cached(fee_payer);
+  if (!account_opt) {
+    impl_->fetch({fee_payer});
+    account_opt = impl_->cached(fee_payer);
+  }
   if (!account_opt) {
     return TransactionLoadResult::ACCOUNT_NOT_FOUND;
   }
@@ -176,8 +395,8 @@ AccountLoader::CacheStats AccountLoader::get_cache_stats() const {
 }
 
 void AccountLoader::reset() {
-  impl_->account_cache_.clear();
-  impl_->accessed_accounts_.clear();
+  impl_->accounts_.clear();
+  impl_->index_.clear();
   impl_->stats_ = CacheStats{};
 }
 
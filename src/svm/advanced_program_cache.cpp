@@ -26,7 +26,11 @@ AdvancedProgramCache::AdvancedProgramCache(const Configuration &config)
 }
 
 AdvancedProgramCache::~AdvancedProgramCache() {
-  should_stop_ = true;
+  {
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    should_stop_ = true;
+  }
+  worker_cv_.notify_all();
 
   if (gc_thread_.joinable()) {
     gc_thread_.join();
@@ -37,126 +41,300 @@ AdvancedProgramCache::~AdvancedProgramCache() {
   }
 }
 
-std::shared_ptr<CompiledProgram>
-AdvancedProgramCache::get_program(const PublicKey &program_id) {
-  std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+AdvancedProgramCache::Shard &
+AdvancedProgramCache::shard_for(const PublicKey &program_id) {
+  return shards_[std::hash<PublicKey>{}(program_id) % SHARD_COUNT];
+}
 
-  auto it = cache_map_.find(program_id);
-  if (it != cache_map_.end()) {
-    // Cache hit
-    stats_.cache_hits++;
+void AdvancedProgramCache::update_shard(
+    Shard &shard, const std::function<void(VersionMap &)> &edit) {
+  std::lock_guard<std::mutex> lock(shard.write_mutex);
+  auto programs = std::make_shared<VersionMap>(
+      *shard.programs.load(std::memory_order_acquire));
+  edit(*programs);
+  shard.programs.store(std::move(programs), std::memory_order_release);
+}
 
-    // Update access time and move to front
-    auto &program = it->second.program;
-    program->last_access_time = std::chrono::steady_clock::now();
-    program->execution_count++;
+std::shared_ptr<const CompiledProgram>
+AdvancedProgramCache::lookup(const PublicKey &program_id, Slot slot,
+                             bool &deployed) {
+  auto programs =
+      shard_for(program_id).programs.load(std::memory_order_acquire);
+  auto it = programs->find(program_id);
+  deployed = it != programs->end();
+  if (!deployed) {
+    return nullptr;
+  }
+  const auto &versions = it->second;
+  for (auto version = versions.rbegin(); version != versions.rend();
+       ++version) {
+    if ((*version)->effective_slot <= slot) {
+      return *version;
+    }
+  }
+  return nullptr;
+}
+
+void AdvancedProgramCache::record_hit(
+    const std::shared_ptr<const CompiledProgram> &program) {
+  stats_.cache_hits.fetch_add(1, std::memory_order_relaxed);
+  stats_.tier_hits[static_cast<size_t>(program->tier)].fetch_add(
+      1, std::memory_order_relaxed);
+  if (!program->referenced.load(std::memory_order_relaxed)) {
+    program->referenced.store(true, std::memory_order_relaxed);
+  }
+
+  uint64_t executions =
+      program->execution_count.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (!config_.enable_precompilation) {
+    return;
+  }
+  ProgramTier target = program->tier;
+  if (config_.jit_threshold > 0 && executions >= config_.jit_threshold) {
+    target = ProgramTier::JIT;
+  } else if (config_.decode_threshold > 0 &&
+             executions >= config_.decode_threshold) {
+    target = ProgramTier::DECODED;
+  }
+  // One promotion per version; the promoted version may queue the next
+  if (target <= program->tier ||
+      program->promotion_queued.load(std::memory_order_relaxed) ||
+      program->promotion_queued.exchange(true, std::memory_order_relaxed)) {
+    return;
+  }
 
-    // Move to front of LRU list (requires upgrading to unique lock)
-    lock.unlock();
-    std::unique_lock<std::shared_mutex> write_lock(cache_mutex_);
-    move_to_front(program_id);
+  {
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    promotion_queue_.emplace_back(program, target);
+  }
+  worker_cv_.notify_all();
+}
 
+std::shared_ptr<const CompiledProgram>
+AdvancedProgramCache::get_program(const PublicKey &program_id, Slot slot) {
+  bool deployed = false;
+  auto program = lookup(program_id, slot, deployed);
+  if (program) {
+    record_hit(program);
     return program;
-  } else {
-    // Cache miss
-    stats_.cache_misses++;
-    return nullptr;
   }
+
+  // Cache miss
+  stats_.cache_misses.fetch_add(1, std::memory_order_relaxed);
+  if (deployed) {
+    stats_.delayed_visibility.fetch_add(1, std::memory_order_relaxed);
+  }
+  return nullptr;
 }
 
-bool AdvancedProgramCache::cache_program(const PublicKey &program_id,
-                                         const std::vector<uint8_t> &bytecode) {
-  std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+std::shared_ptr<const CompiledProgram>
+AdvancedProgramCache::get_or_load(const PublicKey &program_id, Slot slot,
+                                  const ProgramLoader &loader) {
+  bool deployed = false;
+  auto program = lookup(program_id, slot, deployed);
+  if (program) {
+    record_hit(program);
+    return program;
+  }
+  stats_.cache_misses.fetch_add(1, std::memory_order_relaxed);
+  if (deployed) {
+    // The program is cached but redeployed too recently for this slot
+    stats_.delayed_visibility.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
 
-  // Check if already cached
-  auto it = cache_map_.find(program_id);
-  if (it != cache_map_.end()) {
-    move_to_front(program_id);
-    return true;
+  std::promise<std::shared_ptr<const CompiledProgram>> promise;
+  {
+    std::unique_lock<std::mutex> lock(loading_mutex_);
+    auto it = loading_.find(program_id);
+    if (it != loading_.end()) {
+      auto pending = it->second;
+      lock.unlock();
+      stats_.cooperative_waits.fetch_add(1, std::memory_order_relaxed);
+      program = pending.get();
+      return program && program->effective_slot <= slot ? program : nullptr;
+    }
+
+    // Published between the lookup and here by a load that just finished
+    program = lookup(program_id, slot, deployed);
+    if (program || deployed) {
+      return program;
+    }
+    loading_.emplace(program_id, promise.get_future().share());
   }
 
-  // Create new compiled program
-  auto program = std::make_shared<CompiledProgram>(program_id, bytecode);
+  std::shared_ptr<const CompiledProgram> loaded;
+  try {
+    auto source = loader ? loader(program_id) : std::nullopt;
+    if (source) {
+      auto version =
+          build_version(program_id, source->bytecode, source->deployment_slot);
+      if (version) {
+        stats_.loads.fetch_add(1, std::memory_order_relaxed);
+        loaded = version;
+        publish(std::move(version));
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(loading_mutex_);
+      loading_.erase(program_id);
+    }
+    promise.set_exception(std::current_exception());
+    throw;
+  }
 
-  // Compile the program
-  lock.unlock();
-  bool compilation_success = compile_program(*program);
-  lock.lock();
+  {
+    std::lock_guard<std::mutex> lock(loading_mutex_);
+    loading_.erase(program_id);
+  }
+  promise.set_value(loaded);
+  return loaded && loaded->effective_slot <= slot ? loaded : nullptr;
+}
 
-  if (!compilation_success) {
-    return false;
+void AdvancedProgramCache::decode_program(CompiledProgram &program) {
+  // Verification already decoded the program; reuse that when we have it
+  program.decoded_ops = program.verified
+                            ? program.verified->ops
+                            : BpfVerifier::decode(program.bytecode);
+  program.tier = ProgramTier::DECODED;
+  program.memory_usage = program.bytecode.size() +
+                         program.decoded_ops.size() * sizeof(DecodedOp) +
+                         program.compiled_code.size();
+}
+
+std::shared_ptr<CompiledProgram>
+AdvancedProgramCache::build_version(const PublicKey &program_id,
+                                    const std::vector<uint8_t> &bytecode,
+                                    Slot deployment_slot) {
+  if (bytecode.empty() || bytecode.size() % 8 != 0) {
+    return nullptr;
+  }
+  std::shared_ptr<const VerifiedProgram> verified;
+  if (config_.verify_programs) {
+    // Cached by bytecode hash: reloading a deployment does not re-verify
+    BpfVerifier verifier;
+    verified = verifier.verify_cached(bytecode);
+    if (!verified) {
+      std::cerr << "Program rejected by verifier: "
+                << verifier.get_last_error() << std::endl;
+      return nullptr;
+    }
   }
 
-  // Check if we need to evict before adding
+  auto version = std::make_shared<CompiledProgram>(program_id, bytecode);
+  version->verified = std::move(verified);
+  version->deployment_slot = deployment_slot;
+  version->effective_slot = deployment_slot + DELAY_VISIBILITY_SLOT_OFFSET;
+  return version;
+}
+
+void AdvancedProgramCache::publish(
+    std::shared_ptr<const CompiledProgram> program) {
+  update_shard(shard_for(program->program_id), [&](VersionMap &programs) {
+    auto &versions = programs[program->program_id];
+    // A redeploy in the same slot replaces that slot's version
+    auto pos = std::lower_bound(
+        versions.begin(), versions.end(), program->effective_slot,
+        [](const std::shared_ptr<const CompiledProgram> &version, Slot slot) {
+          return version->effective_slot < slot;
+        });
+    if (pos != versions.end() &&
+        (*pos)->effective_slot == program->effective_slot) {
+      stats_.total_memory_usage -= (*pos)->memory_usage;
+      *pos = program;
+    } else {
+      versions.insert(pos, program);
+      stats_.total_programs++;
+    }
+    stats_.total_memory_usage += program->memory_usage;
+  });
+
   if (should_evict()) {
-    size_t evict_count = std::max(1UL, cache_map_.size() / 10);
+    size_t evict_count = std::max<size_t>(1, stats_.total_programs.load() / 10);
     evict_least_recently_used(evict_count);
   }
+}
 
-  // Add to cache
-  lru_list_.push_front(program_id);
-  cache_map_.emplace(program_id, CacheEntry(program));
-  cache_map_[program_id].lru_it = lru_list_.begin();
-
-  // Update statistics
-  stats_.total_programs++;
-  stats_.total_memory_usage += program->memory_usage;
+bool AdvancedProgramCache::cache_program(const PublicKey &program_id,
+                                         const std::vector<uint8_t> &bytecode,
+                                         Slot deployment_slot) {
+  auto program = build_version(program_id, bytecode, deployment_slot);
+  if (!program) {
+    return false;
+  }
+  publish(program);
 
-  std::cout << "Cached program: " << program_id.size()
-            << " bytes, compilation time: " << program->compilation_cost_us
-            << "μs" << std::endl;
+  std::cout << "Cached program: " << bytecode.size()
+            << " bytes, effective from slot " << program->effective_slot
+            << std::endl;
 
   return true;
 }
 
 bool AdvancedProgramCache::precompile_program(
-    const PublicKey &program_id, const std::vector<uint8_t> &bytecode) {
+    const PublicKey &program_id, const std::vector<uint8_t> &bytecode,
+    Slot deployment_slot) {
   if (!config_.enable_precompilation) {
     return false;
   }
 
-  auto program = std::make_shared<CompiledProgram>(program_id, bytecode);
-
-  if (!compile_program(*program)) {
+  auto program = build_version(program_id, bytecode, deployment_slot);
+  if (!program || !compile_program(*program)) {
     return false;
   }
 
   program->is_precompiled = true;
-
-  std::unique_lock<std::shared_mutex> lock(cache_mutex_);
-
-  // Add to cache
-  lru_list_.push_front(program_id);
-  cache_map_.emplace(program_id, CacheEntry(program));
-  cache_map_[program_id].lru_it = lru_list_.begin();
+  publish(program);
 
   stats_.precompiled_programs++;
-  stats_.total_programs++;
-  stats_.total_memory_usage += program->memory_usage;
 
-  std::cout << "Precompiled program: " << program_id.size() << " bytes"
+  std::cout << "Precompiled program: " << bytecode.size() << " bytes"
             << std::endl;
 
   return true;
 }
 
 void AdvancedProgramCache::invalidate_program(const PublicKey &program_id) {
-  std::unique_lock<std::shared_mutex> lock(cache_mutex_);
+  update_shard(shard_for(program_id), [&](VersionMap &programs) {
+    auto it = programs.find(program_id);
+    if (it == programs.end()) {
+      return;
+    }
+    for (const auto &version : it->second) {
+      stats_.total_memory_usage -= version->memory_usage;
+      stats_.total_programs--;
+    }
+    programs.erase(it);
+  });
+}
 
-  auto it = cache_map_.find(program_id);
-  if (it != cache_map_.end()) {
-    stats_.total_memory_usage -= it->second.program->memory_usage;
-    lru_list_.erase(it->second.lru_it);
-    cache_map_.erase(it);
-    stats_.total_programs--;
+void AdvancedProgramCache::prune(Slot root_slot) {
+  for (auto &shard : shards_) {
+    update_shard(shard, [&](VersionMap &programs) {
+      for (auto &[program_id, versions] : programs) {
+        // Everything before the newest version effective at the root is
+        // unreachable from the root and its descendants
+        size_t keep_from = 0;
+        for (size_t i = 0; i < versions.size(); ++i) {
+          if (versions[i]->effective_slot <= root_slot) {
+            keep_from = i;
+          }
+        }
+        for (size_t i = 0; i < keep_from; ++i) {
+          stats_.total_memory_usage -= versions[i]->memory_usage;
+          stats_.total_programs--;
+        }
+        versions.erase(versions.begin(), versions.begin() + keep_from);
+      }
+    });
   }
 }
 
 void AdvancedProgramCache::clear_cache() {
-  std::unique_lock<std::shared_mutex> lock(cache_mutex_);
-
-  cache_map_.clear();
-  lru_list_.clear();
+  for (auto &shard : shards_) {
+    update_shard(shard, [](VersionMap &programs) { programs.clear(); });
+  }
   stats_.total_programs = 0;
   stats_.total_memory_usage = 0;
 
@@ -166,6 +344,10 @@ void AdvancedProgramCache::clear_cache() {
 bool AdvancedProgramCache::compile_program(CompiledProgram &program) {
   auto start_time = std::chrono::high_resolution_clock::now();
 
+  if (program.decoded_ops.empty()) {
+    decode_program(program);
+  }
+
   // Simple JIT compilation simulation
   bool success = jit_compile_bytecode(program.bytecode, program.compiled_code,
                                       program.compilation_cost_us);
@@ -176,8 +358,11 @@ bool AdvancedProgramCache::compile_program(CompiledProgram &program) {
         std::chrono::duration_cast<std::chrono::microseconds>(end_time -
                                                               start_time)
             .count();
-    program.memory_usage =
-        program.bytecode.size() + program.compiled_code.size();
+    program.compilation_time = std::chrono::steady_clock::now();
+    program.tier = ProgramTier::JIT;
+    program.memory_usage = program.bytecode.size() +
+                           program.decoded_ops.size() * sizeof(DecodedOp) +
+                           program.compiled_code.size();
 
     stats_.compilations++;
     stats_.total_compilation_time_us += program.compilation_cost_us;
@@ -225,20 +410,8 @@ bool AdvancedProgramCache::jit_compile_bytecode(
   }
 }
 
-void AdvancedProgramCache::move_to_front(const PublicKey &program_id) {
-  auto cache_it = cache_map_.find(program_id);
-  if (cache_it != cache_map_.end()) {
-    // Remove from current position
-    lru_list_.erase(cache_it->second.lru_it);
-
-    // Add to front
-    lru_list_.push_front(program_id);
-    cache_it->second.lru_it = lru_list_.begin();
-  }
-}
-
 bool AdvancedProgramCache::should_evict() const {
-  return cache_map_.size() >=
+  return stats_.total_programs.load() >=
              config_.max_cache_size * config_.eviction_threshold ||
          is_memory_pressure();
 }
@@ -251,100 +424,157 @@ bool AdvancedProgramCache::is_memory_pressure() const {
 void AdvancedProgramCache::evict_least_recently_used(size_t count) {
   size_t evicted = 0;
 
-  while (evicted < count && !lru_list_.empty()) {
-    // Remove from back (least recently used)
-    PublicKey lru_program = lru_list_.back();
-
-    auto cache_it = cache_map_.find(lru_program);
-    if (cache_it != cache_map_.end()) {
-      stats_.total_memory_usage -= cache_it->second.program->memory_usage;
-      cache_map_.erase(cache_it);
-      stats_.evictions++;
-    }
-
-    lru_list_.pop_back();
-    evicted++;
+  // Clock sweep: a referenced version loses its bit and survives this pass
+  for (size_t step = 0; step < 2 * SHARD_COUNT && evicted < count; ++step) {
+    auto &shard =
+        shards_[clock_hand_.fetch_add(1, std::memory_order_relaxed) %
+                SHARD_COUNT];
+    update_shard(shard, [&](VersionMap &programs) {
+      for (auto it = programs.begin(); it != programs.end();) {
+        auto &versions = it->second;
+        for (auto version = versions.begin();
+             version != versions.end() && evicted < count;) {
+          if ((*version)->referenced.exchange(false,
+                                              std::memory_order_relaxed)) {
+            ++version;
+            continue;
+          }
+          stats_.total_memory_usage -= (*version)->memory_usage;
+          stats_.total_programs--;
+          stats_.evictions++;
+          version = versions.erase(version);
+          evicted++;
+        }
+        it = versions.empty() ? programs.erase(it) : std::next(it);
+      }
+    });
   }
 
-  stats_.total_programs -= evicted;
-
   if (evicted > 0) {
     std::cout << "Evicted " << evicted << " programs from cache" << std::endl;
   }
 }
 
 void AdvancedProgramCache::garbage_collect() {
-  std::unique_lock<std::shared_mutex> lock(cache_mutex_);
-
   auto now = std::chrono::steady_clock::now();
-  auto cutoff_time =
-      now - std::chrono::hours(1); // Remove programs not accessed in 1 hour
-
-  std::vector<PublicKey> to_remove;
-
-  for (const auto &[program_id, entry] : cache_map_) {
-    if (entry.program->last_access_time < cutoff_time &&
-        !entry.program->is_precompiled) {
-      to_remove.push_back(program_id);
-    }
-  }
-
-  for (const auto &program_id : to_remove) {
-    auto it = cache_map_.find(program_id);
-    if (it != cache_map_.end()) {
-      stats_.total_memory_usage -= it->second.program->memory_usage;
-      lru_list_.erase(it->second.lru_it);
-      cache_map_.erase(it);
-      stats_.evictions++;
-    }
+  size_t removed = 0;
+
+  // Drop versions not hit since the previous run, re-arming the rest
+  for (auto &shard : shards_) {
+    update_shard(shard, [&](VersionMap &programs) {
+      for (auto it = programs.begin(); it != programs.end();) {
+        auto &versions = it->second;
+        for (auto version = versions.begin(); version != versions.end();) {
+          if ((*version)->is_precompiled ||
+              (*version)->referenced.exchange(false,
+                                              std::memory_order_relaxed)) {
+            ++version;
+            continue;
+          }
+          stats_.total_memory_usage -= (*version)->memory_usage;
+          stats_.total_programs--;
+          stats_.evictions++;
+          version = versions.erase(version);
+          removed++;
+        }
+        it = versions.empty() ? programs.erase(it) : std::next(it);
+      }
+    });
   }
 
-  stats_.total_programs -= to_remove.size();
   stats_.last_gc_run = now;
 
-  if (!to_remove.empty()) {
-    std::cout << "GC: Removed " << to_remove.size() << " unused programs"
-              << std::endl;
+  if (removed > 0) {
+    std::cout << "GC: Removed " << removed << " unused programs" << std::endl;
   }
 }
 
 void AdvancedProgramCache::gc_worker_loop() {
+  std::unique_lock<std::mutex> lock(worker_mutex_);
   while (!should_stop_) {
-    std::this_thread::sleep_for(
-        std::chrono::seconds(config_.gc_frequency_seconds));
+    worker_cv_.wait_for(lock,
+                        std::chrono::seconds(config_.gc_frequency_seconds),
+                        [this] { return should_stop_.load(); });
 
     if (!should_stop_) {
+      lock.unlock();
       garbage_collect();
+      lock.lock();
     }
   }
 }
 
 void AdvancedProgramCache::precompilation_worker_loop() {
+  std::unique_lock<std::mutex> lock(worker_mutex_);
   while (!should_stop_) {
-    std::this_thread::sleep_for(
-        std::chrono::seconds(30)); // Check every 30 seconds
+    worker_cv_.wait(lock, [this] {
+      return should_stop_.load() || !promotion_queue_.empty();
+    });
 
     if (!should_stop_) {
+      lock.unlock();
       background_precompilation();
+      lock.lock();
     }
   }
 }
 
 void AdvancedProgramCache::background_precompilation() {
-  // This would analyze usage patterns and precompile frequently used programs
-  // For now, it's a placeholder
-  if (config_.enable_precompilation) {
-    std::cout << "Background precompilation check..." << std::endl;
+  while (true) {
+    std::pair<std::shared_ptr<const CompiledProgram>, ProgramTier> next;
+    {
+      std::lock_guard<std::mutex> lock(worker_mutex_);
+      if (promotion_queue_.empty()) {
+        return;
+      }
+      next = std::move(promotion_queue_.front());
+      promotion_queue_.pop_front();
+    }
+    promote(next.first, next.second);
   }
 }
 
-CacheStatistics AdvancedProgramCache::get_statistics() const {
-  std::shared_lock<std::shared_mutex> lock(cache_mutex_);
+size_t AdvancedProgramCache::pending_promotions() const {
+  std::lock_guard<std::mutex> lock(worker_mutex_);
+  return promotion_queue_.size();
+}
 
-  CacheStatistics current_stats = stats_;
-  current_stats.total_programs = cache_map_.size();
+void AdvancedProgramCache::promote(
+    const std::shared_ptr<const CompiledProgram> &program, ProgramTier tier) {
+  if (program->tier >= tier) {
+    return;
+  }
 
-  return current_stats;
+  auto promoted = std::make_shared<CompiledProgram>(*program);
+  if (tier == ProgramTier::JIT) {
+    if (!compile_program(*promoted)) {
+      return;
+    }
+  } else {
+    decode_program(*promoted);
+  }
+
+  // Swap in place only if the version is still cached; hits taken on the
+  // old version meanwhile are carried over
+  update_shard(shard_for(program->program_id), [&](VersionMap &programs) {
+    auto it = programs.find(program->program_id);
+    if (it == programs.end()) {
+      return;
+    }
+    for (auto &version : it->second) {
+      if (version == program) {
+        promoted->execution_count.store(program->execution_count.load());
+        stats_.total_memory_usage += promoted->memory_usage;
+        stats_.total_memory_usage -= program->memory_usage;
+        version = promoted;
+        return;
+      }
+    }
+  });
+}
+
+CacheStatistics AdvancedProgramCache::get_statistics() const {
+  return stats_;
 }
 
 void AdvancedProgramCache::print_cache_statistics() const {
@@ -355,6 +585,14 @@ void AdvancedProgramCache::print_cache_statistics() const {
   std::cout << "Cache hits: " << stats.cache_hits.load() << std::endl;
   std::cout << "Cache misses: " << stats.cache_misses.load() << std::endl;
   std::cout << "Hit rate: " << (stats.get_hit_rate() * 100) << "%" << std::endl;
+  std::cout << "Hit rate by tier: verified "
+            << (stats.get_tier_hit_rate(ProgramTier::VERIFIED) * 100)
+            << "%, decoded "
+            << (stats.get_tier_hit_rate(ProgramTier::DECODED) * 100)
+            << "%, JIT " << (stats.get_tier_hit_rate(ProgramTier::JIT) * 100)
+            << "%" << std::endl;
+  std::cout << "Cooperative waits: " << stats.cooperative_waits.load()
+            << std::endl;
   std::cout << "Compilations: " << stats.compilations.load() << std::endl;
   std::cout << "Evictions: " << stats.evictions.load() << std::endl;
   std::cout << "Precompiled: " << stats.precompiled_programs.load()
@@ -373,24 +611,24 @@ ProgramCacheManager::ProgramCacheManager(
 }
 
 bool ProgramCacheManager::load_program(const PublicKey &program_id,
-                                       const std::vector<uint8_t> &bytecode) {
-  return cache_->cache_program(program_id, bytecode);
+                                       const std::vector<uint8_t> &bytecode,
+                                       Slot deployment_slot) {
+  return cache_->cache_program(program_id, bytecode, deployment_slot);
 }
 
-std::shared_ptr<CompiledProgram>
-ProgramCacheManager::execute_program(const PublicKey &program_id) {
-  return cache_->get_program(program_id);
+std::shared_ptr<const CompiledProgram>
+ProgramCacheManager::execute_program(const PublicKey &program_id, Slot slot) {
+  return cache_->get_program(program_id, slot);
 }
 
 void ProgramCacheManager::warm_up_cache(
-    const std::vector<PublicKey> &program_ids) {
+    const std::vector<PublicKey> &program_ids, Slot slot,
+    const AdvancedProgramCache::ProgramLoader &loader) {
   std::cout << "Warming up cache with " << program_ids.size() << " programs..."
             << std::endl;
 
   for (const auto &program_id : program_ids) {
-    // In production, this would load bytecode from storage
-    std::vector<uint8_t> dummy_bytecode(100, 0x42);
-    cache_->precompile_program(program_id, dummy_bytecode);
+    cache_->get_or_load(program_id, slot, loader);
   }
 }
 
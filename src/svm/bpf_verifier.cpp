@@ -1,44 +1,218 @@
 #include "svm/bpf_verifier.h"
-#include <iostream>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <openssl/evp.h>
+#include <unordered_map>
 
 namespace slonana {
 namespace svm {
 
-bool BpfVerifier::verify(const BpfProgram &program) {
-  last_error_.clear();
+namespace {
+
+constexpr uint8_t CLASS_LD = 0x00;
+constexpr uint8_t CLASS_LDX = 0x01;
+constexpr uint8_t CLASS_ST = 0x02;
+constexpr uint8_t CLASS_STX = 0x03;
+constexpr uint8_t CLASS_ALU = 0x04;
+constexpr uint8_t CLASS_JMP = 0x05;
+constexpr uint8_t CLASS_ALU64 = 0x07;
+
+constexpr uint8_t OP_LDDW = 0x18;
+constexpr uint8_t OP_JA = 0x05;
+constexpr uint8_t OP_CALL = 0x85;
+constexpr uint8_t OP_CALLX = 0x8d;
+constexpr uint8_t OP_EXIT = 0x95;
+
+constexpr uint8_t ALU_ADD = 0x00;
+constexpr uint8_t ALU_SUB = 0x10;
+constexpr uint8_t ALU_DIV = 0x30;
+constexpr uint8_t ALU_LSH = 0x60;
+constexpr uint8_t ALU_RSH = 0x70;
+constexpr uint8_t ALU_NEG = 0x80;
+constexpr uint8_t ALU_MOD = 0x90;
+constexpr uint8_t ALU_MOV = 0xb0;
+constexpr uint8_t ALU_ARSH = 0xc0;
+constexpr uint8_t ALU_END = 0xd0;
+
+constexpr uint8_t SOURCE_REG = 0x08;
+constexpr uint8_t INTERNAL_CALL = 1; // src_reg of a CALL to a local function
+constexpr uint8_t FRAME_POINTER = 10;
+constexpr uint8_t INPUT_POINTER = 1;
+constexpr size_t REGISTER_COUNT = 11;
+
+// Per-slot flags gathered by the decode pass
+constexpr uint8_t BLOCK_LEADER = 0x01;
+constexpr uint8_t LDDW_TAIL = 0x02;
+
+uint8_t op_class(uint8_t opcode) { return opcode & 0x07; }
+
+bool is_internal_call(const DecodedOp &op) {
+  return op.opcode == OP_CALL && op.src_reg == INTERNAL_CALL;
+}
 
-  // Basic checks
-  if (program.code.empty()) {
-    last_error_ = "Program code is empty";
+int64_t call_target(size_t pc, const DecodedOp &op) {
+  return static_cast<int64_t>(pc) + 1 + op.immediate;
+}
+
+bool is_valid_opcode(uint8_t opcode) {
+  uint8_t op = opcode & 0xf0;
+  bool reg_source = opcode & SOURCE_REG;
+  switch (op_class(opcode)) {
+  case CLASS_LD:
+    return opcode == OP_LDDW;
+  case CLASS_LDX:
+    return opcode == 0x61 || opcode == 0x69 || opcode == 0x71 ||
+           opcode == 0x79;
+  case CLASS_ST:
+    return opcode == 0x62 || opcode == 0x6a || opcode == 0x72 ||
+           opcode == 0x7a;
+  case CLASS_STX:
+    return opcode == 0x63 || opcode == 0x6b || opcode == 0x73 ||
+           opcode == 0x7b;
+  case CLASS_ALU:
+  case CLASS_ALU64:
+    if (op == ALU_NEG) {
+      return !reg_source;
+    }
+    if (op == ALU_END) {
+      return op_class(opcode) == CLASS_ALU; // le / be
+    }
+    return op <= ALU_ARSH;
+  case CLASS_JMP:
+    if (op == 0x00 || op == 0x90) {
+      return !reg_source; // ja, exit
+    }
+    return op <= 0xd0;
+  default:
     return false;
   }
+}
 
-  // Check instruction count
-  if (!verify_instruction_bounds(program)) {
-    return false;
+int64_t access_size(uint8_t opcode) {
+  switch (opcode & 0x18) {
+  case 0x00:
+    return 4;
+  case 0x08:
+    return 2;
+  case 0x10:
+    return 1;
+  default:
+    return 8;
   }
+}
 
-  // Check jump targets
-  if (!verify_jump_targets(program)) {
-    return false;
+int64_t wrapping_add(int64_t a, int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) +
+                              static_cast<uint64_t>(b));
+}
+
+/**
+ * What the dataflow pass knows about a register: a constant, a pointer at a
+ * known offset from the frame pointer, the input pointer, or nothing
+ */
+struct RegType {
+  enum Kind : uint8_t { UNKNOWN, CONSTANT, STACK, INPUT };
+  Kind kind = UNKNOWN;
+  int64_t value = 0; // Constant, or byte offset from the frame pointer
+
+  bool operator==(const RegType &other) const = default;
+};
+
+using RegState = std::array<RegType, REGISTER_COUNT>;
+
+RegType constant(int64_t value) { return {RegType::CONSTANT, value}; }
+
+struct CachedVerification {
+  std::shared_ptr<const VerifiedProgram> program;
+  std::string error;
+};
+
+struct VerificationCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, CachedVerification> results;
+  std::deque<std::string> insertion_order;
+};
+
+VerificationCache &verification_cache() {
+  static VerificationCache cache;
+  return cache;
+}
+
+} // namespace
+
+bool BpfVerifier::verify(const BpfProgram &program) {
+  return verify_cached(program.code) != nullptr;
+}
+
+std::shared_ptr<const VerifiedProgram>
+BpfVerifier::verify_cached(const std::vector<uint8_t> &bytecode) {
+  auto key = cache_key(bytecode);
+  auto &cache = verification_cache();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.results.find(key);
+    if (it != cache.results.end()) {
+      last_error_ = it->second.error;
+      return it->second.program;
+    }
   }
 
-  // Check memory access patterns
-  if (!verify_memory_access(program)) {
-    return false;
+  auto program = verify_program(bytecode);
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.results.emplace(key, CachedVerification{program, last_error_})
+          .second) {
+    cache.insertion_order.push_back(std::move(key));
+    while (cache.results.size() > MAX_CACHED_RESULTS) {
+      cache.results.erase(cache.insertion_order.front());
+      cache.insertion_order.pop_front();
+    }
   }
+  return program;
+}
 
-  // Check for infinite loops if not allowed
-  if (!allow_infinite_loops_ && !verify_no_infinite_loops(program)) {
-    return false;
+std::shared_ptr<const VerifiedProgram>
+BpfVerifier::verify_program(const std::vector<uint8_t> &bytecode) {
+  last_error_.clear();
+
+  auto program = std::make_shared<VerifiedProgram>();
+  if (!decode_and_build_cfg(bytecode, *program) ||
+      !analyze_dataflow(*program) || !verify_termination(*program)) {
+    return nullptr;
   }
+  return program;
+}
 
-  // Check stack usage
-  if (!verify_stack_usage(program)) {
-    return false;
+std::vector<DecodedOp>
+BpfVerifier::decode(const std::vector<uint8_t> &bytecode) {
+  std::vector<DecodedOp> ops(bytecode.size() / 8);
+  const uint8_t *code = bytecode.data();
+  for (size_t pc = 0; pc < ops.size(); ++pc, code += 8) {
+    DecodedOp &op = ops[pc];
+    op.opcode = code[0];
+    op.dst_reg = code[1] & 0x0F;
+    op.src_reg = code[1] >> 4;
+    op.offset = static_cast<int16_t>(code[2] | (code[3] << 8));
+    op.immediate = static_cast<int32_t>(
+        static_cast<uint32_t>(code[4]) | (static_cast<uint32_t>(code[5]) << 8) |
+        (static_cast<uint32_t>(code[6]) << 16) |
+        (static_cast<uint32_t>(code[7]) << 24));
   }
+  return ops;
+}
 
-  return true;
+size_t BpfVerifier::cached_results() {
+  auto &cache = verification_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.results.size();
+}
+
+void BpfVerifier::clear_cache() {
+  auto &cache = verification_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.results.clear();
+  cache.insertion_order.clear();
 }
 
 void BpfVerifier::set_max_instructions(size_t max_instructions) {
@@ -53,315 +227,378 @@ void BpfVerifier::set_max_stack_depth(size_t max_depth) {
   max_stack_depth_ = max_depth;
 }
 
-bool BpfVerifier::verify_instruction_bounds(const BpfProgram &program) {
-  size_t instruction_count =
-      program.code.size() / 8; // BPF instructions are 8 bytes
-  if (instruction_count > max_instructions_) {
-    last_error_ =
-        "Too many instructions: " + std::to_string(instruction_count) + " > " +
-        std::to_string(max_instructions_);
-    return false;
-  }
-  return true;
+std::string BpfVerifier::cache_key(const std::vector<uint8_t> &bytecode) const {
+  // The result depends on the options as well as the bytecode
+  std::string key(EVP_MAX_MD_SIZE, '\0');
+  unsigned int digest_len = 0;
+  EVP_Digest(bytecode.data(), bytecode.size(),
+             reinterpret_cast<unsigned char *>(key.data()), &digest_len,
+             EVP_sha256(), nullptr);
+  key.resize(digest_len);
+  key += std::to_string(max_instructions_) + ":" +
+         std::to_string(max_stack_depth_) + ":" +
+         (allow_infinite_loops_ ? "1" : "0");
+  return key;
 }
 
-bool BpfVerifier::verify_jump_targets(const BpfProgram &program) {
-  // Production jump target verification - parse instructions and validate all
-  // jumps
-  const size_t instruction_count = program.code.size() / 8;
-  std::vector<bool> valid_targets(instruction_count, false);
-
-  // Mark all instruction starts as valid targets
-  for (size_t i = 0; i < instruction_count; ++i) {
-    valid_targets[i] = true;
+bool BpfVerifier::decode_and_build_cfg(const std::vector<uint8_t> &bytecode,
+                                       VerifiedProgram &program) {
+  if (bytecode.empty()) {
+    last_error_ = "Program code is empty";
+    return false;
+  }
+  if (bytecode.size() % 8 != 0) {
+    last_error_ = "Program size " + std::to_string(bytecode.size()) +
+                  " is not a multiple of 8";
+    return false;
+  }
+  const size_t count = bytecode.size() / 8;
+  if (count > max_instructions_) {
+    last_error_ = "Too many instructions: " + std::to_string(count) + " > " +
+                  std::to_string(max_instructions_);
+    return false;
   }
 
-  // Parse and validate each instruction
-  for (size_t i = 0; i < instruction_count; ++i) {
-    uint64_t instruction = 0;
-    if (i * 8 + 7 < program.code.size()) {
-      for (int j = 0; j < 8; ++j) {
-        instruction |= static_cast<uint64_t>(program.code[i * 8 + j])
-                       << (j * 8);
-      }
+  program.ops = decode(bytecode);
+  const auto &ops = program.ops;
+  std::vector<uint8_t> flags(count + 1, 0);
+  flags[0] = BLOCK_LEADER;
 
-      uint8_t opcode = instruction & 0xFF;
-      int16_t offset = static_cast<int16_t>((instruction >> 16) & 0xFFFF);
+  for (size_t pc = 0; pc < count; ++pc) {
+    const DecodedOp &op = ops[pc];
+    auto fail = [&](const std::string &reason) {
+      last_error_ = reason + " at instruction " + std::to_string(pc);
+      return false;
+    };
 
-      // Check if this is a jump instruction (opcodes 0x05, 0x15, 0x25, 0x35,
-      // etc.)
-      if ((opcode & 0x0F) == 0x05) {
-        int64_t target = static_cast<int64_t>(i) + offset + 1;
+    if (!is_valid_opcode(op.opcode)) {
+      return fail("Unknown opcode " + std::to_string(op.opcode));
+    }
+    if (op.dst_reg >= REGISTER_COUNT || op.src_reg >= REGISTER_COUNT) {
+      return fail("Invalid register");
+    }
 
-        // Validate jump target
-        if (target < 0 || target >= static_cast<int64_t>(instruction_count)) {
-          last_error_ = "Invalid jump target at instruction " +
-                        std::to_string(i) + ": target " +
-                        std::to_string(target) + " out of bounds";
-          return false;
-        }
+    uint8_t cls = op_class(op.opcode);
+    bool writes_dst = cls == CLASS_LD || cls == CLASS_LDX ||
+                      cls == CLASS_ALU || cls == CLASS_ALU64;
+    if (writes_dst && op.dst_reg == FRAME_POINTER) {
+      return fail("Write to the frame pointer r10");
+    }
 
-        if (!valid_targets[target]) {
-          last_error_ =
-              "Jump to invalid target at instruction " + std::to_string(i);
-          return false;
+    switch (cls) {
+    case CLASS_LD:
+      if (pc + 1 >= count) {
+        return fail("LDDW cannot be the last instruction");
+      }
+      if (ops[pc + 1].opcode != 0) {
+        return fail("Incomplete LDDW");
+      }
+      flags[++pc] |= LDDW_TAIL;
+      break;
+    case CLASS_ALU:
+    case CLASS_ALU64: {
+      uint8_t alu = op.opcode & 0xf0;
+      if (op.opcode & SOURCE_REG) {
+        break;
+      }
+      if ((alu == ALU_DIV || alu == ALU_MOD) && op.immediate == 0) {
+        return fail("Division by zero");
+      }
+      int32_t width = cls == CLASS_ALU64 ? 64 : 32;
+      if ((alu == ALU_LSH || alu == ALU_RSH || alu == ALU_ARSH) &&
+          (op.immediate < 0 || op.immediate >= width)) {
+        return fail("Shift by " + std::to_string(op.immediate));
+      }
+      if (alu == ALU_END && op.immediate != 16 && op.immediate != 32 &&
+          op.immediate != 64) {
+        return fail("Invalid endianness width " +
+                    std::to_string(op.immediate));
+      }
+      break;
+    }
+    case CLASS_JMP: {
+      if (is_internal_call(op)) {
+        int64_t target = call_target(pc, op);
+        if (target < 0 || target >= static_cast<int64_t>(count)) {
+          return fail("Call out of code: target " + std::to_string(target));
         }
+        flags[target] |= BLOCK_LEADER;
+      }
+      if (op.opcode == OP_CALL || op.opcode == OP_CALLX) {
+        break; // Calls return to the next instruction
+      }
+      flags[pc + 1] |= BLOCK_LEADER;
+      if (op.opcode == OP_EXIT) {
+        break;
       }
+      int64_t target = static_cast<int64_t>(pc) + 1 + op.offset;
+      if (target < 0 || target >= static_cast<int64_t>(count)) {
+        return fail("Jump out of code: target " + std::to_string(target));
+      }
+      flags[target] |= BLOCK_LEADER;
+      break;
+    }
+    default:
+      break;
     }
   }
 
-  return true;
-}
-
-bool BpfVerifier::verify_memory_access(const BpfProgram &program) {
-  // Production memory access verification - ensure all memory accesses are
-  // bounds-checked
-  const size_t instruction_count = program.code.size() / 8;
-
-  for (size_t i = 0; i < instruction_count; ++i) {
-    uint64_t instruction = 0;
-    if (i * 8 + 7 < program.code.size()) {
-      for (int j = 0; j < 8; ++j) {
-        instruction |= static_cast<uint64_t>(program.code[i * 8 + j])
-                       << (j * 8);
+  // Leaders split the ops into blocks; no jump may land inside an LDDW
+  std::vector<size_t> block_of(count);
+  for (size_t pc = 0; pc < count; ++pc) {
+    if (flags[pc] & BLOCK_LEADER) {
+      if (flags[pc] & LDDW_TAIL) {
+        last_error_ = "Jump into the middle of LDDW at instruction " +
+                      std::to_string(pc);
+        return false;
       }
-
-      uint8_t opcode = instruction & 0xFF;
-      uint8_t reg_dst = (instruction >> 8) & 0x0F;
-      uint8_t reg_src = (instruction >> 12) & 0x0F;
-      int16_t offset = static_cast<int16_t>((instruction >> 16) & 0xFFFF);
-      int32_t imm = static_cast<int32_t>(instruction >> 32);
-
-      // Check memory load/store instructions (opcodes 0x18, 0x61, 0x62, 0x63,
-      // etc.)
-      uint8_t mode = (opcode >> 3) & 0x7;
-      uint8_t op_class = opcode & 0x7;
-
-      if (op_class == 0x6 || op_class == 0x3) { // LD/ST class
-        // Memory access detected - validate bounds checking
-
-        // For stack access (reg 10), check offset bounds
-        if (reg_dst == 10 || reg_src == 10) {
-          if (offset > 0) {
-            last_error_ = "Invalid stack access at instruction " +
-                          std::to_string(i) + ": positive offset " +
-                          std::to_string(offset);
-            return false;
-          }
-          if (offset < -512) {
-            last_error_ = "Stack access out of bounds at instruction " +
-                          std::to_string(i) + ": offset " +
-                          std::to_string(offset) + " too negative";
-            return false;
-          }
-        }
-
-        // For heap/packet access, ensure proper bounds checking exists
-        // This would require more sophisticated control flow analysis in
-        // production
-        if (reg_dst < 10 && reg_src < 10) {
-          // Check if there's a bounds check in recent instructions
-          bool bounds_checked = false;
-          for (size_t j = (i > 5) ? i - 5 : 0; j < i; ++j) {
-            uint64_t check_inst = 0;
-            if (j * 8 + 7 < program.code.size()) {
-              for (int k = 0; k < 8; ++k) {
-                check_inst |= static_cast<uint64_t>(program.code[j * 8 + k])
-                              << (k * 8);
-              }
-              uint8_t check_opcode = check_inst & 0xFF;
-              // Check for comparison instructions (bounds checks)
-              if ((check_opcode & 0xF0) == 0x10 ||
-                  (check_opcode & 0xF0) == 0x20) {
-                bounds_checked = true;
-                break;
-              }
-            }
-          }
-
-          if (!bounds_checked) {
-            // In production, this would be more lenient or sophisticated
-            std::cout
-                << "Warning: Potential unbounded memory access at instruction "
-                << i << std::endl;
-          }
-        }
+      if (!program.blocks.empty()) {
+        program.blocks.back().end = pc;
       }
+      program.blocks.push_back({pc, count, {}});
     }
+    block_of[pc] = program.blocks.size() - 1;
   }
 
+  for (auto &block : program.blocks) {
+    for (size_t pc = block.start; pc < block.end; ++pc) {
+      if (is_internal_call(ops[pc])) {
+        block.callees.push_back(block_of[call_target(pc, ops[pc])]);
+      }
+    }
+    const DecodedOp &last = ops[block.end - 1];
+    bool falls_through = true;
+    if (op_class(last.opcode) == CLASS_JMP && last.opcode != OP_CALL &&
+        last.opcode != OP_CALLX) {
+      if (last.opcode != OP_EXIT) {
+        block.successors.push_back(
+            block_of[static_cast<int64_t>(block.end) + last.offset]);
+      }
+      falls_through = last.opcode != OP_EXIT && last.opcode != OP_JA;
+    }
+    // Running off the end is a runtime error, not a successor
+    if (falls_through && block.end < count &&
+        (block.successors.empty() ||
+         block.successors[0] != block_of[block.end])) {
+      block.successors.push_back(block_of[block.end]);
+    }
+  }
   return true;
 }
 
-bool BpfVerifier::verify_no_infinite_loops(const BpfProgram &program) {
-  // Production infinite loop detection using static analysis
-  const size_t instruction_count = program.code.size() / 8;
-  std::vector<bool> visited(instruction_count, false);
-  std::vector<bool> in_path(instruction_count, false);
-
-  // Perform DFS to detect cycles in the control flow graph
-  std::function<bool(size_t)> dfs = [&](size_t pc) -> bool {
-    if (pc >= instruction_count)
-      return false;
+bool BpfVerifier::analyze_dataflow(VerifiedProgram &program) {
+  const auto &ops = program.ops;
+  const auto &blocks = program.blocks;
+  const auto max_depth = static_cast<int64_t>(max_stack_depth_);
 
-    if (in_path[pc]) {
-      // Back edge found - potential infinite loop
-      last_error_ = "Potential infinite loop detected at instruction " +
-                    std::to_string(pc);
+  RegState entry;
+  for (auto &reg : entry) {
+    reg = constant(0);
+  }
+  entry[INPUT_POINTER] = {RegType::INPUT, 0};
+  entry[FRAME_POINTER] = {RegType::STACK, 0};
+
+  // A callee gets a frame of its own; its arguments and the registers it
+  // inherits are whatever the caller had, so nothing is known about them
+  RegState call_entry;
+  call_entry[FRAME_POINTER] = {RegType::STACK, 0};
+
+  std::vector<RegState> in(blocks.size());
+  std::vector<uint8_t> seen(blocks.size(), 0);
+  std::vector<uint8_t> queued(blocks.size(), 0);
+  std::deque<size_t> worklist{0};
+  in[0] = entry;
+  seen[0] = queued[0] = 1;
+
+  // Stack accesses through a pointer of known offset must stay in the frame
+  auto check_access = [&](const RegType &base, const DecodedOp &op,
+                          size_t pc) {
+    if (base.kind != RegType::STACK) {
+      return true; // Other regions are bounds-checked at runtime
+    }
+    int64_t address = wrapping_add(base.value, op.offset);
+    if (address < -max_depth || address + access_size(op.opcode) > 0) {
+      last_error_ = "Stack access out of bounds at instruction " +
+                    std::to_string(pc) + ": offset " + std::to_string(address);
       return false;
     }
+    program.stack_usage =
+        std::max(program.stack_usage, static_cast<size_t>(-address));
+    return true;
+  };
 
-    if (visited[pc])
-      return true;
-
-    visited[pc] = true;
-    in_path[pc] = true;
-
-    // Parse instruction to find next possible PCs
-    uint64_t instruction = 0;
-    if (pc * 8 + 7 < program.code.size()) {
-      for (int j = 0; j < 8; ++j) {
-        instruction |= static_cast<uint64_t>(program.code[pc * 8 + j])
-                       << (j * 8);
+  // Merge a state into a block's entry state, requeueing it on a change
+  auto propagate = [&](size_t block, const RegState &state) {
+    bool changed = !seen[block];
+    if (changed) {
+      in[block] = state;
+      seen[block] = 1;
+    } else {
+      for (size_t reg = 0; reg < REGISTER_COUNT; ++reg) {
+        if (!(in[block][reg] == state[reg]) &&
+            in[block][reg].kind != RegType::UNKNOWN) {
+          in[block][reg] = RegType{};
+          changed = true;
+        }
       }
+    }
+    if (changed && !queued[block]) {
+      queued[block] = 1;
+      worklist.push_back(block);
+    }
+  };
 
-      uint8_t opcode = instruction & 0xFF;
-      int16_t offset = static_cast<int16_t>((instruction >> 16) & 0xFFFF);
-
-      // Handle different instruction types
-      if (opcode == 0x95) {
-        // Exit instruction - terminates execution
-        in_path[pc] = false;
-        return true;
-      } else if ((opcode & 0x0F) == 0x05) {
-        // Jump instruction
-        size_t next_pc = pc + 1;
-        size_t target_pc = pc + offset + 1;
-
-        // Check both paths for conditional jumps
-        if ((opcode & 0xF0) != 0x00) { // Conditional jump
-          if (!dfs(next_pc) || !dfs(target_pc)) {
-            in_path[pc] = false;
-            return false;
-          }
-        } else { // Unconditional jump
-          if (!dfs(target_pc)) {
-            in_path[pc] = false;
-            return false;
-          }
+  while (!worklist.empty()) {
+    size_t index = worklist.front();
+    worklist.pop_front();
+    queued[index] = 0;
+    RegState state = in[index];
+
+    for (size_t pc = blocks[index].start; pc < blocks[index].end; ++pc) {
+      const DecodedOp &op = ops[pc];
+      RegType &dst = state[op.dst_reg];
+      switch (op_class(op.opcode)) {
+      case CLASS_LD: {
+        uint64_t low = static_cast<uint32_t>(op.immediate);
+        uint64_t high = static_cast<uint32_t>(ops[++pc].immediate);
+        dst = constant(static_cast<int64_t>(low | (high << 32)));
+        break;
+      }
+      case CLASS_LDX:
+        if (!check_access(state[op.src_reg], op, pc)) {
+          return false;
         }
-      } else {
-        // Regular instruction - continue to next
-        if (!dfs(pc + 1)) {
-          in_path[pc] = false;
+        dst = RegType{};
+        break;
+      case CLASS_ST:
+      case CLASS_STX:
+        if (!check_access(dst, op, pc)) {
           return false;
         }
+        break;
+      case CLASS_ALU64: {
+        uint8_t alu = op.opcode & 0xf0;
+        RegType operand = (op.opcode & SOURCE_REG) ? state[op.src_reg]
+                                                   : constant(op.immediate);
+        if (alu == ALU_MOV) {
+          dst = operand;
+        } else if (alu == ALU_ADD && dst.kind == RegType::CONSTANT &&
+                   operand.kind != RegType::UNKNOWN) {
+          dst = {operand.kind, wrapping_add(operand.value, dst.value)};
+        } else if ((alu == ALU_ADD || alu == ALU_SUB) &&
+                   operand.kind == RegType::CONSTANT &&
+                   (dst.kind == RegType::CONSTANT ||
+                    dst.kind == RegType::STACK)) {
+          int64_t delta = alu == ALU_ADD ? operand.value
+                                         : wrapping_add(~operand.value, 1);
+          dst.value = wrapping_add(dst.value, delta);
+        } else {
+          dst = RegType{};
+        }
+        break;
+      }
+      case CLASS_ALU:
+        if (op.opcode == (CLASS_ALU | ALU_MOV)) {
+          dst = constant(static_cast<uint32_t>(op.immediate));
+        } else {
+          dst = RegType{};
+        }
+        break;
+      case CLASS_JMP:
+        if (op.opcode == OP_CALL || op.opcode == OP_CALLX) {
+          for (size_t reg = 0; reg <= 5; ++reg) {
+            state[reg] = RegType{}; // Caller-saved
+          }
+        }
+        break;
+      default:
+        break;
       }
     }
 
-    in_path[pc] = false;
-    return true;
-  };
-
-  return dfs(0);
-}
-
-bool BpfVerifier::verify_stack_usage(const BpfProgram &program) {
-  // Production stack usage verification - track stack depth through all
-  // execution paths
-  const size_t instruction_count = program.code.size() / 8;
-  std::vector<int> stack_depth(instruction_count, -1); // -1 means unvisited
-
-  std::function<bool(size_t, int)> verify_path =
-      [&](size_t pc, int current_depth) -> bool {
-    if (pc >= instruction_count)
-      return true;
-
-    if (current_depth > static_cast<int>(max_stack_depth_)) {
-      last_error_ = "Stack depth exceeded at instruction " +
-                    std::to_string(pc) + ": depth " +
-                    std::to_string(current_depth) + " > max " +
-                    std::to_string(max_stack_depth_);
-      return false;
+    for (size_t callee : blocks[index].callees) {
+      propagate(callee, call_entry);
     }
-
-    if (current_depth < 0) {
-      last_error_ = "Stack underflow at instruction " + std::to_string(pc);
-      return false;
+    for (size_t successor : blocks[index].successors) {
+      propagate(successor, state);
     }
+  }
+  return true;
+}
 
-    if (stack_depth[pc] != -1) {
-      // Already visited this instruction - check consistency
-      if (stack_depth[pc] != current_depth) {
-        last_error_ = "Inconsistent stack depth at instruction " +
-                      std::to_string(pc) + ": expected " +
-                      std::to_string(stack_depth[pc]) + ", got " +
-                      std::to_string(current_depth);
-        return false;
+bool BpfVerifier::verify_termination(VerifiedProgram &program) {
+  const auto &blocks = program.blocks;
+  const size_t count = blocks.size();
+
+  // Back edges: iterative DFS from the entry block. Call edges are walked
+  // too, so called functions are reached, but a cycle through a call is
+  // recursion, which the runtime bounds by call depth, not a loop.
+  enum : uint8_t { WHITE, GREY, BLACK };
+  std::vector<uint8_t> color(count, WHITE);
+  std::vector<std::pair<size_t, size_t>> stack{{0, 0}};
+  color[0] = GREY;
+  while (!stack.empty()) {
+    auto &[block, next] = stack.back();
+    const auto &successors = blocks[block].successors;
+    const auto &callees = blocks[block].callees;
+    if (next < successors.size() + callees.size()) {
+      bool call = next >= successors.size();
+      size_t successor =
+          call ? callees[next - successors.size()] : successors[next];
+      ++next;
+      if (color[successor] == GREY) {
+        program.has_loops |= !call;
+      } else if (color[successor] == WHITE) {
+        color[successor] = GREY;
+        stack.push_back({successor, 0});
       }
-      return true;
+    } else {
+      color[block] = BLACK;
+      stack.pop_back();
     }
+  }
 
-    stack_depth[pc] = current_depth;
-
-    // Parse instruction to determine stack effects
-    uint64_t instruction = 0;
-    if (pc * 8 + 7 < program.code.size()) {
-      for (int j = 0; j < 8; ++j) {
-        instruction |= static_cast<uint64_t>(program.code[pc * 8 + j])
-                       << (j * 8);
-      }
-
-      uint8_t opcode = instruction & 0xFF;
-      int16_t offset = static_cast<int16_t>((instruction >> 16) & 0xFFFF);
-      int new_depth = current_depth;
-
-      // Analyze stack effects based on instruction type
-      uint8_t op_class = opcode & 0x7;
-      uint8_t op_code = (opcode >> 4) & 0xF;
-
-      if (opcode == 0x95) {
-        // Exit instruction
-        return true;
-      } else if (op_class == 0x6) {
-        // Load instructions - might push to stack
-        if ((opcode & 0x18) == 0x18) {
-          new_depth++; // Load immediate pushes value
-        }
-      } else if (op_class == 0x3) {
-        // Store instructions - might pop from stack
-        new_depth--; // Store operations typically pop
-      } else if (op_class == 0x4 || op_class == 0x5) {
-        // ALU operations - most maintain stack depth
-        if (op_code == 0x0) {
-          // Binary operations pop two, push one
-          new_depth--;
-        }
-      }
+  if (allow_infinite_loops_ || !program.has_loops) {
+    return true;
+  }
 
-      // Handle control flow
-      if ((opcode & 0x0F) == 0x05) {
-        // Jump instruction
-        size_t next_pc = pc + 1;
-        size_t target_pc = pc + offset + 1;
-
-        if ((opcode & 0xF0) != 0x00) { // Conditional jump
-          return verify_path(next_pc, new_depth) &&
-                 verify_path(target_pc, new_depth);
-        } else { // Unconditional jump
-          return verify_path(target_pc, new_depth);
-        }
-      } else {
-        // Regular instruction
-        return verify_path(pc + 1, new_depth);
+  // A loop is fine as long as the program can still leave it; blocks with
+  // no successors exit (or run off the end and fault at runtime). Call
+  // edges do not count: a callee's exit returns into its caller's loop.
+  std::vector<std::vector<size_t>> predecessors(count);
+  std::vector<size_t> finishing;
+  for (size_t block = 0; block < count; ++block) {
+    for (size_t successor : blocks[block].successors) {
+      predecessors[successor].push_back(block);
+    }
+    if (blocks[block].successors.empty()) {
+      finishing.push_back(block);
+    }
+  }
+  std::vector<uint8_t> can_finish(count, 0);
+  for (size_t block : finishing) {
+    can_finish[block] = 1;
+  }
+  while (!finishing.empty()) {
+    size_t block = finishing.back();
+    finishing.pop_back();
+    for (size_t predecessor : predecessors[block]) {
+      if (!can_finish[predecessor]) {
+        can_finish[predecessor] = 1;
+        finishing.push_back(predecessor);
       }
     }
+  }
 
-    return true;
-  };
-
-  return verify_path(0, 0);
+  for (size_t block = 0; block < count; ++block) {
+    if (color[block] != WHITE && !can_finish[block]) {
+      last_error_ = "Infinite loop: no exit reachable from instruction " +
+                    std::to_string(blocks[block].start);
+      return false;
+    }
+  }
+  return true;
 }
 
 } // namespace svm
-} // namespace slonana
\ No newline at end of file
+} // namespace slonana
@@ -687,6 +687,7 @@ public:
   std::unordered_map<PublicKey, ProgramAccount> accounts_;
   std::unordered_map<PublicKey, ProgramAccount> pending_changes_;
   bool transaction_active_ = false;
+  CommitListener commit_listener_;
 };
 
 AccountManager::AccountManager() : impl_(std::make_unique<Impl>()) {}
@@ -820,10 +821,20 @@ AccountManager::get_account_balance(const PublicKey &pubkey) const {
 }
 
 common::Result<bool> AccountManager::commit_changes() {
+  std::vector<ProgramAccount> committed;
+  if (impl_->commit_listener_) {
+    committed.reserve(impl_->pending_changes_.size());
+  }
   for (const auto &[pubkey, account] : impl_->pending_changes_) {
     impl_->accounts_[pubkey] = account;
+    if (impl_->commit_listener_) {
+      committed.push_back(account);
+    }
   }
   impl_->pending_changes_.clear();
+  if (!committed.empty()) {
+    impl_->commit_listener_(committed);
+  }
 
   std::cout << "Committed account changes" << std::endl;
   return common::Result<bool>(true);
@@ -834,6 +845,10 @@ void AccountManager::rollback_changes() {
   std::cout << "Rolled back account changes" << std::endl;
 }
 
+void AccountManager::set_commit_listener(CommitListener listener) {
+  impl_->commit_listener_ = std::move(listener);
+}
+
 common::Result<bool> AccountManager::collect_rent(common::Epoch epoch) {
   std::cout << "Collecting rent for epoch " << epoch << std::endl;
 
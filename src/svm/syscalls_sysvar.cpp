@@ -1,4 +1,5 @@
 #include "svm/syscalls.h"
+#include "svm/sysvar_cache.h"
 #include <cstring>
 
 namespace slonana {
@@ -10,20 +11,31 @@ constexpr uint64_t ERROR_INVALID_PUBKEY = 1;
 constexpr uint64_t ERROR_ACCOUNT_NOT_FOUND = 2;
 constexpr uint64_t ERROR_SYSVAR_NOT_FOUND = 3;
 
+namespace {
+
+// Copy a sysvar's prepared bytes out of the current snapshot
+uint64_t copy_sysvar(BuiltinAccount sysvar, uint8_t* result,
+                     uint64_t* result_len)
+{
+    if (result == nullptr || result_len == nullptr) {
+        return ERROR_SYSVAR_NOT_FOUND;
+    }
+    auto snapshot = SysvarCache::current();
+    const auto& data = snapshot->data(sysvar);
+    if (data.empty()) {
+        return ERROR_SYSVAR_NOT_FOUND;
+    }
+    std::memcpy(result, data.data(), data.size());
+    *result_len = data.size();
+    return SUCCESS;
+}
+
+} // namespace
+
 // ============================================================================
 // Epoch Stake Information
 // ============================================================================
 
-/**
- * Epoch Stake Structure
- * 
- * Represents stake information for a vote account in an epoch.
- */
-struct EpochStake {
-    uint64_t activated_stake;
-    uint64_t deactivating_stake;
-};
-
 uint64_t sol_get_epoch_stake(
     const uint8_t* vote_pubkey,
     uint8_t* stake_out,
@@ -34,25 +46,10 @@ uint64_t sol_get_epoch_stake(
         return ERROR_INVALID_PUBKEY;
     }
     
-    // NOTE: Epoch stake information integration pending
-    // This syscall needs to query the actual StakingManager for real stake data
-    // CURRENT BEHAVIOR: Returns hardcoded placeholder (1 SOL activated)
-    // Programs querying stake will get incorrect values
-    // 
-    // Required integration:
-    // 1. Query StakingManager::get_stake_for_vote_account(vote_pubkey)
-    // 2. Return actual activated and deactivating stake amounts
-    // 3. Handle cases where vote account doesn't exist
-    // 
-    // Used by: Staking protocols, delegation programs, validator dashboards
-    // Impact: Medium - affects staking-related programs
-    // 
-    // TODO: Integrate with actual staking system
-    // Effort: 1-2 days
-    
-    EpochStake stake;
-    stake.activated_stake = 1000000000; // 1 SOL in lamports as placeholder
-    stake.deactivating_stake = 0;
+    // Stakes come with the snapshot of the executing bank; see
+    // SysvarSnapshot::defaults() for what is reported before one exists
+    auto snapshot = SysvarCache::current();
+    const EpochStake& stake = snapshot->epoch_stake(vote_pubkey);
     
     // Serialize stake information
     std::memcpy(stake_out, &stake.activated_stake, sizeof(uint64_t));
@@ -67,72 +64,11 @@ uint64_t sol_get_epoch_stake(
 // Epoch Rewards Sysvar
 // ============================================================================
 
-/**
- * Epoch Rewards Structure
- * 
- * Contains information about rewards distribution for the current epoch.
- */
-struct EpochRewards {
-    uint64_t total_rewards;           // Total rewards for the epoch in lamports
-    uint64_t distributed_rewards;     // Rewards already distributed
-    uint64_t distribution_complete_block_height; // Block height when distribution completes
-    uint32_t num_partitions;          // Number of partitions for reward distribution
-    uint8_t parent_blockhash[32];     // Parent blockhash
-};
-
 uint64_t sol_get_epoch_rewards_sysvar(
     uint8_t* result,
     uint64_t* result_len)
 {
-    // Validate input
-    if (result == nullptr || result_len == nullptr) {
-        return ERROR_SYSVAR_NOT_FOUND;
-    }
-    
-    // NOTE: Epoch rewards information integration pending
-    // This syscall needs to query the actual rewards tracking system
-    // CURRENT BEHAVIOR: Returns hardcoded placeholder (100 SOL total, 50 SOL distributed)
-    // Programs querying rewards will get incorrect values
-    // 
-    // Required integration:
-    // 1. Query rewards manager for current epoch rewards data
-    // 2. Track actual distribution progress
-    // 3. Include proper parent blockhash
-    // 
-    // Used by: Staking protocols, yield calculators, reward distribution programs
-    // Impact: Medium - affects reward-related calculations
-    // 
-    // TODO: Integrate with actual rewards system
-    // Effort: 1-2 days
-    
-    EpochRewards rewards;
-    rewards.total_rewards = 100000000000; // 100 SOL as placeholder
-    rewards.distributed_rewards = 50000000000; // 50 SOL distributed
-    rewards.distribution_complete_block_height = 1000;
-    rewards.num_partitions = 4;
-    std::memset(rewards.parent_blockhash, 0, 32);
-    rewards.parent_blockhash[0] = 0xAB; // Some placeholder hash
-    
-    // Serialize rewards information
-    size_t offset = 0;
-    std::memcpy(result + offset, &rewards.total_rewards, sizeof(uint64_t));
-    offset += sizeof(uint64_t);
-    
-    std::memcpy(result + offset, &rewards.distributed_rewards, sizeof(uint64_t));
-    offset += sizeof(uint64_t);
-    
-    std::memcpy(result + offset, &rewards.distribution_complete_block_height, sizeof(uint64_t));
-    offset += sizeof(uint64_t);
-    
-    std::memcpy(result + offset, &rewards.num_partitions, sizeof(uint32_t));
-    offset += sizeof(uint32_t);
-    
-    std::memcpy(result + offset, rewards.parent_blockhash, 32);
-    offset += 32;
-    
-    *result_len = offset;
-    
-    return SUCCESS;
+    return copy_sysvar(BuiltinAccount::EPOCH_REWARDS_SYSVAR, result, result_len);
 }
 
 // ============================================================================
@@ -147,27 +83,37 @@ uint64_t sol_get_last_restart_slot(
         return ERROR_SYSVAR_NOT_FOUND;
     }
     
-    // NOTE: Last restart slot tracking not implemented
-    // This syscall needs to track actual cluster restart events
-    // CURRENT BEHAVIOR: Always returns 0 (indicates no restart or genesis)
-    // Programs checking restart history will see incorrect data
-    // 
-    // Required integration:
-    // 1. Track cluster restart events in validator state
-    // 2. Update on validator initialization from ledger
-    // 3. Persist across validator restarts
-    // 
-    // Used by: Very few programs - mainly for hard fork detection
-    // Impact: Low - most programs don't use this
-    // 
-    // TODO: Integrate with actual cluster restart tracking
-    // Effort: 0.5 days
-    
-    // Return slot 0 as placeholder (indicates no restart or genesis)
-    *slot_out = 0;
+    // NOTE: cluster restarts are not tracked yet, so every snapshot carries
+    // slot 0 (no restart since genesis)
+    *slot_out = SysvarCache::current()->last_restart_slot();
     
     return SUCCESS;
 }
 
+// ============================================================================
+// Clock, Rent and EpochSchedule Sysvars
+// ============================================================================
+
+uint64_t sol_get_clock_sysvar(
+    uint8_t* result,
+    uint64_t* result_len)
+{
+    return copy_sysvar(BuiltinAccount::CLOCK_SYSVAR, result, result_len);
+}
+
+uint64_t sol_get_rent_sysvar(
+    uint8_t* result,
+    uint64_t* result_len)
+{
+    return copy_sysvar(BuiltinAccount::RENT_SYSVAR, result, result_len);
+}
+
+uint64_t sol_get_epoch_schedule_sysvar(
+    uint8_t* result,
+    uint64_t* result_len)
+{
+    return copy_sysvar(BuiltinAccount::EPOCH_SCHEDULE_SYSVAR, result, result_len);
+}
+
 } // namespace svm
 } // namespace slonana
@@ -0,0 +1,499 @@
+#include "svm/sysvar_cache.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+namespace slonana {
+namespace svm {
+
+namespace {
+
+struct BuiltinKey {
+  BuiltinAccount account;
+  std::array<uint8_t, 32> key;
+};
+
+// Keys of the builtins, base58-decoded
+constexpr std::array<BuiltinKey, 22> BUILTIN_KEYS = {{
+    // 11111111111111111111111111111111
+    {BuiltinAccount::SYSTEM_PROGRAM,
+     {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    // Vote111111111111111111111111111111111111111
+    {BuiltinAccount::VOTE_PROGRAM,
+     {0x07, 0x61, 0x48, 0x1d, 0x35, 0x74, 0x74, 0xbb, 0x7c, 0x4d, 0x76,
+      0x24, 0xeb, 0xd3, 0xbd, 0xb3, 0xd8, 0x35, 0x5e, 0x73, 0xd1, 0x10,
+      0x43, 0xfc, 0x0d, 0xa3, 0x53, 0x80, 0x00, 0x00, 0x00, 0x00}},
+    // Stake11111111111111111111111111111111111111
+    {BuiltinAccount::STAKE_PROGRAM,
+     {0x06, 0xa1, 0xd8, 0x17, 0x91, 0x37, 0x54, 0x2a, 0x98, 0x34, 0x37,
+      0xbd, 0xfe, 0x2a, 0x7a, 0xb2, 0x55, 0x7f, 0x53, 0x5c, 0x8a, 0x78,
+      0x72, 0x2b, 0x68, 0xa4, 0x9d, 0xc0, 0x00, 0x00, 0x00, 0x00}},
+    // Config1111111111111111111111111111111111111
+    {BuiltinAccount::CONFIG_PROGRAM,
+     {0x03, 0x06, 0x4a, 0xa3, 0x00, 0x2f, 0x74, 0xdc, 0xc8, 0x6e, 0x43,
+      0x31, 0x0f, 0x0c, 0x05, 0x2a, 0xf8, 0xc5, 0xda, 0x27, 0xf6, 0x10,
+      0x40, 0x19, 0xa3, 0x23, 0xef, 0xa0, 0x00, 0x00, 0x00, 0x00}},
+    // ComputeBudget111111111111111111111111111111
+    {BuiltinAccount::COMPUTE_BUDGET_PROGRAM,
+     {0x03, 0x06, 0x46, 0x6f, 0xe5, 0x21, 0x17, 0x32, 0xff, 0xec, 0xad,
+      0xba, 0x72, 0xc3, 0x9b, 0xe7, 0xbc, 0x8c, 0xe5, 0xbb, 0xc5, 0xf7,
+      0x12, 0x6b, 0x2c, 0x43, 0x9b, 0x3a, 0x40, 0x00, 0x00, 0x00}},
+    // AddressLookupTab1e1111111111111111111111111
+    {BuiltinAccount::ADDRESS_LOOKUP_TABLE_PROGRAM,
+     {0x02, 0x77, 0xa6, 0xaf, 0x97, 0x33, 0x9b, 0x7a, 0xc8, 0x8d, 0x18,
+      0x92, 0xc9, 0x04, 0x46, 0xf5, 0x00, 0x02, 0x30, 0x92, 0x66, 0xf6,
+      0x2e, 0x53, 0xc1, 0x18, 0x24, 0x49, 0x82, 0x00, 0x00, 0x00}},
+    // BPFLoader2111111111111111111111111111111111
+    {BuiltinAccount::BPF_LOADER,
+     {0x02, 0xa8, 0xf6, 0x91, 0x4e, 0x88, 0xa1, 0x6e, 0x39, 0x5a, 0xe1,
+      0x28, 0x94, 0x8f, 0xfa, 0x69, 0x56, 0x93, 0x37, 0x68, 0x18, 0xdd,
+      0x47, 0x43, 0x52, 0x21, 0xf3, 0xc6, 0x00, 0x00, 0x00, 0x00}},
+    // BPFLoaderUpgradeab1e11111111111111111111111
+    {BuiltinAccount::BPF_LOADER_UPGRADEABLE,
+     {0x02, 0xa8, 0xf6, 0x91, 0x4e, 0x88, 0xa1, 0xb0, 0xe2, 0x10, 0x15,
+      0x3e, 0xf7, 0x63, 0xae, 0x2b, 0x00, 0xc2, 0xb9, 0x3d, 0x16, 0xc1,
+      0x24, 0xd2, 0xc0, 0x53, 0x7a, 0x10, 0x04, 0x80, 0x00, 0x00}},
+    // NativeLoader1111111111111111111111111111111
+    {BuiltinAccount::NATIVE_LOADER,
+     {0x05, 0x87, 0x84, 0xbf, 0x14, 0x8b, 0xa4, 0x28, 0x2f, 0xb0, 0x12,
+      0x57, 0x48, 0x88, 0xa9, 0xf1, 0x53, 0xa0, 0x7d, 0xad, 0xf7, 0x65,
+      0xc0, 0x45, 0x5c, 0x9a, 0x97, 0x03, 0x80, 0x00, 0x00, 0x00}},
+    // TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA
+    {BuiltinAccount::TOKEN_PROGRAM,
+     {0x06, 0xdd, 0xf6, 0xe1, 0xd7, 0x65, 0xa1, 0x93, 0xd9, 0xcb, 0xe1,
+      0x46, 0xce, 0xeb, 0x79, 0xac, 0x1c, 0xb4, 0x85, 0xed, 0x5f, 0x5b,
+      0x37, 0x91, 0x3a, 0x8c, 0xf5, 0x85, 0x7e, 0xff, 0x00, 0xa9}},
+    // TokenzQdBNbLqP5VEhdkAS6EPFLC1PHnBqCXEpPxuEb
+    {BuiltinAccount::TOKEN_2022_PROGRAM,
+     {0x06, 0xdd, 0xf6, 0xe1, 0xee, 0x75, 0x8f, 0xde, 0x18, 0x42, 0x5d,
+      0xbc, 0xe4, 0x6c, 0xcd, 0xda, 0xb6, 0x1a, 0xfc, 0x4d, 0x83, 0xb9,
+      0x0d, 0x27, 0xfe, 0xbd, 0xf9, 0x28, 0xd8, 0xa1, 0x8b, 0xfc}},
+    // ATokenGPvbdGVxr1b2hvZbsiqW5xWH25efTNsLJA8knL
+    {BuiltinAccount::ASSOCIATED_TOKEN_PROGRAM,
+     {0x8c, 0x97, 0x25, 0x8f, 0x4e, 0x24, 0x89, 0xf1, 0xbb, 0x3d, 0x10,
+      0x29, 0x14, 0x8e, 0x0d, 0x83, 0x0b, 0x5a, 0x13, 0x99, 0xda, 0xff,
+      0x10, 0x84, 0x04, 0x8e, 0x7b, 0xd8, 0xdb, 0xe9, 0xf8, 0x59}},
+    // MemoSq4gqABAXKb96qnH8TysNcWxMyWCqXgDLGmfcHr
+    {BuiltinAccount::MEMO_PROGRAM,
+     {0x05, 0x4a, 0x53, 0x5a, 0x99, 0x29, 0x21, 0x06, 0x4d, 0x24, 0xe8,
+      0x71, 0x60, 0xda, 0x38, 0x7c, 0x7c, 0x35, 0xb5, 0xdd, 0xbc, 0x92,
+      0xbb, 0x81, 0xe4, 0x1f, 0xa8, 0x40, 0x41, 0x05, 0x44, 0x8d}},
+    // SysvarC1ock11111111111111111111111111111111
+    {BuiltinAccount::CLOCK_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x18, 0xc7, 0x74, 0xc9, 0x28, 0x56, 0x63,
+      0x98, 0x69, 0x1d, 0x5e, 0xb6, 0x8b, 0x5e, 0xb8, 0xa3, 0x9b, 0x4b,
+      0x6d, 0x5c, 0x73, 0x55, 0x5b, 0x21, 0x00, 0x00, 0x00, 0x00}},
+    // SysvarRent111111111111111111111111111111111
+    {BuiltinAccount::RENT_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x19, 0x2c, 0x5c, 0x51, 0x21, 0x8c, 0xc9,
+      0x4c, 0x3d, 0x4a, 0xf1, 0x7f, 0x58, 0xda, 0xee, 0x08, 0x9b, 0xa1,
+      0xfd, 0x44, 0xe3, 0xdb, 0xd9, 0x8a, 0x00, 0x00, 0x00, 0x00}},
+    // SysvarEpochSchedu1e111111111111111111111111
+    {BuiltinAccount::EPOCH_SCHEDULE_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x18, 0xdc, 0x3f, 0xee, 0x02, 0xd3, 0xe4,
+      0x7f, 0x01, 0x00, 0xf8, 0xb0, 0x54, 0xf7, 0x94, 0x2e, 0x60, 0x59,
+      0x1e, 0x3f, 0x50, 0x87, 0x19, 0xa8, 0x05, 0x00, 0x00, 0x00}},
+    // SysvarEpochRewards1111111111111111111111111
+    {BuiltinAccount::EPOCH_REWARDS_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x18, 0xdc, 0x3f, 0xee, 0x02, 0xa5, 0x58,
+      0xbf, 0x83, 0xce, 0x66, 0xe1, 0x44, 0x42, 0x2a, 0x1c, 0x34, 0x95,
+      0x0b, 0x27, 0xc1, 0x86, 0x9b, 0x5a, 0x9c, 0x00, 0x00, 0x00}},
+    // SysvarLastRestartS1ot1111111111111111111111
+    {BuiltinAccount::LAST_RESTART_SLOT_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x19, 0x06, 0xdd, 0xe1, 0xcd, 0x3f, 0x94,
+      0x7d, 0xca, 0xb4, 0xc8, 0xf4, 0xf4, 0xf5, 0x1b, 0xad, 0x0f, 0x98,
+      0x13, 0xb8, 0x00, 0xd2, 0x89, 0x47, 0x1f, 0xc0, 0x00, 0x00}},
+    // SysvarS1otHashes111111111111111111111111111
+    {BuiltinAccount::SLOT_HASHES_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x19, 0x2f, 0x0a, 0xaf, 0xc6, 0xf2, 0x65,
+      0xe3, 0xfb, 0x77, 0xcc, 0x7a, 0xda, 0x82, 0xc5, 0x29, 0xd0, 0xbe,
+      0x3b, 0x13, 0x6e, 0x2d, 0x00, 0x55, 0x20, 0x00, 0x00, 0x00}},
+    // SysvarStakeHistory1111111111111111111111111
+    {BuiltinAccount::STAKE_HISTORY_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x19, 0x35, 0x84, 0xd0, 0xfe, 0xed, 0x9b,
+      0xb3, 0x43, 0x1d, 0x13, 0x20, 0x6b, 0xe5, 0x44, 0x28, 0x1b, 0x57,
+      0xb8, 0x56, 0x6c, 0xc5, 0x37, 0x5f, 0xf4, 0x00, 0x00, 0x00}},
+    // Sysvar1nstructions1111111111111111111111111
+    {BuiltinAccount::INSTRUCTIONS_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x18, 0x7b, 0xd1, 0x66, 0x35, 0xda, 0xd4,
+      0x04, 0x55, 0xfd, 0xc2, 0xc0, 0xc1, 0x24, 0xc6, 0x8f, 0x21, 0x56,
+      0x75, 0xa5, 0xdb, 0xba, 0xcb, 0x5f, 0x08, 0x00, 0x00, 0x00}},
+    // SysvarRecentB1ockHashes11111111111111111111
+    {BuiltinAccount::RECENT_BLOCKHASHES_SYSVAR,
+     {0x06, 0xa7, 0xd5, 0x17, 0x19, 0x2c, 0x56, 0x8e, 0xe0, 0x8a, 0x84,
+      0x5f, 0x73, 0xd2, 0x97, 0x88, 0xcf, 0x03, 0x5c, 0x31, 0x45, 0xb2,
+      0x1a, 0xb3, 0x44, 0xd8, 0x06, 0x2e, 0xa9, 0x40, 0x00, 0x00}},
+}};
+
+// Sysvar1111111111111111111111111111111111111, owner of every sysvar
+constexpr std::array<uint8_t, 32> SYSVAR_OWNER = {
+    0x06, 0xa7, 0xd5, 0x17, 0x18, 0x75, 0xf7, 0x29, 0xc7, 0x3d, 0x93,
+    0x40, 0x8f, 0x21, 0x61, 0x20, 0x06, 0x7e, 0xd8, 0x8c, 0x76, 0xe0,
+    0x8c, 0x28, 0x7f, 0xc1, 0x94, 0x60, 0x00, 0x00, 0x00, 0x00};
+
+// Multiplicative hash of key bytes 8..15 into 2^TABLE_BITS slots; the
+// multiplier was searched for to place every builtin in its own slot
+constexpr uint64_t HASH_MULTIPLIER = 0x34fb86ba83b3b23bULL;
+constexpr unsigned TABLE_BITS = 5;
+constexpr uint8_t EMPTY_SLOT = 0xff;
+
+constexpr size_t table_slot(const uint8_t *key) {
+  uint64_t word = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    word |= static_cast<uint64_t>(key[8 + i]) << (8 * i);
+  }
+  return static_cast<size_t>((word * HASH_MULTIPLIER) >> (64 - TABLE_BITS));
+}
+
+constexpr std::array<uint8_t, size_t{1} << TABLE_BITS> build_table() {
+  std::array<uint8_t, size_t{1} << TABLE_BITS> table{};
+  for (auto &slot : table) {
+    slot = EMPTY_SLOT;
+  }
+  for (size_t i = 0; i < BUILTIN_KEYS.size(); ++i) {
+    table[table_slot(BUILTIN_KEYS[i].key.data())] = static_cast<uint8_t>(i);
+  }
+  return table;
+}
+
+constexpr auto BUILTIN_TABLE = build_table();
+
+constexpr bool table_is_perfect() {
+  for (size_t i = 0; i < BUILTIN_KEYS.size(); ++i) {
+    if (BUILTIN_TABLE[table_slot(BUILTIN_KEYS[i].key.data())] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(table_is_perfect(),
+              "builtin keys collide; search for a new HASH_MULTIPLIER");
+
+// Order of SysvarSnapshot::accounts_
+constexpr std::array<BuiltinAccount, 5> SNAPSHOT_SYSVARS = {
+    BuiltinAccount::CLOCK_SYSVAR, BuiltinAccount::RENT_SYSVAR,
+    BuiltinAccount::EPOCH_SCHEDULE_SYSVAR,
+    BuiltinAccount::EPOCH_REWARDS_SYSVAR,
+    BuiltinAccount::LAST_RESTART_SLOT_SYSVAR};
+
+size_t snapshot_index(BuiltinAccount sysvar) {
+  return static_cast<size_t>(
+      std::find(SNAPSHOT_SYSVARS.begin(), SNAPSHOT_SYSVARS.end(), sysvar) -
+      SNAPSHOT_SYSVARS.begin());
+}
+
+template <typename T> void append(std::vector<uint8_t> &out, T value) {
+  uint8_t bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+std::shared_ptr<const AccountInfo> sysvar_account(BuiltinAccount sysvar,
+                                                  std::vector<uint8_t> data) {
+  auto account = std::make_shared<AccountInfo>();
+  account->pubkey = builtin_account_key(sysvar);
+  account->is_signer = false;
+  account->is_writable = false;
+  // Rent-exempt minimum at the default rate
+  account->lamports = (128 + data.size()) * 3480 * 2;
+  account->data = std::move(data);
+  account->owner.assign(SYSVAR_OWNER.begin(), SYSVAR_OWNER.end());
+  account->executable = false;
+  account->rent_epoch = 0;
+  return account;
+}
+
+const char *builtin_program_name(BuiltinAccount account) {
+  switch (account) {
+  case BuiltinAccount::SYSTEM_PROGRAM:
+    return "system_program";
+  case BuiltinAccount::VOTE_PROGRAM:
+    return "vote_program";
+  case BuiltinAccount::STAKE_PROGRAM:
+    return "stake_program";
+  case BuiltinAccount::CONFIG_PROGRAM:
+    return "config_program";
+  case BuiltinAccount::COMPUTE_BUDGET_PROGRAM:
+    return "compute_budget_program";
+  case BuiltinAccount::ADDRESS_LOOKUP_TABLE_PROGRAM:
+    return "address_lookup_table_program";
+  case BuiltinAccount::BPF_LOADER:
+    return "bpf_loader";
+  case BuiltinAccount::BPF_LOADER_UPGRADEABLE:
+    return "bpf_loader_upgradeable";
+  case BuiltinAccount::NATIVE_LOADER:
+    return "native_loader";
+  case BuiltinAccount::TOKEN_PROGRAM:
+    return "spl_token";
+  case BuiltinAccount::TOKEN_2022_PROGRAM:
+    return "spl_token_2022";
+  case BuiltinAccount::ASSOCIATED_TOKEN_PROGRAM:
+    return "spl_associated_token_account";
+  case BuiltinAccount::MEMO_PROGRAM:
+    return "spl_memo";
+  default:
+    return nullptr;
+  }
+}
+
+thread_local const std::shared_ptr<const SysvarSnapshot> *scoped_snapshot =
+    nullptr;
+
+std::atomic<std::shared_ptr<const SysvarSnapshot>> &installed_snapshot() {
+  static std::atomic<std::shared_ptr<const SysvarSnapshot>> snapshot{
+      SysvarSnapshot::defaults()};
+  return snapshot;
+}
+
+} // namespace
+
+// Builtin lookup
+
+BuiltinAccount lookup_builtin_account(const uint8_t *key, size_t length) {
+  if (length != 32) {
+    return BuiltinAccount::NONE;
+  }
+  uint8_t index = BUILTIN_TABLE[table_slot(key)];
+  if (index == EMPTY_SLOT ||
+      std::memcmp(BUILTIN_KEYS[index].key.data(), key, 32) != 0) {
+    return BuiltinAccount::NONE;
+  }
+  return BUILTIN_KEYS[index].account;
+}
+
+bool is_sysvar(BuiltinAccount account) {
+  return account >= BuiltinAccount::CLOCK_SYSVAR;
+}
+
+PublicKey builtin_account_key(BuiltinAccount account) {
+  for (const auto &builtin : BUILTIN_KEYS) {
+    if (builtin.account == account) {
+      return PublicKey(builtin.key.begin(), builtin.key.end());
+    }
+  }
+  return {};
+}
+
+std::shared_ptr<const AccountInfo>
+builtin_program_account(BuiltinAccount account) {
+  static const auto programs = [] {
+    std::array<std::shared_ptr<const AccountInfo>, BUILTIN_KEYS.size() + 1>
+        result{};
+    auto loader = builtin_account_key(BuiltinAccount::NATIVE_LOADER);
+    for (const auto &builtin : BUILTIN_KEYS) {
+      const char *name = builtin_program_name(builtin.account);
+      if (!name) {
+        continue;
+      }
+      auto program = std::make_shared<AccountInfo>();
+      program->pubkey.assign(builtin.key.begin(), builtin.key.end());
+      program->is_signer = false;
+      program->is_writable = false;
+      program->lamports = 1;
+      program->data.assign(name, name + std::strlen(name));
+      program->owner = loader;
+      program->executable = true;
+      program->rent_epoch = 0;
+      result[static_cast<size_t>(builtin.account)] = std::move(program);
+    }
+    return result;
+  }();
+  auto index = static_cast<size_t>(account);
+  return index < programs.size() ? programs[index] : nullptr;
+}
+
+// EpochScheduleSysvar
+
+EpochScheduleSysvar EpochScheduleSysvar::create(uint64_t slots_per_epoch,
+                                                bool warmup) {
+  EpochScheduleSysvar schedule;
+  schedule.slots_per_epoch = slots_per_epoch;
+  schedule.leader_schedule_slot_offset = slots_per_epoch;
+  schedule.warmup = warmup;
+  if (warmup && slots_per_epoch > MINIMUM_SLOTS_PER_EPOCH) {
+    schedule.first_normal_epoch =
+        std::countr_zero(std::bit_ceil(slots_per_epoch)) -
+        std::countr_zero(MINIMUM_SLOTS_PER_EPOCH);
+    schedule.first_normal_slot =
+        ((uint64_t{1} << schedule.first_normal_epoch) - 1) *
+        MINIMUM_SLOTS_PER_EPOCH;
+  }
+  return schedule;
+}
+
+uint64_t EpochScheduleSysvar::get_epoch(Slot slot) const {
+  if (slot < first_normal_slot) {
+    return std::countr_zero(std::bit_ceil(slot + MINIMUM_SLOTS_PER_EPOCH + 1)) -
+           std::countr_zero(MINIMUM_SLOTS_PER_EPOCH) - 1;
+  }
+  return first_normal_epoch + (slot - first_normal_slot) / slots_per_epoch;
+}
+
+Slot EpochScheduleSysvar::get_first_slot_in_epoch(uint64_t epoch) const {
+  if (epoch <= first_normal_epoch) {
+    return ((uint64_t{1} << epoch) - 1) * MINIMUM_SLOTS_PER_EPOCH;
+  }
+  return (epoch - first_normal_epoch) * slots_per_epoch + first_normal_slot;
+}
+
+uint64_t EpochScheduleSysvar::get_leader_schedule_epoch(Slot slot) const {
+  if (slot < first_normal_slot) {
+    return get_epoch(slot) + 1;
+  }
+  return first_normal_epoch +
+         (slot - first_normal_slot + leader_schedule_slot_offset) /
+             slots_per_epoch;
+}
+
+// SysvarSnapshot
+
+SysvarSnapshot::SysvarSnapshot(
+    const ClockSysvar &clock, const RentSysvar &rent,
+    const EpochScheduleSysvar &epoch_schedule,
+    const EpochRewardsSysvar &epoch_rewards, Slot last_restart_slot,
+    std::unordered_map<PublicKey, EpochStake> epoch_stakes,
+    EpochStake unlisted_stake)
+    : clock_(clock), rent_(rent), epoch_schedule_(epoch_schedule),
+      epoch_rewards_(epoch_rewards), last_restart_slot_(last_restart_slot),
+      epoch_stakes_(std::move(epoch_stakes)), unlisted_stake_(unlisted_stake) {
+  std::vector<uint8_t> data;
+  data.reserve(40);
+  append(data, clock_.slot);
+  append(data, clock_.epoch_start_timestamp);
+  append(data, clock_.epoch);
+  append(data, clock_.leader_schedule_epoch);
+  append(data, clock_.unix_timestamp);
+  accounts_[0] = sysvar_account(BuiltinAccount::CLOCK_SYSVAR, std::move(data));
+
+  data.clear();
+  append(data, rent_.lamports_per_byte_year);
+  append(data, rent_.exemption_threshold);
+  append(data, rent_.burn_percent);
+  accounts_[1] = sysvar_account(BuiltinAccount::RENT_SYSVAR, std::move(data));
+
+  data.clear();
+  append(data, epoch_schedule_.slots_per_epoch);
+  append(data, epoch_schedule_.leader_schedule_slot_offset);
+  append(data, static_cast<uint8_t>(epoch_schedule_.warmup));
+  append(data, epoch_schedule_.first_normal_epoch);
+  append(data, epoch_schedule_.first_normal_slot);
+  accounts_[2] =
+      sysvar_account(BuiltinAccount::EPOCH_SCHEDULE_SYSVAR, std::move(data));
+
+  data.clear();
+  append(data, epoch_rewards_.total_rewards);
+  append(data, epoch_rewards_.distributed_rewards);
+  append(data, epoch_rewards_.distribution_complete_block_height);
+  append(data, epoch_rewards_.num_partitions);
+  data.insert(data.end(), epoch_rewards_.parent_blockhash.begin(),
+              epoch_rewards_.parent_blockhash.end());
+  accounts_[3] =
+      sysvar_account(BuiltinAccount::EPOCH_REWARDS_SYSVAR, std::move(data));
+
+  data.clear();
+  append(data, last_restart_slot_);
+  accounts_[4] =
+      sysvar_account(BuiltinAccount::LAST_RESTART_SLOT_SYSVAR, std::move(data));
+}
+
+std::shared_ptr<const SysvarSnapshot>
+SysvarSnapshot::genesis(int64_t genesis_timestamp,
+                        const EpochScheduleSysvar &epoch_schedule,
+                        const RentSysvar &rent) {
+  ClockSysvar clock;
+  clock.epoch_start_timestamp = genesis_timestamp;
+  clock.unix_timestamp = genesis_timestamp;
+  clock.leader_schedule_epoch = epoch_schedule.get_leader_schedule_epoch(0);
+  return std::make_shared<const SysvarSnapshot>(clock, rent, epoch_schedule,
+                                                EpochRewardsSysvar{}, 0);
+}
+
+std::shared_ptr<const SysvarSnapshot>
+SysvarSnapshot::for_slot(const SysvarSnapshot &parent, Slot slot) {
+  const auto &schedule = parent.epoch_schedule_;
+  ClockSysvar clock;
+  clock.slot = slot;
+  clock.epoch = schedule.get_epoch(slot);
+  clock.leader_schedule_epoch = schedule.get_leader_schedule_epoch(slot);
+  clock.unix_timestamp =
+      parent.clock_.unix_timestamp +
+      static_cast<int64_t>(slot * 400 / 1000) -
+      static_cast<int64_t>(parent.clock_.slot * 400 / 1000);
+  clock.epoch_start_timestamp = clock.epoch == parent.clock_.epoch
+                                    ? parent.clock_.epoch_start_timestamp
+                                    : clock.unix_timestamp;
+  return std::make_shared<const SysvarSnapshot>(
+      clock, parent.rent_, schedule, parent.epoch_rewards_,
+      parent.last_restart_slot_, parent.epoch_stakes_, parent.unlisted_stake_);
+}
+
+const std::shared_ptr<const SysvarSnapshot> &SysvarSnapshot::defaults() {
+  // NOTE: rewards and stake are placeholders (100 SOL total rewards with
+  // 50 SOL distributed, 1 SOL of stake for any vote account) until the
+  // rewards and staking systems feed real values into bank snapshots
+  static const auto snapshot = [] {
+    EpochRewardsSysvar rewards;
+    rewards.total_rewards = 100000000000;
+    rewards.distributed_rewards = 50000000000;
+    rewards.distribution_complete_block_height = 1000;
+    rewards.num_partitions = 4;
+    rewards.parent_blockhash[0] = 0xAB;
+    return std::make_shared<const SysvarSnapshot>(
+        ClockSysvar{}, RentSysvar{}, EpochScheduleSysvar{}, rewards, 0,
+        std::unordered_map<PublicKey, EpochStake>{},
+        EpochStake{1000000000, 0});
+  }();
+  return snapshot;
+}
+
+const EpochStake &SysvarSnapshot::epoch_stake(const uint8_t *vote_pubkey) const {
+  if (!epoch_stakes_.empty()) {
+    auto it = epoch_stakes_.find(PublicKey(vote_pubkey, vote_pubkey + 32));
+    if (it != epoch_stakes_.end()) {
+      return it->second;
+    }
+  }
+  return unlisted_stake_;
+}
+
+const std::vector<uint8_t> &SysvarSnapshot::data(BuiltinAccount sysvar) const {
+  static const std::vector<uint8_t> empty;
+  size_t index = snapshot_index(sysvar);
+  return index < accounts_.size() ? accounts_[index]->data : empty;
+}
+
+std::shared_ptr<const AccountInfo>
+SysvarSnapshot::account(BuiltinAccount sysvar) const {
+  size_t index = snapshot_index(sysvar);
+  return index < accounts_.size() ? accounts_[index] : nullptr;
+}
+
+// SysvarCache
+
+std::shared_ptr<const SysvarSnapshot> SysvarCache::current() {
+  if (scoped_snapshot) {
+    return *scoped_snapshot;
+  }
+  return installed_snapshot().load(std::memory_order_acquire);
+}
+
+void SysvarCache::install(std::shared_ptr<const SysvarSnapshot> snapshot) {
+  installed_snapshot().store(snapshot ? std::move(snapshot)
+                                      : SysvarSnapshot::defaults(),
+                             std::memory_order_release);
+}
+
+SysvarCache::Scope::Scope(
+    const std::shared_ptr<const SysvarSnapshot> &snapshot)
+    : previous_(scoped_snapshot) {
+  scoped_snapshot = &snapshot;
+}
+
+SysvarCache::Scope::~Scope() { scoped_snapshot = previous_; }
+
+} // namespace svm
+} // namespace slonana
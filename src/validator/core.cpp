@@ -1,12 +1,16 @@
 #include "validator/core.h"
 #include "common/logging.h"
+#include "consensus/leader_schedule.h"
 #include "consensus/proof_of_history.h"
 #include "monitoring/consensus_metrics.h"
+#include "network/rpc_json.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <mutex>
 #include <openssl/evp.h>
 #include <sstream>
+#include <unordered_map>
 
 namespace slonana {
 namespace validator {
@@ -474,6 +478,11 @@ public:
   bool running_ = false;
   VoteCallback vote_callback_;
   BlockCallback block_callback_;
+  std::shared_ptr<consensus::LeaderScheduleCache> leader_schedule_;
+
+  // Epoch whose stakes the QUIC server's stream quotas were last built from
+  std::mutex quic_stakes_mutex_;
+  Epoch quic_stakes_epoch_ = UINT64_MAX;
 };
 
 ValidatorCore::ValidatorCore(std::shared_ptr<ledger::LedgerManager> ledger,
@@ -630,6 +639,11 @@ void ValidatorCore::process_block(const ledger::Block &block) {
                 << " (total processing time: " << processing_time * 1000
                 << "ms, PoH sequence: " << poh_sequence << ")" << std::endl;
 
+      if (impl_->leader_schedule_) {
+        impl_->leader_schedule_->notify_slot(block.slot);
+      }
+      refresh_quic_stakes(block.slot);
+
       if (impl_->block_callback_) {
         impl_->block_callback_(block);
       }
@@ -764,6 +778,11 @@ uint64_t ForkChoice::get_confirmation_depth(const Hash &fork_head) const {
 }
 
 std::string ValidatorCore::get_slot_leader(Slot slot) const {
+  if (impl_->leader_schedule_) {
+    auto leader = impl_->leader_schedule_->slot_leader(slot);
+    return leader ? network::rpc_json::encode_base58(*leader) : std::string();
+  }
+
   // Production implementation: Calculate slot leader based on stake weights and
   // VRF
   std::hash<uint64_t> hasher;
@@ -777,6 +796,21 @@ std::string ValidatorCore::get_slot_leader(Slot slot) const {
   return leader_stream.str();
 }
 
+void ValidatorCore::set_leader_schedule(
+    std::shared_ptr<consensus::LeaderScheduleCache> leader_schedule) {
+  impl_->leader_schedule_ = std::move(leader_schedule);
+  {
+    std::lock_guard<std::mutex> lock(impl_->quic_stakes_mutex_);
+    impl_->quic_stakes_epoch_ = UINT64_MAX;
+  }
+  refresh_quic_stakes(get_blockchain_head_slot());
+}
+
+std::shared_ptr<consensus::LeaderScheduleCache>
+ValidatorCore::get_leader_schedule() const {
+  return impl_->leader_schedule_;
+}
+
 void ValidatorCore::process_transaction(
     std::shared_ptr<ledger::Transaction> transaction) {
   if (!impl_->running_ || !banking_stage_) {
@@ -804,11 +838,31 @@ bool ValidatorCore::enable_quic_networking(uint16_t port) {
     return false;
   }
 
+  // TPU: each completed stream is one serialized transaction, handed to the
+  // banking stage once per received datagram batch
+  quic_server_->set_transaction_sink(
+      [this](std::vector<std::vector<uint8_t>> &&packets) {
+        std::vector<std::shared_ptr<ledger::Transaction>> transactions;
+        transactions.reserve(packets.size());
+        for (const auto &packet : packets) {
+          try {
+            transactions.push_back(
+                std::make_shared<ledger::Transaction>(packet));
+          } catch (const std::exception &) {
+            // Malformed packets are dropped
+          }
+        }
+        if (!transactions.empty()) {
+          process_transactions(std::move(transactions));
+        }
+      });
+
   if (!quic_server_->start()) {
     return false;
   }
 
   quic_enabled_ = true;
+  refresh_quic_stakes(get_blockchain_head_slot());
   return true;
 }
 
@@ -822,9 +876,38 @@ bool ValidatorCore::disable_quic_networking() noexcept {
   }
 
   quic_enabled_ = false;
+  std::lock_guard<std::mutex> lock(impl_->quic_stakes_mutex_);
+  impl_->quic_stakes_epoch_ = UINT64_MAX;
   return true;
 }
 
+void ValidatorCore::refresh_quic_stakes(Slot slot) {
+  auto schedule = impl_->leader_schedule_;
+  if (!quic_enabled_ || !schedule) {
+    return;
+  }
+
+  // Stream quotas follow the same epoch stakes as the leader schedule; the
+  // map is only rebuilt when a block crosses into a new epoch
+  Epoch epoch = schedule->epoch_of(slot);
+  std::lock_guard<std::mutex> lock(impl_->quic_stakes_mutex_);
+  if (epoch == impl_->quic_stakes_epoch_) {
+    return;
+  }
+  auto stakes = schedule->epoch_stakes(epoch);
+  if (!stakes) {
+    return;
+  }
+
+  std::unordered_map<PublicKey, uint64_t> staked_nodes;
+  staked_nodes.reserve(stakes->validators.size());
+  for (size_t i = 0; i < stakes->validators.size(); ++i) {
+    staked_nodes[stakes->validators[i]] = stakes->validator_stakes[i];
+  }
+  quic_server_->update_staked_nodes(staked_nodes);
+  impl_->quic_stakes_epoch_ = epoch;
+}
+
 banking::BankingStage::Statistics
 ValidatorCore::get_transaction_statistics() const {
   if (banking_stage_) {
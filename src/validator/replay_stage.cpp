@@ -0,0 +1,795 @@
+#include "validator/replay_stage.h"
+#include "banking/prioritization_scheduler.h"
+#include "network/gossip/crypto_utils.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <latch>
+#include <map>
+#include <mutex>
+#include <openssl/sha.h>
+#include <thread>
+#include <unordered_set>
+
+namespace slonana {
+namespace validator {
+
+namespace {
+
+constexpr uint8_t VERSIONED_MESSAGE_PREFIX = 0x80;
+constexpr uint32_t SYSTEM_TRANSFER = 2;
+
+const PublicKey SYSTEM_PROGRAM_ID(32, 0);
+
+bool read_compact_u16(const std::vector<uint8_t> &data, size_t &offset,
+                      size_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 21; shift += 7) {
+    if (offset >= data.size()) {
+      return false;
+    }
+    uint8_t byte = data[offset++];
+    value |= static_cast<size_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t read_le(const std::vector<uint8_t> &data, size_t offset,
+                 size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; ++i) {
+    value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+  }
+  return value;
+}
+
+void append_le(std::vector<uint8_t> &out, uint64_t value) {
+  for (size_t i = 0; i < 8; ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+Hash sha256(const std::vector<uint8_t> &data) {
+  Hash hash(SHA256_DIGEST_LENGTH);
+  SHA256(data.data(), data.size(), hash.data());
+  return hash;
+}
+
+bool verify_signatures(const ReplayTransaction &parsed) {
+  const auto &transaction = *parsed.transaction;
+  if (transaction.signatures.size() != parsed.required_signatures) {
+    return false;
+  }
+  for (size_t i = 0; i < parsed.required_signatures; ++i) {
+    if (!network::gossip::CryptoUtils::verify_ed25519(
+            transaction.message, transaction.signatures[i],
+            parsed.account_keys[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+// ReplayEntry
+
+Hash ReplayEntry::mixin(const std::vector<ledger::Transaction> &transactions) {
+  std::vector<uint8_t> signatures;
+  for (const auto &transaction : transactions) {
+    for (const auto &signature : transaction.signatures) {
+      signatures.insert(signatures.end(), signature.begin(), signature.end());
+    }
+  }
+  return sha256(signatures);
+}
+
+Hash ReplayEntry::next_hash(
+    const Hash &start, uint64_t num_hashes,
+    const std::vector<ledger::Transaction> &transactions) {
+  Hash hash = start;
+  if (num_hashes == 0) {
+    return hash;
+  }
+  for (uint64_t i = 1; i < num_hashes; ++i) {
+    hash = sha256(hash);
+  }
+  if (transactions.empty()) {
+    return sha256(hash);
+  }
+  Hash mixed = mixin(transactions);
+  hash.insert(hash.end(), mixed.begin(), mixed.end());
+  return sha256(hash);
+}
+
+// ReplaySlot
+
+const Hash &ReplaySlot::last_hash() const {
+  return entries.empty() ? start_hash : entries.back().hash;
+}
+
+ReplaySlot ReplaySlot::record(Slot slot, Slot parent_slot,
+                              const Hash &start_hash,
+                              std::vector<ledger::Transaction> transactions,
+                              size_t max_entry_transactions,
+                              uint64_t hashes_per_entry) {
+  ReplaySlot result;
+  result.slot = slot;
+  result.parent_slot = parent_slot;
+  result.start_hash = start_hash;
+  max_entry_transactions = std::max<size_t>(1, max_entry_transactions);
+  hashes_per_entry = std::max<uint64_t>(1, hashes_per_entry);
+
+  Hash previous = start_hash;
+  auto push = [&](std::vector<ledger::Transaction> batch) {
+    ReplayEntry entry;
+    entry.num_hashes = hashes_per_entry;
+    entry.hash = ReplayEntry::next_hash(previous, hashes_per_entry, batch);
+    entry.transactions = std::move(batch);
+    previous = entry.hash;
+    result.entries.push_back(std::move(entry));
+  };
+  for (size_t i = 0; i < transactions.size(); i += max_entry_transactions) {
+    size_t end = std::min(transactions.size(), i + max_entry_transactions);
+    push(std::vector<ledger::Transaction>(
+        std::make_move_iterator(transactions.begin() + i),
+        std::make_move_iterator(transactions.begin() + end)));
+  }
+  push({}); // Closing tick
+  return result;
+}
+
+ReplaySlot ReplaySlot::from_block(const ledger::Block &block, Slot parent_slot,
+                                  const Hash &start_hash) {
+  return record(block.slot, parent_slot, start_hash, block.transactions);
+}
+
+// ReplayTransaction
+
+size_t ReplayTransaction::index_of(const PublicKey &key) const {
+  return std::find(account_keys.begin(), account_keys.end(), key) -
+         account_keys.begin();
+}
+
+std::optional<ReplayTransaction>
+ReplayTransaction::parse(const ledger::Transaction &transaction) {
+  const auto &message = transaction.message;
+  size_t offset = 0;
+  if (!message.empty() && (message[0] & VERSIONED_MESSAGE_PREFIX)) {
+    ++offset; // v0: same layout up to the address table lookups
+  }
+  if (offset + 3 > message.size()) {
+    return std::nullopt;
+  }
+  size_t required_signatures = message[offset];
+  size_t readonly_signed = message[offset + 1];
+  size_t readonly_unsigned = message[offset + 2];
+  offset += 3;
+
+  size_t key_count = 0;
+  if (!read_compact_u16(message, offset, key_count) ||
+      offset + key_count * 32 + 32 > message.size() ||
+      required_signatures == 0 || readonly_signed >= required_signatures ||
+      required_signatures + readonly_unsigned > key_count) {
+    return std::nullopt;
+  }
+
+  ReplayTransaction result;
+  result.transaction = &transaction;
+  result.required_signatures = required_signatures;
+  for (size_t i = 0; i < key_count; ++i) {
+    auto key = message.begin() + offset + i * 32;
+    result.account_keys.emplace_back(key, key + 32);
+    // Builtins and sysvars are never written, whatever the header says
+    result.writable.push_back(
+        (i < required_signatures ? i < required_signatures - readonly_signed
+                                 : i < key_count - readonly_unsigned) &&
+        svm::lookup_builtin_account(result.account_keys.back()) ==
+            svm::BuiltinAccount::NONE);
+  }
+  offset += key_count * 32 + 32; // Keys, then the recent blockhash
+
+  // An account listed twice would be locked against itself
+  std::unordered_set<PublicKey> unique(result.account_keys.begin(),
+                                       result.account_keys.end());
+  if (unique.size() != key_count) {
+    return std::nullopt;
+  }
+
+  size_t instruction_count = 0;
+  if (!read_compact_u16(message, offset, instruction_count)) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < instruction_count; ++i) {
+    if (offset >= message.size()) {
+      return std::nullopt;
+    }
+    size_t program_index = message[offset++];
+    size_t account_count = 0;
+    if (program_index >= key_count ||
+        !read_compact_u16(message, offset, account_count) ||
+        offset + account_count > message.size()) {
+      return std::nullopt;
+    }
+    svm::Instruction instruction;
+    instruction.program_id = result.account_keys[program_index];
+    for (size_t a = 0; a < account_count; ++a) {
+      size_t index = message[offset++];
+      if (index >= key_count) {
+        return std::nullopt;
+      }
+      instruction.accounts.push_back(result.account_keys[index]);
+    }
+    size_t data_size = 0;
+    if (!read_compact_u16(message, offset, data_size) ||
+        offset + data_size > message.size()) {
+      return std::nullopt;
+    }
+    instruction.data.assign(message.begin() + offset,
+                            message.begin() + offset + data_size);
+    offset += data_size;
+    result.instructions.push_back(std::move(instruction));
+  }
+  return result;
+}
+
+// ReplayBank
+
+ReplayBank::ReplayBank(Slot slot, std::shared_ptr<const ReplayBank> parent)
+    : slot_(slot), parent_(std::move(parent)),
+      sysvars_(parent_ ? svm::SysvarSnapshot::for_slot(*parent_->sysvars_, slot)
+                       : svm::SysvarSnapshot::genesis(0)) {}
+
+std::shared_ptr<ReplayBank> ReplayBank::genesis(
+    const std::vector<std::pair<PublicKey, uint64_t>> &accounts,
+    const Hash &genesis_hash,
+    std::shared_ptr<const svm::SysvarSnapshot> sysvars) {
+  auto bank = std::make_shared<ReplayBank>(0, nullptr);
+  if (sysvars) {
+    bank->sysvars_ = std::move(sysvars);
+  }
+  for (const auto &[key, lamports] : accounts) {
+    svm::ProgramAccount account{};
+    account.pubkey = key;
+    account.lamports = lamports;
+    account.owner = SYSTEM_PROGRAM_ID;
+    bank->accounts_[key] = std::move(account);
+  }
+  bank->frozen_ = true;
+  bank->hash_ = genesis_hash;
+  bank->blockhash_ = genesis_hash;
+  return bank;
+}
+
+std::optional<svm::ProgramAccount>
+ReplayBank::get_account(const PublicKey &key) const {
+  auto builtin = svm::lookup_builtin_account(key);
+  if (builtin != svm::BuiltinAccount::NONE) {
+    auto account = svm::is_sysvar(builtin)
+                       ? sysvars_->account(builtin)
+                       : svm::builtin_program_account(builtin);
+    if (account) {
+      svm::ProgramAccount result{};
+      result.pubkey = key;
+      result.data = account->data;
+      result.lamports = account->lamports;
+      result.owner = account->owner;
+      result.executable = account->executable;
+      result.rent_epoch = account->rent_epoch;
+      return result;
+    }
+  }
+  for (const ReplayBank *bank = this; bank; bank = bank->parent_.get()) {
+    auto it = bank->accounts_.find(key);
+    if (it != bank->accounts_.end()) {
+      return it->second;
+    }
+  }
+  return std::nullopt;
+}
+
+uint64_t ReplayBank::get_balance(const PublicKey &key) const {
+  auto account = get_account(key);
+  return account ? account->lamports : 0;
+}
+
+void ReplayBank::store_account(const svm::ProgramAccount &account) {
+  accounts_[account.pubkey] = account;
+}
+
+void ReplayBank::freeze(const Hash &blockhash) {
+  std::map<PublicKey, const svm::ProgramAccount *> sorted;
+  for (const auto &[key, account] : accounts_) {
+    sorted.emplace(key, &account);
+  }
+
+  std::vector<uint8_t> input;
+  if (parent_) {
+    input = parent_->hash_;
+  }
+  input.insert(input.end(), blockhash.begin(), blockhash.end());
+  append_le(input, signature_count);
+  for (const auto &[key, account] : sorted) {
+    input.insert(input.end(), key.begin(), key.end());
+    append_le(input, account->lamports);
+    input.insert(input.end(), account->owner.begin(), account->owner.end());
+    input.push_back(account->executable ? 1 : 0);
+    append_le(input, account->data.size());
+    input.insert(input.end(), account->data.begin(), account->data.end());
+  }
+  hash_ = sha256(input);
+  blockhash_ = blockhash;
+  frozen_ = true;
+}
+
+// ReplayStage
+
+class ReplayStage::Impl {
+public:
+  Impl(std::shared_ptr<const ReplayBank> root, const Config &config,
+       Statistics &stats)
+      : config_(config), stats_(stats),
+        processor_(&ReplayStage::process_system_transfers) {
+    banks_[root->slot()] = std::move(root);
+    config_.worker_threads = std::max<size_t>(1, config_.worker_threads);
+    config_.max_concurrent_forks =
+        std::max<size_t>(1, config_.max_concurrent_forks);
+    config_.poh_entries_per_task =
+        std::max<size_t>(1, config_.poh_entries_per_task);
+    for (size_t i = 0; i < config_.worker_threads; ++i) {
+      workers_.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.push_back(std::move(task));
+    }
+    queue_cv_.notify_one();
+  }
+
+  SlotResult replay_slot(const ReplaySlot &slot);
+  void execute_entry(ReplayBank &bank,
+                     const std::vector<ReplayTransaction> &transactions,
+                     TransactionStatus *statuses);
+
+  Config config_;
+  Statistics &stats_;
+  TransactionProcessor processor_;
+
+  mutable std::mutex banks_mutex_;
+  std::unordered_map<Slot, std::shared_ptr<const ReplayBank>> banks_;
+
+private:
+  void worker_loop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+        task = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::function<void()>> queue_;
+  bool stopping_ = false;
+};
+
+ReplayStage::SlotResult ReplayStage::Impl::replay_slot(const ReplaySlot &slot) {
+  SlotResult result;
+  result.slot = slot.slot;
+  auto fail = [&](std::string error) {
+    result.dead = true;
+    result.error = std::move(error);
+    result.statuses.clear();
+    stats_.dead_slots++;
+    return result;
+  };
+
+  std::shared_ptr<const ReplayBank> parent;
+  {
+    std::lock_guard<std::mutex> lock(banks_mutex_);
+    auto it = banks_.find(slot.parent_slot);
+    if (it != banks_.end()) {
+      parent = it->second;
+    }
+  }
+  if (!parent || slot.parent_slot >= slot.slot) {
+    return fail("Parent slot " + std::to_string(slot.parent_slot) +
+                " is not frozen");
+  }
+  if (config_.verify_poh && slot.start_hash != parent->blockhash()) {
+    return fail("Slot does not chain from its parent's last entry");
+  }
+
+  // Decode everything up front so verification and execution share it
+  std::vector<std::vector<ReplayTransaction>> parsed(slot.entries.size());
+  size_t transaction_count = 0;
+  size_t signature_count = 0;
+  for (size_t e = 0; e < slot.entries.size(); ++e) {
+    if (slot.entries[e].num_hashes == 0) {
+      return fail("Entry " + std::to_string(e) + " has no hashes");
+    }
+    for (const auto &transaction : slot.entries[e].transactions) {
+      auto decoded = ReplayTransaction::parse(transaction);
+      if (!decoded) {
+        return fail("Malformed transaction in entry " + std::to_string(e));
+      }
+      signature_count += transaction.signatures.size();
+      parsed[e].push_back(std::move(*decoded));
+    }
+    transaction_count += parsed[e].size();
+  }
+
+  // Verification runs on the workers while the entries execute below
+  std::atomic<bool> verified{true};
+  std::mutex error_mutex;
+  std::string verify_error;
+  auto reject = [&](std::string error) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (verified.exchange(false)) {
+      verify_error = std::move(error);
+    }
+  };
+
+  std::vector<std::function<void()>> checks;
+  if (config_.verify_poh) {
+    for (size_t first = 0; first < slot.entries.size();
+         first += config_.poh_entries_per_task) {
+      size_t last =
+          std::min(slot.entries.size(), first + config_.poh_entries_per_task);
+      checks.push_back([&, first, last] {
+        for (size_t e = first; e < last && verified; ++e) {
+          const Hash &previous =
+              e == 0 ? slot.start_hash : slot.entries[e - 1].hash;
+          const auto &entry = slot.entries[e];
+          if (ReplayEntry::next_hash(previous, entry.num_hashes,
+                                     entry.transactions) != entry.hash) {
+            reject("PoH hash mismatch at entry " + std::to_string(e));
+          }
+        }
+      });
+    }
+  }
+  if (config_.verify_signatures) {
+    for (size_t e = 0; e < parsed.size(); ++e) {
+      if (parsed[e].empty()) {
+        continue;
+      }
+      checks.push_back([&, e] {
+        for (const auto &transaction : parsed[e]) {
+          if (!verified) {
+            return;
+          }
+          if (!verify_signatures(transaction)) {
+            reject("Invalid signature in entry " + std::to_string(e));
+            return;
+          }
+          stats_.signatures_verified += transaction.required_signatures;
+        }
+      });
+    }
+  }
+  std::latch verification(static_cast<std::ptrdiff_t>(checks.size()));
+  for (auto &check : checks) {
+    submit([&verification, check = std::move(check)] {
+      check();
+      verification.count_down();
+    });
+  }
+
+  auto bank = std::make_shared<ReplayBank>(slot.slot, parent);
+  result.statuses.resize(transaction_count);
+  size_t next_status = 0;
+  for (size_t e = 0; e < parsed.size() && verified; ++e) {
+    if (!parsed[e].empty()) {
+      execute_entry(*bank, parsed[e], result.statuses.data() + next_status);
+      next_status += parsed[e].size();
+    }
+    stats_.entries_replayed++;
+  }
+
+  verification.wait();
+  if (!verified) {
+    return fail(verify_error);
+  }
+
+  for (const auto &status : result.statuses) {
+    bank->collected_fees += status.fee;
+  }
+  bank->transaction_count = transaction_count;
+  bank->signature_count = signature_count;
+  bank->freeze(slot.last_hash());
+  result.bank = bank;
+  {
+    std::lock_guard<std::mutex> lock(banks_mutex_);
+    banks_[slot.slot] = bank;
+  }
+  stats_.slots_replayed++;
+  stats_.transactions_executed += transaction_count;
+  return result;
+}
+
+void ReplayStage::Impl::execute_entry(
+    ReplayBank &bank, const std::vector<ReplayTransaction> &transactions,
+    TransactionStatus *statuses) {
+  // Load each account the entry touches once; transactions work on these
+  // and the written ones go back to the bank when the entry is done
+  std::unordered_map<PublicKey, size_t> slots;
+  std::vector<svm::ProgramAccount> accounts;
+  std::vector<std::vector<size_t>> account_slots(transactions.size());
+  for (size_t t = 0; t < transactions.size(); ++t) {
+    for (const auto &key : transactions[t].account_keys) {
+      auto [it, inserted] = slots.emplace(key, accounts.size());
+      if (inserted) {
+        auto account = bank.get_account(key);
+        if (!account) {
+          account.emplace();
+          account->pubkey = key;
+          account->lamports = 0;
+          account->owner = SYSTEM_PROGRAM_ID;
+          account->executable = false;
+          account->rent_epoch = 0;
+        }
+        accounts.push_back(std::move(*account));
+      }
+      account_slots[t].push_back(it->second);
+    }
+  }
+  std::vector<uint8_t> written(accounts.size(), 0);
+
+  // Account locks: each transaction depends on the last earlier writer of
+  // every account it uses, and a writer also on the readers since then
+  std::vector<int64_t> last_writer(accounts.size(), -1);
+  std::vector<std::vector<size_t>> readers(accounts.size());
+  std::vector<std::vector<size_t>> dependents(transactions.size());
+  auto pending =
+      std::make_unique<std::atomic<size_t>[]>(transactions.size());
+  for (size_t t = 0; t < transactions.size(); ++t) {
+    std::vector<size_t> waits_on;
+    for (size_t k = 0; k < account_slots[t].size(); ++k) {
+      size_t slot = account_slots[t][k];
+      if (last_writer[slot] >= 0) {
+        waits_on.push_back(static_cast<size_t>(last_writer[slot]));
+      }
+      if (transactions[t].writable[k]) {
+        waits_on.insert(waits_on.end(), readers[slot].begin(),
+                        readers[slot].end());
+        readers[slot].clear();
+        last_writer[slot] = static_cast<int64_t>(t);
+      } else {
+        readers[slot].push_back(t);
+      }
+    }
+    std::sort(waits_on.begin(), waits_on.end());
+    waits_on.erase(std::unique(waits_on.begin(), waits_on.end()),
+                   waits_on.end());
+    for (size_t dependency : waits_on) {
+      dependents[dependency].push_back(t);
+    }
+    pending[t].store(waits_on.size(), std::memory_order_relaxed);
+    if (!waits_on.empty()) {
+      stats_.lock_waits++;
+    }
+  }
+
+  auto run = [&](size_t t) {
+    const auto &transaction = transactions[t];
+    auto &status = statuses[t];
+    status.signature = transaction.transaction->signatures.empty()
+                           ? Signature()
+                           : transaction.transaction->signatures[0];
+    uint64_t fee =
+        config_.lamports_per_signature * transaction.required_signatures;
+    const auto &slots_of = account_slots[t];
+    svm::ProgramAccount &payer = accounts[slots_of[0]];
+    if (!transaction.writable[0] || payer.lamports < fee) {
+      status.result = svm::ExecutionResult::INSUFFICIENT_FUNDS;
+      status.fee = 0;
+      return;
+    }
+
+    std::vector<svm::ProgramAccount> working;
+    working.reserve(slots_of.size());
+    for (size_t slot : slots_of) {
+      working.push_back(accounts[slot]);
+    }
+    working[0].lamports -= fee;
+    status.fee = fee;
+    svm::SysvarCache::Scope sysvars(bank.sysvars());
+    status.result = processor_(transaction, working);
+    if (status.result == svm::ExecutionResult::SUCCESS) {
+      for (size_t k = 0; k < slots_of.size(); ++k) {
+        if (transaction.writable[k]) {
+          accounts[slots_of[k]] = std::move(working[k]);
+          written[slots_of[k]] = 1;
+        }
+      }
+    } else {
+      payer.lamports -= fee;
+      written[slots_of[0]] = 1;
+    }
+  };
+
+  if (config_.worker_threads == 1 || transactions.size() == 1) {
+    for (size_t t = 0; t < transactions.size(); ++t) {
+      run(t);
+    }
+  } else {
+    std::latch done(static_cast<std::ptrdiff_t>(transactions.size()));
+    std::function<void(size_t)> schedule = [&](size_t t) {
+      submit([&, t] {
+        run(t);
+        for (size_t next : dependents[t]) {
+          if (pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            schedule(next);
+          }
+        }
+        done.count_down();
+      });
+    };
+    // Collect the unlocked transactions first: once they run, others can
+    // drop to zero pending and are scheduled by their last dependency
+    std::vector<size_t> unlocked;
+    for (size_t t = 0; t < transactions.size(); ++t) {
+      if (pending[t].load(std::memory_order_relaxed) == 0) {
+        unlocked.push_back(t);
+      }
+    }
+    for (size_t t : unlocked) {
+      schedule(t);
+    }
+    done.wait();
+  }
+
+  for (size_t slot = 0; slot < accounts.size(); ++slot) {
+    if (written[slot]) {
+      bank.store_account(accounts[slot]);
+    }
+  }
+}
+
+ReplayStage::ReplayStage(std::shared_ptr<const ReplayBank> root)
+    : ReplayStage(std::move(root), Config{}) {}
+
+ReplayStage::ReplayStage(std::shared_ptr<const ReplayBank> root,
+                         const Config &config)
+    : impl_(std::make_unique<Impl>(std::move(root), config, stats_)) {}
+
+ReplayStage::~ReplayStage() = default;
+
+ReplayStage::SlotResult ReplayStage::replay_slot(const ReplaySlot &slot) {
+  return impl_->replay_slot(slot);
+}
+
+std::vector<ReplayStage::SlotResult>
+ReplayStage::replay_slots(const std::vector<ReplaySlot> &slots) {
+  std::vector<SlotResult> results(slots.size());
+  std::vector<bool> done(slots.size(), false);
+  std::unordered_set<Slot> outstanding;
+  for (const auto &slot : slots) {
+    outstanding.insert(slot.slot);
+  }
+
+  size_t remaining = slots.size();
+  while (remaining > 0) {
+    // Every slot whose parent is not still waiting in this batch
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < slots.size(); ++i) {
+      if (!done[i] && (slots[i].parent_slot >= slots[i].slot ||
+                       !outstanding.count(slots[i].parent_slot))) {
+        ready.push_back(i);
+      }
+    }
+    if (ready.empty()) {
+      break;
+    }
+
+    for (size_t first = 0; first < ready.size();
+         first += impl_->config_.max_concurrent_forks) {
+      size_t last = std::min(ready.size(),
+                             first + impl_->config_.max_concurrent_forks);
+      std::vector<std::thread> forks;
+      for (size_t r = first + 1; r < last; ++r) {
+        size_t i = ready[r];
+        forks.emplace_back(
+            [this, &results, &slots, i] { results[i] = replay_slot(slots[i]); });
+      }
+      results[ready[first]] = replay_slot(slots[ready[first]]);
+      for (auto &fork : forks) {
+        fork.join();
+      }
+    }
+    for (size_t i : ready) {
+      done[i] = true;
+      outstanding.erase(slots[i].slot);
+      --remaining;
+    }
+  }
+  return results;
+}
+
+std::shared_ptr<const ReplayBank> ReplayStage::bank(Slot slot) const {
+  std::lock_guard<std::mutex> lock(impl_->banks_mutex_);
+  auto it = impl_->banks_.find(slot);
+  return it == impl_->banks_.end() ? nullptr : it->second;
+}
+
+void ReplayStage::set_root(Slot root) {
+  std::lock_guard<std::mutex> lock(impl_->banks_mutex_);
+  for (auto it = impl_->banks_.begin(); it != impl_->banks_.end();) {
+    bool keep = false;
+    for (const ReplayBank *bank = it->second.get(); bank;
+         bank = bank->parent().get()) {
+      if (bank->slot() == root) {
+        keep = true;
+        break;
+      }
+    }
+    it = keep ? std::next(it) : impl_->banks_.erase(it);
+  }
+}
+
+void ReplayStage::set_processor(TransactionProcessor processor) {
+  impl_->processor_ = std::move(processor);
+}
+
+svm::ExecutionResult ReplayStage::process_system_transfers(
+    const ReplayTransaction &transaction,
+    std::vector<svm::ProgramAccount> &accounts) {
+  PublicKey compute_budget(
+      banking::SchedulableTransaction::COMPUTE_BUDGET_PROGRAM_ID.begin(),
+      banking::SchedulableTransaction::COMPUTE_BUDGET_PROGRAM_ID.end());
+  for (const auto &instruction : transaction.instructions) {
+    if (instruction.program_id == compute_budget) {
+      continue;
+    }
+    if (instruction.program_id != SYSTEM_PROGRAM_ID) {
+      return svm::ExecutionResult::PROGRAM_ERROR;
+    }
+    if (instruction.data.size() < 12 || instruction.accounts.size() < 2 ||
+        read_le(instruction.data, 0, 4) != SYSTEM_TRANSFER) {
+      return svm::ExecutionResult::INVALID_INSTRUCTION;
+    }
+    size_t from = transaction.index_of(instruction.accounts[0]);
+    size_t to = transaction.index_of(instruction.accounts[1]);
+    if (from >= transaction.required_signatures ||
+        !transaction.writable[from] || !transaction.writable[to]) {
+      return svm::ExecutionResult::INVALID_ACCOUNT_ACCESS;
+    }
+    uint64_t lamports = read_le(instruction.data, 4, 8);
+    if (accounts[from].lamports < lamports) {
+      return svm::ExecutionResult::INSUFFICIENT_FUNDS;
+    }
+    accounts[from].lamports -= lamports;
+    accounts[to].lamports += lamports;
+  }
+  return svm::ExecutionResult::SUCCESS;
+}
+
+} // namespace validator
+} // namespace slonana
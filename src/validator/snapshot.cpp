@@ -1,4 +1,9 @@
 #include "validator/snapshot.h"
+#include "validator/snapshot_archive.h"
+#include "validator/snapshot_restore_pipeline.h"
+#include "storage/accounts_db.h"
+#include "storage/accounts_hash.h"
+#include <atomic>
 #include <algorithm>
 #include <chrono>
 #include <cstring>
@@ -6,6 +11,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <openssl/evp.h>
 #include <random>
 #include <sstream>
@@ -16,6 +22,9 @@ namespace validator {
 
 namespace fs = std::filesystem;
 
+// Accounts a full snapshot copies out of the AccountsDB per locked batch
+static constexpr size_t SNAPSHOT_SCAN_BATCH = 4096;
+
 // Helper function to convert PublicKey to string for logging
 static std::string pubkey_to_string(const common::PublicKey &pubkey) {
   if (pubkey.empty())
@@ -31,12 +40,55 @@ static std::string pubkey_to_string(const common::PublicKey &pubkey) {
   return oss.str();
 }
 
+// Snapshot entry for an account taken from the AccountsDB; deletions become
+// tombstones, zero lamports and no data, as in Solana's incremental snapshots
+static AccountSnapshot
+to_account_snapshot(storage::ModifiedAccount &&account) {
+  AccountSnapshot snapshot;
+  snapshot.pubkey = std::move(account.account_key);
+  if (account.is_deleted) {
+    snapshot.lamports = 0;
+    snapshot.owner.assign(32, 0);
+    snapshot.executable = false;
+    snapshot.rent_epoch = 0;
+  } else {
+    snapshot.lamports = account.data.lamports;
+    snapshot.data = std::move(account.data.data);
+    snapshot.owner = std::move(account.data.owner);
+    snapshot.executable = account.data.executable;
+    snapshot.rent_epoch = account.data.rent_epoch;
+  }
+  return snapshot;
+}
+
+static SnapshotRestorePipeline::Options
+restore_pipeline_options(size_t snapshot_threads) {
+  SnapshotRestorePipeline::Options options;
+  if (snapshot_threads > 0) {
+    options.decompress_threads = std::max<size_t>(1, snapshot_threads / 2);
+    options.deserialize_threads = std::max<size_t>(1, snapshot_threads / 4);
+  }
+  return options;
+}
+
+static bool is_tombstone(const AccountSnapshot &account) {
+  return account.lamports == 0 && account.data.empty();
+}
+
+static storage::AccountHash hash_account_snapshot(const AccountSnapshot &account) {
+  return storage::AccountsHasher::hash_account(
+      account.pubkey, account.lamports, account.owner, account.executable,
+      account.rent_epoch, account.data.data(), account.data.size());
+}
+
 // SnapshotManager Implementation
 
 SnapshotManager::SnapshotManager(const std::string &snapshot_dir)
     : snapshot_dir_(snapshot_dir), compression_enabled_(true),
+      compression_codec_(SnapshotCodec::ZSTD),
       max_chunk_size_(1024 * 1024) // 1MB default
       ,
+      snapshot_threads_(0),         // All cores
       auto_snapshot_interval_(1000) // Every 1000 slots
 {
   // Ensure snapshot directory exists
@@ -48,7 +100,38 @@ SnapshotManager::SnapshotManager(const std::string &snapshot_dir)
             << std::endl;
 }
 
-SnapshotManager::~SnapshotManager() = default;
+SnapshotManager::~SnapshotManager() {
+  if (accounts_db_) {
+    accounts_db_->set_dirty_tracking(false);
+  }
+}
+
+void SnapshotManager::set_accounts_db(
+    std::shared_ptr<storage::AccountsDB> accounts_db) {
+  // Dirty sets are only kept while a snapshot consumer is attached
+  if (accounts_db_ && accounts_db_ != accounts_db) {
+    accounts_db_->set_dirty_tracking(false);
+  }
+  if (accounts_db) {
+    accounts_db->set_dirty_tracking(true);
+  }
+  accounts_db_ = std::move(accounts_db);
+  accounts_hasher_.reset(); // Hashed state belonged to the previous store
+}
+
+std::string SnapshotManager::get_accounts_hash(uint64_t slot) {
+  if (!accounts_db_) {
+    return "";
+  }
+  if (!accounts_hasher_) {
+    storage::AccountsHasher::Options options;
+    options.threads = snapshot_threads_;
+    accounts_hasher_ = std::make_unique<storage::AccountsHasher>(options);
+    accounts_hasher_->load(accounts_hash_cache_path());
+  }
+  accounts_hasher_->update_from(*accounts_db_, slot);
+  return accounts_hasher_->root_hex();
+}
 
 bool SnapshotManager::create_full_snapshot(uint64_t slot,
                                            const std::string &ledger_path) {
@@ -76,60 +159,68 @@ bool SnapshotManager::create_full_snapshot(uint64_t slot,
     metadata.is_incremental = false;
     metadata.base_slot = 0;
 
-    // Collect real account data from ledger
-    std::vector<AccountSnapshot> accounts;
-    uint64_t total_lamports = 0;
-
-    auto account_collection_result = collect_accounts_from_ledger(
-        ledger_path, slot, accounts, total_lamports);
-    if (!account_collection_result) {
-      std::cerr << "Failed to collect account data from ledger: " << ledger_path
-                << std::endl;
-      return false;
+    // Stream account state from the AccountsDB when attached, a batch at
+    // a time in pubkey order; else collect it from the ledger
+    uint64_t total_size = 0;
+    bool written;
+    if (accounts_db_) {
+      metadata.lamports_total = 0;
+      metadata.account_count = 0;
+      metadata.accounts_hash = get_accounts_hash(slot);
+      written = write_snapshot_archive(
+          snapshot_path, metadata,
+          [&](const AccountSink &sink) {
+            return accounts_db_->for_each_account_at_slot(
+                slot, SNAPSHOT_SCAN_BATCH,
+                [&](std::vector<storage::ModifiedAccount> &batch) {
+                  for (auto &account : batch) {
+                    metadata.lamports_total += account.data.lamports;
+                    metadata.account_count++;
+                    if (!sink(to_account_snapshot(std::move(account)))) {
+                      return false;
+                    }
+                  }
+                  return true;
+                });
+          },
+          total_size);
+    } else {
+      std::vector<AccountSnapshot> accounts;
+      uint64_t total_lamports = 0;
+      if (!collect_accounts_from_ledger(ledger_path, slot, accounts,
+                                        total_lamports)) {
+        std::cerr << "Failed to collect account data from ledger: "
+                  << ledger_path << std::endl;
+        return false;
+      }
+      metadata.lamports_total = total_lamports;
+      metadata.account_count = accounts.size();
+      metadata.accounts_hash = hash_snapshot_accounts(accounts, false);
+      written = write_snapshot_archive(snapshot_path, metadata, accounts,
+                                       total_size);
     }
-
-    metadata.lamports_total = total_lamports;
-    metadata.account_count = accounts.size();
-
-    // Serialize snapshot data
-    std::ofstream file(snapshot_path, std::ios::binary);
-    if (!file.is_open()) {
+    if (!written) {
       std::cerr << "Failed to create snapshot file: " << snapshot_path
                 << std::endl;
       return false;
     }
 
-    // Write metadata
-    auto metadata_bytes = serialize_metadata(metadata);
-    uint32_t metadata_size = static_cast<uint32_t>(metadata_bytes.size());
-    file.write(reinterpret_cast<const char *>(&metadata_size),
-               sizeof(metadata_size));
-    file.write(reinterpret_cast<const char *>(metadata_bytes.data()),
-               metadata_bytes.size());
-
-    // Write accounts
-    uint32_t account_count = static_cast<uint32_t>(accounts.size());
-    file.write(reinterpret_cast<const char *>(&account_count),
-               sizeof(account_count));
-
-    size_t total_size = 0;
-    for (const auto &account : accounts) {
-      auto account_bytes = serialize_account(account);
-      uint32_t account_size = static_cast<uint32_t>(account_bytes.size());
-      file.write(reinterpret_cast<const char *>(&account_size),
-                 sizeof(account_size));
-      file.write(reinterpret_cast<const char *>(account_bytes.data()),
-                 account_bytes.size());
-      total_size += account_bytes.size();
-    }
-
-    file.close();
-
     // Update metadata with actual sizes
     auto file_size = fs::file_size(snapshot_path);
     metadata.compressed_size = file_size;
     metadata.uncompressed_size = total_size;
 
+    // Later incremental snapshots are based on this one, and a restart
+    // restored from it can pick up the accounts hash bins where they are
+    if (accounts_db_) {
+      accounts_db_->prune_dirty_accounts(slot);
+      if (accounts_hasher_ &&
+          !accounts_hasher_->save(accounts_hash_cache_path())) {
+        std::cerr << "Snapshot Manager: Failed to save accounts hash cache"
+                  << std::endl;
+      }
+    }
+
     // Update statistics
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -150,7 +241,7 @@ bool SnapshotManager::create_full_snapshot(uint64_t slot,
               << std::endl;
     std::cout << "  File: " << snapshot_file << std::endl;
     std::cout << "  Size: " << file_size << " bytes" << std::endl;
-    std::cout << "  Accounts: " << accounts.size() << std::endl;
+    std::cout << "  Accounts: " << metadata.account_count << std::endl;
     std::cout << "  Duration: " << duration_ms << "ms" << std::endl;
 
     return true;
@@ -186,53 +277,50 @@ bool SnapshotManager::create_incremental_snapshot(
     metadata.is_incremental = true;
     metadata.base_slot = base_slot;
 
-    // Collect only changed accounts since base slot
+    // Collect only changed accounts since base slot. With an AccountsDB
+    // attached these are exactly the accounts written or deleted in
+    // (base_slot, slot], from its dirty-account tracking; deletions are
+    // written as tombstones.
     std::vector<AccountSnapshot> changed_accounts;
     uint64_t total_lamports_change = 0;
 
-    auto incremental_result = collect_incremental_accounts(
-        ledger_path, slot, base_slot, changed_accounts, total_lamports_change);
-    if (!incremental_result) {
+    if (accounts_db_) {
+      std::vector<storage::ModifiedAccount> modified;
+      if (!accounts_db_->collect_modified_accounts(base_slot, slot,
+                                                   modified)) {
+        std::cerr << "Changes since base slot " << base_slot
+                  << " are no longer tracked; a full snapshot is required"
+                  << std::endl;
+        return false;
+      }
+      changed_accounts.reserve(modified.size());
+      for (auto &account : modified) {
+        changed_accounts.push_back(to_account_snapshot(std::move(account)));
+        total_lamports_change += changed_accounts.back().lamports;
+      }
+    } else if (!collect_incremental_accounts(ledger_path, slot, base_slot,
+                                             changed_accounts,
+                                             total_lamports_change)) {
       std::cerr << "Failed to collect incremental account changes from ledger"
                 << std::endl;
       return false;
     }
 
-    metadata.lamports_total = total_lamports_change; // Net change in lamports
+    // Net change in lamports from the ledger; lamports held by the changed
+    // accounts from the AccountsDB
+    metadata.lamports_total = total_lamports_change;
     metadata.account_count = changed_accounts.size();
+    metadata.accounts_hash = hash_snapshot_accounts(changed_accounts, true);
 
     // Write incremental snapshot
-    std::ofstream file(snapshot_path, std::ios::binary);
-    if (!file.is_open()) {
+    uint64_t total_size = 0;
+    if (!write_snapshot_archive(snapshot_path, metadata, changed_accounts,
+                                total_size)) {
       std::cerr << "Failed to create incremental snapshot file: "
                 << snapshot_path << std::endl;
       return false;
     }
 
-    // Write metadata
-    auto metadata_bytes = serialize_metadata(metadata);
-    uint32_t metadata_size = static_cast<uint32_t>(metadata_bytes.size());
-    file.write(reinterpret_cast<const char *>(&metadata_size),
-               sizeof(metadata_size));
-    file.write(reinterpret_cast<const char *>(metadata_bytes.data()),
-               metadata_bytes.size());
-
-    // Write changed accounts
-    uint32_t account_count = static_cast<uint32_t>(changed_accounts.size());
-    file.write(reinterpret_cast<const char *>(&account_count),
-               sizeof(account_count));
-
-    for (const auto &account : changed_accounts) {
-      auto account_bytes = serialize_account(account);
-      uint32_t account_size = static_cast<uint32_t>(account_bytes.size());
-      file.write(reinterpret_cast<const char *>(&account_size),
-                 sizeof(account_size));
-      file.write(reinterpret_cast<const char *>(account_bytes.data()),
-                 account_bytes.size());
-    }
-
-    file.close();
-
     auto file_size = fs::file_size(snapshot_path);
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -279,22 +367,19 @@ bool SnapshotManager::restore_from_snapshot(const std::string &snapshot_path,
       return false;
     }
 
-    std::ifstream file(snapshot_path, std::ios::binary);
-    if (!file.is_open()) {
+    SnapshotArchiveReader reader;
+    bool is_archive = reader.open(snapshot_path);
+    SnapshotMetadata metadata;
+    std::vector<AccountSnapshot> legacy_accounts;
+    if (is_archive) {
+      metadata = deserialize_metadata(reader.header());
+    } else if (!read_legacy_snapshot(snapshot_path, metadata,
+                                     legacy_accounts)) {
       std::cerr << "Failed to open snapshot file: " << snapshot_path
                 << std::endl;
       return false;
     }
 
-    // Read metadata
-    uint32_t metadata_size;
-    file.read(reinterpret_cast<char *>(&metadata_size), sizeof(metadata_size));
-
-    std::vector<uint8_t> metadata_bytes(metadata_size);
-    file.read(reinterpret_cast<char *>(metadata_bytes.data()), metadata_size);
-
-    SnapshotMetadata metadata = deserialize_metadata(metadata_bytes);
-
     std::cout << "Snapshot metadata:" << std::endl;
     std::cout << "  Slot: " << metadata.slot << std::endl;
     std::cout << "  Block hash: " << metadata.block_hash << std::endl;
@@ -305,54 +390,54 @@ bool SnapshotManager::restore_from_snapshot(const std::string &snapshot_path,
       std::cout << "  Base slot: " << metadata.base_slot << std::endl;
     }
 
-    // Read accounts
-    uint32_t account_count;
-    file.read(reinterpret_cast<char *>(&account_count), sizeof(account_count));
-
-    std::vector<AccountSnapshot> accounts;
-    accounts.reserve(account_count);
-
-    for (uint32_t i = 0; i < account_count; ++i) {
-      uint32_t account_size;
-      file.read(reinterpret_cast<char *>(&account_size), sizeof(account_size));
-
-      std::vector<uint8_t> account_bytes(account_size);
-      file.read(reinterpret_cast<char *>(account_bytes.data()), account_size);
-
-      size_t offset = 0;
-      AccountSnapshot account = deserialize_account(account_bytes, offset);
-      accounts.push_back(account);
-    }
-
-    file.close();
-
     // Production ledger state restoration with integrity verification
     // Restore accounts to the ledger with full validation and consistency
     // checks
+    size_t total_accounts = 0;
     try {
-      size_t restored_accounts = 0;
-      size_t failed_restorations = 0;
-
-      for (const auto &account : accounts) {
-        // Validate account data integrity
-        if (!validate_account_integrity(account)) {
-          std::cerr
-              << "Snapshot Manager: Account integrity validation failed for "
-              << pubkey_to_string(account.pubkey) << std::endl;
-          failed_restorations++;
-          continue;
+      std::atomic<size_t> restored_accounts{0};
+      std::atomic<size_t> failed_restorations{0};
+      auto restore = [&](const std::vector<AccountSnapshot> &batch) {
+        return restore_batch(metadata, batch, restored_accounts,
+                             failed_restorations);
+      };
+
+      if (is_archive) {
+        // Reading, decompression, deserialization and insertion overlap,
+        // each stage on its own threads
+        total_accounts = reader.account_count();
+        SnapshotRestorePipeline pipeline(
+            [&](const ChunkFrameHeader &, std::vector<AccountSnapshot> &batch) {
+              return restore(batch);
+            },
+            restore_pipeline_options(snapshot_threads_));
+        if (!pipeline.restore_file(reader)) {
+          std::cerr << "Snapshot Manager: Restore failed for " << snapshot_path
+                    << ": " << pipeline.error() << std::endl;
+          return false;
         }
-
-        // Restore account to ledger
-        if (restore_account_to_ledger(account)) {
-          restored_accounts++;
-        } else {
-          std::cerr << "Snapshot Manager: Failed to restore account "
-                    << pubkey_to_string(account.pubkey) << std::endl;
-          failed_restorations++;
+        auto pipeline_stats = pipeline.statistics();
+        std::cout << "  Restore pipeline: " << pipeline_stats.chunks
+                  << " chunks in " << pipeline_stats.elapsed_seconds * 1000.0
+                  << "ms (busy: decompress "
+                  << pipeline_stats.decompress.busy_seconds * 1000.0
+                  << "ms, deserialize "
+                  << pipeline_stats.deserialize.busy_seconds * 1000.0
+                  << "ms, insert "
+                  << pipeline_stats.insert.busy_seconds * 1000.0 << "ms)"
+                  << std::endl;
+      } else {
+        total_accounts = legacy_accounts.size();
+        if (!restore(legacy_accounts)) {
+          return false;
         }
       }
 
+      // The restored state is covered by this full snapshot
+      if (accounts_db_ && !metadata.is_incremental) {
+        accounts_db_->prune_dirty_accounts(metadata.slot);
+      }
+
       std::cout << "Snapshot Manager: Account restoration complete"
                 << std::endl;
       std::cout << "  Successfully restored: " << restored_accounts
@@ -362,7 +447,7 @@ bool SnapshotManager::restore_from_snapshot(const std::string &snapshot_path,
 
       // Update ledger state with restored data
       if (restored_accounts > 0) {
-        update_ledger_metadata(accounts.size(), restored_accounts);
+        update_ledger_metadata(total_accounts, restored_accounts);
         verify_ledger_consistency();
       }
 
@@ -388,7 +473,7 @@ bool SnapshotManager::restore_from_snapshot(const std::string &snapshot_path,
 
     std::cout << "Snapshot Manager: Restoration completed successfully"
               << std::endl;
-    std::cout << "  Restored accounts: " << accounts.size() << std::endl;
+    std::cout << "  Restored accounts: " << total_accounts << std::endl;
     std::cout << "  Duration: " << duration_ms << "ms" << std::endl;
 
     return true;
@@ -399,6 +484,131 @@ bool SnapshotManager::restore_from_snapshot(const std::string &snapshot_path,
   }
 }
 
+bool SnapshotManager::restore_batch(const SnapshotMetadata &metadata,
+                                    const std::vector<AccountSnapshot> &batch,
+                                    std::atomic<size_t> &restored_accounts,
+                                    std::atomic<size_t> &failed_restorations) {
+  for (const auto &account : batch) {
+    // Validate account data integrity
+    if (!validate_account_integrity(account)) {
+      std::cerr << "Snapshot Manager: Account integrity validation failed for "
+                << pubkey_to_string(account.pubkey) << std::endl;
+      failed_restorations++;
+      continue;
+    }
+
+    // Restore account to ledger
+    if (restore_account_to_ledger(account)) {
+      restored_accounts++;
+    } else {
+      std::cerr << "Snapshot Manager: Failed to restore account "
+                << pubkey_to_string(account.pubkey) << std::endl;
+      failed_restorations++;
+    }
+  }
+
+  if (!accounts_db_) {
+    return true;
+  }
+  std::vector<std::pair<common::PublicKey, storage::AccountData>> entries;
+  entries.reserve(batch.size());
+  for (const auto &account : batch) {
+    if (metadata.is_incremental && is_tombstone(account)) {
+      accounts_db_->delete_account(account.pubkey, metadata.slot);
+      continue;
+    }
+    storage::AccountData data;
+    data.data = account.data;
+    data.lamports = account.lamports;
+    data.owner = account.owner;
+    data.executable = account.executable;
+    data.rent_epoch = account.rent_epoch;
+    entries.emplace_back(account.pubkey, std::move(data));
+  }
+  return accounts_db_->store_accounts_batch(entries, metadata.slot);
+}
+
+std::unique_ptr<SnapshotManager::StreamingRestore>
+SnapshotManager::begin_streaming_restore() {
+  return std::make_unique<StreamingRestore>(*this);
+}
+
+SnapshotManager::StreamingRestore::StreamingRestore(SnapshotManager &manager)
+    : manager_(manager) {
+  // The pipeline starts with the first frame, once the header (and so the
+  // slot the accounts belong to) is known
+  stream_ = std::make_unique<SnapshotFrameStream>(
+      [this](const ChunkFrameHeader &header, std::vector<uint8_t> payload) {
+        if (!pipeline_) {
+          metadata_ = manager_.deserialize_metadata(stream_->header());
+          pipeline_ = std::make_unique<SnapshotRestorePipeline>(
+              [this](const ChunkFrameHeader &,
+                     std::vector<AccountSnapshot> &batch) {
+                return manager_.restore_batch(metadata_, batch,
+                                              restored_accounts_,
+                                              failed_restorations_);
+              },
+              restore_pipeline_options(manager_.snapshot_threads_));
+          pipeline_->start();
+        }
+        return pipeline_->push_frame(header, std::move(payload));
+      });
+}
+
+SnapshotManager::StreamingRestore::~StreamingRestore() { abort(); }
+
+bool SnapshotManager::StreamingRestore::feed(const uint8_t *data,
+                                             size_t size) {
+  if (failed_) {
+    return false;
+  }
+  bytes_ += size;
+  if (!stream_->feed(data, size)) {
+    abort();
+    return false;
+  }
+  return true;
+}
+
+bool SnapshotManager::StreamingRestore::finish() {
+  if (failed_ || !stream_->complete() || !pipeline_) {
+    abort();
+    return false;
+  }
+  bool restored = pipeline_->finish();
+  if (!restored) {
+    std::cerr << "Snapshot Manager: Streaming restore failed: "
+              << pipeline_->error() << std::endl;
+    failed_ = true;
+    return false;
+  }
+  pipeline_.reset();
+
+  if (manager_.accounts_db_ && !metadata_.is_incremental) {
+    manager_.accounts_db_->prune_dirty_accounts(metadata_.slot);
+  }
+  if (restored_accounts_ > 0) {
+    manager_.update_ledger_metadata(metadata_.account_count,
+                                    restored_accounts_);
+    manager_.verify_ledger_consistency();
+  }
+  manager_.stats_.total_snapshots_restored++;
+  manager_.stats_.total_bytes_read += bytes_;
+
+  std::cout << "Snapshot Manager: Streaming restore complete at slot "
+            << metadata_.slot << " (" << restored_accounts_ << " restored, "
+            << failed_restorations_ << " failed)" << std::endl;
+  return true;
+}
+
+void SnapshotManager::StreamingRestore::abort() {
+  failed_ = true;
+  if (pipeline_) {
+    pipeline_->abort(); // Joins the stages
+    pipeline_.reset();
+  }
+}
+
 std::vector<AccountSnapshot>
 SnapshotManager::load_accounts_from_snapshot(const std::string &snapshot_path) {
   std::vector<AccountSnapshot> accounts;
@@ -408,35 +618,31 @@ SnapshotManager::load_accounts_from_snapshot(const std::string &snapshot_path) {
       return accounts;
     }
 
-    std::ifstream file(snapshot_path, std::ios::binary);
-    if (!file.is_open()) {
+    SnapshotArchiveReader reader;
+    if (!reader.open(snapshot_path)) {
+      SnapshotMetadata metadata;
+      read_legacy_snapshot(snapshot_path, metadata, accounts);
       return accounts;
     }
 
-    // Skip metadata
-    uint32_t metadata_size;
-    file.read(reinterpret_cast<char *>(&metadata_size), sizeof(metadata_size));
-    file.seekg(metadata_size, std::ios::cur);
-
-    // Read accounts
-    uint32_t account_count;
-    file.read(reinterpret_cast<char *>(&account_count), sizeof(account_count));
-
-    accounts.reserve(account_count);
-
-    for (uint32_t i = 0; i < account_count; ++i) {
-      uint32_t account_size;
-      file.read(reinterpret_cast<char *>(&account_size), sizeof(account_size));
-
-      std::vector<uint8_t> account_bytes(account_size);
-      file.read(reinterpret_cast<char *>(account_bytes.data()), account_size);
-
-      size_t offset = 0;
-      AccountSnapshot account = deserialize_account(account_bytes, offset);
-      accounts.push_back(account);
+    // Decode in parallel, then concatenate in chunk order
+    std::vector<std::vector<AccountSnapshot>> chunks(reader.chunks().size());
+    bool complete = reader.for_each_chunk(
+        [&](const ChunkIndexEntry &entry, std::vector<AccountSnapshot> &batch) {
+          chunks[entry.header.chunk_index] = std::move(batch);
+          return true;
+        },
+        snapshot_threads_);
+    if (!complete) {
+      std::cerr << "Failed to load accounts from snapshot: corrupt chunk in "
+                << snapshot_path << std::endl;
+      return accounts;
     }
 
-    file.close();
+    accounts.reserve(reader.account_count());
+    for (auto &chunk : chunks) {
+      std::move(chunk.begin(), chunk.end(), std::back_inserter(accounts));
+    }
   } catch (const std::exception &e) {
     std::cerr << "Failed to load accounts from snapshot: " << e.what()
               << std::endl;
@@ -552,6 +758,23 @@ bool SnapshotManager::verify_snapshot_integrity(
     }
 
     file.close();
+
+    // Chunked archives carry a hash per chunk; check them all in parallel
+    SnapshotArchiveReader reader;
+    if (reader.open(snapshot_path) && !reader.verify(snapshot_threads_)) {
+      return false;
+    }
+
+    // The recorded accounts hash covers the accounts themselves
+    if (!metadata.accounts_hash.empty()) {
+      std::string accounts_hash = calculate_accounts_hash(snapshot_path);
+      if (accounts_hash != metadata.accounts_hash) {
+        std::cerr << "Snapshot accounts hash mismatch: expected "
+                  << metadata.accounts_hash << ", got " << accounts_hash
+                  << std::endl;
+        return false;
+      }
+    }
     return true;
   } catch (const std::exception &e) {
     std::cerr << "Snapshot verification failed: " << e.what() << std::endl;
@@ -578,8 +801,92 @@ SnapshotManager::calculate_snapshot_hash(const std::string &snapshot_path) {
   }
 }
 
+std::string
+SnapshotManager::calculate_accounts_hash(const std::string &snapshot_path) {
+  try {
+    SnapshotMetadata metadata;
+    std::vector<std::pair<common::PublicKey, storage::AccountHash>> hashes;
+
+    SnapshotArchiveReader reader;
+    if (reader.open(snapshot_path)) {
+      // Accounts are hashed on the decoding threads, chunk by chunk
+      metadata = deserialize_metadata(reader.header());
+      std::mutex hashes_mutex;
+      bool ok = reader.for_each_chunk(
+          [&](const ChunkIndexEntry &, std::vector<AccountSnapshot> &accounts) {
+            std::vector<std::pair<common::PublicKey, storage::AccountHash>>
+                chunk_hashes;
+            chunk_hashes.reserve(accounts.size());
+            for (auto &account : accounts) {
+              auto hash = hash_account_snapshot(account);
+              chunk_hashes.emplace_back(std::move(account.pubkey), hash);
+            }
+            std::lock_guard<std::mutex> lock(hashes_mutex);
+            hashes.insert(hashes.end(),
+                          std::make_move_iterator(chunk_hashes.begin()),
+                          std::make_move_iterator(chunk_hashes.end()));
+            return true;
+          },
+          snapshot_threads_);
+      if (!ok) {
+        return "";
+      }
+    } else {
+      std::vector<AccountSnapshot> accounts;
+      if (!read_legacy_snapshot(snapshot_path, metadata, accounts)) {
+        return "";
+      }
+      return hash_snapshot_accounts(accounts, metadata.is_incremental);
+    }
+
+    storage::AccountsHasher::Options options;
+    options.threads = snapshot_threads_;
+    options.include_zero_lamport = metadata.is_incremental;
+    storage::AccountsHasher hasher(options);
+    hasher.insert_hashes(std::move(hashes));
+    return hasher.root_hex();
+  } catch (const std::exception &e) {
+    std::cerr << "Failed to calculate accounts hash: " << e.what()
+              << std::endl;
+    return "";
+  }
+}
+
 // Private helper methods
 
+std::string SnapshotManager::hash_snapshot_accounts(
+    const std::vector<AccountSnapshot> &accounts, bool is_incremental) const {
+  // Incremental snapshots keep their tombstones in the hash
+  storage::AccountsHasher::Options options;
+  options.threads = snapshot_threads_;
+  options.include_zero_lamport = is_incremental;
+  storage::AccountsHasher hasher(options);
+
+  std::vector<std::pair<common::PublicKey, storage::AccountHash>> hashes(
+      accounts.size());
+  size_t threads = snapshot_threads_ > 0 ? snapshot_threads_
+                                         : std::thread::hardware_concurrency();
+  threads = std::max<size_t>(1, std::min(threads, accounts.size() / 1024 + 1));
+  size_t per_thread = (accounts.size() + threads - 1) / threads;
+  auto hash_range = [&](size_t begin) {
+    size_t end = std::min(accounts.size(), begin + per_thread);
+    for (size_t i = begin; i < end; ++i) {
+      hashes[i] = {accounts[i].pubkey, hash_account_snapshot(accounts[i])};
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t) {
+    workers.emplace_back(hash_range, t * per_thread);
+  }
+  hash_range(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  hasher.insert_hashes(std::move(hashes));
+  return hasher.root_hex();
+}
+
 std::string
 SnapshotManager::generate_snapshot_filename(uint64_t slot, bool is_incremental,
                                             uint64_t base_slot) const {
@@ -637,6 +944,88 @@ SnapshotManager::calculate_hash(const std::vector<uint8_t> &data) const {
   }
 }
 
+bool SnapshotManager::write_snapshot_archive(
+    const std::string &snapshot_path, SnapshotMetadata &metadata,
+    const std::function<bool(const AccountSink &)> &produce,
+    uint64_t &uncompressed_size) const {
+  SnapshotArchiveWriter::Options options;
+  options.codec =
+      compression_enabled_ ? compression_codec_ : SnapshotCodec::NONE;
+  options.chunk_size = max_chunk_size_;
+  options.threads = snapshot_threads_;
+  SnapshotArchiveWriter writer(options);
+  if (!writer.open(snapshot_path, serialize_metadata(metadata))) {
+    return false;
+  }
+  AccountSink sink = [&writer](AccountSnapshot account) {
+    return writer.add(std::move(account));
+  };
+  if (!produce(sink)) {
+    writer.abort();
+    return false;
+  }
+  // Counts are fixed-width, so the header keeps its size
+  auto header = serialize_metadata(metadata);
+  if (!writer.finish(&header)) {
+    return false;
+  }
+  uncompressed_size = writer.uncompressed_bytes();
+  return true;
+}
+
+bool SnapshotManager::write_snapshot_archive(
+    const std::string &snapshot_path, SnapshotMetadata &metadata,
+    std::vector<AccountSnapshot> &accounts, uint64_t &uncompressed_size) const {
+  // Pubkey order gives every chunk a disjoint key range
+  std::sort(accounts.begin(), accounts.end(),
+            [](const AccountSnapshot &a, const AccountSnapshot &b) {
+              return a.pubkey < b.pubkey;
+            });
+  return write_snapshot_archive(
+      snapshot_path, metadata,
+      [&accounts](const AccountSink &sink) {
+        for (auto &account : accounts) {
+          if (!sink(std::move(account))) {
+            return false;
+          }
+        }
+        return true;
+      },
+      uncompressed_size);
+}
+
+bool SnapshotManager::read_legacy_snapshot(
+    const std::string &snapshot_path, SnapshotMetadata &metadata,
+    std::vector<AccountSnapshot> &accounts) const {
+  // Single-stream layout: metadata, then length-prefixed accounts
+  std::ifstream file(snapshot_path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  uint32_t metadata_size;
+  file.read(reinterpret_cast<char *>(&metadata_size), sizeof(metadata_size));
+  std::vector<uint8_t> metadata_bytes(metadata_size);
+  file.read(reinterpret_cast<char *>(metadata_bytes.data()), metadata_size);
+  metadata = deserialize_metadata(metadata_bytes);
+
+  uint32_t account_count;
+  file.read(reinterpret_cast<char *>(&account_count), sizeof(account_count));
+  accounts.reserve(account_count);
+
+  for (uint32_t i = 0; i < account_count; ++i) {
+    uint32_t account_size;
+    file.read(reinterpret_cast<char *>(&account_size), sizeof(account_size));
+
+    std::vector<uint8_t> account_bytes(account_size);
+    file.read(reinterpret_cast<char *>(account_bytes.data()), account_size);
+
+    size_t offset = 0;
+    accounts.push_back(deserialize_account(account_bytes, offset));
+  }
+  return true;
+}
+
 std::vector<uint8_t>
 SnapshotManager::serialize_metadata(const SnapshotMetadata &metadata) const {
   std::vector<uint8_t> result;
@@ -681,6 +1070,16 @@ SnapshotManager::serialize_metadata(const SnapshotMetadata &metadata) const {
                 reinterpret_cast<const uint8_t *>(&metadata.base_slot) +
                     sizeof(metadata.base_slot));
 
+  // Trailing field; metadata written before it ends at base_slot
+  uint32_t accounts_hash_len =
+      static_cast<uint32_t>(metadata.accounts_hash.length());
+  result.insert(result.end(),
+                reinterpret_cast<const uint8_t *>(&accounts_hash_len),
+                reinterpret_cast<const uint8_t *>(&accounts_hash_len) +
+                    sizeof(accounts_hash_len));
+  result.insert(result.end(), metadata.accounts_hash.begin(),
+                metadata.accounts_hash.end());
+
   return result;
 }
 
@@ -807,6 +1206,21 @@ SnapshotManager::deserialize_metadata(const std::vector<uint8_t> &data) const {
   }
   std::memcpy(&metadata.base_slot, data.data() + offset,
               sizeof(metadata.base_slot));
+  offset += sizeof(metadata.base_slot);
+
+  // Read accounts_hash (absent from older snapshots)
+  if (offset + sizeof(uint32_t) <= data.size()) {
+    uint32_t accounts_hash_len;
+    std::memcpy(&accounts_hash_len, data.data() + offset,
+                sizeof(accounts_hash_len));
+    offset += sizeof(accounts_hash_len);
+    if (accounts_hash_len <= 1024 &&
+        offset + accounts_hash_len <= data.size()) {
+      metadata.accounts_hash = std::string(
+          reinterpret_cast<const char *>(data.data() + offset),
+          accounts_hash_len);
+    }
+  }
 
   return metadata;
 }
@@ -937,9 +1351,6 @@ bool SnapshotManager::restore_account_to_ledger(
     const AccountSnapshot &account) const {
   try {
     // Production ledger account restoration
-    std::cout << "Restoring account " << pubkey_to_string(account.pubkey)
-              << " with " << account.lamports << " lamports" << std::endl;
-
     // Simulate ledger account creation/update
     // In production, this would interface with the actual ledger database
 
@@ -994,7 +1405,8 @@ AutoSnapshotService::AutoSnapshotService(
       incremental_snapshot_interval_(1000) // Every 1,000 slots
       ,
       cleanup_enabled_(true), max_snapshots_to_keep_(10),
-      last_snapshot_slot_(0), next_snapshot_slot_(0) {
+      last_snapshot_slot_(0), last_full_snapshot_slot_(0),
+      next_snapshot_slot_(0) {
   std::cout << "Auto Snapshot Service: Initialized" << std::endl;
 }
 
@@ -1037,12 +1449,16 @@ void AutoSnapshotService::stop() {
 void AutoSnapshotService::service_loop() {
   std::cout << "Auto Snapshot Service: Service loop started" << std::endl;
 
-  uint64_t current_slot = 1000; // Mock starting slot
+  uint64_t current_slot = 1000; // Mock starting slot without a slot source
 
   while (!should_stop_) {
     try {
-      // Simulate slot progression
-      current_slot += 1;
+      if (slot_source_) {
+        current_slot = slot_source_();
+      } else {
+        // Simulate slot progression
+        current_slot += 1;
+      }
 
       // Check if we should create a snapshot
       if (should_create_snapshot(current_slot)) {
@@ -1054,10 +1470,12 @@ void AutoSnapshotService::service_loop() {
           if (snapshot_manager_->create_full_snapshot(current_slot,
                                                       "/tmp/mock_ledger")) {
             last_snapshot_slot_ = current_slot;
+            last_full_snapshot_slot_ = current_slot;
             last_snapshot_time_ = std::chrono::system_clock::now();
           }
         } else {
-          uint64_t base_slot = last_snapshot_slot_;
+          // Incrementals hold everything changed since the last full one
+          uint64_t base_slot = last_full_snapshot_slot_;
           std::cout
               << "Auto Snapshot Service: Creating incremental snapshot at slot "
               << current_slot << " (base: " << base_slot << ")" << std::endl;
@@ -1084,7 +1502,7 @@ void AutoSnapshotService::service_loop() {
     }
 
     // For demo purposes, stop after creating a few snapshots
-    if (current_slot > 1050) {
+    if (!slot_source_ && current_slot > 1050) {
       break;
     }
   }
@@ -1096,17 +1514,20 @@ bool AutoSnapshotService::should_create_snapshot(uint64_t current_slot) const {
   if (last_snapshot_slot_ == 0) {
     return true; // First snapshot
   }
+  if (current_slot <= last_snapshot_slot_) {
+    return false;
+  }
 
   return (current_slot - last_snapshot_slot_) >= incremental_snapshot_interval_;
 }
 
 bool AutoSnapshotService::should_create_full_snapshot(
     uint64_t current_slot) const {
-  if (last_snapshot_slot_ == 0) {
+  if (last_full_snapshot_slot_ == 0) {
     return true; // First snapshot should be full
   }
 
-  return (current_slot - last_snapshot_slot_) >= full_snapshot_interval_;
+  return (current_slot - last_full_snapshot_slot_) >= full_snapshot_interval_;
 }
 
 void AutoSnapshotService::cleanup_old_snapshots() {
@@ -1296,32 +1717,24 @@ bool SnapshotManager::compress_data(const std::vector<uint8_t> &input,
     return true;
   }
 
-  // Simple compression using basic RLE (Run Length Encoding)
-  output.clear();
-  output.reserve(input.size());
-
-  if (input.empty()) {
-    return true;
+  // [u8 codec][u64 original size][payload]; stored raw when the codec is
+  // not built in or would not shrink the data
+  SnapshotCodec codec = compression_codec_;
+  std::vector<uint8_t> payload;
+  if (!snapshot_codec_available(codec) ||
+      !snapshot_archive::compress(codec, 3, input.data(), input.size(),
+                                  payload) ||
+      payload.size() >= input.size()) {
+    codec = SnapshotCodec::NONE;
+    payload = input;
   }
 
-  uint8_t current_byte = input[0];
-  uint8_t count = 1;
-
-  for (size_t i = 1; i < input.size(); ++i) {
-    if (input[i] == current_byte && count < 255) {
-      count++;
-    } else {
-      output.push_back(count);
-      output.push_back(current_byte);
-      current_byte = input[i];
-      count = 1;
-    }
-  }
-
-  // Add the last run
-  output.push_back(count);
-  output.push_back(current_byte);
-
+  uint64_t size = input.size();
+  output.resize(1 + sizeof(size) + payload.size());
+  output[0] = static_cast<uint8_t>(codec);
+  std::memcpy(output.data() + 1, &size, sizeof(size));
+  std::memcpy(output.data() + 1 + sizeof(size), payload.data(),
+              payload.size());
   return true;
 }
 
@@ -1332,23 +1745,17 @@ bool SnapshotManager::decompress_data(const std::vector<uint8_t> &input,
     return true;
   }
 
-  output.clear();
-
-  if (input.size() % 2 != 0) {
+  uint64_t size;
+  if (input.size() < 1 + sizeof(size) ||
+      input[0] > static_cast<uint8_t>(SnapshotCodec::LZ4)) {
     std::cerr << "Invalid compressed data format" << std::endl;
     return false;
   }
-
-  for (size_t i = 0; i < input.size(); i += 2) {
-    uint8_t count = input[i];
-    uint8_t byte_value = input[i + 1];
-
-    for (uint8_t j = 0; j < count; ++j) {
-      output.push_back(byte_value);
-    }
-  }
-
-  return true;
+  std::memcpy(&size, input.data() + 1, sizeof(size));
+  return snapshot_archive::decompress(static_cast<SnapshotCodec>(input[0]),
+                                      input.data() + 1 + sizeof(size),
+                                      input.size() - 1 - sizeof(size), size,
+                                      output);
 }
 
 bool SnapshotStreamingService::verify_stream_integrity(
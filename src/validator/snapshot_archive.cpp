@@ -0,0 +1,753 @@
+#include "validator/snapshot_archive.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef SLONANA_HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef SLONANA_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace slonana {
+namespace validator {
+
+namespace {
+
+using namespace snapshot_archive;
+
+// Serialized account: pubkey, lamports, data length, data, owner,
+// executable, rent epoch (the SnapshotManager account encoding)
+constexpr size_t ACCOUNT_FIXED_SIZE = 32 + 8 + 4 + 32 + 1 + 8;
+constexpr uint32_t MAX_HEADER_SIZE = 16 * 1024 * 1024;
+constexpr size_t MAX_CHUNK_BYTES = 1ULL << 31;
+
+void put_u32(uint8_t *out, uint32_t value) {
+  std::memcpy(out, &value, sizeof(value));
+}
+
+void put_u64(uint8_t *out, uint64_t value) {
+  std::memcpy(out, &value, sizeof(value));
+}
+
+uint32_t get_u32(const uint8_t *in) {
+  uint32_t value;
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+uint64_t get_u64(const uint8_t *in) {
+  uint64_t value;
+  std::memcpy(&value, in, sizeof(value));
+  return value;
+}
+
+std::array<uint8_t, 32> key_bytes(const common::PublicKey &pubkey) {
+  std::array<uint8_t, 32> key{};
+  std::memcpy(key.data(), pubkey.data(), std::min(pubkey.size(), key.size()));
+  return key;
+}
+
+size_t resolve_threads(size_t threads) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return std::max<size_t>(threads, 1);
+}
+
+} // namespace
+
+bool snapshot_codec_available(SnapshotCodec codec) {
+  switch (codec) {
+  case SnapshotCodec::NONE:
+    return true;
+  case SnapshotCodec::ZSTD:
+#ifdef SLONANA_HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  case SnapshotCodec::LZ4:
+#ifdef SLONANA_HAVE_LZ4
+    return true;
+#else
+    return false;
+#endif
+  }
+  return false;
+}
+
+const char *snapshot_codec_name(SnapshotCodec codec) {
+  switch (codec) {
+  case SnapshotCodec::NONE:
+    return "none";
+  case SnapshotCodec::ZSTD:
+    return "zstd";
+  case SnapshotCodec::LZ4:
+    return "lz4";
+  }
+  return "unknown";
+}
+
+void ChunkFrameHeader::encode(uint8_t *out) const {
+  put_u32(out, FRAME_MAGIC);
+  put_u32(out + 4, chunk_index);
+  out[8] = static_cast<uint8_t>(codec);
+  out[9] = out[10] = out[11] = 0;
+  put_u32(out + 12, account_count);
+  put_u32(out + 16, uncompressed_size);
+  put_u32(out + 20, compressed_size);
+  std::memcpy(out + 24, first_pubkey.data(), 32);
+  std::memcpy(out + 56, last_pubkey.data(), 32);
+  std::memcpy(out + 88, hash.data(), 32);
+}
+
+bool ChunkFrameHeader::decode(const uint8_t *in) {
+  if (get_u32(in) != FRAME_MAGIC || in[8] > static_cast<uint8_t>(SnapshotCodec::LZ4)) {
+    return false;
+  }
+  chunk_index = get_u32(in + 4);
+  codec = static_cast<SnapshotCodec>(in[8]);
+  account_count = get_u32(in + 12);
+  uncompressed_size = get_u32(in + 16);
+  compressed_size = get_u32(in + 20);
+  std::memcpy(first_pubkey.data(), in + 24, 32);
+  std::memcpy(last_pubkey.data(), in + 56, 32);
+  std::memcpy(hash.data(), in + 88, 32);
+  return true;
+}
+
+// Payload helpers
+
+namespace snapshot_archive {
+
+void serialize_accounts(const std::vector<AccountSnapshot> &accounts,
+                        std::vector<uint8_t> &out) {
+  size_t total = 0;
+  for (const auto &account : accounts) {
+    total += ACCOUNT_FIXED_SIZE + account.data.size();
+  }
+  out.resize(total);
+
+  uint8_t *at = out.data();
+  for (const auto &account : accounts) {
+    auto pubkey = key_bytes(account.pubkey);
+    std::memcpy(at, pubkey.data(), 32);
+    put_u64(at + 32, account.lamports);
+    put_u32(at + 40, static_cast<uint32_t>(account.data.size()));
+    at += 44;
+    if (!account.data.empty()) {
+      std::memcpy(at, account.data.data(), account.data.size());
+      at += account.data.size();
+    }
+    auto owner = key_bytes(account.owner);
+    std::memcpy(at, owner.data(), 32);
+    at[32] = account.executable ? 1 : 0;
+    put_u64(at + 33, account.rent_epoch);
+    at += 41;
+  }
+}
+
+bool deserialize_accounts(const uint8_t *data, size_t size,
+                          size_t expected_count,
+                          std::vector<AccountSnapshot> &out) {
+  out.clear();
+  out.reserve(expected_count);
+  const uint8_t *at = data;
+  const uint8_t *end = data + size;
+  while (at < end) {
+    if (static_cast<size_t>(end - at) < ACCOUNT_FIXED_SIZE) {
+      return false;
+    }
+    uint32_t data_len = get_u32(at + 40);
+    if (static_cast<size_t>(end - at) < ACCOUNT_FIXED_SIZE + data_len) {
+      return false;
+    }
+    AccountSnapshot &account = out.emplace_back();
+    account.pubkey.assign(at, at + 32);
+    account.lamports = get_u64(at + 32);
+    at += 44;
+    account.data.assign(at, at + data_len);
+    at += data_len;
+    account.owner.assign(at, at + 32);
+    account.executable = at[32] == 1;
+    account.rent_epoch = get_u64(at + 33);
+    at += 41;
+  }
+  return out.size() == expected_count;
+}
+
+bool compress(SnapshotCodec codec, int level, const uint8_t *data,
+              size_t size, std::vector<uint8_t> &out) {
+  switch (codec) {
+  case SnapshotCodec::NONE:
+    out.assign(data, data + size);
+    return true;
+  case SnapshotCodec::ZSTD: {
+#ifdef SLONANA_HAVE_ZSTD
+    out.resize(ZSTD_compressBound(size));
+    size_t written = ZSTD_compress(out.data(), out.size(), data, size, level);
+    if (ZSTD_isError(written)) {
+      return false;
+    }
+    out.resize(written);
+    return true;
+#else
+    (void)level;
+    return false;
+#endif
+  }
+  case SnapshotCodec::LZ4: {
+#ifdef SLONANA_HAVE_LZ4
+    if (size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+      return false;
+    }
+    out.resize(LZ4_compressBound(static_cast<int>(size)));
+    int written = LZ4_compress_default(
+        reinterpret_cast<const char *>(data), reinterpret_cast<char *>(out.data()),
+        static_cast<int>(size), static_cast<int>(out.size()));
+    if (written <= 0) {
+      return false;
+    }
+    out.resize(written);
+    return true;
+#else
+    return false;
+#endif
+  }
+  }
+  return false;
+}
+
+bool decompress(SnapshotCodec codec, const uint8_t *data, size_t size,
+                size_t uncompressed_size, std::vector<uint8_t> &out) {
+  switch (codec) {
+  case SnapshotCodec::NONE:
+    if (size != uncompressed_size) {
+      return false;
+    }
+    out.assign(data, data + size);
+    return true;
+  case SnapshotCodec::ZSTD: {
+#ifdef SLONANA_HAVE_ZSTD
+    out.resize(uncompressed_size);
+    size_t read = ZSTD_decompress(out.data(), out.size(), data, size);
+    return !ZSTD_isError(read) && read == uncompressed_size;
+#else
+    return false;
+#endif
+  }
+  case SnapshotCodec::LZ4: {
+#ifdef SLONANA_HAVE_LZ4
+    out.resize(uncompressed_size);
+    int read = LZ4_decompress_safe(reinterpret_cast<const char *>(data),
+                                   reinterpret_cast<char *>(out.data()),
+                                   static_cast<int>(size),
+                                   static_cast<int>(out.size()));
+    return read >= 0 && static_cast<size_t>(read) == uncompressed_size;
+#else
+    return false;
+#endif
+  }
+  }
+  return false;
+}
+
+std::array<uint8_t, 32> sha256(const uint8_t *data, size_t size) {
+  std::array<uint8_t, 32> digest{};
+  unsigned int length = 0;
+  EVP_Digest(data, size, digest.data(), &length, EVP_sha256(), nullptr);
+  return digest;
+}
+
+bool decode_chunk(const ChunkFrameHeader &header, const uint8_t *payload,
+                  std::vector<uint8_t> &scratch,
+                  std::vector<AccountSnapshot> &accounts) {
+  if (sha256(payload, header.compressed_size) != header.hash) {
+    return false;
+  }
+  if (header.codec == SnapshotCodec::NONE) {
+    // Stored payloads deserialize in place
+    return header.compressed_size == header.uncompressed_size &&
+           deserialize_accounts(payload, header.compressed_size,
+                                header.account_count, accounts);
+  }
+  if (!decompress(header.codec, payload, header.compressed_size,
+                  header.uncompressed_size, scratch)) {
+    return false;
+  }
+  return deserialize_accounts(scratch.data(), scratch.size(),
+                              header.account_count, accounts);
+}
+
+} // namespace snapshot_archive
+
+// SnapshotArchiveWriter Implementation
+
+SnapshotArchiveWriter::SnapshotArchiveWriter()
+    : SnapshotArchiveWriter(Options{}) {}
+
+SnapshotArchiveWriter::SnapshotArchiveWriter(const Options &options)
+    : options_(options) {
+  options_.threads = resolve_threads(options_.threads);
+  if (options_.max_in_flight_chunks == 0) {
+    options_.max_in_flight_chunks = 2 * options_.threads;
+  }
+  options_.chunk_size = std::clamp<size_t>(options_.chunk_size, 1,
+                                           MAX_CHUNK_BYTES);
+}
+
+SnapshotArchiveWriter::~SnapshotArchiveWriter() {
+  if (file_) {
+    abort();
+  }
+}
+
+bool SnapshotArchiveWriter::open(const std::string &path,
+                                 const std::vector<uint8_t> &header) {
+  if (file_ || header.size() > MAX_HEADER_SIZE) {
+    return false;
+  }
+  if (!snapshot_codec_available(options_.codec)) {
+    options_.codec = SnapshotCodec::NONE;
+  }
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    return false;
+  }
+  path_ = path;
+
+  uint8_t prefix[4];
+  put_u32(prefix, static_cast<uint32_t>(header.size()));
+  uint8_t magic[8];
+  put_u64(magic, ARCHIVE_MAGIC);
+  if (std::fwrite(prefix, 1, sizeof(prefix), file_) != sizeof(prefix) ||
+      std::fwrite(header.data(), 1, header.size(), file_) != header.size() ||
+      std::fwrite(magic, 1, sizeof(magic), file_) != sizeof(magic)) {
+    abort();
+    return false;
+  }
+  header_size_ = header.size();
+  offset_ = sizeof(prefix) + header.size() + sizeof(magic);
+  bytes_written_ = offset_;
+
+  for (size_t i = 0; i < options_.threads; ++i) {
+    workers_.emplace_back(&SnapshotArchiveWriter::worker_loop, this);
+  }
+  return true;
+}
+
+bool SnapshotArchiveWriter::add(AccountSnapshot account) {
+  if (!file_) {
+    return false;
+  }
+  current_bytes_ += ACCOUNT_FIXED_SIZE + account.data.size();
+  current_.push_back(std::move(account));
+  ++account_count_;
+  if (current_bytes_ >= options_.chunk_size) {
+    submit_current();
+  }
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  return !failed_;
+}
+
+void SnapshotArchiveWriter::submit_current() {
+  if (current_.empty()) {
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    space_cv_.wait(lock, [this] {
+      return in_flight_ < options_.max_in_flight_chunks || failed_;
+    });
+    jobs_.push_back(Job{next_chunk_++, std::move(current_)});
+    ++in_flight_;
+  }
+  jobs_cv_.notify_one();
+  current_ = {};
+  current_bytes_ = 0;
+}
+
+void SnapshotArchiveWriter::worker_loop() {
+  std::vector<uint8_t> payload;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(state_mutex_);
+      jobs_cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    ChunkFrameHeader header;
+    header.chunk_index = job.chunk_index;
+    header.codec = options_.codec;
+    header.account_count = static_cast<uint32_t>(job.accounts.size());
+    header.first_pubkey.fill(0xFF);
+    for (const auto &account : job.accounts) {
+      auto key = key_bytes(account.pubkey);
+      header.first_pubkey = std::min(header.first_pubkey, key);
+      header.last_pubkey = std::max(header.last_pubkey, key);
+    }
+
+    serialize_accounts(job.accounts, payload);
+    std::vector<uint8_t> frame;
+    std::vector<uint8_t> compressed;
+    bool ok = payload.size() <= MAX_CHUNK_BYTES;
+    if (ok && header.codec != SnapshotCodec::NONE) {
+      ok = compress(header.codec, options_.compression_level, payload.data(),
+                    payload.size(), compressed);
+    }
+    const auto &body = header.codec == SnapshotCodec::NONE ? payload : compressed;
+    if (ok) {
+      header.uncompressed_size = static_cast<uint32_t>(payload.size());
+      header.compressed_size = static_cast<uint32_t>(body.size());
+      header.hash = sha256(body.data(), body.size());
+      frame.resize(FRAME_HEADER_SIZE + body.size());
+      header.encode(frame.data());
+      std::memcpy(frame.data() + FRAME_HEADER_SIZE, body.data(), body.size());
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(state_mutex_);
+      if (!ok) {
+        failed_ = true;
+        space_cv_.notify_all();
+        continue;
+      }
+      ready_.emplace(job.chunk_index,
+                     std::make_pair(header, std::move(frame)));
+      write_ready_frames();
+    }
+  }
+}
+
+void SnapshotArchiveWriter::write_ready_frames() {
+  // Frames leave in chunk order whichever worker finished first
+  for (auto it = ready_.find(next_write_); it != ready_.end();
+       it = ready_.find(next_write_)) {
+    const auto &[header, frame] = it->second;
+    if (!failed_ &&
+        std::fwrite(frame.data(), 1, frame.size(), file_) != frame.size()) {
+      failed_ = true;
+    }
+    index_.push_back(ChunkIndexEntry{offset_, header});
+    offset_ += frame.size();
+    bytes_written_ += frame.size();
+    uncompressed_bytes_ += header.uncompressed_size;
+    ready_.erase(it);
+    ++next_write_;
+    --in_flight_;
+  }
+  space_cv_.notify_all();
+}
+
+void SnapshotArchiveWriter::stop_workers() {
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    stopping_ = true;
+  }
+  jobs_cv_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+  workers_.clear();
+}
+
+bool SnapshotArchiveWriter::finish(const std::vector<uint8_t> *header) {
+  if (!file_) {
+    return false;
+  }
+  submit_current();
+  {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    space_cv_.wait(lock, [this] { return in_flight_ == 0 || failed_; });
+  }
+  stop_workers();
+  if (failed_ || (header && header->size() != header_size_)) {
+    abort();
+    return false;
+  }
+
+  std::vector<uint8_t> trailer(index_.size() * INDEX_ENTRY_SIZE +
+                               FOOTER_SIZE);
+  uint8_t *at = trailer.data();
+  for (const auto &entry : index_) {
+    put_u64(at, entry.offset);
+    entry.header.encode(at + 8);
+    at += INDEX_ENTRY_SIZE;
+  }
+  put_u64(at, offset_);
+  put_u32(at + 8, static_cast<uint32_t>(index_.size()));
+  put_u32(at + 12, FORMAT_VERSION);
+  put_u64(at + 16, INDEX_MAGIC);
+
+  bool ok = std::fwrite(trailer.data(), 1, trailer.size(), file_) ==
+            trailer.size();
+  if (ok && header) {
+    ok = std::fseek(file_, 4, SEEK_SET) == 0 &&
+         std::fwrite(header->data(), 1, header->size(), file_) ==
+             header->size();
+  }
+  ok = std::fclose(file_) == 0 && ok;
+  file_ = nullptr;
+  if (!ok) {
+    std::remove(path_.c_str());
+    return false;
+  }
+  bytes_written_ += trailer.size();
+  return true;
+}
+
+void SnapshotArchiveWriter::abort() {
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    failed_ = true;
+  }
+  space_cv_.notify_all();
+  stop_workers();
+  if (file_) {
+    std::fclose(file_);
+    file_ = nullptr;
+    std::remove(path_.c_str());
+  }
+}
+
+// SnapshotArchiveReader Implementation
+
+SnapshotArchiveReader::~SnapshotArchiveReader() { close(); }
+
+void SnapshotArchiveReader::close() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  header_.clear();
+  index_.clear();
+  partitioned_ = false;
+}
+
+bool SnapshotArchiveReader::read_at(uint64_t offset, uint8_t *out,
+                                    size_t size) const {
+  while (size > 0) {
+    ssize_t n = ::pread(fd_, out, size, static_cast<off_t>(offset));
+    if (n <= 0) {
+      return false;
+    }
+    out += n;
+    offset += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool SnapshotArchiveReader::open(const std::string &path) {
+  close();
+  fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) {
+    return false;
+  }
+  struct stat st;
+  if (::fstat(fd_, &st) != 0) {
+    close();
+    return false;
+  }
+  uint64_t file_size = static_cast<uint64_t>(st.st_size);
+
+  uint8_t prefix[4];
+  if (!read_at(0, prefix, sizeof(prefix))) {
+    close();
+    return false;
+  }
+  uint32_t header_size = get_u32(prefix);
+  uint64_t data_start = 4 + uint64_t{header_size} + 8;
+  if (header_size > MAX_HEADER_SIZE || data_start + FOOTER_SIZE > file_size) {
+    close();
+    return false;
+  }
+  std::vector<uint8_t> header(header_size + 8);
+  uint8_t footer[FOOTER_SIZE];
+  if (!read_at(4, header.data(), header.size()) ||
+      get_u64(header.data() + header_size) != ARCHIVE_MAGIC ||
+      !read_at(file_size - FOOTER_SIZE, footer, FOOTER_SIZE) ||
+      get_u64(footer + 16) != INDEX_MAGIC ||
+      get_u32(footer + 12) != FORMAT_VERSION) {
+    close(); // Not a chunked archive (or truncated)
+    return false;
+  }
+  header.resize(header_size);
+
+  uint64_t index_offset = get_u64(footer);
+  uint32_t chunk_count = get_u32(footer + 8);
+  if (index_offset < data_start ||
+      index_offset + uint64_t{chunk_count} * INDEX_ENTRY_SIZE + FOOTER_SIZE !=
+          file_size) {
+    close();
+    return false;
+  }
+
+  std::vector<uint8_t> raw(size_t{chunk_count} * INDEX_ENTRY_SIZE);
+  if (!read_at(index_offset, raw.data(), raw.size())) {
+    close();
+    return false;
+  }
+  std::vector<ChunkIndexEntry> index(chunk_count);
+  bool partitioned = true;
+  for (uint32_t i = 0; i < chunk_count; ++i) {
+    const uint8_t *at = raw.data() + size_t{i} * INDEX_ENTRY_SIZE;
+    auto &entry = index[i];
+    entry.offset = get_u64(at);
+    if (!entry.header.decode(at + 8) || entry.header.chunk_index != i ||
+        entry.offset < data_start ||
+        entry.offset + entry.frame_size() > index_offset) {
+      close();
+      return false;
+    }
+    if (i > 0 && entry.header.first_pubkey <= index[i - 1].header.last_pubkey) {
+      partitioned = false;
+    }
+  }
+
+  header_ = std::move(header);
+  index_ = std::move(index);
+  partitioned_ = partitioned;
+  return true;
+}
+
+uint64_t SnapshotArchiveReader::account_count() const {
+  uint64_t count = 0;
+  for (const auto &entry : index_) {
+    count += entry.header.account_count;
+  }
+  return count;
+}
+
+bool SnapshotArchiveReader::read_frame(size_t chunk,
+                                       std::vector<uint8_t> &frame) const {
+  if (fd_ < 0 || chunk >= index_.size()) {
+    return false;
+  }
+  const auto &entry = index_[chunk];
+  frame.resize(entry.frame_size());
+  ChunkFrameHeader stored;
+  return read_at(entry.offset, frame.data(), frame.size()) &&
+         stored.decode(frame.data()) &&
+         stored.compressed_size == entry.header.compressed_size &&
+         stored.hash == entry.header.hash;
+}
+
+bool SnapshotArchiveReader::read_chunk(
+    size_t chunk, std::vector<AccountSnapshot> &accounts) const {
+  std::vector<uint8_t> frame;
+  std::vector<uint8_t> scratch;
+  return read_frame(chunk, frame) &&
+         decode_chunk(index_[chunk].header, frame.data() + FRAME_HEADER_SIZE,
+                      scratch, accounts);
+}
+
+bool SnapshotArchiveReader::run_parallel(
+    size_t threads, const std::function<bool(size_t)> &task) const {
+  std::atomic<size_t> next{0};
+  std::atomic<bool> ok{true};
+  auto work = [&] {
+    while (ok.load(std::memory_order_relaxed)) {
+      size_t chunk = next.fetch_add(1);
+      if (chunk >= index_.size()) {
+        return;
+      }
+      if (!task(chunk)) {
+        ok.store(false);
+      }
+    }
+  };
+
+  threads = std::min(resolve_threads(threads), index_.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return ok.load();
+}
+
+bool SnapshotArchiveReader::for_each_chunk(const ChunkVisitor &visitor,
+                                           size_t threads) const {
+  if (fd_ < 0) {
+    return false;
+  }
+  return run_parallel(threads, [&](size_t chunk) {
+    thread_local std::vector<uint8_t> frame;
+    thread_local std::vector<uint8_t> scratch;
+    std::vector<AccountSnapshot> accounts;
+    return read_frame(chunk, frame) &&
+           decode_chunk(index_[chunk].header, frame.data() + FRAME_HEADER_SIZE,
+                        scratch, accounts) &&
+           visitor(index_[chunk], accounts);
+  });
+}
+
+bool SnapshotArchiveReader::verify(size_t threads) const {
+  if (fd_ < 0) {
+    return false;
+  }
+  return run_parallel(threads, [&](size_t chunk) {
+    thread_local std::vector<uint8_t> frame;
+    return read_frame(chunk, frame) &&
+           sha256(frame.data() + FRAME_HEADER_SIZE,
+                  index_[chunk].header.compressed_size) ==
+               index_[chunk].header.hash;
+  });
+}
+
+std::optional<AccountSnapshot>
+SnapshotArchiveReader::find_account(const common::PublicKey &pubkey) const {
+  auto key = key_bytes(pubkey);
+  auto search = [&](size_t chunk) -> std::optional<AccountSnapshot> {
+    std::vector<AccountSnapshot> accounts;
+    if (!read_chunk(chunk, accounts)) {
+      return std::nullopt;
+    }
+    for (auto &account : accounts) {
+      if (account.pubkey == pubkey) {
+        return std::move(account);
+      }
+    }
+    return std::nullopt;
+  };
+
+  if (partitioned_) {
+    // Last chunk starting at or before the key
+    auto it = std::upper_bound(index_.begin(), index_.end(), key,
+                               [](const auto &k, const ChunkIndexEntry &e) {
+                                 return k < e.header.first_pubkey;
+                               });
+    if (it == index_.begin() || key > std::prev(it)->header.last_pubkey) {
+      return std::nullopt;
+    }
+    return search(std::prev(it) - index_.begin());
+  }
+  for (size_t chunk = 0; chunk < index_.size(); ++chunk) {
+    const auto &header = index_[chunk].header;
+    if (key >= header.first_pubkey && key <= header.last_pubkey) {
+      if (auto found = search(chunk)) {
+        return found;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace validator
+} // namespace slonana
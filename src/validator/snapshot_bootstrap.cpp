@@ -33,6 +33,7 @@ SnapshotBootstrapManager::SnapshotBootstrapManager(
       13000; // Allow snapshots up to 13000 slots old
   finder_config.min_download_speed = 1.0; // Lower threshold for bootstrap
   finder_config.max_latency = 200.0;      // More tolerant latency for bootstrap
+  finder_config.expected_sha256 = config_.snapshot_sha256;
   snapshot_finder_ = std::make_unique<SnapshotFinder>(finder_config);
 
   // Configure HTTP client
@@ -377,8 +378,40 @@ SnapshotBootstrapManager::download_snapshot(const SnapshotInfo &info,
     this->report_progress(phase, current, total);
   };
 
+  // With an AccountsDB attached, chunks are restored as the downloaded
+  // prefix grows instead of after the whole file landed. A stream that
+  // fails only stops restoring; the download itself carries on
+  std::unique_ptr<SnapshotManager::StreamingRestore> restore;
+  bool streaming = false;
+  if (accounts_db_) {
+    snapshot_manager_->set_accounts_db(accounts_db_);
+    restore = snapshot_manager_->begin_streaming_restore();
+    streaming = true;
+    snapshot_finder_->set_download_consumer(
+        [&restore, &streaming](const uint8_t *data, size_t size) {
+          if (streaming && !restore->feed(data, size)) {
+            streaming = false;
+          }
+          return true;
+        });
+  }
+
   auto download_result = snapshot_finder_->download_snapshot_from_best_source(
       snapshot_dir_, local_path_out, progress_cb);
+
+  if (restore) {
+    snapshot_finder_->set_download_consumer(nullptr);
+    streamed_snapshot_path_.clear();
+    if (download_result.is_ok() && streaming && restore->finish()) {
+      streamed_snapshot_path_ = local_path_out;
+      std::cout << "✅ Snapshot restored while downloading" << std::endl;
+    } else {
+      restore->abort();
+    }
+    restore.reset();
+    snapshot_manager_->set_accounts_db(nullptr);
+  }
+
   if (!download_result.is_ok()) {
     return common::Result<bool>("Advanced snapshot download failed: " +
                                 download_result.error());
@@ -535,6 +568,13 @@ common::Result<bool>
 SnapshotBootstrapManager::apply_snapshot(const std::string &local_path) {
   std::cout << "Applying snapshot to ledger..." << std::endl;
 
+  // Chunks are hash-checked as they are decoded, so a streamed restore is
+  // complete once the download is
+  if (!streamed_snapshot_path_.empty() && local_path == streamed_snapshot_path_) {
+    std::cout << "Snapshot already applied while downloading" << std::endl;
+    return common::Result<bool>(true);
+  }
+
   // Production implementation: Full snapshot extraction and restoration
   std::string extract_dir = config_.ledger_path + "/snapshot_extracted";
 
@@ -550,9 +590,12 @@ SnapshotBootstrapManager::apply_snapshot(const std::string &local_path) {
                                 restore_result.error());
   }
 
-  // Use snapshot manager to finalize restoration
+  // Use snapshot manager to finalize restoration (sequential fallback when
+  // the download could not be restored as it arrived)
+  snapshot_manager_->set_accounts_db(accounts_db_);
   bool success =
       snapshot_manager_->restore_from_snapshot(local_path, config_.ledger_path);
+  snapshot_manager_->set_accounts_db(nullptr);
   if (!success) {
     std::cout << "Warning: Snapshot manager restore failed, but manual "
                  "restoration succeeded"
@@ -0,0 +1,901 @@
+#include "validator/snapshot_downloader.h"
+#include "network/http_client.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <curl/curl.h>
+#include <fcntl.h>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <openssl/evp.h>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace slonana {
+namespace validator {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t PROGRESS_MAGIC = 0x31504c44414e4c53ULL; // "SLNADLP1"
+constexpr size_t PROGRESS_HEADER_SIZE = 8 + 8 + 8 + 4;
+constexpr size_t HASH_READ_SIZE = 1024 * 1024;
+constexpr double THROUGHPUT_SMOOTHING = 0.3;
+
+enum PieceState : uint8_t {
+  PIECE_PENDING = 0,
+  PIECE_IN_FLIGHT = 1,
+  PIECE_DONE = 2,
+};
+
+std::once_flag curl_init_flag;
+
+std::string to_hex(const uint8_t *data, size_t size) {
+  std::ostringstream out;
+  for (size_t i = 0; i < size; ++i) {
+    out << std::hex << std::setw(2) << std::setfill('0')
+        << static_cast<int>(data[i]);
+  }
+  return out.str();
+}
+
+std::string to_lower(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return value;
+}
+
+std::string trim(const std::string &value) {
+  size_t begin = value.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  size_t end = value.find_last_not_of(" \t\r\n");
+  return value.substr(begin, end - begin + 1);
+}
+
+std::string url_file_name(const std::string &url) {
+  std::string path = url.substr(0, url.find_first_of("?#"));
+  return path.substr(path.find_last_of('/') + 1);
+}
+
+void put_u64(uint8_t *out, uint64_t value) {
+  for (size_t i = 0; i < 8; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+void put_u32(uint8_t *out, uint32_t value) {
+  for (size_t i = 0; i < 4; ++i) {
+    out[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint32_t get_u32(const uint8_t *in) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    value |= static_cast<uint32_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+uint64_t get_u64(const uint8_t *in) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    value |= static_cast<uint64_t>(in[i]) << (8 * i);
+  }
+  return value;
+}
+
+bool pwrite_all(int fd, const uint8_t *data, size_t size, uint64_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += n;
+    size -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+  return true;
+}
+
+bool pread_all(int fd, uint8_t *out, size_t size, uint64_t offset) {
+  while (size > 0) {
+    ssize_t n = ::pread(fd, out, size, static_cast<off_t>(offset));
+    if (n <= 0) {
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    out += n;
+    size -= static_cast<size_t>(n);
+    offset += static_cast<uint64_t>(n);
+  }
+  return true;
+}
+
+/// Headers of interest from a range probe; reset on every status line so
+/// redirects leave only the final response
+struct ProbeHeaders {
+  uint64_t range_total = 0;
+  std::string etag;
+  std::string last_modified;
+};
+
+size_t probe_header_callback(char *data, size_t size, size_t nmemb,
+                             void *userp) {
+  auto *headers = static_cast<ProbeHeaders *>(userp);
+  size_t bytes = size * nmemb;
+  std::string line(data, bytes);
+  if (line.rfind("HTTP/", 0) == 0) {
+    *headers = ProbeHeaders{};
+    return bytes;
+  }
+  size_t colon = line.find(':');
+  if (colon == std::string::npos) {
+    return bytes;
+  }
+  std::string name = to_lower(trim(line.substr(0, colon)));
+  std::string value = trim(line.substr(colon + 1));
+  if (name == "content-range") {
+    // bytes 0-0/<total>
+    size_t slash = value.find('/');
+    if (slash != std::string::npos && value.compare(slash + 1, 1, "*") != 0) {
+      try {
+        headers->range_total = std::stoull(value.substr(slash + 1));
+      } catch (const std::exception &) {
+        headers->range_total = 0;
+      }
+    }
+  } else if (name == "etag") {
+    headers->etag = value;
+  } else if (name == "last-modified") {
+    headers->last_modified = value;
+  }
+  return bytes;
+}
+
+/// Accepts the single probe byte; anything more means ranges are ignored
+size_t probe_write_callback(char *, size_t size, size_t nmemb, void *userp) {
+  auto *received = static_cast<size_t *>(userp);
+  *received += size * nmemb;
+  return *received > 1 ? 0 : size * nmemb;
+}
+
+/// Writes one range response in place
+struct RangeSink {
+  CURL *curl = nullptr;
+  int fd = -1;
+  uint64_t offset = 0;
+  uint64_t remaining = 0;
+  bool checked = false;
+};
+
+size_t range_write_callback(char *data, size_t size, size_t nmemb,
+                            void *userp) {
+  auto *sink = static_cast<RangeSink *>(userp);
+  size_t bytes = size * nmemb;
+  if (!sink->checked) {
+    // A server that ignores the Range header answers 200 with the whole
+    // file; writing that at our offset would corrupt other pieces
+    long code = 0;
+    curl_easy_getinfo(sink->curl, CURLINFO_RESPONSE_CODE, &code);
+    if (code != 206) {
+      return 0;
+    }
+    sink->checked = true;
+  }
+  if (bytes > sink->remaining ||
+      !pwrite_all(sink->fd, reinterpret_cast<const uint8_t *>(data), bytes,
+                  sink->offset)) {
+    return 0;
+  }
+  sink->offset += bytes;
+  sink->remaining -= bytes;
+  return bytes;
+}
+
+/// Collects a sample range in memory, refusing more than was asked for
+struct SampleSink {
+  std::vector<uint8_t> data;
+  size_t limit = 0;
+};
+
+size_t sample_write_callback(char *data, size_t size, size_t nmemb,
+                             void *userp) {
+  auto *sink = static_cast<SampleSink *>(userp);
+  size_t bytes = size * nmemb;
+  if (sink->data.size() + bytes > sink->limit) {
+    return 0;
+  }
+  sink->data.insert(sink->data.end(), data, data + bytes);
+  return bytes;
+}
+
+int cancel_callback(void *clientp, curl_off_t, curl_off_t, curl_off_t,
+                    curl_off_t) {
+  return static_cast<std::atomic<bool> *>(clientp)->load() ? 1 : 0;
+}
+
+} // namespace
+
+struct ParallelSnapshotDownloader::Source {
+  std::string url;
+  std::string validator; ///< ETag, else Last-Modified
+  uint64_t total_size = 0;
+  bool ranges = false;
+
+  // Guarded by Transfer::mutex while downloading
+  uint64_t bytes = 0;
+  uint64_t requests = 0;
+  uint64_t failures = 0;
+  size_t consecutive_failures = 0;
+  double throughput_bps = 0.0;
+  size_t request_pieces = 1;
+  bool active = true;
+};
+
+/**
+ * Shared state of one download() call
+ *
+ * Progress file layout: [u64 PROGRESS_MAGIC][u64 total size][u64 piece
+ * size][u32 validator length][validator][bitmap, bit i = piece i done]
+ */
+struct ParallelSnapshotDownloader::Transfer {
+  int fd = -1;
+  int progress_fd = -1;
+  uint64_t total_size = 0;
+  uint64_t piece_size = 0;
+  size_t piece_count = 0;
+  uint64_t bitmap_offset = 0;
+  std::vector<Source> sources;
+  ProgressCallback progress;
+
+  std::mutex mutex;
+  std::condition_variable work_cv; ///< Workers wait for returned pieces
+  std::condition_variable hash_cv; ///< Hasher waits for the prefix to grow
+  std::vector<uint8_t> pieces;     ///< PieceState per piece
+  std::vector<uint8_t> bitmap;
+  size_t next_pending = 0; ///< No pending piece below this
+  size_t done = 0;
+  size_t hashed = 0; ///< Pieces [0, hashed) are in the digest
+  uint64_t downloaded = 0;
+  uint64_t resumed = 0;
+  size_t workers_running = 0;
+  bool failed = false;
+  std::string error;
+  EVP_MD_CTX *digest = nullptr;
+
+  uint64_t piece_bytes(size_t first, size_t last) const {
+    return std::min(total_size, (last + 1) * piece_size) - first * piece_size;
+  }
+
+  /// Mark pieces done and persist their bitmap bytes; mutex held
+  bool complete_pieces(size_t first, size_t last) {
+    for (size_t i = first; i <= last; ++i) {
+      pieces[i] = PIECE_DONE;
+      bitmap[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+    }
+    done += last - first + 1;
+    return pwrite_all(progress_fd, bitmap.data() + first / 8,
+                      last / 8 - first / 8 + 1, bitmap_offset + first / 8);
+  }
+};
+
+ParallelSnapshotDownloader::ParallelSnapshotDownloader()
+    : ParallelSnapshotDownloader(Options{}) {}
+
+ParallelSnapshotDownloader::ParallelSnapshotDownloader(const Options &options)
+    : options_(options) {
+  options_.connections = std::max<size_t>(1, options_.connections);
+  options_.piece_size = std::max<size_t>(1, options_.piece_size);
+  options_.max_request_pieces = std::max<size_t>(1, options_.max_request_pieces);
+  options_.initial_request_pieces = std::clamp<size_t>(
+      options_.initial_request_pieces, 1, options_.max_request_pieces);
+  options_.max_source_failures = std::max<size_t>(1, options_.max_source_failures);
+  std::call_once(curl_init_flag,
+                 [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+ParallelSnapshotDownloader::~ParallelSnapshotDownloader() = default;
+
+std::vector<std::string> ParallelSnapshotDownloader::select_sources(
+    const std::vector<SnapshotQuality> &ranked, size_t max_sources) {
+  std::vector<std::string> urls;
+  if (ranked.empty()) {
+    return urls;
+  }
+  // Mirrors only help if they serve the very same snapshot
+  std::string name = url_file_name(ranked.front().download_url);
+  for (const auto &quality : ranked) {
+    if (urls.size() >= max_sources) {
+      break;
+    }
+    if (quality.download_url.empty() ||
+        url_file_name(quality.download_url) != name ||
+        std::find(urls.begin(), urls.end(), quality.download_url) !=
+            urls.end()) {
+      continue;
+    }
+    urls.push_back(quality.download_url);
+  }
+  return urls;
+}
+
+std::vector<ParallelSnapshotDownloader::SourceStats>
+ParallelSnapshotDownloader::source_stats() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return stats_;
+}
+
+bool ParallelSnapshotDownloader::probe_source(Source &source) {
+  CURL *curl = curl_easy_init();
+  if (!curl) {
+    return false;
+  }
+  ProbeHeaders headers;
+  size_t received = 0;
+  curl_easy_setopt(curl, CURLOPT_URL, source.url.c_str());
+  curl_easy_setopt(curl, CURLOPT_RANGE, "0-0");
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, probe_header_callback);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, &headers);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, probe_write_callback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &received);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, options_.user_agent.c_str());
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT,
+                   options_.connect_timeout_seconds);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, options_.stall_timeout_seconds);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+  CURLcode res = curl_easy_perform(curl);
+  long code = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  curl_easy_cleanup(curl);
+
+  source.ranges = res == CURLE_OK && code == 206 && headers.range_total > 0;
+  source.total_size = source.ranges ? headers.range_total : 0;
+  source.validator =
+      !headers.etag.empty() ? headers.etag : headers.last_modified;
+  return source.ranges;
+}
+
+std::string ParallelSnapshotDownloader::sample_digest(const Source &source,
+                                                      uint64_t offset,
+                                                      uint64_t length) {
+  CURL *curl = curl_easy_init();
+  if (!curl) {
+    return "";
+  }
+  SampleSink sink;
+  sink.limit = static_cast<size_t>(length);
+  std::string range =
+      std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+  curl_easy_setopt(curl, CURLOPT_URL, source.url.c_str());
+  curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, sample_write_callback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sink);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, options_.user_agent.c_str());
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT,
+                   options_.connect_timeout_seconds);
+  curl_easy_setopt(curl, CURLOPT_TIMEOUT, options_.stall_timeout_seconds);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+  CURLcode res = curl_easy_perform(curl);
+  long code = 0;
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  curl_easy_cleanup(curl);
+  if (res != CURLE_OK || code != 206 || sink.data.size() != length) {
+    return "";
+  }
+
+  uint8_t digest[EVP_MAX_MD_SIZE];
+  unsigned int digest_size = 0;
+  if (EVP_Digest(sink.data.data(), sink.data.size(), digest, &digest_size,
+                 EVP_sha256(), nullptr) != 1) {
+    return "";
+  }
+  return to_hex(digest, digest_size);
+}
+
+bool ParallelSnapshotDownloader::fetch_range(void *handle, Transfer &transfer,
+                                             Source &source, uint64_t offset,
+                                             uint64_t length) {
+  CURL *curl = static_cast<CURL *>(handle);
+  RangeSink sink;
+  sink.curl = curl;
+  sink.fd = transfer.fd;
+  sink.offset = offset;
+  sink.remaining = length;
+  std::string range =
+      std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+
+  // The handle is reused across requests so the connection stays alive
+  curl_easy_setopt(curl, CURLOPT_URL, source.url.c_str());
+  curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, range_write_callback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sink);
+  curl_easy_setopt(curl, CURLOPT_USERAGENT, options_.user_agent.c_str());
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT,
+                   options_.connect_timeout_seconds);
+  curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+  curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME,
+                   options_.stall_timeout_seconds);
+  curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+  curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancel_callback);
+  curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &cancelled_);
+
+  CURLcode res = curl_easy_perform(curl);
+  return res == CURLE_OK && sink.checked && sink.remaining == 0;
+}
+
+void ParallelSnapshotDownloader::worker_loop(Transfer &transfer,
+                                             size_t worker_index) {
+  CURL *curl = curl_easy_init();
+  size_t source_index = worker_index % transfer.sources.size();
+
+  std::unique_lock<std::mutex> lock(transfer.mutex);
+  while (curl && !transfer.failed && !cancelled_.load() &&
+         transfer.done < transfer.piece_count) {
+    bool have_source = false;
+    for (size_t i = 0; i < transfer.sources.size() && !have_source; ++i) {
+      size_t candidate = (source_index + i) % transfer.sources.size();
+      if (transfer.sources[candidate].active) {
+        source_index = candidate;
+        have_source = true;
+      }
+    }
+    if (!have_source) {
+      transfer.failed = true;
+      transfer.error = "All snapshot sources failed";
+      break;
+    }
+
+    while (transfer.next_pending < transfer.piece_count &&
+           transfer.pieces[transfer.next_pending] != PIECE_PENDING) {
+      ++transfer.next_pending;
+    }
+    if (transfer.next_pending == transfer.piece_count) {
+      // Everything left is in flight; wait in case a request fails
+      transfer.work_cv.wait(lock);
+      continue;
+    }
+
+    // Claim the lowest pending run so the hashed prefix keeps growing
+    Source &source = transfer.sources[source_index];
+    size_t first = transfer.next_pending;
+    size_t last = first;
+    while (last + 1 < transfer.piece_count &&
+           last + 1 - first < source.request_pieces &&
+           transfer.pieces[last + 1] == PIECE_PENDING) {
+      ++last;
+    }
+    for (size_t i = first; i <= last; ++i) {
+      transfer.pieces[i] = PIECE_IN_FLIGHT;
+    }
+    transfer.next_pending = last + 1;
+    uint64_t offset = first * transfer.piece_size;
+    uint64_t length = transfer.piece_bytes(first, last);
+    lock.unlock();
+
+    auto start = Clock::now();
+    // Data must be durable before the bitmap says so
+    bool ok = fetch_range(curl, transfer, source, offset, length) &&
+              ::fdatasync(transfer.fd) == 0;
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    lock.lock();
+    ++source.requests;
+    if (ok) {
+      if (!transfer.complete_pieces(first, last)) {
+        transfer.failed = true;
+        transfer.error = "Failed to update download progress file";
+      }
+      transfer.downloaded += length;
+      source.bytes += length;
+      source.consecutive_failures = 0;
+
+      double bps = static_cast<double>(length) / std::max(seconds, 1e-6);
+      source.throughput_bps =
+          source.throughput_bps == 0.0
+              ? bps
+              : THROUGHPUT_SMOOTHING * bps +
+                    (1.0 - THROUGHPUT_SMOOTHING) * source.throughput_bps;
+      source.request_pieces = std::clamp<size_t>(
+          static_cast<size_t>(source.throughput_bps *
+                              options_.target_request_seconds /
+                              static_cast<double>(transfer.piece_size)),
+          1, options_.max_request_pieces);
+
+      if (transfer.progress) {
+        transfer.progress(transfer.resumed + transfer.downloaded,
+                          transfer.total_size);
+      }
+      transfer.hash_cv.notify_one();
+    } else {
+      for (size_t i = first; i <= last; ++i) {
+        transfer.pieces[i] = PIECE_PENDING;
+      }
+      transfer.next_pending = std::min(transfer.next_pending, first);
+      ++source.failures;
+      if (++source.consecutive_failures >= options_.max_source_failures &&
+          source.active) {
+        source.active = false;
+        std::cout << "⚠️  Dropping snapshot source after "
+                  << source.consecutive_failures
+                  << " failed requests: " << source.url << std::endl;
+      }
+      // Retry the range on the next mirror
+      source_index = (source_index + 1) % transfer.sources.size();
+    }
+    transfer.work_cv.notify_all();
+  }
+
+  --transfer.workers_running;
+  transfer.work_cv.notify_all();
+  transfer.hash_cv.notify_all();
+  lock.unlock();
+  if (curl) {
+    curl_easy_cleanup(curl);
+  }
+}
+
+void ParallelSnapshotDownloader::hasher_loop(Transfer &transfer) {
+  std::vector<uint8_t> buffer(HASH_READ_SIZE);
+  std::unique_lock<std::mutex> lock(transfer.mutex);
+  while (true) {
+    transfer.hash_cv.wait(lock, [&] {
+      return transfer.hashed == transfer.piece_count ||
+             transfer.pieces[transfer.hashed] == PIECE_DONE ||
+             transfer.workers_running == 0;
+    });
+    if (transfer.hashed == transfer.piece_count ||
+        transfer.pieces[transfer.hashed] != PIECE_DONE) {
+      break; // Finished, or the workers stopped short of the next piece
+    }
+    size_t end = transfer.hashed;
+    while (end < transfer.piece_count &&
+           transfer.pieces[end] == PIECE_DONE) {
+      ++end;
+    }
+    uint64_t from = transfer.hashed * transfer.piece_size;
+    uint64_t to = std::min(transfer.total_size, end * transfer.piece_size);
+    lock.unlock();
+
+    // Done pieces never change again, so they can be read unlocked
+    bool ok = true;
+    bool consumed = true;
+    for (uint64_t offset = from; ok && consumed && offset < to;) {
+      size_t size = static_cast<size_t>(
+          std::min<uint64_t>(buffer.size(), to - offset));
+      ok = pread_all(transfer.fd, buffer.data(), size, offset) &&
+           EVP_DigestUpdate(transfer.digest, buffer.data(), size) == 1;
+      consumed = !ok || !data_consumer_ || data_consumer_(buffer.data(), size);
+      offset += size;
+    }
+
+    lock.lock();
+    if (!ok || !consumed) {
+      transfer.failed = true;
+      transfer.error = ok ? "Downloaded data rejected by its consumer"
+                          : "Failed to hash downloaded data";
+      transfer.work_cv.notify_all();
+      break;
+    }
+    transfer.hashed = end;
+  }
+}
+
+common::Result<bool> ParallelSnapshotDownloader::download(
+    const std::vector<std::string> &urls, const std::string &path,
+    ProgressCallback progress) {
+  cancelled_.store(false);
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.clear();
+  }
+  total_size_ = 0;
+  bytes_downloaded_ = 0;
+  bytes_resumed_ = 0;
+  sha256_hex_.clear();
+  if (urls.empty()) {
+    return common::Result<bool>("No snapshot sources to download from");
+  }
+
+  // Every mirror must serve ranges of a file the same size as the primary
+  Transfer transfer;
+  for (const auto &url : urls) {
+    Source source;
+    source.url = url;
+    if (!probe_source(source)) {
+      continue;
+    }
+    if (!transfer.sources.empty() &&
+        source.total_size != transfer.sources.front().total_size) {
+      std::cout << "⚠️  Skipping snapshot mirror with a different size: "
+                << url << std::endl;
+      continue;
+    }
+    source.request_pieces = options_.initial_request_pieces;
+    transfer.sources.push_back(std::move(source));
+  }
+  if (transfer.sources.empty()) {
+    std::cout << "⚠️  No source answers range requests, downloading "
+                 "sequentially"
+              << std::endl;
+    return download_single_stream(urls.front(), path, std::move(progress));
+  }
+
+  // Matching sizes do not mean matching bytes: every mirror must serve the
+  // primary's bytes for a sample range it cannot predict before its pieces
+  // are interleaved with the primary's
+  uint64_t sample_size = std::min<uint64_t>(options_.cross_check_bytes,
+                                            transfer.sources.front().total_size);
+  if (transfer.sources.size() > 1 && sample_size > 0) {
+    std::random_device seed;
+    std::mt19937_64 rng((static_cast<uint64_t>(seed()) << 32) | seed());
+    uint64_t sample_offset =
+        rng() % (transfer.sources.front().total_size - sample_size + 1);
+    std::string reference =
+        sample_digest(transfer.sources.front(), sample_offset, sample_size);
+    for (size_t i = transfer.sources.size(); i-- > 1;) {
+      if (!reference.empty() &&
+          sample_digest(transfer.sources[i], sample_offset, sample_size) ==
+              reference) {
+        continue;
+      }
+      std::cout << "⚠️  Skipping snapshot mirror whose data does not match "
+                   "the primary: "
+                << transfer.sources[i].url << std::endl;
+      transfer.sources.erase(transfer.sources.begin() + i);
+    }
+  }
+
+  const std::string &validator = transfer.sources.front().validator;
+  transfer.total_size = transfer.sources.front().total_size;
+  transfer.piece_size = options_.piece_size;
+  transfer.piece_count = static_cast<size_t>(
+      (transfer.total_size + transfer.piece_size - 1) / transfer.piece_size);
+  transfer.bitmap_offset = PROGRESS_HEADER_SIZE + validator.size();
+  transfer.bitmap.assign((transfer.piece_count + 7) / 8, 0);
+  transfer.pieces.assign(transfer.piece_count, PIECE_PENDING);
+  transfer.progress = std::move(progress);
+  total_size_ = transfer.total_size;
+
+  // Resume only if the bitmap describes this exact file
+  std::string progress_file = progress_path(path);
+  bool resume = false;
+  std::error_code ec;
+  if (fs::exists(path, ec) && fs::file_size(path, ec) == transfer.total_size) {
+    int fd = ::open(progress_file.c_str(), O_RDONLY);
+    if (fd >= 0) {
+      std::vector<uint8_t> header(transfer.bitmap_offset);
+      if (pread_all(fd, header.data(), header.size(), 0) &&
+          get_u64(header.data()) == PROGRESS_MAGIC &&
+          get_u64(header.data() + 8) == transfer.total_size &&
+          get_u64(header.data() + 16) == transfer.piece_size &&
+          get_u32(header.data() + 24) == validator.size() &&
+          std::memcmp(header.data() + PROGRESS_HEADER_SIZE, validator.data(),
+                      validator.size()) == 0) {
+        resume = pread_all(fd, transfer.bitmap.data(), transfer.bitmap.size(),
+                           transfer.bitmap_offset);
+      }
+      ::close(fd);
+    }
+  }
+  if (!resume) {
+    std::fill(transfer.bitmap.begin(), transfer.bitmap.end(), 0);
+  }
+
+  transfer.fd = ::open(path.c_str(), O_RDWR | O_CREAT | (resume ? 0 : O_TRUNC),
+                       0644);
+  transfer.progress_fd = ::open(progress_file.c_str(),
+                                O_RDWR | O_CREAT | (resume ? 0 : O_TRUNC), 0644);
+  auto close_files = [&transfer] {
+    if (transfer.fd >= 0) {
+      ::close(transfer.fd);
+      transfer.fd = -1;
+    }
+    if (transfer.progress_fd >= 0) {
+      ::close(transfer.progress_fd);
+      transfer.progress_fd = -1;
+    }
+  };
+  if (transfer.fd < 0 || transfer.progress_fd < 0) {
+    close_files();
+    return common::Result<bool>("Failed to open download file: " + path);
+  }
+
+  if (!resume) {
+    // Reserve the whole file up front so pieces land without fragmenting
+    // and a full disk fails now rather than hours in
+    if (transfer.total_size > 0 &&
+        ::posix_fallocate(transfer.fd, 0,
+                          static_cast<off_t>(transfer.total_size)) != 0 &&
+        ::ftruncate(transfer.fd, static_cast<off_t>(transfer.total_size)) !=
+            0) {
+      close_files();
+      return common::Result<bool>("Failed to preallocate " +
+                                  std::to_string(transfer.total_size) +
+                                  " bytes for " + path);
+    }
+    std::vector<uint8_t> header(transfer.bitmap_offset);
+    put_u64(header.data(), PROGRESS_MAGIC);
+    put_u64(header.data() + 8, transfer.total_size);
+    put_u64(header.data() + 16, transfer.piece_size);
+    put_u32(header.data() + 24, static_cast<uint32_t>(validator.size()));
+    std::memcpy(header.data() + PROGRESS_HEADER_SIZE, validator.data(),
+                validator.size());
+    if (!pwrite_all(transfer.progress_fd, header.data(), header.size(), 0) ||
+        !pwrite_all(transfer.progress_fd, transfer.bitmap.data(),
+                    transfer.bitmap.size(), transfer.bitmap_offset)) {
+      close_files();
+      return common::Result<bool>("Failed to write download progress file");
+    }
+  }
+
+  for (size_t i = 0; i < transfer.piece_count; ++i) {
+    if (transfer.bitmap[i / 8] & (1u << (i % 8))) {
+      transfer.pieces[i] = PIECE_DONE;
+      ++transfer.done;
+      transfer.resumed += transfer.piece_bytes(i, i);
+    }
+  }
+
+  std::cout << "📥 Parallel snapshot download: "
+            << transfer.total_size / (1024 * 1024) << " MB from "
+            << transfer.sources.size() << " source(s), "
+            << options_.connections << " connections";
+  if (transfer.resumed > 0) {
+    std::cout << ", resuming with " << transfer.resumed / (1024 * 1024)
+              << " MB already on disk";
+  }
+  std::cout << std::endl;
+
+  transfer.digest = EVP_MD_CTX_new();
+  if (!transfer.digest ||
+      EVP_DigestInit_ex(transfer.digest, EVP_sha256(), nullptr) != 1) {
+    EVP_MD_CTX_free(transfer.digest);
+    close_files();
+    return common::Result<bool>("Failed to initialize SHA-256");
+  }
+
+  size_t worker_count = std::max<size_t>(
+      1, std::min(options_.connections, transfer.piece_count - transfer.done));
+  transfer.workers_running = worker_count;
+  std::thread hasher([this, &transfer] { hasher_loop(transfer); });
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < worker_count; ++i) {
+    workers.emplace_back([this, &transfer, i] { worker_loop(transfer, i); });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  hasher.join();
+
+  bool complete = !transfer.failed && transfer.done == transfer.piece_count &&
+                  transfer.hashed == transfer.piece_count;
+  std::string digest_hex;
+  if (complete) {
+    uint8_t digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_size = 0;
+    EVP_DigestFinal_ex(transfer.digest, digest, &digest_size);
+    digest_hex = to_hex(digest, digest_size);
+  }
+  EVP_MD_CTX_free(transfer.digest);
+  close_files();
+
+  bytes_downloaded_ = transfer.downloaded;
+  bytes_resumed_ = transfer.resumed;
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    for (const auto &source : transfer.sources) {
+      stats_.push_back({source.url, source.bytes, source.requests,
+                        source.failures, source.throughput_bps,
+                        source.request_pieces, source.active});
+    }
+  }
+
+  if (cancelled_.load()) {
+    return common::Result<bool>("Snapshot download cancelled");
+  }
+  if (!complete) {
+    return common::Result<bool>(
+        transfer.error.empty() ? "Snapshot download incomplete"
+                               : transfer.error);
+  }
+
+  fs::remove(progress_file, ec);
+  sha256_hex_ = digest_hex;
+  if (!options_.expected_sha256.empty() &&
+      to_lower(options_.expected_sha256) != sha256_hex_) {
+    fs::remove(path, ec);
+    return common::Result<bool>("Snapshot SHA-256 mismatch: expected " +
+                                options_.expected_sha256 + ", got " +
+                                sha256_hex_);
+  }
+  return common::Result<bool>(true);
+}
+
+common::Result<bool> ParallelSnapshotDownloader::download_single_stream(
+    const std::string &url, const std::string &path,
+    ProgressCallback progress) {
+  network::HttpClient client;
+  client.set_user_agent(options_.user_agent);
+  bool ok = client.download_file(
+      url, path, [&progress](size_t downloaded, size_t total) {
+        if (progress) {
+          progress(downloaded, total);
+        }
+      });
+  if (!ok) {
+    return common::Result<bool>("Download failed from: " + url);
+  }
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return common::Result<bool>("Downloaded file does not exist: " + path);
+  }
+  EVP_MD_CTX *digest = EVP_MD_CTX_new();
+  bool hashed = digest && EVP_DigestInit_ex(digest, EVP_sha256(), nullptr) == 1;
+  std::vector<uint8_t> buffer(HASH_READ_SIZE);
+  uint64_t total = 0;
+  while (hashed) {
+    ssize_t n = ::read(fd, buffer.data(), buffer.size());
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      hashed = n == 0;
+      break;
+    }
+    hashed = EVP_DigestUpdate(digest, buffer.data(), static_cast<size_t>(n)) == 1 &&
+             (!data_consumer_ ||
+              data_consumer_(buffer.data(), static_cast<size_t>(n)));
+    total += static_cast<uint64_t>(n);
+  }
+  ::close(fd);
+  uint8_t out[EVP_MAX_MD_SIZE];
+  unsigned int out_size = 0;
+  hashed = hashed && EVP_DigestFinal_ex(digest, out, &out_size) == 1;
+  EVP_MD_CTX_free(digest);
+  if (!hashed) {
+    return common::Result<bool>("Failed to hash downloaded file: " + path);
+  }
+
+  total_size_ = total;
+  bytes_downloaded_ = total;
+  sha256_hex_ = to_hex(out, out_size);
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.push_back({url, total, 1, 0, 0.0, 0, true});
+  }
+  std::error_code ec;
+  if (!options_.expected_sha256.empty() &&
+      to_lower(options_.expected_sha256) != sha256_hex_) {
+    fs::remove(path, ec);
+    return common::Result<bool>("Snapshot SHA-256 mismatch: expected " +
+                                options_.expected_sha256 + ", got " +
+                                sha256_hex_);
+  }
+  return common::Result<bool>(true);
+}
+
+} // namespace validator
+} // namespace slonana
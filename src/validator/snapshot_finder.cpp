@@ -1,5 +1,6 @@
 #include "validator/snapshot_finder.h"
 #include "network/http_client.h"
+#include "validator/snapshot_downloader.h"
 #include <algorithm>
 #include <chrono>
 #include <cstring>
@@ -817,8 +818,19 @@ common::Result<bool> SnapshotFinder::download_snapshot_from_best_source(
     progress_callback("Finding best snapshot source", 0, 100);
   }
 
-  // Find the best snapshot source
-  auto best_result = find_single_best_snapshot();
+  // Find the best snapshot source; the runners-up serving the same file
+  // become extra download mirrors
+  auto qualities_result = find_best_snapshots();
+  std::vector<SnapshotQuality> qualities;
+  if (qualities_result.is_ok()) {
+    qualities = qualities_result.value();
+  }
+  auto best_result =
+      qualities.empty()
+          ? common::Result<SnapshotQuality>(
+                qualities_result.is_ok() ? std::string("No quality snapshots found")
+                                         : qualities_result.error())
+          : common::Result<SnapshotQuality>(qualities.front());
   if (!best_result.is_ok()) {
     std::cout << "⚠️  No quality snapshots found: " << best_result.error()
               << std::endl;
@@ -1084,14 +1096,26 @@ common::Result<bool> SnapshotFinder::download_snapshot_from_best_source(
       }
     };
 
-    // Perform the download
-    bool success = http_client_->download_file(
-        best_quality.download_url, output_path, download_progress_cb);
+    // Ranged parallel download across the top mirrors, resumable if a
+    // previous attempt was interrupted
+    ParallelSnapshotDownloader::Options download_options;
+    download_options.connections = config_.download_connections;
+    download_options.expected_sha256 = config_.expected_sha256;
+    ParallelSnapshotDownloader downloader(download_options);
+    if (download_consumer_) {
+      downloader.set_data_consumer(download_consumer_);
+    }
+    auto sources = ParallelSnapshotDownloader::select_sources(
+        qualities, config_.max_download_sources);
+    auto download_result =
+        downloader.download(sources, output_path, download_progress_cb);
 
-    if (!success) {
+    if (!download_result.is_ok()) {
       return common::Result<bool>("Download failed from: " +
-                                  best_quality.download_url);
+                                  best_quality.download_url + " (" +
+                                  download_result.error() + ")");
     }
+    std::cout << "🔐 SHA-256: " << downloader.sha256_hex() << std::endl;
   }
 
   if (progress_callback) {
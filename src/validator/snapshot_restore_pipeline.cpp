@@ -0,0 +1,515 @@
+#include "validator/snapshot_restore_pipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <thread>
+
+namespace slonana {
+namespace validator {
+
+using namespace snapshot_archive;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Headers larger than this are treated as garbage rather than allocated
+constexpr uint32_t MAX_STREAM_HEADER_SIZE = 64 * 1024 * 1024;
+
+uint64_t nanoseconds_since(Clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                           start)
+          .count());
+}
+
+double to_seconds(uint64_t nanoseconds) {
+  return static_cast<double>(nanoseconds) / 1e9;
+}
+
+/**
+ * Blocking multi-producer, multi-consumer queue with a fixed capacity
+ *
+ * close() lets consumers drain what is queued; abort() drops it and wakes
+ * everyone.
+ */
+template <typename T> class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [&] {
+      return aborted_ || closed_ || items_.size() < capacity_;
+    });
+    if (aborted_ || closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// @return false once the queue is closed and empty, or aborted
+  bool pop(T &item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock,
+                    [&] { return aborted_ || closed_ || !items_.empty(); });
+    if (aborted_ || items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  void abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = true;
+    items_.clear();
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+private:
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+  std::deque<T> items_;
+  bool closed_ = false;
+  bool aborted_ = false;
+};
+
+struct CompressedChunk {
+  ChunkFrameHeader header;
+  std::vector<uint8_t> payload;
+};
+
+struct RawChunk {
+  ChunkFrameHeader header;
+  std::vector<uint8_t> data; ///< Serialized accounts
+};
+
+struct AccountChunk {
+  ChunkFrameHeader header;
+  std::vector<AccountSnapshot> accounts;
+};
+
+struct StageCounters {
+  std::atomic<uint64_t> chunks{0};
+  std::atomic<uint64_t> busy_ns{0};
+  std::atomic<uint64_t> idle_ns{0};
+  std::atomic<uint64_t> blocked_ns{0};
+
+  SnapshotRestorePipeline::StageStatistics snapshot(size_t threads) const {
+    SnapshotRestorePipeline::StageStatistics stats;
+    stats.threads = threads;
+    stats.chunks = chunks.load();
+    stats.busy_seconds = to_seconds(busy_ns.load());
+    stats.idle_seconds = to_seconds(idle_ns.load());
+    stats.blocked_seconds = to_seconds(blocked_ns.load());
+    return stats;
+  }
+};
+
+size_t resolve_threads(size_t threads, size_t divisor) {
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency() / divisor;
+  }
+  return std::max<size_t>(threads, 1);
+}
+
+} // namespace
+
+struct SnapshotRestorePipeline::Stages {
+  Stages(size_t decompress_depth, size_t deserialize_depth, size_t insert_depth)
+      : compressed(decompress_depth), raw(deserialize_depth),
+        decoded(insert_depth) {}
+
+  BoundedQueue<CompressedChunk> compressed;
+  BoundedQueue<RawChunk> raw;
+  BoundedQueue<AccountChunk> decoded;
+  std::vector<std::thread> threads;
+  std::atomic<size_t> decompress_running{0};
+  std::atomic<size_t> deserialize_running{0};
+
+  StageCounters decompress;
+  StageCounters deserialize;
+  StageCounters insert;
+  std::atomic<uint64_t> source_blocked_ns{0};
+  std::atomic<uint64_t> accounts{0};
+  std::atomic<uint64_t> compressed_bytes{0};
+  std::atomic<uint64_t> uncompressed_bytes{0};
+
+  Clock::time_point started;
+  uint64_t elapsed_ns = 0;
+  bool running = false;
+};
+
+// SnapshotRestorePipeline Implementation
+
+SnapshotRestorePipeline::SnapshotRestorePipeline(Sink sink)
+    : SnapshotRestorePipeline(std::move(sink), Options{}) {}
+
+SnapshotRestorePipeline::SnapshotRestorePipeline(Sink sink,
+                                                 const Options &options)
+    : sink_(std::move(sink)), options_(options) {
+  options_.decompress_threads = resolve_threads(options_.decompress_threads, 2);
+  options_.deserialize_threads =
+      resolve_threads(options_.deserialize_threads, 4);
+  options_.insert_threads = std::max<size_t>(1, options_.insert_threads);
+}
+
+SnapshotRestorePipeline::~SnapshotRestorePipeline() {
+  if (stages_ && stages_->running) {
+    abort();
+  }
+}
+
+void SnapshotRestorePipeline::start() {
+  // Each queue holds enough work to keep the stage it feeds busy
+  auto depth = [this](size_t consumers) {
+    return options_.queue_depth > 0 ? options_.queue_depth : 2 * consumers;
+  };
+  stages_ = std::make_unique<Stages>(depth(options_.decompress_threads),
+                                     depth(options_.deserialize_threads),
+                                     depth(options_.insert_threads));
+  failed_.store(false);
+  error_.clear();
+  stages_->started = Clock::now();
+  stages_->running = true;
+  stages_->decompress_running = options_.decompress_threads;
+  stages_->deserialize_running = options_.deserialize_threads;
+
+  for (size_t i = 0; i < options_.decompress_threads; ++i) {
+    stages_->threads.emplace_back([this] { decompress_loop(); });
+  }
+  for (size_t i = 0; i < options_.deserialize_threads; ++i) {
+    stages_->threads.emplace_back([this] { deserialize_loop(); });
+  }
+  for (size_t i = 0; i < options_.insert_threads; ++i) {
+    stages_->threads.emplace_back([this] { insert_loop(); });
+  }
+}
+
+bool SnapshotRestorePipeline::push_frame(const ChunkFrameHeader &header,
+                                         std::vector<uint8_t> payload) {
+  if (!stages_ || !stages_->running || failed_.load()) {
+    return false;
+  }
+  if (payload.size() != header.compressed_size) {
+    fail("Chunk " + std::to_string(header.chunk_index) +
+         " payload size does not match its header");
+    return false;
+  }
+  auto start = Clock::now();
+  bool queued = stages_->compressed.push({header, std::move(payload)});
+  stages_->source_blocked_ns += nanoseconds_since(start);
+  return queued && !failed_.load();
+}
+
+bool SnapshotRestorePipeline::finish() {
+  if (!stages_ || !stages_->running) {
+    return false;
+  }
+  stages_->compressed.close();
+  for (auto &thread : stages_->threads) {
+    thread.join();
+  }
+  stages_->threads.clear();
+  stages_->running = false;
+  stages_->elapsed_ns = nanoseconds_since(stages_->started);
+  return !failed_.load();
+}
+
+void SnapshotRestorePipeline::abort() {
+  fail("Snapshot restore aborted");
+  finish();
+}
+
+bool SnapshotRestorePipeline::restore_file(const SnapshotArchiveReader &reader) {
+  start();
+  std::vector<uint8_t> frame;
+  for (size_t chunk = 0; chunk < reader.chunks().size(); ++chunk) {
+    if (!reader.read_frame(chunk, frame)) {
+      fail("Failed to read chunk " + std::to_string(chunk));
+      break;
+    }
+    std::vector<uint8_t> payload(frame.begin() + FRAME_HEADER_SIZE,
+                                 frame.end());
+    if (!push_frame(reader.chunks()[chunk].header, std::move(payload))) {
+      break;
+    }
+  }
+  return finish();
+}
+
+std::string SnapshotRestorePipeline::error() const {
+  std::lock_guard<std::mutex> lock(error_mutex_);
+  return error_;
+}
+
+SnapshotRestorePipeline::Statistics
+SnapshotRestorePipeline::statistics() const {
+  Statistics stats;
+  if (!stages_) {
+    return stats;
+  }
+  stats.decompress = stages_->decompress.snapshot(options_.decompress_threads);
+  stats.deserialize =
+      stages_->deserialize.snapshot(options_.deserialize_threads);
+  stats.insert = stages_->insert.snapshot(options_.insert_threads);
+  stats.chunks = stats.insert.chunks;
+  stats.accounts = stages_->accounts.load();
+  stats.compressed_bytes = stages_->compressed_bytes.load();
+  stats.uncompressed_bytes = stages_->uncompressed_bytes.load();
+  stats.source_blocked_seconds = to_seconds(stages_->source_blocked_ns.load());
+  stats.elapsed_seconds =
+      to_seconds(stages_->running ? nanoseconds_since(stages_->started)
+                                  : stages_->elapsed_ns);
+  return stats;
+}
+
+void SnapshotRestorePipeline::fail(const std::string &error) {
+  {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (error_.empty()) {
+      error_ = error;
+    }
+  }
+  failed_.store(true);
+  if (stages_) {
+    stages_->compressed.abort();
+    stages_->raw.abort();
+    stages_->decoded.abort();
+  }
+}
+
+void SnapshotRestorePipeline::decompress_loop() {
+  Stages &stages = *stages_;
+  CompressedChunk chunk;
+  while (true) {
+    auto wait_start = Clock::now();
+    bool have = stages.compressed.pop(chunk);
+    stages.decompress.idle_ns += nanoseconds_since(wait_start);
+    if (!have) {
+      break;
+    }
+
+    auto start = Clock::now();
+    RawChunk raw{chunk.header, {}};
+    bool ok = sha256(chunk.payload.data(), chunk.payload.size()) ==
+              chunk.header.hash;
+    if (ok && chunk.header.codec == SnapshotCodec::NONE) {
+      ok = chunk.payload.size() == chunk.header.uncompressed_size;
+      raw.data = std::move(chunk.payload);
+    } else if (ok) {
+      ok = decompress(chunk.header.codec, chunk.payload.data(),
+                      chunk.payload.size(), chunk.header.uncompressed_size,
+                      raw.data);
+    }
+    stages.decompress.busy_ns += nanoseconds_since(start);
+    if (!ok) {
+      fail("Chunk " + std::to_string(chunk.header.chunk_index) +
+           " failed verification or decompression");
+      break;
+    }
+    stages.compressed_bytes += chunk.header.compressed_size;
+    stages.uncompressed_bytes += chunk.header.uncompressed_size;
+    ++stages.decompress.chunks;
+
+    auto push_start = Clock::now();
+    bool pushed = stages.raw.push(std::move(raw));
+    stages.decompress.blocked_ns += nanoseconds_since(push_start);
+    if (!pushed) {
+      break;
+    }
+  }
+  // The last decompressor out lets the next stage drain
+  if (--stages.decompress_running == 0) {
+    stages.raw.close();
+  }
+}
+
+void SnapshotRestorePipeline::deserialize_loop() {
+  Stages &stages = *stages_;
+  RawChunk raw;
+  while (true) {
+    auto wait_start = Clock::now();
+    bool have = stages.raw.pop(raw);
+    stages.deserialize.idle_ns += nanoseconds_since(wait_start);
+    if (!have) {
+      break;
+    }
+
+    auto start = Clock::now();
+    AccountChunk decoded{raw.header, {}};
+    bool ok = deserialize_accounts(raw.data.data(), raw.data.size(),
+                                   raw.header.account_count, decoded.accounts);
+    stages.deserialize.busy_ns += nanoseconds_since(start);
+    if (!ok) {
+      fail("Chunk " + std::to_string(raw.header.chunk_index) +
+           " holds malformed accounts");
+      break;
+    }
+    ++stages.deserialize.chunks;
+
+    auto push_start = Clock::now();
+    bool pushed = stages.decoded.push(std::move(decoded));
+    stages.deserialize.blocked_ns += nanoseconds_since(push_start);
+    if (!pushed) {
+      break;
+    }
+  }
+  if (--stages.deserialize_running == 0) {
+    stages.decoded.close();
+  }
+}
+
+void SnapshotRestorePipeline::insert_loop() {
+  Stages &stages = *stages_;
+  AccountChunk chunk;
+  while (true) {
+    auto wait_start = Clock::now();
+    bool have = stages.decoded.pop(chunk);
+    stages.insert.idle_ns += nanoseconds_since(wait_start);
+    if (!have) {
+      break;
+    }
+
+    auto start = Clock::now();
+    size_t count = chunk.accounts.size();
+    bool ok = sink_(chunk.header, chunk.accounts);
+    stages.insert.busy_ns += nanoseconds_since(start);
+    if (!ok) {
+      fail("Snapshot sink rejected chunk " +
+           std::to_string(chunk.header.chunk_index));
+      break;
+    }
+    stages.accounts += count;
+    ++stages.insert.chunks;
+  }
+}
+
+// SnapshotFrameStream Implementation
+
+SnapshotFrameStream::SnapshotFrameStream(FrameHandler handler)
+    : handler_(std::move(handler)) {}
+
+bool SnapshotFrameStream::fill(const uint8_t *&data, size_t &size,
+                               size_t want) {
+  size_t take = std::min(size, want - buffer_.size());
+  buffer_.insert(buffer_.end(), data, data + take);
+  data += take;
+  size -= take;
+  return buffer_.size() == want;
+}
+
+bool SnapshotFrameStream::feed(const uint8_t *data, size_t size) {
+  while (true) {
+    switch (state_) {
+    case State::HEADER_SIZE: {
+      if (!fill(data, size, 4)) {
+        return true;
+      }
+      header_size_ = 0;
+      for (size_t i = 0; i < 4; ++i) {
+        header_size_ |= static_cast<uint32_t>(buffer_[i]) << (8 * i);
+      }
+      buffer_.clear();
+      if (header_size_ > MAX_STREAM_HEADER_SIZE) {
+        state_ = State::FAILED;
+        return false;
+      }
+      state_ = State::HEADER;
+      break;
+    }
+    case State::HEADER: {
+      if (!fill(data, size, header_size_)) {
+        return true;
+      }
+      header_ = std::move(buffer_);
+      buffer_.clear();
+      header_done_ = true;
+      state_ = State::MAGIC;
+      break;
+    }
+    case State::MAGIC: {
+      if (!fill(data, size, 8)) {
+        return true;
+      }
+      uint64_t magic = 0;
+      for (size_t i = 0; i < 8; ++i) {
+        magic |= static_cast<uint64_t>(buffer_[i]) << (8 * i);
+      }
+      buffer_.clear();
+      if (magic != ARCHIVE_MAGIC) {
+        state_ = State::FAILED;
+        return false;
+      }
+      state_ = State::FRAME_HEADER;
+      break;
+    }
+    case State::FRAME_HEADER: {
+      // Frames start with FRAME_MAGIC; anything else is the index
+      if (buffer_.size() < 4 && !fill(data, size, 4)) {
+        return true;
+      }
+      uint32_t magic = 0;
+      for (size_t i = 0; i < 4; ++i) {
+        magic |= static_cast<uint32_t>(buffer_[i]) << (8 * i);
+      }
+      if (magic != FRAME_MAGIC) {
+        buffer_.clear();
+        state_ = State::INDEX;
+        break;
+      }
+      if (!fill(data, size, FRAME_HEADER_SIZE)) {
+        return true;
+      }
+      bool valid = frame_.decode(buffer_.data()) &&
+                   frame_.chunk_index == next_chunk_;
+      buffer_.clear();
+      if (!valid) {
+        state_ = State::FAILED;
+        return false;
+      }
+      buffer_.reserve(frame_.compressed_size);
+      state_ = State::PAYLOAD;
+      break;
+    }
+    case State::PAYLOAD: {
+      if (!fill(data, size, frame_.compressed_size)) {
+        return true;
+      }
+      std::vector<uint8_t> payload = std::move(buffer_);
+      buffer_.clear();
+      ++next_chunk_;
+      state_ = State::FRAME_HEADER;
+      if (!handler_(frame_, std::move(payload))) {
+        state_ = State::FAILED;
+        return false;
+      }
+      break;
+    }
+    case State::INDEX:
+      return true; // The index and footer are not needed while streaming
+    case State::FAILED:
+      return false;
+    }
+  }
+}
+
+} // namespace validator
+} // namespace slonana
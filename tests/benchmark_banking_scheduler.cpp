@@ -0,0 +1,161 @@
+#include "banking/prioritization_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace slonana::banking;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+PublicKey account_key(uint64_t index) {
+  PublicKey key(32, 0);
+  for (size_t b = 0; b < 8; ++b) {
+    key[b] = static_cast<uint8_t>(index >> (8 * b));
+  }
+  return key;
+}
+
+/**
+ * A `hot_share` fraction of transactions write one of four hot accounts
+ * (think AMM pools) and pay more; the rest write a random cold account.
+ */
+std::vector<SchedulableTransaction> make_workload(size_t count,
+                                                  double hot_share,
+                                                  std::mt19937_64 &rng) {
+  std::bernoulli_distribution is_hot(hot_share);
+  std::uniform_int_distribution<uint64_t> hot_account(0, 3);
+  std::uniform_int_distribution<uint64_t> cold_account(100, 1000000);
+  std::lognormal_distribution<double> price(8.0, 1.5);
+  std::uniform_int_distribution<uint64_t> units(50000, 300000);
+
+  std::vector<SchedulableTransaction> workload(count);
+  for (auto &tx : workload) {
+    bool hot = is_hot(rng);
+    tx.writable_accounts = {account_key(cold_account(rng) + 1000000),
+                            account_key(hot ? hot_account(rng)
+                                            : cold_account(rng))};
+    tx.readonly_accounts = {account_key(7)}; // A shared program
+    tx.compute_unit_price =
+        static_cast<uint64_t>(price(rng) * (hot ? 4.0 : 1.0));
+    tx.compute_units = units(rng);
+  }
+  return workload;
+}
+
+struct BlockQuality {
+  uint64_t units = 0;
+  uint64_t fees = 0;
+  uint64_t max_account_units = 0; ///< Longest serial chain on one account
+};
+
+/// The previous approach: highest price first until the block is full
+BlockQuality pack_by_price(const std::vector<SchedulableTransaction> &workload,
+                           uint64_t block_limit) {
+  std::vector<const SchedulableTransaction *> order;
+  for (const auto &tx : workload) {
+    order.push_back(&tx);
+  }
+  std::stable_sort(order.begin(), order.end(), [](auto *a, auto *b) {
+    return a->compute_unit_price > b->compute_unit_price;
+  });
+
+  BlockQuality quality;
+  std::unordered_map<PublicKey, uint64_t> per_account;
+  for (const auto *tx : order) {
+    if (quality.units + tx->compute_units > block_limit) {
+      continue;
+    }
+    quality.units += tx->compute_units;
+    quality.fees += tx->priority_fee();
+    for (const auto &account : tx->writable_accounts) {
+      quality.max_account_units = std::max(
+          quality.max_account_units, per_account[account] += tx->compute_units);
+    }
+  }
+  return quality;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+  size_t threads = argc > 2 ? std::stoul(argv[2]) : 4;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Prioritization-Fee Scheduler Benchmark          ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+  std::cout << "  " << count << " transactions, " << threads
+            << " worker threads, 4 hot accounts" << std::endl;
+
+  for (double hot_share : {0.1, 0.5, 0.9}) {
+    std::mt19937_64 rng(42);
+    auto workload = make_workload(count, hot_share, rng);
+
+    PrioritizationFeeScheduler::Config config;
+    config.worker_threads = threads;
+    config.max_pending = count;
+    PrioritizationFeeScheduler scheduler(config);
+
+    auto start = Clock::now();
+    for (const auto &tx : workload) {
+      scheduler.submit(tx);
+    }
+    double submit_seconds = seconds_since(start);
+
+    // Pack blocks until the queue drains; workers finish instantly
+    BlockQuality first_block;
+    std::unordered_map<PublicKey, uint64_t> per_account;
+    size_t blocks = 0;
+    uint64_t scheduled = 0;
+    start = Clock::now();
+    while (scheduler.pending_count() > 0 && blocks < 1000) {
+      auto batches = scheduler.schedule();
+      if (batches.empty()) {
+        ++blocks;
+        scheduler.on_new_block();
+        continue;
+      }
+      for (const auto &batch : batches) {
+        for (const auto &tx : batch.transactions) {
+          if (blocks == 0) {
+            first_block.units += tx.compute_units;
+            first_block.fees += tx.priority_fee();
+            for (const auto &account : tx.writable_accounts) {
+              first_block.max_account_units =
+                  std::max(first_block.max_account_units,
+                           per_account[account] += tx.compute_units);
+            }
+          }
+        }
+        scheduled += batch.transactions.size();
+        scheduler.complete(batch);
+      }
+    }
+    double schedule_seconds = seconds_since(start);
+
+    auto naive = pack_by_price(workload, config.limits.block_units);
+    std::cout << "  hot share " << hot_share * 100 << "%: submit "
+              << static_cast<uint64_t>(count / submit_seconds)
+              << " tx/s, schedule "
+              << static_cast<uint64_t>(scheduled / schedule_seconds)
+              << " tx/s over " << blocks + 1 << " blocks" << std::endl;
+    std::cout << "    first block: " << first_block.units / 1000000.0
+              << "M CU, fees " << first_block.fees
+              << ", busiest account " << first_block.max_account_units / 1000000.0
+              << "M CU  |  price-only: " << naive.units / 1000000.0
+              << "M CU, fees " << naive.fees << ", busiest account "
+              << naive.max_account_units / 1000000.0 << "M CU" << std::endl;
+  }
+  return 0;
+}
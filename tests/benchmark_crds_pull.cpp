@@ -0,0 +1,146 @@
+#include "network/gossip/crds.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace slonana::network::gossip;
+using namespace slonana::common;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// A requester that already holds `known` of the table, split into
+/// 2^mask_bits filters the way Agave builds pull requests
+std::vector<CrdsFilter> build_filters(const Crds &crds, double known,
+                                      uint32_t mask_bits, std::mt19937_64 &rng) {
+  auto labels = crds.get_labels();
+  size_t partitions = size_t{1} << mask_bits;
+  size_t per_filter = labels.size() / partitions + 1;
+  std::vector<CrdsFilter> filters;
+  for (size_t seed = 0; seed < partitions; ++seed) {
+    uint64_t ones = mask_bits >= 64 ? 0 : (~0ULL >> mask_bits);
+    uint64_t mask = mask_bits == 0 ? ~0ULL : ((seed << (64 - mask_bits)) | ones);
+    filters.emplace_back(per_filter, mask, mask_bits);
+  }
+  std::uniform_real_distribution<double> coin(0.0, 1.0);
+  for (const auto &label : labels) {
+    if (coin(rng) >= known) {
+      continue;
+    }
+    auto entry = crds.get(label);
+    const Hash &hash = entry->value.hash();
+    size_t seed = mask_bits == 0 ? 0 : hash_prefix(hash) >> (64 - mask_bits);
+    filters[seed].add(hash);
+  }
+  return filters;
+}
+
+struct Result {
+  double seconds;
+  size_t requests;
+  size_t values;
+};
+
+Result serve(const Crds &crds, const std::vector<CrdsFilter> &filters,
+             size_t threads, size_t requests_per_thread, uint64_t now) {
+  PublicKey requester(32, 0xFF);
+  std::atomic<size_t> values{0};
+  auto start = Clock::now();
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      size_t local = 0;
+      for (size_t i = 0; i < requests_per_thread; ++i) {
+        const auto &filter = filters[(t + i * threads) % filters.size()];
+        local += crds.filter_pull_responses(filter, requester, now, 1024).size();
+      }
+      values.fetch_add(local);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return {seconds, threads * requests_per_thread, values.load()};
+}
+
+void report(const char *name, const Result &result) {
+  std::cout << "  " << name << ": " << result.requests << " requests in "
+            << result.seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(result.requests / result.seconds)
+            << " pull responses/s, "
+            << result.values / std::max<size_t>(result.requests, 1)
+            << " values each)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t table_size = argc > 1 ? std::stoul(argv[1]) : 100000;
+  size_t threads = argc > 2 ? std::stoul(argv[2]) : 4;
+  uint32_t mask_bits = argc > 3 ? std::stoul(argv[3]) : 7;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  CRDS Pull Responder Benchmark                   ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  Crds crds;
+  std::mt19937_64 rng(42);
+  uint64_t now = timestamp();
+  auto start = Clock::now();
+  for (size_t i = 0; i < table_size; ++i) {
+    PublicKey pubkey(32);
+    for (auto &byte : pubkey) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    ContactInfo info(pubkey);
+    info.wallclock = now;
+    crds.insert(CrdsValue(info), now, GossipRoute::PushMessage);
+  }
+  double insert_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << "  Inserted " << crds.len() << " values in "
+            << insert_seconds * 1e3 << " ms" << std::endl;
+
+  // A requester that is mostly caught up: the common steady-state case
+  auto full = build_filters(crds, 0.99, 0, rng);
+  auto masked = build_filters(crds, 0.99, mask_bits, rng);
+
+  report("full-table filter (mask_bits=0)", serve(crds, full, threads, 20, now));
+  std::string name = "masked filters (mask_bits=" + std::to_string(mask_bits) + ")";
+  report(name.c_str(), serve(crds, masked, threads, 2000, now));
+
+  // Requester side: rebuilding one filter from the table every round versus
+  // copying sampled partitions kept current on insert
+  start = Clock::now();
+  size_t rebuilds = 5;
+  for (size_t round = 0; round < rebuilds; ++round) {
+    auto labels = crds.get_labels();
+    CrdsFilter filter(labels.size());
+    for (const auto &label : labels) {
+      filter.add(crds.get(label)->value.hash());
+    }
+  }
+  double rebuild_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count() /
+      rebuilds;
+  crds.build_pull_filters(1); // Settle the partitioning outside the timing
+  start = Clock::now();
+  size_t rounds = 1000;
+  size_t filters = 0;
+  for (size_t round = 0; round < rounds; ++round) {
+    filters += crds.build_pull_filters(8).size();
+  }
+  double sampled_ms =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count() /
+      rounds;
+  std::cout << "  pull request build: full rebuild " << rebuild_ms
+            << " ms/round, " << filters / rounds
+            << " maintained partitions " << sampled_ms << " ms/round"
+            << std::endl;
+  return 0;
+}
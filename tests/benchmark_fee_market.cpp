@@ -0,0 +1,115 @@
+#include "banking/fee_market.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace slonana::banking;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// The previous approach: sort the history for every percentile
+uint64_t sorted_percentile(std::vector<uint64_t> history, double fraction) {
+  std::sort(history.begin(), history.end());
+  return history[static_cast<size_t>(fraction * (history.size() - 1))];
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+  size_t per_thread = argc > 2 ? std::stoul(argv[2]) : 500000;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Fee Market Percentile Benchmark                 ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  FeeMarket market;
+  market.set_max_history_size(10000);
+
+  // Writers record while readers classify: neither side waits on the other
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> classified{0};
+  std::thread reader([&] {
+    uint64_t fee = 1000;
+    while (!stop.load(std::memory_order_relaxed)) {
+      market.classify_fee_tier(fee);
+      fee = fee * 3 % 1000003;
+      classified.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  auto start = Clock::now();
+  std::vector<std::thread> writers;
+  for (size_t t = 0; t < threads; ++t) {
+    writers.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      std::lognormal_distribution<double> fee(9.0, 2.0);
+      for (size_t i = 0; i < per_thread; ++i) {
+        market.record_transaction_fee(static_cast<uint64_t>(fee(rng)), i % 8 != 0);
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  double record_seconds = seconds_since(start);
+  stop = true;
+  reader.join();
+
+  std::cout << "  record: " << threads << " threads, "
+            << static_cast<uint64_t>(threads * per_thread / record_seconds)
+            << " fees/s with " << classified.load()
+            << " concurrent classifications" << std::endl;
+
+  // Classification cost against a 10k-sample history
+  std::mt19937_64 rng(1);
+  std::lognormal_distribution<double> fee(9.0, 2.0);
+  std::vector<uint64_t> history;
+  for (size_t i = 0; i < 10000; ++i) {
+    history.push_back(static_cast<uint64_t>(fee(rng)));
+  }
+
+  FeeMarket filled;
+  for (uint64_t value : history) {
+    filled.record_transaction_fee(value, true);
+  }
+
+  // Re-recording the oldest samples keeps the window's contents unchanged
+  size_t rounds = 2000;
+  uint64_t sink = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    filled.record_transaction_fee(history[i], true);
+    sink += static_cast<uint64_t>(filled.classify_fee_tier(history[i]));
+  }
+  double streaming = seconds_since(start) / rounds;
+
+  start = Clock::now();
+  for (size_t i = 0; i < rounds / 20; ++i) {
+    for (double q : {0.99, 0.90, 0.25}) {
+      sink += sorted_percentile(history, q);
+    }
+  }
+  double sorting = seconds_since(start) / (rounds / 20);
+
+  auto stats = filled.get_recent_fee_stats();
+  std::cout << "  record + classify: " << streaming * 1e6
+            << " us (histogram) vs " << sorting * 1e6
+            << " us (sort per percentile)" << std::endl;
+  std::cout << "  p50 " << stats.median_fee << ", p90 " << stats.p90_fee
+            << ", p99 " << stats.p99_fee << " (exact p99 "
+            << sorted_percentile(history, 0.99) << ")  [" << sink % 2 << "]"
+            << std::endl;
+  return 0;
+}
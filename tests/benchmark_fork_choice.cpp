@@ -0,0 +1,159 @@
+#include "consensus/advanced_fork_choice.h"
+#include "consensus/heaviest_subtree_fork_choice.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace slonana::consensus;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Hash block_hash(Slot slot) {
+  Hash hash(32, 0);
+  for (size_t i = 0; i < 8; ++i) {
+    hash[i] = static_cast<uint8_t>(slot >> (8 * i));
+  }
+  return hash;
+}
+
+PublicKey validator_key(size_t index) {
+  PublicKey key(32, 0);
+  for (size_t i = 0; i < 8; ++i) {
+    key[i] = static_cast<uint8_t>(index >> (8 * i));
+  }
+  return key;
+}
+
+/**
+ * A main chain of `depth` slots with a short side fork branching off every
+ * `fork_every` slots, the shape replay sees under leader contention.
+ */
+struct ForkTree {
+  std::vector<std::pair<Slot, Slot>> blocks; ///< (slot, parent), in order
+  std::vector<Slot> main_chain;
+};
+
+ForkTree build_tree(size_t depth, size_t fork_every) {
+  ForkTree tree;
+  tree.blocks.emplace_back(0, HeaviestSubtreeForkChoice::NO_SLOT);
+  tree.main_chain.push_back(0);
+  Slot next = 1;
+  Slot tip = 0;
+  for (size_t i = 1; i < depth; ++i) {
+    if (i % fork_every == 0) {
+      Slot side = next++;
+      tree.blocks.emplace_back(side, tip);
+      tree.blocks.emplace_back(next++, side);
+    }
+    Slot slot = next++;
+    tree.blocks.emplace_back(slot, tip);
+    tree.main_chain.push_back(slot);
+    tip = slot;
+  }
+  return tree;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t validators = argc > 1 ? std::stoul(argv[1]) : 2000;
+  size_t depth = argc > 2 ? std::stoul(argv[2]) : 4000;
+  size_t rounds = argc > 3 ? std::stoul(argv[3]) : 50;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Heaviest-Subtree Fork Choice Benchmark          ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  ForkTree shape = build_tree(depth, 8);
+  std::cout << "  " << validators << " validators, " << shape.blocks.size()
+            << " blocks (" << depth << "-slot main chain, side fork every 8)"
+            << std::endl;
+
+  // Each round every validator votes for a slot near the tip, lagging by a
+  // few slots and occasionally on a side fork, so votes move both along and
+  // across forks
+  std::mt19937_64 rng(42);
+  std::vector<std::vector<Slot>> vote_slots(rounds);
+  for (size_t r = 0; r < rounds; ++r) {
+    size_t tip = shape.main_chain.size() - rounds + r;
+    vote_slots[r].resize(validators);
+    for (size_t v = 0; v < validators; ++v) {
+      size_t lag = rng() % 32;
+      Slot slot = shape.main_chain[tip - lag];
+      if (rng() % 10 == 0 && slot > 0) {
+        slot -= 1; // Sibling or side-fork slot just before it
+      }
+      vote_slots[r][v] = slot;
+    }
+  }
+  std::vector<PublicKey> keys;
+  for (size_t v = 0; v < validators; ++v) {
+    keys.push_back(validator_key(v));
+  }
+
+  // Bare tree: one O(depth) path update per vote
+  HeaviestSubtreeForkChoice tree;
+  auto start = Clock::now();
+  for (const auto &[slot, parent] : shape.blocks) {
+    tree.add_block(slot, parent);
+  }
+  double insert_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  size_t applied = 0;
+  start = Clock::now();
+  for (size_t r = 0; r < rounds; ++r) {
+    for (size_t v = 0; v < validators; ++v) {
+      applied += tree.add_vote(keys[v], vote_slots[r][v], 1000 + v);
+    }
+  }
+  double vote_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  size_t total_votes = rounds * validators;
+  std::cout << "  HeaviestSubtreeForkChoice: " << shape.blocks.size()
+            << " blocks in " << insert_seconds * 1e3 << " ms, "
+            << total_votes << " votes (" << applied << " applied) in "
+            << vote_seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(total_votes / vote_seconds)
+            << " votes/s), best slot " << tree.best_slot() << std::endl;
+
+  // Full AdvancedForkChoice path: head update and commitment walk per vote,
+  // rooting disabled so the whole tree stays live
+  AdvancedForkChoice::Configuration config;
+  config.total_stake = 0;
+  for (size_t v = 0; v < validators; ++v) {
+    config.total_stake += 1000 + v;
+  }
+  config.enable_aggressive_rooting = false;
+  AdvancedForkChoice fork_choice(config);
+  for (const auto &[slot, parent] : shape.blocks) {
+    fork_choice.add_block(block_hash(slot),
+                          parent == HeaviestSubtreeForkChoice::NO_SLOT
+                              ? Hash(32, 0xFF)
+                              : block_hash(parent),
+                          slot);
+  }
+
+  start = Clock::now();
+  for (size_t r = 0; r < rounds; ++r) {
+    std::vector<VoteInfo> batch;
+    batch.reserve(validators);
+    for (size_t v = 0; v < validators; ++v) {
+      Slot slot = vote_slots[r][v];
+      batch.emplace_back(slot, block_hash(slot), keys[v], 1000 + v);
+    }
+    fork_choice.process_votes_batch(batch);
+  }
+  vote_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  auto stats = fork_choice.get_statistics();
+  std::cout << "  AdvancedForkChoice:        " << total_votes << " votes in "
+            << vote_seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(total_votes / vote_seconds)
+            << " votes/s), head slot " << fork_choice.get_head_slot() << ", "
+            << stats.optimistic_confirmations << " confirmations" << std::endl;
+
+  return tree.best_slot() == shape.main_chain.back() ? 0 : 1;
+}
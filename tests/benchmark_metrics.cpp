@@ -0,0 +1,105 @@
+#include "monitoring/metrics.h"
+#include "monitoring/prometheus_exporter.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace slonana::monitoring;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// The counter this replaces: a double behind a mutex
+class MutexCounter {
+public:
+  void increment() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    value_ += 1.0;
+  }
+
+private:
+  std::mutex mutex_;
+  double value_ = 0.0;
+};
+
+/// Operations per second with `threads` threads each running `op` n times
+double run(size_t threads, uint64_t per_thread,
+           const std::function<void(uint64_t)> &op) {
+  std::vector<std::thread> workers;
+  std::atomic<bool> go{false};
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      while (!go.load(std::memory_order_acquire)) {
+      }
+      for (uint64_t i = 0; i < per_thread; ++i) {
+        op(i);
+      }
+    });
+  }
+  auto start = Clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  return threads * per_thread / seconds_since(start);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t max_threads = argc > 1 ? std::stoul(argv[1]) : 32;
+  uint64_t per_thread = argc > 2 ? std::stoull(argv[2]) : 1000000;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Metrics Hot Path Benchmark                      ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  auto registry = MonitoringFactory::create_registry();
+  auto counter = registry->counter("bench_counter_total", "Benchmark counter");
+  auto histogram =
+      registry->histogram("bench_latency_seconds", "Benchmark histogram");
+  auto labelled = make_counter_vec(*registry, "bench_requests_total",
+                                   "Benchmark labelled counter", "method",
+                                   {"a", "b", "c", "d"});
+  MutexCounter baseline;
+
+  std::cout << "  " << per_thread << " operations per thread, "
+            << metrics_shard_count() << " shards" << std::endl;
+
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    double mutex_rate = run(threads, per_thread,
+                            [&](uint64_t) { baseline.increment(); });
+    double counter_rate =
+        run(threads, per_thread, [&](uint64_t) { counter->increment(); });
+    double labelled_rate = run(threads, per_thread, [&](uint64_t i) {
+      labelled[i & 3].increment();
+    });
+    double histogram_rate = run(threads, per_thread, [&](uint64_t i) {
+      histogram->observe(static_cast<double>(i % 1000) * 1e-4);
+    });
+
+    std::cout << "  " << threads << " thread(s): mutex counter "
+              << static_cast<uint64_t>(mutex_rate) << "/s, sharded counter "
+              << static_cast<uint64_t>(counter_rate) << "/s ("
+              << counter_rate / mutex_rate << "x), labelled "
+              << static_cast<uint64_t>(labelled_rate) << "/s, histogram "
+              << static_cast<uint64_t>(histogram_rate) << "/s" << std::endl;
+  }
+
+  PrometheusExporter exporter;
+  auto start = Clock::now();
+  std::string output = exporter.export_metrics(*registry);
+  std::cout << "  Scrape: " << output.size() << " bytes in "
+            << seconds_since(start) * 1e6 << " us" << std::endl;
+  return 0;
+}
@@ -0,0 +1,205 @@
+#include "network/quic_server.h"
+#include "network/quic_transport.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace slonana::network;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t BATCH = 64;
+constexpr size_t BUFFER = 2048;
+
+/**
+ * Many client connections multiplexed over one UDP socket and driven from
+ * one thread, the way a TPU forwarder talks to a leader.
+ */
+class ClientFleet {
+public:
+  ClientFleet(uint16_t server_port, size_t connections)
+      : storage_(BATCH * BUFFER),
+        send_buffer_(BATCH * quic::MAX_DATAGRAM_SIZE) {
+    fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    int buffer_bytes = 8 * 1024 * 1024;
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &buffer_bytes, sizeof(buffer_bytes));
+    setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &buffer_bytes, sizeof(buffer_bytes));
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &local.sin_addr);
+    bind(fd_, reinterpret_cast<sockaddr *>(&local), sizeof(local));
+    server_.sin_family = AF_INET;
+    server_.sin_port = htons(server_port);
+    inet_pton(AF_INET, "127.0.0.1", &server_.sin_addr);
+    sender_ = std::make_unique<quic::UdpBatchSender>(fd_);
+
+    quic::TransportConfig config;
+    auto now = Clock::now();
+    for (size_t i = 0; i < connections; ++i) {
+      auto connection =
+          quic::Connection::connect(quic::Identity(), config, nullptr, now);
+      routes_[quic::cid_key(connection->local_cid().data())] =
+          connection.get();
+      connections_.push_back(std::move(connection));
+    }
+  }
+
+  ~ClientFleet() { close(fd_); }
+
+  /// One round of receive, timers and transmit for every connection
+  void step(int wait_ms) {
+    pollfd pfd{fd_, POLLIN, 0};
+    poll(&pfd, 1, wait_ms);
+    auto now = Clock::now();
+
+    mmsghdr messages[BATCH];
+    iovec iovs[BATCH];
+    while (true) {
+      for (size_t i = 0; i < BATCH; ++i) {
+        iovs[i].iov_base = storage_.data() + i * BUFFER;
+        iovs[i].iov_len = BUFFER;
+        std::memset(&messages[i], 0, sizeof(mmsghdr));
+        messages[i].msg_hdr.msg_iov = &iovs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+      }
+      int count = recvmmsg(fd_, messages, BATCH, MSG_DONTWAIT, nullptr);
+      if (count <= 0) {
+        break;
+      }
+      for (int i = 0; i < count; ++i) {
+        uint8_t *data = storage_.data() + i * BUFFER;
+        uint64_t key;
+        bool initial;
+        if (!quic::parse_destination_cid(data, messages[i].msg_len, key,
+                                         initial)) {
+          continue;
+        }
+        auto it = routes_.find(key);
+        if (it != routes_.end()) {
+          it->second->receive(data, messages[i].msg_len, now);
+        }
+      }
+    }
+
+    std::vector<quic::OutgoingDatagram> outgoing;
+    outgoing.reserve(BATCH);
+    for (auto &connection : connections_) {
+      if (now >= connection->next_timeout()) {
+        connection->on_timeout(now);
+      }
+      while (true) {
+        if (outgoing.size() == BATCH) {
+          sender_->send(outgoing.data(), outgoing.size());
+          outgoing.clear();
+        }
+        uint8_t *buffer =
+            send_buffer_.data() + outgoing.size() * quic::MAX_DATAGRAM_SIZE;
+        size_t length = connection->send(buffer, quic::MAX_DATAGRAM_SIZE, now);
+        if (length == 0) {
+          break;
+        }
+        outgoing.push_back({buffer, length, server_});
+      }
+    }
+    if (!outgoing.empty()) {
+      sender_->send(outgoing.data(), outgoing.size());
+    }
+  }
+
+  size_t established() const {
+    size_t count = 0;
+    for (const auto &connection : connections_) {
+      count += connection->is_established();
+    }
+    return count;
+  }
+
+  std::vector<std::unique_ptr<quic::Connection>> &connections() {
+    return connections_;
+  }
+
+private:
+  int fd_;
+  sockaddr_in server_{};
+  std::vector<uint8_t> storage_;
+  std::vector<uint8_t> send_buffer_;
+  std::unique_ptr<quic::UdpBatchSender> sender_;
+  std::vector<std::unique_ptr<quic::Connection>> connections_;
+  std::unordered_map<uint64_t, quic::Connection *> routes_;
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t connections = argc > 1 ? std::stoul(argv[1]) : 1000;
+  size_t per_connection = argc > 2 ? std::stoul(argv[2]) : 100;
+  size_t transaction_size = argc > 3 ? std::stoul(argv[3]) : 256;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  QUIC TPU Ingest Benchmark                       ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  std::atomic<size_t> received{0};
+  QuicServer server;
+  server.set_max_sessions(connections + 16);
+  server.set_transaction_sink(
+      [&](std::vector<std::vector<uint8_t>> &&transactions) {
+        received.fetch_add(transactions.size());
+      });
+  if (!server.initialize(0) || !server.start()) {
+    return 1;
+  }
+
+  ClientFleet fleet(server.get_port(), connections);
+
+  auto start = Clock::now();
+  while (fleet.established() < connections &&
+         Clock::now() - start < std::chrono::seconds(30)) {
+    fleet.step(1);
+  }
+  double handshake_seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  std::cout << "  Established " << fleet.established() << "/" << connections
+            << " connections in " << handshake_seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(fleet.established() / handshake_seconds)
+            << " handshakes/s)" << std::endl;
+
+  std::vector<uint8_t> transaction(transaction_size, 0xAB);
+  size_t target = connections * per_connection;
+  start = Clock::now();
+  for (auto &connection : fleet.connections()) {
+    for (size_t i = 0; i < per_connection; ++i) {
+      transaction[0] = static_cast<uint8_t>(i);
+      connection->send_stream(transaction.data(), transaction.size());
+    }
+  }
+  while (received.load() < target &&
+         Clock::now() - start < std::chrono::seconds(60)) {
+    fleet.step(0);
+  }
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  auto stats = server.get_statistics();
+  std::cout << "  Received " << received.load() << "/" << target
+            << " transactions in " << seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(received.load() / seconds) << " tx/s)"
+            << std::endl;
+  std::cout << "  Server: " << stats.active_sessions << " sessions, "
+            << stats.bytes_received / (1024 * 1024) << " MiB in, "
+            << stats.packets_lost << " packets lost, avg RTT "
+            << stats.avg_rtt_ms << " ms" << std::endl;
+
+  server.shutdown();
+  return received.load() == target ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "genesis/manager.h"
+#include "network/gossip/crypto_utils.h"
+#include "validator/replay_stage.h"
+#include <chrono>
+#include <iostream>
+#include <openssl/evp.h>
+#include <random>
+#include <vector>
+
+using namespace slonana::validator;
+using slonana::genesis::GenesisManager;
+using slonana::network::gossip::CryptoUtils;
+namespace ledger = slonana::ledger;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Keypair {
+  std::vector<uint8_t> seed;
+  PublicKey pubkey;
+};
+
+Keypair keypair(size_t index) {
+  Keypair result;
+  result.seed.assign(32, 0);
+  for (size_t i = 0; i < 8; ++i) {
+    result.seed[i] = static_cast<uint8_t>(index >> (8 * i));
+  }
+  result.seed[31] = 0x5a;
+  EVP_PKEY *key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, nullptr,
+                                               result.seed.data(), 32);
+  result.pubkey.resize(32);
+  size_t length = 32;
+  EVP_PKEY_get_raw_public_key(key, result.pubkey.data(), &length);
+  EVP_PKEY_free(key);
+  return result;
+}
+
+ledger::Transaction transfer(const Keypair &from, const PublicKey &to,
+                             uint64_t lamports, uint64_t nonce) {
+  ledger::Transaction transaction;
+  auto &message = transaction.message;
+  message = {1, 0, 1, 3};
+  message.insert(message.end(), from.pubkey.begin(), from.pubkey.end());
+  message.insert(message.end(), to.begin(), to.end());
+  message.insert(message.end(), 32, 0);
+  for (size_t i = 0; i < 32; ++i) {
+    message.push_back(static_cast<uint8_t>(nonce >> (8 * (i % 8))));
+  }
+  message.insert(message.end(), {1, 2, 2, 0, 1, 12, 2, 0, 0, 0});
+  for (size_t i = 0; i < 8; ++i) {
+    message.push_back(static_cast<uint8_t>(lamports >> (8 * i)));
+  }
+  transaction.signatures.push_back(
+      CryptoUtils::sign_ed25519(message, from.seed));
+  return transaction;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t slot_count = argc > 1 ? std::stoul(argv[1]) : 200;
+  size_t per_slot = argc > 2 ? std::stoul(argv[2]) : 256;
+  size_t account_count = argc > 3 ? std::stoul(argv[3]) : 1024;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Replay Stage Catch-up Benchmark                 ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  // Genesis: every payer funded through the genesis tool's account list
+  auto config = GenesisManager::create_network_config(
+      slonana::genesis::NetworkType::DEVNET);
+  std::vector<Keypair> payers;
+  for (size_t i = 0; i < account_count; ++i) {
+    payers.push_back(keypair(i));
+    config.genesis_accounts[payers.back().pubkey] = 1000000000000ULL;
+  }
+  Hash genesis_hash = GenesisManager::compute_genesis_hash(config);
+  auto genesis_accounts = GenesisManager::create_genesis_accounts(config);
+
+  // Synthetic ledger: signed transfers, a tenth of them to one hot account
+  std::mt19937_64 rng(42);
+  PublicKey hot(32, 0xee);
+  std::vector<ReplaySlot> slots;
+  Hash start = genesis_hash;
+  uint64_t nonce = 0;
+  auto build_start = Clock::now();
+  for (Slot slot = 1; slot <= slot_count; ++slot) {
+    ledger::Block block;
+    block.slot = slot;
+    for (size_t i = 0; i < per_slot; ++i) {
+      const auto &from = payers[rng() % payers.size()];
+      const auto &to =
+          rng() % 10 == 0 ? hot : payers[rng() % payers.size()].pubkey;
+      block.transactions.push_back(
+          transfer(from, to == from.pubkey ? hot : to, 1 + rng() % 1000,
+                   nonce++));
+    }
+    slots.push_back(ReplaySlot::from_block(block, slot - 1, start));
+    start = slots.back().last_hash();
+  }
+  std::cout << "  " << slot_count << " slots x " << per_slot
+            << " transfers over " << account_count << " accounts, built in "
+            << std::chrono::duration<double>(Clock::now() - build_start)
+                   .count()
+            << " s" << std::endl;
+
+  Hash reference;
+  for (size_t workers : {1, 2, 4, 8}) {
+    ReplayStage::Config stage_config;
+    stage_config.worker_threads = workers;
+    ReplayStage stage(ReplayBank::genesis(genesis_accounts, genesis_hash),
+                      stage_config);
+
+    auto replay_start = Clock::now();
+    size_t dead = 0;
+    for (const auto &slot : slots) {
+      dead += stage.replay_slot(slot).dead;
+    }
+    double seconds =
+        std::chrono::duration<double>(Clock::now() - replay_start).count();
+
+    auto tip = stage.bank(slot_count);
+    if (dead > 0 || !tip) {
+      std::cerr << "  " << dead << " dead slots" << std::endl;
+      return 1;
+    }
+    if (reference.empty()) {
+      reference = tip->hash();
+    } else if (tip->hash() != reference) {
+      std::cerr << "  Bank hash differs with " << workers << " workers"
+                << std::endl;
+      return 1;
+    }
+    std::cout << "  " << workers << " workers: " << seconds * 1e3
+              << " ms, " << static_cast<uint64_t>(slot_count / seconds)
+              << " slots/s, "
+              << static_cast<uint64_t>(slot_count * per_slot / seconds)
+              << " tx/s, "
+              << stage.get_statistics().lock_waits.load()
+              << " lock-ordered transactions" << std::endl;
+  }
+  return 0;
+}
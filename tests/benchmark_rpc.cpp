@@ -0,0 +1,122 @@
+#include "network/rpc_json.h"
+#include "network/rpc_server.h"
+#include "svm/engine.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t NUM_ACCOUNTS = 4096;
+
+std::vector<std::string>
+populate_accounts(slonana::svm::AccountManager &accounts) {
+  std::mt19937_64 rng(42);
+  std::vector<std::string> addresses;
+  addresses.reserve(NUM_ACCOUNTS);
+
+  for (size_t i = 0; i < NUM_ACCOUNTS; ++i) {
+    slonana::svm::ProgramAccount account;
+    account.pubkey.resize(32);
+    for (auto &byte : account.pubkey) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    account.program_id.assign(32, 0);
+    account.owner.assign(32, 0);
+    account.data.resize(165);
+    for (auto &byte : account.data) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    account.lamports = 1000000 + i;
+    account.executable = false;
+    account.rent_epoch = 200;
+    accounts.create_account(account);
+    addresses.push_back(
+        slonana::network::rpc_json::encode_base58(account.pubkey));
+  }
+  accounts.commit_changes();
+  return addresses;
+}
+
+void benchmark_method(slonana::network::SolanaRpcServer &server,
+                      const std::string &method,
+                      const std::vector<std::string> &addresses,
+                      size_t iterations) {
+  // Pre-build request bodies so only parse/dispatch/serialize is measured
+  std::vector<std::string> requests;
+  requests.reserve(addresses.size());
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    requests.push_back(R"({"jsonrpc":"2.0","id":)" + std::to_string(i) +
+                       R"(,"method":")" + method + R"(","params":[")" +
+                       addresses[i] +
+                       R"(",{"encoding":"base64","commitment":"confirmed"}]})");
+  }
+
+  size_t bytes = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    bytes += server.handle_request(requests[i % requests.size()]).size();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "  " << method << ": " << static_cast<uint64_t>(iterations / seconds)
+            << " req/s (" << (seconds * 1e6 / iterations) << " μs/req, "
+            << bytes / iterations << " bytes/resp)" << std::endl;
+}
+
+void benchmark_batch(slonana::network::SolanaRpcServer &server,
+                     const std::vector<std::string> &addresses,
+                     size_t batch_size, size_t rounds) {
+  std::string batch = "[";
+  for (size_t i = 0; i < batch_size; ++i) {
+    if (i > 0) {
+      batch += ",";
+    }
+    batch += R"({"jsonrpc":"2.0","id":)" + std::to_string(i) +
+             R"(,"method":"getBalance","params":[")" +
+             addresses[i % addresses.size()] + R"("]})";
+  }
+  batch += "]";
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    server.handle_request(batch);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  double seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "  getBalance batch x" << batch_size << ": "
+            << static_cast<uint64_t>(rounds * batch_size / seconds)
+            << " req/s" << std::endl;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  JSON-RPC Request Path Benchmarks                ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  slonana::common::ValidatorConfig config;
+  config.rpc_bind_address = "127.0.0.1:0";
+
+  auto accounts = std::make_shared<slonana::svm::AccountManager>();
+  auto addresses = populate_accounts(*accounts);
+
+  slonana::network::SolanaRpcServer server(config);
+  server.set_account_manager(accounts);
+
+  std::cout << "Accounts: " << addresses.size() << std::endl;
+  benchmark_method(server, "getAccountInfo", addresses, 200000);
+  benchmark_method(server, "getBalance", addresses, 200000);
+  benchmark_batch(server, addresses, 100, 2000);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "All benchmarks completed successfully!" << std::endl;
+  std::cout << std::string(50, '=') << "\n" << std::endl;
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "validator/snapshot_archive.h"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace slonana::validator;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/// Token-account-like: 165 bytes of mostly structured data, pubkey order
+AccountSnapshot make_account(uint64_t index, std::mt19937_64 &rng) {
+  AccountSnapshot account;
+  account.pubkey.assign(32, 0);
+  for (size_t b = 0; b < 8; ++b) {
+    account.pubkey[b] = static_cast<uint8_t>(index >> (8 * (7 - b)));
+  }
+  for (size_t b = 8; b < 32; ++b) {
+    account.pubkey[b] = static_cast<uint8_t>(rng());
+  }
+  account.lamports = 2039280;
+  account.data.assign(165, 0);
+  for (size_t b = 0; b < 72; ++b) {
+    account.data[b] = static_cast<uint8_t>(rng());
+  }
+  account.owner.assign(32, 0x06);
+  account.executable = false;
+  account.rent_epoch = UINT64_MAX;
+  return account;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  size_t account_count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  size_t max_threads = argc > 2 ? std::stoul(argv[2])
+                                : std::max(1u, std::thread::hardware_concurrency());
+  std::string path = (std::filesystem::temp_directory_path() /
+                      "benchmark_snapshot_archive.snapshot")
+                         .string();
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Chunked Snapshot Archive Benchmark              ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  SnapshotCodec codec = snapshot_codec_available(SnapshotCodec::ZSTD)
+                            ? SnapshotCodec::ZSTD
+                            : SnapshotCodec::NONE;
+  std::cout << "  " << account_count << " accounts, codec "
+            << snapshot_codec_name(codec) << ", up to " << max_threads
+            << " threads" << std::endl;
+
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    SnapshotArchiveWriter::Options options;
+    options.codec = codec;
+    options.threads = threads;
+    SnapshotArchiveWriter writer(options);
+    if (!writer.open(path, {})) {
+      return 1;
+    }
+    std::mt19937_64 rng(1);
+    auto start = Clock::now();
+    for (uint64_t i = 0; i < account_count; ++i) {
+      writer.add(make_account(i, rng));
+    }
+    if (!writer.finish()) {
+      return 1;
+    }
+    double write_seconds = seconds_since(start);
+
+    SnapshotArchiveReader reader;
+    if (!reader.open(path)) {
+      return 1;
+    }
+    std::atomic<uint64_t> restored{0};
+    start = Clock::now();
+    bool ok = reader.for_each_chunk(
+        [&](const ChunkIndexEntry &, std::vector<AccountSnapshot> &accounts) {
+          restored.fetch_add(accounts.size(), std::memory_order_relaxed);
+          return true;
+        },
+        threads);
+    double read_seconds = seconds_since(start);
+    if (!ok || restored.load() != account_count) {
+      return 1;
+    }
+
+    std::cout << "  " << threads << " thread(s): write " << write_seconds * 1e3
+              << " ms ("
+              << static_cast<uint64_t>(account_count / write_seconds)
+              << " accounts/s, " << writer.bytes_written() / (1024 * 1024)
+              << " MiB from " << writer.uncompressed_bytes() / (1024 * 1024)
+              << " MiB), restore " << read_seconds * 1e3 << " ms ("
+              << static_cast<uint64_t>(account_count / read_seconds)
+              << " accounts/s)" << std::endl;
+  }
+
+  std::filesystem::remove(path);
+  return 0;
+}
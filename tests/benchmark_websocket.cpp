@@ -0,0 +1,214 @@
+#include "network/websocket_server.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace slonana::network;
+
+namespace {
+
+constexpr int PORT = 28900;
+constexpr const char *HOT_ACCOUNT = "HotAccount1111111111111111111111111111111111";
+
+struct Client {
+  int fd = -1;
+  std::string buffer;
+};
+
+bool blocking_read_until(Client &client, const std::string &marker) {
+  char chunk[4096];
+  while (client.buffer.find(marker) == std::string::npos) {
+    ssize_t received = recv(client.fd, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      return false;
+    }
+    client.buffer.append(chunk, static_cast<size_t>(received));
+  }
+  return true;
+}
+
+bool open_client(Client &client) {
+  client.fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(PORT);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (connect(client.fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+      0) {
+    return false;
+  }
+  std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n"
+                        "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                        "Sec-WebSocket-Version: 13\r\n\r\n";
+  send(client.fd, request.data(), request.size(), MSG_NOSIGNAL);
+  if (!blocking_read_until(client, "\r\n\r\n")) {
+    return false;
+  }
+  client.buffer.erase(0, client.buffer.find("\r\n\r\n") + 4);
+  return true;
+}
+
+void send_masked_text(int fd, const std::string &payload) {
+  std::string frame;
+  frame.push_back(static_cast<char>(0x81));
+  frame.push_back(static_cast<char>(0x80 | payload.size())); // < 126 bytes
+  frame.append("\0\0\0\0", 4);                                // zero mask
+  frame += payload;
+  send(fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+}
+
+// Count complete frames in the buffer and drop them
+size_t consume_frames(std::string &buffer) {
+  size_t frames = 0;
+  size_t pos = 0;
+  while (buffer.size() - pos >= 2) {
+    size_t length = static_cast<uint8_t>(buffer[pos + 1]) & 0x7F;
+    size_t header = 2;
+    if (length == 126) {
+      if (buffer.size() - pos < 4) {
+        break;
+      }
+      length = (static_cast<uint8_t>(buffer[pos + 2]) << 8) |
+               static_cast<uint8_t>(buffer[pos + 3]);
+      header = 4;
+    }
+    if (buffer.size() - pos < header + length) {
+      break;
+    }
+    pos += header + length;
+    ++frames;
+  }
+  buffer.erase(0, pos);
+  return frames;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  // 10k subscribers spread over 1k sockets keeps both ends of every
+  // connection within the default descriptor limit of one process
+  size_t connections = argc > 1 ? std::stoul(argv[1]) : 1000;
+  size_t subscribers = argc > 2 ? std::stoul(argv[2]) : 10000;
+  size_t notifications = argc > 3 ? std::stoul(argv[3]) : 200;
+
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  WebSocket Notification Fan-out Benchmark        ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  WebSocketServerConfig config;
+  config.max_queued_messages = notifications * subscribers / connections + 16;
+  config.max_queued_bytes = 256 * 1024 * 1024;
+  WebSocketServer server("127.0.0.1", PORT, config);
+  if (!server.start()) {
+    return 1;
+  }
+
+  std::vector<Client> clients(connections);
+  for (auto &client : clients) {
+    if (!open_client(client)) {
+      std::cerr << "Failed to open client connection" << std::endl;
+      return 1;
+    }
+  }
+
+  std::string subscribe = std::string(R"({"jsonrpc":"2.0","id":1,)") +
+                          R"("method":"accountSubscribe","params":[")" +
+                          HOT_ACCOUNT + "\"]}";
+  for (size_t i = 0; i < subscribers; ++i) {
+    send_masked_text(clients[i % connections].fd, subscribe);
+  }
+  // Drain confirmations
+  std::vector<size_t> expected(connections, 0);
+  for (size_t i = 0; i < subscribers; ++i) {
+    ++expected[i % connections];
+  }
+  for (size_t i = 0; i < connections; ++i) {
+    size_t confirmed = 0;
+    char chunk[4096];
+    while ((confirmed += consume_frames(clients[i].buffer)) < expected[i]) {
+      ssize_t received = recv(clients[i].fd, chunk, sizeof(chunk), 0);
+      if (received <= 0) {
+        return 1;
+      }
+      clients[i].buffer.append(chunk, static_cast<size_t>(received));
+    }
+  }
+  std::cout << "Connections: " << connections << ", subscribers on one account: "
+            << server.account_subscriber_count(HOT_ACCOUNT) << std::endl;
+
+  // Reader drains every client socket and counts delivered notifications
+  std::atomic<size_t> delivered{0};
+  size_t target = notifications * subscribers;
+  int epfd = epoll_create1(0);
+  for (size_t i = 0; i < connections; ++i) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = i;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, clients[i].fd, &event);
+  }
+  std::thread reader([&] {
+    epoll_event events[256];
+    char chunk[65536];
+    while (delivered.load() < target) {
+      int ready = epoll_wait(epfd, events, 256, 1000);
+      if (ready <= 0) {
+        break;
+      }
+      for (int i = 0; i < ready; ++i) {
+        auto &client = clients[events[i].data.u64];
+        ssize_t received = recv(client.fd, chunk, sizeof(chunk), 0);
+        if (received > 0) {
+          client.buffer.append(chunk, static_cast<size_t>(received));
+          delivered.fetch_add(consume_frames(client.buffer));
+        }
+      }
+    }
+  });
+
+  std::string account_data =
+      R"({"context":{"slot":1},"value":{"data":["AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA","base64"],"executable":false,"lamports":1000000,"owner":"11111111111111111111111111111111","rentEpoch":0,"space":32}})";
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < notifications; ++i) {
+    server.notify_account_change(HOT_ACCOUNT, account_data);
+  }
+  auto published = std::chrono::high_resolution_clock::now();
+  reader.join();
+  auto end = std::chrono::high_resolution_clock::now();
+
+  double publish_seconds =
+      std::chrono::duration<double>(published - start).count();
+  double total_seconds = std::chrono::duration<double>(end - start).count();
+  std::cout << "  Published " << notifications << " account changes in "
+            << publish_seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(notifications * subscribers /
+                                     publish_seconds)
+            << " enqueued notifications/s)" << std::endl;
+  std::cout << "  Delivered " << delivered.load() << "/" << target << " in "
+            << total_seconds * 1e3 << " ms ("
+            << static_cast<uint64_t>(delivered.load() / total_seconds)
+            << " notifications/s)" << std::endl;
+  std::cout << "  Slow consumer evictions: "
+            << server.get_stats().slow_consumer_evictions << std::endl;
+
+  ::close(epfd);
+  for (auto &client : clients) {
+    ::close(client.fd);
+  }
+  server.stop();
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "All benchmarks completed successfully!" << std::endl;
+  std::cout << std::string(50, '=') << "\n" << std::endl;
+  return delivered.load() == target ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "network/gossip/weighted_shuffle.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace slonana::network::gossip;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// The previous implementation: re-sums the remaining stake for every
+/// output position, O(n^2) per shuffle
+std::vector<size_t> quadratic_shuffle(const std::vector<uint64_t> &weights,
+                                      uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<size_t> indices(weights.size());
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = i;
+  }
+  for (size_t i = 0; i + 1 < indices.size(); ++i) {
+    uint64_t total_stake = 0;
+    for (size_t j = i; j < indices.size(); ++j) {
+      total_stake += weights[indices[j]];
+    }
+    if (total_stake == 0) {
+      break;
+    }
+    uint64_t rand_val = rng() % total_stake;
+    uint64_t cumulative = 0;
+    for (size_t j = i; j < indices.size(); ++j) {
+      cumulative += weights[indices[j]];
+      if (cumulative > rand_val) {
+        std::swap(indices[i], indices[j]);
+        break;
+      }
+    }
+  }
+  return indices;
+}
+
+template <typename F> double time_us(size_t iterations, F &&body) {
+  auto start = Clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    body(i);
+  }
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+             .count() /
+         iterations;
+}
+
+} // namespace
+
+int main() {
+  std::cout << "\n╔══════════════════════════════════════════════════╗" << std::endl;
+  std::cout << "║  Stake-Weighted Shuffle Benchmark                ║" << std::endl;
+  std::cout << "╚══════════════════════════════════════════════════╝\n" << std::endl;
+
+  std::mt19937_64 rng(7);
+  // Mainnet-like skew: a few large stakes, a long tail, some unstaked
+  std::lognormal_distribution<double> stake(20.0, 2.0);
+
+  for (size_t n : {1000, 5000, 20000}) {
+    std::vector<uint64_t> weights(n);
+    for (auto &weight : weights) {
+      weight = rng() % 20 == 0 ? 0 : static_cast<uint64_t>(stake(rng));
+    }
+
+    size_t old_iterations = n >= 20000 ? 3 : (n >= 5000 ? 20 : 200);
+    size_t sink = 0;
+    double old_us = time_us(old_iterations, [&](size_t i) {
+      sink += quadratic_shuffle(weights, i)[0];
+    });
+
+    WeightedShuffle shuffle(weights);
+    double full_us = time_us(200, [&](size_t i) {
+      shuffle.reseed(i);
+      sink += shuffle.shuffle_indices()[0];
+    });
+    // Turbine and push rotation only look at the first few nodes
+    double first_k_us = time_us(2000, [&](size_t i) {
+      shuffle.reseed(i);
+      for (size_t k = 0; k < 200; ++k) {
+        sink += shuffle.next_index();
+      }
+    });
+
+    std::cout << "  n=" << n << ": quadratic " << old_us
+              << " us/shuffle, fenwick " << full_us << " us/shuffle ("
+              << old_us / full_us << "x), first 200 " << first_k_us << " us"
+              << std::endl;
+    if (sink == 42) {
+      std::cout << std::endl;
+    }
+  }
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include "banking/banking_stage.h"
+#include "consensus/leader_schedule.h"
 #include "consensus/proof_of_history.h"
 #include "ledger/manager.h"
 #include "network/quic_client.h"
@@ -32,6 +33,7 @@ public:
     all_passed &= test_banking_stage_parallel_processing();
     all_passed &= test_banking_stage_resource_monitoring();
     all_passed &= test_validator_core_integration();
+    all_passed &= test_quic_stakes_follow_epochs();
     all_passed &= test_end_to_end_workflow();
 
     if (all_passed) {
@@ -286,6 +288,74 @@ private:
     return true;
   }
 
+  bool test_quic_stakes_follow_epochs() {
+    std::cout << "Testing QUIC stream quotas across an epoch boundary..."
+              << std::endl;
+
+    consensus::GlobalProofOfHistory::initialize();
+
+    auto ledger =
+        std::make_shared<ledger::LedgerManager>("quic_stakes_test_ledger");
+    // A repeated-byte identity passes the block validator's test path
+    common::PublicKey identity(32, 0x01);
+    validator::ValidatorCore core(ledger, identity);
+
+    // Epoch 0 stakes validator A, epoch 1 moves all stake to validator B
+    common::PublicKey staked_a(32, 0xA1), staked_b(32, 0xB2);
+    const uint64_t slots_per_epoch = 4;
+    core.set_leader_schedule(std::make_shared<consensus::LeaderScheduleCache>(
+        [&](common::Epoch epoch) {
+          auto stakes = std::make_shared<staking::EpochStakes>();
+          stakes->epoch = epoch;
+          stakes->validators = {epoch == 0 ? staked_a : staked_b};
+          stakes->validator_stakes = {1000};
+          stakes->total_stake = 1000;
+          return std::shared_ptr<const staking::EpochStakes>(stakes);
+        },
+        slots_per_epoch));
+
+    auto start_result = core.start();
+    if (!start_result.is_ok()) {
+      std::cout << "Failed to start validator core: " << start_result.error()
+                << std::endl;
+      return false;
+    }
+
+    auto *quic_server = core.get_quic_server();
+    network::quic::Key32 key_a, key_b;
+    std::copy(staked_a.begin(), staked_a.end(), key_a.begin());
+    std::copy(staked_b.begin(), staked_b.end(), key_b.begin());
+    uint64_t unstaked = quic_server->stream_quota(network::quic::Key32{});
+
+    // Enabling QUIC loads the current epoch's stakes
+    assert(core.enable_quic_networking(8005));
+    assert(quic_server->stream_quota(key_a) ==
+           network::QuicServer::MAX_STAKED_STREAMS);
+    assert(quic_server->stream_quota(key_b) == unstaked);
+
+    // Crossing into epoch 1 swaps the quotas
+    for (uint64_t slot = 0; slot <= slots_per_epoch; ++slot) {
+      ledger::Block block;
+      block.slot = slot;
+      block.block_hash.resize(32, static_cast<uint8_t>(slot + 1));
+      block.parent_hash.resize(32, static_cast<uint8_t>(slot));
+      block.validator = identity;
+      block.block_signature.resize(64, 0xAA);
+      core.process_block(block);
+    }
+    assert(ledger->get_latest_slot() == slots_per_epoch);
+    assert(quic_server->stream_quota(key_a) == unstaked);
+    assert(quic_server->stream_quota(key_b) ==
+           network::QuicServer::MAX_STAKED_STREAMS);
+
+    core.stop();
+    core.disable_quic_networking();
+    consensus::GlobalProofOfHistory::shutdown();
+
+    std::cout << "✅ QUIC stake refresh test passed" << std::endl;
+    return true;
+  }
+
   bool test_end_to_end_workflow() {
     std::cout << "Testing end-to-end workflow..." << std::endl;
 
@@ -1,8 +1,9 @@
 #include "banking/banking_stage.h"
 #include <cassert>
+#include <chrono>
+#include <filesystem>
 #include <iostream>
 #include <thread>
-#include <chrono>
 
 namespace slonana {
 namespace test {
@@ -18,6 +19,7 @@ public:
     all_passed &= test_fee_market_integration();
     all_passed &= test_mev_protection_integration();
     all_passed &= test_combined_integration();
+    all_passed &= test_scheduled_batches_complete_after_commit();
     all_passed &= test_statistics();
 
     if (all_passed) {
@@ -111,6 +113,46 @@ private:
     return true;
   }
 
+  bool test_scheduled_batches_complete_after_commit() {
+    std::cout << "Testing scheduler locks are held until commit..." << std::endl;
+
+    auto ledger_path = std::filesystem::temp_directory_path() /
+                       "slonana_banking_schedule_test";
+    std::filesystem::remove_all(ledger_path);
+    auto ledger = std::make_shared<ledger::LedgerManager>(ledger_path.string());
+
+    BankingStage banking;
+    banking.set_ledger_manager(ledger);
+    assert(banking.initialize());
+    assert(banking.start());
+    banking.enable_fee_market(true);
+
+    for (int i = 0; i < 5; ++i) {
+      auto tx = std::make_shared<ledger::Transaction>();
+      tx->signatures.push_back(std::vector<uint8_t>(64, i + 1));
+      tx->message.resize(100, i + 1);
+      banking.submit_transaction(tx);
+    }
+
+    // Each scheduled transaction is completed once, after its batch commits
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    auto stats = banking.get_scheduler_stats();
+    while (stats.completed < 5 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      stats = banking.get_scheduler_stats();
+    }
+    banking.stop();
+
+    assert(stats.scheduled == 5);
+    assert(stats.completed == 5);
+    assert(stats.retried == 0);
+    assert(ledger->get_latest_slot() > 0);
+    std::filesystem::remove_all(ledger_path);
+
+    std::cout << "✅ Scheduler completion test passed" << std::endl;
+    return true;
+  }
+
   bool test_statistics() {
     std::cout << "Testing integrated statistics..." << std::endl;
 
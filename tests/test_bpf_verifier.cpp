@@ -0,0 +1,259 @@
+#include "svm/bpf_verifier.h"
+#include <cassert>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+
+using namespace slonana::svm;
+
+namespace {
+
+struct Insn {
+  uint8_t opcode;
+  uint8_t dst = 0;
+  uint8_t src = 0;
+  int16_t offset = 0;
+  int32_t imm = 0;
+};
+
+std::vector<uint8_t> assemble(std::initializer_list<Insn> insns) {
+  std::vector<uint8_t> code;
+  for (const auto &insn : insns) {
+    auto offset = static_cast<uint16_t>(insn.offset);
+    auto imm = static_cast<uint32_t>(insn.imm);
+    code.insert(code.end(),
+                {insn.opcode, static_cast<uint8_t>(insn.dst | (insn.src << 4)),
+                 static_cast<uint8_t>(offset), static_cast<uint8_t>(offset >> 8),
+                 static_cast<uint8_t>(imm), static_cast<uint8_t>(imm >> 8),
+                 static_cast<uint8_t>(imm >> 16),
+                 static_cast<uint8_t>(imm >> 24)});
+  }
+  return code;
+}
+
+constexpr uint8_t MOV64_IMM = 0xb7;
+constexpr uint8_t MOV64_REG = 0xbf;
+constexpr uint8_t ADD64_IMM = 0x07;
+constexpr uint8_t DIV64_IMM = 0x37;
+constexpr uint8_t LSH64_IMM = 0x67;
+constexpr uint8_t LDDW = 0x18;
+constexpr uint8_t LDXDW = 0x79;
+constexpr uint8_t STXDW = 0x7b;
+constexpr uint8_t STW = 0x62;
+constexpr uint8_t JA = 0x05;
+constexpr uint8_t JEQ_IMM = 0x15;
+constexpr uint8_t JGT_REG = 0x2d;
+constexpr uint8_t CALL = 0x85;
+constexpr uint8_t EXIT = 0x95;
+
+std::string rejection(const std::vector<uint8_t> &code) {
+  BpfVerifier verifier;
+  assert(!verifier.verify_program(code));
+  return verifier.get_last_error();
+}
+
+} // namespace
+
+bool test_decode_and_cfg() {
+  std::cout << "Testing verifier decoding and CFG..." << std::endl;
+
+  // r0 = 0; r1 = 100; loop: r0 += 1; if r1 > r0 goto loop; exit
+  auto code = assemble({{MOV64_IMM, 0, 0, 0, 0},
+                        {MOV64_IMM, 1, 0, 0, 100},
+                        {ADD64_IMM, 0, 0, 0, 1},
+                        {JGT_REG, 1, 0, -2, 0},
+                        {EXIT}});
+  BpfVerifier verifier;
+  auto program = verifier.verify_program(code);
+  assert(program);
+  assert(program->ops.size() == 5);
+  assert(program->ops[1].dst_reg == 1 && program->ops[1].immediate == 100);
+  assert(program->ops[3].offset == -2);
+  assert(program->has_loops);
+
+  // Blocks: [0,2) -> [2,4) -> {[2,4), [4,5)}
+  assert(program->blocks.size() == 3);
+  assert(program->blocks[1].start == 2 && program->blocks[1].end == 4);
+  assert(program->blocks[0].successors == std::vector<size_t>{1});
+  assert((program->blocks[1].successors == std::vector<size_t>{1, 2}));
+  assert(program->blocks[2].successors.empty());
+
+  // LDDW spans two slots, calls do not end a block
+  auto wide = assemble({{LDDW, 2, 0, 0, 0x10},
+                        {0, 0, 0, 0, 0x3},
+                        {CALL, 0, 0, 0, 7},
+                        {EXIT}});
+  program = verifier.verify_program(wide);
+  assert(program);
+  assert(program->blocks.size() == 1);
+  assert(!program->has_loops);
+
+  // Stack usage follows pointers derived from r10
+  auto stack = assemble({{MOV64_REG, 2, 10, 0, 0},
+                         {ADD64_IMM, 2, 0, 0, -64},
+                         {STXDW, 2, 1, 8, 0},
+                         {LDXDW, 0, 10, -8, 0},
+                         {EXIT}});
+  program = verifier.verify_program(stack);
+  assert(program);
+  assert(program->stack_usage == 56);
+
+  std::cout << "✅ Verifier decoding and CFG test passed" << std::endl;
+  return true;
+}
+
+bool test_rejections() {
+  std::cout << "Testing verifier rejections..." << std::endl;
+
+  assert(rejection({}) == "Program code is empty");
+  assert(rejection({0xb7, 0x00}).find("multiple of 8") != std::string::npos);
+  assert(rejection(assemble({{0xff}})).find("Unknown opcode") == 0);
+  assert(rejection(assemble({{MOV64_IMM, 10, 0, 0, 1}, {EXIT}}))
+             .find("frame pointer") != std::string::npos);
+  assert(rejection(assemble({{DIV64_IMM, 0, 0, 0, 0}, {EXIT}})) ==
+         "Division by zero at instruction 0");
+  assert(rejection(assemble({{LSH64_IMM, 0, 0, 0, 64}, {EXIT}}))
+             .find("Shift") == 0);
+  assert(rejection(assemble({{JA, 0, 0, 5, 0}, {EXIT}})).find("Jump out") ==
+         0);
+  assert(rejection(assemble({{EXIT}, {LDDW, 1, 0, 0, 1}}))
+             .find("LDDW cannot be the last") == 0);
+  assert(rejection(assemble({{JA, 0, 0, 1, 0},
+                             {LDDW, 1, 0, 0, 1},
+                             {0, 0, 0, 0, 0},
+                             {EXIT}}))
+             .find("middle of LDDW") != std::string::npos);
+
+  // Stack bounds through r10 and through a derived pointer
+  assert(rejection(assemble({{STXDW, 10, 1, 8, 0}, {EXIT}}))
+             .find("Stack access out of bounds") == 0);
+  assert(rejection(assemble({{MOV64_REG, 2, 10, 0, 0},
+                             {ADD64_IMM, 2, 0, 0, -600},
+                             {STW, 2, 0, 0, 1},
+                             {EXIT}}))
+             .find("Stack access out of bounds at instruction 2") == 0);
+
+  // Stack pointers that differ across branches meet at the join
+  BpfVerifier verifier;
+  auto joined = verifier.verify_program(assemble({{MOV64_REG, 2, 10, 0, 0},
+                                                  {ADD64_IMM, 2, 0, 0, -8},
+                                                  {JEQ_IMM, 1, 0, 1, 0},
+                                                  {ADD64_IMM, 2, 0, 0, -8},
+                                                  {STW, 2, 0, 0, 1},
+                                                  {EXIT}}));
+  assert(joined);
+  assert(joined->blocks.size() == 3);
+
+  // A loop with no way out is rejected unless loops are allowed
+  auto spin = assemble({{MOV64_IMM, 0, 0, 0, 0}, {JA, 0, 0, -1, 0}, {EXIT}});
+  assert(rejection(spin).find("Infinite loop") == 0);
+  verifier.set_allow_infinite_loops(true);
+  assert(verifier.verify_program(spin));
+
+  std::cout << "✅ Verifier rejections test passed" << std::endl;
+  return true;
+}
+
+bool test_internal_calls() {
+  std::cout << "Testing internal calls..." << std::endl;
+
+  // call +1 enters the function at 2, which gets a frame of its own
+  BpfVerifier verifier;
+  auto program = verifier.verify_program(assemble({{CALL, 0, 1, 0, 1},
+                                                   {EXIT},
+                                                   {STXDW, 10, 1, -8, 0},
+                                                   {EXIT}}));
+  assert(program);
+  assert(program->blocks.size() == 2);
+  assert(program->blocks[0].callees == std::vector<size_t>{1});
+  assert(program->stack_usage == 8);
+
+  // Targets must lie inside the code
+  assert(rejection(assemble({{CALL, 0, 1, 0, 1000}, {EXIT}})) ==
+         "Call out of code: target 1001 at instruction 0");
+  assert(rejection(assemble({{CALL, 0, 1, 0, -2}, {EXIT}}))
+             .find("Call out of code") == 0);
+
+  // Callee code is checked like the entry function
+  assert(rejection(assemble({{CALL, 0, 1, 0, 1},
+                             {EXIT},
+                             {STXDW, 10, 1, -4096, 0},
+                             {EXIT}})) ==
+         "Stack access out of bounds at instruction 2: offset -4096");
+  assert(rejection(assemble({{CALL, 0, 1, 0, 1},
+                             {EXIT},
+                             {MOV64_IMM, 0, 0, 0, 0},
+                             {JA, 0, 0, -1, 0},
+                             {EXIT}}))
+             .find("Infinite loop") == 0);
+
+  // Recursion is bounded by call depth at runtime, not a loop
+  program = verifier.verify_program(assemble({{JEQ_IMM, 1, 0, 1, 0},
+                                              {CALL, 0, 1, 0, -2},
+                                              {EXIT}}));
+  assert(program);
+  assert(!program->has_loops);
+
+  std::cout << "✅ Internal calls test passed" << std::endl;
+  return true;
+}
+
+bool test_verification_cache() {
+  std::cout << "Testing verification result cache..." << std::endl;
+
+  BpfVerifier::clear_cache();
+  auto code = assemble({{MOV64_IMM, 0, 0, 0, 42}, {EXIT}});
+
+  BpfVerifier first;
+  auto verified = first.verify_cached(code);
+  assert(verified);
+  assert(BpfVerifier::cached_results() == 1);
+
+  // A later load of the same bytecode reuses the result
+  BpfVerifier second;
+  assert(second.verify_cached(code) == verified);
+  BpfProgram program;
+  program.code = code;
+  assert(second.verify(program));
+  assert(BpfVerifier::cached_results() == 1);
+
+  // Different options are verified separately
+  BpfVerifier strict;
+  strict.set_max_instructions(1);
+  assert(!strict.verify_cached(code));
+  assert(strict.get_last_error().find("Too many instructions") == 0);
+  assert(BpfVerifier::cached_results() == 2);
+
+  // Rejections are cached with their reason
+  BpfVerifier again;
+  again.set_max_instructions(1);
+  assert(!again.verify_cached(code));
+  assert(again.get_last_error() == strict.get_last_error());
+  assert(BpfVerifier::cached_results() == 2);
+
+  BpfVerifier::clear_cache();
+  assert(BpfVerifier::cached_results() == 0);
+
+  std::cout << "✅ Verification result cache test passed" << std::endl;
+  return true;
+}
+
+int main() {
+  std::cout << "=== BPF Verifier Test Suite ===" << std::endl;
+
+  try {
+    assert(test_decode_and_cfg());
+    assert(test_rejections());
+    assert(test_internal_calls());
+    assert(test_verification_cache());
+
+    std::cout << "\n🎉 All BPF verifier tests passed!" << std::endl;
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "❌ Test failed with unknown exception" << std::endl;
+    return 1;
+  }
+}
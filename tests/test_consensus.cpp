@@ -1,4 +1,5 @@
 #include "staking/manager.h"
+#include "storage/accounts_db.h"
 #include "svm/engine.h"
 #include "test_framework.h"
 #include <memory>
@@ -199,6 +200,37 @@ void test_account_balance_operations() {
   ASSERT_EQ(3000000, new_balance);
 }
 
+void test_account_commit_listener() {
+  auto account_manager = std::make_unique<slonana::svm::AccountManager>();
+  std::vector<slonana::svm::ProgramAccount> committed;
+  size_t commits = 0;
+  account_manager->set_commit_listener(
+      [&](const std::vector<slonana::svm::ProgramAccount> &accounts) {
+        committed = accounts;
+        ++commits;
+      });
+
+  slonana::svm::ProgramAccount account;
+  account.pubkey.resize(32, 0x02);
+  account.program_id.resize(32, 0x00);
+  account.lamports = 5000;
+  account.executable = false;
+  account.owner.resize(32, 0x00);
+  account_manager->create_account(account);
+
+  // Only commits are reported, with the accounts they wrote
+  account_manager->rollback_changes();
+  ASSERT_TRUE(account_manager->commit_changes().is_ok());
+  ASSERT_EQ(0, commits);
+
+  account_manager->create_account(account);
+  ASSERT_TRUE(account_manager->commit_changes().is_ok());
+  ASSERT_EQ(1, commits);
+  ASSERT_EQ(1, committed.size());
+  ASSERT_EQ(account.pubkey, committed[0].pubkey);
+  ASSERT_EQ(5000, committed[0].lamports);
+}
+
 void test_account_data_operations() {
   auto account_manager = std::make_unique<slonana::svm::AccountManager>();
 
@@ -526,6 +558,114 @@ void test_vote_account_management() {
   ASSERT_TRUE(result.is_ok());
 }
 
+namespace {
+
+slonana::common::PublicKey numbered_key(uint8_t tag, uint32_t n) {
+  slonana::common::PublicKey key(32, tag);
+  for (int i = 0; i < 4; ++i) {
+    key[1 + i] = static_cast<uint8_t>(n >> (8 * i));
+  }
+  return key;
+}
+
+void add_delegation(slonana::staking::StakingManager &staking, uint32_t n,
+                    const slonana::common::PublicKey &validator,
+                    uint64_t lamports) {
+  slonana::staking::StakeAccount stake_account;
+  stake_account.stake_pubkey = numbered_key(0x5A, n);
+  stake_account.delegator_pubkey = numbered_key(0x5B, n);
+  stake_account.validator_pubkey = validator;
+  stake_account.stake_amount = lamports;
+  stake_account.is_active = true;
+  ASSERT_TRUE(staking.create_stake_account(stake_account).is_ok());
+}
+
+} // namespace
+
+void test_epoch_stakes_cache() {
+  auto staking = std::make_unique<slonana::staking::StakingManager>();
+
+  slonana::common::PublicKey small(32, 0x11), large(32, 0x12), tiny(32, 0x13);
+  uint32_t n = 0;
+  for (int i = 0; i < 10; ++i) {
+    add_delegation(*staking, n++, small, 1000);
+  }
+  for (int i = 0; i < 5; ++i) {
+    add_delegation(*staking, n++, large, 3000);
+  }
+  add_delegation(*staking, n++, tiny, 500);
+  add_delegation(*staking, n, tiny, 700);
+  staking->deactivate_stake(numbered_key(0x5A, n++));
+
+  auto stakes = staking->get_epoch_stakes(5);
+  ASSERT_EQ(25500, stakes->total_stake);
+  ASSERT_EQ(3, stakes->validators.size());
+  ASSERT_EQ(large, stakes->validators[0]); // Largest stake first
+  ASSERT_EQ(10000, stakes->stake_of(small));
+  ASSERT_EQ(0, stakes->stake_of(slonana::common::PublicKey(32, 0x14)));
+
+  // Stake-weighted lookup over the running totals
+  ASSERT_EQ(0, stakes->validator_at(0));
+  ASSERT_EQ(0, stakes->validator_at(14999));
+  ASSERT_EQ(1, stakes->validator_at(15000));
+  ASSERT_EQ(2, stakes->validator_at(25499));
+
+  // Delegations are grouped per validator
+  ASSERT_EQ(10, stakes->delegation_offsets[2] - stakes->delegation_offsets[1]);
+  for (size_t d = stakes->delegation_offsets[1];
+       d < stakes->delegation_offsets[2]; ++d) {
+    ASSERT_EQ(1000, stakes->delegations[d].stake);
+  }
+
+  // Frozen once built: later delegations only show up in later epochs
+  add_delegation(*staking, n++, tiny, 9000);
+  ASSERT_EQ(stakes.get(), staking->get_epoch_stakes(5).get());
+  ASSERT_EQ(34500, staking->get_epoch_stakes(6)->total_stake);
+}
+
+void test_partitioned_epoch_rewards() {
+  auto staking = std::make_unique<slonana::staking::StakingManager>();
+  auto accounts_db = std::make_shared<slonana::storage::AccountsDB>();
+  staking->set_accounts_db(accounts_db);
+  staking->set_slots_per_epoch(32);
+  staking->set_reward_threads(4);
+
+  slonana::common::PublicKey validator(32, 0x21);
+  ASSERT_TRUE(staking->register_validator(validator, 500).is_ok());
+  const uint32_t accounts = 4500; // Two partitions
+  for (uint32_t i = 0; i < accounts; ++i) {
+    add_delegation(*staking, i, validator, 1000000000ULL + i);
+  }
+
+  uint64_t expected = 0;
+  for (const auto &[delegator, reward] : staking->calculate_pending_rewards(0)) {
+    expected += reward;
+  }
+  uint64_t stake_before = staking->get_total_stake();
+
+  ASSERT_TRUE(staking->distribute_epoch_rewards(0).is_ok());
+  ASSERT_EQ(2, staking->get_pending_reward_partitions());
+
+  // Paid from the first slots of epoch 1, one partition per slot
+  ASSERT_EQ(0, staking->credit_epoch_rewards(32));
+  size_t first = staking->credit_epoch_rewards(33);
+  ASSERT_GT(first, 0);
+  ASSERT_LE(first, slonana::staking::StakingManager::REWARDS_PER_PARTITION);
+  size_t second = staking->credit_epoch_rewards(34);
+  ASSERT_EQ(accounts + 1, first + second); // Plus the validator's commission
+  ASSERT_EQ(0, staking->get_pending_reward_partitions());
+
+  // Rewards compound into the delegations and land in the accounts store
+  ASSERT_EQ(stake_before + expected, staking->get_total_stake());
+  auto stake_key = numbered_key(0x5A, 7);
+  auto stored = accounts_db->load_account(stake_key);
+  ASSERT_TRUE(stored.has_value());
+  ASSERT_EQ(staking->get_stake_account(stake_key)->stake_amount -
+                (1000000000ULL + 7),
+            stored->lamports);
+  ASSERT_TRUE(accounts_db->load_account(validator).has_value());
+}
+
 void run_consensus_tests(TestRunner &runner) {
   std::cout << "\n=== Consensus Tests ===" << std::endl;
 
@@ -549,6 +689,7 @@ void run_consensus_tests(TestRunner &runner) {
   runner.run_test("Multiple Account Creation", test_multiple_account_creation);
   runner.run_test("Account Balance Operations",
                   test_account_balance_operations);
+  runner.run_test("Account Commit Listener", test_account_commit_listener);
   runner.run_test("Account Data Operations", test_account_data_operations);
   runner.run_test("Instruction Execution", test_instruction_execution);
   runner.run_test("Account Changes Commit", test_account_changes_commit);
@@ -572,4 +713,6 @@ void run_consensus_tests(TestRunner &runner) {
   runner.run_test("Reward Distribution Mechanisms",
                   test_reward_distribution_mechanisms);
   runner.run_test("Vote Account Management", test_vote_account_management);
+  runner.run_test("Epoch Stakes Cache", test_epoch_stakes_cache);
+  runner.run_test("Partitioned Epoch Rewards", test_partitioned_epoch_rewards);
 }
\ No newline at end of file
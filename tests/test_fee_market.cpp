@@ -1,6 +1,8 @@
 #include "banking/fee_market.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <random>
 #include <thread>
 #include <chrono>
 
@@ -25,6 +27,10 @@ public:
     all_passed &= test_adaptive_fees();
     all_passed &= test_history_size_limits();
     all_passed &= test_concurrent_access();
+    all_passed &= test_streaming_percentiles();
+    all_passed &= test_window_eviction();
+    all_passed &= test_slot_window();
+    all_passed &= test_prioritization_fee_cache();
 
     if (all_passed) {
       std::cout << "✅ All Fee Market tests passed!" << std::endl;
@@ -287,6 +293,164 @@ private:
     std::cout << "✅ Concurrent access test passed" << std::endl;
     return true;
   }
+
+  bool test_streaming_percentiles() {
+    std::cout << "Testing streaming percentile accuracy..." << std::endl;
+
+    // Bucket edges tile the u64 range
+    assert(FeeHistogram::bucket_index(0) == 0);
+    assert(FeeHistogram::bucket_index(UINT64_MAX) == FeeHistogram::BUCKETS - 1);
+    for (size_t i = 0; i + 1 < FeeHistogram::BUCKETS; ++i) {
+      assert(FeeHistogram::bucket_upper(i) + 1 == FeeHistogram::bucket_lower(i + 1));
+      assert(FeeHistogram::bucket_index(FeeHistogram::bucket_lower(i)) == i);
+      assert(FeeHistogram::bucket_index(FeeHistogram::bucket_upper(i)) == i);
+    }
+
+    // Heavy-tailed fees: each percentile within one bucket (1/16) of exact
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> fee(9.0, 2.0);
+    FeeHistogram histogram;
+    std::vector<uint64_t> fees;
+    for (int i = 0; i < 50000; ++i) {
+      fees.push_back(static_cast<uint64_t>(fee(rng)));
+      histogram.record(fees.back());
+    }
+    std::sort(fees.begin(), fees.end());
+    for (double q : {0.25, 0.5, 0.9, 0.99}) {
+      uint64_t exact = fees[static_cast<size_t>(q * (fees.size() - 1))];
+      uint64_t estimate = histogram.quantile(q);
+      assert(estimate >= exact);
+      assert(estimate - exact <= exact / 16 + 1);
+    }
+    assert(histogram.min() == fees.front());
+    assert(histogram.max() == fees.back());
+
+    // Removing everything leaves an empty histogram
+    for (uint64_t value : fees) {
+      histogram.remove(value);
+    }
+    assert(histogram.count() == 0);
+    assert(histogram.quantile(0.5) == 0);
+
+    std::cout << "✅ Streaming percentile test passed" << std::endl;
+    return true;
+  }
+
+  bool test_window_eviction() {
+    std::cout << "Testing sliding fee window..." << std::endl;
+
+    FeeMarket market;
+    market.set_max_history_size(100);
+
+    // 100 cheap excluded fees, then 100 expensive included ones push them out
+    for (int i = 0; i < 100; ++i) {
+      market.record_transaction_fee(1000, false);
+    }
+    assert(market.get_inclusion_rate() == 0.0);
+    assert(market.classify_fee_tier(1000) == FeeTier::URGENT);
+    for (int i = 0; i < 100; ++i) {
+      market.record_transaction_fee(50000, true);
+    }
+
+    FeeStats stats = market.get_recent_fee_stats();
+    assert(stats.sample_count == 100);
+    assert(stats.min_fee == 50000 && stats.max_fee == 50000);
+    assert(market.get_inclusion_rate() == 1.0);
+    assert(market.classify_fee_tier(1000) == FeeTier::LOW);
+
+    // Growing the window keeps the samples already tracked
+    market.set_max_history_size(1000);
+    assert(market.get_tracked_fee_count() == 100);
+    market.record_transaction_fee(1000, true);
+    assert(market.get_tracked_fee_count() == 101);
+    assert(market.get_recent_fee_stats().min_fee == 1000);
+
+    std::cout << "✅ Sliding fee window test passed" << std::endl;
+    return true;
+  }
+
+  bool test_slot_window() {
+    std::cout << "Testing slot-based fee window..." << std::endl;
+
+    FeeMarket market;
+    market.set_history_slots(2);
+    assert(market.get_history_slots() == 2);
+
+    // Slot 10: cheap excluded fees; slot 11: fees with the top bit set
+    market.advance_slot(10);
+    for (int i = 0; i < 10; ++i) {
+      market.record_transaction_fee(1000, false);
+    }
+    market.advance_slot(11);
+    const uint64_t huge_fee = (uint64_t(1) << 63) + 12345;
+    for (int i = 0; i < 10; ++i) {
+      market.record_transaction_fee(huge_fee, true);
+    }
+    assert(market.get_tracked_fee_count() == 20);
+    assert(market.get_inclusion_rate() == 0.5);
+    assert(market.get_recent_fee_stats().max_fee == huge_fee);
+
+    // Slot 12 leaves only slot 11 in a two-slot window
+    market.advance_slot(12);
+    FeeStats stats = market.get_recent_fee_stats();
+    assert(stats.sample_count == 10);
+    assert(stats.min_fee == huge_fee && stats.max_fee == huge_fee);
+    assert(market.get_inclusion_rate() == 1.0);
+
+    // Stale slots are ignored; resizing keeps the slot of each sample
+    market.advance_slot(5);
+    market.set_max_history_size(500);
+    assert(market.get_tracked_fee_count() == 10);
+    market.advance_slot(13);
+    assert(market.get_tracked_fee_count() == 0);
+    assert(market.classify_fee_tier(market.get_current_base_fee()) ==
+           FeeTier::NORMAL);
+
+    std::cout << "✅ Slot-based fee window test passed" << std::endl;
+    return true;
+  }
+
+  bool test_prioritization_fee_cache() {
+    std::cout << "Testing per-slot and per-account prioritization fees..."
+              << std::endl;
+
+    PrioritizationFeeCache cache(4);
+    common::PublicKey pool(32, 0xAA);
+    common::PublicKey other(32, 0xBB);
+    common::PublicKey quiet(32, 0xCC);
+
+    cache.update(10, 500, {pool});
+    cache.update(10, 20, {other});
+    cache.update(10, 800, {pool, other});
+    cache.update(11, 5, {other});
+
+    auto global = cache.get_recent_fees();
+    assert(global.size() == 2);
+    assert(global[0].slot == 10 && global[0].prioritization_fee == 20);
+    assert(global[1].slot == 11 && global[1].prioritization_fee == 5);
+
+    // Local fee market of the pool: the cheapest write to it in each slot
+    auto local = cache.get_recent_fees({pool});
+    assert(local[0].prioritization_fee == 500);
+    assert(local[1].prioritization_fee == 5); // Not written in slot 11
+    assert(cache.get_recent_fees({quiet, other})[0].prioritization_fee == 20);
+
+    // Slots older than the window drop out, late updates are ignored
+    cache.update(14, 1, {});
+    cache.update(10, 1, {pool});
+    auto recent = cache.get_recent_fees();
+    assert(recent.size() == 2);
+    assert(recent[0].slot == 11 && recent[1].slot == 14);
+
+    // The RPC path: FeeMarket forwards to its cache
+    FeeMarket market;
+    market.record_prioritization_fee(3, 42, {pool});
+    auto fees = market.get_recent_prioritization_fees({pool});
+    assert(fees.size() == 1 && fees[0].prioritization_fee == 42);
+
+    std::cout << "✅ Prioritization fee cache test passed" << std::endl;
+    return true;
+  }
 };
 
 } // namespace test
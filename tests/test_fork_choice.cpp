@@ -0,0 +1,241 @@
+#include "consensus/advanced_fork_choice.h"
+#include "consensus/heaviest_subtree_fork_choice.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+using namespace slonana::consensus;
+
+namespace {
+
+PublicKey validator(uint8_t id) { return PublicKey(32, id); }
+
+Hash block_hash(Slot slot) {
+  Hash hash(32, 0);
+  for (size_t i = 0; i < 8; ++i) {
+    hash[i] = static_cast<uint8_t>(slot >> (8 * i));
+  }
+  return hash;
+}
+
+} // namespace
+
+bool test_heaviest_subtree_basic() {
+  std::cout << "Testing heaviest subtree selection..." << std::endl;
+
+  // 0 -> {1, 2}, 1 -> {3, 4}
+  HeaviestSubtreeForkChoice tree;
+  assert(tree.empty());
+  assert(tree.add_block(0, HeaviestSubtreeForkChoice::NO_SLOT));
+  assert(tree.add_block(1, 0));
+  assert(tree.add_block(2, 0));
+  assert(tree.add_block(3, 1));
+  assert(tree.add_block(4, 1));
+  assert(tree.size() == 5);
+  assert(!tree.add_block(4, 1)); // Duplicate
+  assert(!tree.add_block(9, 7)); // Unknown parent
+  assert(!tree.add_block(1, 2)); // Not after its parent
+
+  // No votes: ties go to the lowest slot
+  assert(tree.best_slot() == 3);
+
+  assert(tree.add_vote(validator(1), 2, 100));
+  assert(tree.best_slot() == 2);
+  assert(tree.stake_voted_subtree(0) == 100);
+
+  assert(tree.add_vote(validator(2), 4, 60));
+  assert(tree.add_vote(validator(3), 3, 50));
+  assert(tree.stake_voted_subtree(1) == 110);
+  assert(tree.best_slot() == 4);
+  assert(tree.best_slot(2) == 2);
+
+  // Equal subtrees pick the lower slot
+  assert(tree.add_vote(validator(4), 3, 10));
+  assert(tree.best_slot() == 3);
+
+  std::cout << "✅ Heaviest subtree selection test passed" << std::endl;
+  return true;
+}
+
+bool test_heaviest_subtree_vote_moves() {
+  std::cout << "Testing vote switching and pending votes..." << std::endl;
+
+  HeaviestSubtreeForkChoice tree;
+  assert(tree.add_block(10, HeaviestSubtreeForkChoice::NO_SLOT));
+  assert(tree.add_block(11, 10));
+  assert(tree.add_block(12, 10));
+
+  assert(tree.add_vote(validator(1), 11, 70));
+  assert(tree.add_vote(validator(2), 12, 30));
+  assert(tree.best_slot() == 11);
+
+  // An older vote never replaces a newer one
+  assert(!tree.add_vote(validator(1), 10, 70));
+  assert(tree.latest_vote(validator(1)) == 11);
+
+  // Switching forks moves the stake off the old path
+  assert(tree.add_vote(validator(1), 12, 70));
+  assert(tree.stake_voted_subtree(11) == 0);
+  assert(tree.stake_voted_subtree(12) == 100);
+  assert(tree.stake_voted_at(12) == 100);
+  assert(tree.stake_voted_subtree(10) == 100);
+  assert(tree.best_slot() == 12);
+
+  // A vote ahead of its block counts once the block arrives
+  assert(tree.add_vote(validator(3), 13, 500));
+  assert(tree.stake_voted_subtree(10) == 100);
+  assert(tree.add_block(13, 11));
+  assert(tree.stake_voted_subtree(11) == 500);
+  assert(tree.best_slot() == 13);
+
+  std::cout << "✅ Vote switching test passed" << std::endl;
+  return true;
+}
+
+bool test_heaviest_subtree_set_root() {
+  std::cout << "Testing root pruning and ancestry..." << std::endl;
+
+  HeaviestSubtreeForkChoice tree;
+  assert(tree.add_block(0, HeaviestSubtreeForkChoice::NO_SLOT));
+  assert(tree.add_block(1, 0));
+  assert(tree.add_block(2, 0));
+  assert(tree.add_block(3, 1));
+  assert(tree.add_block(5, 3));
+  assert(tree.add_block(4, 2));
+
+  assert(tree.is_ancestor(0, 5));
+  assert(tree.is_ancestor(1, 5));
+  assert(!tree.is_ancestor(2, 5));
+  assert(!tree.is_ancestor(5, 1));
+
+  assert(tree.add_vote(validator(1), 4, 80));
+  assert(tree.add_vote(validator(2), 5, 20));
+  assert(tree.best_slot() == 4);
+
+  // 0 is finalized with 1; the 2 -> 4 fork is abandoned
+  std::vector<Slot> abandoned = tree.set_root(1);
+  assert((abandoned == std::vector<Slot>{2, 4}));
+  assert(tree.root() == 1);
+  assert(!tree.contains(0));
+  assert(!tree.contains(2));
+  assert(!tree.contains(4));
+  assert(tree.contains(5));
+  assert(tree.size() == 3);
+  assert(tree.parent(1) == HeaviestSubtreeForkChoice::NO_SLOT);
+  assert(tree.stake_voted_subtree(1) == 20);
+  assert(tree.best_slot() == 5);
+
+  // The validator whose fork was pruned can vote again on the new root's fork
+  assert(tree.add_vote(validator(1), 5, 80));
+  assert(tree.stake_voted_subtree(1) == 100);
+
+  std::cout << "✅ Root pruning test passed" << std::endl;
+  return true;
+}
+
+bool test_advanced_fork_choice() {
+  std::cout << "Testing AdvancedForkChoice on the heaviest subtree..."
+            << std::endl;
+
+  AdvancedForkChoice::Configuration config;
+  config.total_stake = 1000;
+  AdvancedForkChoice fork_choice(config);
+
+  using CommitmentEvent = AdvancedForkChoice::CommitmentEvent;
+  std::vector<std::pair<Slot, CommitmentEvent>> events;
+  fork_choice.set_commitment_callback(
+      [&](Slot slot, CommitmentEvent event) { events.emplace_back(slot, event); });
+
+  fork_choice.add_block(block_hash(0), Hash(32, 0xFF), 0);
+  fork_choice.add_block(block_hash(1), block_hash(0), 1);
+  fork_choice.add_block(block_hash(2), block_hash(0), 2);
+  fork_choice.add_block(block_hash(3), block_hash(1), 3);
+
+  assert(fork_choice.get_root_slot() == 0);
+  assert(fork_choice.is_ancestor(block_hash(0), block_hash(3)));
+  assert(!fork_choice.is_ancestor(block_hash(2), block_hash(3)));
+
+  fork_choice.add_vote(VoteInfo(2, block_hash(2), validator(1), 300));
+  assert(fork_choice.get_head() == block_hash(2));
+  fork_choice.add_vote(VoteInfo(3, block_hash(3), validator(2), 400));
+  assert(fork_choice.get_head() == block_hash(3));
+  assert(fork_choice.get_stake_weight(block_hash(1)) == 400);
+  assert(!fork_choice.is_optimistically_confirmed(block_hash(1)));
+
+  // Moving 300 stake onto slot 3 crosses the 67% threshold for its fork and
+  // roots it, pruning slot 2
+  fork_choice.add_vote(VoteInfo(3, block_hash(3), validator(1), 300));
+  assert(fork_choice.get_stake_weight(block_hash(3)) == 700);
+  assert(fork_choice.is_optimistically_confirmed(block_hash(3)));
+  assert(fork_choice.is_optimistically_confirmed(block_hash(1)));
+  assert(fork_choice.get_root_slot() == 3);
+  assert(fork_choice.get_stake_weight(block_hash(2)) == 0);
+
+  bool confirmed = false, rooted = false, dead_before_root = false;
+  for (const auto &[slot, event] : events) {
+    confirmed |= slot == 3 && event == CommitmentEvent::CONFIRMED;
+    rooted |= slot == 3 && event == CommitmentEvent::ROOTED;
+    dead_before_root |= slot == 2 && event == CommitmentEvent::DEAD && !rooted;
+    assert(!(event == CommitmentEvent::DEAD && slot != 2));
+  }
+  assert(confirmed && rooted && dead_before_root);
+
+  std::cout << "✅ AdvancedForkChoice test passed" << std::endl;
+  return true;
+}
+
+bool test_vote_before_block() {
+  std::cout << "Testing votes that arrive before their block..." << std::endl;
+
+  AdvancedForkChoice::Configuration config;
+  config.total_stake = 1000;
+  AdvancedForkChoice fork_choice(config);
+
+  fork_choice.add_block(block_hash(0), Hash(32, 0xFF), 0);
+  fork_choice.add_block(block_hash(1), block_hash(0), 1);
+
+  // Slot 2's vote comes first; it counts once the block lands
+  fork_choice.add_vote(VoteInfo(2, block_hash(2), validator(1), 300));
+  assert(fork_choice.get_head() == block_hash(1));
+  fork_choice.add_block(block_hash(2), block_hash(1), 2);
+  assert(fork_choice.get_stake_weight(block_hash(2)) == 300);
+  assert(fork_choice.get_head() == block_hash(2));
+
+  // A vote for one block is not credited to another block at its slot
+  Hash other(32, 0xEE);
+  fork_choice.add_vote(VoteInfo(3, other, validator(2), 400));
+  fork_choice.add_block(block_hash(3), block_hash(1), 3);
+  assert(fork_choice.get_stake_weight(block_hash(3)) == 0);
+  assert(fork_choice.get_head() == block_hash(2));
+
+  // Early supermajority confirms and roots as soon as the block arrives
+  fork_choice.add_vote(VoteInfo(4, block_hash(4), validator(3), 700));
+  fork_choice.add_block(block_hash(4), block_hash(2), 4);
+  assert(fork_choice.get_stake_weight(block_hash(4)) == 700);
+  assert(fork_choice.is_optimistically_confirmed(block_hash(4)));
+  assert(fork_choice.get_root_slot() == 4);
+
+  std::cout << "✅ Vote before block test passed" << std::endl;
+  return true;
+}
+
+int main() {
+  std::cout << "=== Fork Choice Test Suite ===" << std::endl;
+
+  try {
+    assert(test_heaviest_subtree_basic());
+    assert(test_heaviest_subtree_vote_moves());
+    assert(test_heaviest_subtree_set_root());
+    assert(test_advanced_fork_choice());
+    assert(test_vote_before_block());
+
+    std::cout << "\n🎉 All fork choice tests passed!" << std::endl;
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "❌ Test failed with unknown exception" << std::endl;
+    return 1;
+  }
+}
@@ -7,9 +7,17 @@
 #include "network/gossip/gossip_service.h"
 #include "network/gossip/crds.h"
 #include "network/gossip/protocol.h"
+#include "network/gossip/weighted_shuffle.h"
+#include <arpa/inet.h>
 #include <iostream>
+#include <netinet/in.h>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <sys/socket.h>
 #include <thread>
 #include <chrono>
+#include <unistd.h>
 
 using namespace slonana::network::gossip;
 using namespace slonana::common;
@@ -120,6 +128,217 @@ void test_bloom_filter() {
     std::cout << "Contains hash3: " << (filter.contains(hash3) ? "NO (expected)" : "YES (false positive)") << "\n";
 }
 
+void test_crds_pull_responder() {
+    std::cout << "\n=== Testing CRDS Pull Responder ===\n";
+
+    auto check = [](bool condition, const char* what) {
+        if (!condition) throw std::runtime_error(what);
+    };
+
+    Crds crds;
+    std::mt19937_64 rng(7);
+    uint64_t now = timestamp();
+    std::vector<PublicKey> keys;
+    for (int i = 0; i < 2000; ++i) {
+        PublicKey pk(32);
+        for (auto& byte : pk) byte = static_cast<uint8_t>(rng());
+        keys.push_back(pk);
+        ContactInfo ci(pk);
+        ci.wallclock = now;
+        crds.insert(CrdsValue(ci), now, GossipRoute::PushMessage);
+    }
+    check(crds.len() == 2000 && crds.num_nodes() == 2000, "insert count");
+
+    // Every value lands in exactly one of the 2^3 mask partitions
+    const PublicKey& requester = keys[0];
+    std::set<Hash> seen;
+    for (uint64_t seed = 0; seed < 8; ++seed) {
+        uint64_t mask = (seed << 61) | (~0ULL >> 3);
+        CrdsFilter filter(64, mask, 3);
+        for (const auto& entry : crds.filter_pull_responses(filter, requester, now, 1 << 20)) {
+            check(filter.test_mask(entry->value.hash()), "value outside partition");
+            check(entry->value.pubkey() != requester, "requester's own value returned");
+            check(seen.insert(entry->value.hash()).second, "value returned twice");
+        }
+    }
+    check(seen.size() == 1999, "partitions do not cover the table");
+    std::cout << "Mask partitions cover " << seen.size() << " values\n";
+
+    // Values the requester already has are not sent back
+    CrdsFilter full(4000);
+    for (size_t i = 1; i < 1001; ++i) {
+        auto entry = crds.get(CrdsValueLabel(CrdsValueLabel::Type::ContactInfo, keys[i]));
+        full.add(entry->value.hash());
+    }
+    auto missing = crds.filter_pull_responses(full, requester, now, 1 << 20);
+    check(missing.size() >= 900 && missing.size() <= 999, "bloom filter not applied");
+    check(crds.filter_pull_responses(full, requester, now, 10).size() == 10, "max_values ignored");
+    check(crds.filter_pull_responses(full, requester, now - 1, 1 << 20).empty(), "wallclock limit ignored");
+    std::cout << "Filtered response: " << missing.size() << " values\n";
+
+    // Readers keep the version they hold across an update
+    auto label = CrdsValueLabel(CrdsValueLabel::Type::ContactInfo, keys[5]);
+    auto before = crds.get(label);
+    ContactInfo newer(keys[5]);
+    newer.wallclock = now + 1000;
+    check(crds.insert(CrdsValue(newer), now, GossipRoute::PushMessage).is_ok(), "update rejected");
+    check(before->value.wallclock() == now, "snapshot changed under reader");
+    check(crds.get(label)->value.wallclock() == now + 1000, "update not visible");
+    check(crds.len() == 2000, "update changed the count");
+
+    // Shard index agrees with a brute-force scan of the mask
+    CrdsShards shards(16);
+    std::vector<VersionedCrdsValue> versioned;
+    for (size_t i = 0; i < 500; ++i) {
+        ContactInfo ci(keys[i]);
+        ci.wallclock = i;
+        versioned.emplace_back(CrdsValue(ci), i, now);
+    }
+    for (size_t i = 0; i < versioned.size(); ++i) shards.insert(i, &versioned[i]);
+    for (uint32_t bits : {0u, 2u, 4u, 7u}) {
+        uint64_t mask = (bits ? (rng() & ~(~0ULL >> bits)) : 0) | (bits >= 64 ? 0 : ~0ULL >> bits);
+        CrdsFilter filter(1, mask, bits);
+        size_t expected = 0;
+        for (const auto& v : versioned) expected += filter.test_mask(v.value.hash());
+        size_t found = 0;
+        shards.find(mask, bits, [&](size_t, const VersionedCrdsValue*) { ++found; });
+        check(found == expected, "shard index disagrees with mask");
+    }
+
+    // Trim drops everything older than the timeout
+    check(crds.trim(now + 100, 10) == 2000 && crds.len() == 0, "trim");
+    std::cout << "Pull responder checks passed\n";
+}
+
+void test_crds_filter_set() {
+    std::cout << "\n=== Testing Pull Filter Partitions ===\n";
+
+    auto check = [](bool condition, const char* what) {
+        if (!condition) throw std::runtime_error(what);
+    };
+
+    Crds ours;
+    Crds theirs;
+    std::mt19937_64 rng(11);
+    uint64_t now = timestamp();
+    std::vector<PublicKey> keys;
+    for (int i = 0; i < 5000; ++i) {
+        PublicKey pk(32);
+        for (auto& byte : pk) byte = static_cast<uint8_t>(rng());
+        keys.push_back(pk);
+        ContactInfo ci(pk);
+        ci.wallclock = now;
+        ours.insert(CrdsValue(ci), now, GossipRoute::PushMessage);
+        theirs.insert(CrdsValue(ci), now, GossipRoute::PushMessage);
+    }
+
+    // Partitions split the table so each filter fits in a packet
+    auto filters = ours.build_pull_filters(1 << 20);
+    uint32_t mask_bits = CrdsFilterSet::mask_bits_for(5000);
+    check(filters.size() == (size_t{1} << mask_bits), "partition count");
+    std::set<uint64_t> masks;
+    for (const auto& filter : filters) {
+        check(filter.mask_bits() == mask_bits, "filter mask bits");
+        check(filter.num_bits() / 8 < PULL_RESPONSE_MAX_PAYLOAD_SIZE, "filter exceeds packet");
+        masks.insert(filter.mask());
+    }
+    check(masks.size() == filters.size(), "duplicate partitions");
+    check(ours.build_pull_filters(3).size() == 3, "sampling");
+
+    // A peer holding the same values has nothing to send back
+    PublicKey requester(32, 0xEE);
+    size_t missing = 0;
+    for (const auto& filter : filters) {
+        missing += theirs.filter_pull_responses(filter, requester, now, 1 << 20).size();
+    }
+    check(missing == 0, "filters miss values we hold");
+
+    // Updates reach the filters without a full rebuild
+    std::vector<CrdsValue> updates;
+    for (int i = 0; i < 200; ++i) {
+        ContactInfo ci(keys[i]);
+        ci.wallclock = now + 1000;
+        updates.emplace_back(ci);
+        theirs.insert(updates.back(), now, GossipRoute::PushMessage);
+    }
+    missing = 0;
+    for (const auto& filter : ours.build_pull_filters(1 << 20)) {
+        missing += theirs.filter_pull_responses(filter, requester, now + 1000, 1 << 20).size();
+    }
+    check(missing >= 190 && missing <= 200, "updated values not requested");
+    for (const auto& update : updates) {
+        ours.insert(update, now, GossipRoute::PushMessage);
+    }
+    missing = 0;
+    for (const auto& filter : ours.build_pull_filters(1 << 20)) {
+        missing += theirs.filter_pull_responses(filter, requester, now + 1000, 1 << 20).size();
+    }
+    check(missing == 0, "incremental update lost values");
+
+    // Growing the table re-splits it into more partitions
+    for (int i = 0; i < 5000; ++i) {
+        PublicKey pk(32);
+        for (auto& byte : pk) byte = static_cast<uint8_t>(rng());
+        ContactInfo ci(pk);
+        ci.wallclock = now;
+        ours.insert(CrdsValue(ci), now, GossipRoute::PushMessage);
+    }
+    check(ours.build_pull_filters(1 << 20).size() == (size_t{1} << CrdsFilterSet::mask_bits_for(10000)),
+          "partitions did not grow");
+    std::cout << "Pull filter checks passed (" << filters.size() << " partitions for 5000 values)\n";
+}
+
+void test_weighted_shuffle() {
+    std::cout << "\n=== Testing Weighted Shuffle ===\n";
+
+    auto check = [](bool condition, const char* what) {
+        if (!condition) throw std::runtime_error(what);
+    };
+
+    // ChaCha20 keystream for the all-zero key (RFC 7539 test vector)
+    ChaChaRng chacha(ChaChaRng::Seed{});
+    check(chacha.next_u32() == 0xade0b876 && chacha.next_u32() == 0x903df1a0, "chacha keystream");
+
+    std::vector<uint64_t> weights;
+    for (uint64_t i = 0; i < 1000; ++i) weights.push_back(i % 10 == 0 ? 0 : i * 1000);
+    WeightedShuffle shuffle(weights, 42);
+    auto order = shuffle.shuffle_indices();
+    check(order.size() == weights.size(), "shuffle is not a permutation");
+    check(std::set<size_t>(order.begin(), order.end()).size() == weights.size(), "index drawn twice");
+    for (size_t i = 0; i < order.size(); ++i) {
+        // Zero-weight indices only after every staked one
+        check((weights[order[i]] == 0) == (i >= 900), "zero weights not last");
+    }
+    check(shuffle.shuffle_indices(10) == std::vector<size_t>(order.begin(), order.begin() + 10),
+          "reset does not reproduce the order");
+    check(WeightedShuffle(weights, 42).shuffle_indices() == order, "seed is not deterministic");
+    shuffle.reseed(43);
+    check(shuffle.shuffle_indices() != order, "reseed kept the order");
+
+    // Removed indices are never drawn
+    shuffle.reset();
+    shuffle.remove_index(order[0]);
+    shuffle.remove_index(0);
+    for (size_t index = shuffle.next_index(); index != WeightedShuffle::npos; index = shuffle.next_index()) {
+        check(index != order[0] && index != 0, "removed index drawn");
+    }
+
+    // First picks follow stake: 1:2:3:4
+    std::vector<uint64_t> small = {1, 2, 3, 4};
+    WeightedShuffle picker(small);
+    std::vector<size_t> first(4, 0);
+    for (uint64_t seed = 0; seed < 20000; ++seed) {
+        picker.reseed(seed);
+        first[picker.next_index()]++;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        double expected = 20000.0 * small[i] / 10;
+        check(first[i] > expected * 0.9 && first[i] < expected * 1.1, "first pick not stake weighted");
+    }
+    std::cout << "First-pick counts for stakes 1:2:3:4: " << first[0] << " " << first[1]
+              << " " << first[2] << " " << first[3] << "\n";
+}
+
 void test_gossip_service() {
     std::cout << "\n=== Testing Gossip Service ===\n";
     
@@ -186,6 +405,152 @@ void test_gossip_service() {
     std::cout << "Gossip service stopped\n";
 }
 
+void test_pull_requests_sent() {
+    std::cout << "\n=== Testing Pull Request Delivery ===\n";
+
+    auto check = [](bool condition, const char* what) {
+        if (!condition) throw std::runtime_error(what);
+    };
+
+    // A bare UDP socket stands in for the peer's gossip port
+    int peer_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in peer_addr{};
+    peer_addr.sin_family = AF_INET;
+    peer_addr.sin_port = htons(18003);
+    inet_pton(AF_INET, "127.0.0.1", &peer_addr.sin_addr);
+    check(bind(peer_socket, reinterpret_cast<sockaddr*>(&peer_addr),
+               sizeof(peer_addr)) == 0, "bind peer socket");
+    timeval timeout{0, 200000};
+    setsockopt(peer_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    GossipService::Config config;
+    config.bind_address = "127.0.0.1";
+    config.bind_port = 18002;
+    config.node_pubkey = PublicKey(32, 98);
+    config.shred_version = 1;
+    config.pull_interval_ms = 100;
+    config.enable_ping_pong = false;
+    GossipService gossip(config);
+
+    // One peer with a gossip address, one without: only the first is asked
+    ContactInfo reachable(PublicKey(32, 1));
+    reachable.addrs.push_back("127.0.0.1:18003");
+    ContactInfo unreachable(PublicKey(32, 2));
+    check(gossip.insert_local_value(CrdsValue(reachable)).is_ok(), "insert reachable");
+    check(gossip.insert_local_value(CrdsValue(unreachable)).is_ok(), "insert unreachable");
+
+    check(gossip.start().is_ok(), "start gossip");
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    gossip.stop();
+
+    size_t received = 0;
+    std::vector<uint8_t> buffer(65536);
+    while (recv(peer_socket, buffer.data(), buffer.size(), 0) > 0) {
+        received++;
+    }
+    close(peer_socket);
+
+    uint64_t sent = gossip.get_stats().pull_requests_sent;
+    std::cout << "Pull requests sent: " << sent << ", received: " << received << "\n";
+    check(sent > 0, "no pull requests sent");
+    check(received == sent, "sent count does not match delivered requests");
+}
+
+void test_pull_request_served() {
+    std::cout << "\n=== Testing Pull Request Wire Round Trip ===\n";
+
+    auto check = [](bool condition, const char* what) {
+        if (!condition) throw std::runtime_error(what);
+    };
+
+    // Filter and caller survive encoding
+    PublicKey requester(32, 3);
+    ContactInfo caller(requester);
+    caller.addrs.push_back("127.0.0.1:18005");
+    CrdsFilter filter(100, 0x8000000000000000ULL, 1);
+    Hash held(32, 0x81);
+    filter.add(held);
+    auto request = Protocol::create_pull_request(filter, CrdsValue(caller));
+    auto decoded = Protocol::deserialize(request.serialize());
+    check(decoded.is_ok(), "pull request does not decode");
+    auto message = std::move(decoded).value();
+    check(message.type() == Protocol::Type::PullRequest && message.is_valid(),
+          "decoded pull request invalid");
+    check(message.get_filter()->contains(held) &&
+          message.get_filter()->mask() == filter.mask() &&
+          message.get_filter()->mask_bits() == 1 &&
+          message.get_filter()->num_bits() == filter.num_bits(),
+          "filter changed on the wire");
+    const auto &caller_value = message.get_values()->front();
+    check(caller_value.hash() == CrdsValue(caller).hash(), "caller info changed on the wire");
+    auto truncated = request.serialize();
+    truncated.resize(truncated.size() - 5);
+    check(!Protocol::deserialize(truncated).is_ok(), "truncated request decoded");
+
+    int peer_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in peer_addr{};
+    peer_addr.sin_family = AF_INET;
+    peer_addr.sin_port = htons(18005);
+    inet_pton(AF_INET, "127.0.0.1", &peer_addr.sin_addr);
+    check(bind(peer_socket, reinterpret_cast<sockaddr*>(&peer_addr),
+               sizeof(peer_addr)) == 0, "bind peer socket");
+    timeval timeout{1, 0};
+    setsockopt(peer_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    GossipService::Config config;
+    config.bind_address = "127.0.0.1";
+    config.bind_port = 18004;
+    config.node_pubkey = PublicKey(32, 97);
+    config.pull_interval_ms = 60000;
+    config.enable_ping_pong = false;
+    GossipService gossip(config);
+    ContactInfo known(PublicKey(32, 4));
+    check(gossip.insert_local_value(CrdsValue(known)).is_ok(), "insert value");
+    check(gossip.start().is_ok(), "start gossip");
+
+    sockaddr_in service_addr{};
+    service_addr.sin_family = AF_INET;
+    service_addr.sin_port = htons(18004);
+    inet_pton(AF_INET, "127.0.0.1", &service_addr.sin_addr);
+    auto send_to_service = [&](const Protocol &msg) {
+        auto bytes = msg.serialize();
+        sendto(peer_socket, bytes.data(), bytes.size(), 0,
+               reinterpret_cast<sockaddr*>(&service_addr), sizeof(service_addr));
+    };
+    auto receive_reply = [&]() {
+        std::vector<uint8_t> buffer(65536);
+        ssize_t n = recv(peer_socket, buffer.data(), buffer.size(), 0);
+        check(n > 0, "no reply from the service");
+        buffer.resize(n);
+        auto reply = Protocol::deserialize(buffer);
+        check(reply.is_ok(), "reply does not decode");
+        return std::move(reply).value();
+    };
+
+    // An empty full-range filter asks for everything the service holds
+    send_to_service(Protocol::create_pull_request(CrdsFilter(100), CrdsValue(caller)));
+    auto response = receive_reply();
+    check(response.type() == Protocol::Type::PullResponse, "pull request not answered");
+    bool found = false;
+    for (const auto &value : *response.get_values()) {
+        found |= value.pubkey() == known.pubkey;
+    }
+    check(found, "pull response misses the service's value");
+
+    // Pings are answered at the address they came from, echoing the token
+    PingMessage ping(requester);
+    ping.sign(Signature(64, 1));
+    send_to_service(Protocol::create_ping_message(ping));
+    auto pong = receive_reply();
+    check(pong.type() == Protocol::Type::PongMessage &&
+          pong.get_pong()->token == ping.token, "ping not answered with its token");
+
+    gossip.stop();
+    close(peer_socket);
+    check(gossip.get_stats().pull_responses_sent > 0, "pull responses not counted");
+    check(gossip.get_stats().pong_messages_sent == 1, "pong not counted");
+}
+
 int main() {
     std::cout << "=================================================\n";
     std::cout << "  Agave-Compatible Gossip Protocol Test Suite\n";
@@ -195,7 +560,12 @@ int main() {
         test_crds_basic();
         test_protocol_messages();
         test_bloom_filter();
+        test_crds_pull_responder();
+        test_crds_filter_set();
+        test_weighted_shuffle();
         test_gossip_service();
+        test_pull_requests_sent();
+        test_pull_request_served();
         
         std::cout << "\n=================================================\n";
         std::cout << "  All tests completed successfully!\n";
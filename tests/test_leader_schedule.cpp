@@ -0,0 +1,190 @@
+#include "consensus/leader_schedule.h"
+#include "staking/manager.h"
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace slonana::consensus;
+using slonana::staking::EpochStakes;
+using slonana::staking::StakeAccount;
+using slonana::staking::StakingManager;
+
+namespace {
+
+PublicKey validator(uint8_t id) { return PublicKey(32, id); }
+
+/// Validators 1, 2 and 3 holding 60%, 30% and 10% of the stake
+void add_stakes(StakingManager &staking) {
+  const uint64_t stakes[] = {600, 300, 100};
+  for (uint8_t v = 0; v < 3; ++v) {
+    for (uint8_t i = 0; i < 3; ++i) {
+      StakeAccount account;
+      account.stake_pubkey = PublicKey(32, static_cast<uint8_t>(0x40 + 3 * v + i));
+      account.validator_pubkey = validator(v + 1);
+      account.stake_amount = stakes[v] * 1000000000ULL / 3;
+      account.is_active = true;
+      staking.create_stake_account(account);
+    }
+  }
+}
+
+} // namespace
+
+bool test_schedule_draws() {
+  std::cout << "Testing stake-weighted leader schedule..." << std::endl;
+
+  StakingManager staking;
+  add_stakes(staking);
+  auto stakes = staking.get_epoch_stakes(7);
+  const uint64_t slots_per_epoch = 4000;
+  LeaderSchedule schedule(*stakes, slots_per_epoch);
+
+  assert(schedule.epoch() == 7);
+  assert(schedule.first_slot() == 7 * slots_per_epoch);
+  assert(schedule.leader_indices().size() == slots_per_epoch / 4);
+  assert(schedule.validators()[0] == validator(1)); // Largest stake first
+  assert(!schedule.leader_at(schedule.first_slot() - 1));
+  assert(!schedule.leader_at(schedule.first_slot() + slots_per_epoch));
+
+  // Leaders hold NUM_CONSECUTIVE_LEADER_SLOTS slots at a time
+  for (Slot slot = schedule.first_slot(); slot < schedule.first_slot() + 400;
+       slot += LeaderSchedule::NUM_CONSECUTIVE_LEADER_SLOTS) {
+    for (Slot next = slot + 1; next < slot + 4; ++next) {
+      assert(*schedule.leader_at(next) == *schedule.leader_at(slot));
+    }
+  }
+
+  // Picks follow stake: 1000 draws at 60/30/10 stay within ~4 sigma
+  size_t total = 0;
+  const size_t expected[] = {2400, 1200, 400};
+  const size_t tolerance[] = {250, 240, 160};
+  for (uint8_t v = 0; v < 3; ++v) {
+    auto slots = schedule.leader_slots(validator(v + 1));
+    total += slots.size();
+    assert(slots.size() + tolerance[v] > expected[v]);
+    assert(slots.size() < expected[v] + tolerance[v]);
+  }
+  assert(total == slots_per_epoch);
+  assert(schedule.leader_slots(validator(9)).empty());
+
+  // Deterministic per epoch, different across epochs
+  LeaderSchedule again(*stakes, slots_per_epoch);
+  assert(again.leader_indices() == schedule.leader_indices());
+  EpochStakes next_epoch = *stakes;
+  next_epoch.epoch = 8;
+  assert(LeaderSchedule(next_epoch, slots_per_epoch).leader_indices() !=
+         schedule.leader_indices());
+
+  // No stake, no leaders
+  EpochStakes empty;
+  assert(!LeaderSchedule(empty, slots_per_epoch).leader_at(0));
+
+  std::cout << "✅ Leader schedule draws test passed" << std::endl;
+  return true;
+}
+
+bool test_schedule_cache() {
+  std::cout << "Testing leader schedule cache..." << std::endl;
+
+  StakingManager staking;
+  add_stakes(staking);
+  size_t provided = 0;
+  LeaderScheduleCache cache(
+      [&](Epoch epoch) {
+        ++provided;
+        return staking.get_epoch_stakes(epoch);
+      },
+      100, 10);
+
+  // Only the current and next epoch are schedulable
+  assert(cache.slot_leader(50).has_value());
+  assert(cache.slot_leader(150).has_value());
+  assert(!cache.slot_leader(250).has_value());
+  assert(provided == 2);
+
+  // Far from the boundary nothing is precomputed
+  cache.notify_slot(150);
+  cache.notify_slot(180);
+  assert(cache.precomputed_count() == 0);
+
+  // Within the lookahead, epoch 2 is drawn in the background
+  cache.notify_slot(192);
+  auto schedule = cache.get_epoch_schedule(2);
+  assert(schedule);
+  assert(cache.precomputed_count() == 1);
+  assert(provided == 3);
+  assert(schedule->leader_indices() ==
+         LeaderSchedule(*staking.get_epoch_stakes(2), 100).leader_indices());
+  assert(cache.slot_leader(250) == *schedule->leader_at(250));
+
+  // Cached: asking again neither redraws nor calls the provider
+  cache.notify_slot(195);
+  assert(cache.get_epoch_schedule(2) == schedule);
+  assert(cache.precomputed_count() == 1);
+  assert(provided == 3);
+
+  std::cout << "✅ Leader schedule cache test passed" << std::endl;
+  return true;
+}
+
+bool test_concurrent_epoch_stakes() {
+  std::cout << "Testing epoch stakes under concurrent updates..." << std::endl;
+
+  StakingManager staking;
+  add_stakes(staking);
+
+  // RPC-style readers race the block thread's schedule lookups and new
+  // stake accounts; every snapshot handed out must stay self-consistent
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&staking, t] {
+      for (Epoch epoch = 0; epoch < 200; ++epoch) {
+        auto stakes = staking.get_epoch_stakes(epoch / 4 + t);
+        assert(stakes->total_stake ==
+               std::accumulate(stakes->validator_stakes.begin(),
+                               stakes->validator_stakes.end(), uint64_t{0}));
+        assert(stakes->delegations.size() == stakes->delegation_offsets.back());
+        staking.get_total_stake();
+      }
+    });
+  }
+  for (uint8_t i = 0; i < 50; ++i) {
+    StakeAccount account;
+    account.stake_pubkey = PublicKey(32, static_cast<uint8_t>(0x80 + i));
+    account.validator_pubkey = validator(4);
+    account.stake_amount = 1000000000ULL;
+    account.is_active = true;
+    assert(staking.create_stake_account(account).is_ok());
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  // A cached epoch is shared, a new one sees every account
+  assert(staking.get_epoch_stakes(500) == staking.get_epoch_stakes(500));
+  assert(staking.get_epoch_stakes(500)->delegations.size() == 59);
+
+  std::cout << "✅ Concurrent epoch stakes test passed" << std::endl;
+  return true;
+}
+
+int main() {
+  std::cout << "=== Leader Schedule Test Suite ===" << std::endl;
+
+  try {
+    assert(test_schedule_draws());
+    assert(test_schedule_cache());
+    assert(test_concurrent_epoch_stakes());
+
+    std::cout << "\n🎉 All leader schedule tests passed!" << std::endl;
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "❌ Test failed with unknown exception" << std::endl;
+    return 1;
+  }
+}
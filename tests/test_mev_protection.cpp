@@ -1,6 +1,8 @@
 #include "banking/mev_protection.h"
+#include "banking/prioritization_scheduler.h"
 #include <cassert>
 #include <iostream>
+#include <random>
 #include <thread>
 #include <chrono>
 
@@ -26,6 +28,9 @@ public:
     all_passed &= test_suspicious_filtering();
     all_passed &= test_statistics();
     all_passed &= test_concurrent_access();
+    all_passed &= test_sandwich_detection();
+    all_passed &= test_front_and_back_running();
+    all_passed &= test_detection_benchmark();
 
     if (all_passed) {
       std::cout << "✅ All MEV Protection tests passed!" << std::endl;
@@ -57,6 +62,40 @@ private:
     return tx;
   }
 
+  /**
+   * A swap of `amount` through `program` on `pool`, from the payer's
+   * `source` token account to `destination`, paying `price` per CU
+   */
+  TransactionPtr create_swap(uint64_t id, uint32_t payer, uint32_t pool,
+                             uint32_t source, uint32_t destination,
+                             uint64_t amount, uint64_t price,
+                             uint32_t program = 0x50) {
+    auto tx = create_test_transaction(id);
+    // payer, source, destination, pool writable; program, ComputeBudget not
+    std::vector<uint8_t> message = {1, 0, 2, 6};
+    for (uint32_t tag : {payer, source, destination, pool, program}) {
+      for (size_t i = 0; i < 32; ++i) {
+        message.push_back(static_cast<uint8_t>(tag >> (8 * (i % 4))) ^
+                          static_cast<uint8_t>(i / 4));
+      }
+    }
+    const auto &budget = SchedulableTransaction::COMPUTE_BUDGET_PROGRAM_ID;
+    message.insert(message.end(), budget.begin(), budget.end());
+    message.insert(message.end(), 32, 0); // Recent blockhash
+
+    message.push_back(2);
+    message.insert(message.end(), {5, 0, 9, 3});
+    for (size_t i = 0; i < 8; ++i) {
+      message.push_back(static_cast<uint8_t>(price >> (8 * i)));
+    }
+    message.insert(message.end(), {4, 4, 3, 1, 2, 0, 9, 9});
+    for (size_t i = 0; i < 8; ++i) {
+      message.push_back(static_cast<uint8_t>(amount >> (8 * i)));
+    }
+    tx->message = message;
+    return tx;
+  }
+
   bool test_initialization() {
     std::cout << "Testing MEV protection initialization..." << std::endl;
 
@@ -261,6 +300,144 @@ private:
     std::cout << "✅ Concurrent access test passed" << std::endl;
     return true;
   }
+
+  bool test_sandwich_detection() {
+    std::cout << "Testing sandwich detection across gaps..." << std::endl;
+
+    MEVProtection protection;
+    std::vector<TransactionPtr> block;
+    block.push_back(create_swap(1, 0xA1, 0x70, 0x11, 0x12, 1000, 500)); // Buy
+    block.push_back(create_swap(2, 0xB1, 0x71, 0x21, 0x22, 50, 400));
+    block.push_back(create_swap(3, 0xB2, 0x70, 0x31, 0x32, 700, 300)); // Victim
+    block.push_back(create_swap(4, 0xB3, 0x72, 0x41, 0x42, 80, 200));
+    block.push_back(create_swap(5, 0xA1, 0x70, 0x12, 0x11, 1000, 100)); // Sell
+    // The same attacker back on an unrelated pool is not a sandwich
+    block.push_back(create_swap(6, 0xA1, 0x71, 0x11, 0x12, 10, 100));
+
+    auto alerts = protection.detect_mev_patterns(block);
+    size_t sandwiches = 0;
+    for (const auto &alert : alerts) {
+      if (alert.type != MEVAlert::Type::SANDWICH_ATTACK) {
+        continue;
+      }
+      ++sandwiches;
+      assert(alert.suspicious_transactions.size() == 3);
+      assert(alert.suspicious_transactions[0] == block[0]->signatures[0]);
+      assert(alert.suspicious_transactions[1] == block[2]->signatures[0]);
+      assert(alert.suspicious_transactions[2] == block[4]->signatures[0]);
+      assert(alert.confidence_score >= 0.99); // Reversed direction
+    }
+    assert(sandwiches == 1);
+    assert(protection.get_detected_attacks_count() == alerts.size());
+    assert(protection.is_sandwich_attack(block[0], block[2], block[4]));
+    assert(!protection.is_sandwich_attack(block[0], block[1], block[5]));
+
+    // No one in between: just two trades by one sender
+    MEVProtection quiet;
+    auto pair = quiet.detect_mev_patterns(
+        {create_swap(7, 0xA1, 0x70, 0x11, 0x12, 5, 1),
+         create_swap(8, 0xA1, 0x70, 0x12, 0x11, 5, 1)});
+    assert(pair.empty());
+
+    std::cout << "✅ Sandwich detection test passed" << std::endl;
+    return true;
+  }
+
+  bool test_front_and_back_running() {
+    std::cout << "Testing front- and back-running detection..." << std::endl;
+
+    MEVProtection protection;
+    protection.set_alert_threshold(0.5);
+    auto front = create_swap(1, 0xC1, 0x70, 0x11, 0x12, 1020, 900);
+    auto victim = create_swap(2, 0xC2, 0x70, 0x21, 0x22, 1000, 100);
+    auto backrun = create_swap(3, 0xC3, 0x70, 0x31, 0x32, 1, 100);
+
+    assert(protection.is_front_running(victim, front));
+    assert(!protection.is_front_running(front, victim)); // Lower price
+    assert(protection.is_back_running(victim, backrun));
+
+    auto alerts = protection.detect_mev_patterns({front, victim, backrun});
+    size_t front_runs = 0;
+    size_t back_runs = 0;
+    for (const auto &alert : alerts) {
+      front_runs += alert.type == MEVAlert::Type::FRONT_RUNNING;
+      back_runs += alert.type == MEVAlert::Type::BACK_RUNNING;
+    }
+    assert(front_runs == 1);
+    assert(back_runs == 1);
+
+    // Unparseable messages carry no features and raise nothing
+    std::vector<TransactionPtr> opaque;
+    for (int i = 0; i < 10; ++i) {
+      opaque.push_back(create_test_transaction(i));
+    }
+    assert(protection.detect_mev_patterns(opaque).empty());
+
+    std::cout << "✅ Front/back-running detection test passed" << std::endl;
+    return true;
+  }
+
+  bool test_detection_benchmark() {
+    std::cout << "Benchmarking detection on a 4k-transaction block..."
+              << std::endl;
+
+    // Distinct traders on 64 pools, with a sandwich every 256 transactions
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<uint32_t> pool(1, 64);
+    std::uniform_int_distribution<uint64_t> amount(1, 1000000);
+    std::uniform_int_distribution<uint64_t> price(1, 10000);
+    std::vector<TransactionPtr> block;
+    std::vector<uint32_t> pools;
+    for (uint32_t i = 0; i < 4096; ++i) {
+      uint32_t trader = 0x10000 + 3 * i;
+      pools.push_back(pool(rng));
+      block.push_back(create_swap(i, trader, pools[i], trader + 1,
+                                  trader + 2, amount(rng), price(rng)));
+    }
+    // Each attacker buys ahead of a victim and sells `gap` transactions
+    // after it, with unrelated traffic in between (gaps of 1 to 76)
+    for (uint32_t k = 0; k < 16; ++k) {
+      uint32_t front = 256 * k + 8;
+      uint32_t gap = 1 + 5 * k;
+      uint32_t victim = front + gap;
+      uint32_t back = victim + gap;
+      uint32_t attacker = 0x100 + 3 * k;
+      uint32_t target = pools[victim];
+      block[front] = create_swap(front, attacker, target, attacker + 1,
+                                 attacker + 2, 5000, 900);
+      block[back] = create_swap(back, attacker, target, attacker + 2,
+                                attacker + 1, 5000, 1);
+    }
+
+    MEVProtection protection;
+    size_t sandwiches = 0;
+    auto first_alerts = protection.detect_mev_patterns(block);
+    for (const auto &alert : first_alerts) {
+      sandwiches += alert.type == MEVAlert::Type::SANDWICH_ATTACK;
+    }
+    assert(sandwiches == 16); // Every injected one, at any distance
+
+    const int rounds = 20;
+    auto start = std::chrono::steady_clock::now();
+    size_t alerts = 0;
+    for (int r = 0; r < rounds; ++r) {
+      alerts += protection.detect_mev_patterns(block).size();
+    }
+    double micros = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - start)
+                        .count() /
+                    rounds;
+    // Repeated detection over the same block is deterministic
+    assert(alerts == first_alerts.size() * rounds);
+
+    // Timing is reported against the 1 ms per block target, not asserted:
+    // shared CI machines make wall-clock thresholds flaky
+    std::cout << "  " << micros << " us per block (target 1000 us), "
+              << alerts / rounds << " alerts" << std::endl;
+
+    std::cout << "✅ Detection benchmark passed" << std::endl;
+    return true;
+  }
 };
 
 } // namespace test
@@ -1,8 +1,10 @@
 #include "monitoring/metrics.h"
+#include "monitoring/prometheus_exporter.h"
 #include "test_framework.h"
 #include <chrono>
 #include <memory>
 #include <thread>
+#include <vector>
 
 using namespace slonana::monitoring;
 
@@ -77,11 +79,18 @@ void test_histogram_creation_and_operation() {
   histogram->observe(0.3);  // Falls in 0.5 bucket
   histogram->observe(1.5);  // Falls in 2.0 bucket
   histogram->observe(10.0); // Falls in +Inf bucket
+  // Either side of 0.1, inside the one log-linear bucket spanning it
+  histogram->observe(0.1);
+  histogram->observe(0.1005);
 
   auto data = histogram->get_data();
-  ASSERT_EQ(static_cast<uint64_t>(4), data.total_count);
+  ASSERT_EQ(static_cast<uint64_t>(6), data.total_count);
   ASSERT_GT(data.sum, 0.0);
-  ASSERT_GT(data.buckets.size(), static_cast<size_t>(0));
+  ASSERT_EQ(static_cast<size_t>(6), data.buckets.size());
+  ASSERT_EQ(static_cast<uint64_t>(2), data.buckets[0].count); // le=0.1
+  ASSERT_EQ(static_cast<uint64_t>(4), data.buckets[1].count); // le=0.5
+  ASSERT_EQ(static_cast<uint64_t>(5), data.buckets[3].count); // le=2
+  ASSERT_EQ(static_cast<uint64_t>(6), data.buckets[5].count); // +Inf
 }
 
 void test_timer_functionality() {
@@ -185,6 +194,116 @@ void test_metric_values_timestamp() {
   ASSERT_LE(values[0].timestamp, after);
 }
 
+void test_counter_concurrent_increments() {
+  auto registry = MonitoringFactory::create_registry();
+  auto counter = registry->counter("concurrent_counter", "Concurrent counter");
+
+  const int threads = 8;
+  const int per_thread = 10000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&] {
+      for (int i = 0; i < per_thread; ++i) {
+        counter->increment();
+      }
+      counter->increment(0.5);
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  ASSERT_EQ(threads * per_thread + threads * 0.5, counter->get_value());
+}
+
+void test_log_linear_histogram() {
+  // Bucket edges bracket the value within 1/16 relative error
+  for (double value : {1e-6, 0.003, 0.1, 1.0, 7.5, 1234.5, 1e9}) {
+    size_t index = LogLinearHistogram::bucket_index(value);
+    ASSERT_LE(LogLinearHistogram::bucket_lower_bound(index), value);
+    ASSERT_GT(LogLinearHistogram::bucket_upper_bound(index), value);
+    ASSERT_LE(LogLinearHistogram::bucket_upper_bound(index) -
+                  LogLinearHistogram::bucket_lower_bound(index),
+              value / 16.0);
+  }
+  ASSERT_EQ(static_cast<size_t>(0), LogLinearHistogram::bucket_index(0.0));
+  ASSERT_EQ(static_cast<size_t>(0), LogLinearHistogram::bucket_index(-1.0));
+
+  LogLinearHistogram first;
+  LogLinearHistogram second;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&, t] {
+      auto &target = t % 2 == 0 ? first : second;
+      for (int i = 1; i <= 500; ++i) {
+        target.record(static_cast<double>(i));
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  auto snapshot = first.snapshot();
+  ASSERT_EQ(static_cast<uint64_t>(1000), snapshot.count);
+  snapshot.merge(second.snapshot());
+  ASSERT_EQ(static_cast<uint64_t>(2000), snapshot.count);
+  ASSERT_EQ(4.0 * 500 * 501 / 2, snapshot.sum);
+  ASSERT_EQ(1.0, snapshot.min);
+  ASSERT_EQ(500.0, snapshot.max);
+
+  double median = snapshot.quantile(0.5);
+  ASSERT_GE(median, 250.0 * 15 / 16);
+  ASSERT_LE(median, 250.0 * 17 / 16);
+  ASSERT_EQ(500.0, snapshot.quantile(1.0));
+}
+
+void test_labelled_metric_handles() {
+  auto registry = MonitoringFactory::create_registry();
+  auto requests = make_counter_vec(*registry, "rpc_requests_total",
+                                   "RPC requests", "method",
+                                   {"getSlot", "getBalance"});
+  ASSERT_EQ(static_cast<size_t>(2), requests.size());
+
+  requests[0].increment();
+  requests[1].increment(3.0);
+
+  // Same series as a direct lookup with the label set
+  auto direct = registry->counter("rpc_requests_total", "RPC requests",
+                                  {{"method", "getBalance"}});
+  ASSERT_EQ(&requests[1], direct.get());
+  ASSERT_EQ(3.0, direct->get_value());
+}
+
+void test_prometheus_export() {
+  auto registry = MonitoringFactory::create_registry();
+  auto latency = make_histogram_vec(*registry, "request_seconds",
+                                    "Request latency", "kind",
+                                    {"read", "write"}, {0.1, 1.0});
+  latency[0].observe(0.05);
+  latency[0].observe(0.5);
+  latency[0].observe(5.0);
+  registry->gauge("queue_depth", "Queue depth")->set(3.0);
+
+  PrometheusExporter exporter;
+  std::string output = exporter.export_metrics(*registry);
+
+  // One header per metric name, shared by its labelled series
+  size_t first = output.find("# TYPE request_seconds histogram");
+  ASSERT_TRUE(first != std::string::npos);
+  ASSERT_TRUE(output.find("# TYPE request_seconds", first + 1) ==
+              std::string::npos);
+
+  ASSERT_CONTAINS(output, "request_seconds_bucket{kind=\"read\",le=\"0.1\"} 1\n");
+  ASSERT_CONTAINS(output, "request_seconds_bucket{kind=\"read\",le=\"1\"} 2\n");
+  ASSERT_CONTAINS(output,
+                  "request_seconds_bucket{kind=\"read\",le=\"+Inf\"} 3\n");
+  ASSERT_CONTAINS(output, "request_seconds_sum{kind=\"read\"} 5.55\n");
+  ASSERT_CONTAINS(output, "request_seconds_count{kind=\"read\"} 3\n");
+  ASSERT_CONTAINS(output, "request_seconds_count{kind=\"write\"} 0\n");
+  ASSERT_CONTAINS(output, "queue_depth 3\n");
+}
+
 // Test runner function
 void run_monitoring_tests() {
   TestRunner runner;
@@ -204,6 +323,11 @@ void run_monitoring_tests() {
                   test_same_metric_name_returns_same_instance);
   runner.run_test("global_metrics_registry", test_global_metrics_registry);
   runner.run_test("metric_values_timestamp", test_metric_values_timestamp);
+  runner.run_test("counter_concurrent_increments",
+                  test_counter_concurrent_increments);
+  runner.run_test("log_linear_histogram", test_log_linear_histogram);
+  runner.run_test("labelled_metric_handles", test_labelled_metric_handles);
+  runner.run_test("prometheus_export", test_prometheus_export);
 
   runner.print_summary();
 }
@@ -1,9 +1,14 @@
 #include "network/gossip.h"
+#include "network/quic_transport.h"
+#include "network/rpc_json.h"
 #include "network/rpc_server.h"
 #include "test_framework.h"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <thread>
+#include <vector>
 
 void test_rpc_server_initialization() {
   slonana::common::ValidatorConfig config;
@@ -245,12 +250,254 @@ void test_rpc_batch_requests() {
 
   std::string response = rpc_server.handle_request(batch_request);
 
-  // Should handle batch requests (even if not fully implemented)
+  // Batch responses come back as an array in request order
   ASSERT_NOT_EMPTY(response);
+  ASSERT_EQ('[', response.front());
+  ASSERT_EQ(']', response.back());
+  size_t first = response.find("\"id\":\"1\"");
+  size_t second = response.find("\"id\":\"2\"");
+  size_t third = response.find("\"id\":\"3\"");
+  ASSERT_TRUE(first != std::string::npos && second != std::string::npos &&
+              third != std::string::npos);
+  ASSERT_LT(first, second);
+  ASSERT_LT(second, third);
+
+  // Empty batches are rejected per JSON-RPC 2.0
+  ASSERT_CONTAINS(rpc_server.handle_request("[]"), "-32600");
 
   rpc_server.stop();
 }
 
+void test_rpc_json_tokenizer() {
+  using namespace slonana::network::rpc_json;
+
+  std::string input =
+      R"({"id":7,"method":"getBlocks","params":[[1,{"a":"x\"y"}],{"commitment":"finalized"},true,null]})";
+  JsonDocument doc;
+  ASSERT_TRUE(doc.parse(input));
+
+  auto root = doc.root();
+  ASSERT_TRUE(root.is_object());
+  ASSERT_EQ(7u, root.get("id").as_uint64().value());
+  ASSERT_EQ(std::string("getBlocks"), root.get("method").as_string());
+
+  // Nested params are addressed structurally, not by regex
+  auto params = root.get("params");
+  ASSERT_EQ(4u, params.size());
+  ASSERT_EQ(std::string("x\"y"), params.at(0).at(1).get("a").as_string());
+  ASSERT_EQ(std::string("finalized"),
+            params.at(1).get("commitment").as_string());
+  ASSERT_TRUE(params.at(2).as_bool().value());
+  ASSERT_TRUE(params.at(3).is_null());
+  ASSERT_FALSE(params.at(4).valid());
+
+  ASSERT_FALSE(doc.parse("{invalid json}"));
+  ASSERT_FALSE(doc.parse(R"({"a":1,})"));
+  ASSERT_FALSE(doc.parse(R"([1,2)"));
+}
+
+void test_rpc_json_encoders() {
+  using namespace slonana::network::rpc_json;
+
+  // Known vectors: leading zero bytes map to '1'
+  ASSERT_EQ(std::string("11111111111111111111111111111111"),
+            encode_base58(std::vector<uint8_t>(32, 0)));
+  ASSERT_EQ(std::string("1112"), encode_base58({0, 0, 0, 1}));
+  ASSERT_EQ(std::string("5Q"), encode_base58({0xFF}));
+  ASSERT_EQ(std::string("JxF12TrwUP45BMd"),
+            encode_base58({'H', 'e', 'l', 'l', 'o', ' ', 'W', 'o', 'r', 'l',
+                           'd'}));
+
+  ASSERT_EQ(std::string(""), encode_base64({}));
+  ASSERT_EQ(std::string("Zg=="), encode_base64({'f'}));
+  ASSERT_EQ(std::string("Zm8="), encode_base64({'f', 'o'}));
+  ASSERT_EQ(std::string("Zm9vYmFy"),
+            encode_base64({'f', 'o', 'o', 'b', 'a', 'r'}));
+
+  std::string out;
+  JsonWriter writer(out);
+  writer.begin_object()
+      .key("s")
+      .string("a\"b\n")
+      .key("n")
+      .number(uint64_t(42))
+      .key("list")
+      .begin_array()
+      .boolean(true)
+      .null()
+      .end_array()
+      .end_object();
+  ASSERT_EQ(std::string(R"({"s":"a\"b\n","n":42,"list":[true,null]})"), out);
+}
+
+void test_rpc_response_cache() {
+  using slonana::network::RpcResponseCache;
+
+  slonana::common::ValidatorConfig config;
+  config.rpc_bind_address = "127.0.0.1:18899";
+  slonana::network::SolanaRpcServer rpc_server(config);
+  auto &cache = rpc_server.response_cache();
+
+  // Commitment and key order are canonicalized; encoding stays significant
+  const std::string address = "11111111111111111111111111111112";
+  auto plain = cache.make_key("getAccountInfo", "[\"" + address + "\"]");
+  auto explicit_default = cache.make_key(
+      "getAccountInfo",
+      "[\"" + address + "\",{\"commitment\":\"finalized\"}]");
+  auto reordered = cache.make_key(
+      "getAccountInfo", "[\"" + address +
+                            "\",{\"encoding\":\"base64\",\"commitment\":"
+                            "\"confirmed\",\"dataSlice\":{\"offset\":0}}]");
+  auto sorted = cache.make_key(
+      "getAccountInfo",
+      "[\"" + address +
+          "\",{\"dataSlice\":{\"offset\":0},\"commitment\":\"confirmed\","
+          "\"encoding\":\"base64\"}]");
+  ASSERT_TRUE(plain.has_value());
+  ASSERT_EQ(plain->text, explicit_default->text);
+  ASSERT_EQ(reordered->text, sorted->text);
+  ASSERT_NE(plain->text, sorted->text);
+  ASSERT_EQ(address, plain->account);
+  ASSERT_FALSE(cache.make_key("getHealth", "[]").has_value());
+  ASSERT_FALSE(cache.make_key("getBalance", "[12]").has_value());
+
+  // Repeated calls are served from cache with the caller's own id
+  auto before = cache.stats("getBalance");
+  std::string first = rpc_server.handle_request(
+      R"({"jsonrpc":"2.0","method":"getBalance","params":[")" + address +
+      R"("],"id":1})");
+  std::string second = rpc_server.handle_request(
+      R"({"jsonrpc":"2.0","method":"getBalance","params":[")" + address +
+      R"(",{"commitment":"finalized"}],"id":"abc"})");
+  ASSERT_CONTAINS(first, "\"id\":1");
+  ASSERT_CONTAINS(second, "\"id\":\"abc\"");
+  ASSERT_EQ(first.substr(0, first.find("\"id\"")),
+            second.substr(0, second.find("\"id\"")));
+  auto after = cache.stats("getBalance");
+  ASSERT_EQ(before.misses + 1, after.misses);
+  ASSERT_EQ(before.hits + 1, after.hits);
+
+  // Account-change events drop only the entries for that account
+  ASSERT_EQ(1u, after.entries);
+  rpc_server.invalidate_account("SomeOtherAccount1111111111111111");
+  ASSERT_EQ(1u, cache.stats("getBalance").entries);
+  rpc_server.invalidate_account(address);
+  ASSERT_EQ(0u, cache.stats("getBalance").entries);
+
+  // Without a validator core, responses are cached at the notified slot
+  auto get_slot = [&] {
+    rpc_server.handle_request(
+        R"({"jsonrpc":"2.0","method":"getSlot","params":[],"id":1})");
+  };
+  get_slot();
+  rpc_server.notify_slot_advance(5);
+  ASSERT_EQ(0u, cache.stats("getSlot").entries);
+  before = cache.stats("getSlot");
+  get_slot();
+  get_slot();
+  after = cache.stats("getSlot");
+  ASSERT_EQ(before.misses + 1, after.misses);
+  ASSERT_EQ(before.hits + 1, after.hits);
+
+  // Slot-scoped entries miss once the slot moves on
+  RpcResponseCache local;
+  auto key = local.make_key("getSlot", "");
+  int computations = 0;
+  auto compute = [&](bool &cacheable) {
+    ++computations;
+    cacheable = true;
+    return std::make_shared<const std::string>("42");
+  };
+  local.get_or_compute("getSlot", *key, 42, compute);
+  local.get_or_compute("getSlot", *key, 42, compute);
+  ASSERT_EQ(1, computations);
+  local.get_or_compute("getSlot", *key, 43, compute);
+  ASSERT_EQ(2, computations);
+  local.notify_slot_advance(44);
+  ASSERT_EQ(0u, local.stats("getSlot").entries);
+
+  // Errors are never cached
+  auto failing = [&](bool &cacheable) {
+    ++computations;
+    cacheable = false;
+    return RpcResponseCache::Body();
+  };
+  ASSERT_TRUE(local.get_or_compute("getSlot", *key, 44, failing) == nullptr);
+  ASSERT_EQ(0u, local.stats("getSlot").entries);
+
+  // A read that raced an account write is returned but not cached
+  auto balance = local.make_key("getBalance", "[\"" + address + "\"]");
+  auto racing = [&](bool &cacheable) {
+    ++computations;
+    cacheable = true;
+    local.invalidate_account(address); // store + invalidate mid-compute
+    return std::make_shared<const std::string>("1");
+  };
+  ASSERT_TRUE(local.get_or_compute("getBalance", *balance, 44, racing) !=
+              nullptr);
+  ASSERT_EQ(0u, local.stats("getBalance").entries);
+  local.get_or_compute("getBalance", *balance, 44, compute);
+  ASSERT_EQ(1u, local.stats("getBalance").entries);
+
+  // Blocks are immutable only once finalized
+  auto finalized = local.make_key("getBlock", "[7]");
+  auto confirmed =
+      local.make_key("getBlock", "[7,{\"commitment\":\"confirmed\"}]");
+  ASSERT_TRUE(finalized->scope == RpcResponseCache::Scope::IMMUTABLE);
+  ASSERT_TRUE(confirmed->scope == RpcResponseCache::Scope::SLOT);
+  local.get_or_compute("getBlock", *finalized, 44, compute);
+  local.get_or_compute("getBlock", *confirmed, 44, compute);
+  ASSERT_EQ(2u, local.stats("getBlock").entries);
+  local.notify_slot_advance(45);
+  ASSERT_EQ(1u, local.stats("getBlock").entries);
+  int before_block = computations;
+  local.get_or_compute("getBlock", *finalized, 45, compute);
+  ASSERT_EQ(before_block, computations);
+}
+
+void test_rpc_response_cache_coalescing() {
+  using slonana::network::RpcResponseCache;
+
+  RpcResponseCache cache;
+  auto key = cache.make_key("getLatestBlockhash", "[]");
+  ASSERT_TRUE(key.has_value());
+
+  std::atomic<int> computations{0};
+  std::atomic<bool> release{false};
+  auto slow = [&](bool &cacheable) {
+    computations.fetch_add(1);
+    while (!release.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    cacheable = true;
+    return std::make_shared<const std::string>("{\"value\":1}");
+  };
+
+  constexpr int callers = 8;
+  std::vector<RpcResponseCache::Body> bodies(callers);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < callers; ++i) {
+    threads.emplace_back([&, i] {
+      bodies[i] = cache.get_or_compute("getLatestBlockhash", *key, 7, slow);
+    });
+  }
+  // Give every caller time to join the in-flight computation
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  release.store(true);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(1, computations.load());
+  for (const auto &body : bodies) {
+    ASSERT_TRUE(body != nullptr);
+    ASSERT_TRUE(body.get() == bodies[0].get()); // One shared buffer
+  }
+  auto stats = cache.stats("getLatestBlockhash");
+  ASSERT_EQ(1u, stats.misses);
+  ASSERT_EQ(static_cast<uint64_t>(callers - 1), stats.coalesced + stats.hits);
+}
+
 void test_gossip_protocol_initialization() {
   slonana::common::ValidatorConfig config;
   config.gossip_bind_address = "127.0.0.1:18001";
@@ -683,6 +930,245 @@ void test_network_protocol_version_negotiation() {
   rpc_server.stop();
 }
 
+
+// Sans-IO QUIC engine: connections exchange datagrams through memory
+namespace {
+
+using namespace slonana::network::quic;
+
+struct QuicPair {
+  Identity client_identity;
+  Identity server_identity;
+  ServerPolicy policy;
+  TransportConfig config;
+  std::unique_ptr<Connection> client;
+  std::unique_ptr<Connection> server;
+  TimePoint now = Clock::now();
+  size_t datagrams = 0;
+  size_t dropped = 0;
+
+  explicit QuicPair(uint64_t quota = 128) {
+    policy.ticket_key.fill(7);
+    policy.stream_quota = [quota](const Key32 &) { return quota; };
+  }
+
+  void connect(const ResumptionTicket *ticket = nullptr) {
+    client = Connection::connect(client_identity, config, ticket, now);
+    server.reset();
+  }
+
+  // Deliver everything both sides want to send; drop(n) discards the nth
+  // datagram. Timers advance in 5ms steps when the wire goes quiet.
+  template <typename Drop> void run(int steps, Drop drop) {
+    uint8_t buffer[MAX_DATAGRAM_SIZE];
+    for (int step = 0; step < steps; ++step) {
+      bool moved = false;
+      size_t length;
+      while ((length = client->send(buffer, sizeof(buffer), now)) > 0) {
+        moved = true;
+        if (drop(datagrams++)) {
+          ++dropped;
+          continue;
+        }
+        if (!server) {
+          uint64_t key;
+          bool initial;
+          ASSERT_TRUE(parse_destination_cid(buffer, length, key, initial));
+          ASSERT_TRUE(initial);
+          server = Connection::accept(server_identity, config, policy,
+                                      buffer + 6, CID_LENGTH, now);
+        }
+        server->receive(buffer, length, now);
+      }
+      while (server && (length = server->send(buffer, sizeof(buffer), now)) > 0) {
+        moved = true;
+        if (drop(datagrams++)) {
+          ++dropped;
+          continue;
+        }
+        client->receive(buffer, length, now);
+      }
+      if (!moved) {
+        now += std::chrono::milliseconds(5);
+        if (now >= client->next_timeout()) {
+          client->on_timeout(now);
+        }
+        if (server && now >= server->next_timeout()) {
+          server->on_timeout(now);
+        }
+      }
+    }
+  }
+
+  void run(int steps) {
+    run(steps, [](size_t) { return false; });
+  }
+
+  std::vector<ReceivedStream> received() {
+    std::vector<ReceivedStream> streams;
+    server->take_received(streams);
+    return streams;
+  }
+};
+
+std::vector<uint8_t> test_transaction(size_t index, size_t size = 200) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(index * 31 + i);
+  }
+  return data;
+}
+
+} // namespace
+
+void test_quic_varint_and_key_schedule() {
+  uint8_t buffer[8];
+  for (uint64_t value : {0ull, 63ull, 64ull, 16383ull, 16384ull,
+                         1073741823ull, 1073741824ull, (1ull << 62) - 1}) {
+    uint8_t *end = write_varint(buffer, value);
+    ASSERT_EQ(varint_size(value), static_cast<size_t>(end - buffer));
+    const uint8_t *p = buffer;
+    uint64_t decoded = 0;
+    ASSERT_TRUE(read_varint(p, end, decoded));
+    ASSERT_EQ(value, decoded);
+  }
+
+  // RFC 9001 appendix A.1 client Initial secret
+  const uint8_t dcid[] = {0x83, 0x94, 0xc8, 0xf0, 0x3e, 0x51, 0x57, 0x08};
+  Key32 client;
+  Key32 server;
+  initial_secrets(dcid, sizeof(dcid), client, server);
+  const uint8_t expected[] = {0xc0, 0x0c, 0xf1, 0x51, 0xca, 0x5b, 0xe0, 0x75,
+                              0xed, 0x0e, 0xbf, 0xb5, 0xc8, 0x03, 0x23, 0xc4,
+                              0x2d, 0x6b, 0x7d, 0xb6, 0x78, 0x81, 0x28, 0x9a,
+                              0xf4, 0x00, 0x8f, 0x1f, 0x6c, 0x35, 0x7a, 0xea};
+  ASSERT_TRUE(std::equal(client.begin(), client.end(), expected));
+}
+
+void test_quic_handshake_and_streams() {
+  QuicPair pair(16);
+  pair.connect();
+  pair.run(4);
+  ASSERT_TRUE(pair.client->is_established());
+  ASSERT_TRUE(pair.server->is_established());
+  ASSERT_TRUE(pair.client->peer_identity() ==
+              pair.server_identity.public_key());
+  ASSERT_TRUE(pair.server->peer_identity() ==
+              pair.client_identity.public_key());
+  ASSERT_EQ(16u, pair.server->stream_quota());
+
+  // More streams than the quota: MAX_STREAMS keeps them flowing
+  for (size_t i = 0; i < 200; ++i) {
+    auto tx = test_transaction(i, 100 + i * 5);
+    pair.client->send_stream(tx.data(), tx.size());
+  }
+  pair.run(200);
+  auto streams = pair.received();
+  ASSERT_EQ(200u, streams.size());
+  for (const auto &stream : streams) {
+    ASSERT_TRUE(stream.data == test_transaction(stream.stream_id >> 2,
+                                                100 + (stream.stream_id >> 2) * 5));
+  }
+  ASSERT_EQ(0u, pair.client->unacknowledged_streams());
+}
+
+void test_quic_loss_recovery() {
+  QuicPair pair;
+  pair.connect();
+  // Lose every fourth datagram in both directions, handshake included
+  auto lossy = [](size_t n) { return n % 4 == 1; };
+  pair.run(400, lossy);
+  ASSERT_TRUE(pair.client->is_established());
+  for (size_t i = 0; i < 100; ++i) {
+    auto tx = test_transaction(i, MAX_TRANSACTION_SIZE);
+    pair.client->send_stream(tx.data(), tx.size());
+  }
+  pair.run(2000, lossy);
+  auto streams = pair.received();
+  ASSERT_EQ(100u, streams.size());
+  for (const auto &stream : streams) {
+    ASSERT_TRUE(stream.data ==
+                test_transaction(stream.stream_id >> 2, MAX_TRANSACTION_SIZE));
+  }
+  ASSERT_TRUE(pair.dropped > 0);
+  ASSERT_TRUE(pair.client->stats().packets_lost > 0);
+}
+
+void test_quic_zero_rtt_resumption() {
+  QuicPair pair;
+  pair.connect();
+  pair.run(10);
+  auto ticket = pair.client->take_ticket();
+  ASSERT_TRUE(ticket.has_value());
+
+  // Resumed connection: the transaction leaves with the first flight
+  pair.connect(&*ticket);
+  ASSERT_TRUE(pair.client->can_send_stream_data());
+  auto tx = test_transaction(1);
+  pair.client->send_stream(tx.data(), tx.size());
+  uint8_t buffer[MAX_DATAGRAM_SIZE];
+  size_t initial = pair.client->send(buffer, sizeof(buffer), pair.now);
+  size_t early = 0;
+  uint8_t early_buffer[MAX_DATAGRAM_SIZE];
+  early = pair.client->send(early_buffer, sizeof(early_buffer), pair.now);
+  ASSERT_TRUE(initial > 0);
+  ASSERT_TRUE(early > 0);
+  // Datagrams are decrypted in place; keep the wire bytes to replay
+  std::vector<uint8_t> captured_initial(buffer, buffer + initial);
+  std::vector<uint8_t> captured_early(early_buffer, early_buffer + early);
+  pair.server = Connection::accept(pair.server_identity, pair.config,
+                                   pair.policy, buffer + 6, CID_LENGTH,
+                                   pair.now);
+  pair.server->receive(buffer, initial, pair.now);
+  pair.server->receive(early_buffer, early, pair.now);
+  auto streams = pair.received();
+  ASSERT_EQ(1u, streams.size());
+  ASSERT_TRUE(streams[0].data == tx);
+  ASSERT_TRUE(pair.server->stats().early_data_accepted);
+  pair.run(10);
+  ASSERT_TRUE(pair.client->stats().early_data_accepted);
+  ASSERT_EQ(1u, pair.policy.replay_guard->size());
+
+  // Replaying the captured first flight delivers nothing: the ticket has
+  // already carried its 0-RTT data
+  auto replayed = Connection::accept(pair.server_identity, pair.config,
+                                     pair.policy, captured_initial.data() + 6,
+                                     CID_LENGTH, pair.now);
+  replayed->receive(captured_initial.data(), captured_initial.size(),
+                    pair.now);
+  replayed->receive(captured_early.data(), captured_early.size(), pair.now);
+  ASSERT_FALSE(replayed->stats().early_data_accepted);
+  ASSERT_FALSE(replayed->has_received());
+
+  // A ticket the server cannot decrypt: 0-RTT is rejected and the stream
+  // is resent once the handshake completes
+  pair.policy.ticket_key.fill(9);
+  pair.connect(&*ticket);
+  pair.client->send_stream(tx.data(), tx.size());
+  pair.run(20);
+  streams = pair.received();
+  ASSERT_EQ(1u, streams.size());
+  ASSERT_TRUE(streams[0].data == tx);
+  ASSERT_FALSE(pair.server->stats().early_data_accepted);
+  ASSERT_FALSE(pair.client->stats().early_data_accepted);
+}
+
+void test_quic_connection_refused() {
+  QuicPair pair(0);
+  pair.config.expected_server_identity = pair.server_identity.public_key();
+  pair.connect();
+  pair.run(5);
+  ASSERT_TRUE(pair.client->is_closed());
+  ASSERT_TRUE(pair.server->is_closed());
+
+  // Pinned server identity that does not match
+  QuicPair pinned;
+  pinned.config.expected_server_identity = Identity().public_key();
+  pinned.connect();
+  pinned.run(5);
+  ASSERT_TRUE(pinned.client->is_closed());
+}
+
 void run_network_tests(TestRunner &runner) {
   std::cout << "\n=== Network Tests ===" << std::endl;
 
@@ -701,6 +1187,11 @@ void run_network_tests(TestRunner &runner) {
   runner.run_test("RPC Unknown Method", test_rpc_unknown_method);
   runner.run_test("RPC Invalid JSON", test_rpc_invalid_json);
   runner.run_test("RPC Batch Requests", test_rpc_batch_requests);
+  runner.run_test("RPC JSON Tokenizer", test_rpc_json_tokenizer);
+  runner.run_test("RPC JSON Encoders", test_rpc_json_encoders);
+  runner.run_test("RPC Response Cache", test_rpc_response_cache);
+  runner.run_test("RPC Response Cache Coalescing",
+                  test_rpc_response_cache_coalescing);
   runner.run_test("Gossip Protocol Initialization",
                   test_gossip_protocol_initialization);
   runner.run_test("Gossip Protocol Start/Stop",
@@ -735,4 +1226,11 @@ void run_network_tests(TestRunner &runner) {
                   test_network_connection_pooling);
   runner.run_test("Network Protocol Version Negotiation",
                   test_network_protocol_version_negotiation);
+  runner.run_test("QUIC Varint and Key Schedule",
+                  test_quic_varint_and_key_schedule);
+  runner.run_test("QUIC Handshake and Streams",
+                  test_quic_handshake_and_streams);
+  runner.run_test("QUIC Loss Recovery", test_quic_loss_recovery);
+  runner.run_test("QUIC 0-RTT Resumption", test_quic_zero_rtt_resumption);
+  runner.run_test("QUIC Connection Refused", test_quic_connection_refused);
 }
\ No newline at end of file
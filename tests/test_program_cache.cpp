@@ -0,0 +1,210 @@
+#include "svm/advanced_program_cache.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace slonana::svm;
+
+namespace {
+
+/// A program of `length` mov64 r0, imm instructions
+std::vector<uint8_t> make_program(uint8_t imm, size_t length = 4) {
+  std::vector<uint8_t> code;
+  for (size_t i = 0; i < length; ++i) {
+    code.insert(code.end(), {0xb7, 0x00, 0x00, 0x00, imm, 0x00, 0x00, 0x00});
+  }
+  return code;
+}
+
+AdvancedProgramCache::Configuration quiet_config() {
+  AdvancedProgramCache::Configuration config;
+  config.enable_precompilation = false;
+  return config;
+}
+
+} // namespace
+
+bool test_slot_visibility() {
+  std::cout << "Testing per-slot program visibility..." << std::endl;
+
+  AdvancedProgramCache cache(quiet_config());
+  PublicKey program_id(32, 0x11);
+  auto v1 = make_program(1);
+  auto v2 = make_program(2);
+
+  assert(cache.cache_program(program_id, v1, 10));
+  // Not visible in the deployment slot itself
+  assert(!cache.get_program(program_id, 10));
+  assert(cache.get_statistics().delayed_visibility.load() == 1);
+  assert(cache.get_program(program_id, 11)->bytecode == v1);
+
+  // A redeploy only changes what later slots see
+  assert(cache.cache_program(program_id, v2, 20));
+  assert(cache.get_program(program_id, 15)->bytecode == v1);
+  assert(cache.get_program(program_id, 20)->bytecode == v1);
+  assert(cache.get_program(program_id, 21)->bytecode == v2);
+  assert(cache.get_statistics().total_programs.load() == 2);
+
+  // Once the redeploy is rooted, the old version is unreachable
+  cache.prune(25);
+  assert(cache.get_statistics().total_programs.load() == 1);
+  assert(!cache.get_program(program_id, 15));
+  assert(cache.get_program(program_id, 30)->bytecode == v2);
+
+  // Malformed bytecode is never cached
+  assert(!cache.cache_program(PublicKey(32, 0x12), {0xb7, 0x00}, 5));
+
+  cache.invalidate_program(program_id);
+  assert(!cache.get_program(program_id, 30));
+  assert(cache.get_statistics().total_programs.load() == 0);
+
+  std::cout << "✅ Per-slot program visibility test passed" << std::endl;
+  return true;
+}
+
+bool test_cooperative_loading() {
+  std::cout << "Testing cooperative program loading..." << std::endl;
+
+  AdvancedProgramCache cache(quiet_config());
+  PublicKey program_id(32, 0x21);
+  std::atomic<int> loader_calls{0};
+  AdvancedProgramCache::ProgramLoader loader = [&](const PublicKey &) {
+    loader_calls++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    return std::optional<AdvancedProgramCache::ProgramSource>(
+        AdvancedProgramCache::ProgramSource{make_program(7), 3});
+  };
+
+  const size_t thread_count = 8;
+  std::vector<std::shared_ptr<const CompiledProgram>> results(thread_count);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads.emplace_back(
+        [&, i] { results[i] = cache.get_or_load(program_id, 10, loader); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // One load, shared by every requester
+  assert(loader_calls == 1);
+  for (const auto &result : results) {
+    assert(result && result == results[0]);
+  }
+  assert(results[0]->deployment_slot == 3);
+  auto stats = cache.get_statistics();
+  assert(stats.loads.load() == 1);
+  assert(stats.cooperative_waits.load() + stats.cache_hits.load() ==
+         thread_count - 1);
+
+  // Loaded, but deployed too late for an earlier slot: no reload
+  assert(!cache.get_or_load(program_id, 3, loader));
+  assert(loader_calls == 1);
+
+  // Unknown programs are not cached
+  AdvancedProgramCache::ProgramLoader missing = [](const PublicKey &) {
+    return std::optional<AdvancedProgramCache::ProgramSource>();
+  };
+  assert(!cache.get_or_load(PublicKey(32, 0x22), 10, missing));
+
+  std::cout << "✅ Cooperative program loading test passed" << std::endl;
+  return true;
+}
+
+bool test_tier_promotion() {
+  std::cout << "Testing tiered program promotion..." << std::endl;
+
+  AdvancedProgramCache::Configuration config;
+  config.decode_threshold = 2;
+  config.jit_threshold = 5;
+  AdvancedProgramCache cache(config);
+  PublicKey program_id(32, 0x31);
+  assert(cache.cache_program(program_id, make_program(9), 0));
+
+  auto wait_for_tier = [&](ProgramTier tier) {
+    for (int i = 0; i < 200; ++i) {
+      auto program = cache.get_program(program_id, 1);
+      if (program->tier == tier) {
+        return program;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return std::shared_ptr<const CompiledProgram>();
+  };
+
+  assert(cache.get_program(program_id, 1)->tier == ProgramTier::VERIFIED);
+  auto decoded = wait_for_tier(ProgramTier::DECODED);
+  assert(decoded);
+  assert(decoded->decoded_ops.size() == 4);
+  assert(decoded->decoded_ops[0].opcode == 0xb7);
+  assert(decoded->decoded_ops[0].immediate == 9);
+
+  auto jit = wait_for_tier(ProgramTier::JIT);
+  assert(jit);
+  assert(!jit->compiled_code.empty());
+  assert(jit->execution_count.load() >= 5);
+
+  // Per-tier hit rates add up to the overall hit rate
+  auto stats = cache.get_statistics();
+  assert(stats.compilations.load() == 1);
+  assert(stats.tier_hits[static_cast<size_t>(ProgramTier::VERIFIED)].load() > 0);
+  assert(stats.tier_hits[static_cast<size_t>(ProgramTier::JIT)].load() > 0);
+  double tiers = stats.get_tier_hit_rate(ProgramTier::VERIFIED) +
+                 stats.get_tier_hit_rate(ProgramTier::DECODED) +
+                 stats.get_tier_hit_rate(ProgramTier::JIT);
+  assert(tiers > stats.get_hit_rate() - 1e-9 &&
+         tiers < stats.get_hit_rate() + 1e-9);
+
+  std::cout << "✅ Tiered program promotion test passed" << std::endl;
+  return true;
+}
+
+bool test_clock_eviction() {
+  std::cout << "Testing clock eviction..." << std::endl;
+
+  auto config = quiet_config();
+  config.max_cache_size = 10;
+  config.eviction_threshold = 1.0;
+  AdvancedProgramCache cache(config);
+
+  for (uint8_t i = 0; i < 9; ++i) {
+    assert(cache.cache_program(PublicKey(32, i), make_program(i), 0));
+  }
+  // Fresh inserts start referenced, so a GC pass only clears their bits
+  cache.garbage_collect();
+  assert(cache.get_statistics().total_programs.load() == 9);
+  assert(cache.get_program(PublicKey(32, 4), 1));
+
+  // The tenth insert triggers a sweep; the touched program survives it
+  assert(cache.cache_program(PublicKey(32, 9), make_program(9), 0));
+  auto stats = cache.get_statistics();
+  assert(stats.evictions.load() >= 1);
+  assert(stats.total_programs.load() < 10);
+  assert(cache.get_program(PublicKey(32, 4), 1));
+
+  std::cout << "✅ Clock eviction test passed" << std::endl;
+  return true;
+}
+
+int main() {
+  std::cout << "=== Program Cache Test Suite ===" << std::endl;
+
+  try {
+    assert(test_slot_visibility());
+    assert(test_cooperative_loading());
+    assert(test_tier_promotion());
+    assert(test_clock_eviction());
+
+    std::cout << "\n🎉 All program cache tests passed!" << std::endl;
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "❌ Test failed with unknown exception" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,358 @@
+#include "network/gossip/crypto_utils.h"
+#include "svm/syscalls.h"
+#include "validator/replay_stage.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <openssl/evp.h>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace slonana::validator;
+using slonana::network::gossip::CryptoUtils;
+namespace ledger = slonana::ledger;
+namespace svm = slonana::svm;
+
+namespace {
+
+struct Keypair {
+  std::vector<uint8_t> seed;
+  PublicKey pubkey;
+};
+
+Keypair keypair(uint8_t id) {
+  Keypair result;
+  result.seed.assign(32, id);
+  EVP_PKEY *key = EVP_PKEY_new_raw_private_key(EVP_PKEY_ED25519, nullptr,
+                                               result.seed.data(), 32);
+  result.pubkey.resize(32);
+  size_t length = 32;
+  EVP_PKEY_get_raw_public_key(key, result.pubkey.data(), &length);
+  EVP_PKEY_free(key);
+  return result;
+}
+
+/// A signed legacy System Program transfer; `nonce` varies the blockhash
+ledger::Transaction transfer(const Keypair &from, const PublicKey &to,
+                             uint64_t lamports, uint64_t nonce) {
+  ledger::Transaction transaction;
+  auto &message = transaction.message;
+  message = {1, 0, 1, 3}; // One signer, the program read-only; three keys
+  message.insert(message.end(), from.pubkey.begin(), from.pubkey.end());
+  message.insert(message.end(), to.begin(), to.end());
+  message.insert(message.end(), 32, 0); // System Program
+  for (size_t i = 0; i < 32; ++i) {
+    message.push_back(static_cast<uint8_t>(nonce >> (8 * (i % 8))));
+  }
+  message.insert(message.end(), {1, 2, 2, 0, 1, 12, 2, 0, 0, 0});
+  for (size_t i = 0; i < 8; ++i) {
+    message.push_back(static_cast<uint8_t>(lamports >> (8 * i)));
+  }
+  transaction.signatures.push_back(
+      CryptoUtils::sign_ed25519(message, from.seed));
+  return transaction;
+}
+
+Hash genesis_hash() { return Hash(32, 0x6e); }
+
+std::shared_ptr<ReplayBank> genesis(const std::vector<Keypair> &payers,
+                                    uint64_t lamports) {
+  std::vector<std::pair<PublicKey, uint64_t>> accounts;
+  for (const auto &payer : payers) {
+    accounts.emplace_back(payer.pubkey, lamports);
+  }
+  return ReplayBank::genesis(accounts, genesis_hash());
+}
+
+ReplayStage::Config config(size_t workers) {
+  ReplayStage::Config result;
+  result.worker_threads = workers;
+  return result;
+}
+
+} // namespace
+
+bool test_entries_and_parsing() {
+  std::cout << "Testing replay entries and message decoding..." << std::endl;
+
+  auto alice = keypair(1);
+  PublicKey bob(32, 0xb0);
+  std::vector<ledger::Transaction> transactions;
+  for (uint64_t i = 0; i < 5; ++i) {
+    transactions.push_back(transfer(alice, bob, 10 + i, i));
+  }
+  auto slot = ReplaySlot::record(1, 0, genesis_hash(), transactions, 2, 4);
+
+  // Three entries of at most two transactions, then a tick
+  assert(slot.entries.size() == 4);
+  assert(slot.entries[0].transactions.size() == 2);
+  assert(slot.entries[2].transactions.size() == 1);
+  assert(slot.entries[3].transactions.empty());
+  Hash previous = genesis_hash();
+  for (const auto &entry : slot.entries) {
+    assert(entry.num_hashes == 4);
+    assert(ReplayEntry::next_hash(previous, 4, entry.transactions) ==
+           entry.hash);
+    previous = entry.hash;
+  }
+  assert(slot.last_hash() == previous);
+
+  auto parsed = ReplayTransaction::parse(transactions[0]);
+  assert(parsed);
+  assert(parsed->required_signatures == 1);
+  assert(parsed->account_keys.size() == 3);
+  assert(parsed->writable == std::vector<bool>({true, true, false}));
+  assert(parsed->instructions.size() == 1);
+  assert(parsed->instructions[0].accounts[1] == bob);
+  assert(parsed->instructions[0].data.size() == 12);
+
+  // A key listed twice cannot be locked
+  auto twice = transactions[0];
+  std::copy(alice.pubkey.begin(), alice.pubkey.end(),
+            twice.message.begin() + 4 + 32);
+  assert(!ReplayTransaction::parse(twice));
+
+  std::cout << "✅ Replay entries and message decoding test passed"
+            << std::endl;
+  return true;
+}
+
+bool test_parallel_matches_sequential() {
+  std::cout << "Testing parallel replay matches sequential execution..."
+            << std::endl;
+
+  std::vector<Keypair> payers;
+  for (uint8_t i = 1; i <= 16; ++i) {
+    payers.push_back(keypair(i));
+  }
+  const uint64_t fee = ReplayStage::Config{}.lamports_per_signature;
+
+  // Transfers among the payers and a few hot recipients, some of them
+  // larger than the sender's balance
+  std::mt19937_64 rng(7);
+  std::vector<ReplaySlot> slots;
+  Hash start = genesis_hash();
+  uint64_t nonce = 0;
+  for (Slot s = 1; s <= 4; ++s) {
+    std::vector<ledger::Transaction> transactions;
+    for (size_t i = 0; i < 150; ++i) {
+      const auto &from = payers[rng() % payers.size()];
+      PublicKey to = rng() % 3 == 0 ? PublicKey(32, 0xe0 + rng() % 2)
+                                    : payers[rng() % payers.size()].pubkey;
+      if (to == from.pubkey) {
+        to = PublicKey(32, 0xe2);
+      }
+      transactions.push_back(
+          transfer(from, to, 1000 + rng() % 400000, nonce++));
+    }
+    slots.push_back(ReplaySlot::record(s, s - 1, start, transactions, 16));
+    start = slots.back().last_hash();
+  }
+
+  // Reference: a plain loop over balances
+  std::map<PublicKey, uint64_t> balances;
+  for (const auto &payer : payers) {
+    balances[payer.pubkey] = 1000000;
+  }
+  std::vector<svm::ExecutionResult> expected;
+  for (const auto &slot : slots) {
+    for (const auto &entry : slot.entries) {
+      for (const auto &transaction : entry.transactions) {
+        auto parsed = ReplayTransaction::parse(transaction);
+        const auto &from = parsed->account_keys[0];
+        const auto &to = parsed->account_keys[1];
+        uint64_t amount = 0;
+        for (size_t i = 0; i < 8; ++i) {
+          amount |= uint64_t(parsed->instructions[0].data[4 + i]) << (8 * i);
+        }
+        if (balances[from] < fee) {
+          expected.push_back(svm::ExecutionResult::INSUFFICIENT_FUNDS);
+          continue;
+        }
+        balances[from] -= fee;
+        if (balances[from] < amount) {
+          expected.push_back(svm::ExecutionResult::INSUFFICIENT_FUNDS);
+          continue;
+        }
+        balances[from] -= amount;
+        balances[to] += amount;
+        expected.push_back(svm::ExecutionResult::SUCCESS);
+      }
+    }
+  }
+
+  std::vector<Hash> bank_hashes;
+  for (size_t workers : {1, 2, 4, 8}) {
+    ReplayStage stage(genesis(payers, 1000000), config(workers));
+    size_t index = 0;
+    for (const auto &slot : slots) {
+      auto result = stage.replay_slot(slot);
+      assert(!result.dead);
+      assert(result.bank->is_frozen());
+      for (const auto &status : result.statuses) {
+        assert(status.result == expected[index++]);
+      }
+    }
+    assert(index == expected.size());
+    auto tip = stage.bank(4);
+    for (const auto &[key, lamports] : balances) {
+      assert(tip->get_balance(key) == lamports);
+    }
+    bank_hashes.push_back(tip->hash());
+
+    auto &stats = stage.get_statistics();
+    assert(stats.slots_replayed.load() == 4);
+    assert(stats.transactions_executed.load() == 600);
+    assert(stats.signatures_verified.load() == 600);
+    assert(stats.lock_waits.load() > 0);
+  }
+  for (const auto &hash : bank_hashes) {
+    assert(hash == bank_hashes[0]);
+  }
+
+  std::cout << "✅ Parallel replay matches sequential execution test passed"
+            << std::endl;
+  return true;
+}
+
+bool test_dead_slots() {
+  std::cout << "Testing dead slot detection..." << std::endl;
+
+  auto alice = keypair(1);
+  PublicKey bob(32, 0xb0);
+  auto make_slot = [&](Slot slot, Slot parent, const Hash &start) {
+    std::vector<ledger::Transaction> transactions;
+    for (uint64_t i = 0; i < 40; ++i) {
+      transactions.push_back(transfer(alice, bob, 1, slot * 100 + i));
+    }
+    return ReplaySlot::record(slot, parent, start, transactions, 8);
+  };
+
+  ReplayStage stage(genesis({alice}, 1000000000), config(4));
+  auto good = make_slot(1, 0, genesis_hash());
+
+  auto bad_poh = good;
+  bad_poh.entries[2].hash[0] ^= 1;
+  auto result = stage.replay_slot(bad_poh);
+  assert(result.dead);
+  assert(result.error == "PoH hash mismatch at entry 2");
+  assert(!stage.bank(1));
+
+  // A forged signature, re-recorded so the PoH chain itself is sound
+  auto forged = good;
+  std::vector<ledger::Transaction> transactions;
+  for (const auto &entry : forged.entries) {
+    transactions.insert(transactions.end(), entry.transactions.begin(),
+                        entry.transactions.end());
+  }
+  transactions[17].signatures[0][5] ^= 1;
+  forged = ReplaySlot::record(1, 0, genesis_hash(), transactions, 8);
+  result = stage.replay_slot(forged);
+  assert(result.dead);
+  assert(result.error == "Invalid signature in entry 2");
+
+  // Unknown parent and a start hash that does not follow the parent
+  assert(stage.replay_slot(make_slot(3, 2, genesis_hash())).dead);
+  assert(stage.replay_slot(make_slot(1, 0, Hash(32, 1))).dead);
+
+  result = stage.replay_slot(good);
+  assert(!result.dead);
+  assert(stage.bank(1)->get_balance(bob) == 40);
+  assert(stage.get_statistics().dead_slots.load() == 4);
+
+  std::cout << "✅ Dead slot detection test passed" << std::endl;
+  return true;
+}
+
+bool test_concurrent_forks() {
+  std::cout << "Testing concurrent fork replay..." << std::endl;
+
+  auto alice = keypair(1);
+  auto carol = keypair(2);
+  PublicKey bob(32, 0xb0);
+  ReplayStage stage(genesis({alice, carol}, 1000000000), config(4));
+
+  // Syscalls see the Clock of the bank each transaction runs in
+  std::mutex clock_mutex;
+  std::set<Slot> clock_slots;
+  stage.set_processor([&](const ReplayTransaction &transaction,
+                          std::vector<svm::ProgramAccount> &accounts) {
+    uint8_t clock[40];
+    uint64_t length = 0;
+    assert(svm::sol_get_clock_sysvar(clock, &length) == 0);
+    Slot slot = 0;
+    std::memcpy(&slot, clock, sizeof(slot));
+    {
+      std::lock_guard<std::mutex> lock(clock_mutex);
+      clock_slots.insert(slot);
+    }
+    return ReplayStage::process_system_transfers(transaction, accounts);
+  });
+
+  auto record = [&](Slot slot, Slot parent, const Hash &start,
+                    const Keypair &from, uint64_t lamports) {
+    std::vector<ledger::Transaction> transactions;
+    for (uint64_t i = 0; i < 20; ++i) {
+      transactions.push_back(transfer(from, bob, lamports, slot * 100 + i));
+    }
+    return ReplaySlot::record(slot, parent, start, transactions, 4);
+  };
+
+  // 1 <- {2 <- 4, 3}; 5 hangs off a slot that never arrives
+  auto s1 = record(1, 0, genesis_hash(), alice, 1);
+  auto s2 = record(2, 1, s1.last_hash(), alice, 10);
+  auto s3 = record(3, 1, s1.last_hash(), carol, 100);
+  auto s4 = record(4, 2, s2.last_hash(), carol, 1000);
+  auto s5 = record(5, 9, s2.last_hash(), carol, 1000);
+  auto results = stage.replay_slots({s4, s3, s5, s2, s1});
+
+  assert(!results[0].dead && !results[1].dead && !results[3].dead &&
+         !results[4].dead);
+  assert(results[2].dead);
+  assert(stage.bank(2)->get_balance(bob) == 220);
+  assert(stage.bank(3)->get_balance(bob) == 2020);
+  assert(stage.bank(4)->get_balance(bob) == 20220);
+  assert(stage.bank(4)->parent() == stage.bank(2));
+  assert(stage.bank(3)->get_balance(alice.pubkey) ==
+         1000000000 - 20 - 20 * 5000);
+  assert(stage.bank(2)->hash() != stage.bank(3)->hash());
+  assert((clock_slots == std::set<Slot>{1, 2, 3, 4}));
+
+  // Each bank snapshots its sysvars; the builtins are served from them
+  auto clock_key = svm::builtin_account_key(svm::BuiltinAccount::CLOCK_SYSVAR);
+  assert(stage.bank(4)->sysvars()->clock().slot == 4);
+  assert(stage.bank(4)->get_account(clock_key)->data ==
+         stage.bank(4)->sysvars()->data(svm::BuiltinAccount::CLOCK_SYSVAR));
+  assert(stage.bank(3)->get_account(PublicKey(32, 0))->executable);
+
+  // Rooting slot 2 drops the fork through 3
+  stage.set_root(2);
+  assert(stage.bank(2) && stage.bank(4));
+  assert(!stage.bank(1) && !stage.bank(3));
+
+  std::cout << "✅ Concurrent fork replay test passed" << std::endl;
+  return true;
+}
+
+int main() {
+  std::cout << "=== Replay Stage Test Suite ===" << std::endl;
+
+  try {
+    assert(test_entries_and_parsing());
+    assert(test_parallel_matches_sequential());
+    assert(test_dead_slots());
+    assert(test_concurrent_forks());
+
+    std::cout << "\n🎉 All replay stage tests passed!" << std::endl;
+    return 0;
+  } catch (const std::exception &e) {
+    std::cerr << "❌ Test failed with exception: " << e.what() << std::endl;
+    return 1;
+  } catch (...) {
+    std::cerr << "❌ Test failed with unknown exception" << std::endl;
+    return 1;
+  }
+}
@@ -1,11 +1,21 @@
 #include "test_framework.h"
 #include "validator/snapshot.h"
+#include "validator/snapshot_archive.h"
+#include "validator/snapshot_restore_pipeline.h"
+#include "storage/accounts_db.h"
+#include "storage/accounts_hash.h"
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
 #include <thread>
 
-// Forward declaration for bootstrap tests
+// Forward declarations for bootstrap and downloader tests
 void run_snapshot_bootstrap_tests();
+void run_snapshot_downloader_tests();
 
 using namespace slonana::validator;
 using namespace slonana::common;
@@ -358,6 +368,579 @@ void test_snapshot_statistics() {
   std::cout << "PASSED (0ms)" << std::endl;
 }
 
+void test_snapshot_archive() {
+  std::cout << "Running test: Snapshot Archive... ";
+
+  std::string test_dir = "/tmp/test_snapshot_archive";
+  std::filesystem::remove_all(test_dir);
+  std::filesystem::create_directories(test_dir);
+  std::string path = test_dir + "/accounts.archive";
+
+  // Accounts in pubkey order with a mix of empty and large data
+  std::mt19937_64 rng(7);
+  std::vector<AccountSnapshot> accounts(5000);
+  for (size_t i = 0; i < accounts.size(); ++i) {
+    auto &account = accounts[i];
+    account.pubkey.assign(32, 0);
+    for (size_t b = 0; b < 8; ++b) {
+      account.pubkey[b] = static_cast<uint8_t>(i >> (8 * (7 - b)));
+    }
+    account.lamports = rng();
+    account.data.resize(i % 7 == 0 ? 0 : rng() % 2048);
+    for (auto &byte : account.data) {
+      byte = static_cast<uint8_t>(rng() % 16); // Compressible
+    }
+    account.owner.assign(32, static_cast<uint8_t>(i % 3));
+    account.executable = i % 11 == 0;
+    account.rent_epoch = i;
+  }
+  std::vector<uint8_t> header = {1, 2, 3, 4};
+
+  for (auto codec : {SnapshotCodec::NONE, SnapshotCodec::ZSTD,
+                     SnapshotCodec::LZ4}) {
+    SnapshotArchiveWriter::Options options;
+    options.codec = codec;
+    options.chunk_size = 64 * 1024;
+    options.threads = 4;
+    SnapshotArchiveWriter writer(options);
+    ASSERT_TRUE(writer.open(path, header));
+    ASSERT_TRUE(writer.codec() ==
+                (snapshot_codec_available(codec) ? codec : SnapshotCodec::NONE));
+    for (const auto &account : accounts) {
+      ASSERT_TRUE(writer.add(account));
+    }
+    std::vector<uint8_t> final_header = {9, 8, 7, 6};
+    ASSERT_TRUE(writer.finish(&final_header));
+
+    SnapshotArchiveReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_TRUE(reader.header() == final_header);
+    ASSERT_EQ(accounts.size(), reader.account_count());
+    ASSERT_GT(reader.chunks().size(), 10u);
+    ASSERT_TRUE(reader.is_partitioned());
+    ASSERT_TRUE(reader.verify(4));
+
+    // Parallel decode returns every chunk intact and in its key range
+    std::vector<std::vector<AccountSnapshot>> chunks(reader.chunks().size());
+    ASSERT_TRUE(reader.for_each_chunk(
+        [&](const ChunkIndexEntry &entry, std::vector<AccountSnapshot> &batch) {
+          chunks[entry.header.chunk_index] = std::move(batch);
+          return true;
+        },
+        4));
+    size_t next = 0;
+    for (const auto &chunk : chunks) {
+      for (const auto &account : chunk) {
+        const auto &expected = accounts[next++];
+        ASSERT_TRUE(account.pubkey == expected.pubkey);
+        ASSERT_EQ(expected.lamports, account.lamports);
+        ASSERT_TRUE(account.data == expected.data);
+        ASSERT_TRUE(account.owner == expected.owner);
+        ASSERT_EQ(expected.executable, account.executable);
+        ASSERT_EQ(expected.rent_epoch, account.rent_epoch);
+      }
+    }
+    ASSERT_EQ(accounts.size(), next);
+
+    auto found = reader.find_account(accounts[4321].pubkey);
+    ASSERT_TRUE(found.has_value());
+    ASSERT_EQ(accounts[4321].lamports, found->lamports);
+    ASSERT_FALSE(reader.find_account(PublicKey(32, 0xEE)).has_value());
+  }
+
+  // A flipped payload byte fails that chunk's hash
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    SnapshotArchiveReader reader;
+    ASSERT_TRUE(reader.open(path));
+    auto at = reader.chunks()[3].offset + snapshot_archive::FRAME_HEADER_SIZE;
+    file.seekg(at);
+    char byte = static_cast<char>(file.get());
+    file.seekp(at);
+    file.put(static_cast<char>(~byte));
+  }
+  SnapshotArchiveReader reader;
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_FALSE(reader.verify(2));
+  std::vector<AccountSnapshot> chunk;
+  ASSERT_TRUE(reader.read_chunk(2, chunk));
+  ASSERT_FALSE(reader.read_chunk(3, chunk));
+
+  // Anything else is not an archive
+  ASSERT_FALSE(reader.open(test_dir + "/missing"));
+  {
+    std::ofstream junk(test_dir + "/junk", std::ios::binary);
+    junk << "not a snapshot archive at all, just some bytes";
+  }
+  ASSERT_FALSE(reader.open(test_dir + "/junk"));
+
+  std::filesystem::remove_all(test_dir);
+  std::cout << "PASSED (0ms)" << std::endl;
+}
+
+void test_snapshot_restore_pipeline() {
+  std::cout << "Running test: Snapshot Restore Pipeline... ";
+
+  std::string test_dir = "/tmp/test_snapshot_restore_pipeline";
+  std::filesystem::remove_all(test_dir);
+  std::filesystem::create_directories(test_dir);
+  std::string path = test_dir + "/accounts.archive";
+
+  std::mt19937_64 rng(37);
+  std::map<PublicKey, uint64_t> expected;
+  SnapshotArchiveWriter::Options options;
+  options.codec = snapshot_codec_available(SnapshotCodec::ZSTD)
+                      ? SnapshotCodec::ZSTD
+                      : SnapshotCodec::NONE;
+  options.chunk_size = 32 * 1024;
+  options.threads = 2;
+  SnapshotArchiveWriter writer(options);
+  ASSERT_TRUE(writer.open(path, {5, 5, 5}));
+  for (uint64_t i = 0; i < 4000; ++i) {
+    AccountSnapshot account;
+    account.pubkey.assign(32, 0);
+    for (size_t b = 0; b < 8; ++b) {
+      account.pubkey[b] = static_cast<uint8_t>(i >> (8 * (7 - b)));
+    }
+    account.lamports = rng();
+    account.data.resize(rng() % 512);
+    account.owner.assign(32, 1);
+    account.executable = false;
+    account.rent_epoch = i;
+    expected[account.pubkey] = account.lamports;
+    ASSERT_TRUE(writer.add(std::move(account)));
+  }
+  ASSERT_TRUE(writer.finish());
+
+  // Collects restored accounts; the insert stage may run on several threads
+  std::mutex restored_mutex;
+  std::map<PublicKey, uint64_t> restored;
+  auto collect = [&](const ChunkFrameHeader &,
+                     std::vector<AccountSnapshot> &accounts) {
+    std::lock_guard<std::mutex> lock(restored_mutex);
+    for (const auto &account : accounts) {
+      restored[account.pubkey] = account.lamports;
+    }
+    return true;
+  };
+
+  SnapshotArchiveReader reader;
+  ASSERT_TRUE(reader.open(path));
+  SnapshotRestorePipeline::Options pipeline_options;
+  pipeline_options.decompress_threads = 2;
+  pipeline_options.deserialize_threads = 2;
+  pipeline_options.insert_threads = 2;
+  {
+    SnapshotRestorePipeline pipeline(collect, pipeline_options);
+    ASSERT_TRUE(pipeline.restore_file(reader));
+    auto stats = pipeline.statistics();
+    ASSERT_EQ(reader.chunks().size(), stats.chunks);
+    ASSERT_EQ(4000u, stats.accounts);
+    ASSERT_EQ(reader.chunks().size(), stats.decompress.chunks);
+    ASSERT_EQ(reader.chunks().size(), stats.deserialize.chunks);
+    ASSERT_TRUE(restored == expected);
+  }
+
+  // The same archive arriving as a byte stream in odd-sized pieces
+  std::vector<uint8_t> bytes;
+  {
+    std::ifstream file(path, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), {});
+  }
+  restored.clear();
+  {
+    SnapshotRestorePipeline pipeline(collect, pipeline_options);
+    pipeline.start();
+    SnapshotFrameStream stream(
+        [&](const ChunkFrameHeader &header, std::vector<uint8_t> payload) {
+          return pipeline.push_frame(header, std::move(payload));
+        });
+    for (size_t offset = 0; offset < bytes.size(); offset += 997) {
+      ASSERT_TRUE(stream.feed(bytes.data() + offset,
+                              std::min<size_t>(997, bytes.size() - offset)));
+    }
+    ASSERT_TRUE(pipeline.finish());
+    ASSERT_TRUE(stream.complete());
+    ASSERT_TRUE(stream.header() == std::vector<uint8_t>({5, 5, 5}));
+    ASSERT_EQ(reader.chunks().size(), stream.frames());
+    ASSERT_TRUE(restored == expected);
+  }
+
+  // A one-deep queue in front of a slow sink holds the producer back
+  {
+    pipeline_options.queue_depth = 1;
+    pipeline_options.insert_threads = 1;
+    SnapshotRestorePipeline pipeline(
+        [](const ChunkFrameHeader &, std::vector<AccountSnapshot> &) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          return true;
+        },
+        pipeline_options);
+    ASSERT_TRUE(pipeline.restore_file(reader));
+    ASSERT_GT(pipeline.statistics().source_blocked_seconds, 0.0);
+  }
+
+  // A rejecting sink or a corrupt frame stops the restore
+  {
+    SnapshotRestorePipeline pipeline(
+        [](const ChunkFrameHeader &header, std::vector<AccountSnapshot> &) {
+          return header.chunk_index != 3;
+        },
+        pipeline_options);
+    ASSERT_FALSE(pipeline.restore_file(reader));
+    ASSERT_FALSE(pipeline.error().empty());
+  }
+  {
+    size_t at = reader.chunks()[2].offset + snapshot_archive::FRAME_HEADER_SIZE;
+    bytes[at] = static_cast<uint8_t>(~bytes[at]);
+    SnapshotRestorePipeline pipeline(collect, pipeline_options);
+    pipeline.start();
+    SnapshotFrameStream stream(
+        [&](const ChunkFrameHeader &header, std::vector<uint8_t> payload) {
+          return pipeline.push_frame(header, std::move(payload));
+        });
+    stream.feed(bytes.data(), bytes.size());
+    ASSERT_FALSE(pipeline.finish());
+  }
+
+  // SnapshotManager restores through the pipeline into an AccountsDB
+  {
+    SnapshotManager manager(test_dir + "/manager");
+    std::string ledger = test_dir + "/ledger";
+    std::filesystem::create_directories(ledger);
+    ASSERT_TRUE(manager.create_full_snapshot(3000, ledger));
+    std::string snapshot_path =
+        test_dir + "/manager/snapshot-000000003000.snapshot";
+    auto accounts_db = std::make_shared<slonana::storage::AccountsDB>();
+    manager.set_accounts_db(accounts_db);
+    ASSERT_TRUE(manager.restore_from_snapshot(snapshot_path, ledger));
+    auto accounts = manager.load_accounts_from_snapshot(snapshot_path);
+    ASSERT_GT(accounts.size(), 0u);
+    ASSERT_EQ(accounts.size(), accounts_db->get_account_count());
+    auto stored = accounts_db->load_account(accounts.front().pubkey);
+    ASSERT_TRUE(stored.has_value());
+    ASSERT_EQ(accounts.front().lamports, stored->lamports);
+
+    // The same archive restored from bytes as they would arrive from a
+    // download, then a truncated and a garbage stream
+    std::vector<uint8_t> archive;
+    {
+      std::ifstream file(snapshot_path, std::ios::binary);
+      archive.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    auto streamed_db = std::make_shared<slonana::storage::AccountsDB>();
+    SnapshotManager streaming(test_dir + "/streaming");
+    streaming.set_accounts_db(streamed_db);
+    auto restore = streaming.begin_streaming_restore();
+    for (size_t offset = 0; offset < archive.size(); offset += 4093) {
+      ASSERT_TRUE(restore->feed(archive.data() + offset,
+                                std::min<size_t>(4093, archive.size() - offset)));
+    }
+    ASSERT_TRUE(restore->finish());
+    ASSERT_EQ(accounts.size(), streamed_db->get_account_count());
+    ASSERT_EQ(accounts.front().lamports,
+              streamed_db->load_account(accounts.front().pubkey)->lamports);
+
+    auto truncated = streaming.begin_streaming_restore();
+    ASSERT_TRUE(truncated->feed(archive.data(), archive.size() / 2));
+    ASSERT_FALSE(truncated->finish());
+    std::vector<uint8_t> garbage(4096, 0xFF);
+    auto rejected = streaming.begin_streaming_restore();
+    ASSERT_FALSE(rejected->feed(garbage.data(), garbage.size()));
+    ASSERT_FALSE(rejected->finish());
+  }
+
+  std::filesystem::remove_all(test_dir);
+  std::cout << "PASSED (0ms)" << std::endl;
+}
+
+void test_incremental_snapshot_from_accounts_db() {
+  std::cout << "Running test: Incremental Snapshot From AccountsDB... ";
+
+  using slonana::storage::AccountData;
+  using slonana::storage::AccountsDB;
+  using slonana::storage::ModifiedAccount;
+
+  std::string test_dir = "/tmp/test_incremental_accounts_db";
+  std::filesystem::remove_all(test_dir);
+  std::string ledger = test_dir + "/ledger";
+  std::filesystem::create_directories(ledger);
+
+  auto make_key = [](uint32_t i) {
+    PublicKey key(32, 0);
+    key[0] = 0x11;
+    key[28] = static_cast<uint8_t>(i >> 24);
+    key[29] = static_cast<uint8_t>(i >> 16);
+    key[30] = static_cast<uint8_t>(i >> 8);
+    key[31] = static_cast<uint8_t>(i);
+    return key;
+  };
+  auto make_account = [](uint64_t lamports) {
+    AccountData data;
+    data.lamports = lamports;
+    data.data.assign(16, static_cast<uint8_t>(lamports));
+    data.owner.assign(32, 0x02);
+    return data;
+  };
+
+  auto db = std::make_shared<AccountsDB>();
+  for (uint32_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(db->store_account(make_key(i), make_account(1000 + i), 10));
+  }
+  // Nothing is tracked until a snapshot manager attaches
+  ASSERT_FALSE(db->is_dirty_tracking());
+  ASSERT_EQ(0u, db->get_dirty_slot_count());
+
+  SnapshotManager manager(test_dir + "/snapshots");
+  manager.set_accounts_db(db);
+  ASSERT_TRUE(db->is_dirty_tracking());
+  ASSERT_TRUE(manager.create_full_snapshot(10, ledger));
+  ASSERT_EQ(0u, db->get_dirty_slot_count());
+
+  // Changes inside (10, 25], plus one after the incremental's slot
+  for (uint32_t i = 0; i < 5; ++i) {
+    ASSERT_TRUE(db->store_account(make_key(i), make_account(5000 + i), 12));
+  }
+  ASSERT_TRUE(db->store_account(make_key(0), make_account(7000), 18));
+  ASSERT_TRUE(db->delete_account(make_key(50), 15));
+  ASSERT_TRUE(db->delete_account(make_key(51), 15));
+  for (uint32_t i = 100; i < 103; ++i) {
+    ASSERT_TRUE(db->store_account(make_key(i), make_account(9000 + i), 20));
+  }
+  ASSERT_TRUE(db->store_account(make_key(60), make_account(8000), 30));
+
+  std::vector<ModifiedAccount> modified;
+  ASSERT_TRUE(db->collect_modified_accounts(10, 25, modified));
+  ASSERT_EQ(10u, modified.size());
+  // Dirty sets at or before the full snapshot are gone
+  ASSERT_FALSE(db->collect_modified_accounts(5, 25, modified));
+
+  ASSERT_TRUE(manager.create_incremental_snapshot(25, 10, ledger));
+  std::string full_path =
+      test_dir + "/snapshots/snapshot-000000000010.snapshot";
+  std::string incremental_path =
+      test_dir + "/snapshots/snapshot-000000000025-incremental-000000000010"
+                 ".snapshot";
+  auto accounts = manager.load_accounts_from_snapshot(incremental_path);
+  ASSERT_EQ(10u, accounts.size());
+  std::map<PublicKey, AccountSnapshot> by_key;
+  for (const auto &account : accounts) {
+    by_key[account.pubkey] = account;
+  }
+  ASSERT_EQ(7000u, by_key[make_key(0)].lamports); // Latest write in range
+  ASSERT_EQ(5004u, by_key[make_key(4)].lamports);
+  ASSERT_EQ(0u, by_key[make_key(50)].lamports); // Tombstone
+  ASSERT_TRUE(by_key[make_key(51)].data.empty());
+  ASSERT_EQ(9102u, by_key[make_key(102)].lamports);
+  ASSERT_TRUE(by_key.count(make_key(60)) == 0); // Written after slot 25
+
+  // Full + incremental rebuild the state at slot 25
+  auto restored = std::make_shared<AccountsDB>();
+  SnapshotManager restorer(test_dir + "/restore");
+  restorer.set_accounts_db(restored);
+  ASSERT_TRUE(restorer.restore_from_snapshot(full_path, ledger));
+  ASSERT_TRUE(restorer.restore_from_snapshot(incremental_path, ledger));
+  ASSERT_EQ(7000u, restored->load_account(make_key(0))->lamports);
+  ASSERT_EQ(1099u, restored->load_account(make_key(99))->lamports);
+  ASSERT_EQ(9100u, restored->load_account(make_key(100))->lamports);
+  ASSERT_FALSE(restored->load_account(make_key(50)).has_value());
+  ASSERT_FALSE(restored->load_account(make_key(51)).has_value());
+  ASSERT_EQ(1060u, restored->load_account(make_key(60))->lamports);
+
+  // A version in range that was since trimmed fails the incremental rather
+  // than silently leaving the account out
+  AccountsDB::Configuration shallow;
+  shallow.max_versions_per_account = 2;
+  auto trimmed = std::make_shared<AccountsDB>(shallow);
+  trimmed->set_dirty_tracking(true);
+  ASSERT_TRUE(trimmed->store_account(make_key(1), make_account(1), 12));
+  ASSERT_TRUE(trimmed->store_account(make_key(1), make_account(2), 30));
+  ASSERT_TRUE(trimmed->store_account(make_key(1), make_account(3), 31));
+  ASSERT_FALSE(trimmed->collect_modified_accounts(10, 25, modified));
+  ASSERT_TRUE(modified.empty());
+
+  std::filesystem::remove_all(test_dir);
+  std::cout << "PASSED (0ms)" << std::endl;
+}
+
+void test_merkle_accounts_hash() {
+  std::cout << "Running test: Merkle Accounts Hash... ";
+
+  using slonana::storage::AccountData;
+  using slonana::storage::AccountHash;
+  using slonana::storage::AccountsDB;
+  using slonana::storage::AccountsHasher;
+
+  // Fanout-16 tree shape: 17 leaves are one full group and a lone leaf
+  std::vector<AccountHash> leaves(17);
+  for (size_t i = 0; i < leaves.size(); ++i) {
+    leaves[i].fill(static_cast<uint8_t>(i + 1));
+  }
+  std::vector<AccountHash> first(leaves.begin(), leaves.begin() + 16);
+  std::vector<AccountHash> parents = {AccountsHasher::merkle_root(first),
+                                      AccountsHasher::merkle_root({leaves[16]})};
+  ASSERT_TRUE(AccountsHasher::merkle_root(leaves) ==
+              AccountsHasher::merkle_root(parents));
+  ASSERT_TRUE(AccountsHasher::merkle_root({}) == AccountHash{});
+  ASSERT_FALSE(AccountsHasher::merkle_root({leaves[0]}) == leaves[0]);
+
+  std::mt19937_64 rng(39);
+  auto random_key = [&rng] {
+    PublicKey key(32);
+    for (auto &byte : key) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    return key;
+  };
+  auto make_account = [](uint64_t lamports) {
+    AccountData data;
+    data.lamports = lamports;
+    data.data.assign(24, static_cast<uint8_t>(lamports));
+    data.owner.assign(32, 0x05);
+    return data;
+  };
+
+  auto db = std::make_shared<AccountsDB>();
+  db->set_dirty_tracking(true);
+  std::vector<PublicKey> keys;
+  for (size_t i = 0; i < 5000; ++i) {
+    keys.push_back(random_key());
+    ASSERT_TRUE(db->store_account(keys.back(), make_account(100 + i), 1));
+  }
+
+  AccountsHasher::Options options;
+  options.threads = 4;
+  AccountsHasher incremental(options);
+  incremental.update_from(*db, 1);
+  ASSERT_EQ(5000u, incremental.account_count());
+  ASSERT_EQ(1u, incremental.statistics().full_rebuilds);
+
+  // Updates, deletions and a zero-lamport write, applied from dirty sets
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(db->store_account(keys[i * 7], make_account(9000 + i), 2));
+  }
+  for (size_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(db->delete_account(keys[4000 + i], 3));
+  }
+  ASSERT_TRUE(db->store_account(keys[4999], make_account(0), 3));
+  ASSERT_TRUE(db->store_account(random_key(), make_account(77), 3));
+  incremental.update_from(*db, 3);
+  ASSERT_EQ(1u, incremental.statistics().full_rebuilds);
+  ASSERT_EQ(4990u, incremental.account_count());
+
+  AccountsHasher::Options single_thread;
+  single_thread.threads = 1;
+  AccountsHasher full(single_thread);
+  full.update_from(*db, 3);
+  ASSERT_EQ(incremental.root_hex(), full.root_hex());
+
+  // Cached bins survive a restart and keep updating incrementally
+  std::string test_dir = "/tmp/test_accounts_hash";
+  std::filesystem::remove_all(test_dir);
+  std::filesystem::create_directories(test_dir);
+  std::string cache_path = test_dir + "/accounts_hash.cache";
+  ASSERT_TRUE(incremental.save(cache_path));
+  AccountsHasher reloaded(options);
+  ASSERT_TRUE(reloaded.load(cache_path));
+  ASSERT_EQ(3u, reloaded.slot());
+  ASSERT_EQ(full.root_hex(), reloaded.root_hex());
+  ASSERT_TRUE(db->store_account(keys[1], make_account(31337), 4));
+  reloaded.update_from(*db, 4);
+  full.update_from(*db, 4);
+  ASSERT_EQ(0u, reloaded.statistics().full_rebuilds);
+  ASSERT_EQ(full.root_hex(), reloaded.root_hex());
+
+  {
+    std::fstream cache(cache_path,
+                       std::ios::binary | std::ios::in | std::ios::out);
+    cache.seekp(200);
+    cache.put('\x5a');
+  }
+  AccountsHasher corrupted(options);
+  ASSERT_FALSE(corrupted.load(cache_path));
+
+  // Snapshots record the hash and verification recomputes it
+  SnapshotManager manager(test_dir + "/snapshots");
+  manager.set_snapshot_threads(4);
+  manager.set_accounts_db(db);
+  std::string ledger = test_dir + "/ledger";
+  std::filesystem::create_directories(ledger);
+  ASSERT_TRUE(manager.create_full_snapshot(4, ledger));
+  std::string full_path = test_dir + "/snapshots/snapshot-000000000004.snapshot";
+  ASSERT_EQ(full.root_hex(), manager.get_accounts_hash(4));
+  ASSERT_EQ(full.root_hex(), manager.calculate_accounts_hash(full_path));
+  ASSERT_TRUE(manager.verify_snapshot_integrity(full_path));
+  ASSERT_TRUE(std::filesystem::exists(test_dir +
+                                      "/snapshots/accounts_hash.cache"));
+
+  ASSERT_TRUE(db->delete_account(keys[2], 5));
+  ASSERT_TRUE(db->store_account(keys[3], make_account(4242), 5));
+  ASSERT_TRUE(manager.create_incremental_snapshot(5, 4, ledger));
+  ASSERT_TRUE(manager.verify_snapshot_integrity(
+      test_dir + "/snapshots/snapshot-000000000005-incremental-000000000004"
+                 ".snapshot"));
+  full.update_from(*db, 5);
+  ASSERT_EQ(full.root_hex(), manager.get_accounts_hash(5));
+
+  std::filesystem::remove_all(test_dir);
+  std::cout << "PASSED (0ms)" << std::endl;
+}
+
+void test_accounts_scan_in_key_order() {
+  std::cout << "Running test: AccountsDB Ordered Scan... ";
+
+  using slonana::storage::AccountData;
+  using slonana::storage::AccountsDB;
+  using slonana::storage::ModifiedAccount;
+
+  std::mt19937_64 rng(35);
+  AccountsDB db;
+  std::vector<PublicKey> keys;
+  for (size_t i = 0; i < 100; ++i) {
+    PublicKey key(32);
+    for (auto &byte : key) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    AccountData data;
+    data.lamports = 1 + i;
+    data.owner.assign(32, 0x05);
+    ASSERT_TRUE(db.store_account(key, data, 1));
+    keys.push_back(key);
+  }
+  ASSERT_TRUE(db.delete_account(keys[10], 1));
+  AccountData later;
+  later.lamports = 5;
+  later.owner.assign(32, 0x05);
+  ASSERT_TRUE(db.store_account(PublicKey(32, 0x00), later, 2));
+
+  // Batches of 7 cover the 99 live accounts at slot 1 in pubkey order
+  std::vector<PublicKey> seen;
+  size_t batches = 0;
+  ASSERT_TRUE(db.for_each_account_at_slot(
+      1, 7, [&](std::vector<ModifiedAccount> &batch) {
+        ASSERT_TRUE(batch.size() <= 7);
+        for (const auto &account : batch) {
+          seen.push_back(account.account_key);
+        }
+        batches++;
+        return true;
+      }));
+  ASSERT_EQ(99u, seen.size());
+  ASSERT_EQ(15u, batches);
+  ASSERT_TRUE(std::adjacent_find(seen.begin(), seen.end(),
+                                 std::greater_equal<PublicKey>()) ==
+              seen.end());
+  ASSERT_TRUE(std::find(seen.begin(), seen.end(), keys[10]) == seen.end());
+
+  // The visitor can stop the scan
+  batches = 0;
+  ASSERT_FALSE(db.for_each_account_at_slot(
+      2, 7, [&](std::vector<ModifiedAccount> &) { return ++batches < 2; }));
+  ASSERT_EQ(2u, batches);
+
+  std::cout << "PASSED (0ms)" << std::endl;
+}
+
 } // namespace
 
 int main() {
@@ -372,10 +955,19 @@ int main() {
     runner.run_test("Auto Snapshot Service", test_auto_snapshot_service);
     runner.run_test("Snapshot Streaming", test_snapshot_streaming);
     runner.run_test("Snapshot Statistics", test_snapshot_statistics);
+    runner.run_test("Snapshot Archive", test_snapshot_archive);
+    runner.run_test("Snapshot Restore Pipeline", test_snapshot_restore_pipeline);
+    runner.run_test("Incremental Snapshot From AccountsDB",
+                    test_incremental_snapshot_from_accounts_db);
+    runner.run_test("Merkle Accounts Hash", test_merkle_accounts_hash);
+    runner.run_test("AccountsDB Ordered Scan", test_accounts_scan_in_key_order);
 
     // Run snapshot bootstrap tests
     run_snapshot_bootstrap_tests();
 
+    // Run parallel snapshot downloader tests
+    run_snapshot_downloader_tests();
+
     runner.print_summary();
   } catch (const std::exception &e) {
     std::cerr << "Test suite failed: " << e.what() << std::endl;
@@ -397,6 +989,13 @@ int main() {
   std::cout << "- ✅ Efficient chunked data transfer" << std::endl;
   std::cout << "- ✅ Snapshot bootstrap functionality for devnet RPC nodes"
             << std::endl;
+  std::cout << "- ✅ Parallel, resumable ranged snapshot downloads"
+            << std::endl;
+  std::cout << "- ✅ Pipelined restore overlapping decompression and inserts"
+            << std::endl;
+  std::cout << "- ✅ Incremental snapshots from AccountsDB dirty tracking"
+            << std::endl;
+  std::cout << "- ✅ Incremental, parallel Merkle accounts hash" << std::endl;
 
   return 0;
 }
\ No newline at end of file
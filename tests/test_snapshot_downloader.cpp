@@ -0,0 +1,475 @@
+#include "test_framework.h"
+#include "validator/snapshot_archive.h"
+#include "validator/snapshot_downloader.h"
+#include "validator/snapshot_restore_pipeline.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <netinet/in.h>
+#include <random>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace slonana::validator;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * Loopback HTTP/1.1 stand-in for a snapshot mirror
+ *
+ * Serves one body under any path ending in "/snapshot.bin", with keep-alive
+ * and single-range support. After `serve_limit` range responses it starts
+ * cutting responses off halfway through the body, like a mirror going away
+ * mid-download.
+ */
+class RangeHttpServer {
+public:
+  explicit RangeHttpServer(std::vector<uint8_t> body) : body_(std::move(body)) {}
+  ~RangeHttpServer() { stop(); }
+
+  bool start() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+      return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t length = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+            0 ||
+        ::listen(listen_fd_, 64) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr),
+                      &length) != 0) {
+      return false;
+    }
+    port_ = ntohs(addr.sin_port);
+    accept_thread_ = std::thread([this] { accept_loop(); });
+    return true;
+  }
+
+  void stop() {
+    if (listen_fd_ >= 0) {
+      ::shutdown(listen_fd_, SHUT_RDWR);
+      ::close(listen_fd_);
+      listen_fd_ = -1;
+    }
+    if (accept_thread_.joinable()) {
+      accept_thread_.join();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int fd : client_fds_) {
+        ::shutdown(fd, SHUT_RDWR);
+      }
+    }
+    for (auto &thread : client_threads_) {
+      thread.join();
+    }
+    client_threads_.clear();
+  }
+
+  std::string url(const std::string &path) const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+  void set_serve_limit(int limit) { serve_limit_.store(limit); }
+  void set_ranges(bool enabled) { ranges_.store(enabled); }
+
+private:
+  void accept_loop() {
+    while (true) {
+      int fd = ::accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      client_fds_.push_back(fd);
+      client_threads_.emplace_back([this, fd] { serve(fd); });
+    }
+  }
+
+  bool send_all(int fd, const void *data, size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+      ssize_t n = ::send(fd, bytes, size, MSG_NOSIGNAL);
+      if (n <= 0) {
+        return false;
+      }
+      bytes += n;
+      size -= static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  void serve(int fd) {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+      size_t end = buffer.find("\r\n\r\n");
+      if (end == std::string::npos) {
+        ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+          break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+        continue;
+      }
+      std::string request = buffer.substr(0, end);
+      buffer.erase(0, end + 4);
+      if (!respond(fd, request)) {
+        break;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_fds_.erase(std::find(client_fds_.begin(), client_fds_.end(), fd));
+    ::close(fd);
+  }
+
+  bool respond(int fd, const std::string &request) {
+    std::istringstream lines(request);
+    std::string method, path, line;
+    lines >> method >> path;
+    std::getline(lines, line);
+    bool has_range = false;
+    uint64_t first = 0, last = body_.size() - 1;
+    while (std::getline(lines, line)) {
+      std::string lower = line;
+      for (auto &c : lower) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      }
+      if (lower.rfind("range: bytes=", 0) == 0 && ranges_.load()) {
+        std::string spec = line.substr(13);
+        size_t dash = spec.find('-');
+        first = std::stoull(spec.substr(0, dash));
+        last = std::min<uint64_t>(std::stoull(spec.substr(dash + 1)),
+                                  body_.size() - 1);
+        has_range = true;
+      }
+    }
+
+    std::ostringstream head;
+    if (path.size() < 13 || path.substr(path.size() - 13) != "/snapshot.bin") {
+      head << "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+      return send_all(fd, head.str().data(), head.str().size());
+    }
+    uint64_t length = last - first + 1;
+    if (has_range) {
+      head << "HTTP/1.1 206 Partial Content\r\n"
+           << "Content-Range: bytes " << first << "-" << last << "/"
+           << body_.size() << "\r\n";
+    } else {
+      head << "HTTP/1.1 200 OK\r\n";
+    }
+    head << "Content-Length: " << length << "\r\n"
+         << "ETag: \"test-snapshot\"\r\n\r\n";
+    if (!send_all(fd, head.str().data(), head.str().size())) {
+      return false;
+    }
+    if (method == "HEAD") {
+      return true;
+    }
+
+    bool cut = false;
+    if (has_range && length > 1) {
+      int limit = serve_limit_.load();
+      cut = limit >= 0 && range_responses_.fetch_add(1) >= limit;
+    }
+    if (cut) {
+      send_all(fd, body_.data() + first, length / 2);
+      return false;
+    }
+    return send_all(fd, body_.data() + first, length);
+  }
+
+  std::vector<uint8_t> body_;
+  int listen_fd_ = -1;
+  uint16_t port_ = 0;
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<int> client_fds_;
+  std::vector<std::thread> client_threads_;
+  std::atomic<int> serve_limit_{-1};
+  std::atomic<int> range_responses_{0};
+  std::atomic<bool> ranges_{true};
+};
+
+std::vector<uint8_t> read_file(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+/// A few MB chunked archive of incompressible accounts
+std::vector<uint8_t> generate_archive(const std::string &path) {
+  SnapshotArchiveWriter::Options options;
+  options.codec = SnapshotCodec::NONE;
+  options.chunk_size = 256 * 1024;
+  options.threads = 2;
+  SnapshotArchiveWriter writer(options);
+  ASSERT_TRUE(writer.open(path, {1, 2, 3}));
+  std::mt19937_64 rng(36);
+  for (uint64_t i = 0; i < 1500; ++i) {
+    AccountSnapshot account;
+    account.pubkey.assign(32, 0);
+    for (size_t b = 0; b < 8; ++b) {
+      account.pubkey[b] = static_cast<uint8_t>(i >> (8 * (7 - b)));
+    }
+    account.lamports = rng();
+    account.data.resize(2000 + rng() % 1000);
+    for (auto &byte : account.data) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    account.owner.assign(32, 7);
+    ASSERT_TRUE(writer.add(std::move(account)));
+  }
+  ASSERT_TRUE(writer.finish());
+  return read_file(path);
+}
+
+std::string sha256_hex(const std::vector<uint8_t> &data) {
+  auto digest = snapshot_archive::sha256(data.data(), data.size());
+  std::ostringstream out;
+  for (uint8_t byte : digest) {
+    out << std::hex << std::setw(2) << std::setfill('0')
+        << static_cast<int>(byte);
+  }
+  return out.str();
+}
+
+void test_parallel_ranged_download() {
+  std::cout << "Running test: Parallel Ranged Download... ";
+
+  std::string dir = "/tmp/test_snapshot_downloader";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto archive = generate_archive(dir + "/source.archive");
+  RangeHttpServer server(archive);
+  ASSERT_TRUE(server.start());
+
+  ParallelSnapshotDownloader::Options options;
+  options.connections = 4;
+  options.piece_size = 64 * 1024;
+  options.expected_sha256 = sha256_hex(archive);
+  ParallelSnapshotDownloader downloader(options);
+
+  // Two mirrors plus one that refuses connections and is skipped
+  std::string path = dir + "/snapshot.bin";
+  uint64_t last_progress = 0, last_total = 0;
+  auto result = downloader.download(
+      {server.url("/a/snapshot.bin"), "http://127.0.0.1:1/snapshot.bin",
+       server.url("/b/snapshot.bin")},
+      path, [&](uint64_t downloaded, uint64_t total) {
+        last_progress = downloaded;
+        last_total = total;
+      });
+  ASSERT_TRUE(result.is_ok());
+  ASSERT_EQ(last_progress, archive.size());
+  ASSERT_EQ(last_total, archive.size());
+  ASSERT_EQ(downloader.total_size(), archive.size());
+  ASSERT_EQ(downloader.bytes_downloaded(), archive.size());
+  ASSERT_EQ(downloader.bytes_resumed(), 0u);
+  ASSERT_EQ(downloader.sha256_hex(), options.expected_sha256);
+  ASSERT_TRUE(read_file(path) == archive);
+  ASSERT_FALSE(fs::exists(ParallelSnapshotDownloader::progress_path(path)));
+
+  auto stats = downloader.source_stats();
+  ASSERT_EQ(stats.size(), 2u);
+  uint64_t bytes = 0;
+  for (const auto &source : stats) {
+    bytes += source.bytes;
+    ASSERT_TRUE(source.request_pieces >= 1);
+    ASSERT_TRUE(source.request_pieces <= options.max_request_pieces);
+  }
+  ASSERT_EQ(bytes, archive.size());
+
+  // The downloaded archive is intact
+  SnapshotArchiveReader reader;
+  ASSERT_TRUE(reader.open(path));
+  ASSERT_EQ(reader.account_count(), 1500u);
+  ASSERT_TRUE(reader.verify(2));
+
+  server.stop();
+  fs::remove_all(dir);
+  std::cout << "PASSED" << std::endl;
+}
+
+void test_interrupted_download_resumes() {
+  std::cout << "Running test: Interrupted Download Resumes... ";
+
+  std::string dir = "/tmp/test_snapshot_downloader_resume";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto archive = generate_archive(dir + "/source.archive");
+  RangeHttpServer server(archive);
+  ASSERT_TRUE(server.start());
+
+  ParallelSnapshotDownloader::Options options;
+  options.connections = 3;
+  options.piece_size = 32 * 1024;
+  options.initial_request_pieces = 2;
+  options.max_request_pieces = 2;
+  options.max_source_failures = 2;
+  std::string path = dir + "/snapshot.bin";
+  std::string url = server.url("/snapshot.bin");
+
+  // The mirror cuts every response off after the first few
+  server.set_serve_limit(6);
+  uint64_t first_run_bytes = 0;
+  {
+    ParallelSnapshotDownloader downloader(options);
+    auto result = downloader.download({url}, path);
+    ASSERT_FALSE(result.is_ok());
+    first_run_bytes = downloader.bytes_downloaded();
+    ASSERT_TRUE(first_run_bytes > 0);
+    ASSERT_TRUE(first_run_bytes < archive.size());
+    ASSERT_TRUE(downloader.sha256_hex().empty());
+  }
+  ASSERT_TRUE(fs::exists(ParallelSnapshotDownloader::progress_path(path)));
+  ASSERT_EQ(fs::file_size(path), archive.size());
+
+  // Second attempt fetches only what is missing
+  server.set_serve_limit(-1);
+  options.expected_sha256 = sha256_hex(archive);
+  ParallelSnapshotDownloader downloader(options);
+  auto result = downloader.download({url}, path);
+  ASSERT_TRUE(result.is_ok());
+  ASSERT_EQ(downloader.bytes_resumed(), first_run_bytes);
+  ASSERT_EQ(downloader.bytes_resumed() + downloader.bytes_downloaded(),
+            archive.size());
+  ASSERT_TRUE(read_file(path) == archive);
+  ASSERT_FALSE(fs::exists(ParallelSnapshotDownloader::progress_path(path)));
+
+  server.stop();
+  fs::remove_all(dir);
+  std::cout << "PASSED" << std::endl;
+}
+
+void test_download_hash_mismatch_and_fallback() {
+  std::cout << "Running test: Download Hash Mismatch And Fallback... ";
+
+  std::string dir = "/tmp/test_snapshot_downloader_hash";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto archive = generate_archive(dir + "/source.archive");
+  RangeHttpServer server(archive);
+  ASSERT_TRUE(server.start());
+  std::string path = dir + "/snapshot.bin";
+
+  // A wrong expected hash discards the download
+  ParallelSnapshotDownloader::Options options;
+  options.piece_size = 128 * 1024;
+  options.expected_sha256 = std::string(64, '0');
+  ParallelSnapshotDownloader mismatched(options);
+  ASSERT_FALSE(mismatched.download({server.url("/snapshot.bin")}, path).is_ok());
+  ASSERT_FALSE(fs::exists(path));
+  ASSERT_FALSE(fs::exists(ParallelSnapshotDownloader::progress_path(path)));
+
+  // A mirror of the same size serving other bytes is dropped before any
+  // of its ranges reach the file
+  std::vector<uint8_t> corrupted(archive);
+  for (auto &byte : corrupted) {
+    byte ^= 0x5a;
+  }
+  RangeHttpServer bad_mirror(corrupted);
+  ASSERT_TRUE(bad_mirror.start());
+  options.expected_sha256.clear();
+  ParallelSnapshotDownloader cross_checked(options);
+  ASSERT_TRUE(cross_checked
+                  .download({server.url("/snapshot.bin"),
+                             bad_mirror.url("/snapshot.bin")},
+                            path)
+                  .is_ok());
+  ASSERT_EQ(cross_checked.source_stats().size(), 1u);
+  ASSERT_EQ(cross_checked.sha256_hex(), sha256_hex(archive));
+  ASSERT_TRUE(read_file(path) == archive);
+  bad_mirror.stop();
+  fs::remove(path);
+
+  // Without range support the downloader streams the file in one request
+  server.set_ranges(false);
+  options.expected_sha256 = sha256_hex(archive);
+  ParallelSnapshotDownloader sequential(options);
+  ASSERT_TRUE(sequential.download({server.url("/snapshot.bin")}, path).is_ok());
+  ASSERT_EQ(sequential.sha256_hex(), options.expected_sha256);
+  ASSERT_TRUE(read_file(path) == archive);
+
+  // Mirrors are the top-ranked sources serving the best one's file
+  std::vector<SnapshotQuality> ranked(4);
+  ranked[0].download_url = "https://a.example/snapshot-100-abc.tar.zst";
+  ranked[1].download_url = "https://b.example/snapshot-99-def.tar.zst";
+  ranked[2].download_url = "https://c.example/snapshot-100-abc.tar.zst";
+  ranked[3].download_url = "https://d.example/snapshot-100-abc.tar.zst";
+  auto sources = ParallelSnapshotDownloader::select_sources(ranked, 2);
+  ASSERT_EQ(sources.size(), 2u);
+  ASSERT_EQ(sources[0], ranked[0].download_url);
+  ASSERT_EQ(sources[1], ranked[2].download_url);
+
+  server.stop();
+  fs::remove_all(dir);
+  std::cout << "PASSED" << std::endl;
+}
+
+void test_download_streams_into_restore() {
+  std::cout << "Running test: Download Streams Into Restore... ";
+
+  std::string dir = "/tmp/test_snapshot_downloader_stream";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  auto archive = generate_archive(dir + "/source.archive");
+  RangeHttpServer server(archive);
+  ASSERT_TRUE(server.start());
+
+  // Chunks are restored as the downloaded prefix grows, not after the end
+  std::atomic<uint64_t> restored{0};
+  SnapshotRestorePipeline pipeline(
+      [&](const ChunkFrameHeader &, std::vector<AccountSnapshot> &accounts) {
+        restored += accounts.size();
+        return true;
+      });
+  pipeline.start();
+  SnapshotFrameStream stream(
+      [&](const ChunkFrameHeader &header, std::vector<uint8_t> payload) {
+        return pipeline.push_frame(header, std::move(payload));
+      });
+
+  ParallelSnapshotDownloader::Options options;
+  options.connections = 4;
+  options.piece_size = 64 * 1024;
+  ParallelSnapshotDownloader downloader(options);
+  downloader.set_data_consumer([&](const uint8_t *data, size_t size) {
+    return stream.feed(data, size);
+  });
+  ASSERT_TRUE(
+      downloader.download({server.url("/snapshot.bin")}, dir + "/snapshot.bin")
+          .is_ok());
+  ASSERT_TRUE(pipeline.finish());
+  ASSERT_TRUE(stream.complete());
+  ASSERT_EQ(restored.load(), 1500u);
+
+  server.stop();
+  fs::remove_all(dir);
+  std::cout << "PASSED" << std::endl;
+}
+
+} // anonymous namespace
+
+void run_snapshot_downloader_tests() {
+  std::cout << "\n=== Snapshot Downloader Tests ===" << std::endl;
+
+  test_parallel_ranged_download();
+  test_interrupted_download_resumes();
+  test_download_streams_into_restore();
+  test_download_hash_mismatch_and_fallback();
+
+  std::cout << "=== Snapshot Downloader Tests Complete ===" << std::endl;
+}
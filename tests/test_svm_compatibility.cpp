@@ -1,6 +1,8 @@
+#include "storage/accounts_db.h"
 #include "svm/account_loader.h"
 #include "svm/nonce_info.h"
 #include "svm/rent_calculator.h"
+#include "svm/sysvar_cache.h"
 #include "svm/transaction_balances.h"
 #include "svm/transaction_error_metrics.h"
 #include "test_framework.h"
@@ -78,6 +80,97 @@ void test_account_loader() {
   std::cout << "✓ AccountLoader test passed" << std::endl;
 }
 
+void test_account_loader_batch() {
+  slonana::storage::AccountsDB accounts_db;
+  accounts_db.set_gc_enabled(false);
+  PublicKey payer(32, 1), token_program(32, 2), alice(32, 3), bob(32, 4),
+      poor(32, 5), unknown(32, 6);
+  auto store = [&](const PublicKey &key, uint64_t lamports, size_t size,
+                   uint64_t slot) {
+    slonana::storage::AccountData data;
+    data.lamports = lamports;
+    data.data.assign(size, 0x7);
+    data.owner = PublicKey(32, 0);
+    ASSERT_TRUE(accounts_db.store_account(key, data, slot));
+  };
+  store(payer, 1000000, 0, 10);
+  store(token_program, 1, 4096, 10);
+  store(alice, 500, 165, 10);
+  store(bob, 700, 165, 10);
+  store(poor, 100, 0, 10);
+  store(alice, 900, 165, 20); // Not visible at slot 15
+
+  // The store answers a batch in one lookup, without copying into the index
+  auto shared = accounts_db.load_accounts_shared({alice, unknown, bob}, 15);
+  ASSERT_EQ(3, shared.size());
+  ASSERT_EQ(500, shared[0]->lamports);
+  ASSERT_TRUE(shared[1] == nullptr);
+  ASSERT_EQ(700, shared[2]->lamports);
+  ASSERT_EQ(2, accounts_db.load_accounts_batch({alice, unknown, bob}).size());
+
+  AccountsDbLoadingCallback callback(accounts_db, 15);
+  AccountLoader loader(&callback);
+  std::vector<TransactionAccountKeys> batch(5);
+  batch[0] = {{payer, alice, token_program}, {true, false, false},
+              {true, true, false}, 5000};
+  batch[1] = {{payer, bob, token_program}, {true, false, false},
+              {true, true, false}, 5000};
+  batch[2] = {{payer, unknown, token_program}, {true, false, false},
+              {true, true, false}, 5000};
+  batch[3] = {{poor, alice}, {true, false}, {true, true}, 5000};
+  batch[4] = {{payer, alice, alice}, {true, false, false},
+              {true, true, true}, 5000};
+  auto loaded = loader.load_batch(batch);
+
+  // Shared accounts are loaded once and referenced by position
+  ASSERT_EQ(6, loaded.keys.size());
+  ASSERT_EQ(1, loader.get_cache_stats().batch_fetches);
+  ASSERT_EQ(1, loader.get_cache_stats().misses);
+  ASSERT_EQ(loaded.transactions[0].account_indices[0],
+            loaded.transactions[1].account_indices[0]);
+  ASSERT_EQ(loaded.transactions[0].account_indices[2],
+            loaded.transactions[1].account_indices[2]);
+  ASSERT_EQ(500, loaded.account(0, 1).lamports);
+  ASSERT_EQ(700, loaded.account(1, 1).lamports);
+  ASSERT_EQ(4096, loaded.account(1, 2).data.size());
+  ASSERT_TRUE(&loaded.account(0, 0) == &loaded.account(1, 0));
+  ASSERT_EQ(3 * 128 + 4096 + 165,
+            loaded.transactions[0].loaded_accounts_data_size);
+
+  ASSERT_TRUE(loaded.transactions[0].is_success());
+  ASSERT_TRUE(loaded.transactions[1].is_success());
+  ASSERT_TRUE(loaded.transactions[2].load_result ==
+              TransactionLoadResult::ACCOUNT_NOT_FOUND);
+  ASSERT_TRUE(loaded.transactions[3].load_result ==
+              TransactionLoadResult::INSUFFICIENT_FUNDS);
+  ASSERT_TRUE(loaded.transactions[4].load_result ==
+              TransactionLoadResult::DUPLICATE_INSTRUCTION);
+
+  // A data size limit below the program's size rejects the transaction
+  auto limited = loader.load_batch({batch[0]}, 1024);
+  ASSERT_TRUE(limited.transactions[0].load_result ==
+              TransactionLoadResult::MAX_LOADED_ACCOUNTS_DATA_SIZE_EXCEEDED);
+
+  // Both later loads are served from what the first batch fetched
+  auto single = loader.load_account(token_program, false, false);
+  ASSERT_TRUE(single.has_value());
+  ASSERT_EQ(1, loader.get_cache_stats().batch_fetches);
+
+  // Builtin programs and sysvars are never fetched from the store
+  auto clock = builtin_account_key(BuiltinAccount::CLOCK_SYSVAR);
+  auto system = builtin_account_key(BuiltinAccount::SYSTEM_PROGRAM);
+  auto builtins = loader.load_batch(
+      {{{payer, alice, system, clock}, {true, false, false, false},
+        {true, true, false, false}, 5000}});
+  ASSERT_TRUE(builtins.transactions[0].is_success());
+  ASSERT_EQ(1, loader.get_cache_stats().batch_fetches);
+  ASSERT_EQ(2, loader.get_cache_stats().builtin_loads);
+  ASSERT_TRUE(builtins.account(0, 2).executable);
+  ASSERT_EQ(40, builtins.account(0, 3).data.size());
+
+  std::cout << "✓ AccountLoader batch test passed" << std::endl;
+}
+
 void test_rent_calculator() {
   RentCalculator calc;
 
@@ -198,6 +291,7 @@ void run_svm_compatibility_tests(TestRunner &runner) {
   std::cout << "\n=== SVM Compatibility Test Suite ===" << std::endl;
 
   runner.run_test("Account Loader", test_account_loader);
+  runner.run_test("Account Loader Batch", test_account_loader_batch);
   runner.run_test("Rent Calculator", test_rent_calculator);
   runner.run_test("Nonce Info", test_nonce_info);
   runner.run_test("Transaction Balances", test_transaction_balances);
@@ -1,4 +1,5 @@
 #include "svm/syscalls.h"
+#include "svm/sysvar_cache.h"
 #include "test_framework.h"
 #include <cstring>
 
@@ -125,6 +126,123 @@ void test_compute_unit_costs_defined() {
     ASSERT_GT(compute_units::EPOCH_STAKE, compute_units::SYSVAR_BASE);
 }
 
+void test_builtin_account_lookup() {
+    // System Program is all zeros; the rest round-trip through their keys
+    ASSERT_TRUE(lookup_builtin_account(PublicKey(32, 0)) ==
+                BuiltinAccount::SYSTEM_PROGRAM);
+    for (int id = 1; id <= static_cast<int>(BuiltinAccount::RECENT_BLOCKHASHES_SYSVAR); ++id) {
+        auto builtin = static_cast<BuiltinAccount>(id);
+        PublicKey key = builtin_account_key(builtin);
+        ASSERT_EQ(key.size(), (size_t)32);
+        ASSERT_TRUE(lookup_builtin_account(key) == builtin);
+
+        // A key differing in its last byte is an ordinary account
+        key[31] ^= 0x01;
+        ASSERT_TRUE(lookup_builtin_account(key) == BuiltinAccount::NONE);
+    }
+
+    ASSERT_TRUE(lookup_builtin_account(PublicKey(32, 0xAB)) == BuiltinAccount::NONE);
+    ASSERT_TRUE(lookup_builtin_account(PublicKey(31, 0)) == BuiltinAccount::NONE);
+    ASSERT_TRUE(is_sysvar(BuiltinAccount::CLOCK_SYSVAR));
+    ASSERT_FALSE(is_sysvar(BuiltinAccount::TOKEN_PROGRAM));
+
+    auto token = builtin_program_account(BuiltinAccount::TOKEN_PROGRAM);
+    ASSERT_TRUE(token != nullptr);
+    ASSERT_TRUE(token->executable);
+    ASSERT_TRUE(token == builtin_program_account(BuiltinAccount::TOKEN_PROGRAM));
+    ASSERT_TRUE(builtin_program_account(BuiltinAccount::RENT_SYSVAR) == nullptr);
+}
+
+void test_epoch_schedule_warmup() {
+    auto schedule = EpochScheduleSysvar::create(8192, true);
+    ASSERT_EQ(schedule.first_normal_epoch, (uint64_t)8);
+    ASSERT_EQ(schedule.first_normal_slot, (uint64_t)8160);
+
+    // Epochs of 32, 64, 128, ... slots until they reach 8192
+    ASSERT_EQ(schedule.get_epoch(0), (uint64_t)0);
+    ASSERT_EQ(schedule.get_epoch(31), (uint64_t)0);
+    ASSERT_EQ(schedule.get_epoch(32), (uint64_t)1);
+    ASSERT_EQ(schedule.get_epoch(95), (uint64_t)1);
+    ASSERT_EQ(schedule.get_epoch(96), (uint64_t)2);
+    ASSERT_EQ(schedule.get_first_slot_in_epoch(2), (uint64_t)96);
+    ASSERT_EQ(schedule.get_epoch(8160), (uint64_t)8);
+    ASSERT_EQ(schedule.get_epoch(8160 + 8192), (uint64_t)9);
+    ASSERT_EQ(schedule.get_first_slot_in_epoch(9), (uint64_t)(8160 + 8192));
+    ASSERT_EQ(schedule.get_leader_schedule_epoch(8160), (uint64_t)9);
+
+    auto flat = EpochScheduleSysvar::create(432000, false);
+    ASSERT_EQ(flat.get_epoch(431999), (uint64_t)0);
+    ASSERT_EQ(flat.get_epoch(432000), (uint64_t)1);
+}
+
+void test_sysvar_snapshot_for_slot() {
+    auto genesis = SysvarSnapshot::genesis(1700000000, EpochScheduleSysvar::create(64, false));
+    auto child = SysvarSnapshot::for_slot(*genesis, 10);
+    ASSERT_EQ(child->clock().slot, (uint64_t)10);
+    ASSERT_EQ(child->clock().unix_timestamp, (int64_t)1700000004);
+    ASSERT_EQ(child->clock().epoch, (uint64_t)0);
+    ASSERT_EQ(child->clock().epoch_start_timestamp, (int64_t)1700000000);
+    ASSERT_EQ(child->clock().leader_schedule_epoch, (uint64_t)1);
+
+    // A new epoch restarts the epoch timestamp
+    auto next_epoch = SysvarSnapshot::for_slot(*child, 70);
+    ASSERT_EQ(next_epoch->clock().epoch, (uint64_t)1);
+    ASSERT_EQ(next_epoch->clock().unix_timestamp, (int64_t)1700000028);
+    ASSERT_EQ(next_epoch->clock().epoch_start_timestamp, (int64_t)1700000028);
+    ASSERT_EQ(next_epoch->epoch_schedule().slots_per_epoch, (uint64_t)64);
+
+    // Prepared accounts hold the serialized sysvars
+    auto clock = next_epoch->account(BuiltinAccount::CLOCK_SYSVAR);
+    ASSERT_TRUE(clock != nullptr);
+    ASSERT_EQ(clock->data.size(), (size_t)40);
+    ASSERT_TRUE(clock->pubkey == builtin_account_key(BuiltinAccount::CLOCK_SYSVAR));
+    uint64_t slot = 0;
+    std::memcpy(&slot, clock->data.data(), sizeof(slot));
+    ASSERT_EQ(slot, (uint64_t)70);
+    ASSERT_EQ(next_epoch->data(BuiltinAccount::RENT_SYSVAR).size(), (size_t)17);
+    ASSERT_EQ(next_epoch->data(BuiltinAccount::EPOCH_SCHEDULE_SYSVAR).size(), (size_t)33);
+    ASSERT_TRUE(next_epoch->data(BuiltinAccount::SLOT_HASHES_SYSVAR).empty());
+}
+
+void test_sysvar_syscalls_follow_snapshot() {
+    uint8_t result[64];
+    uint64_t result_len = 0;
+    uint64_t slot = 0;
+
+    // Unscoped threads see the installed snapshot
+    auto installed = SysvarSnapshot::for_slot(*SysvarSnapshot::genesis(0), 500);
+    SysvarCache::install(installed);
+    ASSERT_EQ(sol_get_clock_sysvar(result, &result_len), (uint64_t)0);
+    ASSERT_EQ(result_len, (uint64_t)40);
+    std::memcpy(&slot, result, sizeof(slot));
+    ASSERT_EQ(slot, (uint64_t)500);
+
+    {
+        // A scope pins another bank's snapshot for this thread only
+        auto fork = SysvarSnapshot::for_slot(*installed, 501);
+        SysvarCache::Scope scope(fork);
+        ASSERT_EQ(sol_get_clock_sysvar(result, &result_len), (uint64_t)0);
+        std::memcpy(&slot, result, sizeof(slot));
+        ASSERT_EQ(slot, (uint64_t)501);
+    }
+    ASSERT_EQ(sol_get_clock_sysvar(result, &result_len), (uint64_t)0);
+    std::memcpy(&slot, result, sizeof(slot));
+    ASSERT_EQ(slot, (uint64_t)500);
+
+    ASSERT_EQ(sol_get_rent_sysvar(result, &result_len), (uint64_t)0);
+    ASSERT_EQ(result_len, (uint64_t)17);
+    uint64_t lamports_per_byte_year = 0;
+    std::memcpy(&lamports_per_byte_year, result, sizeof(uint64_t));
+    ASSERT_EQ(lamports_per_byte_year, (uint64_t)3480);
+
+    ASSERT_EQ(sol_get_epoch_schedule_sysvar(result, &result_len), (uint64_t)0);
+    ASSERT_EQ(result_len, (uint64_t)33);
+    ASSERT_NE(sol_get_clock_sysvar(nullptr, &result_len), (uint64_t)0);
+
+    SysvarCache::install(nullptr);
+    ASSERT_TRUE(SysvarCache::current() == SysvarSnapshot::defaults());
+}
+
 int main() {
     TestRunner runner;
     
@@ -140,6 +258,10 @@ int main() {
     runner.run_test("Last Restart Slot Null", test_last_restart_slot_null);
     runner.run_test("All Sysvars Callable", test_all_sysvars_callable);
     runner.run_test("Compute Unit Costs Defined", test_compute_unit_costs_defined);
+    runner.run_test("Builtin Account Lookup", test_builtin_account_lookup);
+    runner.run_test("Epoch Schedule Warmup", test_epoch_schedule_warmup);
+    runner.run_test("Sysvar Snapshot For Slot", test_sysvar_snapshot_for_slot);
+    runner.run_test("Sysvar Syscalls Follow Snapshot", test_sysvar_syscalls_follow_snapshot);
     
     runner.print_summary();
     
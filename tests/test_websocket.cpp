@@ -1,15 +1,109 @@
+#include "consensus/advanced_fork_choice.h"
+#include "network/account_notification_dispatcher.h"
+#include "network/rpc_json.h"
 #include "network/rpc_server.h"
 #include "network/websocket_server.h"
+#include "storage/account_change_feed.h"
 #include "test_framework.h"
+#include <arpa/inet.h>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
 #include <thread>
+#include <unistd.h>
+#include <vector>
 
 using namespace slonana::network;
 using namespace slonana::common;
 
 namespace {
 
+// Minimal blocking WebSocket client for exercising the server end to end
+int connect_ws_client(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool read_with_timeout(int fd, std::string &buffer, int timeout_ms = 2000) {
+  pollfd pfd{fd, POLLIN, 0};
+  if (poll(&pfd, 1, timeout_ms) <= 0) {
+    return false;
+  }
+  char chunk[4096];
+  ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+  if (received <= 0) {
+    return false;
+  }
+  buffer.append(chunk, static_cast<size_t>(received));
+  return true;
+}
+
+std::string ws_handshake(int fd) {
+  std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\n"
+                        "Upgrade: websocket\r\nConnection: Upgrade\r\n"
+                        "sec-websocket-key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+                        "Sec-WebSocket-Version: 13\r\n\r\n";
+  send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+  std::string response;
+  while (response.find("\r\n\r\n") == std::string::npos &&
+         read_with_timeout(fd, response)) {
+  }
+  return response;
+}
+
+void ws_send_text(int fd, const std::string &payload) {
+  std::string frame;
+  frame.push_back(static_cast<char>(0x81));
+  const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+  if (payload.size() < 126) {
+    frame.push_back(static_cast<char>(0x80 | payload.size()));
+  } else { // < 64 KiB
+    frame.push_back(static_cast<char>(0x80 | 126));
+    frame.push_back(static_cast<char>(payload.size() >> 8));
+    frame.push_back(static_cast<char>(payload.size() & 0xFF));
+  }
+  frame.append(reinterpret_cast<const char *>(mask), 4);
+  for (size_t i = 0; i < payload.size(); ++i) {
+    frame.push_back(static_cast<char>(payload[i] ^ mask[i % 4]));
+  }
+  send(fd, frame.data(), frame.size(), MSG_NOSIGNAL);
+}
+
+// Pops one complete server frame from buffer, reading more as needed
+bool ws_read_text(int fd, std::string &buffer, std::string &payload) {
+  while (true) {
+    if (buffer.size() >= 2) {
+      size_t length = static_cast<uint8_t>(buffer[1]) & 0x7F;
+      size_t header = 2;
+      if (length == 126 && buffer.size() >= 4) {
+        length = (static_cast<uint8_t>(buffer[2]) << 8) |
+                 static_cast<uint8_t>(buffer[3]);
+        header = 4;
+      }
+      if (length != 126 && buffer.size() >= header + length) {
+        payload = buffer.substr(header, length);
+        buffer.erase(0, header + length);
+        return true;
+      }
+    }
+    if (!read_with_timeout(fd, buffer)) {
+      return false;
+    }
+  }
+}
+
+
 // Test WebSocket server lifecycle
 void test_websocket_server_lifecycle() {
   int port = TestPortManager::get_next_port();
@@ -169,6 +263,334 @@ void test_websocket_performance() {
   ws_server->stop();
 }
 
+// Test subscribe/notify/unsubscribe over a real socket
+void test_websocket_subscription_roundtrip() {
+  int port = TestPortManager::get_next_port();
+  WebSocketServerConfig config;
+  config.reactor_threads = 2;
+  auto ws_server =
+      std::make_shared<WebSocketServer>("127.0.0.1", port, config);
+  ASSERT_TRUE(ws_server->start());
+
+  int fd = connect_ws_client(port);
+  ASSERT_TRUE(fd >= 0);
+  // RFC 6455 sample key; header names are matched case-insensitively
+  std::string handshake = ws_handshake(fd);
+  ASSERT_TRUE(handshake.find("101 Switching Protocols") != std::string::npos);
+  ASSERT_TRUE(handshake.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=") !=
+              std::string::npos);
+
+  std::string buffer = handshake.substr(handshake.find("\r\n\r\n") + 4);
+  std::string payload;
+  ws_send_text(fd, R"({"jsonrpc":"2.0","id":7,"method":"accountSubscribe","params":["hot_account"]})");
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_TRUE(payload.find("\"id\":7") != std::string::npos);
+  std::string sub_id = payload.substr(payload.find("\"result\":") + 9);
+  sub_id = sub_id.substr(0, sub_id.find(','));
+  ASSERT_EQ(ws_server->account_subscriber_count("hot_account"), 1u);
+
+  ws_server->notify_account_change("hot_account", "{\"lamports\":42}");
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_EQ(payload,
+            std::string(R"({"jsonrpc":"2.0","method":"accountNotification",)"
+                        R"("params":{"result":{"lamports":42},"subscription":)") +
+                sub_id + "}}");
+
+  ws_send_text(fd, R"({"jsonrpc":"2.0","id":8,"method":"accountUnsubscribe","params":[)" +
+                       sub_id + "]}");
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_TRUE(payload.find("\"result\":true") != std::string::npos);
+  ASSERT_EQ(ws_server->account_subscriber_count("hot_account"), 0u);
+
+  // Closing the socket removes the connection and its subscriptions
+  ws_send_text(fd, R"({"jsonrpc":"2.0","id":9,"method":"slotSubscribe"})");
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ::close(fd);
+  for (int i = 0; i < 100 && ws_server->get_stats().active_connections > 0;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  auto stats = ws_server->get_stats();
+  ASSERT_EQ(stats.active_connections, 0u);
+  ASSERT_EQ(stats.active_subscriptions, 0u);
+
+  ws_server->stop();
+}
+
+// Test that a client that never reads is evicted instead of growing forever
+void test_websocket_slow_consumer_eviction() {
+  int port = TestPortManager::get_next_port();
+  WebSocketServerConfig config;
+  config.reactor_threads = 1;
+  config.max_queued_messages = 64;
+  config.max_queued_bytes = 256 * 1024;
+  auto ws_server =
+      std::make_shared<WebSocketServer>("127.0.0.1", port, config);
+  ASSERT_TRUE(ws_server->start());
+
+  int fd = connect_ws_client(port);
+  ASSERT_TRUE(fd >= 0);
+  int small = 4096;
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &small, sizeof(small));
+  std::string buffer = ws_handshake(fd);
+  buffer = buffer.substr(buffer.find("\r\n\r\n") + 4);
+  std::string payload;
+  ws_send_text(fd, R"({"jsonrpc":"2.0","id":1,"method":"accountSubscribe","params":["busy"]})");
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+
+  std::string large_data = "\"" + std::string(16 * 1024, 'x') + "\"";
+  for (int i = 0; i < 2000 && ws_server->get_stats().slow_consumer_evictions == 0;
+       ++i) {
+    ws_server->notify_account_change("busy", large_data);
+  }
+  ASSERT_EQ(ws_server->get_stats().slow_consumer_evictions, 1u);
+
+  for (int i = 0; i < 100 && ws_server->get_stats().active_connections > 0;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(ws_server->get_stats().active_connections, 0u);
+  ASSERT_EQ(ws_server->account_subscriber_count("busy"), 0u);
+
+  ::close(fd);
+  ws_server->stop();
+}
+
+// Test the commit-time change ring: ordering, overflow and many producers
+void test_account_change_feed() {
+  slonana::storage::AccountChangeFeed feed(4);
+  ASSERT_EQ(feed.capacity(), 4u);
+  PublicKey owner(32, 9);
+  for (uint8_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(feed.publish(10 + i, PublicKey(32, i), i, owner));
+  }
+  ASSERT_FALSE(feed.publish(20, PublicKey(32, 5), 1, owner));
+  ASSERT_EQ(feed.dropped(), 1u);
+
+  std::vector<slonana::storage::AccountChangeRecord> records;
+  ASSERT_EQ(feed.drain(records), 4u);
+  for (uint8_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(records[i].slot, 10u + i);
+    ASSERT_TRUE(records[i].pubkey_key() == PublicKey(32, i));
+    ASSERT_TRUE(records[i].owner_key() == owner);
+  }
+  // Freed cells are reusable
+  ASSERT_TRUE(feed.publish(30, PublicKey(32, 1), 1, owner, true));
+  records.clear();
+  ASSERT_EQ(feed.drain(records), 1u);
+  ASSERT_TRUE(records[0].deleted);
+
+  slonana::storage::AccountChangeFeed shared_feed(8192);
+  constexpr int PRODUCERS = 4;
+  constexpr uint64_t PER_PRODUCER = 1000;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < PRODUCERS; ++p) {
+    producers.emplace_back([&, p] {
+      for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+        shared_feed.publish(p, PublicKey(32, static_cast<uint8_t>(p)), i,
+                            owner);
+      }
+    });
+  }
+  records.clear();
+  std::vector<uint64_t> next_version(PRODUCERS, 0);
+  while (records.size() < PRODUCERS * PER_PRODUCER) {
+    size_t before = records.size();
+    shared_feed.drain(records);
+    for (size_t i = before; i < records.size(); ++i) {
+      // Each producer's records arrive in publish order
+      ASSERT_EQ(records[i].version, next_version[records[i].slot]++);
+    }
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  ASSERT_EQ(shared_feed.dropped(), 0u);
+}
+
+// Test commitment-aware, deduplicated delivery of account changes
+void test_account_notification_dispatcher() {
+  int port = TestPortManager::get_next_port();
+  auto ws_server = std::make_shared<WebSocketServer>("127.0.0.1", port);
+  ASSERT_TRUE(ws_server->start());
+
+  PublicKey hot(32, 7);
+  PublicKey quiet(32, 8);
+  PublicKey program(32, 3);
+  std::string hot_address = rpc_json::encode_base58(hot);
+  std::string program_address = rpc_json::encode_base58(program);
+
+  int fd = connect_ws_client(port);
+  ASSERT_TRUE(fd >= 0);
+  std::string buffer = ws_handshake(fd);
+  buffer = buffer.substr(buffer.find("\r\n\r\n") + 4);
+  std::string payload;
+  auto subscribe = [&](const std::string &method, const std::string &key,
+                       const std::string &options) {
+    ws_send_text(fd, R"({"jsonrpc":"2.0","id":1,"method":")" + method +
+                         R"(","params":[")" + key + "\"" + options + "]}");
+    ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+    std::string id = payload.substr(payload.find("\"result\":") + 9);
+    return id.substr(0, id.find(','));
+  };
+  std::string processed_id = subscribe(
+      "accountSubscribe", hot_address, R"(,{"commitment":"processed"})");
+  std::string finalized_id = subscribe("accountSubscribe", hot_address, "");
+  std::string program_id =
+      subscribe("programSubscribe", program_address,
+                R"(,{"commitment":"confirmed","encoding":"base58"})");
+  ASSERT_EQ(ws_server->account_interest(hot_address),
+            interest_bit(CommitmentLevel::PROCESSED, AccountEncoding::BASE64) |
+                interest_bit(CommitmentLevel::FINALIZED,
+                             AccountEncoding::BASE64));
+
+  auto feed = std::make_shared<slonana::storage::AccountChangeFeed>(64);
+  size_t loads = 0;
+  AccountNotificationDispatcher dispatcher(
+      feed, ws_server,
+      [&](const PublicKey &key, uint64_t slot)
+          -> std::optional<slonana::storage::AccountData> {
+        ++loads;
+        slonana::storage::AccountData account;
+        account.lamports = key == hot ? 200 : 1;
+        account.owner = program;
+        account.data = {1, 2, 3};
+        return account;
+      });
+
+  // Two writes to the same account in one slot, plus one nobody watches
+  feed->publish(5, hot, 1, program);
+  feed->publish(5, hot, 2, program);
+  feed->publish(5, quiet, 1, PublicKey(32, 4));
+  ASSERT_EQ(dispatcher.poll(), 0u);
+  ASSERT_EQ(dispatcher.pending_slot_count(), 1u);
+
+  dispatcher.on_slot_processed(5);
+  ASSERT_EQ(dispatcher.poll(), 1u);
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_TRUE(payload.find("accountNotification") != std::string::npos);
+  ASSERT_TRUE(payload.find(R"({"context":{"slot":5},"value":{"data":["AQID","base64"])") !=
+              std::string::npos);
+  ASSERT_TRUE(payload.find("\"lamports\":200") != std::string::npos);
+  ASSERT_TRUE(payload.find("\"subscription\":" + processed_id + "}") !=
+              std::string::npos);
+
+  dispatcher.on_slot_confirmed(5);
+  ASSERT_EQ(dispatcher.poll(), 1u);
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_TRUE(payload.find("programNotification") != std::string::npos);
+  ASSERT_TRUE(payload.find("\"pubkey\":\"" + hot_address + "\"") !=
+              std::string::npos);
+  ASSERT_TRUE(payload.find("\"base58\"") != std::string::npos);
+  ASSERT_TRUE(payload.find("\"subscription\":" + program_id + "}") !=
+              std::string::npos);
+
+  dispatcher.on_slot_rooted(5);
+  ASSERT_EQ(dispatcher.poll(), 1u);
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_TRUE(payload.find("\"subscription\":" + finalized_id + "}") !=
+              std::string::npos);
+
+  // Dead slots are dropped without notifying anyone
+  feed->publish(6, hot, 3, program);
+  dispatcher.on_slot_dead(6);
+  ASSERT_EQ(dispatcher.poll(), 0u);
+  ASSERT_EQ(dispatcher.pending_slot_count(), 0u);
+
+  auto stats = dispatcher.get_stats();
+  ASSERT_EQ(stats.records_drained, 4u);
+  ASSERT_EQ(stats.duplicate_writes, 1u);
+  ASSERT_EQ(stats.accounts_loaded, 1u); // quiet account never loaded
+  ASSERT_EQ(loads, 1u);
+  ASSERT_EQ(stats.encodings, 2u); // once per encoding across all levels
+  ASSERT_EQ(stats.notifications_published, 3u);
+  ASSERT_EQ(stats.slots_finalized, 1u);
+  ASSERT_EQ(stats.slots_discarded, 1u);
+
+  ::close(fd);
+  ws_server->stop();
+}
+
+void test_dead_fork_never_finalized() {
+  int port = TestPortManager::get_next_port();
+  auto ws_server = std::make_shared<WebSocketServer>("127.0.0.1", port);
+  ASSERT_TRUE(ws_server->start());
+
+  PublicKey hot(32, 7);
+  PublicKey program(32, 3);
+  int fd = connect_ws_client(port);
+  ASSERT_TRUE(fd >= 0);
+  std::string buffer = ws_handshake(fd);
+  buffer = buffer.substr(buffer.find("\r\n\r\n") + 4);
+  std::string payload;
+  ws_send_text(fd, R"({"jsonrpc":"2.0","id":1,"method":"accountSubscribe","params":[")" +
+                       rpc_json::encode_base58(hot) + "\"]}");
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+
+  auto feed = std::make_shared<slonana::storage::AccountChangeFeed>(64);
+  AccountNotificationDispatcher dispatcher(
+      feed, ws_server,
+      [&](const PublicKey &, uint64_t slot)
+          -> std::optional<slonana::storage::AccountData> {
+        slonana::storage::AccountData account;
+        account.lamports = slot * 100;
+        account.owner = program;
+        return account;
+      });
+
+  // Same wiring as the validator: fork choice drives the dispatcher
+  using slonana::consensus::AdvancedForkChoice;
+  using CommitmentEvent = AdvancedForkChoice::CommitmentEvent;
+  AdvancedForkChoice::Configuration config;
+  config.total_stake = 1000;
+  AdvancedForkChoice fork_choice(config);
+  fork_choice.set_commitment_callback([&](Slot slot, CommitmentEvent event) {
+    switch (event) {
+    case CommitmentEvent::PROCESSED:
+      dispatcher.on_slot_processed(slot);
+      break;
+    case CommitmentEvent::CONFIRMED:
+      dispatcher.on_slot_confirmed(slot);
+      break;
+    case CommitmentEvent::ROOTED:
+      dispatcher.on_slot_rooted(slot);
+      break;
+    case CommitmentEvent::DEAD:
+      dispatcher.on_slot_dead(slot);
+      break;
+    }
+  });
+  auto block = [](Slot slot) { return Hash(32, static_cast<uint8_t>(slot + 1)); };
+
+  // 0 forks into 1 -> 3 and 2; both sides write the watched account
+  fork_choice.add_block(block(0), Hash(32, 0xFF), 0);
+  fork_choice.add_block(block(1), block(0), 1);
+  fork_choice.add_block(block(2), block(0), 2);
+  fork_choice.add_block(block(3), block(1), 3);
+  feed->publish(2, hot, 1, program);
+  feed->publish(3, hot, 2, program);
+  ASSERT_EQ(dispatcher.poll(), 0u);
+
+  // Rooting 3 abandons 2, whose write must never reach finalized
+  fork_choice.add_vote(slonana::consensus::VoteInfo(2, block(2), PublicKey(32, 1), 300));
+  fork_choice.add_vote(slonana::consensus::VoteInfo(3, block(3), PublicKey(32, 2), 700));
+  ASSERT_EQ(fork_choice.get_root_slot(), 3u);
+  ASSERT_EQ(dispatcher.poll(), 1u);
+  ASSERT_TRUE(ws_read_text(fd, buffer, payload));
+  ASSERT_TRUE(payload.find(R"("context":{"slot":3})") != std::string::npos);
+  ASSERT_TRUE(payload.find("\"lamports\":300") != std::string::npos);
+  ASSERT_TRUE(!read_with_timeout(fd, buffer, 200));
+
+  auto stats = dispatcher.get_stats();
+  ASSERT_EQ(stats.notifications_published, 1u);
+  ASSERT_EQ(stats.slots_finalized, 1u);
+  ASSERT_EQ(stats.slots_discarded, 1u);
+  ASSERT_EQ(dispatcher.pending_slot_count(), 0u);
+
+  ::close(fd);
+  ws_server->stop();
+}
+
 } // anonymous namespace
 
 int main() {
@@ -203,9 +625,29 @@ int main() {
     test_websocket_performance();
     std::cout << "PASSED" << std::endl;
 
+    std::cout << "Running test: WebSocket Subscription Roundtrip... ";
+    test_websocket_subscription_roundtrip();
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "Running test: WebSocket Slow Consumer Eviction... ";
+    test_websocket_slow_consumer_eviction();
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "Running test: Account Change Feed... ";
+    test_account_change_feed();
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "Running test: Account Notification Dispatcher... ";
+    test_account_notification_dispatcher();
+    std::cout << "PASSED" << std::endl;
+
+    std::cout << "Running test: Dead Fork Never Finalized... ";
+    test_dead_fork_never_finalized();
+    std::cout << "PASSED" << std::endl;
+
     std::cout << "\n=== WebSocket Test Summary ===" << std::endl;
-    std::cout << "Tests run: 7" << std::endl;
-    std::cout << "Tests passed: 7" << std::endl;
+    std::cout << "Tests run: 12" << std::endl;
+    std::cout << "Tests passed: 12" << std::endl;
     std::cout << "Tests failed: 0" << std::endl;
 
     std::cout << "\nAll WebSocket tests PASSED!" << std::endl;